@@ -22,6 +22,7 @@
 #include "vtkSlicerApplicationLogic.h"
 #include "vtkMRMLCoreTestingMacros.h"
 #include "vtkSlicerConfigure.h"
+#include "vtkSlicerTask.h"
 
 // Slicer MRML includes
 #include "vtkMRMLScene.h"
@@ -29,6 +30,47 @@
 
 // VTK includes
 #include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtksys/SystemTools.hxx>
+
+// STD includes
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <thread>
+
+namespace
+{
+
+//-----------------------------------------------------------------------------
+/// Logic that provides task functions for testing task scheduling
+class vtkSlicerTaskTestLogic : public vtkMRMLAbstractLogic
+{
+public:
+  static vtkSlicerTaskTestLogic* New();
+  vtkTypeMacro(vtkSlicerTaskTestLogic, vtkMRMLAbstractLogic);
+
+  /// Blocks the processing thread until Blocking is cleared
+  void BlockingTask(void* vtkNotUsed(clientdata))
+  {
+    while (this->Blocking.load())
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  }
+  void CountedTask(void* clientdata) { (*reinterpret_cast<int*>(clientdata)) += 1; }
+  void CountedCancel(void* clientdata) { (*reinterpret_cast<int*>(clientdata)) += 100; }
+
+  std::atomic<bool> Blocking{ true };
+
+protected:
+  vtkSlicerTaskTestLogic() = default;
+  ~vtkSlicerTaskTestLogic() override = default;
+};
+
+vtkStandardNewMacro(vtkSlicerTaskTestLogic);
+
+} // namespace
 
 //-----------------------------------------------------------------------------
 int vtkSlicerApplicationLogicTest1(int, char*[])
@@ -350,5 +392,112 @@ int vtkSlicerApplicationLogicTest1(int, char*[])
     }
   }
 
+  //-----------------------------------------------------------------------------
+  // Test request priority and cancellation
+  //-----------------------------------------------------------------------------
+  {
+    vtkNew<vtkSlicerApplicationLogic> appLogic;
+    vtkNew<vtkMRMLScene> mrmlScene;
+    appLogic->SetMRMLScene(mrmlScene.GetPointer());
+    vtkNew<vtkMRMLModelHierarchyNode> referencingNode;
+    mrmlScene->AddNode(referencingNode.GetPointer());
+    vtkNew<vtkMRMLModelHierarchyNode> referencedNode;
+    mrmlScene->AddNode(referencedNode.GetPointer());
+
+    appLogic->CreateProcessingThread();
+    vtkMTimeType lowPriorityUID = appLogic->RequestAddNodeReference(referencingNode->GetID(), referencedNode->GetID(), "low");
+    vtkMTimeType cancelledUID = appLogic->RequestAddNodeReference(referencingNode->GetID(), referencedNode->GetID(), "cancelled");
+    vtkMTimeType highPriorityUID = appLogic->RequestAddNodeReference(referencingNode->GetID(), referencedNode->GetID(), "high");
+    CHECK_BOOL(lowPriorityUID != 0 && cancelledUID != 0 && highPriorityUID != 0, true);
+    CHECK_INT(appLogic->GetReadDataQueueSize(), 3);
+
+    CHECK_BOOL(appLogic->SetRequestPriority(highPriorityUID, 10), true);
+    CHECK_BOOL(appLogic->CancelRequest(cancelledUID), true);
+    CHECK_BOOL(appLogic->CancelRequest(cancelledUID), false);
+    CHECK_INT(appLogic->GetReadDataQueueSize(), 2);
+
+    // The request with the highest priority is processed first
+    appLogic->ProcessReadData();
+    CHECK_INT(appLogic->GetReadDataQueueSize(), 1);
+    CHECK_POINTER(referencingNode->GetNodeReference("high"), referencedNode.GetPointer());
+    CHECK_NULL(referencingNode->GetNodeReference("low"));
+
+    appLogic->ProcessReadData();
+    CHECK_INT(appLogic->GetReadDataQueueSize(), 0);
+    CHECK_POINTER(referencingNode->GetNodeReference("low"), referencedNode.GetPointer());
+    CHECK_NULL(referencingNode->GetNodeReference("cancelled"));
+    CHECK_BOOL(appLogic->SetRequestPriority(lowPriorityUID, 1), false);
+
+    appLogic->TerminateProcessingThread();
+  }
+
+  //-----------------------------------------------------------------------------
+  // Test that temporary files of cancelled requests are deleted
+  //-----------------------------------------------------------------------------
+  {
+    vtkNew<vtkSlicerApplicationLogic> appLogic;
+    vtkNew<vtkMRMLScene> mrmlScene;
+    appLogic->SetMRMLScene(mrmlScene.GetPointer());
+    appLogic->CreateProcessingThread();
+
+    std::string keptFilename = "applicationLogicCancelledRequestKeptFile.mrml";
+    std::string deletedFilename = "applicationLogicCancelledRequestDeletedFile.mrml";
+    for (const std::string& filename : { keptFilename, deletedFilename })
+    {
+      std::ofstream file(filename.c_str());
+      file << "<MRML></MRML>" << std::endl;
+    }
+    std::vector<std::string> nodeIDs;
+    vtkMTimeType keptFileUID = appLogic->RequestReadScene(keptFilename, nodeIDs, nodeIDs, 0, /*deleteFile=*/0);
+    vtkMTimeType deletedFileUID = appLogic->RequestReadScene(deletedFilename, nodeIDs, nodeIDs, 0, /*deleteFile=*/1);
+    CHECK_BOOL(keptFileUID != 0 && deletedFileUID != 0, true);
+
+    CHECK_BOOL(appLogic->CancelRequest(keptFileUID), true);
+    CHECK_BOOL(appLogic->CancelRequest(deletedFileUID), true);
+    CHECK_INT(appLogic->GetReadDataQueueSize(), 0);
+    CHECK_BOOL(vtksys::SystemTools::FileExists(keptFilename), true);
+    CHECK_BOOL(vtksys::SystemTools::FileExists(deletedFilename), false);
+    vtksys::SystemTools::RemoveFile(keptFilename);
+
+    // Priority of a task can only be changed while it is in the queue
+    vtkNew<vtkSlicerTask> task;
+    CHECK_BOOL(appLogic->SetTaskPriority(task, 10), false);
+    CHECK_INT(task->GetPriority(), 0);
+
+    appLogic->TerminateProcessingThread();
+  }
+
+  //-----------------------------------------------------------------------------
+  // Test that the cancel function of a queued task is called when it is cancelled
+  //-----------------------------------------------------------------------------
+  {
+    vtkNew<vtkSlicerApplicationLogic> appLogic;
+    appLogic->SetNumberOfProcessingThreads(1);
+    appLogic->CreateProcessingThread();
+    vtkNew<vtkSlicerTaskTestLogic> taskLogic;
+
+    // Keep the only processing thread busy, so that the next task stays in the queue
+    vtkNew<vtkSlicerTask> blockingTask;
+    blockingTask->SetTypeToProcessing();
+    blockingTask->SetTaskFunction(taskLogic, (vtkSlicerTask::TaskFunctionPointer)&vtkSlicerTaskTestLogic::BlockingTask, nullptr);
+    CHECK_BOOL(appLogic->ScheduleTask(blockingTask), true);
+
+    int counter = 0;
+    vtkNew<vtkSlicerTask> cancelledTask;
+    cancelledTask->SetTypeToProcessing();
+    cancelledTask->SetTaskFunction(taskLogic, (vtkSlicerTask::TaskFunctionPointer)&vtkSlicerTaskTestLogic::CountedTask, &counter);
+    cancelledTask->SetCancelFunction((vtkSlicerTask::TaskFunctionPointer)&vtkSlicerTaskTestLogic::CountedCancel);
+    CHECK_BOOL(appLogic->ScheduleTask(cancelledTask), true);
+    CHECK_BOOL(appLogic->CancelTask(cancelledTask), true);
+    CHECK_INT(counter, 100);
+    CHECK_BOOL(appLogic->CancelTask(cancelledTask), false);
+    CHECK_INT(counter, 100);
+
+    taskLogic->Blocking.store(false);
+    appLogic->TerminateProcessingThread();
+    // The cancelled task is not executed
+    CHECK_INT(counter, 100);
+  }
+
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,241 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Slicer includes
+#include "vtkSlicerApplicationLogic.h"
+#include "vtkSlicerCLIModuleLogic.h"
+
+// MRML includes
+#include "vtkMRMLCommandLineModuleNode.h"
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLScene.h"
+
+// ModuleDescriptionParser includes
+#include <ModuleDescription.h>
+#include <ModuleDescriptionParser.h>
+
+// VTK includes
+#include <vtkCallbackCommand.h>
+#include <vtkCollection.h>
+#include <vtkNew.h>
+#include <vtksys/SystemTools.hxx>
+
+// STD includes
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+// Command line executable that sleeps for the number of seconds given as first argument
+const char SleepModuleDescription[] = "<?xml version=\"1.0\" encoding=\"utf-8\"?>"
+                                      "<executable>"
+                                      "  <title>Sleep</title>"
+                                      "  <parameters>"
+                                      "    <label>Parameters</label>"
+                                      "    <float>"
+                                      "      <name>duration</name>"
+                                      "      <label>Duration</label>"
+                                      "      <index>0</index>"
+                                      "      <default>0</default>"
+                                      "    </float>"
+                                      "  </parameters>"
+                                      "</executable>";
+
+//----------------------------------------------------------------------------
+// Minimal implementation of the application's delayed event invocation:
+// requests may come from any thread, events are invoked on the main thread.
+std::mutex InvokeRequestsMutex;
+std::vector<vtkMRMLApplicationLogic::InvokeRequest> InvokeRequests;
+
+//----------------------------------------------------------------------------
+void RequestInvokeCallback(vtkObject* vtkNotUsed(caller), unsigned long vtkNotUsed(eid), void* vtkNotUsed(clientData), void* callData)
+{
+  vtkMRMLApplicationLogic::InvokeRequest* request = reinterpret_cast<vtkMRMLApplicationLogic::InvokeRequest*>(callData);
+  std::lock_guard<std::mutex> lock(InvokeRequestsMutex);
+  InvokeRequests.push_back(*request);
+}
+
+//----------------------------------------------------------------------------
+void ProcessInvokeRequests()
+{
+  std::vector<vtkMRMLApplicationLogic::InvokeRequest> invokeRequests;
+  {
+    std::lock_guard<std::mutex> lock(InvokeRequestsMutex);
+    invokeRequests.swap(InvokeRequests);
+  }
+  for (const vtkMRMLApplicationLogic::InvokeRequest& request : invokeRequests)
+  {
+    request.Caller->InvokeEvent(request.EventID, request.CallData);
+  }
+}
+
+//----------------------------------------------------------------------------
+struct BatchEventCounts
+{
+  int NumberOfCompletedJobEvents{ 0 };
+  int NumberOfCompletedBatchEvents{ 0 };
+};
+
+//----------------------------------------------------------------------------
+void BatchEventCallback(vtkObject* vtkNotUsed(caller), unsigned long eid, void* clientData, void* vtkNotUsed(callData))
+{
+  BatchEventCounts* counts = reinterpret_cast<BatchEventCounts*>(clientData);
+  if (eid == vtkSlicerCLIModuleLogic::BatchJobCompletedEvent)
+  {
+    counts->NumberOfCompletedJobEvents++;
+  }
+  else if (eid == vtkSlicerCLIModuleLogic::BatchCompletedEvent)
+  {
+    counts->NumberOfCompletedBatchEvents++;
+  }
+}
+
+//----------------------------------------------------------------------------
+/// Process event requests until the batch is completed or the timeout expires.
+void WaitForBatch(vtkSlicerCLIModuleLogic* logic)
+{
+  for (int i = 0; i < 3000 && logic->IsBatchRunning(); ++i)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    ProcessInvokeRequests();
+  }
+  // Events of the last job are requested right before the worker thread exits
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  ProcessInvokeRequests();
+}
+
+//----------------------------------------------------------------------------
+/// Wait until the job starts execution, for at most 30 seconds.
+bool WaitForRunningJob(vtkMRMLCommandLineModuleNode* node)
+{
+  for (int i = 0; i < 3000; ++i)
+  {
+    if (node->GetStatus() == vtkMRMLCommandLineModuleNode::Running)
+    {
+      return true;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return false;
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLCommandLineModuleNode* AddJob(vtkMRMLScene* scene, vtkCollection* jobs, const ModuleDescription& moduleDescription, const std::string& duration)
+{
+  vtkNew<vtkMRMLCommandLineModuleNode> node;
+  node->SetModuleDescription(moduleDescription);
+  node->SetParameterAsString("duration", duration);
+  scene->AddNode(node);
+  jobs->AddItem(node);
+  return node;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkSlicerCLIModuleLogicBatchTest1(int, char*[])
+{
+#ifdef _WIN32
+  std::cout << "Test skipped, it requires the sleep executable." << std::endl;
+  return EXIT_SUCCESS;
+#endif
+
+  ModuleDescription moduleDescription;
+  ModuleDescriptionParser parser;
+  CHECK_INT(parser.Parse(SleepModuleDescription, moduleDescription), 0);
+  moduleDescription.SetType("CommandLineModule");
+  moduleDescription.SetTarget("sleep");
+
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkSlicerApplicationLogic> appLogic;
+  appLogic->SetMRMLScene(scene);
+  appLogic->SetTemporaryPath(vtksys::SystemTools::GetCurrentWorkingDirectory().c_str());
+  vtkNew<vtkCallbackCommand> requestInvokeCallback;
+  requestInvokeCallback->SetCallback(RequestInvokeCallback);
+  appLogic->AddObserver(vtkMRMLApplicationLogic::RequestInvokeEvent, requestInvokeCallback);
+
+  vtkNew<vtkSlicerCLIModuleLogic> logic;
+  logic->SetMRMLApplicationLogic(appLogic);
+  logic->SetMRMLScene(scene);
+  logic->SetBatchCPUCoreBudget(4);
+  logic->SetMaximumNumberOfConcurrentBatchJobs(2);
+
+  BatchEventCounts eventCounts;
+  vtkNew<vtkCallbackCommand> batchEventCallback;
+  batchEventCallback->SetCallback(BatchEventCallback);
+  batchEventCallback->SetClientData(&eventCounts);
+  logic->AddObserver(vtkSlicerCLIModuleLogic::BatchJobCompletedEvent, batchEventCallback);
+  logic->AddObserver(vtkSlicerCLIModuleLogic::BatchCompletedEvent, batchEventCallback);
+
+  // All jobs of a batch are completed, two at a time
+  vtkNew<vtkCollection> jobs;
+  AddJob(scene, jobs, moduleDescription, "0");
+  AddJob(scene, jobs, moduleDescription, "0.1");
+  AddJob(scene, jobs, moduleDescription, "0");
+  CHECK_BOOL(logic->ApplyBatch(jobs), true);
+  CHECK_INT(logic->GetNumberOfBatchJobs(), 3);
+  CHECK_INT(logic->GetNumberOfConcurrentBatchJobs(), 2);
+  CHECK_INT(logic->GetNumberOfThreadsPerBatchJob(), 2);
+  WaitForBatch(logic);
+  CHECK_BOOL(logic->IsBatchRunning(), false);
+  CHECK_INT(logic->GetNumberOfCompletedBatchJobs(), 3);
+  CHECK_INT(logic->GetNumberOfFailedBatchJobs(), 0);
+  CHECK_INT(logic->GetNumberOfCancelledBatchJobs(), 0);
+  CHECK_DOUBLE_TOLERANCE(logic->GetBatchProgress(), 1.0, 1e-6);
+  CHECK_INT(eventCounts.NumberOfCompletedJobEvents, 3);
+  CHECK_INT(eventCounts.NumberOfCompletedBatchEvents, 1);
+
+  // Cancelling a running job does not affect the other jobs of the batch
+  eventCounts = BatchEventCounts();
+  jobs->RemoveAllItems();
+  vtkMRMLCommandLineModuleNode* longJob = AddJob(scene, jobs, moduleDescription, "60");
+  AddJob(scene, jobs, moduleDescription, "0");
+  CHECK_BOOL(logic->ApplyBatch(jobs), true);
+  CHECK_BOOL(WaitForRunningJob(longJob), true);
+  CHECK_POINTER(logic->GetNthBatchJobNode(0), longJob);
+  longJob->Cancel();
+  WaitForBatch(logic);
+  CHECK_INT(longJob->GetStatus(), vtkMRMLCommandLineModuleNode::Cancelled);
+  CHECK_INT(logic->GetNumberOfCompletedBatchJobs(), 1);
+  CHECK_INT(logic->GetNumberOfCancelledBatchJobs(), 1);
+  CHECK_BOOL(logic->GetNthBatchJobElapsedTime(0) < 60.0, true);
+  CHECK_INT(eventCounts.NumberOfCompletedJobEvents, 2);
+  CHECK_INT(eventCounts.NumberOfCompletedBatchEvents, 1);
+
+  // Cancelling the batch stops the running job and skips the queued ones
+  eventCounts = BatchEventCounts();
+  jobs->RemoveAllItems();
+  logic->SetMaximumNumberOfConcurrentBatchJobs(1);
+  longJob = AddJob(scene, jobs, moduleDescription, "60");
+  AddJob(scene, jobs, moduleDescription, "0");
+  AddJob(scene, jobs, moduleDescription, "0");
+  CHECK_BOOL(logic->ApplyBatch(jobs), true);
+  CHECK_BOOL(WaitForRunningJob(longJob), true);
+  logic->CancelBatch();
+  WaitForBatch(logic);
+  CHECK_BOOL(logic->IsBatchRunning(), false);
+  CHECK_INT(logic->GetNumberOfCompletedBatchJobs(), 0);
+  CHECK_INT(logic->GetNumberOfCancelledBatchJobs(), 3);
+  CHECK_INT(eventCounts.NumberOfCompletedJobEvents, 3);
+  CHECK_INT(eventCounts.NumberOfCompletedBatchEvents, 1);
+
+  appLogic->RemoveObserver(requestInvokeCallback);
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
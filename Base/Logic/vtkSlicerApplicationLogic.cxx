@@ -43,21 +43,82 @@
 # include <sys/resource.h>
 #endif
 
+#include <deque>
 #include <queue>
 
 #include "vtkSlicerApplicationLogicRequests.h"
 
 //----------------------------------------------------------------------------
-class ProcessingTaskQueue : public std::queue<vtkSmartPointer<vtkSlicerTask>>
+class ProcessingTaskQueue : public std::deque<vtkSmartPointer<vtkSlicerTask>>
 {
+public:
+  /// Return iterator to the task of the given type that has the highest priority.
+  /// If there are multiple such tasks then the one that was scheduled first is returned.
+  iterator FindNextTask(int taskType)
+  {
+    iterator nextTask = this->end();
+    for (iterator it = this->begin(); it != this->end(); ++it)
+    {
+      if ((*it)->GetType() == taskType && (nextTask == this->end() || (*it)->GetPriority() > (*nextTask)->GetPriority()))
+      {
+        nextTask = it;
+      }
+    }
+    return nextTask;
+  }
 };
 class ModifiedQueue : public std::queue<vtkSmartPointer<vtkObject>>
 {
 };
-class ReadDataQueue : public std::queue<DataRequest*>
+class DataRequestQueue : public std::deque<DataRequest*>
+{
+public:
+  /// Remove and return the request that has the highest priority.
+  /// If there are multiple such requests then the one that was requested first is returned.
+  DataRequest* PopNextRequest()
+  {
+    iterator nextRequest = this->end();
+    for (iterator it = this->begin(); it != this->end(); ++it)
+    {
+      if (nextRequest == this->end() || (*it)->GetPriority() > (*nextRequest)->GetPriority())
+      {
+        nextRequest = it;
+      }
+    }
+    if (nextRequest == this->end())
+    {
+      return nullptr;
+    }
+    DataRequest* req = *nextRequest;
+    this->erase(nextRequest);
+    return req;
+  }
+
+  iterator FindRequest(vtkMTimeType uid)
+  {
+    for (iterator it = this->begin(); it != this->end(); ++it)
+    {
+      if ((*it)->GetUID() == uid)
+      {
+        return it;
+      }
+    }
+    return this->end();
+  }
+
+  void DeleteAllRequests()
+  {
+    for (DataRequest* req : *this)
+    {
+      delete req;
+    }
+    this->clear();
+  }
+};
+class ReadDataQueue : public DataRequestQueue
 {
 };
-class WriteDataQueue : public std::queue<DataRequest*>
+class WriteDataQueue : public DataRequestQueue
 {
 };
 
@@ -75,6 +136,8 @@ vtkSlicerApplicationLogic::vtkSlicerApplicationLogic()
 
   this->WriteDataQueueActive = false;
 
+  this->NumberOfProcessingThreads = 1;
+
   this->InternalTaskQueue = new ProcessingTaskQueue;
   this->InternalModifiedQueue = new ModifiedQueue;
 
@@ -101,7 +164,9 @@ vtkSlicerApplicationLogic::~vtkSlicerApplicationLogic()
   }
   this->ModifiedQueueLock.unlock();
   delete this->InternalModifiedQueue;
+  this->InternalReadDataQueue->DeleteAllRequests();
   delete this->InternalReadDataQueue;
+  this->InternalWriteDataQueue->DeleteAllRequests();
   delete this->InternalWriteDataQueue;
 
   this->UserInformation->Delete();
@@ -113,6 +178,64 @@ unsigned int vtkSlicerApplicationLogic::GetReadDataQueueSize()
   return static_cast<unsigned int>((*this->InternalReadDataQueue).size());
 }
 
+//----------------------------------------------------------------------------
+bool vtkSlicerApplicationLogic::SetRequestPriority(vtkMTimeType uid, int priority)
+{
+  {
+    std::lock_guard<std::mutex> lock(this->ReadDataQueueLock);
+    ReadDataQueue::iterator it = this->InternalReadDataQueue->FindRequest(uid);
+    if (it != this->InternalReadDataQueue->end())
+    {
+      (*it)->SetPriority(priority);
+      return true;
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock(this->WriteDataQueueLock);
+    WriteDataQueue::iterator it = this->InternalWriteDataQueue->FindRequest(uid);
+    if (it != this->InternalWriteDataQueue->end())
+    {
+      (*it)->SetPriority(priority);
+      return true;
+    }
+  }
+  return false;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSlicerApplicationLogic::CancelRequest(vtkMTimeType uid)
+{
+  DataRequest* req = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(this->ReadDataQueueLock);
+    ReadDataQueue::iterator it = this->InternalReadDataQueue->FindRequest(uid);
+    if (it != this->InternalReadDataQueue->end())
+    {
+      req = *it;
+      this->InternalReadDataQueue->erase(it);
+    }
+  }
+  if (!req)
+  {
+    std::lock_guard<std::mutex> lock(this->WriteDataQueueLock);
+    WriteDataQueue::iterator it = this->InternalWriteDataQueue->FindRequest(uid);
+    if (it != this->InternalWriteDataQueue->end())
+    {
+      req = *it;
+      this->InternalWriteDataQueue->erase(it);
+    }
+  }
+  if (!req)
+  {
+    return false;
+  }
+  // The request will not be executed, therefore it must clean up its temporary files now
+  req->DeleteTemporaryFiles();
+  delete req;
+  this->InvokeEvent(vtkSlicerApplicationLogic::RequestProcessedEvent, reinterpret_cast<void*>(uid));
+  return true;
+}
+
 //-----------------------------------------------------------------------------
 void vtkSlicerApplicationLogic::SetMRMLSceneDataIO(vtkMRMLScene* newMRMLScene, vtkMRMLRemoteIOLogic* remoteIOLogic, vtkDataIOManagerLogic* dataIOManagerLogic)
 {
@@ -151,20 +274,24 @@ void vtkSlicerApplicationLogic::PrintSelf(ostream& os, vtkIndent indent)
   this->vtkObject::PrintSelf(os, indent);
 
   os << indent << "SlicerApplicationLogic:             " << this->GetClassName() << "\n";
+  os << indent << "NumberOfProcessingThreads: " << this->NumberOfProcessingThreads << "\n";
 }
 
 //----------------------------------------------------------------------------
 void vtkSlicerApplicationLogic::CreateProcessingThread()
 {
-  if (!this->ProcessingThread.joinable())
+  if (this->ProcessingThreads.empty())
   {
     this->ProcessingThreadActiveLock.lock();
     this->ProcessingThreadActive = true;
     this->ProcessingThreadActiveLock.unlock();
 
-    this->ProcessingThread = std::thread(vtkSlicerApplicationLogic::ProcessingThreaderCallback, this);
+    for (int threadIndex = 0; threadIndex < this->NumberOfProcessingThreads; ++threadIndex)
+    {
+      this->ProcessingThreads.push_back(std::thread(vtkSlicerApplicationLogic::ProcessingThreaderCallback, this));
+    }
 
-    // Start four network threads (TODO: make the number of threads a setting)
+    // Start a network thread
     NetworkingThreads.push_back(std::thread(vtkSlicerApplicationLogic::NetworkingThreaderCallback, this));
 
     /*
@@ -198,7 +325,7 @@ void vtkSlicerApplicationLogic::CreateProcessingThread()
 //----------------------------------------------------------------------------
 void vtkSlicerApplicationLogic::TerminateProcessingThread()
 {
-  if (this->ProcessingThread.joinable())
+  if (!this->ProcessingThreads.empty())
   {
     this->ModifiedQueueActiveLock.lock();
     this->ModifiedQueueActive = false;
@@ -216,7 +343,17 @@ void vtkSlicerApplicationLogic::TerminateProcessingThread()
     this->ProcessingThreadActive = false;
     this->ProcessingThreadActiveLock.unlock();
 
-    this->ProcessingThread.join();
+    // Wake up all threads that are waiting for tasks.
+    // Acquire the queue lock to not miss threads that are just about to start waiting.
+    this->ProcessingTaskQueueLock.lock();
+    this->ProcessingTaskQueueLock.unlock();
+    this->ProcessingTaskQueueCondition.notify_all();
+
+    for (auto& thread : this->ProcessingThreads)
+    {
+      thread.join();
+    }
+    this->ProcessingThreads.clear();
 
     for (auto& thread : this->NetworkingThreads)
     {
@@ -244,48 +381,7 @@ void vtkSlicerApplicationLogic::ProcessingThreaderCallback(vtkSlicerApplicationL
 //----------------------------------------------------------------------------
 void vtkSlicerApplicationLogic::ProcessProcessingTasks()
 {
-  int active = true;
-  vtkSmartPointer<vtkSlicerTask> task = nullptr;
-
-  while (active)
-  {
-    // Check to see if we should be shutting down
-    this->ProcessingThreadActiveLock.lock();
-    active = this->ProcessingThreadActive;
-    this->ProcessingThreadActiveLock.unlock();
-
-    if (active)
-    {
-      // pull a task off the queue
-      this->ProcessingTaskQueueLock.lock();
-      if ((*this->InternalTaskQueue).size() > 0)
-      {
-        // std::cout << "Number of queued tasks: " << (*this->InternalTaskQueue).size() << std::endl;
-
-        // only handle processing tasks in this thread
-        task = (*this->InternalTaskQueue).front();
-        if (task->GetType() == vtkSlicerTask::Processing)
-        {
-          (*this->InternalTaskQueue).pop();
-        }
-        else
-        {
-          task = nullptr;
-        }
-      }
-      this->ProcessingTaskQueueLock.unlock();
-
-      // process the task (should this be in a separate thread?)
-      if (task)
-      {
-        task->Execute();
-        task = nullptr;
-      }
-    }
-
-    // busy wait
-    itksys::SystemTools::Delay(100);
-  }
+  this->ProcessTasks(vtkSlicerTask::Processing);
 }
 
 void vtkSlicerApplicationLogic::NetworkingThreaderCallback(vtkSlicerApplicationLogic* appLogic)
@@ -305,45 +401,42 @@ void vtkSlicerApplicationLogic::NetworkingThreaderCallback(vtkSlicerApplicationL
 //----------------------------------------------------------------------------
 void vtkSlicerApplicationLogic::ProcessNetworkingTasks()
 {
-  int active = true;
-  vtkSmartPointer<vtkSlicerTask> task = nullptr;
+  this->ProcessTasks(vtkSlicerTask::Networking);
+}
 
-  while (active)
+//----------------------------------------------------------------------------
+void vtkSlicerApplicationLogic::ProcessTasks(int taskType)
+{
+  auto isActive = [this]()
   {
-    // Check to see if we should be shutting down
-    this->ProcessingThreadActiveLock.lock();
-    active = this->ProcessingThreadActive;
-    this->ProcessingThreadActiveLock.unlock();
+    std::lock_guard<std::mutex> activeLock(this->ProcessingThreadActiveLock);
+    return this->ProcessingThreadActive;
+  };
 
-    if (active)
+  while (true)
+  {
+    vtkSmartPointer<vtkSlicerTask> task;
     {
-      // pull a task off the queue
-      this->ProcessingTaskQueueLock.lock();
-      if ((*this->InternalTaskQueue).size() > 0)
+      // Pull the highest priority task of this type off the queue.
+      // Tasks of other types do not block this thread, as they are left in the queue.
+      std::unique_lock<std::mutex> lock(this->ProcessingTaskQueueLock);
+      this->ProcessingTaskQueueCondition.wait(lock,
+                                              [this, taskType, &isActive]()
+                                              {
+                                                return !isActive() //
+                                                       || this->InternalTaskQueue->FindNextTask(taskType) != this->InternalTaskQueue->end();
+                                              });
+      if (!isActive())
       {
-        // std::cout << "Number of queued tasks: " << (*this->InternalTaskQueue).size() << std::endl;
-        task = (*this->InternalTaskQueue).front();
-        if (task->GetType() == vtkSlicerTask::Networking)
-        {
-          (*this->InternalTaskQueue).pop();
-        }
-        else
-        {
-          task = nullptr;
-        }
-      }
-      this->ProcessingTaskQueueLock.unlock();
-
-      // process the task (should this be in a separate thread?)
-      if (task)
-      {
-        task->Execute();
-        task = nullptr;
+        // shutting down
+        return;
       }
+      ProcessingTaskQueue::iterator it = this->InternalTaskQueue->FindNextTask(taskType);
+      task = *it;
+      this->InternalTaskQueue->erase(it);
     }
 
-    // busy wait
-    itksys::SystemTools::Delay(100);
+    task->Execute();
   }
 }
 
@@ -360,8 +453,43 @@ int vtkSlicerApplicationLogic::ScheduleTask(vtkSlicerTask* task)
   }
 
   this->ProcessingTaskQueueLock.lock();
-  (*this->InternalTaskQueue).push(task);
+  (*this->InternalTaskQueue).push_back(task);
   this->ProcessingTaskQueueLock.unlock();
+  // Only threads of the task's type can pick it up, therefore wake up all of them
+  this->ProcessingTaskQueueCondition.notify_all();
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSlicerApplicationLogic::CancelTask(vtkSlicerTask* task)
+{
+  // Keep the task alive until its cancel function is called
+  vtkSmartPointer<vtkSlicerTask> cancelledTask = task;
+  {
+    std::lock_guard<std::mutex> lock(this->ProcessingTaskQueueLock);
+    ProcessingTaskQueue::iterator it = std::find(this->InternalTaskQueue->begin(), this->InternalTaskQueue->end(), task);
+    if (it == this->InternalTaskQueue->end())
+    {
+      return false;
+    }
+    this->InternalTaskQueue->erase(it);
+  }
+  // The cancel function may invoke events, therefore it is called after the queue is unlocked
+  cancelledTask->Cancel();
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSlicerApplicationLogic::SetTaskPriority(vtkSlicerTask* task, int priority)
+{
+  // Processing threads read the priority of queued tasks while holding the lock
+  std::lock_guard<std::mutex> lock(this->ProcessingTaskQueueLock);
+  ProcessingTaskQueue::iterator it = std::find(this->InternalTaskQueue->begin(), this->InternalTaskQueue->end(), task);
+  if (it == this->InternalTaskQueue->end())
+  {
+    return false;
+  }
+  task->SetPriority(priority);
   return true;
 }
 
@@ -403,7 +531,7 @@ vtkMTimeType vtkSlicerApplicationLogic::RequestReadFile(const char* refNode, con
   this->ReadDataQueueLock.lock();
   this->RequestTimeStamp.Modified();
   vtkMTimeType uid = this->RequestTimeStamp.GetMTime();
-  (*this->InternalReadDataQueue).push(new ReadDataRequestFile(refNode, filename, displayData, deleteFile, uid));
+  (*this->InternalReadDataQueue).push_back(new ReadDataRequestFile(refNode, filename, displayData, deleteFile, uid));
   this->ReadDataQueueLock.unlock();
   return uid;
 }
@@ -424,7 +552,7 @@ vtkMTimeType vtkSlicerApplicationLogic::RequestUpdateParentTransform(const std::
   this->ReadDataQueueLock.lock();
   this->RequestTimeStamp.Modified();
   vtkMTimeType uid = this->RequestTimeStamp.GetMTime();
-  (*this->InternalReadDataQueue).push(new ReadDataRequestUpdateParentTransform(refNode, parentTransformNode, uid));
+  (*this->InternalReadDataQueue).push_back(new ReadDataRequestUpdateParentTransform(refNode, parentTransformNode, uid));
   this->ReadDataQueueLock.unlock();
   return uid;
 }
@@ -445,7 +573,7 @@ vtkMTimeType vtkSlicerApplicationLogic::RequestUpdateSubjectHierarchyLocation(co
   this->ReadDataQueueLock.lock();
   this->RequestTimeStamp.Modified();
   vtkMTimeType uid = this->RequestTimeStamp.GetMTime();
-  (*this->InternalReadDataQueue).push(new ReadDataRequestUpdateSubjectHierarchyLocation(updatedNode, siblingNode, uid));
+  (*this->InternalReadDataQueue).push_back(new ReadDataRequestUpdateSubjectHierarchyLocation(updatedNode, siblingNode, uid));
   this->ReadDataQueueLock.unlock();
   return uid;
 }
@@ -466,7 +594,7 @@ vtkMTimeType vtkSlicerApplicationLogic::RequestAddNodeReference(const std::strin
   this->ReadDataQueueLock.lock();
   this->RequestTimeStamp.Modified();
   vtkMTimeType uid = this->RequestTimeStamp.GetMTime();
-  (*this->InternalReadDataQueue).push(new ReadDataRequestAddNodeReference(referencingNode, referencedNode, role, uid));
+  (*this->InternalReadDataQueue).push_back(new ReadDataRequestAddNodeReference(referencingNode, referencedNode, role, uid));
   this->ReadDataQueueLock.unlock();
   return uid;
 }
@@ -487,7 +615,7 @@ vtkMTimeType vtkSlicerApplicationLogic::RequestWriteData(const char* refNode, co
   this->WriteDataQueueLock.lock();
   this->RequestTimeStamp.Modified();
   vtkMTimeType uid = this->RequestTimeStamp.GetMTime();
-  (*this->InternalWriteDataQueue).push(new WriteDataRequestFile(refNode, filename, uid));
+  (*this->InternalWriteDataQueue).push_back(new WriteDataRequestFile(refNode, filename, uid));
   this->WriteDataQueueLock.unlock();
   return uid;
 }
@@ -512,7 +640,7 @@ vtkMTimeType vtkSlicerApplicationLogic::RequestReadScene(const std::string& file
   this->ReadDataQueueLock.lock();
   this->RequestTimeStamp.Modified();
   vtkMTimeType uid = this->RequestTimeStamp.GetMTime();
-  (*this->InternalReadDataQueue).push(new ReadDataRequestScene(targetIDs, sourceIDs, filename, displayData, deleteFile, uid));
+  (*this->InternalReadDataQueue).push_back(new ReadDataRequestScene(targetIDs, sourceIDs, filename, displayData, deleteFile, uid));
   this->ReadDataQueueLock.unlock();
   return uid;
 }
@@ -589,17 +717,17 @@ void vtkSlicerApplicationLogic::ProcessReadData()
   // pull an object off the queue
   DataRequest* req = nullptr;
   this->ReadDataQueueLock.lock();
-  if ((*this->InternalReadDataQueue).size() > 0)
-  {
-    req = (*this->InternalReadDataQueue).front();
-    (*this->InternalReadDataQueue).pop();
-  }
+  req = (*this->InternalReadDataQueue).PopNextRequest();
   this->ReadDataQueueLock.unlock();
 
   vtkMTimeType uid = 0;
   if (req)
   {
     uid = req->GetUID();
+    if (uid)
+    {
+      this->InvokeEvent(vtkSlicerApplicationLogic::RequestStartedEvent, reinterpret_cast<void*>(uid));
+    }
     req->Execute(this);
     delete req;
   }
@@ -629,16 +757,16 @@ void vtkSlicerApplicationLogic::ProcessWriteData()
   // pull an object off the queue
   DataRequest* req = nullptr;
   this->WriteDataQueueLock.lock();
-  if ((*this->InternalWriteDataQueue).size() > 0)
-  {
-    req = (*this->InternalWriteDataQueue).front();
-    (*this->InternalWriteDataQueue).pop();
-  }
+  req = (*this->InternalWriteDataQueue).PopNextRequest();
   this->WriteDataQueueLock.unlock();
 
   if (req)
   {
     vtkMTimeType uid = req->GetUID();
+    if (uid)
+    {
+      this->InvokeEvent(vtkSlicerApplicationLogic::RequestStartedEvent, reinterpret_cast<void*>(uid));
+    }
     req->Execute(this);
     delete req;
 
@@ -28,6 +28,7 @@
 #include <vtkCollection.h>
 
 // STL includes
+#include <condition_variable>
 #include <mutex>
 #include <thread>
 
@@ -61,11 +62,18 @@ public:
   /// \sa vtkMRMLRemoteIOLogic::AddDataIOToScene()
   void SetMRMLSceneDataIO(vtkMRMLScene* scene, vtkMRMLRemoteIOLogic* remoteIOLogic, vtkDataIOManagerLogic* dataIOManagerLogic);
 
-  /// Create a thread for processing
+  /// Create the threads for processing and networking tasks
   void CreateProcessingThread();
 
-  /// Shutdown the processing thread
+  /// Shutdown the processing and networking threads
   void TerminateProcessingThread();
+
+  /// Number of threads that execute processing tasks in parallel.
+  /// Must be set before CreateProcessingThread() is called.
+  /// Default is 1, which means processing tasks are executed one at a time.
+  vtkSetClampMacro(NumberOfProcessingThreads, int, 1, VTK_INT_MAX);
+  vtkGetMacro(NumberOfProcessingThreads, int);
+
   /// List of events potentially fired by the application logic
   enum RequestEvents
   {
@@ -76,14 +84,34 @@ public:
     /// has been processed.
     /// The UID of the request is passed as callData.
     /// \todo Add support for "modified" request.
-    RequestProcessedEvent
+    RequestProcessedEvent,
+    /// Event fired when processing of a readData, writeData or readScene request
+    /// is started. It allows reporting progress of each request.
+    /// The UID of the request is passed as callData.
+    RequestStartedEvent
   };
 
-  /// Schedule a task to run in the processing thread. Returns true if
-  /// task was successfully scheduled. ScheduleTask() is called from the
-  /// main thread to run something in the processing thread.
+  /// Schedule a task to run in a processing or networking thread (depending on
+  /// the type of the task). Returns true if task was successfully scheduled.
+  /// ScheduleTask() is called from the main thread to run something in a processing thread.
+  /// Tasks with higher priority are executed first.
+  /// \sa vtkSlicerTask::SetPriority(), SetTaskPriority()
   int ScheduleTask(vtkSlicerTask*);
 
+  /// Change priority of a scheduled task.
+  /// The priority is changed while the task queue is locked, therefore it is safe
+  /// to call this method while processing threads are picking up tasks.
+  /// Returns false if the task was not found in the queue (e.g., because
+  /// its execution has already started).
+  bool SetTaskPriority(vtkSlicerTask*, int priority);
+
+  /// Remove a task from the queue of scheduled tasks.
+  /// The cancel function of the task is called if the task is removed.
+  /// Returns false if the task was not found in the queue (e.g., because
+  /// its execution has already started).
+  /// \sa vtkSlicerTask::SetCancelFunction()
+  bool CancelTask(vtkSlicerTask*);
+
   /// Request a Modified call on an object.  This method allows a
   /// processing thread to request a Modified call on an object to be
   /// performed in the main thread.  This allows the call to Modified
@@ -134,6 +162,19 @@ public:
   /// multiple items are being returned and have all been returned).
   unsigned int GetReadDataQueueSize();
 
+  /// Change priority of a queued read or write data request.
+  /// Requests with higher priority are processed first (requests with the same
+  /// priority are processed in the order they were requested). Default priority is 0.
+  /// Returns false if the request is not found in the queues.
+  bool SetRequestPriority(vtkMTimeType uid, int priority);
+
+  /// Remove a read or write data request from the queue.
+  /// RequestProcessedEvent is invoked with the request UID as calldata,
+  /// so that observers waiting for the request are notified.
+  /// Must be called from the main thread.
+  /// Returns false if the request is not found in the queues.
+  bool CancelRequest(vtkMTimeType uid);
+
   /// Request that data be written from a file to a remote destination.
   /// Return the request UID (monotonically increasing) of the request or 0 if
   /// the request failed to be registered.  When the request is processed,
@@ -227,6 +268,10 @@ protected:
   /// Networking Task processing loop that is run in a networking thread
   void ProcessNetworkingTasks();
 
+  /// Execute scheduled tasks of the specified type until the processing threads are terminated.
+  /// Waits without consuming CPU time while there are no tasks to execute.
+  void ProcessTasks(int taskType);
+
   /// Process a request to read data into a scene.  This method is
   /// called by ProcessReadData() in the application main thread
   /// because calls to load data will cause a Modified() on a node
@@ -253,8 +298,10 @@ private:
   std::mutex WriteDataQueueActiveLock;
   std::mutex WriteDataQueueLock;
   vtkTimeStamp RequestTimeStamp;
-  std::thread ProcessingThread;
+  std::condition_variable ProcessingTaskQueueCondition;
+  std::vector<std::thread> ProcessingThreads;
   std::vector<std::thread> NetworkingThreads;
+  int NumberOfProcessingThreads;
   int ProcessingThreadActive;
   int ModifiedQueueActive;
   int ReadDataQueueActive;
@@ -19,23 +19,42 @@
 #include <vtkMRMLStorageNode.h>
 #include <vtkMRMLSubjectHierarchyNode.h>
 #include <vtkMRMLTableNode.h>
+#include <vtkMRMLVolumeNode.h>
+#include <vtkMRMLVolumeSharedMemoryTransfer.h>
 
 //----------------------------------------------------------------------------
 class DataRequest
 {
 public:
-  DataRequest() { m_UID = 0; }
+  DataRequest()
+  {
+    m_UID = 0;
+    m_Priority = 0;
+  }
 
-  DataRequest(int uid) { m_UID = uid; }
+  DataRequest(int uid)
+  {
+    m_UID = uid;
+    m_Priority = 0;
+  }
 
   virtual ~DataRequest() = default;
 
   virtual void Execute(vtkSlicerApplicationLogic*) {};
 
-  int GetUID() const { return m_UID; }
+  /// Remove temporary files that the request owns.
+  /// Called after the request is executed, or when the request is canceled before execution.
+  virtual void DeleteTemporaryFiles() {};
+
+  vtkMTimeType GetUID() const { return m_UID; }
+
+  /// Requests with higher priority are processed first
+  int GetPriority() const { return m_Priority; }
+  void SetPriority(int priority) { m_Priority = priority; }
 
 protected:
   vtkMTimeType m_UID;
+  int m_Priority;
 };
 
 //----------------------------------------------------------------------------
@@ -63,9 +82,18 @@ public:
     vtkMRMLCommandLineModuleNode* clp = vtkMRMLCommandLineModuleNode::SafeDownCast(nd);
 
     bool useURI = appLogic->GetMRMLScene()->GetCacheManager()->IsRemoteReference(m_Filename.c_str());
+    bool useSharedMemory = vtkMRMLVolumeSharedMemoryTransfer::IsSharedMemoryFileName(m_Filename);
 
     vtkMRMLStorableNode* storableNode = vtkMRMLStorableNode::SafeDownCast(nd);
-    if (storableNode)
+    if (useSharedMemory)
+    {
+      // Shared memory images are copied directly into the volume node, without a storage node
+      if (!vtkMRMLVolumeSharedMemoryTransfer::ReadVolumeNode(vtkMRMLVolumeNode::SafeDownCast(nd), m_Filename))
+      {
+        vtkErrorWithObjectMacro(appLogic, "Failed to read shared memory image " << m_Filename);
+      }
+    }
+    else if (storableNode)
     {
       int numStorageNodes = storableNode->GetNumberOfStorageNodes();
       for (int n = 0; n < numStorageNodes; n++)
@@ -161,23 +189,7 @@ public:
     }
 
     // Delete the file if requested
-    if (m_DeleteFile)
-    {
-      int removed;
-      // is it a shared memory location?
-      if (m_Filename.find("slicer:") != std::string::npos)
-      {
-        removed = 1;
-      }
-      else
-      {
-        removed = static_cast<bool>(itksys::SystemTools::RemoveFile(m_Filename.c_str()));
-      }
-      if (!removed)
-      {
-        vtkGenericWarningMacro("Unable to delete temporary file " << m_Filename);
-      }
-    }
+    this->DeleteTemporaryFiles();
 
     // Get the right type of display node. Only create a display node
     // if one does not exist already
@@ -226,6 +238,33 @@ public:
     }
   }
 
+  void DeleteTemporaryFiles() override
+  {
+    if (!m_DeleteFile)
+    {
+      return;
+    }
+    m_DeleteFile = 0;
+    int removed;
+    // is it a shared memory location?
+    if (m_Filename.find("slicer:") != std::string::npos)
+    {
+      removed = 1;
+    }
+    else if (vtkMRMLVolumeSharedMemoryTransfer::IsSharedMemoryFileName(m_Filename))
+    {
+      removed = vtkMRMLVolumeSharedMemoryTransfer::RemoveSharedMemory(m_Filename);
+    }
+    else
+    {
+      removed = static_cast<bool>(itksys::SystemTools::RemoveFile(m_Filename.c_str()));
+    }
+    if (!removed)
+    {
+      vtkGenericWarningMacro("Unable to delete temporary file " << m_Filename);
+    }
+  }
+
 protected:
   std::string m_TargetNode;
   std::string m_Filename;
@@ -264,17 +303,7 @@ public:
       appLogic->GetMRMLScene()->Import();
 
       // Delete the file if requested
-      if (m_DeleteFile)
-      {
-        int removed;
-        removed = static_cast<bool>(itksys::SystemTools::RemoveFile(m_Filename.c_str()));
-        if (!removed)
-        {
-          std::stringstream information;
-          information << "Unable to delete temporary file " << m_Filename << std::endl;
-          vtkGenericWarningMacro(<< information.str().c_str());
-        }
-      }
+      this->DeleteTemporaryFiles();
 
       return;
     }
@@ -468,16 +497,23 @@ public:
     appLogic->GetMRMLScene()->EndState(vtkMRMLScene::ImportState);
 
     // Delete the file if requested
-    if (m_DeleteFile)
+    this->DeleteTemporaryFiles();
+  }
+
+  void DeleteTemporaryFiles() override
+  {
+    if (!m_DeleteFile)
     {
-      int removed;
-      removed = static_cast<bool>(itksys::SystemTools::RemoveFile(m_Filename.c_str()));
-      if (!removed)
-      {
-        std::stringstream information;
-        information << "Unable to delete temporary file " << m_Filename << std::endl;
-        vtkGenericWarningMacro(<< information.str().c_str());
-      }
+      return;
+    }
+    m_DeleteFile = 0;
+    int removed;
+    removed = static_cast<bool>(itksys::SystemTools::RemoveFile(m_Filename.c_str()));
+    if (!removed)
+    {
+      std::stringstream information;
+      information << "Unable to delete temporary file " << m_Filename << std::endl;
+      vtkGenericWarningMacro(<< information.str().c_str());
     }
   }
 
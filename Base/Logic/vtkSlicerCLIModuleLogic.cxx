@@ -29,9 +29,12 @@
 #include <vtkMRMLStorageNode.h>
 #include <vtkMRMLModelStorageNode.h>
 #include <vtkMRMLTransformNode.h>
+#include <vtkMRMLVolumeNode.h>
+#include <vtkMRMLVolumeSharedMemoryTransfer.h>
 
 // VTK includes
 #include <vtkCallbackCommand.h>
+#include <vtkCollection.h>
 #include <vtkIntArray.h>
 #include <vtkMultiThreader.h>
 #include <vtkNew.h>
@@ -49,11 +52,14 @@
 
 // STL includes
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <chrono>
 #include <ctime>
 #include <mutex>
 #include <random>
 #include <set>
+#include <thread>
 
 #ifdef _WIN32
 # include <Windows.h> // For GetCurrentProcessId
@@ -77,6 +83,13 @@ struct DigitsToCharacters
 };
 
 typedef std::pair<vtkSlicerCLIModuleLogic*, vtkMRMLCommandLineModuleNode*> LogicNodePair;
+
+//----------------------------------------------------------------------------
+// Environment variables are shared by all the threads of the process,
+// therefore they must not be modified by several logics at the same time
+// while an executable is being launched.
+static std::mutex ProcessLaunchLock;
+
 class MRMLIDMap : public std::map<std::string, std::string>
 {
 };
@@ -177,6 +190,7 @@ public:
   ModuleDescription DefaultModuleDescription;
   int DeleteTemporaryFiles;
   int AllowInMemoryTransfer;
+  int AllowSharedMemoryTransfer;
   int HideWindow;
 
   int RedirectModuleStreams;
@@ -186,6 +200,60 @@ public:
   std::mutex ProcessesKillLock;
   std::vector<itksysProcess*> Processes;
 
+  /// Serializes the preparation of module executions (writing inputs,
+  /// adding storage nodes to the scene) when several modules run at the same time.
+  std::mutex TaskPreparationLock;
+
+  struct BatchJob
+  {
+    vtkSmartPointer<vtkMRMLCommandLineModuleNode> Node;
+    std::chrono::steady_clock::time_point StartTime;
+    std::chrono::steady_clock::time_point EndTime;
+    bool Started{ false };
+    bool Finished{ false };
+  };
+
+  /// Returns the index of the batch job that executes the node,
+  /// -1 if the node is not executed as part of the current batch.
+  int GetUnfinishedBatchJobIndex(vtkMRMLCommandLineModuleNode* node)
+  {
+    std::lock_guard<std::mutex> lock(this->BatchLock);
+    for (size_t jobIndex = 0; jobIndex < this->BatchJobs.size(); ++jobIndex)
+    {
+      if (this->BatchJobs[jobIndex].Node == node && !this->BatchJobs[jobIndex].Finished)
+      {
+        return static_cast<int>(jobIndex);
+      }
+    }
+    return -1;
+  }
+
+  /// Waits for the worker threads of the previous batch to exit.
+  void JoinBatchThreads()
+  {
+    for (std::thread& thread : this->BatchThreads)
+    {
+      if (thread.joinable())
+      {
+        thread.join();
+      }
+    }
+    this->BatchThreads.clear();
+  }
+
+  /// Guards all batch members below
+  std::mutex BatchLock;
+  std::vector<BatchJob> BatchJobs;
+  size_t NextBatchJobIndex{ 0 };
+  int NumberOfRunningBatchThreads{ 0 };
+  int NumberOfConcurrentBatchJobs{ 0 };
+  int NumberOfThreadsPerBatchJob{ 1 };
+  std::chrono::steady_clock::time_point BatchStartTime;
+  std::chrono::steady_clock::time_point BatchEndTime;
+  int BatchCPUCoreBudget{ 0 };
+  int MaximumNumberOfConcurrentBatchJobs{ 0 };
+  std::vector<std::thread> BatchThreads;
+
   typedef std::vector<std::pair<vtkMTimeType, vtkMRMLCommandLineModuleNode*>> RequestType;
   struct FindRequest
   {
@@ -210,6 +278,7 @@ public:
 
   void SetLastRequest(vtkMRMLCommandLineModuleNode* node, vtkMTimeType requestUID)
   {
+    std::lock_guard<std::mutex> lock(this->LastRequestsLock);
     RequestType::iterator it = std::find_if(this->LastRequests.begin(), this->LastRequests.end(), FindRequest(node));
     if (it == this->LastRequests.end())
     {
@@ -223,6 +292,7 @@ public:
   }
   vtkMTimeType GetLastRequest(vtkMRMLCommandLineModuleNode* node)
   {
+    std::lock_guard<std::mutex> lock(this->LastRequestsLock);
     RequestType::iterator it = std::find_if(this->LastRequests.begin(), this->LastRequests.end(), FindRequest(node));
     return (it != this->LastRequests.end()) ? it->first : 0;
   }
@@ -269,6 +339,7 @@ public:
   /// List of read data/scene requests of the CLI nodes
   /// being executed with their.
   RequestType LastRequests;
+  std::mutex LastRequestsLock;
 
   vtkSmartPointer<vtkSlicerCLIRescheduleCallback> RescheduleCallback;
   vtkSmartPointer<vtkSlicerCLIOneShotCallbackCallback> OneShotCallbackCallback;
@@ -286,6 +357,7 @@ vtkSlicerCLIModuleLogic::vtkSlicerCLIModuleLogic()
 
   this->Internal->DeleteTemporaryFiles = 1;
   this->Internal->AllowInMemoryTransfer = 1;
+  this->Internal->AllowSharedMemoryTransfer = 0;
   this->Internal->RedirectModuleStreams = 1;
   this->Internal->HideWindow = 1;
   this->Internal->RescheduleCallback = vtkSmartPointer<vtkSlicerCLIRescheduleCallback>::New();
@@ -300,6 +372,10 @@ vtkSlicerCLIModuleLogic::~vtkSlicerCLIModuleLogic()
 {
   this->RemoveObserver(this->Internal->OneShotCallbackCallback);
 
+  // Worker threads of a batch access the logic, stop them first
+  this->CancelBatch();
+  this->Internal->JoinBatchThreads();
+
   delete this->Internal;
 }
 
@@ -384,6 +460,22 @@ int vtkSlicerCLIModuleLogic::GetAllowInMemoryTransfer() const
   return this->Internal->AllowInMemoryTransfer;
 }
 
+//----------------------------------------------------------------------------
+void vtkSlicerCLIModuleLogic::SetAllowSharedMemoryTransfer(int value)
+{
+  vtkDebugMacro(<< this->GetClassName() << " (" << this << "): setting AllowSharedMemoryTransfer to " << value);
+  if (this->Internal->AllowSharedMemoryTransfer != value)
+  {
+    this->Internal->AllowSharedMemoryTransfer = value;
+  }
+}
+
+//----------------------------------------------------------------------------
+int vtkSlicerCLIModuleLogic::GetAllowSharedMemoryTransfer() const
+{
+  return this->Internal->AllowSharedMemoryTransfer;
+}
+
 //----------------------------------------------------------------------------
 void vtkSlicerCLIModuleLogic::SetHideWindow(int value)
 {
@@ -478,7 +570,8 @@ std::string vtkSlicerCLIModuleLogic::ConstructTemporaryFileName(const std::strin
                                                                 const std::string& type,
                                                                 const std::string& name,
                                                                 const std::vector<std::string>& extensions,
-                                                                CommandLineModuleType commandType)
+                                                                CommandLineModuleType commandType,
+                                                                const std::string& executionTag)
 {
   std::string fname = name;
   std::string pid;
@@ -504,10 +597,9 @@ std::string vtkSlicerCLIModuleLogic::ConstructTemporaryFileName(const std::strin
   // encoded to the same filename every time within that running
   // instance of Slicer).  This last point is an optimization to
   // minimize the number of times a file is written when running a
-  // module.  However, if we change the execution model such that more
-  // than one module can run at the same time within the same Slicer
-  // process, then this encoding will need to be changed to be unique
-  // per module execution.
+  // module.  When more than one module runs at the same time within
+  // the same Slicer process (batch execution), the execution tag
+  // makes the filename unique per module execution.
   //
 
   // Encode process id into a string.  To avoid confusing the
@@ -532,13 +624,28 @@ std::string vtkSlicerCLIModuleLogic::ConstructTemporaryFileName(const std::strin
   {
     temporaryDirectory = appLogic->GetTemporaryPath();
   }
+  if (!executionTag.empty())
+  {
+    std::string encodedExecutionTag = executionTag;
+    std::transform(encodedExecutionTag.begin(), encodedExecutionTag.end(), encodedExecutionTag.begin(), DigitsToCharacters());
+    fname = encodedExecutionTag + "_" + fname;
+  }
   fname = temporaryDirectory + "/" + pid + "_" + fname;
 
   if (tag == "image")
   {
-    if (commandType == CommandLineModule       //
-        || type == "dynamic-contrast-enhanced" //
-        || this->GetAllowInMemoryTransfer() == 0)
+    if (commandType == CommandLineModule && this->CanUseSharedMemoryTransfer(type, name, extensions))
+    {
+      // If running an executable that can access the image in shared memory
+
+      // Redefine the filename to be a reference to a shared memory image.
+      // The name is unique to the module execution, as segments of
+      // output images are created by the executable.
+      fname = vtkMRMLVolumeSharedMemoryTransfer::CreateUniqueFileName();
+    }
+    else if (commandType == CommandLineModule       //
+             || type == "dynamic-contrast-enhanced" //
+             || this->GetAllowInMemoryTransfer() == 0)
     {
       // If running an executable
 
@@ -651,6 +758,35 @@ std::string vtkSlicerCLIModuleLogic::ConstructTemporaryFileName(const std::strin
   return fname;
 }
 
+//----------------------------------------------------------------------------
+bool vtkSlicerCLIModuleLogic::CanUseSharedMemoryTransfer(const std::string& type, const std::string& name, const std::vector<std::string>& extensions)
+{
+  if (this->GetAllowSharedMemoryTransfer() == 0 || !vtkMRMLVolumeSharedMemoryTransfer::IsSupported())
+  {
+    return false;
+  }
+  // Shared memory images only store voxels and geometry, image types that require
+  // additional metadata (such as diffusion or DCE volumes) are passed via files.
+  if (type == "dynamic-contrast-enhanced")
+  {
+    return false;
+  }
+  vtkMRMLNode* node = this->GetMRMLScene() ? this->GetMRMLScene()->GetNodeByID(name) : nullptr;
+  if (!node                                                            //
+      || (strcmp(node->GetClassName(), "vtkMRMLScalarVolumeNode") != 0 //
+          && strcmp(node->GetClassName(), "vtkMRMLLabelMapVolumeNode") != 0
+          && strcmp(node->GetClassName(), "vtkMRMLVectorVolumeNode") != 0))
+  {
+    return false;
+  }
+  // If the module requests a specific file format then it may not be able to use shared memory
+  if (!extensions.empty() && extensions[0] != ".nrrd" && extensions[0] != ".nhdr")
+  {
+    return false;
+  }
+  return true;
+}
+
 //-----------------------------------------------------------------------------
 void vtkSlicerCLIModuleLogic::ApplyAndWait(vtkMRMLCommandLineModuleNode* node, bool updateDisplay)
 {
@@ -678,6 +814,362 @@ void vtkSlicerCLIModuleLogic::KillProcesses()
   this->Internal->ProcessesKillLock.unlock();
 }
 
+//-----------------------------------------------------------------------------
+bool vtkSlicerCLIModuleLogic::ApplyBatch(vtkCollection* nodes, bool updateDisplay)
+{
+  if (!nodes || nodes->GetNumberOfItems() == 0)
+  {
+    vtkErrorMacro("ApplyBatch failed: no jobs to run");
+    return false;
+  }
+  if (!this->GetApplicationLogic())
+  {
+    vtkErrorMacro("ApplyBatch failed: application logic is not set");
+    return false;
+  }
+  if (this->IsBatchRunning())
+  {
+    vtkErrorMacro("ApplyBatch failed: the previous batch is still running");
+    return false;
+  }
+  std::vector<vtkMRMLCommandLineModuleNode*> jobNodes;
+  bool inProcessModule = false;
+  for (int nodeIndex = 0; nodeIndex < nodes->GetNumberOfItems(); ++nodeIndex)
+  {
+    vtkMRMLCommandLineModuleNode* node = vtkMRMLCommandLineModuleNode::SafeDownCast(nodes->GetItemAsObject(nodeIndex));
+    if (!node)
+    {
+      vtkErrorMacro("ApplyBatch failed: item " << nodeIndex << " is not a command line module node");
+      return false;
+    }
+    if (std::find(jobNodes.begin(), jobNodes.end(), node) != jobNodes.end())
+    {
+      vtkErrorMacro("ApplyBatch failed: node " << (node->GetID() ? node->GetID() : "(none)") << " is used by more than one job");
+      return false;
+    }
+    if (node->IsBusy())
+    {
+      vtkErrorMacro("ApplyBatch failed: node " << (node->GetID() ? node->GetID() : "(none)") << " is already running");
+      return false;
+    }
+    if (node->GetModuleDescription().GetType() != "CommandLineModule")
+    {
+      inProcessModule = true;
+    }
+    jobNodes.push_back(node);
+  }
+
+  // Threads of the previous batch have already finished all their jobs
+  this->Internal->JoinBatchThreads();
+
+  for (vtkMRMLCommandLineModuleNode* node : jobNodes)
+  {
+    node->SetAttribute("UpdateDisplay", updateDisplay ? "true" : "false");
+    node->SetOutputText("", false);
+    node->SetErrorText("", false);
+    node->SetStatus(vtkMRMLCommandLineModuleNode::Scheduled);
+  }
+
+  std::lock_guard<std::mutex> lock(this->Internal->BatchLock);
+  this->Internal->BatchJobs.clear();
+  for (vtkMRMLCommandLineModuleNode* node : jobNodes)
+  {
+    vtkInternal::BatchJob job;
+    job.Node = node;
+    this->Internal->BatchJobs.push_back(job);
+  }
+  this->Internal->NextBatchJobIndex = 0;
+
+  // Distribute the CPU cores between the concurrent jobs
+  int numberOfCores = this->Internal->BatchCPUCoreBudget;
+  if (numberOfCores <= 0)
+  {
+    numberOfCores = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  }
+  int numberOfConcurrentJobs = numberOfCores;
+  if (this->Internal->MaximumNumberOfConcurrentBatchJobs > 0)
+  {
+    numberOfConcurrentJobs = this->Internal->MaximumNumberOfConcurrentBatchJobs;
+  }
+  if (inProcessModule)
+  {
+    // Shared object and Python modules redirect the standard output streams
+    // of the application, they cannot run at the same time.
+    numberOfConcurrentJobs = 1;
+  }
+  numberOfConcurrentJobs = std::min(numberOfConcurrentJobs, static_cast<int>(jobNodes.size()));
+  this->Internal->NumberOfConcurrentBatchJobs = numberOfConcurrentJobs;
+  this->Internal->NumberOfThreadsPerBatchJob = std::max(1, numberOfCores / numberOfConcurrentJobs);
+
+  this->Internal->BatchStartTime = std::chrono::steady_clock::now();
+  this->Internal->BatchEndTime = this->Internal->BatchStartTime;
+  this->Internal->NumberOfRunningBatchThreads = numberOfConcurrentJobs;
+  for (int threadIndex = 0; threadIndex < numberOfConcurrentJobs; ++threadIndex)
+  {
+    this->Internal->BatchThreads.push_back(std::thread(&vtkSlicerCLIModuleLogic::ProcessBatchJobs, this));
+  }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkSlicerCLIModuleLogic::ApplyBatchAndWait(vtkCollection* nodes, bool updateDisplay)
+{
+  if (!this->ApplyBatch(nodes, updateDisplay))
+  {
+    return false;
+  }
+  // Outputs are loaded in this thread while the jobs are running
+  while (this->IsBatchRunning())
+  {
+    this->GetApplicationLogic()->ProcessReadData();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  this->Internal->JoinBatchThreads();
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void vtkSlicerCLIModuleLogic::ProcessBatchJobs()
+{
+  while (true)
+  {
+    vtkMRMLCommandLineModuleNode* node = nullptr;
+    size_t jobIndex = 0;
+    {
+      std::lock_guard<std::mutex> lock(this->Internal->BatchLock);
+      if (this->Internal->NextBatchJobIndex >= this->Internal->BatchJobs.size())
+      {
+        break;
+      }
+      jobIndex = this->Internal->NextBatchJobIndex++;
+      vtkInternal::BatchJob& job = this->Internal->BatchJobs[jobIndex];
+      job.Started = true;
+      job.StartTime = std::chrono::steady_clock::now();
+      node = job.Node;
+    }
+
+    // ApplyTask takes the reference
+    node->Register(this);
+    this->ApplyTask(node);
+
+    {
+      std::lock_guard<std::mutex> lock(this->Internal->BatchLock);
+      vtkInternal::BatchJob& job = this->Internal->BatchJobs[jobIndex];
+      job.Finished = true;
+      job.EndTime = std::chrono::steady_clock::now();
+    }
+    this->GetApplicationLogic()->InvokeEventWithDelay(0, this, vtkSlicerCLIModuleLogic::BatchJobCompletedEvent, node);
+  }
+
+  bool lastThread = false;
+  {
+    std::lock_guard<std::mutex> lock(this->Internal->BatchLock);
+    lastThread = (--this->Internal->NumberOfRunningBatchThreads == 0);
+    if (lastThread)
+    {
+      this->Internal->BatchEndTime = std::chrono::steady_clock::now();
+    }
+  }
+  if (lastThread)
+  {
+    this->GetApplicationLogic()->InvokeEventWithDelay(0, this, vtkSlicerCLIModuleLogic::BatchCompletedEvent, nullptr);
+  }
+}
+
+//-----------------------------------------------------------------------------
+void vtkSlicerCLIModuleLogic::CancelBatch()
+{
+  std::vector<vtkSmartPointer<vtkMRMLCommandLineModuleNode>> jobNodes;
+  {
+    std::lock_guard<std::mutex> lock(this->Internal->BatchLock);
+    for (const vtkInternal::BatchJob& job : this->Internal->BatchJobs)
+    {
+      if (!job.Finished)
+      {
+        jobNodes.push_back(job.Node);
+      }
+    }
+  }
+  // Cancel() invokes events, observers may query the batch
+  for (vtkMRMLCommandLineModuleNode* node : jobNodes)
+  {
+    node->Cancel();
+  }
+}
+
+//-----------------------------------------------------------------------------
+bool vtkSlicerCLIModuleLogic::IsBatchRunning()
+{
+  std::lock_guard<std::mutex> lock(this->Internal->BatchLock);
+  for (const vtkInternal::BatchJob& job : this->Internal->BatchJobs)
+  {
+    if (!job.Finished || job.Node->IsBusy())
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+//-----------------------------------------------------------------------------
+void vtkSlicerCLIModuleLogic::SetBatchCPUCoreBudget(int numberOfCores)
+{
+  std::lock_guard<std::mutex> lock(this->Internal->BatchLock);
+  this->Internal->BatchCPUCoreBudget = std::max(0, numberOfCores);
+}
+
+//-----------------------------------------------------------------------------
+int vtkSlicerCLIModuleLogic::GetBatchCPUCoreBudget() const
+{
+  std::lock_guard<std::mutex> lock(this->Internal->BatchLock);
+  return this->Internal->BatchCPUCoreBudget;
+}
+
+//-----------------------------------------------------------------------------
+void vtkSlicerCLIModuleLogic::SetMaximumNumberOfConcurrentBatchJobs(int numberOfJobs)
+{
+  std::lock_guard<std::mutex> lock(this->Internal->BatchLock);
+  this->Internal->MaximumNumberOfConcurrentBatchJobs = std::max(0, numberOfJobs);
+}
+
+//-----------------------------------------------------------------------------
+int vtkSlicerCLIModuleLogic::GetMaximumNumberOfConcurrentBatchJobs() const
+{
+  std::lock_guard<std::mutex> lock(this->Internal->BatchLock);
+  return this->Internal->MaximumNumberOfConcurrentBatchJobs;
+}
+
+//-----------------------------------------------------------------------------
+int vtkSlicerCLIModuleLogic::GetNumberOfConcurrentBatchJobs()
+{
+  std::lock_guard<std::mutex> lock(this->Internal->BatchLock);
+  return this->Internal->NumberOfConcurrentBatchJobs;
+}
+
+//-----------------------------------------------------------------------------
+int vtkSlicerCLIModuleLogic::GetNumberOfThreadsPerBatchJob()
+{
+  std::lock_guard<std::mutex> lock(this->Internal->BatchLock);
+  return this->Internal->NumberOfThreadsPerBatchJob;
+}
+
+//-----------------------------------------------------------------------------
+int vtkSlicerCLIModuleLogic::GetNumberOfBatchJobs()
+{
+  std::lock_guard<std::mutex> lock(this->Internal->BatchLock);
+  return static_cast<int>(this->Internal->BatchJobs.size());
+}
+
+//-----------------------------------------------------------------------------
+vtkMRMLCommandLineModuleNode* vtkSlicerCLIModuleLogic::GetNthBatchJobNode(int jobIndex)
+{
+  std::lock_guard<std::mutex> lock(this->Internal->BatchLock);
+  if (jobIndex < 0 || jobIndex >= static_cast<int>(this->Internal->BatchJobs.size()))
+  {
+    vtkErrorMacro("GetNthBatchJobNode failed: invalid job index " << jobIndex);
+    return nullptr;
+  }
+  return this->Internal->BatchJobs[jobIndex].Node;
+}
+
+//-----------------------------------------------------------------------------
+double vtkSlicerCLIModuleLogic::GetNthBatchJobElapsedTime(int jobIndex)
+{
+  std::lock_guard<std::mutex> lock(this->Internal->BatchLock);
+  if (jobIndex < 0 || jobIndex >= static_cast<int>(this->Internal->BatchJobs.size()))
+  {
+    vtkErrorMacro("GetNthBatchJobElapsedTime failed: invalid job index " << jobIndex);
+    return 0.0;
+  }
+  const vtkInternal::BatchJob& job = this->Internal->BatchJobs[jobIndex];
+  if (!job.Started)
+  {
+    return 0.0;
+  }
+  std::chrono::steady_clock::time_point endTime = job.Finished ? job.EndTime : std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(endTime - job.StartTime).count();
+}
+
+//-----------------------------------------------------------------------------
+int vtkSlicerCLIModuleLogic::GetNumberOfCompletedBatchJobs()
+{
+  std::lock_guard<std::mutex> lock(this->Internal->BatchLock);
+  int numberOfJobs = 0;
+  for (const vtkInternal::BatchJob& job : this->Internal->BatchJobs)
+  {
+    if (job.Node->GetStatus() == vtkMRMLCommandLineModuleNode::Completed)
+    {
+      ++numberOfJobs;
+    }
+  }
+  return numberOfJobs;
+}
+
+//-----------------------------------------------------------------------------
+int vtkSlicerCLIModuleLogic::GetNumberOfFailedBatchJobs()
+{
+  std::lock_guard<std::mutex> lock(this->Internal->BatchLock);
+  int numberOfJobs = 0;
+  for (const vtkInternal::BatchJob& job : this->Internal->BatchJobs)
+  {
+    if (job.Finished && (job.Node->GetStatus() & vtkMRMLCommandLineModuleNode::ErrorsMask))
+    {
+      ++numberOfJobs;
+    }
+  }
+  return numberOfJobs;
+}
+
+//-----------------------------------------------------------------------------
+int vtkSlicerCLIModuleLogic::GetNumberOfCancelledBatchJobs()
+{
+  std::lock_guard<std::mutex> lock(this->Internal->BatchLock);
+  int numberOfJobs = 0;
+  for (const vtkInternal::BatchJob& job : this->Internal->BatchJobs)
+  {
+    if (job.Node->GetStatus() == vtkMRMLCommandLineModuleNode::Cancelled)
+    {
+      ++numberOfJobs;
+    }
+  }
+  return numberOfJobs;
+}
+
+//-----------------------------------------------------------------------------
+double vtkSlicerCLIModuleLogic::GetBatchProgress()
+{
+  std::lock_guard<std::mutex> lock(this->Internal->BatchLock);
+  if (this->Internal->BatchJobs.empty())
+  {
+    return 0.0;
+  }
+  double progress = 0.0;
+  for (const vtkInternal::BatchJob& job : this->Internal->BatchJobs)
+  {
+    if (job.Finished)
+    {
+      progress += 1.0;
+    }
+    else if (job.Started)
+    {
+      progress += std::min(std::max(static_cast<double>(job.Node->GetModuleDescription().GetProcessInformation()->Progress), 0.0), 1.0);
+    }
+  }
+  return progress / this->Internal->BatchJobs.size();
+}
+
+//-----------------------------------------------------------------------------
+double vtkSlicerCLIModuleLogic::GetBatchElapsedTime()
+{
+  std::lock_guard<std::mutex> lock(this->Internal->BatchLock);
+  if (this->Internal->BatchJobs.empty())
+  {
+    return 0.0;
+  }
+  std::chrono::steady_clock::time_point endTime = this->Internal->NumberOfRunningBatchThreads > 0 ? std::chrono::steady_clock::now() : this->Internal->BatchEndTime;
+  return std::chrono::duration<double>(endTime - this->Internal->BatchStartTime).count();
+}
+
 //-----------------------------------------------------------------------------
 void vtkSlicerCLIModuleLogic::Apply(vtkMRMLCommandLineModuleNode* node, bool updateDisplay)
 {
@@ -691,6 +1183,7 @@ void vtkSlicerCLIModuleLogic::Apply(vtkMRMLCommandLineModuleNode* node, bool upd
   // scheduled but before it starts to run. And when the scheduled
   // task does run, it will operate on the correct node.
   task->SetTaskFunction(this, (vtkSlicerTask::TaskFunctionPointer)&vtkSlicerCLIModuleLogic::ApplyTask, node);
+  task->SetCancelFunction((vtkSlicerTask::TaskFunctionPointer)&vtkSlicerCLIModuleLogic::CancelScheduledTask);
 
   // Client data on the task is just a regular pointer, up the
   // reference count on the node, we'll decrease the reference count
@@ -787,6 +1280,21 @@ void vtkSlicerCLIModuleLogic::SetMRMLApplicationLogic(vtkMRMLApplicationLogic* l
 //     }
 // }
 
+//-----------------------------------------------------------------------------
+void vtkSlicerCLIModuleLogic::CancelScheduledTask(void* clientdata)
+{
+  if (clientdata == nullptr)
+  {
+    return;
+  }
+  vtkSmartPointer<vtkMRMLCommandLineModuleNode> node;
+  // node was registered when the task was scheduled, release it when it goes out of scope
+  node.TakeReference(reinterpret_cast<vtkMRMLCommandLineModuleNode*>(clientdata));
+  node->SetOutputText("", false);
+  node->SetErrorText("", false);
+  node->SetStatus(vtkMRMLCommandLineModuleNode::Cancelled);
+}
+
 //-----------------------------------------------------------------------------
 //
 // This routine is called in a separate thread from the main thread.
@@ -821,6 +1329,22 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void* clientdata)
     return;
   }
 
+  // Jobs of a batch run at the same time as other module executions, therefore
+  // their temporary files must be unique to the execution and their number of
+  // threads is limited by the CPU core budget of the batch.
+  std::string executionTag;
+  int numberOfThreads = 0;
+  if (this->Internal->GetUnfinishedBatchJobIndex(node0) >= 0)
+  {
+    static std::atomic<unsigned int> batchExecutionCounter(0);
+    executionTag = "B" + std::to_string(++batchExecutionCounter);
+    numberOfThreads = this->GetNumberOfThreadsPerBatchJob();
+  }
+
+  // Inputs are written and storage nodes are added to the scene by one
+  // execution at a time. The lock is released when the module is started.
+  std::unique_lock<std::mutex> preparationLock(this->Internal->TaskPreparationLock);
+
   // Set the callback for progress.  This will only be used for the
   // scope of this function.
   LogicNodePair lnp(this, node0);
@@ -918,7 +1442,7 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void* clientdata)
           continue;
         }
 
-        std::string fname = this->ConstructTemporaryFileName((*pit).GetTag(), (*pit).GetType(), id, (*pit).GetFileExtensions(), commandType);
+        std::string fname = this->ConstructTemporaryFileName((*pit).GetTag(), (*pit).GetType(), id, (*pit).GetFileExtensions(), commandType, executionTag);
 
         filesToDelete.insert(fname);
         if ((*pit).GetChannel() == "input")
@@ -1069,6 +1593,25 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void* clientdata)
       this->AddCompleteModelHierarchyToMiniScene(miniscene.GetPointer(), mhnd, &sceneToMiniSceneMap, filesToDelete);
     }
 
+    // Volumes passed in shared memory are copied directly from the node
+    if (vtkMRMLVolumeSharedMemoryTransfer::IsSharedMemoryFileName((*id2fn0).second))
+    {
+      out = nullptr;
+      std::string sharedMemoryFileName = (*id2fn0).second;
+      if (!vtkMRMLVolumeSharedMemoryTransfer::WriteVolumeNode(vtkMRMLVolumeNode::SafeDownCast(nd), sharedMemoryFileName))
+      {
+        vtkErrorMacro("ERROR writing shared memory image " << (*id2fn0).second);
+      }
+      else if (sharedMemoryFileName != (*id2fn0).second)
+      {
+        // Segment name was already taken, pass the new name on the command line
+        // and remove the new segment after execution.
+        filesToDelete.erase((*id2fn0).second);
+        filesToDelete.insert(sharedMemoryFileName);
+        nodesToWrite[(*id2fn0).first] = sharedMemoryFileName;
+      }
+    }
+
     // if the file is to be written, then write it
     if (out)
     {
@@ -1697,6 +2240,7 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void* clientdata)
   node0->SetErrorText("", false);
   node0->SetStatus(vtkMRMLCommandLineModuleNode::Running, false);
   this->GetApplicationLogic()->RequestModified(node0);
+  preparationLock.unlock();
   if (commandType == CommandLineModule)
   {
     // Run as a command line module
@@ -1710,20 +2254,50 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void* clientdata)
     // statically linked to the executable.
     // Historically, there was an nvidia driver bug that causes the module
     // to fail on exit with undefined symbol.
+    // If images are passed in shared memory then the plugin is required
+    // to read and write them, therefore the load path is kept.
+    bool useSharedMemoryTransfer = false;
+    for (const MRMLIDToFileNameMap* idToFileNameMap : { &nodesToWrite, &nodesToReload })
+    {
+      for (id2fn0 = idToFileNameMap->begin(); id2fn0 != idToFileNameMap->end(); ++id2fn0)
+      {
+        if (vtkMRMLVolumeSharedMemoryTransfer::IsSharedMemoryFileName((*id2fn0).second))
+        {
+          useSharedMemoryTransfer = true;
+        }
+      }
+    }
+    std::unique_lock<std::mutex> launchLock(ProcessLaunchLock);
     std::string saveITKAutoLoadPath;
     itksys::SystemTools::GetEnv("ITK_AUTOLOAD_PATH", saveITKAutoLoadPath);
-    std::string emptyString("ITK_AUTOLOAD_PATH=");
-    int putSuccess = itksys::SystemTools::PutEnv(const_cast<char*>(emptyString.c_str()));
+    int putSuccess = 1;
+    if (!useSharedMemoryTransfer)
+    {
+      std::string emptyString("ITK_AUTOLOAD_PATH=");
+      putSuccess = itksys::SystemTools::PutEnv(const_cast<char*>(emptyString.c_str()));
+    }
     if (!putSuccess)
     {
       vtkErrorMacro("Unable to reset ITK_AUTOLOAD_PATH.");
     }
+    // Limit the number of threads used by ITK and OpenMP in the executable
+    std::string saveITKNumberOfThreads;
+    std::string saveOMPNumberOfThreads;
+    bool hasITKNumberOfThreads = itksys::SystemTools::GetEnv("ITK_GLOBAL_DEFAULT_NUMBER_OF_THREADS", saveITKNumberOfThreads);
+    bool hasOMPNumberOfThreads = itksys::SystemTools::GetEnv("OMP_NUM_THREADS", saveOMPNumberOfThreads);
+    if (numberOfThreads > 0)
+    {
+      itksys::SystemTools::PutEnv("ITK_GLOBAL_DEFAULT_NUMBER_OF_THREADS=" + std::to_string(numberOfThreads));
+      itksys::SystemTools::PutEnv("OMP_NUM_THREADS=" + std::to_string(numberOfThreads));
+    }
     //
     // now run the process
     //
     itksysProcess* process = itksysProcess_New();
 
+    this->Internal->ProcessesKillLock.lock();
     this->Internal->Processes.push_back(process);
+    this->Internal->ProcessesKillLock.unlock();
 
     // setup the command
     itksysProcess_SetCommand(process, command);
@@ -1743,6 +2317,26 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void* clientdata)
     {
       vtkErrorMacro("Unable to restore ITK_AUTOLOAD_PATH. ");
     }
+    if (numberOfThreads > 0)
+    {
+      if (hasITKNumberOfThreads)
+      {
+        itksys::SystemTools::PutEnv("ITK_GLOBAL_DEFAULT_NUMBER_OF_THREADS=" + saveITKNumberOfThreads);
+      }
+      else
+      {
+        itksys::SystemTools::UnPutEnv("ITK_GLOBAL_DEFAULT_NUMBER_OF_THREADS");
+      }
+      if (hasOMPNumberOfThreads)
+      {
+        itksys::SystemTools::PutEnv("OMP_NUM_THREADS=" + saveOMPNumberOfThreads);
+      }
+      else
+      {
+        itksys::SystemTools::UnPutEnv("OMP_NUM_THREADS");
+      }
+    }
+    launchLock.unlock();
 
     // Wait for the command to finish
     char* tbuffer;
@@ -1769,7 +2363,9 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void* clientdata)
       if (node0->GetModuleDescription().GetProcessInformation()->Abort)
       {
         itksysProcess_Kill(process);
+        this->Internal->ProcessesKillLock.lock();
         this->Internal->Processes.erase(std::find(this->Internal->Processes.begin(), this->Internal->Processes.end(), process));
+        this->Internal->ProcessesKillLock.unlock();
         node0->GetModuleDescription().GetProcessInformation()->Progress = 0;
         node0->GetModuleDescription().GetProcessInformation()->StageProgress = 0;
         this->GetApplicationLogic()->RequestModified(node0);
@@ -2086,7 +2682,8 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void* clientdata)
           displayData = false;
         }
 
-        bool deleteFile = this->GetDeleteTemporaryFiles();
+        // Shared memory images are always removed, as they would keep occupying memory
+        bool deleteFile = this->GetDeleteTemporaryFiles() || vtkMRMLVolumeSharedMemoryTransfer::IsSharedMemoryFileName((*id2fn0).second);
         vtkMTimeType requestUID = this->GetApplicationLogic()->RequestReadFile((*id2fn0).first.c_str(), (*id2fn0).second.c_str(), displayData, deleteFile);
         this->Internal->SetLastRequest(node0, requestUID);
 
@@ -2264,6 +2861,17 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void* clientdata)
   //
   delete[] command;
 
+  // Remove shared memory images of inputs (and outputs that were not
+  // loaded), regardless of DeleteTemporaryFiles, as they would keep
+  // occupying memory until the computer is restarted
+  for (const std::string& fileToDelete : filesToDelete)
+  {
+    if (vtkMRMLVolumeSharedMemoryTransfer::IsSharedMemoryFileName(fileToDelete))
+    {
+      vtkMRMLVolumeSharedMemoryTransfer::RemoveSharedMemory(fileToDelete);
+    }
+  }
+
   // Remove any remaining temporary files.  At this point, these files
   // should be the files written as inputs to the module
   if (this->GetDeleteTemporaryFiles())
@@ -2429,6 +3037,7 @@ void vtkSlicerCLIModuleLogic::ProcessMRMLLogicsEvents(vtkObject* caller, unsigne
       event == vtkSlicerApplicationLogic::RequestProcessedEvent)
   {
     vtkMTimeType uid = reinterpret_cast<vtkMTimeType>(callData);
+    std::unique_lock<std::mutex> lock(this->Internal->LastRequestsLock);
     vtkInternal::RequestType::iterator it = std::find_if(this->Internal->LastRequests.begin(), this->Internal->LastRequests.end(), vtkInternal::FindRequest(uid));
     if (it != this->Internal->LastRequests.end())
     {
@@ -2437,6 +3046,7 @@ void vtkSlicerCLIModuleLogic::ProcessMRMLLogicsEvents(vtkObject* caller, unsigne
       // on the application logic.
       assert(node->GetStatus() == vtkMRMLCommandLineModuleNode::Completing);
       this->Internal->LastRequests.erase(it);
+      lock.unlock();
       // we are not interested in any request anymore because the cli node is
       // Completed.
 
@@ -26,6 +26,9 @@ class ModuleParameter;
 class vtkMRMLModelHierarchyNode;
 class MRMLIDMap;
 
+// VTK includes
+class vtkCollection;
+
 // STL includes
 #include <string>
 
@@ -51,6 +54,17 @@ public:
   vtkTypeMacro(vtkSlicerCLIModuleLogic, vtkSlicerModuleLogic);
   void PrintSelf(ostream& os, vtkIndent indent) override;
 
+  /// List of custom events fired by the class.
+  enum Events
+  {
+    RequestHierarchyEditEvent = vtkCommand::UserEvent + 1,
+    /// Invoked in the main thread when a job of a batch finished execution.
+    /// Call data is the command line module node of the job.
+    BatchJobCompletedEvent,
+    /// Invoked in the main thread when all jobs of a batch finished execution.
+    BatchCompletedEvent
+  };
+
   /// The default module description is used when creating new nodes.
   /// \sa CreateNode()
   void SetDefaultModuleDescription(const ModuleDescription& moduleDescription);
@@ -93,6 +107,16 @@ public:
   void SetAllowInMemoryTransfer(int value);
   int GetAllowInMemoryTransfer() const;
 
+  /// Control use of shared memory data transfer of volumes by this specific CLI,
+  /// when it runs as a command line executable. Input and output volumes are then passed
+  /// as "shm:" references instead of temporary files, which requires the executable to read
+  /// and write images with ITK and have MRMLIDIOPlugin in its ITK_AUTOLOAD_PATH.
+  /// Only scalar, labelmap, and vector volumes are transferred this way, and only on platforms
+  /// where shared memory images are supported (see vtkMRMLVolumeSharedMemoryTransfer::IsSupported()).
+  /// Disabled by default.
+  void SetAllowSharedMemoryTransfer(int value);
+  int GetAllowSharedMemoryTransfer() const;
+
   /// Control whether the CLI process window is hidden (Windows only, defaults to 1).
   void SetHideWindow(int value);
   int GetHideWindow() const;
@@ -119,6 +143,72 @@ public:
   /// in the node selectors.
   void ApplyAndWait(vtkMRMLCommandLineModuleNode* node, bool updateDisplay = true);
 
+  /// Schedules a batch of jobs to run. Each job is a command line module node
+  /// that holds one parameter set (for example one case of a cohort).
+  /// Jobs are started in the order of the collection, each in its own thread,
+  /// and up to GetNumberOfConcurrentBatchJobs() of them run at the same time.
+  /// Outputs are loaded into the scene the same way as for Apply().
+  /// Modules that run in the application process (shared object and Python
+  /// modules) are run one job at a time, as they redirect process-wide output streams.
+  /// This method is non blocking and returns false if the previous batch is
+  /// still running or there is no job to run.
+  /// \sa ApplyBatchAndWait(), CancelBatch(), IsBatchRunning(), GetBatchProgress()
+  bool ApplyBatch(vtkCollection* nodes, bool updateDisplay = false);
+
+  /// Runs a batch of jobs and waits until all the jobs are completed and their
+  /// outputs are loaded into the scene.
+  /// \sa ApplyBatch()
+  bool ApplyBatchAndWait(vtkCollection* nodes, bool updateDisplay = false);
+
+  /// Cancels all queued and running jobs of the current batch.
+  void CancelBatch();
+
+  /// Returns true if any job of the current batch is queued, running, or its outputs are being loaded.
+  bool IsBatchRunning();
+
+  /// Number of CPU cores that the jobs of a batch may use in total.
+  /// The cores are evenly distributed between concurrently running jobs: the number of threads
+  /// of each command line executable is limited by setting ITK_GLOBAL_DEFAULT_NUMBER_OF_THREADS
+  /// and OMP_NUM_THREADS environment variables.
+  /// If 0 (default) then all the CPU cores of the computer are used.
+  void SetBatchCPUCoreBudget(int numberOfCores);
+  int GetBatchCPUCoreBudget() const;
+
+  /// Maximum number of jobs of a batch that run at the same time.
+  /// If 0 (default) then the number of concurrent jobs is the CPU core budget,
+  /// which is optimal for single-threaded modules. Setting a lower value
+  /// allows each job to use more threads and reduces memory usage.
+  /// Takes effect when the next batch is applied.
+  void SetMaximumNumberOfConcurrentBatchJobs(int numberOfJobs);
+  int GetMaximumNumberOfConcurrentBatchJobs() const;
+
+  /// Number of jobs of the current batch that run at the same time
+  /// and the number of threads each of them may use.
+  int GetNumberOfConcurrentBatchJobs();
+  int GetNumberOfThreadsPerBatchJob();
+
+  /// Number of jobs in the current batch.
+  int GetNumberOfBatchJobs();
+  /// Command line module node of a job of the current batch.
+  /// Its status, error text and outputs tell the result of the job.
+  vtkMRMLCommandLineModuleNode* GetNthBatchJobNode(int jobIndex);
+  /// Time (in seconds) spent executing a job of the current batch.
+  /// Returns 0 if the job has not started yet.
+  double GetNthBatchJobElapsedTime(int jobIndex);
+
+  /// Number of jobs of the current batch that are completed successfully,
+  /// completed with errors, or cancelled.
+  int GetNumberOfCompletedBatchJobs();
+  int GetNumberOfFailedBatchJobs();
+  int GetNumberOfCancelledBatchJobs();
+
+  /// Progress of the current batch, between 0 and 1.
+  /// Progress of running jobs is included.
+  double GetBatchProgress();
+  /// Time (in seconds) since the current batch was applied,
+  /// until the last job finished execution.
+  double GetBatchElapsedTime();
+
   void KillProcesses();
 
   //   void LazyEvaluateModuleTarget(ModuleDescription& moduleDescriptionObject);
@@ -138,17 +228,29 @@ protected:
   /// Reimplemented to observe vtkSlicerApplicationLogic.
   void ProcessMRMLLogicsEvents(vtkObject*, long unsigned int, void*) override;
 
+  /// \a executionTag is added to the file name to make it unique if the same node
+  /// is used by several modules that run at the same time.
   std::string ConstructTemporaryFileName(const std::string& tag,
                                          const std::string& type,
                                          const std::string& name,
                                          const std::vector<std::string>& extensions,
-                                         CommandLineModuleType commandType);
+                                         CommandLineModuleType commandType,
+                                         const std::string& executionTag = std::string());
   std::string ConstructTemporarySceneFileName(vtkMRMLScene* scene);
+  /// Returns true if the image parameter can be passed to a command line executable in shared memory.
+  bool CanUseSharedMemoryTransfer(const std::string& type, const std::string& name, const std::vector<std::string>& extensions);
   std::string FindHiddenNodeID(const ModuleDescription& d, const ModuleParameter& p);
 
+  /// The method that runs the jobs of the current batch in a worker thread
+  void ProcessBatchJobs();
+
   // The method that runs the command line module
   void ApplyTask(void* clientdata);
 
+  /// Called instead of ApplyTask if the task is removed from the queue before it is run.
+  /// Sets the node status to Cancelled.
+  void CancelScheduledTask(void* clientdata);
+
   // Communicate progress back to the node
   static void ProgressCallback(void*);
 
@@ -163,12 +265,6 @@ protected:
   /// Call apply because the node requests it.
   void AutoRun(vtkMRMLCommandLineModuleNode* cliNode);
 
-  /// List of custom events fired by the class.
-  enum Events
-  {
-    RequestHierarchyEditEvent = vtkCommand::UserEvent + 1
-  };
-
   // Add a model hierarchy node and all its descendants to a scene (miniscene to sent to a CLI).
   // The mapping of ids from the original scene to the mini scene is put in (added to) sceneToMiniSceneMap.
   // Any files that will be created by writing out the miniscene are added to filesToDelete (i.e. models)
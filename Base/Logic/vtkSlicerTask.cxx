@@ -11,8 +11,10 @@ vtkSlicerTask::vtkSlicerTask()
 {
   this->TaskObject = nullptr;
   this->TaskFunction = nullptr;
+  this->CancelFunction = nullptr;
   this->TaskClientData = nullptr;
   this->Type = vtkSlicerTask::Undefined;
+  this->Priority = 0;
 }
 //----------------------------------------------------------------------------
 vtkSlicerTask::~vtkSlicerTask() = default;
@@ -25,6 +27,12 @@ void vtkSlicerTask::SetTaskFunction(vtkMRMLAbstractLogic* object, vtkMRMLAbstrac
   this->TaskClientData = clientdata;
 }
 
+//----------------------------------------------------------------------------
+void vtkSlicerTask::SetCancelFunction(vtkMRMLAbstractLogic::TaskFunctionPointer function)
+{
+  this->CancelFunction = function;
+}
+
 //----------------------------------------------------------------------------
 void vtkSlicerTask::Execute()
 {
@@ -34,8 +42,19 @@ void vtkSlicerTask::Execute()
   }
 }
 
+//----------------------------------------------------------------------------
+void vtkSlicerTask::Cancel()
+{
+  if (this->TaskObject && this->CancelFunction)
+  {
+    ((*this->TaskObject).*(this->CancelFunction))(this->TaskClientData);
+  }
+}
+
 //----------------------------------------------------------------------------
 void vtkSlicerTask::PrintSelf(ostream& os, vtkIndent indent)
 {
   Superclass::PrintSelf(os, indent);
+  os << indent << "Type: " << this->GetTypeAsString() << "\n";
+  os << indent << "Priority: " << this->Priority << "\n";
 }
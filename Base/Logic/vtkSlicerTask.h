@@ -19,10 +19,20 @@ public:
   /// Set the function and object to call for the task.
   void SetTaskFunction(vtkMRMLAbstractLogic*, TaskFunctionPointer, void* clientdata);
 
+  ///
+  /// Set the function of the task object to call if the task is removed from the
+  /// queue before it is executed (see vtkSlicerApplicationLogic::CancelTask()).
+  /// The function is called with the client data of the task, on the thread that cancels the task.
+  void SetCancelFunction(TaskFunctionPointer);
+
   ///
   /// Execute the task.
   virtual void Execute();
 
+  ///
+  /// Notify the task object that the task will not be executed.
+  virtual void Cancel();
+
   ///
   /// The type of task - this can be used, for example, to decide
   /// how many concurrent threads should be allowed
@@ -38,6 +48,15 @@ public:
   void SetTypeToProcessing() { this->SetType(vtkSlicerTask::Processing); };
   void SetTypeToNetworking() { this->SetType(vtkSlicerTask::Networking); };
 
+  ///
+  /// Priority of the task. Among the queued tasks of the same type the one with
+  /// the highest priority is executed first (tasks with the same priority are
+  /// executed in the order they were scheduled). Default is 0.
+  /// SetPriority() may only be called before the task is scheduled. Use
+  /// vtkSlicerApplicationLogic::SetTaskPriority() to change the priority of a queued task.
+  vtkSetMacro(Priority, int);
+  vtkGetMacro(Priority, int);
+
   const char* GetTypeAsString()
   {
     switch (this->Type)
@@ -58,8 +77,10 @@ protected:
 private:
   vtkSmartPointer<vtkMRMLAbstractLogic> TaskObject;
   vtkMRMLAbstractLogic::TaskFunctionPointer TaskFunction;
+  vtkMRMLAbstractLogic::TaskFunctionPointer CancelFunction;
   void* TaskClientData;
 
   int Type;
+  int Priority;
 };
 #endif
@@ -198,6 +198,17 @@ wchar_t* QStringToPythonWCharPointer(QString str)
 } // namespace
 #endif
 
+namespace
+{
+//-----------------------------------------------------------------------------
+void RequestProcessEventQueueCallback(vtkObject* vtkNotUsed(caller), unsigned long vtkNotUsed(eid), void* clientData, void* vtkNotUsed(callData))
+{
+  // Process all the events that are queued until the next iteration of the event loop at once
+  QObject* context = static_cast<QObject*>(clientData);
+  QTimer::singleShot(0, context, []() { vtkEventBroker::GetInstance()->ProcessEventQueue(); });
+}
+} // namespace
+
 //-----------------------------------------------------------------------------
 // qSlicerCoreApplicationPrivate methods
 
@@ -237,6 +248,9 @@ qSlicerCoreApplicationPrivate::~qSlicerCoreApplicationPrivate()
 #endif
 
   this->AppLogic->TerminateProcessingThread();
+
+  // The event broker singleton may outlive the application
+  vtkEventBroker::GetInstance()->SetRequestProcessEventQueueCallback(nullptr);
 }
 
 //-----------------------------------------------------------------------------
@@ -404,6 +418,15 @@ void qSlicerCoreApplicationPrivate::init()
     vtkEventBroker::GetInstance()->SetRequestModifiedCallback(modifiedRequestCallback);
   }
 
+  // Create callback function that processes the event queue of the event broker
+  // when it is used in asynchronous mode.
+  {
+    vtkNew<vtkCallbackCommand> processEventQueueRequestCallback;
+    processEventQueueRequestCallback->SetClientData(q);
+    processEventQueueRequestCallback->SetCallback(RequestProcessEventQueueCallback);
+    vtkEventBroker::GetInstance()->SetRequestProcessEventQueueCallback(processEventQueueRequestCallback);
+  }
+
   // Set up translation in MRML classes using Qt translator
   { // placed in a block to avoid memory leaks on quick exit at handlePreApplicationCommandLineArguments
     vtkNew<vtkQtTranslator> mrmlTranslator;
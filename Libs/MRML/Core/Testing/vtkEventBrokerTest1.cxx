@@ -0,0 +1,236 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkEventBroker.h"
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLJsonElement.h"
+#include "vtkMRMLModelNode.h"
+#include "vtkMRMLScalarVolumeNode.h"
+
+// VTK includes
+#include <vtkCallbackCommand.h>
+#include <vtkNew.h>
+#include <vtkSmartPointer.h>
+
+namespace
+{
+
+int ModifiedCallCount = 0;
+int ProcessRequestCount = 0;
+int RecursionDepth = 0;
+
+//---------------------------------------------------------------------------
+void ModifiedCallback(vtkObject* vtkNotUsed(caller), unsigned long vtkNotUsed(eid), void* vtkNotUsed(clientData), void* vtkNotUsed(callData))
+{
+  ModifiedCallCount++;
+}
+
+//---------------------------------------------------------------------------
+void RequestProcessEventQueueCallback(vtkObject* vtkNotUsed(caller), unsigned long vtkNotUsed(eid), void* vtkNotUsed(clientData), void* vtkNotUsed(callData))
+{
+  ProcessRequestCount++;
+}
+
+//---------------------------------------------------------------------------
+/// Modifies the object passed in clientData (nested event)
+void ModifyClientDataCallback(vtkObject* vtkNotUsed(caller), unsigned long vtkNotUsed(eid), void* clientData, void* vtkNotUsed(callData))
+{
+  reinterpret_cast<vtkObject*>(clientData)->Modified();
+}
+
+//---------------------------------------------------------------------------
+/// Modifies the caller again (recursive event)
+void ModifyCallerCallback(vtkObject* caller, unsigned long vtkNotUsed(eid), void* vtkNotUsed(clientData), void* vtkNotUsed(callData))
+{
+  if (RecursionDepth < 2)
+  {
+    RecursionDepth++;
+    caller->Modified();
+    RecursionDepth--;
+  }
+}
+
+//---------------------------------------------------------------------------
+int TestEventProfiling(const std::string& tempDir)
+{
+  vtkEventBroker* broker = vtkEventBroker::GetInstance();
+  broker->ResetEventProfile();
+
+  // outerSubject modified -> innerSubject modified -> ModifiedCallback
+  vtkNew<vtkMRMLScalarVolumeNode> outerSubject;
+  vtkNew<vtkMRMLModelNode> innerSubject;
+  vtkNew<vtkMRMLModelNode> observer;
+  vtkNew<vtkCallbackCommand> nestingCallback;
+  nestingCallback->SetCallback(ModifyClientDataCallback);
+  nestingCallback->SetClientData(innerSubject.GetPointer());
+  broker->AddObservation(outerSubject, vtkCommand::ModifiedEvent, observer, nestingCallback);
+  vtkNew<vtkCallbackCommand> modifiedCallback;
+  modifiedCallback->SetCallback(ModifiedCallback);
+  broker->AddObservation(innerSubject, vtkCommand::ModifiedEvent, observer, modifiedCallback);
+
+  // Nothing is recorded while profiling is disabled
+  CHECK_BOOL(broker->GetEventProfiling(), false);
+  outerSubject->Modified();
+  CHECK_INT(broker->GetNumberOfEventProfileEntries(), 0);
+
+  broker->EventProfilingOn();
+  for (int i = 0; i < 5; ++i)
+  {
+    outerSubject->Modified();
+  }
+  CHECK_INT(broker->GetNumberOfEventProfileEntries(), 2);
+  CHECK_INT(broker->GetNumberOfEventProfileTraceEvents(), 10);
+  CHECK_INT(static_cast<int>(broker->GetEventProfileInvocationCount("vtkMRMLScalarVolumeNode", vtkCommand::ModifiedEvent, "vtkMRMLModelNode")), 5);
+  CHECK_INT(static_cast<int>(broker->GetEventProfileInvocationCount("vtkMRMLModelNode")), 5);
+  CHECK_INT(static_cast<int>(broker->GetEventProfileInvocationCount(nullptr)), 10);
+  CHECK_INT(static_cast<int>(broker->GetEventProfileInvocationCount(nullptr, vtkCommand::DeleteEvent)), 0);
+  CHECK_INT(broker->GetEventProfileMaximumNestingLevel("vtkMRMLScalarVolumeNode"), 1);
+  CHECK_INT(broker->GetEventProfileMaximumNestingLevel("vtkMRMLModelNode"), 2);
+  CHECK_INT(static_cast<int>(broker->GetEventProfileRecursiveInvocationCount(nullptr)), 0);
+  // outer invocation time includes the nested invocation time
+  CHECK_BOOL(broker->GetEventProfileTotalElapsedTime("vtkMRMLScalarVolumeNode") >= broker->GetEventProfileTotalElapsedTime("vtkMRMLModelNode"), true);
+  CHECK_BOOL(broker->GetEventProfileMaximumElapsedTime(nullptr) <= broker->GetEventProfileTotalElapsedTime(nullptr), true);
+
+  // Recursive invocations
+  vtkNew<vtkMRMLModelNode> recursiveSubject;
+  vtkNew<vtkCallbackCommand> recursiveCallback;
+  recursiveCallback->SetCallback(ModifyCallerCallback);
+  broker->AddObservation(recursiveSubject, vtkCommand::ModifiedEvent, observer, recursiveCallback);
+  broker->ResetEventProfile();
+  CHECK_INT(broker->GetNumberOfEventProfileEntries(), 0);
+  CHECK_INT(broker->GetNumberOfEventProfileTraceEvents(), 0);
+  recursiveSubject->Modified();
+  CHECK_INT(static_cast<int>(broker->GetEventProfileInvocationCount("vtkMRMLModelNode")), 3);
+  CHECK_INT(static_cast<int>(broker->GetEventProfileRecursiveInvocationCount("vtkMRMLModelNode")), 2);
+  CHECK_INT(broker->GetEventProfileMaximumNestingLevel("vtkMRMLModelNode"), 3);
+
+  // Number of stored trace events is limited
+  outerSubject->Modified();
+  broker->SetMaximumNumberOfEventProfileTraceEvents(6);
+  outerSubject->Modified();
+  CHECK_INT(broker->GetNumberOfEventProfileTraceEvents(), 6);
+  CHECK_INT(static_cast<int>(broker->GetEventProfileInvocationCount("vtkMRMLScalarVolumeNode")), 2);
+  broker->SetMaximumNumberOfEventProfileTraceEvents(100000);
+
+  // Export
+  std::string profileFileName = tempDir + "/vtkEventBrokerTest1_profile.json";
+  CHECK_BOOL(broker->WriteEventProfile(profileFileName.c_str()), true);
+  vtkNew<vtkMRMLJsonReader> reader;
+  vtkSmartPointer<vtkMRMLJsonElement> profile = vtkSmartPointer<vtkMRMLJsonElement>::Take(reader->ReadFromFile(profileFileName.c_str()));
+  CHECK_NOT_NULL(profile);
+  vtkSmartPointer<vtkMRMLJsonElement> profileEntries = vtkSmartPointer<vtkMRMLJsonElement>::Take(profile->GetArrayProperty("eventProfile"));
+  CHECK_NOT_NULL(profileEntries);
+  CHECK_INT(profileEntries->GetArraySize(), broker->GetNumberOfEventProfileEntries());
+  int totalInvocationCount = 0;
+  for (int entryIndex = 0; entryIndex < profileEntries->GetArraySize(); ++entryIndex)
+  {
+    vtkSmartPointer<vtkMRMLJsonElement> entry = vtkSmartPointer<vtkMRMLJsonElement>::Take(profileEntries->GetArrayItem(entryIndex));
+    CHECK_STD_STRING(entry->GetStringProperty("event"), "ModifiedEvent");
+    CHECK_STD_STRING(entry->GetStringProperty("observerClass"), "vtkMRMLModelNode");
+    totalInvocationCount += entry->GetIntProperty("invocationCount");
+  }
+  CHECK_INT(totalInvocationCount, static_cast<int>(broker->GetEventProfileInvocationCount(nullptr)));
+
+  std::string traceFileName = tempDir + "/vtkEventBrokerTest1_trace.json";
+  CHECK_BOOL(broker->WriteEventProfileTrace(traceFileName.c_str()), true);
+  vtkSmartPointer<vtkMRMLJsonElement> trace = vtkSmartPointer<vtkMRMLJsonElement>::Take(reader->ReadFromFile(traceFileName.c_str()));
+  CHECK_NOT_NULL(trace);
+  vtkSmartPointer<vtkMRMLJsonElement> traceEvents = vtkSmartPointer<vtkMRMLJsonElement>::Take(trace->GetArrayProperty("traceEvents"));
+  CHECK_NOT_NULL(traceEvents);
+  CHECK_INT(traceEvents->GetArraySize(), 6);
+  vtkSmartPointer<vtkMRMLJsonElement> traceEvent = vtkSmartPointer<vtkMRMLJsonElement>::Take(traceEvents->GetArrayItem(0));
+  CHECK_STD_STRING(traceEvent->GetStringProperty("ph"), "X");
+  CHECK_STD_STRING(traceEvent->GetStringProperty("name"), "vtkMRMLModelNode.ModifiedEvent -> vtkMRMLModelNode");
+  CHECK_BOOL(traceEvent->GetDoubleProperty("dur") >= 0.0, true);
+
+  broker->EventProfilingOff();
+  broker->ResetEventProfile();
+  outerSubject->Modified();
+  CHECK_INT(broker->GetNumberOfEventProfileEntries(), 0);
+
+  broker->RemoveObservations(observer);
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//---------------------------------------------------------------------------
+int vtkEventBrokerTest1(int argc, char* argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " /path/to/temp" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::string tempDir = argv[1];
+
+  vtkEventBroker* broker = vtkEventBroker::GetInstance();
+
+  vtkNew<vtkMRMLModelNode> subject;
+  vtkNew<vtkMRMLModelNode> observer;
+  vtkNew<vtkCallbackCommand> modifiedCallback;
+  modifiedCallback->SetCallback(ModifiedCallback);
+  broker->AddObservation(subject, vtkCommand::ModifiedEvent, observer, modifiedCallback);
+
+  vtkNew<vtkCallbackCommand> requestCallback;
+  requestCallback->SetCallback(RequestProcessEventQueueCallback);
+  broker->SetRequestProcessEventQueueCallback(requestCallback);
+
+  // Synchronous mode: each event is delivered immediately
+  broker->ResetEventQueueStatistics();
+  subject->Modified();
+  subject->Modified();
+  CHECK_INT(ModifiedCallCount, 2);
+  CHECK_INT(ProcessRequestCount, 0);
+  CHECK_INT(static_cast<int>(broker->GetNumberOfQueuedEvents()), 0);
+
+  // Asynchronous mode: repeated events are coalesced into a single delivery
+  ModifiedCallCount = 0;
+  broker->SetEventModeToAsynchronous();
+  for (int i = 0; i < 100; ++i)
+  {
+    subject->Modified();
+  }
+  CHECK_INT(ModifiedCallCount, 0);
+  CHECK_INT(broker->GetNumberOfQueuedObservations(), 1);
+  CHECK_INT(ProcessRequestCount, 1);
+  CHECK_INT(static_cast<int>(broker->GetNumberOfQueuedEvents()), 100);
+  CHECK_INT(static_cast<int>(broker->GetNumberOfCoalescedEvents()), 99);
+
+  broker->ProcessEventQueue();
+  CHECK_INT(ModifiedCallCount, 1);
+  CHECK_INT(broker->GetNumberOfQueuedObservations(), 0);
+  CHECK_INT(static_cast<int>(broker->GetNumberOfProcessedEvents()), 1);
+
+  // Processing is requested again for events queued after the queue was processed
+  subject->Modified();
+  CHECK_INT(ProcessRequestCount, 2);
+
+  // Switching back to synchronous mode delivers queued events
+  broker->SetEventModeToSynchronous();
+  CHECK_INT(ModifiedCallCount, 2);
+  CHECK_INT(broker->GetNumberOfQueuedObservations(), 0);
+
+  broker->ResetEventQueueStatistics();
+  CHECK_INT(static_cast<int>(broker->GetNumberOfQueuedEvents()), 0);
+  CHECK_INT(static_cast<int>(broker->GetNumberOfCoalescedEvents()), 0);
+  CHECK_INT(static_cast<int>(broker->GetNumberOfProcessedEvents()), 0);
+
+  broker->SetRequestProcessEventQueueCallback(nullptr);
+  broker->RemoveObservations(subject, observer);
+
+  CHECK_EXIT_SUCCESS(TestEventProfiling(tempDir));
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,186 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLLinearTransformNode.h"
+#include "vtkMRMLLinearTransformSequenceStorageNode.h"
+#include "vtkMRMLScene.h"
+#include "vtkMRMLSequenceNode.h"
+#include "vtkMRMLSequenceStorageNode.h"
+
+// VTK includes
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtksys/SystemTools.hxx>
+
+// STL includes
+#include <sstream>
+
+namespace
+{
+
+//---------------------------------------------------------------------------
+void SetFrameMatrix(vtkMatrix4x4* matrix, int frameIndex)
+{
+  matrix->Identity();
+  matrix->SetElement(0, 3, frameIndex * 1.5);
+  matrix->SetElement(1, 3, -frameIndex * 0.25);
+  matrix->SetElement(0, 1, frameIndex * 0.001);
+}
+
+//---------------------------------------------------------------------------
+int CheckFrames(vtkMRMLSequenceNode* sequenceNode, int numberOfFrames)
+{
+  CHECK_INT(sequenceNode->GetNumberOfDataNodes(), numberOfFrames);
+  vtkNew<vtkMatrix4x4> expectedMatrix;
+  vtkNew<vtkMatrix4x4> matrix;
+  for (int frameIndex = 0; frameIndex < numberOfFrames; ++frameIndex)
+  {
+    // Text files store index values with 3 decimal digits, therefore only the numeric value is compared
+    CHECK_DOUBLE_TOLERANCE(atof(sequenceNode->GetNthIndexValue(frameIndex).c_str()), frameIndex * 0.1, 1e-6);
+    SetFrameMatrix(expectedMatrix, frameIndex);
+    CHECK_BOOL(sequenceNode->GetNthMatrixTransformToParent(frameIndex, matrix), true);
+    for (int i = 0; i < 4; ++i)
+    {
+      for (int j = 0; j < 4; ++j)
+      {
+        CHECK_DOUBLE_TOLERANCE(matrix->GetElement(i, j), expectedMatrix->GetElement(i, j), 1e-6);
+      }
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//---------------------------------------------------------------------------
+int vtkMRMLLinearTransformSequenceStorageNodeTest1(int argc, char* argv[])
+{
+  if (argc != 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " /path/to/temp" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string tempDir = argv[1];
+  const int numberOfFrames = 100;
+
+  vtkNew<vtkMRMLLinearTransformSequenceStorageNode> node1;
+  EXERCISE_ALL_BASIC_MRML_METHODS(node1.GetPointer());
+
+  // Record transforms in compact form
+  vtkNew<vtkMRMLScene> scene;
+  vtkMRMLSequenceNode* sequenceNode = vtkMRMLSequenceNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLSequenceNode", "Tool"));
+  CHECK_NOT_NULL(sequenceNode);
+  sequenceNode->CompactLinearTransformStorageOn();
+  vtkNew<vtkMatrix4x4> matrix;
+  for (int frameIndex = 0; frameIndex < numberOfFrames; ++frameIndex)
+  {
+    SetFrameMatrix(matrix, frameIndex);
+    std::stringstream indexValue;
+    indexValue << frameIndex * 0.1;
+    CHECK_BOOL(sequenceNode->SetMatrixTransformToParentAtValue(matrix, indexValue.str()), true);
+  }
+  CHECK_EXIT_SUCCESS(CheckFrames(sequenceNode, numberOfFrames));
+  CHECK_BOOL(sequenceNode->IsNthDataNodeCompact(5), true);
+  CHECK_STD_STRING(sequenceNode->GetDataNodeClassName(), "vtkMRMLLinearTransformNode");
+  CHECK_INT(sequenceNode->GetSequenceScene()->GetNumberOfNodes(), 0);
+
+  // Data node is created when it is accessed and released when it is unloaded
+  vtkMRMLLinearTransformNode* transformNode = vtkMRMLLinearTransformNode::SafeDownCast(sequenceNode->GetNthDataNode(5));
+  CHECK_NOT_NULL(transformNode);
+  CHECK_INT(sequenceNode->GetSequenceScene()->GetNumberOfNodes(), 1);
+  vtkNew<vtkMatrix4x4> modifiedMatrix;
+  SetFrameMatrix(modifiedMatrix, 5);
+  modifiedMatrix->SetElement(2, 3, 7.0);
+  transformNode->SetMatrixTransformToParent(modifiedMatrix);
+  CHECK_BOOL(sequenceNode->UnloadNthDataNode(5), true);
+  CHECK_INT(sequenceNode->GetSequenceScene()->GetNumberOfNodes(), 0);
+  CHECK_BOOL(sequenceNode->GetNthMatrixTransformToParent(5, matrix), true);
+  CHECK_DOUBLE_TOLERANCE(matrix->GetElement(2, 3), 7.0, 1e-6);
+  modifiedMatrix->SetElement(2, 3, 0.0);
+  sequenceNode->SetMatrixTransformToParentAtValue(modifiedMatrix, sequenceNode->GetNthIndexValue(5));
+
+  // Write and read binary transforms
+  std::string binaryFileName = tempDir + "/vtkMRMLLinearTransformSequenceStorageNodeTest1Binary.seq.mha";
+  vtksys::SystemTools::RemoveFile(binaryFileName);
+  vtkNew<vtkMRMLLinearTransformSequenceStorageNode> binaryStorageNode;
+  scene->AddNode(binaryStorageNode);
+  binaryStorageNode->SetFileName(binaryFileName.c_str());
+  binaryStorageNode->WriteBinaryTransformsOn();
+  CHECK_INT(binaryStorageNode->WriteData(sequenceNode), 1);
+  CHECK_BOOL(vtkMRMLLinearTransformSequenceStorageNode::IsBinaryTransformsFile(binaryFileName), true);
+
+  vtkMRMLSequenceNode* binarySequenceNode = vtkMRMLSequenceNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLSequenceNode"));
+  CHECK_INT(binaryStorageNode->ReadData(binarySequenceNode), 1);
+  CHECK_EXIT_SUCCESS(CheckFrames(binarySequenceNode, numberOfFrames));
+  CHECK_BOOL(binarySequenceNode->IsNthDataNodeCompact(0), false);
+  CHECK_NOT_NULL(vtkMRMLLinearTransformNode::SafeDownCast(binarySequenceNode->GetNthDataNode(0)));
+
+  // Write text transforms and read them in compact form
+  std::string textFileName = tempDir + "/vtkMRMLLinearTransformSequenceStorageNodeTest1Text.seq.mha";
+  // Text writer appends transforms to the header of an existing file
+  vtksys::SystemTools::RemoveFile(textFileName);
+  vtkNew<vtkMRMLLinearTransformSequenceStorageNode> textStorageNode;
+  scene->AddNode(textStorageNode);
+  textStorageNode->SetFileName(textFileName.c_str());
+  CHECK_INT(textStorageNode->WriteData(binarySequenceNode), 1);
+  CHECK_BOOL(vtkMRMLLinearTransformSequenceStorageNode::IsBinaryTransformsFile(textFileName), false);
+
+  vtkMRMLSequenceNode* textSequenceNode = vtkMRMLSequenceNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLSequenceNode"));
+  textSequenceNode->CompactLinearTransformStorageOn();
+  CHECK_INT(textStorageNode->ReadData(textSequenceNode), 1);
+  CHECK_EXIT_SUCCESS(CheckFrames(textSequenceNode, numberOfFrames));
+  CHECK_BOOL(textSequenceNode->IsNthDataNodeCompact(0), true);
+
+  // Copy keeps items in compact form
+  vtkNew<vtkMRMLSequenceNode> copiedSequenceNode;
+  copiedSequenceNode->Copy(sequenceNode);
+  CHECK_EXIT_SUCCESS(CheckFrames(copiedSequenceNode, numberOfFrames));
+  CHECK_BOOL(copiedSequenceNode->IsNthDataNodeCompact(0), true);
+
+  // Writing a bundle creates data nodes of compact items only temporarily
+  std::string bundleFileName = tempDir + "/vtkMRMLLinearTransformSequenceStorageNodeTest1.seq.mrb";
+  vtksys::SystemTools::RemoveFile(bundleFileName);
+  vtkNew<vtkMRMLSequenceStorageNode> bundleStorageNode;
+  scene->AddNode(bundleStorageNode);
+  bundleStorageNode->SetFileName(bundleFileName.c_str());
+  CHECK_BOOL(textSequenceNode->GetNthDataNode(3) != nullptr, true);
+  CHECK_INT(bundleStorageNode->WriteData(textSequenceNode), 1);
+  CHECK_BOOL(vtksys::SystemTools::FileExists(bundleFileName), true);
+  CHECK_BOOL(textSequenceNode->IsNthDataNodeLoaded(0), false);
+  CHECK_BOOL(textSequenceNode->IsNthDataNodeLoaded(3), true);
+  CHECK_BOOL(textSequenceNode->UnloadNthDataNode(3), true);
+  CHECK_INT(textSequenceNode->GetSequenceScene()->GetNumberOfNodes(), 0);
+  CHECK_EXIT_SUCCESS(CheckFrames(textSequenceNode, numberOfFrames));
+
+  // Index values that contain the separator character are preserved in binary files
+  vtkMRMLSequenceNode* textIndexSequenceNode = vtkMRMLSequenceNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLSequenceNode"));
+  textIndexSequenceNode->SetIndexType(vtkMRMLSequenceNode::TextIndex);
+  const char* textIndexValues[] = { "first;second", " with spaces ", "100%3B" };
+  for (const char* textIndexValue : textIndexValues)
+  {
+    CHECK_BOOL(textIndexSequenceNode->SetMatrixTransformToParentAtValue(matrix, textIndexValue), true);
+  }
+  CHECK_INT(binaryStorageNode->WriteData(textIndexSequenceNode), 1);
+  vtkMRMLSequenceNode* readTextIndexSequenceNode = vtkMRMLSequenceNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLSequenceNode"));
+  readTextIndexSequenceNode->SetIndexType(vtkMRMLSequenceNode::TextIndex);
+  CHECK_INT(binaryStorageNode->ReadData(readTextIndexSequenceNode), 1);
+  CHECK_INT(readTextIndexSequenceNode->GetNumberOfDataNodes(), 3);
+  for (int itemNumber = 0; itemNumber < 3; ++itemNumber)
+  {
+    CHECK_STD_STRING(readTextIndexSequenceNode->GetNthIndexValue(itemNumber), textIndexSequenceNode->GetNthIndexValue(itemNumber));
+  }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
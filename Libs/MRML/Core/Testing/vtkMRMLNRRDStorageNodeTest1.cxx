@@ -17,5 +17,15 @@ int vtkMRMLNRRDStorageNodeTest1(int, char*[])
 {
   vtkNew<vtkMRMLNRRDStorageNode> node1;
   EXERCISE_ALL_BASIC_MRML_METHODS(node1.GetPointer());
+
+  // Default preset compresses data in parallel with the fastest compression level
+  CHECK_INT(node1->GetNumberOfCompressionPresets(), 5);
+  CHECK_STD_STRING(node1->GetCompressionParameter(), node1->GetCompressionParameterFastestMultiThreaded());
+  CHECK_STD_STRING(node1->GetDisplayNameFromCompressionParameter(node1->GetCompressionParameterFastestMultiThreaded()), "Fastest (multi-threaded)");
+  CHECK_INT(vtkMRMLStorageNode::GetGzipCompressionLevelFromCompressionParameter(node1->GetCompressionParameterFastestMultiThreaded()), 1);
+  CHECK_INT(vtkMRMLStorageNode::GetGzipCompressionNumberOfThreadsFromCompressionParameter(node1->GetCompressionParameterFastestMultiThreaded()), 0);
+  CHECK_INT(vtkMRMLStorageNode::GetGzipCompressionLevelFromCompressionParameter(node1->GetCompressionParameterMinimumSize()), 9);
+  CHECK_INT(vtkMRMLStorageNode::GetGzipCompressionNumberOfThreadsFromCompressionParameter(node1->GetCompressionParameterMinimumSize()), 1);
+
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,187 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLModelDisplayNode.h"
+#include "vtkMRMLModelNode.h"
+#include "vtkMRMLScene.h"
+#include "vtkMRMLScriptedModuleNode.h"
+
+// VTK includes
+#include <vtkCollection.h>
+#include <vtkNew.h>
+#include <vtkSmartPointer.h>
+#include <vtkTimerLog.h>
+
+// STL includes
+#include <vector>
+
+namespace
+{
+
+//---------------------------------------------------------------------------
+std::vector<vtkMRMLNode*> GetNodesByClassByTraversal(vtkMRMLScene* scene, const char* className)
+{
+  std::vector<vtkMRMLNode*> nodes;
+  vtkMRMLNode* node;
+  vtkCollectionSimpleIterator it;
+  for (scene->GetNodes()->InitTraversal(it); (node = vtkMRMLNode::SafeDownCast(scene->GetNodes()->GetNextItemAsObject(it)));)
+  {
+    if (node->IsA(className))
+    {
+      nodes.push_back(node);
+    }
+  }
+  return nodes;
+}
+
+//---------------------------------------------------------------------------
+bool CheckNodesByClass(vtkMRMLScene* scene, const char* className)
+{
+  std::vector<vtkMRMLNode*> expectedNodes = GetNodesByClassByTraversal(scene, className);
+  std::vector<vtkMRMLNode*> nodes;
+  scene->GetNodesByClass(className, nodes);
+  if (nodes != expectedNodes)
+  {
+    std::cerr << "Line " << __LINE__ << ": GetNodesByClass(" << className << ") returned " << nodes.size() //
+              << " nodes, expected " << expectedNodes.size() << " (or node order differs)" << std::endl;
+    return false;
+  }
+  vtkSmartPointer<vtkCollection> nodeCollection = vtkSmartPointer<vtkCollection>::Take(scene->GetNodesByClass(className));
+  if (nodeCollection->GetNumberOfItems() != static_cast<int>(expectedNodes.size()) //
+      || scene->GetNumberOfNodesByClass(className) != static_cast<int>(expectedNodes.size()))
+  {
+    std::cerr << "Line " << __LINE__ << ": number of " << className << " nodes mismatch" << std::endl;
+    return false;
+  }
+  for (size_t nodeIndex = 0; nodeIndex < expectedNodes.size(); ++nodeIndex)
+  {
+    if (nodeCollection->GetItemAsObject(static_cast<int>(nodeIndex)) != expectedNodes[nodeIndex] //
+        || scene->GetNthNodeByClass(static_cast<int>(nodeIndex), className) != expectedNodes[nodeIndex])
+    {
+      std::cerr << "Line " << __LINE__ << ": " << className << " node " << nodeIndex << " mismatch" << std::endl;
+      return false;
+    }
+  }
+  if (scene->GetFirstNodeByClass(className) != (expectedNodes.empty() ? nullptr : expectedNodes[0]) //
+      || scene->GetNthNodeByClass(static_cast<int>(expectedNodes.size()), className) != nullptr)
+  {
+    std::cerr << "Line " << __LINE__ << ": first or past-the-end " << className << " node mismatch" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+//---------------------------------------------------------------------------
+bool CheckAllClasses(vtkMRMLScene* scene)
+{
+  return CheckNodesByClass(scene, "vtkMRMLNode") //
+         && CheckNodesByClass(scene, "vtkMRMLStorableNode") //
+         && CheckNodesByClass(scene, "vtkMRMLDisplayableNode") //
+         && CheckNodesByClass(scene, "vtkMRMLModelNode") //
+         && CheckNodesByClass(scene, "vtkMRMLDisplayNode") //
+         && CheckNodesByClass(scene, "vtkMRMLScriptedModuleNode") //
+         && CheckNodesByClass(scene, "vtkMRMLTransformNode");
+}
+
+//---------------------------------------------------------------------------
+void AddNodes(vtkMRMLScene* scene, int numberOfNodes)
+{
+  for (int nodeIndex = 0; nodeIndex < numberOfNodes; ++nodeIndex)
+  {
+    switch (nodeIndex % 3)
+    {
+      case 0: scene->AddNewNodeByClass("vtkMRMLModelNode"); break;
+      case 1: scene->AddNewNodeByClass("vtkMRMLModelDisplayNode"); break;
+      default: scene->AddNewNodeByClass("vtkMRMLScriptedModuleNode"); break;
+    }
+  }
+}
+
+} // end of anonymous namespace
+
+//---------------------------------------------------------------------------
+int vtkMRMLSceneNodesByClassTest(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  vtkNew<vtkMRMLScene> scene;
+  CHECK_BOOL(CheckAllClasses(scene), true);
+
+  // Nodes added after the first query are appended to the class lists
+  AddNodes(scene, 30);
+  CHECK_BOOL(CheckAllClasses(scene), true);
+  AddNodes(scene, 10);
+  CHECK_BOOL(CheckAllClasses(scene), true);
+
+  // Removed nodes
+  std::vector<vtkMRMLNode*> modelNodes;
+  scene->GetNodesByClass("vtkMRMLModelNode", modelNodes);
+  scene->RemoveNode(modelNodes[0]);
+  scene->RemoveNode(modelNodes[5]);
+  scene->RemoveNode(modelNodes.back());
+  CHECK_BOOL(CheckAllClasses(scene), true);
+
+  // Nodes inserted in the middle of the scene
+  vtkNew<vtkMRMLModelNode> insertedBeforeNode;
+  scene->InsertBeforeNode(modelNodes[3], insertedBeforeNode);
+  CHECK_BOOL(CheckAllClasses(scene), true);
+  vtkNew<vtkMRMLModelNode> insertedAfterNode;
+  scene->InsertAfterNode(modelNodes[2], insertedAfterNode);
+  CHECK_BOOL(CheckAllClasses(scene), true);
+
+  // Singleton lookup
+  vtkNew<vtkMRMLScriptedModuleNode> singletonNode;
+  singletonNode->SetSingletonTag("NodesByClassTest");
+  scene->AddNode(singletonNode);
+  CHECK_POINTER(scene->GetSingletonNode("NodesByClassTest", "vtkMRMLScriptedModuleNode"), singletonNode.GetPointer());
+  CHECK_NULL(scene->GetSingletonNode("NodesByClassTest", "vtkMRMLModelNode"));
+  CHECK_BOOL(CheckAllClasses(scene), true);
+
+  // Cleared scene
+  scene->Clear(1);
+  CHECK_BOOL(CheckAllClasses(scene), true);
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkMRMLModelNode"), 0);
+
+  // Benchmark: query nodes by class in a large scene
+  const int numberOfNodes = 15000;
+  const int numberOfQueries = 200;
+  AddNodes(scene, numberOfNodes);
+  CHECK_BOOL(CheckAllClasses(scene), true);
+
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  size_t numberOfFoundNodesByTraversal = 0;
+  for (int queryIndex = 0; queryIndex < numberOfQueries; ++queryIndex)
+  {
+    numberOfFoundNodesByTraversal += GetNodesByClassByTraversal(scene, "vtkMRMLDisplayableNode").size();
+  }
+  timer->StopTimer();
+  double traversalTime = timer->GetElapsedTime();
+
+  timer->StartTimer();
+  size_t numberOfFoundNodes = 0;
+  std::vector<vtkMRMLNode*> displayableNodes;
+  for (int queryIndex = 0; queryIndex < numberOfQueries; ++queryIndex)
+  {
+    numberOfFoundNodes += scene->GetNodesByClass("vtkMRMLDisplayableNode", displayableNodes);
+  }
+  timer->StopTimer();
+  double indexTime = timer->GetElapsedTime();
+
+  CHECK_INT(static_cast<int>(numberOfFoundNodes), static_cast<int>(numberOfFoundNodesByTraversal));
+  std::cout << numberOfQueries << " queries of displayable nodes in a scene of " << scene->GetNumberOfNodes() << " nodes:" << std::endl
+            << "  scene traversal: " << traversalTime << " s" << std::endl
+            << "  node class index: " << indexTime << " s" << std::endl;
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,141 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLScalarVolumeNode.h"
+#include "vtkMRMLScene.h"
+#include "vtkMRMLVolumeArchetypeStorageNode.h"
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkMinimalStandardRandomSequence.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkTimerLog.h>
+
+// STL includes
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+
+//---------------------------------------------------------------------------
+double ImportScene(const std::string& sceneFileName, bool parallelDataLoading, vtkMRMLScene* scene)
+{
+  scene->SetURL(sceneFileName.c_str());
+  scene->SetParallelDataLoading(parallelDataLoading);
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  scene->Connect();
+  timer->StopTimer();
+  return timer->GetElapsedTime();
+}
+
+} // end of anonymous namespace
+
+//---------------------------------------------------------------------------
+int vtkMRMLSceneParallelDataLoadingTest(int argc, char* argv[])
+{
+  if (argc != 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " /path/to/temp" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string tempDir = argv[1];
+  const int numberOfVolumes = 20;
+  const int dimensions[3] = { 128, 128, 64 };
+
+  // Write a scene with a number of volumes
+  std::string sceneFileName = tempDir + "/vtkMRMLSceneParallelDataLoadingTest.mrml";
+  std::vector<std::string> volumeNodeIDs;
+  {
+    vtkNew<vtkMRMLScene> scene;
+    scene->SetRootDirectory(tempDir.c_str());
+    vtkNew<vtkMinimalStandardRandomSequence> random;
+    random->SetSeed(1);
+    for (int volumeIndex = 0; volumeIndex < numberOfVolumes; ++volumeIndex)
+    {
+      vtkNew<vtkImageData> imageData;
+      imageData->SetDimensions(dimensions[0], dimensions[1], dimensions[2]);
+      imageData->AllocateScalars(VTK_SHORT, 1);
+      vtkDataArray* scalars = imageData->GetPointData()->GetScalars();
+      for (vtkIdType valueIndex = 0; valueIndex < scalars->GetNumberOfValues(); ++valueIndex)
+      {
+        random->Next();
+        scalars->SetTuple1(valueIndex, random->GetRangeValue(-1000.0, 1000.0));
+      }
+
+      vtkMRMLScalarVolumeNode* volumeNode = vtkMRMLScalarVolumeNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLScalarVolumeNode"));
+      CHECK_NOT_NULL(volumeNode);
+      volumeNode->SetAndObserveImageData(imageData);
+      CHECK_BOOL(volumeNode->AddDefaultStorageNode(), true);
+      vtkMRMLVolumeArchetypeStorageNode* storageNode = vtkMRMLVolumeArchetypeStorageNode::SafeDownCast(volumeNode->GetStorageNode());
+      CHECK_NOT_NULL(storageNode);
+      std::stringstream fileName;
+      fileName << tempDir << "/vtkMRMLSceneParallelDataLoadingTest_" << volumeIndex << ".nrrd";
+      storageNode->SetFileName(fileName.str().c_str());
+      storageNode->SetUseCompression(false);
+      CHECK_BOOL(storageNode->WriteData(volumeNode), true);
+      volumeNodeIDs.emplace_back(volumeNode->GetID());
+    }
+    scene->SetURL(sceneFileName.c_str());
+    CHECK_INT(scene->Commit(), 1);
+  }
+
+  // Load the scene sequentially and in parallel
+  vtkNew<vtkMRMLScene> sequentialScene;
+  double sequentialTime = ImportScene(sceneFileName, false, sequentialScene);
+  vtkNew<vtkMRMLScene> parallelScene;
+  double parallelTime = ImportScene(sceneFileName, true, parallelScene);
+  CHECK_BOOL(parallelScene->GetParallelDataLoading(), true);
+
+  std::cout << "Loading " << numberOfVolumes << " volumes:" << std::endl;
+  std::cout << "  sequential: " << sequentialTime << " s" << std::endl;
+  std::cout << "  parallel:   " << parallelTime << " s" << std::endl;
+  if (parallelTime > 0.0)
+  {
+    std::cout << "  speedup:    " << sequentialTime / parallelTime << "x" << std::endl;
+  }
+
+  // Check that the same data is loaded
+  for (const std::string& volumeNodeID : volumeNodeIDs)
+  {
+    vtkMRMLScalarVolumeNode* sequentialVolumeNode = vtkMRMLScalarVolumeNode::SafeDownCast(sequentialScene->GetNodeByID(volumeNodeID));
+    vtkMRMLScalarVolumeNode* parallelVolumeNode = vtkMRMLScalarVolumeNode::SafeDownCast(parallelScene->GetNodeByID(volumeNodeID));
+    CHECK_NOT_NULL(sequentialVolumeNode);
+    CHECK_NOT_NULL(parallelVolumeNode);
+    vtkImageData* sequentialImage = sequentialVolumeNode->GetImageData();
+    vtkImageData* parallelImage = parallelVolumeNode->GetImageData();
+    CHECK_NOT_NULL(sequentialImage);
+    CHECK_NOT_NULL(parallelImage);
+    int* parallelDimensions = parallelImage->GetDimensions();
+    CHECK_INT(parallelDimensions[0], dimensions[0]);
+    CHECK_INT(parallelDimensions[1], dimensions[1]);
+    CHECK_INT(parallelDimensions[2], dimensions[2]);
+    CHECK_INT(parallelImage->GetScalarType(), sequentialImage->GetScalarType());
+    size_t imageSize = static_cast<size_t>(dimensions[0]) * dimensions[1] * dimensions[2] * parallelImage->GetScalarSize();
+    CHECK_INT(memcmp(sequentialImage->GetScalarPointer(), parallelImage->GetScalarPointer(), imageSize), 0);
+
+    // Data can be preloaded directly, too
+    vtkMRMLVolumeArchetypeStorageNode* storageNode = vtkMRMLVolumeArchetypeStorageNode::SafeDownCast(parallelVolumeNode->GetStorageNode());
+    CHECK_NOT_NULL(storageNode);
+    CHECK_BOOL(storageNode->PreloadData(parallelVolumeNode), true);
+    storageNode->ReleasePreloadedData();
+  }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,197 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLScalarVolumeNode.h"
+#include "vtkMRMLScene.h"
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+
+namespace
+{
+
+//---------------------------------------------------------------------------
+vtkMRMLScalarVolumeNode* AddVolumeNode(vtkMRMLScene* scene)
+{
+  vtkNew<vtkImageData> imageData;
+  imageData->SetDimensions(32, 32, 32);
+  imageData->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+  imageData->GetPointData()->GetScalars()->Fill(1);
+
+  vtkNew<vtkMRMLScalarVolumeNode> volumeNode;
+  volumeNode->SetUndoEnabled(true);
+  volumeNode->SetAndObserveImageData(imageData);
+  scene->AddNode(volumeNode);
+  return volumeNode;
+}
+
+//---------------------------------------------------------------------------
+int TestCopyOnWriteReuse()
+{
+  vtkNew<vtkMRMLScene> scene;
+  scene->SetUndoOn();
+  vtkMRMLScalarVolumeNode* volumeNode = AddVolumeNode(scene);
+
+  // Node copies are not shared between undo states by default
+  CHECK_BOOL(scene->GetUndoCopyOnWrite(), false);
+  scene->SaveStateForUndo();
+  vtkTypeInt64 volumeCopySize = scene->GetUndoMemorySize();
+  CHECK_BOOL(volumeCopySize > 32 * 32 * 32, true);
+  scene->SaveStateForUndo();
+  scene->SaveStateForUndo();
+  CHECK_INT(scene->GetNumberOfUndoLevels(), 3);
+  CHECK_BOOL(scene->GetUndoMemorySize() == 3 * volumeCopySize, true);
+  scene->ClearUndoStack();
+  CHECK_BOOL(scene->GetUndoMemorySize() == 0, true);
+
+  // Unmodified node copy is shared between undo states
+  scene->UndoCopyOnWriteOn();
+  scene->SaveStateForUndo();
+  scene->SaveStateForUndo();
+  scene->SaveStateForUndo();
+  CHECK_INT(scene->GetNumberOfUndoLevels(), 3);
+  CHECK_BOOL(scene->GetUndoMemorySize() == volumeCopySize, true);
+
+  // Modified node is copied again
+  volumeNode->SetOrigin(10.0, 0.0, 0.0);
+  scene->SaveStateForUndo();
+  CHECK_INT(scene->GetNumberOfUndoLevels(), 4);
+  CHECK_BOOL(scene->GetUndoMemorySize() == 2 * volumeCopySize, true);
+
+  // Modified voxels are detected, too
+  volumeNode->GetImageData()->GetPointData()->GetScalars()->Fill(2);
+  volumeNode->GetImageData()->Modified();
+  scene->SaveStateForUndo();
+  CHECK_BOOL(scene->GetUndoMemorySize() == 3 * volumeCopySize, true);
+
+  // Undo restores the node from the copy stored in the undo state
+  volumeNode->SetOrigin(20.0, 0.0, 0.0);
+  scene->Undo();
+  CHECK_DOUBLE_TOLERANCE(volumeNode->GetOrigin()[0], 10.0, 1e-6);
+  scene->Undo();
+  CHECK_DOUBLE_TOLERANCE(volumeNode->GetOrigin()[0], 10.0, 1e-6);
+  scene->Undo();
+  CHECK_DOUBLE_TOLERANCE(volumeNode->GetOrigin()[0], 0.0, 1e-6);
+  CHECK_INT(scene->GetNumberOfUndoLevels(), 2);
+
+  return EXIT_SUCCESS;
+}
+
+//---------------------------------------------------------------------------
+int TestDetachOnUndo()
+{
+  vtkNew<vtkMRMLScene> scene;
+  scene->SetUndoOn();
+  scene->UndoCopyOnWriteOn();
+  vtkMRMLScalarVolumeNode* volumeNode = AddVolumeNode(scene);
+  std::string volumeNodeID = volumeNode->GetID();
+
+  // Both undo states share the same node copy
+  scene->SaveStateForUndo();
+  vtkTypeInt64 volumeCopySize = scene->GetUndoMemorySize();
+  scene->SaveStateForUndo();
+  CHECK_BOOL(scene->GetUndoMemorySize() == volumeCopySize, true);
+
+  // Undo of the node removal adds the node copy of the last undo state to the scene
+  scene->RemoveNode(volumeNode);
+  CHECK_NULL(scene->GetNodeByID(volumeNodeID));
+  scene->Undo();
+  vtkMRMLScalarVolumeNode* restoredVolumeNode = vtkMRMLScalarVolumeNode::SafeDownCast(scene->GetNodeByID(volumeNodeID));
+  CHECK_NOT_NULL(restoredVolumeNode);
+  CHECK_DOUBLE_TOLERANCE(restoredVolumeNode->GetOrigin()[0], 0.0, 1e-6);
+
+  // The earlier undo state got its own copy, which is not in the scene
+  CHECK_INT(scene->GetNumberOfUndoLevels(), 1);
+  CHECK_BOOL(scene->GetUndoMemorySize() == volumeCopySize, true);
+
+  // Modifying the restored node does not alter the earlier undo state
+  restoredVolumeNode->SetOrigin(10.0, 0.0, 0.0);
+  restoredVolumeNode->GetImageData()->GetPointData()->GetScalars()->Fill(2);
+  restoredVolumeNode->GetImageData()->Modified();
+  scene->Undo();
+  CHECK_INT(scene->GetNumberOfUndoLevels(), 0);
+  CHECK_POINTER(scene->GetNodeByID(volumeNodeID), restoredVolumeNode);
+  CHECK_DOUBLE_TOLERANCE(restoredVolumeNode->GetOrigin()[0], 0.0, 1e-6);
+  CHECK_DOUBLE_TOLERANCE(restoredVolumeNode->GetImageData()->GetScalarComponentAsDouble(0, 0, 0, 0), 1.0, 1e-6);
+
+  return EXIT_SUCCESS;
+}
+
+//---------------------------------------------------------------------------
+int TestMemoryCap()
+{
+  vtkNew<vtkMRMLScene> scene;
+  scene->SetUndoOn();
+  scene->UndoCopyOnWriteOn();
+  vtkMRMLScalarVolumeNode* volumeNode = AddVolumeNode(scene);
+  CHECK_BOOL(scene->GetMaximumUndoMemorySize() == 0, true);
+
+  scene->SaveStateForUndo();
+  vtkTypeInt64 volumeCopySize = scene->GetUndoMemorySize();
+
+  // Oldest undo states are removed when the limit is exceeded
+  scene->SetMaximumUndoMemorySize(volumeCopySize * 5 / 2);
+  for (int stateIndex = 1; stateIndex <= 5; ++stateIndex)
+  {
+    volumeNode->SetOrigin(stateIndex, 0.0, 0.0);
+    scene->SaveStateForUndo();
+    CHECK_BOOL(scene->GetUndoMemorySize() <= scene->GetMaximumUndoMemorySize(), true);
+  }
+  CHECK_INT(scene->GetNumberOfUndoLevels(), 2);
+
+  // Shared node copies are counted only once, therefore unmodified states are not removed
+  scene->SaveStateForUndo();
+  scene->SaveStateForUndo();
+  CHECK_INT(scene->GetNumberOfUndoLevels(), 4);
+
+  // Remaining states are the most recent ones
+  volumeNode->SetOrigin(100.0, 0.0, 0.0);
+  scene->Undo();
+  CHECK_DOUBLE_TOLERANCE(volumeNode->GetOrigin()[0], 5.0, 1e-6);
+  scene->ClearRedoStack();
+
+  // Reducing the limit trims the stack immediately, but the most recent state is always kept
+  scene->SetMaximumUndoMemorySize(1);
+  CHECK_INT(scene->GetNumberOfUndoLevels(), 1);
+  volumeNode->SetOrigin(100.0, 0.0, 0.0);
+  scene->Undo();
+  CHECK_DOUBLE_TOLERANCE(volumeNode->GetOrigin()[0], 5.0, 1e-6);
+
+  // No limit
+  scene->SetMaximumUndoMemorySize(0);
+  for (int stateIndex = 1; stateIndex <= 5; ++stateIndex)
+  {
+    volumeNode->SetOrigin(stateIndex, 0.0, 0.0);
+    scene->SaveStateForUndo();
+  }
+  CHECK_INT(scene->GetNumberOfUndoLevels(), 5);
+  CHECK_BOOL(scene->GetUndoMemorySize() == 5 * volumeCopySize, true);
+
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//---------------------------------------------------------------------------
+int vtkMRMLSceneUndoTest(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  CHECK_EXIT_SUCCESS(TestCopyOnWriteReuse());
+  CHECK_EXIT_SUCCESS(TestDetachOnUndo());
+  CHECK_EXIT_SUCCESS(TestMemoryCap());
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
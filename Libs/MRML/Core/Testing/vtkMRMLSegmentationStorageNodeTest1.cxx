@@ -40,6 +40,9 @@ int vtkMRMLSegmentationStorageNodeTest1(int argc, char* argv[])
   scene->AddNode(node1.GetPointer());
   EXERCISE_ALL_BASIC_MRML_METHODS(node1.GetPointer());
 
+  // Segmentations are compressed in parallel with the default zlib compression level
+  CHECK_STD_STRING(node1->GetCompressionParameter(), vtkMRMLStorageNode::GetCompressionParameterNormalMultiThreaded());
+
   if (argc != 5)
   {
     std::cerr << "Line " << __LINE__ << " - Missing or extra parameters!\n"
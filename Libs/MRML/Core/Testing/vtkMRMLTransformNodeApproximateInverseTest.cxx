@@ -0,0 +1,180 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLTransformNode.h"
+#include "vtkOrientedGridTransform.h"
+
+// VTK includes
+#include <vtkGeneralTransform.h>
+#include <vtkImageData.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+
+// STD includes
+#include <cmath>
+#include <vector>
+
+namespace
+{
+
+//---------------------------------------------------------------------------
+/// Smooth displacement field on a 21x21x21 grid with 5mm spacing centered at the origin
+void CreateGridTransform(vtkOrientedGridTransform* gridTransform, double amplitude)
+{
+  vtkNew<vtkImageData> displacementGrid;
+  displacementGrid->SetOrigin(-50.0, -50.0, -50.0);
+  displacementGrid->SetSpacing(5.0, 5.0, 5.0);
+  displacementGrid->SetDimensions(21, 21, 21);
+  displacementGrid->AllocateScalars(VTK_DOUBLE, 3);
+  double* displacement = static_cast<double*>(displacementGrid->GetScalarPointer());
+  for (int k = 0; k < 21; ++k)
+  {
+    for (int j = 0; j < 21; ++j)
+    {
+      for (int i = 0; i < 21; ++i, displacement += 3)
+      {
+        double x = -50.0 + i * 5.0;
+        double y = -50.0 + j * 5.0;
+        double z = -50.0 + k * 5.0;
+        displacement[0] = amplitude * sin(y / 30.0);
+        displacement[1] = amplitude * cos(z / 30.0);
+        displacement[2] = amplitude * sin(x / 30.0);
+      }
+    }
+  }
+  gridTransform->SetInterpolationModeToCubic();
+  gridTransform->SetDisplacementGridData(displacementGrid);
+}
+
+//---------------------------------------------------------------------------
+std::vector<double> CreateTestPoints(int numberOfPoints)
+{
+  vtkMath::RandomSeed(42);
+  std::vector<double> points;
+  for (int pointIndex = 0; pointIndex < numberOfPoints * 3; ++pointIndex)
+  {
+    points.push_back(vtkMath::Random(-35.0, 35.0));
+  }
+  return points;
+}
+
+//---------------------------------------------------------------------------
+double GetMaximumDistance(vtkAbstractTransform* transform, vtkAbstractTransform* expectedTransform, const std::vector<double>& points)
+{
+  double maximumDistance = 0.0;
+  for (size_t pointIndex = 0; pointIndex < points.size(); pointIndex += 3)
+  {
+    double transformedPoint[3] = { 0.0, 0.0, 0.0 };
+    transform->TransformPoint(&points[pointIndex], transformedPoint);
+    double expectedTransformedPoint[3] = { 0.0, 0.0, 0.0 };
+    expectedTransform->TransformPoint(&points[pointIndex], expectedTransformedPoint);
+    maximumDistance = std::max(maximumDistance, sqrt(vtkMath::Distance2BetweenPoints(transformedPoint, expectedTransformedPoint)));
+  }
+  return maximumDistance;
+}
+
+} // end of anonymous namespace
+
+//---------------------------------------------------------------------------
+int vtkMRMLTransformNodeApproximateInverseTest(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  const std::vector<double> points = CreateTestPoints(500);
+
+  vtkNew<vtkMRMLTransformNode> transformNode;
+  vtkNew<vtkOrientedGridTransform> gridTransform;
+  CreateGridTransform(gridTransform, 3.0);
+  transformNode->SetAndObserveTransformFromParent(gridTransform);
+
+  // Approximate inverse is disabled by default
+  CHECK_BOOL(transformNode->GetUseApproximateInverse(), false);
+  CHECK_BOOL(transformNode->IsApproximateInverseUsed(), false);
+  CHECK_DOUBLE_TOLERANCE(transformNode->GetApproximateInverseError(), -1.0, 1e-6);
+
+  // Compute the approximate inverse on the displacement grid
+  transformNode->SetUseApproximateInverse(true);
+  transformNode->UpdateApproximateInverse(true);
+  CHECK_BOOL(transformNode->IsApproximateInverseUsed(), true);
+  double approximationError = transformNode->GetApproximateInverseError();
+  std::cout << "Approximate inverse error: " << approximationError << " mm" << std::endl;
+  CHECK_BOOL(approximationError >= 0.0 && approximationError <= transformNode->GetApproximateInverseTolerance(), true);
+
+  // Transform to world uses the approximate inverse, transform from world uses the stored transform
+  vtkNew<vtkGeneralTransform> transformToWorld;
+  transformNode->GetTransformToWorld(transformToWorld);
+  CHECK_BOOL(GetMaximumDistance(transformToWorld, gridTransform->GetInverse(), points) < transformNode->GetApproximateInverseTolerance(), true);
+  vtkNew<vtkGeneralTransform> transformFromWorld;
+  transformNode->GetTransformFromWorld(transformFromWorld);
+  CHECK_DOUBLE_TOLERANCE(GetMaximumDistance(transformFromWorld, gridTransform, points), 0.0, 1e-6);
+
+  // Transform to parent remains the exact inverse (it is used for saving the transform)
+  CHECK_POINTER(transformNode->GetTransformToParent(), gridTransform->GetInverse());
+
+  // Approximation is not used if it is not accurate enough
+  transformNode->SetApproximateInverseTolerance(1e-9);
+  CHECK_BOOL(transformNode->IsApproximateInverseUsed(), false);
+  CHECK_DOUBLE_TOLERANCE(transformNode->GetApproximateInverseError(), approximationError, 1e-9);
+  transformNode->GetTransformToWorld(transformToWorld);
+  CHECK_DOUBLE_TOLERANCE(GetMaximumDistance(transformToWorld, gridTransform->GetInverse(), points), 0.0, 1e-6);
+  transformNode->SetApproximateInverseTolerance(0.1);
+
+  // Approximation is invalidated when the forward transform is modified
+  CreateGridTransform(gridTransform, 4.0);
+  CHECK_DOUBLE_TOLERANCE(transformNode->GetApproximateInverseError(), -1.0, 1e-6);
+  transformNode->GetTransformToWorld(transformToWorld);
+  CHECK_DOUBLE_TOLERANCE(GetMaximumDistance(transformToWorld, gridTransform->GetInverse(), points), 0.0, 1e-6);
+  transformNode->UpdateApproximateInverse(true);
+  CHECK_BOOL(transformNode->IsApproximateInverseUsed(), true);
+  transformNode->GetTransformToWorld(transformToWorld);
+  CHECK_BOOL(GetMaximumDistance(transformToWorld, gridTransform->GetInverse(), points) < transformNode->GetApproximateInverseTolerance(), true);
+
+  // Inverted node approximates the transform from parent
+  transformNode->Inverse();
+  transformNode->UpdateApproximateInverse(true);
+  CHECK_BOOL(transformNode->IsApproximateInverseUsed(), true);
+  transformNode->GetTransformFromWorld(transformFromWorld);
+  CHECK_BOOL(GetMaximumDistance(transformFromWorld, gridTransform->GetInverse(), points) < transformNode->GetApproximateInverseTolerance(), true);
+  transformNode->GetTransformToWorld(transformToWorld);
+  CHECK_DOUBLE_TOLERANCE(GetMaximumDistance(transformToWorld, gridTransform, points), 0.0, 1e-6);
+  transformNode->Inverse();
+
+  // Explicitly specified grid
+  transformNode->SetApproximateInverseGridOrigin(-40.0, -40.0, -40.0);
+  transformNode->SetApproximateInverseGridSpacing(2.0, 2.0, 2.0);
+  transformNode->SetApproximateInverseGridDimensions(41, 41, 41);
+  transformNode->UpdateApproximateInverse(true);
+  CHECK_BOOL(transformNode->IsApproximateInverseUsed(), true);
+  transformNode->GetTransformToWorld(transformToWorld);
+  CHECK_BOOL(GetMaximumDistance(transformToWorld, gridTransform->GetInverse(), points) < transformNode->GetApproximateInverseTolerance(), true);
+
+  // Exact inverse is used outside the grid (grid transforms would clamp the displacements there)
+  std::vector<double> outsidePoints = { 45.0, 0.0, 0.0, -44.0, 30.0, -10.0, 20.0, 42.0, 47.0 };
+  CHECK_DOUBLE_TOLERANCE(GetMaximumDistance(transformToWorld, gridTransform->GetInverse(), outsidePoints), 0.0, 1e-6);
+
+  // Disabled approximation
+  transformNode->SetUseApproximateInverse(false);
+  CHECK_BOOL(transformNode->IsApproximateInverseUsed(), false);
+  transformNode->GetTransformToWorld(transformToWorld);
+  CHECK_DOUBLE_TOLERANCE(GetMaximumDistance(transformToWorld, gridTransform->GetInverse(), points), 0.0, 1e-6);
+
+  // Node is deleted while the approximate inverse is being computed
+  {
+    vtkNew<vtkMRMLTransformNode> pendingTransformNode;
+    pendingTransformNode->SetAndObserveTransformFromParent(gridTransform);
+    pendingTransformNode->SetUseApproximateInverse(true);
+    pendingTransformNode->UpdateApproximateInverse(false);
+  }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
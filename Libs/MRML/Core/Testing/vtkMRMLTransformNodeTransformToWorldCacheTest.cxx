@@ -0,0 +1,260 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLScene.h"
+#include "vtkMRMLTransformNode.h"
+
+// VTK includes
+#include <vtkAddonMathUtilities.h>
+#include <vtkGeneralTransform.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkPoints.h>
+#include <vtkThinPlateSplineTransform.h>
+#include <vtkTimerLog.h>
+#include <vtkTransform.h>
+
+// STD includes
+#include <vector>
+
+namespace
+{
+
+//---------------------------------------------------------------------------
+void SetTransformToParent(vtkMRMLTransformNode* node, double translateX, double rotateZ)
+{
+  vtkNew<vtkTransform> transform;
+  transform->Translate(translateX, 2.0, -3.0);
+  transform->RotateZ(rotateZ);
+  node->SetMatrixTransformToParent(transform->GetMatrix());
+}
+
+//---------------------------------------------------------------------------
+/// Compute transform to world by multiplying matrices to parent (all transforms must be linear)
+void ComputeMatrixTransformToWorld(vtkMRMLTransformNode* node, vtkMatrix4x4* transformToWorld)
+{
+  transformToWorld->Identity();
+  for (vtkMRMLTransformNode* current = node; current != nullptr; current = current->GetParentTransformNode())
+  {
+    vtkNew<vtkMatrix4x4> toParentMatrix;
+    current->GetMatrixTransformToParent(toParentMatrix);
+    vtkMatrix4x4::Multiply4x4(toParentMatrix, transformToWorld, transformToWorld);
+  }
+}
+
+//---------------------------------------------------------------------------
+bool CheckLinearTransformToWorld(vtkMRMLTransformNode* node)
+{
+  vtkNew<vtkMatrix4x4> expectedTransformToWorld;
+  ComputeMatrixTransformToWorld(node, expectedTransformToWorld);
+
+  vtkNew<vtkMatrix4x4> transformToWorld;
+  if (!node->GetMatrixTransformToWorld(transformToWorld) //
+      || !vtkAddonMathUtilities::MatrixAreEqual(transformToWorld, expectedTransformToWorld, 1e-6))
+  {
+    std::cerr << "Line " << __LINE__ << ": matrix transform to world mismatch for " << node->GetName() << std::endl;
+    return false;
+  }
+
+  vtkNew<vtkMatrix4x4> expectedTransformFromWorld;
+  vtkMatrix4x4::Invert(expectedTransformToWorld, expectedTransformFromWorld);
+  vtkNew<vtkMatrix4x4> transformFromWorld;
+  if (!node->GetMatrixTransformFromWorld(transformFromWorld) //
+      || !vtkAddonMathUtilities::MatrixAreEqual(transformFromWorld, expectedTransformFromWorld, 1e-6))
+  {
+    std::cerr << "Line " << __LINE__ << ": matrix transform from world mismatch for " << node->GetName() << std::endl;
+    return false;
+  }
+
+  const double point[3] = { 10.0, -20.0, 30.0 };
+  double expectedTransformedPoint[4] = { point[0], point[1], point[2], 1.0 };
+  expectedTransformToWorld->MultiplyPoint(expectedTransformedPoint, expectedTransformedPoint);
+  vtkNew<vtkGeneralTransform> generalTransformToWorld;
+  node->GetTransformToWorld(generalTransformToWorld);
+  double transformedPoint[3] = { 0.0, 0.0, 0.0 };
+  generalTransformToWorld->TransformPoint(point, transformedPoint);
+  vtkNew<vtkGeneralTransform> generalTransformFromWorld;
+  node->GetTransformFromWorld(generalTransformFromWorld);
+  double inverseTransformedPoint[3] = { 0.0, 0.0, 0.0 };
+  generalTransformFromWorld->TransformPoint(transformedPoint, inverseTransformedPoint);
+  for (int i = 0; i < 3; ++i)
+  {
+    if (fabs(transformedPoint[i] - expectedTransformedPoint[i]) > 1e-6 || fabs(inverseTransformedPoint[i] - point[i]) > 1e-6)
+    {
+      std::cerr << "Line " << __LINE__ << ": general transform to or from world mismatch for " << node->GetName() << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+} // end of anonymous namespace
+
+//---------------------------------------------------------------------------
+int vtkMRMLTransformNodeTransformToWorldCacheTest(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  vtkNew<vtkMRMLScene> scene;
+
+  // Linear chain: leaf -> middle -> root -> world
+  vtkMRMLTransformNode* rootNode = vtkMRMLTransformNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLTransformNode", "Root"));
+  vtkMRMLTransformNode* middleNode = vtkMRMLTransformNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLTransformNode", "Middle"));
+  vtkMRMLTransformNode* leafNode = vtkMRMLTransformNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLTransformNode", "Leaf"));
+  SetTransformToParent(rootNode, 10.0, 30.0);
+  SetTransformToParent(middleNode, -5.0, 45.0);
+  SetTransformToParent(leafNode, 3.0, -60.0);
+  middleNode->SetAndObserveTransformNodeID(rootNode->GetID());
+  leafNode->SetAndObserveTransformNodeID(middleNode->GetID());
+  CHECK_BOOL(CheckLinearTransformToWorld(leafNode), true);
+  CHECK_INT(leafNode->IsTransformToWorldLinear(), 1);
+
+  // Cached results are updated when a transform in the chain changes
+  SetTransformToParent(rootNode, 20.0, 15.0);
+  CHECK_BOOL(CheckLinearTransformToWorld(leafNode), true);
+  CHECK_BOOL(CheckLinearTransformToWorld(middleNode), true);
+
+  // ...when the transform tree changes
+  leafNode->SetAndObserveTransformNodeID(rootNode->GetID());
+  CHECK_BOOL(CheckLinearTransformToWorld(leafNode), true);
+  leafNode->SetAndObserveTransformNodeID(middleNode->GetID());
+  CHECK_BOOL(CheckLinearTransformToWorld(leafNode), true);
+
+  // ...when a transform is inverted
+  middleNode->Inverse();
+  CHECK_BOOL(CheckLinearTransformToWorld(leafNode), true);
+  middleNode->Inverse();
+  CHECK_BOOL(CheckLinearTransformToWorld(leafNode), true);
+
+  // A transform retrieved earlier is not affected by later changes of the cache
+  vtkNew<vtkGeneralTransform> transformToWorldBeforeChange;
+  leafNode->GetTransformToWorld(transformToWorldBeforeChange);
+  const double point[3] = { 1.0, 2.0, 3.0 };
+  double transformedPointBeforeChange[3] = { 0.0, 0.0, 0.0 };
+  transformToWorldBeforeChange->TransformPoint(point, transformedPointBeforeChange);
+  SetTransformToParent(middleNode, 50.0, 10.0);
+  CHECK_BOOL(CheckLinearTransformToWorld(leafNode), true);
+  double transformedPointAfterChange[3] = { 0.0, 0.0, 0.0 };
+  transformToWorldBeforeChange->TransformPoint(point, transformedPointAfterChange);
+  CHECK_DOUBLE_TOLERANCE(transformedPointAfterChange[0], transformedPointBeforeChange[0], 1e-9);
+
+  // Non-linear transform in the middle of the chain
+  vtkNew<vtkPoints> sourceLandmarks;
+  vtkNew<vtkPoints> targetLandmarks;
+  const double landmarks[4][3] = { { 0.0, 0.0, 0.0 }, { 100.0, 0.0, 0.0 }, { 0.0, 100.0, 0.0 }, { 0.0, 0.0, 100.0 } };
+  for (int i = 0; i < 4; ++i)
+  {
+    sourceLandmarks->InsertNextPoint(landmarks[i]);
+    targetLandmarks->InsertNextPoint(landmarks[i][0] + (i == 1 ? 5.0 : 0.0), landmarks[i][1], landmarks[i][2] + (i == 2 ? -3.0 : 0.0));
+  }
+  vtkNew<vtkThinPlateSplineTransform> thinPlateSplineTransform;
+  thinPlateSplineTransform->SetBasisToR();
+  thinPlateSplineTransform->SetSourceLandmarks(sourceLandmarks);
+  thinPlateSplineTransform->SetTargetLandmarks(targetLandmarks);
+  vtkMRMLTransformNode* nonLinearNode = vtkMRMLTransformNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLTransformNode", "NonLinear"));
+  nonLinearNode->SetAndObserveTransformToParent(thinPlateSplineTransform);
+  nonLinearNode->SetAndObserveTransformNodeID(rootNode->GetID());
+  middleNode->SetAndObserveTransformNodeID(nonLinearNode->GetID());
+  CHECK_INT(leafNode->IsTransformToWorldLinear(), 0);
+  CHECK_INT(rootNode->IsTransformToWorldLinear(), 1);
+
+  vtkNew<vtkGeneralTransform> transformToWorld;
+  leafNode->GetTransformToWorld(transformToWorld);
+  double transformedPoint[3] = { 0.0, 0.0, 0.0 };
+  transformToWorld->TransformPoint(point, transformedPoint);
+
+  // Expected result: leaf and middle matrices, then thin-plate spline, then root matrix
+  vtkNew<vtkMatrix4x4> leafToParent;
+  leafNode->GetMatrixTransformToParent(leafToParent);
+  vtkNew<vtkMatrix4x4> middleToParent;
+  middleNode->GetMatrixTransformToParent(middleToParent);
+  vtkNew<vtkMatrix4x4> rootToParent;
+  rootNode->GetMatrixTransformToParent(rootToParent);
+  double expectedPoint[4] = { point[0], point[1], point[2], 1.0 };
+  leafToParent->MultiplyPoint(expectedPoint, expectedPoint);
+  middleToParent->MultiplyPoint(expectedPoint, expectedPoint);
+  thinPlateSplineTransform->TransformPoint(expectedPoint, expectedPoint);
+  rootToParent->MultiplyPoint(expectedPoint, expectedPoint);
+  for (int i = 0; i < 3; ++i)
+  {
+    CHECK_DOUBLE_TOLERANCE(transformedPoint[i], expectedPoint[i], 1e-6);
+  }
+
+  // Non-linear transform is updated when its landmarks change
+  targetLandmarks->SetPoint(3, 0.0, 10.0, 100.0);
+  targetLandmarks->Modified();
+  thinPlateSplineTransform->Modified();
+  leafNode->GetTransformToWorld(transformToWorld);
+  transformToWorld->TransformPoint(point, transformedPoint);
+  expectedPoint[0] = point[0];
+  expectedPoint[1] = point[1];
+  expectedPoint[2] = point[2];
+  expectedPoint[3] = 1.0;
+  leafToParent->MultiplyPoint(expectedPoint, expectedPoint);
+  middleToParent->MultiplyPoint(expectedPoint, expectedPoint);
+  thinPlateSplineTransform->TransformPoint(expectedPoint, expectedPoint);
+  rootToParent->MultiplyPoint(expectedPoint, expectedPoint);
+  for (int i = 0; i < 3; ++i)
+  {
+    CHECK_DOUBLE_TOLERANCE(transformedPoint[i], expectedPoint[i], 1e-6);
+  }
+
+  // Removing the non-linear node from the chain makes it linear again
+  middleNode->SetAndObserveTransformNodeID(rootNode->GetID());
+  CHECK_INT(leafNode->IsTransformToWorldLinear(), 1);
+  CHECK_BOOL(CheckLinearTransformToWorld(leafNode), true);
+
+  // Benchmark: repeated transform to world queries of a deep linear hierarchy
+  const int numberOfLevels = 20;
+  const int numberOfQueries = 10000;
+  std::vector<vtkMRMLTransformNode*> hierarchy;
+  for (int level = 0; level < numberOfLevels; ++level)
+  {
+    vtkMRMLTransformNode* node = vtkMRMLTransformNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLTransformNode"));
+    SetTransformToParent(node, level * 0.5, level * 3.0);
+    if (!hierarchy.empty())
+    {
+      node->SetAndObserveTransformNodeID(hierarchy.back()->GetID());
+    }
+    hierarchy.push_back(node);
+  }
+  vtkMRMLTransformNode* deepestNode = hierarchy.back();
+  CHECK_BOOL(CheckLinearTransformToWorld(deepestNode), true);
+
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  vtkNew<vtkMatrix4x4> expectedTransformToWorld;
+  for (int queryIndex = 0; queryIndex < numberOfQueries; ++queryIndex)
+  {
+    ComputeMatrixTransformToWorld(deepestNode, expectedTransformToWorld);
+  }
+  timer->StopTimer();
+  double traversalTime = timer->GetElapsedTime();
+
+  timer->StartTimer();
+  vtkNew<vtkGeneralTransform> deepTransformToWorld;
+  double deepTransformedPoint[3] = { 0.0, 0.0, 0.0 };
+  for (int queryIndex = 0; queryIndex < numberOfQueries; ++queryIndex)
+  {
+    deepestNode->GetTransformToWorld(deepTransformToWorld);
+    deepTransformToWorld->TransformPoint(point, deepTransformedPoint);
+  }
+  timer->StopTimer();
+  double cachedTime = timer->GetElapsedTime();
+
+  std::cout << numberOfQueries << " transform to world queries of a " << numberOfLevels << "-level hierarchy:" << std::endl
+            << "  parent chain traversal: " << traversalTime << " s" << std::endl
+            << "  cached transform to world: " << cachedTime << " s" << std::endl;
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,176 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLScalarVolumeNode.h"
+#include "vtkMRMLScene.h"
+#include "vtkMRMLSequenceNode.h"
+#include "vtkMRMLVolumeSequenceStorageNode.h"
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkNew.h>
+
+// STL includes
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+
+//---------------------------------------------------------------------------
+void FillFrame(vtkImageData* imageData, int frameIndex)
+{
+  short* voxels = static_cast<short*>(imageData->GetScalarPointer());
+  for (vtkIdType voxelIndex = 0; voxelIndex < imageData->GetNumberOfPoints(); ++voxelIndex)
+  {
+    voxels[voxelIndex] = static_cast<short>(frameIndex * 1000 + voxelIndex % 997 - 500);
+  }
+}
+
+} // end of anonymous namespace
+
+//---------------------------------------------------------------------------
+int vtkMRMLVolumeSequenceStorageNodeTest1(int argc, char* argv[])
+{
+  if (argc != 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " /path/to/temp" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string fileName = std::string(argv[1]) + "/vtkMRMLVolumeSequenceStorageNodeTest1.seq.nrrd";
+  const int numberOfFrames = 5;
+  const int dimensions[3] = { 20, 15, 10 };
+
+  // Write an uncompressed volume sequence
+  {
+    vtkNew<vtkMRMLScene> scene;
+    vtkMRMLSequenceNode* sequenceNode = vtkMRMLSequenceNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLSequenceNode"));
+    CHECK_NOT_NULL(sequenceNode);
+    for (int frameIndex = 0; frameIndex < numberOfFrames; ++frameIndex)
+    {
+      vtkNew<vtkImageData> imageData;
+      imageData->SetDimensions(dimensions[0], dimensions[1], dimensions[2]);
+      imageData->AllocateScalars(VTK_SHORT, 1);
+      FillFrame(imageData, frameIndex);
+      vtkNew<vtkMRMLScalarVolumeNode> volumeNode;
+      volumeNode->SetAndObserveImageData(imageData);
+      volumeNode->SetSpacing(1.5, 2.0, 2.5);
+      std::stringstream indexValue;
+      indexValue << frameIndex;
+      sequenceNode->SetDataNodeAtValue(volumeNode, indexValue.str());
+    }
+    vtkNew<vtkMRMLVolumeSequenceStorageNode> storageNode;
+    scene->AddNode(storageNode);
+    storageNode->SetFileName(fileName.c_str());
+    storageNode->SetUseCompression(false);
+    CHECK_INT(storageNode->WriteData(sequenceNode), 1);
+  }
+
+  // Read the sequence with frames loaded on demand
+  vtkNew<vtkMRMLScene> scene;
+  vtkMRMLSequenceNode* sequenceNode = vtkMRMLSequenceNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLSequenceNode"));
+  CHECK_NOT_NULL(sequenceNode);
+  vtkNew<vtkMRMLVolumeSequenceStorageNode> storageNode;
+  scene->AddNode(storageNode);
+  sequenceNode->SetAndObserveStorageNodeID(storageNode->GetID());
+  storageNode->SetFileName(fileName.c_str());
+  storageNode->LoadFramesOnDemandOn();
+  CHECK_INT(storageNode->ReadData(sequenceNode), 1);
+  CHECK_INT(sequenceNode->GetNumberOfDataNodes(), numberOfFrames);
+  for (int itemNumber = 0; itemNumber < numberOfFrames; ++itemNumber)
+  {
+    CHECK_INT(sequenceNode->GetNthDataNodeStorageFrameIndex(itemNumber), itemNumber);
+    CHECK_BOOL(sequenceNode->IsNthDataNodeLoaded(itemNumber), false);
+    vtkMRMLScalarVolumeNode* volumeNode = vtkMRMLScalarVolumeNode::SafeDownCast(sequenceNode->GetNthDataNode(itemNumber));
+    CHECK_NOT_NULL(volumeNode);
+    CHECK_NULL(volumeNode->GetImageData());
+    CHECK_DOUBLE_TOLERANCE(volumeNode->GetSpacing()[2], 2.5, 1e-6);
+  }
+
+  // Load a single frame and compare it to the original content
+  vtkNew<vtkImageData> expectedImageData;
+  expectedImageData->SetDimensions(dimensions[0], dimensions[1], dimensions[2]);
+  expectedImageData->AllocateScalars(VTK_SHORT, 1);
+  FillFrame(expectedImageData, 3);
+  CHECK_BOOL(sequenceNode->LoadNthDataNode(3), true);
+  CHECK_BOOL(sequenceNode->IsNthDataNodeLoaded(3), true);
+  CHECK_BOOL(sequenceNode->IsNthDataNodeLoaded(2), false);
+  vtkImageData* loadedImageData = vtkMRMLScalarVolumeNode::SafeDownCast(sequenceNode->GetNthDataNode(3))->GetImageData();
+  CHECK_NOT_NULL(loadedImageData);
+  int* loadedDimensions = loadedImageData->GetDimensions();
+  CHECK_INT(loadedDimensions[0], dimensions[0]);
+  CHECK_INT(loadedDimensions[1], dimensions[1]);
+  CHECK_INT(loadedDimensions[2], dimensions[2]);
+  CHECK_INT(loadedImageData->GetScalarType(), VTK_SHORT);
+  size_t imageSize = static_cast<size_t>(dimensions[0]) * dimensions[1] * dimensions[2] * sizeof(short);
+  CHECK_INT(memcmp(loadedImageData->GetScalarPointer(), expectedImageData->GetScalarPointer(), imageSize), 0);
+
+  // Prefetched frames are read in the background and used when the item is loaded
+  CHECK_BOOL(sequenceNode->UnloadNthDataNode(3), true);
+  std::vector<int> itemNumbers = { 3, 4 };
+  sequenceNode->PrefetchDataNodes(itemNumbers);
+  CHECK_INT(storageNode->GetNumberOfPrefetchedFrames(), 2);
+  CHECK_BOOL(sequenceNode->LoadNthDataNode(3), true);
+  CHECK_INT(storageNode->GetNumberOfPrefetchedFrames(), 1);
+  loadedImageData = vtkMRMLScalarVolumeNode::SafeDownCast(sequenceNode->GetNthDataNode(3))->GetImageData();
+  CHECK_NOT_NULL(loadedImageData);
+  CHECK_INT(memcmp(loadedImageData->GetScalarPointer(), expectedImageData->GetScalarPointer(), imageSize), 0);
+
+  // Copy of the sequence reads unloaded items from the same file, without loading them in the source sequence
+  vtkNew<vtkMRMLSequenceNode> sequenceNodeCopy;
+  sequenceNodeCopy->Copy(sequenceNode);
+  CHECK_BOOL(sequenceNode->IsNthDataNodeLoaded(2), false);
+  CHECK_INT(sequenceNodeCopy->GetNthDataNodeStorageFrameIndex(2), 2);
+  CHECK_BOOL(sequenceNodeCopy->IsNthDataNodeLoaded(2), false);
+  CHECK_BOOL(sequenceNodeCopy->IsNthDataNodeLoaded(3), true);
+  CHECK_BOOL(sequenceNodeCopy->LoadNthDataNode(2), true);
+  CHECK_BOOL(sequenceNode->IsNthDataNodeLoaded(2), false);
+  FillFrame(expectedImageData, 2);
+  loadedImageData = vtkMRMLScalarVolumeNode::SafeDownCast(sequenceNodeCopy->GetNthDataNode(2))->GetImageData();
+  CHECK_NOT_NULL(loadedImageData);
+  CHECK_INT(memcmp(loadedImageData->GetScalarPointer(), expectedImageData->GetScalarPointer(), imageSize), 0);
+  CHECK_BOOL(sequenceNodeCopy->UnloadNthDataNode(3), true);
+  CHECK_BOOL(sequenceNodeCopy->IsNthDataNodeLoaded(3), false);
+  CHECK_BOOL(sequenceNode->IsNthDataNodeLoaded(3), true);
+
+  // Unload and load all
+  CHECK_BOOL(sequenceNode->UnloadNthDataNode(3), true);
+  CHECK_BOOL(sequenceNode->IsNthDataNodeLoaded(3), false);
+  CHECK_BOOL(sequenceNode->LoadAllDataNodes(), true);
+  for (int itemNumber = 0; itemNumber < numberOfFrames; ++itemNumber)
+  {
+    CHECK_BOOL(sequenceNode->IsNthDataNodeLoaded(itemNumber), true);
+  }
+
+  // Items that are modified in place are kept in memory
+  loadedImageData = vtkMRMLScalarVolumeNode::SafeDownCast(sequenceNode->GetNthDataNode(2))->GetImageData();
+  *static_cast<short*>(loadedImageData->GetScalarPointer()) = 1234;
+  loadedImageData->Modified();
+  CHECK_BOOL(sequenceNode->UnloadNthDataNode(2), false);
+  CHECK_INT(sequenceNode->GetNthDataNodeStorageFrameIndex(2), -1);
+  CHECK_BOOL(sequenceNode->IsNthDataNodeLoaded(2), true);
+  CHECK_INT(*static_cast<short*>(vtkMRMLScalarVolumeNode::SafeDownCast(sequenceNode->GetNthDataNode(2))->GetImageData()->GetScalarPointer()), 1234);
+  CHECK_BOOL(sequenceNode->UnloadNthDataNode(4), true);
+
+  // Replaced items are always kept in memory
+  vtkNew<vtkMRMLScalarVolumeNode> replacementVolumeNode;
+  replacementVolumeNode->SetAndObserveImageData(expectedImageData);
+  sequenceNode->SetDataNodeAtValue(replacementVolumeNode, "1");
+  CHECK_INT(sequenceNode->GetNthDataNodeStorageFrameIndex(1), -1);
+  CHECK_BOOL(sequenceNode->UnloadNthDataNode(1), false);
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
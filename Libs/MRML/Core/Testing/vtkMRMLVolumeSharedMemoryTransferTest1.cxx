@@ -0,0 +1,131 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLScalarVolumeNode.h"
+#include "vtkMRMLVolumeSharedMemoryTransfer.h"
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+
+// STL includes
+#include <cstring>
+
+//---------------------------------------------------------------------------
+int vtkMRMLVolumeSharedMemoryTransferTest1(int, char*[])
+{
+  CHECK_BOOL(vtkMRMLVolumeSharedMemoryTransfer::IsSharedMemoryFileName("shm:/Slicer1_1"), true);
+  CHECK_BOOL(vtkMRMLVolumeSharedMemoryTransfer::IsSharedMemoryFileName("slicer:0x1234#vtkMRMLScalarVolumeNode1"), false);
+  CHECK_BOOL(vtkMRMLVolumeSharedMemoryTransfer::IsSharedMemoryFileName("/tmp/shm:volume.nrrd"), false);
+  std::string fileName = vtkMRMLVolumeSharedMemoryTransfer::CreateUniqueFileName();
+  CHECK_BOOL(vtkMRMLVolumeSharedMemoryTransfer::IsSharedMemoryFileName(fileName), true);
+  CHECK_BOOL(fileName != vtkMRMLVolumeSharedMemoryTransfer::CreateUniqueFileName(), true);
+
+  if (!vtkMRMLVolumeSharedMemoryTransfer::IsSupported())
+  {
+    std::cout << "Shared memory images are not supported on this platform." << std::endl;
+    return EXIT_SUCCESS;
+  }
+
+  // Write a volume with non-trivial geometry into shared memory
+  vtkNew<vtkImageData> imageData;
+  imageData->SetDimensions(20, 15, 10);
+  imageData->AllocateScalars(VTK_SHORT, 1);
+  short* voxels = static_cast<short*>(imageData->GetScalarPointer());
+  for (vtkIdType voxelIndex = 0; voxelIndex < imageData->GetNumberOfPoints(); ++voxelIndex)
+  {
+    voxels[voxelIndex] = static_cast<short>(voxelIndex % 997 - 500);
+  }
+  vtkNew<vtkMRMLScalarVolumeNode> volumeNode;
+  volumeNode->SetAndObserveImageData(imageData);
+  volumeNode->SetSpacing(1.5, 2.0, 2.5);
+  volumeNode->SetOrigin(10.0, -20.0, 30.0);
+  double ijkDirections[3][3] = { { 0.0, 1.0, 0.0 }, { -1.0, 0.0, 0.0 }, { 0.0, 0.0, 1.0 } };
+  volumeNode->SetIJKToRASDirections(ijkDirections);
+  CHECK_BOOL(vtkMRMLVolumeSharedMemoryTransfer::WriteVolumeNode(volumeNode, fileName), true);
+
+  // Image properties are stored in LPS coordinate system
+  vtkNew<vtkMRMLVolumeSharedMemoryTransfer> transfer;
+  CHECK_BOOL(transfer->Open(fileName), true);
+  CHECK_INT(transfer->GetScalarType(), VTK_SHORT);
+  CHECK_INT(transfer->GetNumberOfComponents(), 1);
+  CHECK_INT(static_cast<int>(transfer->GetScalarSizeInBytes()), 20 * 15 * 10 * static_cast<int>(sizeof(short)));
+  double origin[3] = { 0.0, 0.0, 0.0 };
+  transfer->GetOrigin(origin);
+  CHECK_DOUBLE_TOLERANCE(origin[0], -10.0, 1e-6);
+  CHECK_DOUBLE_TOLERANCE(origin[1], 20.0, 1e-6);
+  CHECK_DOUBLE_TOLERANCE(origin[2], 30.0, 1e-6);
+  transfer->Close();
+
+  // Read the volume back into a new node
+  vtkNew<vtkMRMLScalarVolumeNode> readVolumeNode;
+  CHECK_BOOL(vtkMRMLVolumeSharedMemoryTransfer::ReadVolumeNode(readVolumeNode, fileName), true);
+  vtkImageData* readImageData = readVolumeNode->GetImageData();
+  CHECK_NOT_NULL(readImageData);
+  CHECK_INT(readImageData->GetDimensions()[0], 20);
+  CHECK_INT(readImageData->GetDimensions()[1], 15);
+  CHECK_INT(readImageData->GetDimensions()[2], 10);
+  CHECK_INT(readImageData->GetScalarType(), VTK_SHORT);
+  CHECK_INT(memcmp(readImageData->GetScalarPointer(), imageData->GetScalarPointer(), 20 * 15 * 10 * sizeof(short)), 0);
+  vtkNew<vtkMatrix4x4> expectedIjkToRas;
+  volumeNode->GetIJKToRASMatrix(expectedIjkToRas);
+  vtkNew<vtkMatrix4x4> ijkToRas;
+  readVolumeNode->GetIJKToRASMatrix(ijkToRas);
+  for (int row = 0; row < 4; ++row)
+  {
+    for (int column = 0; column < 4; ++column)
+    {
+      CHECK_DOUBLE_TOLERANCE(ijkToRas->GetElement(row, column), expectedIjkToRas->GetElement(row, column), 1e-6);
+    }
+  }
+
+  // Removed segments cannot be opened anymore
+  CHECK_BOOL(vtkMRMLVolumeSharedMemoryTransfer::RemoveSharedMemory(fileName), true);
+  CHECK_BOOL(transfer->Open(fileName), false);
+  CHECK_BOOL(vtkMRMLVolumeSharedMemoryTransfer::RemoveSharedMemory(fileName), false);
+
+  // Existing segments are not overwritten, the volume is written into a segment with a new name
+  std::string existingFileName = vtkMRMLVolumeSharedMemoryTransfer::CreateUniqueFileName();
+  int existingDimensions[3] = { 2, 2, 2 };
+  double existingSpacing[3] = { 1.0, 1.0, 1.0 };
+  double existingOrigin[3] = { 0.0, 0.0, 0.0 };
+  double existingDirections[9] = { 1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0 };
+  vtkNew<vtkMRMLVolumeSharedMemoryTransfer> existingTransfer;
+  CHECK_BOOL(existingTransfer->Create(existingFileName, existingDimensions, VTK_UNSIGNED_CHAR, 1, existingSpacing, existingOrigin, existingDirections), true);
+  existingTransfer->Close();
+  std::string writtenFileName = existingFileName;
+  CHECK_BOOL(vtkMRMLVolumeSharedMemoryTransfer::WriteVolumeNode(volumeNode, writtenFileName), true);
+  CHECK_BOOL(writtenFileName != existingFileName, true);
+  CHECK_BOOL(vtkMRMLVolumeSharedMemoryTransfer::IsSharedMemoryFileName(writtenFileName), true);
+  CHECK_BOOL(existingTransfer->Open(existingFileName), true);
+  CHECK_INT(existingTransfer->GetScalarType(), VTK_UNSIGNED_CHAR);
+  existingTransfer->Close();
+  CHECK_BOOL(transfer->Open(writtenFileName), true);
+  CHECK_INT(transfer->GetScalarType(), VTK_SHORT);
+  transfer->Close();
+
+  // Create() overwrites an existing segment, as the name is chosen by the caller
+  CHECK_BOOL(existingTransfer->Create(existingFileName, existingDimensions, VTK_FLOAT, 1, existingSpacing, existingOrigin, existingDirections), true);
+  existingTransfer->Close();
+  CHECK_BOOL(existingTransfer->Open(existingFileName), true);
+  CHECK_INT(existingTransfer->GetScalarType(), VTK_FLOAT);
+  existingTransfer->Close();
+
+  CHECK_BOOL(vtkMRMLVolumeSharedMemoryTransfer::RemoveSharedMemory(existingFileName), true);
+  CHECK_BOOL(vtkMRMLVolumeSharedMemoryTransfer::RemoveSharedMemory(writtenFileName), true);
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -14,16 +14,48 @@
 
 // MRML includes
 #include "vtkEventBroker.h"
+#include "vtkMRMLJsonElement.h"
 #include "vtkObservation.h"
 
 // VTK includes
 #include <vtkCallbackCommand.h>
 #include <vtkCollection.h>
+#include <vtkNew.h>
 #include <vtkObjectFactory.h>
 #include <vtkTimerLog.h>
 
+// STD includes
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <tuple>
+
 vtkCxxSetObjectMacro(vtkEventBroker, TimerLog, vtkTimerLog);
 vtkCxxSetObjectMacro(vtkEventBroker, RequestModifiedCallback, vtkCallbackCommand);
+vtkCxxSetObjectMacro(vtkEventBroker, RequestProcessEventQueueCallback, vtkCallbackCommand);
+
+namespace
+{
+const char* EVENT_PROFILE_SCRIPT_OBSERVER_CLASS_NAME = "Script";
+
+//----------------------------------------------------------------------------
+std::string GetEventName(unsigned long eid)
+{
+  const char* eventName = vtkCommand::GetStringFromEventId(eid);
+  if (!strcmp(eventName, "NoEvent"))
+  {
+    return std::to_string(eid);
+  }
+  return eventName;
+}
+
+//----------------------------------------------------------------------------
+bool ClassNameMatches(const char* className, const char* requestedClassName)
+{
+  return requestedClassName == nullptr || (className != nullptr && !strcmp(className, requestedClassName));
+}
+} // namespace
 
 //----------------------------------------------------------------------------
 // The IO manager singleton.
@@ -100,6 +132,13 @@ vtkEventBroker::vtkEventBroker()
   this->ScriptHandler = nullptr;
   this->ScriptHandlerClientData = nullptr;
   this->RequestModifiedCallback = nullptr;
+  this->RequestProcessEventQueueCallback = nullptr;
+  this->EventQueueProcessingRequested = false;
+  this->NumberOfQueuedEvents = 0;
+  this->NumberOfCoalescedEvents = 0;
+  this->NumberOfProcessedEvents = 0;
+  this->EventProfiling = false;
+  this->MaximumNumberOfEventProfileTraceEvents = 100000;
 }
 
 //----------------------------------------------------------------------------
@@ -124,6 +163,11 @@ vtkEventBroker::~vtkEventBroker()
   {
     this->RequestModifiedCallback->Delete();
   }
+
+  if (this->RequestProcessEventQueueCallback)
+  {
+    this->RequestProcessEventQueueCallback->Delete();
+  }
   // cout << "vtkEventBroker singleton Deleted" << endl;
 }
 
@@ -721,10 +765,15 @@ void vtkEventBroker::QueueObservation(vtkObservation* observation, unsigned long
   // can be invoked.
   // If the event is not currently in the queue, add it and keep a flag.
   //
+  this->NumberOfQueuedEvents++;
   vtkObservation::CallType call(eid, callData);
   if (this->GetCompressCallData() && //
       observation->GetEvent() != vtkCommand::AnyEvent)
   {
+    if (!observation->GetCallDataList()->empty())
+    {
+      this->NumberOfCoalescedEvents++;
+    }
     observation->GetCallDataList()->clear();
     observation->GetCallDataList()->push_back(call);
   }
@@ -743,6 +792,10 @@ void vtkEventBroker::QueueObservation(vtkObservation* observation, unsigned long
     {
       observation->GetCallDataList()->push_back(call);
     }
+    else
+    {
+      this->NumberOfCoalescedEvents++;
+    }
   }
 
   if (!observation->GetInEventQueue())
@@ -750,6 +803,13 @@ void vtkEventBroker::QueueObservation(vtkObservation* observation, unsigned long
     this->EventQueue.push_back(observation);
     observation->SetInEventQueue(1);
   }
+
+  // Ask the application to process the queue later, only once for all the events queued until then
+  if (this->RequestProcessEventQueueCallback && !this->EventQueueProcessingRequested)
+  {
+    this->EventQueueProcessingRequested = true;
+    this->RequestProcessEventQueueCallback->Execute(this, vtkCommand::ModifiedEvent, nullptr);
+  }
 }
 
 //----------------------------------------------------------------------------
@@ -782,6 +842,18 @@ void vtkEventBroker::InvokeObservation(vtkObservation* observation, unsigned lon
 {
   this->EventNestingLevel++;
 
+  // Profiling state is stored so that it is consistent within the invocation
+  // even if profiling is turned on or off by the callback.
+  bool profiling = this->EventProfiling;
+  bool recursive = false;
+  EventProfileKey profileKey;
+  if (profiling)
+  {
+    this->GetEventProfileKey(observation, eid, profileKey);
+    recursive = std::find(this->EventProfileInvocationStack.begin(), this->EventProfileInvocationStack.end(), observation) != this->EventProfileInvocationStack.end();
+    this->EventProfileInvocationStack.push_back(observation);
+  }
+
   double startTime = this->TimerLog->GetUniversalTime();
 
   // Register so observation won't be deleted while callback is running
@@ -808,6 +880,11 @@ void vtkEventBroker::InvokeObservation(vtkObservation* observation, unsigned lon
   observation->SetTotalElapsedTime(observation->GetTotalElapsedTime() + elapsedTime);
   observation->SetLastElapsedTime(elapsedTime);
   this->LogEvent(observation);
+  if (profiling)
+  {
+    this->EventProfileInvocationStack.pop_back();
+    this->RecordEventProfile(profileKey, startTime, elapsedTime, recursive);
+  }
 
   // clear reference to observation (may cause delete)
   observation->Delete();
@@ -835,6 +912,7 @@ void vtkEventBroker::ProcessEventQueue()
       vtkObservation::CallType call = observation->GetCallDataList()->front();
       observation->GetCallDataList()->pop_front();
       finished = (observation->GetCallDataList()->size() == 0);
+      this->NumberOfProcessedEvents++;
       this->InvokeObservation(observation, call.EventID, call.CallData);
       if (!observation->GetInEventQueue())
       {
@@ -846,6 +924,266 @@ void vtkEventBroker::ProcessEventQueue()
     this->DequeueObservation();
     observation->Delete();
   }
+  // events that are queued from now on require a new processing request
+  this->EventQueueProcessingRequested = false;
+}
+
+//----------------------------------------------------------------------------
+void vtkEventBroker::ResetEventQueueStatistics()
+{
+  this->NumberOfQueuedEvents = 0;
+  this->NumberOfCoalescedEvents = 0;
+  this->NumberOfProcessedEvents = 0;
+}
+
+//----------------------------------------------------------------------------
+bool vtkEventBroker::EventProfileKey::operator<(const EventProfileKey& other) const
+{
+  return std::tie(this->SubjectClassName, this->Event, this->ObserverClassName, this->Callback, this->Script) //
+         < std::tie(other.SubjectClassName, other.Event, other.ObserverClassName, other.Callback, other.Script);
+}
+
+//----------------------------------------------------------------------------
+void vtkEventBroker::GetEventProfileKey(vtkObservation* observation, unsigned long eid, EventProfileKey& key)
+{
+  key.SubjectClassName = observation->GetSubject() ? observation->GetSubject()->GetClassName() : nullptr;
+  key.Event = eid;
+  if (observation->GetScript() != nullptr)
+  {
+    key.ObserverClassName = EVENT_PROFILE_SCRIPT_OBSERVER_CLASS_NAME;
+    key.Script = observation->GetScript();
+  }
+  else
+  {
+    vtkCallbackCommand* callbackCommand = observation->GetCallbackCommand();
+    if (observation->GetObserver())
+    {
+      key.ObserverClassName = observation->GetObserver()->GetClassName();
+    }
+    else if (callbackCommand)
+    {
+      key.ObserverClassName = callbackCommand->GetClassName();
+    }
+    key.Callback = callbackCommand ? callbackCommand->Callback : nullptr;
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkEventBroker::RecordEventProfile(const EventProfileKey& key, double startTime, double elapsedTime, bool recursive)
+{
+  EventProfileMap::iterator it = this->EventProfile.find(key);
+  if (it == this->EventProfile.end())
+  {
+    it = this->EventProfile.insert(std::make_pair(key, EventProfileEntry())).first;
+  }
+  EventProfileEntry& entry = it->second;
+  entry.InvocationCount++;
+  if (recursive)
+  {
+    entry.RecursiveInvocationCount++;
+  }
+  entry.TotalElapsedTime += elapsedTime;
+  entry.MaximumElapsedTime = std::max(entry.MaximumElapsedTime, elapsedTime);
+  entry.MaximumNestingLevel = std::max(entry.MaximumNestingLevel, this->EventNestingLevel);
+
+  if (static_cast<int>(this->EventProfileTraceEvents.size()) < this->MaximumNumberOfEventProfileTraceEvents)
+  {
+    EventProfileTraceEvent traceEvent;
+    // map elements are not moved when other elements are inserted, so the key can be referenced
+    traceEvent.Key = &(it->first);
+    traceEvent.StartTime = startTime;
+    traceEvent.ElapsedTime = elapsedTime;
+    traceEvent.NestingLevel = this->EventNestingLevel;
+    this->EventProfileTraceEvents.push_back(traceEvent);
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkEventBroker::ResetEventProfile()
+{
+  // Invocations that are in progress will be recorded when they complete,
+  // therefore the invocation stack is kept.
+  this->EventProfileTraceEvents.clear();
+  this->EventProfile.clear();
+}
+
+//----------------------------------------------------------------------------
+int vtkEventBroker::GetNumberOfEventProfileEntries()
+{
+  return static_cast<int>(this->EventProfile.size());
+}
+
+//----------------------------------------------------------------------------
+int vtkEventBroker::GetNumberOfEventProfileTraceEvents()
+{
+  return static_cast<int>(this->EventProfileTraceEvents.size());
+}
+
+//----------------------------------------------------------------------------
+vtkEventBroker::EventProfileEntry vtkEventBroker::GetEventProfileSummary(const char* subjectClassName, unsigned long event, const char* observerClassName)
+{
+  EventProfileEntry summary;
+  for (const auto& keyAndEntry : this->EventProfile)
+  {
+    const EventProfileKey& key = keyAndEntry.first;
+    if (!ClassNameMatches(key.SubjectClassName, subjectClassName) //
+        || (event != vtkCommand::NoEvent && key.Event != event)   //
+        || !ClassNameMatches(key.ObserverClassName, observerClassName))
+    {
+      continue;
+    }
+    const EventProfileEntry& entry = keyAndEntry.second;
+    summary.InvocationCount += entry.InvocationCount;
+    summary.RecursiveInvocationCount += entry.RecursiveInvocationCount;
+    summary.TotalElapsedTime += entry.TotalElapsedTime;
+    summary.MaximumElapsedTime = std::max(summary.MaximumElapsedTime, entry.MaximumElapsedTime);
+    summary.MaximumNestingLevel = std::max(summary.MaximumNestingLevel, entry.MaximumNestingLevel);
+  }
+  return summary;
+}
+
+//----------------------------------------------------------------------------
+vtkTypeUInt64 vtkEventBroker::GetEventProfileInvocationCount(const char* subjectClassName, unsigned long event, const char* observerClassName)
+{
+  return this->GetEventProfileSummary(subjectClassName, event, observerClassName).InvocationCount;
+}
+
+//----------------------------------------------------------------------------
+vtkTypeUInt64 vtkEventBroker::GetEventProfileRecursiveInvocationCount(const char* subjectClassName, unsigned long event, const char* observerClassName)
+{
+  return this->GetEventProfileSummary(subjectClassName, event, observerClassName).RecursiveInvocationCount;
+}
+
+//----------------------------------------------------------------------------
+double vtkEventBroker::GetEventProfileTotalElapsedTime(const char* subjectClassName, unsigned long event, const char* observerClassName)
+{
+  return this->GetEventProfileSummary(subjectClassName, event, observerClassName).TotalElapsedTime;
+}
+
+//----------------------------------------------------------------------------
+double vtkEventBroker::GetEventProfileMaximumElapsedTime(const char* subjectClassName, unsigned long event, const char* observerClassName)
+{
+  return this->GetEventProfileSummary(subjectClassName, event, observerClassName).MaximumElapsedTime;
+}
+
+//----------------------------------------------------------------------------
+int vtkEventBroker::GetEventProfileMaximumNestingLevel(const char* subjectClassName, unsigned long event, const char* observerClassName)
+{
+  return this->GetEventProfileSummary(subjectClassName, event, observerClassName).MaximumNestingLevel;
+}
+
+//----------------------------------------------------------------------------
+bool vtkEventBroker::WriteEventProfile(const char* fileName)
+{
+  vtkNew<vtkMRMLJsonWriter> writer;
+  if (!writer->WriteToFileBegin(fileName, nullptr))
+  {
+    vtkErrorMacro("WriteEventProfile: failed to open file " << (fileName ? fileName : "(none)"));
+    return false;
+  }
+
+  // Most expensive entries first
+  std::vector<EventProfileMap::const_iterator> entries;
+  for (EventProfileMap::const_iterator it = this->EventProfile.begin(); it != this->EventProfile.end(); ++it)
+  {
+    entries.push_back(it);
+  }
+  std::sort(entries.begin(),
+            entries.end(),
+            [](const EventProfileMap::const_iterator& a, const EventProfileMap::const_iterator& b) { return a->second.TotalElapsedTime > b->second.TotalElapsedTime; });
+
+  writer->WriteArrayPropertyStart("eventProfile");
+  for (const EventProfileMap::const_iterator& it : entries)
+  {
+    const EventProfileKey& key = it->first;
+    const EventProfileEntry& entry = it->second;
+    writer->WriteObjectStart();
+    writer->WriteStringProperty("subjectClass", key.SubjectClassName ? key.SubjectClassName : "");
+    writer->WriteStringProperty("event", GetEventName(key.Event));
+    writer->WriteStringProperty("observerClass", key.ObserverClassName ? key.ObserverClassName : "");
+    if (!key.Script.empty())
+    {
+      writer->WriteStringProperty("script", key.Script);
+    }
+    else
+    {
+      std::stringstream callbackSS;
+      callbackSS << "0x" << std::hex << reinterpret_cast<std::uintptr_t>(key.Callback);
+      writer->WriteStringProperty("callback", callbackSS.str());
+    }
+    writer->WriteIntProperty("invocationCount", static_cast<int>(entry.InvocationCount));
+    writer->WriteIntProperty("recursiveInvocationCount", static_cast<int>(entry.RecursiveInvocationCount));
+    writer->WriteDoubleProperty("totalElapsedTimeSec", entry.TotalElapsedTime);
+    writer->WriteDoubleProperty("averageElapsedTimeSec", entry.InvocationCount > 0 ? entry.TotalElapsedTime / entry.InvocationCount : 0.0);
+    writer->WriteDoubleProperty("maximumElapsedTimeSec", entry.MaximumElapsedTime);
+    writer->WriteIntProperty("maximumNestingLevel", entry.MaximumNestingLevel);
+    writer->WriteObjectEnd();
+  }
+  writer->WriteArrayPropertyEnd();
+
+  if (!writer->WriteToFileEnd())
+  {
+    vtkErrorMacro("WriteEventProfile: failed to write file " << fileName);
+    return false;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkEventBroker::WriteEventProfileTrace(const char* fileName)
+{
+  vtkNew<vtkMRMLJsonWriter> writer;
+  if (!writer->WriteToFileBegin(fileName, nullptr))
+  {
+    vtkErrorMacro("WriteEventProfileTrace: failed to open file " << (fileName ? fileName : "(none)"));
+    return false;
+  }
+
+  // Timestamps are relative to the first recorded invocation
+  double firstStartTime = 0.0;
+  for (size_t traceEventIndex = 0; traceEventIndex < this->EventProfileTraceEvents.size(); ++traceEventIndex)
+  {
+    double startTime = this->EventProfileTraceEvents[traceEventIndex].StartTime;
+    if (traceEventIndex == 0 || startTime < firstStartTime)
+    {
+      firstStartTime = startTime;
+    }
+  }
+
+  // Complete events ("ph": "X"), timestamps and durations are in microseconds
+  writer->WriteArrayPropertyStart("traceEvents");
+  for (const EventProfileTraceEvent& traceEvent : this->EventProfileTraceEvents)
+  {
+    const EventProfileKey& key = *traceEvent.Key;
+    std::string subjectClassName = key.SubjectClassName ? key.SubjectClassName : "";
+    std::string observerClassName = key.ObserverClassName ? key.ObserverClassName : "";
+    std::string eventName = GetEventName(key.Event);
+    writer->WriteObjectStart();
+    writer->WriteStringProperty("name", subjectClassName + "." + eventName + " -> " + observerClassName);
+    writer->WriteStringProperty("cat", "MRMLEvent");
+    writer->WriteStringProperty("ph", "X");
+    writer->WriteDoubleProperty("ts", (traceEvent.StartTime - firstStartTime) * 1.0e6);
+    writer->WriteDoubleProperty("dur", traceEvent.ElapsedTime * 1.0e6);
+    writer->WriteIntProperty("pid", 0);
+    writer->WriteIntProperty("tid", 0);
+    writer->WriteObjectPropertyStart("args");
+    writer->WriteStringProperty("subjectClass", subjectClassName);
+    writer->WriteStringProperty("event", eventName);
+    writer->WriteStringProperty("observerClass", observerClassName);
+    writer->WriteStringPropertyIfNotEmpty("script", key.Script);
+    writer->WriteIntProperty("nestingLevel", traceEvent.NestingLevel);
+    writer->WriteObjectPropertyEnd();
+    writer->WriteObjectEnd();
+  }
+  writer->WriteArrayPropertyEnd();
+  writer->WriteStringProperty("displayTimeUnit", "ms");
+
+  if (!writer->WriteToFileEnd())
+  {
+    vtkErrorMacro("WriteEventProfileTrace: failed to write file " << fileName);
+    return false;
+  }
+  return true;
 }
 
 //----------------------------------------------------------------------------
@@ -856,6 +1194,13 @@ void vtkEventBroker::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "NumberOfObservations: " << this->GetNumberOfObservations() << "\n";
   os << indent << "NumberOfQueueObservations: " << this->GetNumberOfQueuedObservations() << "\n";
   os << indent << "EventMode: " << this->GetEventModeAsString() << "\n";
+  os << indent << "NumberOfQueuedEvents: " << this->NumberOfQueuedEvents << "\n";
+  os << indent << "NumberOfCoalescedEvents: " << this->NumberOfCoalescedEvents << "\n";
+  os << indent << "NumberOfProcessedEvents: " << this->NumberOfProcessedEvents << "\n";
+  os << indent << "EventProfiling: " << (this->EventProfiling ? "true" : "false") << "\n";
+  os << indent << "NumberOfEventProfileEntries: " << this->EventProfile.size() << "\n";
+  os << indent << "NumberOfEventProfileTraceEvents: " << this->EventProfileTraceEvents.size() << "\n";
+  os << indent << "MaximumNumberOfEventProfileTraceEvents: " << this->MaximumNumberOfEventProfileTraceEvents << "\n";
   os << indent << "EventLogging: " << this->EventLogging << "\n";
   os << indent << "EventNestingLevel: " << this->EventNestingLevel << "\n";
   os << indent << "LogFileName: " << (this->LogFileName ? this->LogFileName : "(none)") << "\n";
@@ -28,6 +28,7 @@ class vtkTimerLog;
 #include <set>
 #include <map>
 #include <fstream>
+#include <string>
 
 class vtkCollection;
 class vtkCallbackCommand;
@@ -173,7 +174,9 @@ public:
   ///
   /// In synchronous mode, observations are invoked immediately when the
   /// event takes place.  In asynchronous mode, observations are added
-  /// to the event queue for later invocation.
+  /// to the event queue for later invocation. Each observation is queued
+  /// only once, repeated events of the same observation are coalesced
+  /// (see CompressCallData) and delivered once when the queue is processed.
   enum EventMode
   {
     Synchronous,
@@ -229,6 +232,74 @@ public:
   vtkGetMacro(CompressCallData, int);
   vtkSetMacro(CompressCallData, int);
 
+  /// Event queue statistics
+  /// - NumberOfQueuedEvents: number of events that were added to the event queue
+  /// - NumberOfCoalescedEvents: number of queued events that were merged into a call
+  ///   that was already in the queue, therefore they did not cause an additional invocation
+  /// - NumberOfProcessedEvents: number of calls invoked by ProcessEventQueue()
+  vtkGetMacro(NumberOfQueuedEvents, vtkTypeUInt64);
+  vtkGetMacro(NumberOfCoalescedEvents, vtkTypeUInt64);
+  vtkGetMacro(NumberOfProcessedEvents, vtkTypeUInt64);
+  /// Set all event queue statistics to zero
+  void ResetEventQueueStatistics();
+
+  /// Set callback command that is invoked when the first observation is added to the
+  /// empty event queue. The application should then call ProcessEventQueue() later
+  /// (e.g., in the next iteration of its event loop, before rendering), so that all the
+  /// events triggered until then are delivered in one batch.
+  /// The callback is not invoked again until ProcessEventQueue() is called.
+  virtual void SetRequestProcessEventQueueCallback(vtkCallbackCommand* callback);
+  vtkGetObjectMacro(RequestProcessEventQueueCallback, vtkCallbackCommand);
+
+  /// Event profiling
+  ///
+  /// If enabled, invocations of observations are recorded for each combination of
+  /// subject class, event, observer class, and callback function: number of invocations,
+  /// total and maximum elapsed time (including the time spent in nested invocations),
+  /// maximum nesting level, and number of recursive invocations (when an observation is
+  /// invoked again while it is still being invoked).
+  /// Profiling can be turned on and off at any time, for example from the Python console:
+  /// slicer.vtkEventBroker.GetInstance().EventProfilingOn()
+  /// Disabled by default.
+  vtkBooleanMacro(EventProfiling, bool);
+  vtkSetMacro(EventProfiling, bool);
+  vtkGetMacro(EventProfiling, bool);
+
+  /// Maximum number of individual invocations that are stored for WriteEventProfileTrace().
+  /// Invocations beyond this limit are still included in the statistics.
+  /// Set to 0 to only collect statistics. Default is 100000.
+  vtkSetMacro(MaximumNumberOfEventProfileTraceEvents, int);
+  vtkGetMacro(MaximumNumberOfEventProfileTraceEvents, int);
+
+  /// Remove all collected profiling data.
+  void ResetEventProfile();
+
+  /// Number of distinct (subject class, event, observer class, callback) combinations
+  /// that have been recorded.
+  int GetNumberOfEventProfileEntries();
+
+  /// Number of individual invocations stored for WriteEventProfileTrace().
+  int GetNumberOfEventProfileTraceEvents();
+
+  /// Get profiling results, combined for all the recorded entries that match the
+  /// specified subject class, event, and observer class.
+  /// Observer class of script observations is "Script".
+  /// nullptr class name or vtkCommand::NoEvent matches all.
+  vtkTypeUInt64 GetEventProfileInvocationCount(const char* subjectClassName, unsigned long event = 0, const char* observerClassName = nullptr);
+  vtkTypeUInt64 GetEventProfileRecursiveInvocationCount(const char* subjectClassName, unsigned long event = 0, const char* observerClassName = nullptr);
+  double GetEventProfileTotalElapsedTime(const char* subjectClassName, unsigned long event = 0, const char* observerClassName = nullptr);
+  double GetEventProfileMaximumElapsedTime(const char* subjectClassName, unsigned long event = 0, const char* observerClassName = nullptr);
+  int GetEventProfileMaximumNestingLevel(const char* subjectClassName, unsigned long event = 0, const char* observerClassName = nullptr);
+
+  /// Write profiling statistics to a JSON file, sorted by decreasing total elapsed time.
+  /// Returns true on success.
+  bool WriteEventProfile(const char* fileName);
+
+  /// Write stored invocations to a JSON file in Chrome trace event format,
+  /// which can be displayed in chrome://tracing or https://ui.perfetto.dev.
+  /// Returns true on success.
+  bool WriteEventProfileTrace(const char* fileName);
+
   ///
   /// Sets the method pointer to be used for processing script observations
   void SetScriptHandler(void (*scriptHandler)(const char* script, void* clientData), void* clientData)
@@ -296,6 +367,61 @@ protected:
 
   vtkCallbackCommand* RequestModifiedCallback;
 
+  vtkCallbackCommand* RequestProcessEventQueueCallback;
+  bool EventQueueProcessingRequested;
+
+  vtkTypeUInt64 NumberOfQueuedEvents;
+  vtkTypeUInt64 NumberOfCoalescedEvents;
+  vtkTypeUInt64 NumberOfProcessedEvents;
+
+  typedef void (*CallbackFunctionType)(vtkObject*, unsigned long, void*, void*);
+
+  /// Identifies what is profiled. Class names point to static strings and the callback
+  /// is a function pointer, therefore the key remains valid after the objects are deleted.
+  struct EventProfileKey
+  {
+    const char* SubjectClassName{ nullptr };
+    unsigned long Event{ 0 };
+    const char* ObserverClassName{ nullptr };
+    CallbackFunctionType Callback{ nullptr };
+    std::string Script;
+    bool operator<(const EventProfileKey& other) const;
+  };
+
+  struct EventProfileEntry
+  {
+    vtkTypeUInt64 InvocationCount{ 0 };
+    vtkTypeUInt64 RecursiveInvocationCount{ 0 };
+    double TotalElapsedTime{ 0.0 };
+    double MaximumElapsedTime{ 0.0 };
+    int MaximumNestingLevel{ 0 };
+  };
+
+  struct EventProfileTraceEvent
+  {
+    const EventProfileKey* Key{ nullptr };
+    double StartTime{ 0.0 };
+    double ElapsedTime{ 0.0 };
+    int NestingLevel{ 0 };
+  };
+
+  typedef std::map<EventProfileKey, EventProfileEntry> EventProfileMap;
+
+  /// Get the profile key of an observation. Must be called before the observation is invoked,
+  /// as the subject or observer may be deleted during the invocation.
+  void GetEventProfileKey(vtkObservation* observation, unsigned long eid, EventProfileKey& key);
+  /// Add an invocation to the profile
+  void RecordEventProfile(const EventProfileKey& key, double startTime, double elapsedTime, bool recursive);
+  /// Combine all profile entries that match the specified subject class, event, and observer class
+  EventProfileEntry GetEventProfileSummary(const char* subjectClassName, unsigned long event, const char* observerClassName);
+
+  bool EventProfiling;
+  int MaximumNumberOfEventProfileTraceEvents;
+  EventProfileMap EventProfile;
+  std::vector<EventProfileTraceEvent> EventProfileTraceEvents;
+  /// Observations that are currently being invoked (only maintained during profiling)
+  std::vector<vtkObservation*> EventProfileInvocationStack;
+
 private:
   /// DetachObservations is a fast (but dangerous) method to delete all the
   /// observations. It leaves the event broker in an inconsistent state:
@@ -9,6 +9,7 @@ or http://www.slicer.org/copyright/copyright.txt for details.
 
 // STD includes
 #include <algorithm>
+#include <fstream>
 #include <sstream>
 
 #include "vtkMRMLI18N.h"
@@ -23,6 +24,7 @@ or http://www.slicer.org/copyright/copyright.txt for details.
 #include "vtkMRMLSequenceNode.h"
 
 #include "vtkObjectFactory.h"
+#include "vtkByteSwap.h"
 #include "vtkImageAppendComponents.h"
 #include "vtkImageData.h"
 #include "vtkImageExtractComponents.h"
@@ -36,6 +38,8 @@ or http://www.slicer.org/copyright/copyright.txt for details.
 static const int MAX_LINE_LENGTH = 1000;
 static std::string SEQMETA_FIELD_FRAME_FIELD_PREFIX = "Seq_Frame";
 static std::string SEQMETA_FIELD_IMG_STATUS = "ImageStatus";
+static std::string SEQMETA_FIELD_TRANSFORM_NAME = "SequenceTransformName";
+static std::string SEQMETA_FIELD_INDEX_VALUES = "SequenceIndexValues";
 
 // Constants for creating nodes
 static const char NODE_BASE_NAME_SEPARATOR[] = "-";
@@ -52,6 +56,44 @@ vtkMRMLLinearTransformSequenceStorageNode::vtkMRMLLinearTransformSequenceStorage
 //----------------------------------------------------------------------------
 vtkMRMLLinearTransformSequenceStorageNode::~vtkMRMLLinearTransformSequenceStorageNode() = default;
 
+//----------------------------------------------------------------------------
+void vtkMRMLLinearTransformSequenceStorageNode::PrintSelf(ostream& os, vtkIndent indent)
+{
+  Superclass::PrintSelf(os, indent);
+  vtkMRMLPrintBeginMacro(os, indent);
+  vtkMRMLPrintBooleanMacro(WriteBinaryTransforms);
+  vtkMRMLPrintEndMacro();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLLinearTransformSequenceStorageNode::ReadXMLAttributes(const char** atts)
+{
+  MRMLNodeModifyBlocker blocker(this);
+  Superclass::ReadXMLAttributes(atts);
+  vtkMRMLReadXMLBeginMacro(atts);
+  vtkMRMLReadXMLBooleanMacro(writeBinaryTransforms, WriteBinaryTransforms);
+  vtkMRMLReadXMLEndMacro();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLLinearTransformSequenceStorageNode::WriteXML(ostream& of, int nIndent)
+{
+  Superclass::WriteXML(of, nIndent);
+  vtkMRMLWriteXMLBeginMacro(of);
+  vtkMRMLWriteXMLBooleanMacro(writeBinaryTransforms, WriteBinaryTransforms);
+  vtkMRMLWriteXMLEndMacro();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLLinearTransformSequenceStorageNode::Copy(vtkMRMLNode* anode)
+{
+  MRMLNodeModifyBlocker blocker(this);
+  Superclass::Copy(anode);
+  vtkMRMLCopyBeginMacro(anode);
+  vtkMRMLCopyBooleanMacro(WriteBinaryTransforms);
+  vtkMRMLCopyEndMacro();
+}
+
 //----------------------------------------------------------------------------
 bool vtkMRMLLinearTransformSequenceStorageNode::CanReadInReferenceNode(vtkMRMLNode* refNode)
 {
@@ -85,6 +127,215 @@ void StringToInt(const char* strPtr, T& result)
   return;
 }
 
+//----------------------------------------------------------------------------
+/*! Read header fields of a metafile, until the ElementDataFile field (or end of file) is reached */
+static void ReadMetafileHeader(std::ifstream& stream, std::map<std::string, std::string>& fields)
+{
+  std::string line;
+  while (std::getline(stream, line))
+  {
+    size_t separatorFound = line.find_first_of("=");
+    if (separatorFound == std::string::npos)
+    {
+      continue;
+    }
+    std::string name = line.substr(0, separatorFound);
+    std::string value = line.substr(separatorFound + 1);
+    Trim(name);
+    Trim(value);
+    fields[name] = value;
+    if (name == "ElementDataFile")
+    {
+      // this is the last field of the header
+      break;
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+/*! Encode an index value so that it can be stored in the index values field (';' is the separator) */
+static std::string EncodeIndexValue(const std::string& indexValue)
+{
+  std::string encodedIndexValue = indexValue;
+  vtksys::SystemTools::ReplaceString(encodedIndexValue, "%", "%25");
+  vtksys::SystemTools::ReplaceString(encodedIndexValue, ";", "%3B");
+  vtksys::SystemTools::ReplaceString(encodedIndexValue, " ", "%20");
+  vtksys::SystemTools::ReplaceString(encodedIndexValue, "\r", "%0D");
+  vtksys::SystemTools::ReplaceString(encodedIndexValue, "\n", "%0A");
+  return encodedIndexValue;
+}
+
+//----------------------------------------------------------------------------
+/*! Decode an index value encoded by EncodeIndexValue */
+static std::string DecodeIndexValue(const std::string& encodedIndexValue)
+{
+  std::string indexValue = encodedIndexValue;
+  vtksys::SystemTools::ReplaceString(indexValue, "%0A", "\n");
+  vtksys::SystemTools::ReplaceString(indexValue, "%0D", "\r");
+  vtksys::SystemTools::ReplaceString(indexValue, "%20", " ");
+  vtksys::SystemTools::ReplaceString(indexValue, "%3B", ";");
+  vtksys::SystemTools::ReplaceString(indexValue, "%25", "%");
+  return indexValue;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLLinearTransformSequenceStorageNode::IsBinaryTransformsFile(const std::string& fileName)
+{
+  std::ifstream stream(fileName.c_str(), std::ios_base::binary);
+  if (!stream.is_open())
+  {
+    return false;
+  }
+  std::map<std::string, std::string> fields;
+  ReadMetafileHeader(stream, fields);
+  return fields.find(SEQMETA_FIELD_INDEX_VALUES) != fields.end();
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLLinearTransformSequenceStorageNode::ReadBinaryTransformsFile(const std::string& fileName, vtkMRMLSequenceNode* sequenceNode)
+{
+  std::ifstream stream(fileName.c_str(), std::ios_base::binary);
+  if (!stream.is_open())
+  {
+    vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLLinearTransformSequenceStorageNode::ReadBinaryTransformsFile", "Failed to open file: " << fileName);
+    return false;
+  }
+  std::map<std::string, std::string> fields;
+  ReadMetafileHeader(stream, fields);
+
+  int dimensions[3] = { 0, 0, 0 };
+  std::stringstream dimSizeStream(fields["DimSize"]);
+  dimSizeStream >> dimensions[0] >> dimensions[1] >> dimensions[2];
+  if (fields["ElementType"] != "MET_DOUBLE" || fields["ElementDataFile"] != "LOCAL" || fields["CompressedData"] == "True" //
+      || dimensions[0] != 4 || dimensions[1] != 4 || dimensions[2] < 0)
+  {
+    vtkErrorToMessageCollectionMacro(
+      this->GetUserMessages(), "vtkMRMLLinearTransformSequenceStorageNode::ReadBinaryTransformsFile", "Unsupported binary transforms file: " << fileName);
+    return false;
+  }
+  int numberOfFrames = dimensions[2];
+
+  std::vector<std::string> indexValues;
+  std::stringstream indexValuesStream(fields[SEQMETA_FIELD_INDEX_VALUES]);
+  std::string indexValue;
+  while (std::getline(indexValuesStream, indexValue, ';'))
+  {
+    indexValues.push_back(DecodeIndexValue(indexValue));
+  }
+  if (static_cast<int>(indexValues.size()) != numberOfFrames)
+  {
+    vtkErrorToMessageCollectionMacro(this->GetUserMessages(),
+                                     "vtkMRMLLinearTransformSequenceStorageNode::ReadBinaryTransformsFile",
+                                     "Number of index values (" << indexValues.size() << ") does not match number of frames (" << numberOfFrames << ") in file: " << fileName);
+    return false;
+  }
+
+  std::vector<double> matrixElements(static_cast<size_t>(numberOfFrames) * 16);
+  if (numberOfFrames > 0)
+  {
+    stream.read(reinterpret_cast<char*>(matrixElements.data()), matrixElements.size() * sizeof(double));
+    if (stream.gcount() != static_cast<std::streamsize>(matrixElements.size() * sizeof(double)))
+    {
+      vtkErrorToMessageCollectionMacro(
+        this->GetUserMessages(), "vtkMRMLLinearTransformSequenceStorageNode::ReadBinaryTransformsFile", "Failed to read transforms, file is truncated: " << fileName);
+      return false;
+    }
+  }
+#ifdef VTK_WORDS_BIGENDIAN
+  bool swapBytes = (fields["BinaryDataByteOrderMSB"] != "True");
+#else
+  bool swapBytes = (fields["BinaryDataByteOrderMSB"] == "True");
+#endif
+  if (swapBytes)
+  {
+    vtkByteSwap::SwapVoidRange(matrixElements.data(), static_cast<int>(matrixElements.size()), sizeof(double));
+  }
+
+  std::string transformName = fields[SEQMETA_FIELD_TRANSFORM_NAME];
+  MRMLNodeModifyBlocker blocker(sequenceNode);
+  sequenceNode->RemoveAllDataNodes();
+  if (!transformName.empty())
+  {
+    sequenceNode->SetAttribute("Sequences.Source", transformName.c_str());
+  }
+  vtkNew<vtkMatrix4x4> matrix;
+  vtkNew<vtkMRMLLinearTransformNode> transformNode;
+  transformNode->SetName(transformName.empty() ? "Transform" : transformName.c_str());
+  for (int frameIndex = 0; frameIndex < numberOfFrames; ++frameIndex)
+  {
+    matrix->DeepCopy(&matrixElements[frameIndex * 16]);
+    if (sequenceNode->GetCompactLinearTransformStorage())
+    {
+      sequenceNode->SetMatrixTransformToParentAtValue(matrix, indexValues[frameIndex]);
+    }
+    else
+    {
+      transformNode->SetMatrixTransformToParent(matrix);
+      sequenceNode->SetDataNodeAtValue(transformNode, indexValues[frameIndex]);
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLLinearTransformSequenceStorageNode::WriteBinaryTransformsFile(const std::string& fileName,
+                                                                          vtkMRMLSequenceNode* sequenceNode,
+                                                                          const std::string& transformName)
+{
+  int numberOfFrames = sequenceNode->GetNumberOfDataNodes();
+  std::vector<double> matrixElements(static_cast<size_t>(numberOfFrames) * 16);
+  vtkNew<vtkMatrix4x4> matrix;
+  for (int frameIndex = 0; frameIndex < numberOfFrames; ++frameIndex)
+  {
+    if (!sequenceNode->GetNthMatrixTransformToParent(frameIndex, matrix))
+    {
+      // Not a linear transform, write identity
+      matrix->Identity();
+    }
+    std::copy(&matrix->Element[0][0], &matrix->Element[0][0] + 16, matrixElements.begin() + frameIndex * 16);
+  }
+
+  std::ofstream stream(fileName.c_str(), std::ios_base::binary);
+  if (!stream.is_open())
+  {
+    vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLLinearTransformSequenceStorageNode::WriteBinaryTransformsFile", "Failed to open file: " << fileName);
+    return false;
+  }
+  stream << "ObjectType = Image" << std::endl
+         << "NDims = 3" << std::endl
+         << "AnatomicalOrientation = RAI" << std::endl
+         << "BinaryData = True" << std::endl
+#ifdef VTK_WORDS_BIGENDIAN
+         << "BinaryDataByteOrderMSB = True" << std::endl
+#else
+         << "BinaryDataByteOrderMSB = False" << std::endl
+#endif
+         << "CompressedData = False" << std::endl
+         << "DimSize = 4 4 " << numberOfFrames << std::endl
+         << "ElementSpacing = 1 1 1" << std::endl
+         << "Offset = 0 0 0" << std::endl
+         << "TransformMatrix = 1 0 0 0 1 0 0 0 1" << std::endl
+         << "ElementType = MET_DOUBLE" << std::endl
+         << "Kinds = domain domain list" << std::endl
+         << SEQMETA_FIELD_TRANSFORM_NAME << " = " << transformName << std::endl;
+  // Index values are stored in a single field, separated by semicolons (same as in the scene file).
+  // Separator and whitespace characters in index values are percent-encoded.
+  stream << SEQMETA_FIELD_INDEX_VALUES << " =";
+  for (int frameIndex = 0; frameIndex < numberOfFrames; ++frameIndex)
+  {
+    stream << (frameIndex == 0 ? " " : ";") << EncodeIndexValue(sequenceNode->GetNthIndexValue(frameIndex));
+  }
+  stream << std::endl;
+  stream << "ElementDataFile = LOCAL" << std::endl;
+  stream.write(reinterpret_cast<const char*>(matrixElements.data()), matrixElements.size() * sizeof(double));
+  if (!stream.good())
+  {
+    vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLLinearTransformSequenceStorageNode::WriteBinaryTransformsFile", "Failed to write file: " << fileName);
+    return false;
+  }
+  return true;
+}
+
 //----------------------------------------------------------------------------
 int vtkMRMLLinearTransformSequenceStorageNode::ReadSequenceFileTransforms(const std::string& fileName,
                                                                           vtkMRMLScene* scene,
@@ -314,7 +565,16 @@ int vtkMRMLLinearTransformSequenceStorageNode::ReadSequenceFileTransforms(const
       std::ostringstream nameStr;
       nameStr << transform->GetName() << "_" << std::setw(4) << std::setfill('0') << currentFrameNumber << std::ends;
       transform->SetName(nameStr.str().c_str());
-      transformsSequenceNode->SetDataNodeAtValue(transform, paramValueString.c_str());
+      if (transformsSequenceNode->GetCompactLinearTransformStorage())
+      {
+        vtkNew<vtkMatrix4x4> matrix;
+        transform->GetMatrixTransformToParent(matrix);
+        transformsSequenceNode->SetMatrixTransformToParentAtValue(matrix, paramValueString);
+      }
+      else
+      {
+        transformsSequenceNode->SetDataNodeAtValue(transform, paramValueString.c_str());
+      }
       transform->Delete(); // ownership transferred to the sequence node
     }
   }
@@ -449,11 +709,11 @@ bool vtkMRMLLinearTransformSequenceStorageNode::WriteSequenceMetafileTransforms(
 
       std::string transformValue = "1 0 0 0 0 1 0 0 0 0 1 0 0 0 0 1"; // Identity
       std::string transformStatus = "INVALID";
-      vtkMRMLTransformNode* transformNode = vtkMRMLTransformNode::SafeDownCast(currSequenceNode->GetDataNodeAtValue(indexValue.c_str()));
-      if (transformNode != nullptr && transformNode->IsLinear())
+      // Get the matrix directly, to avoid creating data nodes for items that are stored in compact form
+      int itemNumber = currSequenceNode->GetItemNumberFromIndexValue(indexValue);
+      vtkNew<vtkMatrix4x4> matrix;
+      if (itemNumber >= 0 && currSequenceNode->GetNthMatrixTransformToParent(itemNumber, matrix))
       {
-        vtkNew<vtkMatrix4x4> matrix;
-        transformNode->GetMatrixTransformToParent(matrix.GetPointer());
         transformValue = vtkAddonMathUtilities::ToString(matrix.GetPointer());
         transformStatus = "OK";
       }
@@ -510,6 +770,11 @@ int vtkMRMLLinearTransformSequenceStorageNode::ReadDataInternal(vtkMRMLNode* ref
     return 0;
   }
 
+  if (vtkMRMLLinearTransformSequenceStorageNode::IsBinaryTransformsFile(fullName))
+  {
+    return this->ReadBinaryTransformsFile(fullName, seqNode) ? 1 : 0;
+  }
+
   std::deque<vtkSmartPointer<vtkMRMLSequenceNode>> createdTransformNodes;
   createdTransformNodes.push_back(seqNode);
   std::map<int, std::string> frameNumberToIndexValueMap;
@@ -547,10 +812,10 @@ bool vtkMRMLLinearTransformSequenceStorageNode::CanWriteFromReferenceNode(vtkMRM
     return false;
   }
   int numberOfFrameVolumes = sequenceNode->GetNumberOfDataNodes();
+  vtkNew<vtkMatrix4x4> matrix;
   for (int frameIndex = 0; frameIndex < numberOfFrameVolumes; frameIndex++)
   {
-    vtkMRMLTransformNode* transform = vtkMRMLTransformNode::SafeDownCast(sequenceNode->GetNthDataNode(frameIndex));
-    if (transform == NULL || !transform->IsLinear())
+    if (!sequenceNode->GetNthMatrixTransformToParent(frameIndex, matrix))
     {
       vtkDebugMacro("vtkMRMLLinearTransformSequenceStorageNode::CanWriteFromReferenceNode:" << " only linear transform nodes can be written (frame " << frameIndex << ")");
       this->GetUserMessages()->AddMessage(vtkCommand::ErrorEvent, std::string("Only linear transform nodes can be written in this format."));
@@ -591,6 +856,15 @@ int vtkMRMLLinearTransformSequenceStorageNode::WriteDataInternal(vtkMRMLNode* re
     transformName = refNode->GetName();
   }
   transformNames.push_back(transformName);
+  if (this->WriteBinaryTransforms)
+  {
+    if (!this->WriteBinaryTransformsFile(fullName, sequenceNode, transformName))
+    {
+      return 0;
+    }
+    this->StageWriteData(refNode);
+    return 1;
+  }
   if (!vtkMRMLLinearTransformSequenceStorageNode::WriteSequenceMetafileTransforms(fullName, transformSequenceNodes, transformNames, sequenceNode, NULL))
   {
     this->GetUserMessages()->AddMessage(vtkCommand::ErrorEvent, std::string("Writing transforms to sequence metafile failed."));
@@ -598,7 +872,7 @@ int vtkMRMLLinearTransformSequenceStorageNode::WriteDataInternal(vtkMRMLNode* re
   }
 
   this->StageWriteData(refNode);
-  return true;
+  return 1;
 }
 
 //----------------------------------------------------------------------------
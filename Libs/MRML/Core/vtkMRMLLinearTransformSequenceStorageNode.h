@@ -35,6 +35,17 @@ public:
 
   vtkMRMLNode* CreateNodeInstance() override;
 
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Read node attributes from XML file
+  void ReadXMLAttributes(const char** atts) override;
+
+  /// Write this node's information to a MRML file in XML format.
+  void WriteXML(ostream& of, int indent) override;
+
+  /// Copy the node's attributes to this object
+  void Copy(vtkMRMLNode* node) override;
+
   ///
   /// Get node XML tag name (like Storage, Model)
   const char* GetNodeTagName() override { return "LinearTransformSequenceStorage"; };
@@ -50,6 +61,18 @@ public:
   /// Return a default file extension for writing
   const char* GetDefaultWriteFileExtension() override;
 
+  /// Write transforms as a binary array of 4x4 matrices (one matrix per frame) instead of
+  /// text fields in the file header. Writing and reading is much faster and files are smaller
+  /// for long recordings, but the transforms cannot be read by applications that expect
+  /// them in the file header. Files are read correctly regardless of this setting.
+  /// Default is false.
+  vtkGetMacro(WriteBinaryTransforms, bool);
+  vtkSetMacro(WriteBinaryTransforms, bool);
+  vtkBooleanMacro(WriteBinaryTransforms, bool);
+
+  /// Return true if the file contains transforms as a binary array of matrices.
+  static bool IsBinaryTransformsFile(const std::string& fileName);
+
   /// Read all the fields in the metaimage file header.
   /// If sequence nodes are passed in createdNodes then they will be reused. New sequence nodes will be created if there are more transforms
   /// in the sequence metafile than pointers in createdNodes. The caller is responsible for deleting all nodes in createdNodes.
@@ -85,6 +108,15 @@ protected:
 
   /// Initialize all the supported write file types
   void InitializeSupportedWriteFileTypes() override;
+
+  /// Read transforms stored as a binary array of matrices into the sequence node.
+  /// Transforms are stored in compact form if it is enabled in the sequence node.
+  bool ReadBinaryTransformsFile(const std::string& fileName, vtkMRMLSequenceNode* sequenceNode);
+
+  /// Write transforms of the sequence node as a binary array of matrices
+  bool WriteBinaryTransformsFile(const std::string& fileName, vtkMRMLSequenceNode* sequenceNode, const std::string& transformName);
+
+  bool WriteBinaryTransforms{ false };
 };
 
 #endif
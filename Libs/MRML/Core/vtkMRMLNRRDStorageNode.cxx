@@ -46,11 +46,7 @@ vtkMRMLNRRDStorageNode::vtkMRMLNRRDStorageNode()
   this->CenterImage = 0;
   this->DefaultWriteFileExtension = "nhdr";
 
-  this->CompressionPresets.emplace_back(this->GetCompressionParameterFastest(), "Fastest");
-  this->CompressionPresets.emplace_back(this->GetCompressionParameterNormal(), "Normal");
-  this->CompressionPresets.emplace_back(this->GetCompressionParameterMinimumSize(), "Minimum size");
-
-  this->CompressionParameter = this->GetCompressionParameterFastest();
+  this->AddGzipCompressionPresets(true);
 }
 
 //----------------------------------------------------------------------------
@@ -372,6 +368,7 @@ int vtkMRMLNRRDStorageNode::WriteDataInternal(vtkMRMLNode* refNode)
   writer->SetInputConnection(volNode->GetImageDataConnection());
   writer->SetUseCompression(this->GetUseCompression());
   writer->SetCompressionLevel(this->GetGzipCompressionLevelFromCompressionParameter(this->CompressionParameter));
+  writer->SetNumberOfThreads(this->GetGzipCompressionNumberOfThreadsFromCompressionParameter(this->CompressionParameter));
 
   // set volume attributes
   writer->SetIJKToRASMatrix(ijkToRas.GetPointer());
@@ -579,24 +576,6 @@ void vtkMRMLNRRDStorageNode::InitializeSupportedWriteFileTypes()
   this->SupportedWriteFileTypes->InsertNextValue("NRRD (.nhdr)");
 }
 
-//----------------------------------------------------------------------------
-int vtkMRMLNRRDStorageNode::GetGzipCompressionLevelFromCompressionParameter(std::string compressionParameter)
-{
-  if (compressionParameter == this->GetCompressionParameterFastest())
-  {
-    return 1;
-  }
-  else if (compressionParameter == this->GetCompressionParameterNormal())
-  {
-    return 6;
-  }
-  else if (compressionParameter == this->GetCompressionParameterMinimumSize())
-  {
-    return 9;
-  }
-  return 1;
-}
-
 //----------------------------------------------------------------------------
 void vtkMRMLNRRDStorageNode::ConfigureForDataExchange()
 {
@@ -66,14 +66,6 @@ public:
   /// instance to turn off compression.
   void ConfigureForDataExchange() override;
 
-  /// Compression parameter corresponding to minimum compression (fast)
-  std::string GetCompressionParameterFastest() { return "gzip_fastest"; };
-
-  /// Compression parameter corresponding to normal compression
-  std::string GetCompressionParameterNormal() { return "gzip_normal"; };
-  /// Compression parameter corresponding to maximum compression (slow)
-  std::string GetCompressionParameterMinimumSize() { return "gzip_minimum_size"; };
-
 protected:
   vtkMRMLNRRDStorageNode();
   ~vtkMRMLNRRDStorageNode() override;
@@ -92,9 +84,6 @@ protected:
   /// Write data from a  referenced node
   int WriteDataInternal(vtkMRMLNode* refNode) override;
 
-  /// Convert compression parameter string to gzip compression level
-  int GetGzipCompressionLevelFromCompressionParameter(std::string parameter);
-
   int CenterImage;
 };
 
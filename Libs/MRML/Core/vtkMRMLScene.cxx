@@ -80,6 +80,8 @@ Version:   $Revision: 1.18 $
 #include "vtkMRMLSliceDisplayNode.h"
 #include "vtkMRMLSliceNode.h"
 #include "vtkMRMLSnapshotClipNode.h"
+#include "vtkMRMLStorableNode.h"
+#include "vtkMRMLStorageNode.h"
 #include "vtkMRMLSubjectHierarchyNode.h"
 #include "vtkMRMLTableNode.h"
 #include "vtkMRMLTableStorageNode.h"
@@ -109,9 +111,11 @@ Version:   $Revision: 1.18 $
 // VTK includes
 #include <vtkCallbackCommand.h>
 #include <vtkCollection.h>
+#include <vtkDataObject.h>
 #include <vtkDebugLeaks.h>
 #include <vtkObjectFactory.h>
 #include <vtkPNGWriter.h>
+#include <vtkSMPTools.h>
 #include <vtkSmartPointer.h>
 
 // VTKSYS includes
@@ -121,7 +125,9 @@ Version:   $Revision: 1.18 $
 
 // STD includes
 #include <algorithm>
+#include <iterator>
 #include <numeric>
+#include <set>
 
 // #define MRMLSCENE_VERBOSE
 
@@ -140,10 +146,13 @@ vtkMRMLScene::vtkMRMLScene()
   this->RandomGenerator.seed(std::random_device{}());
 
   this->NodeIDsMTime = 0;
+  this->NodesByClassMTime = 0;
 
   this->Nodes = vtkCollection::New();
   this->MaximumNumberOfSavedUndoStates = 20;
   this->UndoFlag = false;
+  this->UndoCopyOnWrite = false;
+  this->MaximumUndoMemorySize = 0;
 
   this->CacheManager = nullptr;
   this->DataIOManager = nullptr;
@@ -156,6 +165,8 @@ vtkMRMLScene::vtkMRMLScene()
 
   this->ReadDataOnLoad = 1;
 
+  this->ParallelDataLoading = false;
+
   this->LastLoadedVersion = nullptr;
   this->LastLoadedExtensions = nullptr;
   this->Version = nullptr;
@@ -905,6 +916,14 @@ int vtkMRMLScene::Import(vtkMRMLMessageCollection* userMessagesInput /*=nullptr*
       storageNode->FixFileName();
     }
 
+    // Read data files in parallel. Storage nodes only read the files into memory here,
+    // the nodes are updated from the preloaded data in UpdateScene below.
+    std::vector<std::pair<vtkMRMLStorageNode*, vtkMRMLStorableNode*>> preloadedStorageNodes;
+    if (this->ParallelDataLoading && this->ReadDataOnLoad)
+    {
+      preloadedStorageNodes = this->PreloadData(addedNodes);
+    }
+
     this->InvokeEvent(vtkMRMLScene::NewSceneEvent, nullptr);
 
     // Notify the imported nodes about that all nodes are created
@@ -932,6 +951,12 @@ int vtkMRMLScene::Import(vtkMRMLMessageCollection* userMessagesInput /*=nullptr*
       }
     }
 
+    // Release data that has not been used (e.g., because the node has been modified meanwhile)
+    for (const auto& storageAndStorableNode : preloadedStorageNodes)
+    {
+      storageAndStorableNode.first->ReleasePreloadedData();
+    }
+
     this->Modified();
     this->RemoveUnusedNodeReferences();
 #ifdef MRMLSCENE_VERBOSE
@@ -1339,10 +1364,12 @@ vtkMRMLNode* vtkMRMLScene::AddNodeNoNotify(vtkMRMLNode* n)
     n->SetName(this->GenerateUniqueName(n).c_str());
   }
   n->SetScene(this);
+  this->UpdateNodesByClass();
   this->Nodes->vtkCollection::AddItem((vtkObject*)n);
 
   // cache the node so the whole scene cache stays up-to date
   this->AddNodeID(n);
+  this->AddNodeToNodesByClass(n);
 
   // Keep the SH up-to-date
   if (vtkMRMLSubjectHierarchyNode::SafeDownCast(n) != nullptr && //
@@ -1545,10 +1572,12 @@ void vtkMRMLScene::RemoveNode(vtkMRMLNode* n)
   {
     n->SetScene(nullptr);
   }
+  this->UpdateNodesByClass();
   this->Nodes->vtkCollection::RemoveItem((vtkObject*)n);
 
   std::string nid = (n->GetID() ? n->GetID() : "");
   this->RemoveNodeID(n->GetID());
+  this->RemoveNodeFromNodesByClass(n);
 
   this->InvokeEvent(vtkMRMLScene::NodeRemovedEvent, n);
 
@@ -1804,17 +1833,7 @@ int vtkMRMLScene::GetNumberOfNodesByClass(const char* className)
     vtkErrorMacro("GetNumberOfNodesByClass: class name is null.");
     return 0;
   }
-  int num = 0;
-  vtkMRMLNode* node;
-  vtkCollectionSimpleIterator it;
-  for (this->Nodes->InitTraversal(it); (node = (vtkMRMLNode*)this->Nodes->GetNextItemAsObject(it));)
-  {
-    if (node->IsA(className))
-    {
-      num++;
-    }
-  }
-  return num;
+  return static_cast<int>(this->GetNodesByClassFromIndex(className).size());
 }
 
 //------------------------------------------------------------------------------
@@ -1826,15 +1845,8 @@ int vtkMRMLScene::GetNodesByClass(const char* className, std::vector<vtkMRMLNode
     vtkErrorMacro("GetNodesByClass: class name is null.");
     return 0;
   }
-  vtkMRMLNode* node;
-  vtkCollectionSimpleIterator it;
-  for (this->Nodes->InitTraversal(it); (node = (vtkMRMLNode*)this->Nodes->GetNextItemAsObject(it));)
-  {
-    if (node->IsA(className))
-    {
-      nodes.push_back(node);
-    }
-  }
+  const std::vector<vtkMRMLNode*>& indexedNodes = this->GetNodesByClassFromIndex(className);
+  nodes.insert(nodes.end(), indexedNodes.begin(), indexedNodes.end());
   return static_cast<int>(nodes.size());
 }
 
@@ -1847,14 +1859,9 @@ vtkCollection* vtkMRMLScene::GetNodesByClass(const char* className)
     return nullptr;
   }
   vtkCollection* nodes = vtkCollection::New();
-  vtkMRMLNode* node;
-  vtkCollectionSimpleIterator it;
-  for (this->Nodes->InitTraversal(it); (node = (vtkMRMLNode*)this->Nodes->GetNextItemAsObject(it));)
+  for (vtkMRMLNode* node : this->GetNodesByClassFromIndex(className))
   {
-    if (node->IsA(className))
-    {
-      nodes->AddItem(node);
-    }
+    nodes->AddItem(node);
   }
   return nodes;
 }
@@ -1914,12 +1921,9 @@ vtkMRMLNode* vtkMRMLScene::GetSingletonNode(const char* singletonTag, const char
     return nullptr;
   }
 
-  vtkCollectionSimpleIterator it;
-  vtkMRMLNode* node = nullptr;
-  for (this->Nodes->InitTraversal(it); (node = (vtkMRMLNode*)this->Nodes->GetNextItemAsObject(it));)
+  for (vtkMRMLNode* node : this->GetNodesByClassFromIndex(className))
   {
-    if (node->IsA(className) &&               //
-        node->GetSingletonTag() != nullptr && //
+    if (node->GetSingletonTag() != nullptr && //
         strcmp(node->GetSingletonTag(), singletonTag) == 0)
     {
       return node;
@@ -1988,21 +1992,12 @@ vtkMRMLNode* vtkMRMLScene::GetNthNodeByClass(int n, const char* className)
     return nullptr;
   }
 
-  int num = 0;
-  vtkMRMLNode* node;
-  vtkCollectionSimpleIterator it;
-  for (this->Nodes->InitTraversal(it); (node = (vtkMRMLNode*)this->Nodes->GetNextItemAsObject(it));)
+  const std::vector<vtkMRMLNode*>& nodes = this->GetNodesByClassFromIndex(className);
+  if (n >= static_cast<int>(nodes.size()))
   {
-    if (node->IsA(className))
-    {
-      if (num == n)
-      {
-        return node;
-      }
-      num++;
-    }
+    return nullptr;
   }
-  return nullptr;
+  return nodes[n];
 }
 
 //------------------------------------------------------------------------------
@@ -2141,11 +2136,9 @@ vtkCollection* vtkMRMLScene::GetNodesByClassByName(const char* className, const
     return nodes;
   }
 
-  vtkMRMLNode* node;
-  for (int n = 0; n < this->Nodes->GetNumberOfItems(); n++)
+  for (vtkMRMLNode* node : this->GetNodesByClassFromIndex(className))
   {
-    node = (vtkMRMLNode*)this->Nodes->GetItemAsObject(n);
-    if (node->GetName() != nullptr && !strcmp(node->GetName(), name) && node->IsA(className))
+    if (node->GetName() != nullptr && !strcmp(node->GetName(), name))
     {
       nodes->AddItem(node);
     }
@@ -2238,6 +2231,8 @@ vtkMRMLNode* vtkMRMLScene::InsertAfterNode(vtkMRMLNode* item, vtkMRMLNode* n)
   }
   // cache the node so the whole scene cache stays up-to-date
   this->AddNodeID(n);
+  // node may have been inserted in the middle of the scene, rebuild class lists when needed
+  this->ClearNodesByClass();
 
   n->SetDisableModifiedEvent(modifyStatus);
 
@@ -2334,6 +2329,8 @@ vtkMRMLNode* vtkMRMLScene::InsertBeforeNode(vtkMRMLNode* item, vtkMRMLNode* n)
   }
   // cache the node so the whole scene cache stays up-todate
   this->AddNodeID(n);
+  // node may have been inserted in the middle of the scene, rebuild class lists when needed
+  this->ClearNodesByClass();
 
   n->SetDisableModifiedEvent(modifyStatus);
 
@@ -2707,6 +2704,72 @@ void vtkMRMLScene::RemoveReservedIDs()
   this->ReservedIDs.clear();
 }
 
+//------------------------------------------------------------------------------
+namespace
+{
+
+//------------------------------------------------------------------------------
+// Last modification time of a node, including modification of its bulk data
+vtkMTimeType GetNodeUndoMTime(vtkMRMLNode* node)
+{
+  vtkMTimeType mtime = node->GetMTime();
+  vtkMRMLStorableNode* storableNode = vtkMRMLStorableNode::SafeDownCast(node);
+  if (storableNode)
+  {
+    mtime = std::max(mtime, storableNode->GetStorableModifiedMTime());
+  }
+  return mtime;
+}
+
+//------------------------------------------------------------------------------
+// Collect bulk data objects of a node
+void GetNodeUndoDataObjects(vtkMRMLNode* node, std::set<vtkDataObject*>& dataObjects)
+{
+  if (vtkMRMLVolumeNode* volumeNode = vtkMRMLVolumeNode::SafeDownCast(node))
+  {
+    if (volumeNode->GetImageData())
+    {
+      dataObjects.insert(volumeNode->GetImageData());
+    }
+  }
+  else if (vtkMRMLModelNode* modelNode = vtkMRMLModelNode::SafeDownCast(node))
+  {
+    if (modelNode->GetMesh())
+    {
+      dataObjects.insert(modelNode->GetMesh());
+    }
+  }
+  else if (vtkMRMLSegmentationNode* segmentationNode = vtkMRMLSegmentationNode::SafeDownCast(node))
+  {
+    vtkSegmentation* segmentation = segmentationNode->GetSegmentation();
+    if (!segmentation)
+    {
+      return;
+    }
+    std::vector<std::string> segmentIDs;
+    segmentation->GetSegmentIDs(segmentIDs);
+    for (const std::string& segmentID : segmentIDs)
+    {
+      vtkSegment* segment = segmentation->GetSegment(segmentID);
+      if (!segment)
+      {
+        continue;
+      }
+      std::vector<std::string> representationNames;
+      segment->GetContainedRepresentationNames(representationNames);
+      for (const std::string& representationName : representationNames)
+      {
+        if (segment->GetRepresentation(representationName))
+        {
+          dataObjects.insert(segment->GetRepresentation(representationName));
+        }
+      }
+    }
+  }
+}
+
+} // namespace
+
 //------------------------------------------------------------------------------
 // Pushes the current scene onto the undo stack, and makes a backup copy of the
 // passed node so that changes to the node are undoable; several signatures to handle
@@ -2741,6 +2804,7 @@ void vtkMRMLScene::SaveStateForUndo(vtkMRMLNode* node)
   {
     this->CopyNodeInUndoStack(node);
   }
+  this->TrimUndoStack();
 }
 
 //------------------------------------------------------------------------------
@@ -2772,6 +2836,7 @@ void vtkMRMLScene::SaveStateForUndo(std::vector<vtkMRMLNode*> nodes)
       this->CopyNodeInUndoStack(node);
     }
   }
+  this->TrimUndoStack();
 }
 
 //------------------------------------------------------------------------------
@@ -2811,6 +2876,7 @@ void vtkMRMLScene::SaveStateForUndo(vtkCollection* nodes)
       this->CopyNodeInUndoStack(node);
     }
   }
+  this->TrimUndoStack();
 }
 
 //------------------------------------------------------------------------------
@@ -2897,10 +2963,34 @@ void vtkMRMLScene::CopyNodeInUndoStack(vtkMRMLNode* copyNode)
     return;
   }
 
-  vtkMRMLNode* snode = copyNode->CreateNodeInstance();
-  if (snode != nullptr)
+  vtkSmartPointer<vtkMRMLNode> snode;
+  std::string nodeID = copyNode->GetID() ? copyNode->GetID() : "";
+  if (this->UndoCopyOnWrite && !nodeID.empty())
+  {
+    // Reuse the copy that is already in the undo stack if the node has not been modified since
+    std::map<std::string, UndoNodeCopy>::iterator nodeCopyIt = this->UndoNodeCopies.find(nodeID);
+    if (nodeCopyIt != this->UndoNodeCopies.end() && nodeCopyIt->second.SourceNode.GetPointer() == copyNode //
+        && nodeCopyIt->second.NodeCopy && GetNodeUndoMTime(copyNode) <= nodeCopyIt->second.SourceNodeMTime)
+    {
+      snode = nodeCopyIt->second.NodeCopy.GetPointer();
+    }
+  }
+  if (!snode)
   {
+    snode = vtkSmartPointer<vtkMRMLNode>::Take(copyNode->CreateNodeInstance());
+    if (snode == nullptr)
+    {
+      vtkErrorMacro("CopyNodeInUndoStack: failed to create node instance");
+      return;
+    }
     snode->CopyWithScene(copyNode);
+    if (this->UndoCopyOnWrite && !nodeID.empty())
+    {
+      UndoNodeCopy& nodeCopy = this->UndoNodeCopies[nodeID];
+      nodeCopy.SourceNode = copyNode;
+      nodeCopy.NodeCopy = snode;
+      nodeCopy.SourceNodeMTime = GetNodeUndoMTime(copyNode);
+    }
   }
 
   vtkCollection* undoScene = this->UndoStack.back();
@@ -2914,7 +3004,6 @@ void vtkMRMLScene::CopyNodeInUndoStack(vtkMRMLNode* copyNode)
       break;
     }
   }
-  snode->Delete();
 }
 
 //------------------------------------------------------------------------------
@@ -3045,6 +3134,11 @@ void vtkMRMLScene::Undo()
 
   for (nn = 0; nn < addNodes.size(); nn++)
   {
+    if (this->UndoCopyOnWrite)
+    {
+      // The node copy becomes a scene node, older undo states must not share it anymore
+      this->DetachNodeFromUndoStack(addNodes[nn], undoScene);
+    }
     this->AddNode(addNodes[nn]);
     addNodes[nn]->SetSceneReferences();
   }
@@ -3209,6 +3303,7 @@ void vtkMRMLScene::ClearUndoStack()
     (*iter)->Delete();
   }
   this->UndoStack.clear();
+  this->UndoNodeCopies.clear();
 }
 
 //------------------------------------------------------------------------------
@@ -3353,6 +3448,59 @@ void vtkMRMLScene::UpdateNodeReferences(vtkCollection* checkNodes /*=nullptr*/)
   }
 }
 
+//------------------------------------------------------------------------------
+std::vector<std::pair<vtkMRMLStorageNode*, vtkMRMLStorableNode*>> vtkMRMLScene::PreloadData(vtkCollection* nodes)
+{
+  // Node references are resolved here, in the main thread, because resolving
+  // a reference may modify the referencing node.
+  std::vector<std::pair<vtkMRMLStorageNode*, vtkMRMLStorableNode*>> storageAndStorableNodes;
+  vtkCollectionSimpleIterator it;
+  vtkMRMLNode* node = nullptr;
+  for (nodes->InitTraversal(it); (node = vtkMRMLNode::SafeDownCast(nodes->GetNextItemAsObject(it)));)
+  {
+    vtkMRMLStorableNode* storableNode = vtkMRMLStorableNode::SafeDownCast(node);
+    if (!storableNode || !storableNode->GetAddToScene())
+    {
+      continue;
+    }
+    int numberOfStorageNodes = storableNode->GetNumberOfStorageNodes();
+    for (int i = 0; i < numberOfStorageNodes; i++)
+    {
+      vtkMRMLStorageNode* storageNode = storableNode->GetNthStorageNode(i);
+      if (storageNode)
+      {
+        storageAndStorableNodes.emplace_back(storageNode, storableNode);
+      }
+    }
+  }
+  if (storageAndStorableNodes.empty())
+  {
+    return storageAndStorableNodes;
+  }
+
+  // Read the files. PreloadData does not modify any MRML nodes, and the main thread
+  // is blocked until all files are read, so the scene cannot change meanwhile.
+  std::vector<char> preloaded(storageAndStorableNodes.size(), 0);
+  vtkSMPTools::For(0, static_cast<vtkIdType>(storageAndStorableNodes.size()), 1,
+    [&](vtkIdType begin, vtkIdType end)
+    {
+      for (vtkIdType index = begin; index < end; ++index)
+      {
+        preloaded[index] = storageAndStorableNodes[index].first->PreloadData(storageAndStorableNodes[index].second) ? 1 : 0;
+      }
+    });
+
+  std::vector<std::pair<vtkMRMLStorageNode*, vtkMRMLStorableNode*>> preloadedStorageNodes;
+  for (size_t index = 0; index < storageAndStorableNodes.size(); ++index)
+  {
+    if (preloaded[index])
+    {
+      preloadedStorageNodes.push_back(storageAndStorableNodes[index]);
+    }
+  }
+  return preloadedStorageNodes;
+}
+
 //------------------------------------------------------------------------------
 void vtkMRMLScene::RemoveInvalidNodeReferences(vtkCollection* checkNodes, const std::set<std::string>& validNodeIDs)
 {
@@ -3554,6 +3702,90 @@ void vtkMRMLScene::ClearNodeIDs()
   }
 }
 
+//-----------------------------------------------------------------------------
+const std::vector<vtkMRMLNode*>& vtkMRMLScene::GetNodesByClassFromIndex(const char* className)
+{
+  this->UpdateNodesByClass();
+  std::map<std::string, std::vector<vtkMRMLNode*>>::iterator classIt = this->NodesByClass.find(className);
+  if (classIt != this->NodesByClass.end())
+  {
+    return classIt->second;
+  }
+  // First query for this class, collect nodes from the scene
+  std::vector<vtkMRMLNode*>& nodes = this->NodesByClass[className];
+  vtkMRMLNode* node;
+  vtkCollectionSimpleIterator it;
+  for (this->Nodes->InitTraversal(it); (node = (vtkMRMLNode*)this->Nodes->GetNextItemAsObject(it));)
+  {
+    if (node->IsA(className))
+    {
+      nodes.push_back(node);
+    }
+  }
+  return nodes;
+}
+
+//-----------------------------------------------------------------------------
+void vtkMRMLScene::UpdateNodesByClass()
+{
+  // The Nodes collection is public, if it was modified directly then
+  // the node lists are not valid anymore.
+  if (this->Nodes && this->Nodes->GetMTime() > this->NodesByClassMTime)
+  {
+    this->ClearNodesByClass();
+  }
+}
+
+//-----------------------------------------------------------------------------
+void vtkMRMLScene::AddNodeToNodesByClass(vtkMRMLNode* node)
+{
+  if (!this->Nodes || !node)
+  {
+    return;
+  }
+  for (std::map<std::string, std::vector<vtkMRMLNode*>>::iterator classIt = this->NodesByClass.begin(); classIt != this->NodesByClass.end(); ++classIt)
+  {
+    if (node->IsA(classIt->first.c_str()))
+    {
+      classIt->second.push_back(node);
+    }
+  }
+  this->NodesByClassMTime = this->Nodes->GetMTime();
+}
+
+//-----------------------------------------------------------------------------
+void vtkMRMLScene::RemoveNodeFromNodesByClass(vtkMRMLNode* node)
+{
+  if (!this->Nodes || !node)
+  {
+    return;
+  }
+  for (std::map<std::string, std::vector<vtkMRMLNode*>>::iterator classIt = this->NodesByClass.begin(); classIt != this->NodesByClass.end(); ++classIt)
+  {
+    if (!node->IsA(classIt->first.c_str()))
+    {
+      continue;
+    }
+    // nodes are often removed in reverse order of addition, search from the end
+    std::vector<vtkMRMLNode*>::reverse_iterator nodeIt = std::find(classIt->second.rbegin(), classIt->second.rend(), node);
+    if (nodeIt != classIt->second.rend())
+    {
+      classIt->second.erase(std::next(nodeIt).base());
+    }
+  }
+  this->NodesByClassMTime = this->Nodes->GetMTime();
+}
+
+//-----------------------------------------------------------------------------
+void vtkMRMLScene::ClearNodesByClass()
+{
+  if (this->Nodes)
+  {
+    this->NodesByClass.clear();
+    this->NodesByClassMTime = this->Nodes->GetMTime();
+  }
+}
+
 //------------------------------------------------------------------------------
 void vtkMRMLScene::AddURIHandler(vtkURIHandler* handler)
 {
@@ -3907,9 +4139,101 @@ void vtkMRMLScene::TrimUndoStack()
   std::list<vtkSmartPointer<vtkCollection>> removedStacks;
   while (static_cast<int>(this->UndoStack.size()) > this->MaximumNumberOfSavedUndoStates)
   {
-    removedStacks.emplace_back(this->UndoStack.front());
+    removedStacks.push_back(vtkSmartPointer<vtkCollection>::Take(this->UndoStack.front()));
     this->UndoStack.pop_front();
   }
+  while (this->MaximumUndoMemorySize > 0 && this->UndoStack.size() > 1 && this->GetUndoMemorySize() > this->MaximumUndoMemorySize)
+  {
+    removedStacks.push_back(vtkSmartPointer<vtkCollection>::Take(this->UndoStack.front()));
+    this->UndoStack.pop_front();
+  }
+}
+
+//-----------------------------------------------------------------------------
+void vtkMRMLScene::SetMaximumUndoMemorySize(vtkTypeInt64 maximumMemorySizeBytes)
+{
+  if (maximumMemorySizeBytes == this->MaximumUndoMemorySize)
+  {
+    return;
+  }
+  this->MaximumUndoMemorySize = maximumMemorySizeBytes;
+  this->TrimUndoStack();
+  this->Modified();
+}
+
+//-----------------------------------------------------------------------------
+vtkTypeInt64 vtkMRMLScene::GetUndoMemorySize()
+{
+  // Nodes that are in the scene are not copies, they are not counted
+  std::set<vtkMRMLNode*> sceneNodes;
+  int numberOfSceneNodes = this->Nodes ? this->Nodes->GetNumberOfItems() : 0;
+  for (int n = 0; n < numberOfSceneNodes; n++)
+  {
+    sceneNodes.insert(vtkMRMLNode::SafeDownCast(this->Nodes->GetItemAsObject(n)));
+  }
+
+  std::set<vtkMRMLNode*> nodeCopies;
+  std::set<vtkDataObject*> dataObjects;
+  for (const std::list<vtkCollection*>* stack : { &this->UndoStack, &this->RedoStack })
+  {
+    for (vtkCollection* stackScene : *stack)
+    {
+      int nnodes = stackScene->GetNumberOfItems();
+      for (int n = 0; n < nnodes; n++)
+      {
+        vtkMRMLNode* node = vtkMRMLNode::SafeDownCast(stackScene->GetItemAsObject(n));
+        if (!node || sceneNodes.find(node) != sceneNodes.end() || !nodeCopies.insert(node).second)
+        {
+          continue;
+        }
+        GetNodeUndoDataObjects(node, dataObjects);
+      }
+    }
+  }
+
+  vtkTypeInt64 memorySize = 0;
+  for (vtkDataObject* dataObject : dataObjects)
+  {
+    // GetActualMemorySize returns size in kibibytes
+    memorySize += static_cast<vtkTypeInt64>(dataObject->GetActualMemorySize()) * 1024;
+  }
+  return memorySize;
+}
+
+//-----------------------------------------------------------------------------
+void vtkMRMLScene::DetachNodeFromUndoStack(vtkMRMLNode* node, vtkCollection* excludedUndoScene)
+{
+  if (!node)
+  {
+    return;
+  }
+  vtkSmartPointer<vtkMRMLNode> nodeCopy;
+  for (vtkCollection* undoScene : this->UndoStack)
+  {
+    if (undoScene == excludedUndoScene)
+    {
+      continue;
+    }
+    int nnodes = undoScene->GetNumberOfItems();
+    for (int n = 0; n < nnodes; n++)
+    {
+      if (undoScene->GetItemAsObject(n) != node)
+      {
+        continue;
+      }
+      if (!nodeCopy)
+      {
+        nodeCopy = vtkSmartPointer<vtkMRMLNode>::Take(node->CreateNodeInstance());
+        nodeCopy->CopyWithScene(node);
+      }
+      undoScene->ReplaceItem(n, nodeCopy);
+      break;
+    }
+  }
+  if (node->GetID())
+  {
+    this->UndoNodeCopies.erase(node->GetID());
+  }
 }
 
 //----------------------------------------------------------------------------
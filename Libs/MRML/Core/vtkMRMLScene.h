@@ -309,7 +309,11 @@ public:
   /// Get number of nodes of a specified class in the scene
   int GetNumberOfNodesByClass(const char* className);
 
-  /// Get vector of nodes of a specified class in the scene
+  /// Get vector of nodes of a specified class in the scene.
+  /// The content of \a nodes is replaced, its allocated memory is reused.
+  /// \note Node lists of each queried class are cached and updated on demand, therefore
+  /// GetNodesByClass(), GetNumberOfNodesByClass(), GetNthNodeByClass() and similar methods
+  /// modify the scene internally: they must not be called concurrently from multiple threads.
   int GetNodesByClass(const char* className, std::vector<vtkMRMLNode*>& nodes);
 
   /// \warning You are responsible for deleting the returned collection.
@@ -536,6 +540,19 @@ public:
   vtkSetMacro(ReadDataOnLoad, int);
   vtkGetMacro(ReadDataOnLoad, int);
 
+  /// \brief Read data files of the imported nodes in parallel.
+  ///
+  /// If enabled, Import() reads the data files referenced by the storage nodes
+  /// of the imported scene in multiple threads (using vtkSMPTools) before the nodes
+  /// are updated. Only file reading is performed in parallel (see vtkMRMLStorageNode::PreloadData()),
+  /// all MRML nodes are still updated in the main thread, in the same order as without
+  /// parallel loading. Storage nodes that do not support preloading read their data
+  /// sequentially, as usual. Disabled by default.
+  /// \sa Import(), GetReadDataOnLoad()
+  vtkSetMacro(ParallelDataLoading, bool);
+  vtkGetMacro(ParallelDataLoading, bool);
+  vtkBooleanMacro(ParallelDataLoading, bool);
+
   /// \brief Set the XML string to read from by Import() if
   /// GetLoadFromXMLString() is true.
   ///
@@ -799,6 +816,31 @@ public:
   void SetMaximumNumberOfSavedUndoStates(int stackSize);
   vtkGetMacro(MaximumNumberOfSavedUndoStates, int);
 
+  /// \brief Enable copy-on-write undo snapshots.
+  ///
+  /// If enabled, SaveStateForUndo() only copies nodes that have been modified since their
+  /// last copy was stored in the undo stack. Unmodified nodes (including their bulk data,
+  /// such as image data or meshes) are shared between undo stack entries.
+  /// Disabled by default.
+  vtkSetMacro(UndoCopyOnWrite, bool);
+  vtkGetMacro(UndoCopyOnWrite, bool);
+  vtkBooleanMacro(UndoCopyOnWrite, bool);
+
+  /// \brief Sets the maximum memory size (in bytes) of the undo and redo stacks.
+  ///
+  /// If the limit is exceeded then the oldest saved undo states are removed
+  /// (the most recent undo state is always kept).
+  /// 0 means no limit (default).
+  /// \sa GetUndoMemorySize()
+  void SetMaximumUndoMemorySize(vtkTypeInt64 maximumMemorySizeBytes);
+  vtkGetMacro(MaximumUndoMemorySize, vtkTypeInt64);
+
+  /// \brief Returns the estimated memory size (in bytes) of node copies stored in the undo and redo stacks.
+  ///
+  /// Only bulk data of volume, model, and segmentation nodes is taken into account.
+  /// Node copies that are shared between stack entries are only counted once.
+  vtkTypeInt64 GetUndoMemorySize();
+
   /// \brief Returns a string for the temporary directory to use for saving/reading scene files.
   /// The directory is created from the current date/time as well as a random number 0-999.
   std::string GetTemporaryBundleDirectory();
@@ -875,6 +917,11 @@ protected:
   /// Remove invalid node references after scene import
   void RemoveInvalidNodeReferences(vtkCollection* checkNodes, const std::set<std::string>& validNodeIDs);
 
+  /// Read data files of the storable nodes in \a nodes in parallel using vtkSMPTools.
+  /// Returns the storage nodes that preloaded data for their storable node.
+  /// \sa SetParallelDataLoading(), vtkMRMLStorageNode::PreloadData()
+  std::vector<std::pair<vtkMRMLStorageNode*, vtkMRMLStorableNode*>> PreloadData(vtkCollection* nodes);
+
   /// Handle vtkMRMLScene::DeleteEvent: clear the scene.
   static void SceneCallback(vtkObject* caller, unsigned long eid, void* clientData, void* callData);
 
@@ -909,12 +956,39 @@ protected:
   /// Clear NodeIDs map used to speedup GetByID() method.
   void ClearNodeIDs();
 
+  /// \brief Get nodes of a class (including subclasses) in the order they are in the scene.
+  ///
+  /// The list is computed by traversing the scene when a class is first queried and
+  /// then it is kept up-to-date by AddNodeToNodesByClass() and RemoveNodeFromNodesByClass().
+  /// The returned reference is only valid until the scene is modified.
+  /// The cache is filled lazily, so this method is not thread-safe, even for read-only use of the scene.
+  const std::vector<vtkMRMLNode*>& GetNodesByClassFromIndex(const char* className);
+
+  /// \brief Synchronize NodesByClass map used to speedup GetNodesByClass() methods with the
+  /// \a Nodes collection. Must be called before nodes are added to or removed from the collection.
+  void UpdateNodesByClass();
+
+  /// Add node that has just been appended to the \a Nodes collection to \a NodesByClass map.
+  void AddNodeToNodesByClass(vtkMRMLNode* node);
+
+  /// Remove node that has just been removed from the \a Nodes collection from \a NodesByClass map.
+  void RemoveNodeFromNodesByClass(vtkMRMLNode* node);
+
+  /// Clear NodesByClass map used to speedup GetNodesByClass() methods.
+  void ClearNodesByClass();
+
   /// Get a NodeReferences iterator for a node reference.
   NodeReferencesType::iterator FindNodeReference(const char* referencedId, vtkMRMLNode* referencingNode);
 
   /// Clean up elements of the undo/redo stack beyond the maximum size
+  /// and beyond the maximum memory size
   void TrimUndoStack();
 
+  /// Replace a node copy in all undo stack entries by a new copy.
+  /// Called before a node copy that may be shared by multiple entries (see UndoCopyOnWrite)
+  /// is added to the scene, to prevent changes of the node from altering saved states.
+  void DetachNodeFromUndoStack(vtkMRMLNode* node, vtkCollection* excludedUndoScene);
+
   /// Reserve all node reference ids for a node
   void ReserveNodeReferenceIDs(vtkMRMLNode* node);
 
@@ -950,6 +1024,18 @@ protected:
 
   int MaximumNumberOfSavedUndoStates;
   bool UndoFlag;
+  bool UndoCopyOnWrite;
+  vtkTypeInt64 MaximumUndoMemorySize;
+
+  /// Most recent copy of each node stored in the undo stack (indexed by node ID),
+  /// used for sharing unmodified node copies between undo stack entries.
+  struct UndoNodeCopy
+  {
+    vtkWeakPointer<vtkMRMLNode> SourceNode;
+    vtkWeakPointer<vtkMRMLNode> NodeCopy;
+    vtkMTimeType SourceNodeMTime{ 0 };
+  };
+  std::map<std::string, UndoNodeCopy> UndoNodeCopies;
 
   std::list<vtkCollection*> UndoStack;
   std::list<vtkCollection*> RedoStack;
@@ -968,6 +1054,8 @@ protected:
   NodeReferencesType NodeReferences; // ReferencedIDs (string), ReferencingNodes (node pointer)
   std::map<std::string, std::string> ReferencedIDChanges;
   std::map<std::string, vtkSmartPointer<vtkMRMLNode>> NodeIDs;
+  // Nodes of each queried class name (including subclasses), in scene order
+  std::map<std::string, std::vector<vtkMRMLNode*>> NodesByClass;
 
   // Stores default nodes. If a class is created or reset (using CreateNodeByClass or Clear) and
   // a default node is defined for it then the content of the default node will be used to initialize
@@ -982,7 +1070,10 @@ protected:
 
   int ReadDataOnLoad;
 
+  bool ParallelDataLoading;
+
   vtkMTimeType NodeIDsMTime;
+  vtkMTimeType NodesByClassMTime;
 
   void RemoveAllNodes(bool removeSingletons);
 
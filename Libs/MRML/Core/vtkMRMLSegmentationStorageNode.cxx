@@ -39,7 +39,6 @@
 #include <vtkErrorCode.h>
 #include <vtkFieldData.h>
 #include <vtkImageAccumulate.h>
-#include <vtkImageAppendComponents.h>
 #include <vtkImageCast.h>
 #include <vtkImageConstantPad.h>
 #include <vtkImageExtractComponents.h>
@@ -91,11 +90,29 @@ static const std::string KEY_SEGMENTATION_REFERENCE_IMAGE_EXTENT_OFFSET = "Refer
 static const std::string KEY_SEGMENTATION_CONTAINED_REPRESENTATION_NAMES = "ContainedRepresentationNames";
 
 static const int SINGLE_SEGMENT_INDEX = -1; // used as segment index when there is only a single segment
+
+//----------------------------------------------------------------------------
+static void SetupBinaryLabelmapReader(vtkITKArchetypeImageSeriesVectorReaderFile* archetypeImageReader, const std::string& path)
+{
+  archetypeImageReader->SetSingleFile(1);
+  archetypeImageReader->SetUseOrientationFromFile(1);
+  archetypeImageReader->ResetFileNames();
+  archetypeImageReader->SetArchetype(path.c_str());
+  archetypeImageReader->SetOutputScalarTypeToNative();
+  archetypeImageReader->SetDesiredCoordinateOrientationToNative();
+  archetypeImageReader->SetUseNativeOriginOn();
+}
+
 //----------------------------------------------------------------------------
 vtkMRMLNodeNewMacro(vtkMRMLSegmentationStorageNode);
 
 //----------------------------------------------------------------------------
-vtkMRMLSegmentationStorageNode::vtkMRMLSegmentationStorageNode() = default;
+vtkMRMLSegmentationStorageNode::vtkMRMLSegmentationStorageNode()
+{
+  this->AddGzipCompressionPresets(true);
+  // Segmentation files used to be written with the default zlib compression level
+  this->CompressionParameter = vtkMRMLStorageNode::GetCompressionParameterNormalMultiThreaded();
+}
 
 //----------------------------------------------------------------------------
 vtkMRMLSegmentationStorageNode::~vtkMRMLSegmentationStorageNode() = default;
@@ -250,6 +267,52 @@ bool vtkMRMLSegmentationStorageNode::CanReadInReferenceNode(vtkMRMLNode* refNode
   return refNode->IsA("vtkMRMLSegmentationNode");
 }
 
+//----------------------------------------------------------------------------
+bool vtkMRMLSegmentationStorageNode::PreloadData(vtkMRMLNode* refNode)
+{
+  this->ReleasePreloadedData();
+  if (!vtkMRMLSegmentationNode::SafeDownCast(refNode))
+  {
+    return false;
+  }
+  std::string fullName = this->GetFullNameFromFileName();
+  if (fullName.empty() || !vtksys::SystemTools::FileExists(fullName.c_str()))
+  {
+    return false;
+  }
+  vtkSmartPointer<vtkITKArchetypeImageSeriesVectorReaderFile> archetypeImageReader = vtkSmartPointer<vtkITKArchetypeImageSeriesVectorReaderFile>::New();
+  SetupBinaryLabelmapReader(archetypeImageReader, fullName);
+  if (!archetypeImageReader->CanReadFile(fullName.c_str()))
+  {
+    return false;
+  }
+  try
+  {
+    archetypeImageReader->Update();
+  }
+  catch (...)
+  {
+    // ReadData() will read the file again and report the error
+    return false;
+  }
+  if (archetypeImageReader->GetErrorCode() != vtkErrorCode::NoError)
+  {
+    return false;
+  }
+  this->PreloadedReader = archetypeImageReader;
+  this->PreloadedNode = refNode;
+  this->PreloadedFileName = fullName;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLSegmentationStorageNode::ReleasePreloadedData()
+{
+  this->PreloadedReader = nullptr;
+  this->PreloadedNode = nullptr;
+  this->PreloadedFileName.clear();
+}
+
 //----------------------------------------------------------------------------
 int vtkMRMLSegmentationStorageNode::ReadDataInternal(vtkMRMLNode* refNode)
 {
@@ -538,14 +601,19 @@ int vtkMRMLSegmentationStorageNode::ReadBinaryLabelmapRepresentation(vtkMRMLSegm
 
   vtkSmartPointer<vtkImageData> imageData = nullptr;
 
-  vtkNew<vtkITKArchetypeImageSeriesVectorReaderFile> archetypeImageReader;
-  archetypeImageReader->SetSingleFile(1);
-  archetypeImageReader->SetUseOrientationFromFile(1);
-  archetypeImageReader->ResetFileNames();
-  archetypeImageReader->SetArchetype(path.c_str());
-  archetypeImageReader->SetOutputScalarTypeToNative();
-  archetypeImageReader->SetDesiredCoordinateOrientationToNative();
-  archetypeImageReader->SetUseNativeOriginOn();
+  // Use the preloaded reader if the file has been read already
+  vtkSmartPointer<vtkITKArchetypeImageSeriesVectorReaderFile> archetypeImageReader;
+  if (this->PreloadedReader && this->PreloadedNode.GetPointer() == segmentationNode && this->PreloadedFileName == path)
+  {
+    archetypeImageReader = this->PreloadedReader;
+  }
+  bool preloaded = (archetypeImageReader.GetPointer() != nullptr);
+  this->ReleasePreloadedData();
+  if (!preloaded)
+  {
+    archetypeImageReader = vtkSmartPointer<vtkITKArchetypeImageSeriesVectorReaderFile>::New();
+    SetupBinaryLabelmapReader(archetypeImageReader, path);
+  }
 
   int numberOfSegments = 0;
   std::map<int, std::vector<int>> segmentIndexInLayer;
@@ -556,12 +624,15 @@ int vtkMRMLSegmentationStorageNode::ReadBinaryLabelmapRepresentation(vtkMRMLSegm
   bool isExtentValid = false;
   int referenceImageExtentOffset[3] = { 0, 0, 0 };
 
-  if (archetypeImageReader->CanReadFile(path.c_str()))
+  if (preloaded || archetypeImageReader->CanReadFile(path.c_str()))
   {
     // Read the volume
-    this->GetUserMessages()->SetObservedObject(archetypeImageReader);
-    archetypeImageReader->Update();
-    this->GetUserMessages()->SetObservedObject(nullptr);
+    if (!preloaded)
+    {
+      this->GetUserMessages()->SetObservedObject(archetypeImageReader);
+      archetypeImageReader->Update();
+      this->GetUserMessages()->SetObservedObject(nullptr);
+    }
     if (archetypeImageReader->GetErrorCode() != vtkErrorCode::NoError)
     {
       vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLSegmentationStorageNode::ReadBinaryLabelmapRepresentation", "Error reading image.");
@@ -1335,6 +1406,8 @@ int vtkMRMLSegmentationStorageNode::WriteBinaryLabelmapRepresentation(vtkMRMLSeg
   vtkNew<vtkTeemNRRDWriter> writer;
   writer->SetFileName(fullName.c_str());
   writer->SetUseCompression(this->GetUseCompression());
+  writer->SetCompressionLevel(this->GetGzipCompressionLevelFromCompressionParameter(this->CompressionParameter));
+  writer->SetNumberOfThreads(this->GetGzipCompressionNumberOfThreadsFromCompressionParameter(this->CompressionParameter));
   writer->SetSpace(nrrdSpaceLeftPosteriorSuperior);
   writer->SetMeasurementFrameMatrix(nullptr);
 
@@ -1369,7 +1442,9 @@ int vtkMRMLSegmentationStorageNode::WriteBinaryLabelmapRepresentation(vtkMRMLSeg
   std::string containedRepresentationNames = this->SerializeContainedRepresentationNames(segmentation);
   writer->SetAttribute(GetSegmentationMetaDataKey(KEY_SEGMENTATION_CONTAINED_REPRESENTATION_NAMES).c_str(), containedRepresentationNames);
 
-  vtkNew<vtkImageAppendComponents> appender;
+  // Layers are passed to the writer as separate inputs, which are interleaved
+  // while writing, to avoid creating a merged copy of all the layers in memory.
+  std::vector<vtkSmartPointer<vtkOrientedImageData>> layerImages;
 
   unsigned int layerIndex = 0;
   std::map<vtkDataObject*, int> labelmapLayers;
@@ -1463,7 +1538,7 @@ int vtkMRMLSegmentationStorageNode::WriteBinaryLabelmapRepresentation(vtkMRMLSeg
     if (labelmapLayers.find(originalRepresentation) == labelmapLayers.end())
     {
       labelmapLayers[originalRepresentation] = layerIndex;
-      appender->AddInputData(currentBinaryLabelmap);
+      layerImages.push_back(currentBinaryLabelmap);
       ++layerIndex;
     }
     unsigned int layer = labelmapLayers[originalRepresentation];
@@ -1474,10 +1549,13 @@ int vtkMRMLSegmentationStorageNode::WriteBinaryLabelmapRepresentation(vtkMRMLSeg
   } // For each segment
 
   this->GetUserMessages()->SetObservedObject(writer);
-  if (segmentationNode->GetSegmentation()->GetNumberOfSegments() > 0)
+  if (!layerImages.empty())
   {
-    appender->Update();
-    writer->SetInputConnection(appender->GetOutputPort());
+    writer->SetInputData(layerImages[0]);
+    for (size_t layerImageIndex = 1; layerImageIndex < layerImages.size(); ++layerImageIndex)
+    {
+      writer->AddInputDataObject(layerImages[layerImageIndex]);
+    }
     writer->SetVectorAxisKind(nrrdKindList);
   }
   else
@@ -28,6 +28,10 @@
 // MRML includes
 #include "vtkMRMLStorageNode.h"
 
+// VTK includes
+#include <vtkSmartPointer.h>
+#include <vtkWeakPointer.h>
+
 #ifdef SUPPORT_4D_SPATIAL_NRRD
 // ITK includes
 # include <itkImageRegionIteratorWithIndex.h>
@@ -42,6 +46,7 @@ class vtkMRMLSegmentationNode;
 class vtkSegment;
 class vtkInformationStringKey;
 class vtkInformationIntegerVectorKey;
+class vtkITKArchetypeImageSeriesVectorReaderFile;
 
 /// \brief MRML node for segmentation storage on disk.
 ///
@@ -111,6 +116,12 @@ public:
   vtkGetMacro(CropToMinimumExtent, bool);
   vtkBooleanMacro(CropToMinimumExtent, bool);
 
+  /// Read the binary labelmap file into memory without modifying the segmentation node.
+  /// Polygonal mesh representations are not preloaded.
+  /// \sa vtkMRMLStorageNode::PreloadData()
+  bool PreloadData(vtkMRMLNode* refNode) override;
+  void ReleasePreloadedData() override;
+
 protected:
   /// Initialize all the supported read file types
   void InitializeSupportedReadFileTypes() override;
@@ -179,6 +190,12 @@ protected:
 protected:
   bool CropToMinimumExtent{ false };
 
+  /// Reader that already read the binary labelmap file of PreloadedNode.
+  /// \sa PreloadData()
+  vtkSmartPointer<vtkITKArchetypeImageSeriesVectorReaderFile> PreloadedReader;
+  vtkWeakPointer<vtkMRMLNode> PreloadedNode;
+  std::string PreloadedFileName;
+
 protected:
   vtkMRMLSegmentationStorageNode();
   ~vtkMRMLSegmentationStorageNode() override;
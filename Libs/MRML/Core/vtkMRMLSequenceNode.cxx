@@ -20,18 +20,23 @@
 #include "vtkMRMLSequenceNode.h"
 #include "vtkMRMLSequenceStorageNode.h"
 #include "vtkMRMLStorableNode.h"
+#include "vtkMRMLStorageNode.h"
 
 // MRML includes
+#include <vtkMRMLLinearTransformNode.h>
 #include <vtkMRMLScene.h>
 
 // VTK includes
 #include <vtkNew.h>
 #include <vtkCollection.h>
+#include <vtkMatrix4x4.h>
 #include <vtkObjectFactory.h>
 #include <vtkSmartPointer.h>
 #include <vtkTimerLog.h>
+#include <vtkTimeStamp.h>
 
 // STD includes
+#include <algorithm>
 #include <sstream>
 
 #define SAFE_CHAR_POINTER(unsafeString) (unsafeString == nullptr ? "" : unsafeString)
@@ -50,6 +55,18 @@
     this->Modified();                                          \
   }
 
+namespace
+{
+//------------------------------------------------------------------------------
+/// Return a modified time that is later than all modifications that have been made so far
+vtkMTimeType GetCurrentModifiedTime()
+{
+  vtkTimeStamp timeStamp;
+  timeStamp.Modified();
+  return timeStamp.GetMTime();
+}
+} // namespace
+
 //------------------------------------------------------------------------------
 vtkMRMLNodeNewMacro(vtkMRMLSequenceNode);
 vtkCxxSetVariableInDataAndStorageNodeMacro(IndexName, const std::string&);
@@ -84,6 +101,9 @@ vtkMRMLSequenceNode::~vtkMRMLSequenceNode()
 void vtkMRMLSequenceNode::RemoveAllDataNodes()
 {
   this->IndexEntries.clear();
+  this->InvalidateItemNumberByIndexValue();
+  this->CompactTransformMatrices.clear();
+  this->CompactTransformMatrices.shrink_to_fit();
   if (!this->SequenceScene)
   {
     return;
@@ -110,14 +130,26 @@ void vtkMRMLSequenceNode::WriteXML(ostream& of, int nIndent)
 
   of << indent << " numericIndexValueTolerance=\"" << this->NumericIndexValueTolerance << "\"";
 
+  if (this->CompactLinearTransformStorage)
+  {
+    of << indent << " compactLinearTransformStorage=\"true\"";
+  }
+
   of << indent << " indexValues=\"";
+  bool firstIndex = true;
   for (std::deque<IndexEntryType>::iterator indexIt = this->IndexEntries.begin(); indexIt != this->IndexEntries.end(); ++indexIt)
   {
-    if (indexIt != this->IndexEntries.begin())
+    if (indexIt->DataNode == nullptr && indexIt->CompactMatrixIndex >= 0)
+    {
+      // There is no data node for compact items, they are restored when the storage node reads the sequence
+      continue;
+    }
+    if (!firstIndex)
     {
       // not the first index, add a separator before adding values
       of << ";";
     }
+    firstIndex = false;
     if (indexIt->DataNode == nullptr)
     {
       // If we have a data node ID then store that, it is the most we know about the node that should be there
@@ -177,6 +209,10 @@ void vtkMRMLSequenceNode::ReadXMLAttributes(const char** atts)
       ss >> numericIndexValueTolerance;
       this->SetNumericIndexValueTolerance(numericIndexValueTolerance);
     }
+    else if (!strcmp(attName, "compactLinearTransformStorage"))
+    {
+      this->SetCompactLinearTransformStorage(!strcmp(attValue, "true"));
+    }
     else if (!strcmp(attName, "indexValues"))
     {
       ReadIndexValues(attValue);
@@ -194,6 +230,7 @@ void vtkMRMLSequenceNode::ReadIndexValues(const std::string& indexText)
     this->IndexEntries.clear();
     modified = true;
   }
+  this->InvalidateItemNumberByIndexValue();
 
   std::stringstream ss(indexText);
   std::string nodeId_indexValue;
@@ -205,8 +242,7 @@ void vtkMRMLSequenceNode::ReadIndexValues(const std::string& indexText)
       std::string nodeId = nodeId_indexValue.substr(0, indexValueSeparatorPos);
       std::string indexValue = nodeId_indexValue.substr(indexValueSeparatorPos + 1, nodeId_indexValue.size() - indexValueSeparatorPos - 1);
 
-      IndexEntryType indexEntry;
-      indexEntry.IndexValue = indexValue;
+      IndexEntryType indexEntry(indexValue);
       // The nodes are not read yet, so we can only store the node ID and get the pointer to the node later (in UpdateScene())
       indexEntry.DataNodeID = nodeId;
       indexEntry.DataNode = nullptr;
@@ -240,6 +276,19 @@ void vtkMRMLSequenceNode::Copy(vtkMRMLNode* anode)
   this->SetIndexUnit(snode->GetIndexUnit());
   this->SetIndexType(snode->GetIndexType());
   this->SetNumericIndexValueTolerance(snode->GetNumericIndexValueTolerance());
+  this->SetCompactLinearTransformStorage(snode->GetCompactLinearTransformStorage());
+
+  // Data nodes that are loaded on demand are copied as placeholders. Their content is read
+  // from the same file as in the source node, using a copy of the source node's item storage node.
+  this->ItemStorageNode = nullptr;
+  if (snode->ItemStorageNode)
+  {
+    this->ItemStorageNode = vtkSmartPointer<vtkMRMLStorageNode>::Take(vtkMRMLStorageNode::SafeDownCast(snode->ItemStorageNode->CreateNodeInstance()));
+    if (this->ItemStorageNode)
+    {
+      this->ItemStorageNode->Copy(snode->ItemStorageNode);
+    }
+  }
 
   // Clear nodes: RemoveAllNodes is not a public method, so it's simpler to just delete and recreate the scene
   if (this->SequenceScene)
@@ -272,16 +321,36 @@ void vtkMRMLSequenceNode::Copy(vtkMRMLNode* anode)
   bool mapDataNodeIds = !sourceToTargetDataNodeID.empty();
 
   this->IndexEntries.clear();
+  this->InvalidateItemNumberByIndexValue();
+  this->CompactTransformMatrices = snode->CompactTransformMatrices;
   for (std::deque<IndexEntryType>::iterator sourceIndexIt = snode->IndexEntries.begin(); sourceIndexIt != snode->IndexEntries.end(); ++sourceIndexIt)
   {
-    IndexEntryType seqItem;
-    seqItem.IndexValue = sourceIndexIt->IndexValue;
+    IndexEntryType seqItem(sourceIndexIt->IndexValue);
     seqItem.DataNode = nullptr;
+    seqItem.CompactMatrixIndex = sourceIndexIt->CompactMatrixIndex;
+    if (sourceIndexIt->StorageFrameIndex >= 0 && this->ItemStorageNode
+        && !(snode->ItemStorageNode->IsSequenceItemLoaded(sourceIndexIt->DataNode)
+             && snode->ItemStorageNode->IsSequenceItemModifiedSince(sourceIndexIt->DataNode, sourceIndexIt->LoadedTime)))
+    {
+      // Content can be read from the file (data node content was not edited since it was loaded)
+      seqItem.StorageFrameIndex = sourceIndexIt->StorageFrameIndex;
+    }
+    if (seqItem.CompactMatrixIndex >= 0 && sourceIndexIt->DataNode == nullptr)
+    {
+      // compact item, there is no data node to copy
+      this->IndexEntries.push_back(seqItem);
+      continue;
+    }
     if (sourceIndexIt->DataNode != nullptr)
     {
       std::string targetDataNodeID = sourceToTargetDataNodeID[sourceIndexIt->DataNode->GetID()];
       seqItem.DataNode = this->SequenceScene->GetNodeByID(targetDataNodeID);
       seqItem.DataNodeID.clear();
+      if (seqItem.StorageFrameIndex >= 0)
+      {
+        // Content of the copied data node is the same as in the file
+        seqItem.LoadedTime = GetCurrentModifiedTime();
+      }
     }
     if (seqItem.DataNode == nullptr)
     {
@@ -313,10 +382,10 @@ void vtkMRMLSequenceNode::CopySequenceIndex(vtkMRMLNode* anode)
   if (this->IndexEntries.size() > 0 || snode->IndexEntries.size() > 0)
   {
     this->IndexEntries.clear();
+    this->InvalidateItemNumberByIndexValue();
     for (std::deque<IndexEntryType>::iterator sourceIndexIt = snode->IndexEntries.begin(); sourceIndexIt != snode->IndexEntries.end(); ++sourceIndexIt)
     {
-      IndexEntryType seqItem;
-      seqItem.IndexValue = sourceIndexIt->IndexValue;
+      IndexEntryType seqItem(sourceIndexIt->IndexValue);
       if (sourceIndexIt->DataNode != nullptr)
       {
         seqItem.DataNodeID = sourceIndexIt->DataNode->GetID();
@@ -344,6 +413,7 @@ void vtkMRMLSequenceNode::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "indexType: " << indexTypeString << "\n";
 
   os << indent << "numericIndexValueTolerance: " << this->NumericIndexValueTolerance << "\n";
+  os << indent << "compactLinearTransformStorage: " << (this->CompactLinearTransformStorage ? "true" : "false") << "\n";
 
   os << indent << "indexValues: ";
   if (this->IndexEntries.empty())
@@ -370,13 +440,27 @@ bool vtkMRMLSequenceNode::UpdateDataNodeAtValue(vtkMRMLNode* node, const std::st
     vtkErrorMacro("vtkMRMLSequenceNode::UpdateDataNodeAtValue failed, invalid node");
     return false;
   }
-  vtkMRMLNode* nodeToBeUpdated = this->GetDataNodeAtValue(indexValue);
+  int seqItemIndex = this->GetItemNumberFromIndexValue(indexValue);
+  vtkMRMLLinearTransformNode* transformNode = vtkMRMLLinearTransformNode::SafeDownCast(node);
+  if (seqItemIndex >= 0 && transformNode && this->IndexEntries[seqItemIndex].DataNode == nullptr && this->IndexEntries[seqItemIndex].CompactMatrixIndex >= 0)
+  {
+    // Update compact item without creating a data node
+    vtkNew<vtkMatrix4x4> matrixToParent;
+    transformNode->GetMatrixTransformToParent(matrixToParent);
+    std::copy(&matrixToParent->Element[0][0], &matrixToParent->Element[0][0] + 16, this->CompactTransformMatrices.begin() + this->IndexEntries[seqItemIndex].CompactMatrixIndex * 16);
+    this->Modified();
+    this->StorableModifiedTime.Modified();
+    return true;
+  }
+  vtkMRMLNode* nodeToBeUpdated = (seqItemIndex >= 0 ? this->GetNthDataNode(seqItemIndex) : nullptr);
   if (!nodeToBeUpdated)
   {
     vtkDebugMacro("vtkMRMLSequenceNode::UpdateDataNodeAtValue failed, indexValue not found");
     return false;
   }
   nodeToBeUpdated->CopyContent(node, !shallowCopy);
+  // Content is not the same as in the file anymore, it must be kept in memory
+  this->IndexEntries[seqItemIndex].StorageFrameIndex = -1;
   this->Modified();
   this->StorableModifiedTime.Modified();
   return true;
@@ -388,9 +472,14 @@ int vtkMRMLSequenceNode::GetInsertPosition(const std::string& indexValue)
   int insertPosition = this->IndexEntries.size();
   if (this->IndexType == vtkMRMLSequenceNode::NumericIndex && !this->IndexEntries.empty())
   {
-    int itemNumber = this->GetItemNumberFromIndexValue(indexValue, false);
     double numericIndexValue = atof(indexValue.c_str());
-    double foundNumericIndexValue = atof(this->IndexEntries[itemNumber].IndexValue.c_str());
+    if (numericIndexValue > this->IndexEntries.back().NumericIndexValue)
+    {
+      // Appending to the end (typical when recording), no need to search
+      return insertPosition;
+    }
+    int itemNumber = this->GetItemNumberFromIndexValue(indexValue, false);
+    double foundNumericIndexValue = this->IndexEntries[itemNumber].NumericIndexValue;
     if (numericIndexValue < foundNumericIndexValue) // Deals with case of index value being smaller than any in the sequence and numeric tolerances
     {
       insertPosition = itemNumber;
@@ -425,14 +514,12 @@ vtkMRMLNode* vtkMRMLSequenceNode::SetDataNodeAtValue(vtkMRMLNode* node, const st
   else
   {
     // The sequence item doesn't exist yet
-    seqItemIndex = GetInsertPosition(indexValue);
-    // Create new item
-    IndexEntryType seqItem;
-    seqItem.IndexValue = indexValue;
-    this->IndexEntries.insert(this->IndexEntries.begin() + seqItemIndex, seqItem);
+    seqItemIndex = this->InsertIndexEntry(indexValue);
   }
   this->IndexEntries[seqItemIndex].DataNode = newNode;
   this->IndexEntries[seqItemIndex].DataNodeID.clear();
+  this->IndexEntries[seqItemIndex].StorageFrameIndex = -1;
+  this->IndexEntries[seqItemIndex].CompactMatrixIndex = -1;
   // Save the sequence data node class name in a node attribute to allow easy access
   // (e.g., for filtering on the GUI). This attribute may be also saved to the sequence file
   // to inform the reader what MRML node class to instantiate when reading the file.
@@ -452,6 +539,119 @@ vtkMRMLNode* vtkMRMLSequenceNode::SetDataNodeAtValue(vtkMRMLNode* node, const st
   return newNode;
 }
 
+//----------------------------------------------------------------------------
+int vtkMRMLSequenceNode::InsertIndexEntry(const std::string& indexValue)
+{
+  int itemNumber = this->GetInsertPosition(indexValue);
+  IndexEntryType seqItem(indexValue);
+  if (itemNumber == static_cast<int>(this->IndexEntries.size()))
+  {
+    // Appending does not change item numbers of existing items
+    this->IndexEntries.push_back(seqItem);
+    if (this->ItemNumberByIndexValueValid)
+    {
+      this->ItemNumberByIndexValue.emplace(indexValue, itemNumber);
+    }
+  }
+  else
+  {
+    this->IndexEntries.insert(this->IndexEntries.begin() + itemNumber, seqItem);
+    this->InvalidateItemNumberByIndexValue();
+  }
+  return itemNumber;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLSequenceNode::SetMatrixTransformToParentAtValue(vtkMatrix4x4* matrixToParent, const std::string& indexValue)
+{
+  if (matrixToParent == nullptr)
+  {
+    vtkErrorMacro("vtkMRMLSequenceNode::SetMatrixTransformToParentAtValue failed, invalid matrix");
+    return false;
+  }
+  MRMLNodeModifyBlocker blocker(this);
+  int seqItemIndex = this->GetItemNumberFromIndexValue(indexValue);
+  if (seqItemIndex < 0)
+  {
+    seqItemIndex = this->InsertIndexEntry(indexValue);
+  }
+  IndexEntryType& indexEntry = this->IndexEntries[seqItemIndex];
+  if (indexEntry.DataNode)
+  {
+    // Replace the data node by the compact item
+    if (this->SequenceScene)
+    {
+      this->SequenceScene->RemoveNode(indexEntry.DataNode);
+    }
+    indexEntry.DataNode = nullptr;
+  }
+  indexEntry.DataNodeID.clear();
+  indexEntry.StorageFrameIndex = -1;
+  if (indexEntry.CompactMatrixIndex < 0)
+  {
+    indexEntry.CompactMatrixIndex = static_cast<int>(this->CompactTransformMatrices.size() / 16);
+    this->CompactTransformMatrices.resize(this->CompactTransformMatrices.size() + 16);
+  }
+  std::copy(&matrixToParent->Element[0][0], &matrixToParent->Element[0][0] + 16, this->CompactTransformMatrices.begin() + indexEntry.CompactMatrixIndex * 16);
+
+  if (this->GetNumberOfDataNodes() <= 1)
+  {
+    this->SetAttribute("DataNodeClassName", this->GetDataNodeClassName().c_str());
+  }
+
+  this->Modified();
+  this->StorableModifiedTime.Modified();
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLSequenceNode::GetNthMatrixTransformToParent(int itemNumber, vtkMatrix4x4* matrixToParent)
+{
+  if (itemNumber < 0 || itemNumber >= static_cast<int>(this->IndexEntries.size()) || !matrixToParent)
+  {
+    vtkErrorMacro("vtkMRMLSequenceNode::GetNthMatrixTransformToParent failed: invalid itemNumber " << itemNumber << " or matrix");
+    return false;
+  }
+  const IndexEntryType& indexEntry = this->IndexEntries[itemNumber];
+  if (indexEntry.DataNode == nullptr && indexEntry.CompactMatrixIndex >= 0)
+  {
+    matrixToParent->DeepCopy(&this->CompactTransformMatrices[indexEntry.CompactMatrixIndex * 16]);
+    return true;
+  }
+  vtkMRMLTransformNode* transformNode = vtkMRMLTransformNode::SafeDownCast(indexEntry.DataNode);
+  if (!transformNode || !transformNode->IsLinear())
+  {
+    return false;
+  }
+  return transformNode->GetMatrixTransformToParent(matrixToParent) != 0;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLSequenceNode::IsNthDataNodeCompact(int itemNumber)
+{
+  if (itemNumber < 0 || itemNumber >= static_cast<int>(this->IndexEntries.size()))
+  {
+    vtkErrorMacro("vtkMRMLSequenceNode::IsNthDataNodeCompact failed: itemNumber " << itemNumber << " is out of range");
+    return false;
+  }
+  return this->IndexEntries[itemNumber].CompactMatrixIndex >= 0;
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLNode* vtkMRMLSequenceNode::CreateCompactDataNode(int itemNumber)
+{
+  IndexEntryType& indexEntry = this->IndexEntries[itemNumber];
+  vtkNew<vtkMatrix4x4> matrixToParent;
+  matrixToParent->DeepCopy(&this->CompactTransformMatrices[indexEntry.CompactMatrixIndex * 16]);
+  vtkNew<vtkMRMLLinearTransformNode> transformNode;
+  transformNode->SetMatrixTransformToParent(matrixToParent);
+  transformNode->SetName(this->GetName() ? this->GetName() : "Data");
+  // Make sure the sequence scene is created
+  this->GetSequenceScene();
+  indexEntry.DataNode = this->DeepCopyNodeToScene(transformNode, this->SequenceScene);
+  return indexEntry.DataNode;
+}
+
 //----------------------------------------------------------------------------
 void vtkMRMLSequenceNode::RemoveDataNodeAtValue(const std::string& indexValue)
 {
@@ -461,17 +661,32 @@ void vtkMRMLSequenceNode::RemoveDataNodeAtValue(const std::string& indexValue)
     vtkWarningMacro("vtkMRMLSequenceNode::RemoveDataNodeAtValue: node was not found at index value " << indexValue);
     return;
   }
-  if (!this->SequenceScene)
+  if (!this->SequenceScene && this->IndexEntries[seqItemIndex].CompactMatrixIndex < 0)
   {
     vtkWarningMacro("vtkMRMLSequenceNode::RemoveDataNodeAtValue: internal scene is already empty");
     return;
   }
   // TODO: remove associated nodes as well (such as storage node)?
+  // Matrix of a compact item is not reused, it is released when all items are removed.
   vtkMRMLNode* dataNode = this->IndexEntries[seqItemIndex].DataNode;
   if (dataNode)
   {
     this->SequenceScene->RemoveNode(dataNode);
   }
+  if (seqItemIndex == static_cast<int>(this->IndexEntries.size()) - 1 && this->ItemNumberByIndexValueValid)
+  {
+    // Removing the last item does not change item numbers of other items.
+    // The entry is only removed if it refers to this item, as an earlier item may have the same index value.
+    std::unordered_map<std::string, int>::iterator itemNumberIt = this->ItemNumberByIndexValue.find(this->IndexEntries.back().IndexValue);
+    if (itemNumberIt != this->ItemNumberByIndexValue.end() && itemNumberIt->second == seqItemIndex)
+    {
+      this->ItemNumberByIndexValue.erase(itemNumberIt);
+    }
+  }
+  else
+  {
+    this->InvalidateItemNumberByIndexValue();
+  }
   this->IndexEntries.erase(this->IndexEntries.begin() + seqItemIndex);
   this->Modified();
   this->StorableModifiedTime.Modified();
@@ -494,8 +709,8 @@ int vtkMRMLSequenceNode::GetItemNumberFromIndexValue(const std::string& indexVal
 
     // Deal with index values not within the range of index values in the Sequence
     double numericIndexValue = atof(indexValue.c_str());
-    double lowerNumericIndexValue = atof(this->IndexEntries[lowerBound].IndexValue.c_str());
-    double upperNumericIndexValue = atof(this->IndexEntries[upperBound].IndexValue.c_str());
+    double lowerNumericIndexValue = this->IndexEntries[lowerBound].NumericIndexValue;
+    double upperNumericIndexValue = this->IndexEntries[upperBound].NumericIndexValue;
     if (numericIndexValue <= lowerNumericIndexValue + this->NumericIndexValueTolerance)
     {
       if (numericIndexValue < lowerNumericIndexValue - this->NumericIndexValueTolerance && exactMatchRequired)
@@ -523,7 +738,7 @@ int vtkMRMLSequenceNode::GetItemNumberFromIndexValue(const std::string& indexVal
     {
       // Note that if middle is equal to either lowerBound or upperBound then upperBound - lowerBound <= 1
       int middle = int((lowerBound + upperBound) / 2);
-      double middleNumericIndexValue = atof(this->IndexEntries[middle].IndexValue.c_str());
+      double middleNumericIndexValue = this->IndexEntries[middle].NumericIndexValue;
       if (fabs(numericIndexValue - middleNumericIndexValue) <= this->NumericIndexValueTolerance)
       {
         return middle;
@@ -543,16 +758,39 @@ int vtkMRMLSequenceNode::GetItemNumberFromIndexValue(const std::string& indexVal
     }
   }
 
-  // Need linear search for non-numeric index
+  // Look up non-numeric index
+  this->UpdateItemNumberByIndexValue();
+  std::unordered_map<std::string, int>::iterator itemNumberIt = this->ItemNumberByIndexValue.find(indexValue);
+  if (itemNumberIt == this->ItemNumberByIndexValue.end())
+  {
+    return -1;
+  }
+  return itemNumberIt->second;
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLSequenceNode::UpdateItemNumberByIndexValue()
+{
+  if (this->ItemNumberByIndexValueValid)
+  {
+    return;
+  }
+  this->ItemNumberByIndexValue.clear();
+  this->ItemNumberByIndexValue.reserve(this->IndexEntries.size());
+  int numberOfSeqItems = this->IndexEntries.size();
   for (int i = 0; i < numberOfSeqItems; i++)
   {
-    if (this->IndexEntries[i].IndexValue.compare(indexValue) == 0)
-    {
-      return i;
-    }
+    // If an index value occurs multiple times then the first item is found (emplace does not overwrite)
+    this->ItemNumberByIndexValue.emplace(this->IndexEntries[i].IndexValue, i);
   }
+  this->ItemNumberByIndexValueValid = true;
+}
 
-  return -1;
+//---------------------------------------------------------------------------
+void vtkMRMLSequenceNode::InvalidateItemNumberByIndexValue()
+{
+  this->ItemNumberByIndexValue.clear();
+  this->ItemNumberByIndexValueValid = false;
 }
 
 //---------------------------------------------------------------------------
@@ -569,7 +807,7 @@ vtkMRMLNode* vtkMRMLSequenceNode::GetDataNodeAtValue(const std::string& indexVal
     // not found
     return nullptr;
   }
-  return this->IndexEntries[seqItemIndex].DataNode;
+  return this->GetNthDataNode(seqItemIndex);
 }
 
 //---------------------------------------------------------------------------
@@ -610,6 +848,8 @@ bool vtkMRMLSequenceNode::UpdateIndexValue(const std::string& oldIndexValue, con
   }
   // Update the index value
   this->IndexEntries[oldSeqItemIndex].IndexValue = newIndexValue;
+  this->IndexEntries[oldSeqItemIndex].NumericIndexValue = atof(newIndexValue.c_str());
+  this->InvalidateItemNumberByIndexValue();
   if (this->IndexType == vtkMRMLSequenceNode::NumericIndex)
   {
     IndexEntryType movingEntry = this->IndexEntries[oldSeqItemIndex];
@@ -631,6 +871,10 @@ std::string vtkMRMLSequenceNode::GetDataNodeClassName()
   {
     return "";
   }
+  if (this->IndexEntries[0].DataNode == nullptr && this->IndexEntries[0].CompactMatrixIndex >= 0)
+  {
+    return "vtkMRMLLinearTransformNode";
+  }
   // All the nodes should be of the same class, so just get the class from the first one
   vtkMRMLNode* node = this->IndexEntries[0].DataNode;
   if (node == nullptr)
@@ -650,6 +894,10 @@ std::string vtkMRMLSequenceNode::GetDataNodeTagName()
   {
     return undefinedReturn;
   }
+  if (this->IndexEntries[0].DataNode == nullptr && this->IndexEntries[0].CompactMatrixIndex >= 0)
+  {
+    return "LinearTransform";
+  }
   // All the nodes should be of the same class, so just get the class from the first one
   vtkMRMLNode* node = this->IndexEntries[0].DataNode;
   if (node == nullptr)
@@ -673,9 +921,208 @@ vtkMRMLNode* vtkMRMLSequenceNode::GetNthDataNode(int itemNumber)
     vtkErrorMacro("vtkMRMLSequenceNode::GetNthDataNode failed: itemNumber " << itemNumber << " is out of range");
     return nullptr;
   }
+  if (this->IndexEntries[itemNumber].DataNode == nullptr && this->IndexEntries[itemNumber].CompactMatrixIndex >= 0)
+  {
+    return this->CreateCompactDataNode(itemNumber);
+  }
   return this->IndexEntries[itemNumber].DataNode;
 }
 
+//-----------------------------------------------------------------------------
+void vtkMRMLSequenceNode::SetNthDataNodeStorageFrameIndex(int itemNumber, int frameIndex)
+{
+  if (itemNumber < 0 || itemNumber >= static_cast<int>(this->IndexEntries.size()))
+  {
+    vtkErrorMacro("vtkMRMLSequenceNode::SetNthDataNodeStorageFrameIndex failed: itemNumber " << itemNumber << " is out of range");
+    return;
+  }
+  this->IndexEntries[itemNumber].StorageFrameIndex = frameIndex;
+  this->IndexEntries[itemNumber].LoadedTime = GetCurrentModifiedTime();
+}
+
+//-----------------------------------------------------------------------------
+void vtkMRMLSequenceNode::SetItemStorageNode(vtkMRMLStorageNode* storageNode)
+{
+  this->ItemStorageNode = storageNode;
+}
+
+//-----------------------------------------------------------------------------
+vtkMRMLStorageNode* vtkMRMLSequenceNode::GetItemStorageNode()
+{
+  return this->ItemStorageNode;
+}
+
+//-----------------------------------------------------------------------------
+int vtkMRMLSequenceNode::GetNthDataNodeStorageFrameIndex(int itemNumber)
+{
+  if (itemNumber < 0 || itemNumber >= static_cast<int>(this->IndexEntries.size()))
+  {
+    vtkErrorMacro("vtkMRMLSequenceNode::GetNthDataNodeStorageFrameIndex failed: itemNumber " << itemNumber << " is out of range");
+    return -1;
+  }
+  return this->IndexEntries[itemNumber].StorageFrameIndex;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkMRMLSequenceNode::IsNthDataNodeLoaded(int itemNumber)
+{
+  if (itemNumber < 0 || itemNumber >= static_cast<int>(this->IndexEntries.size()))
+  {
+    vtkErrorMacro("vtkMRMLSequenceNode::IsNthDataNodeLoaded failed: itemNumber " << itemNumber << " is out of range");
+    return false;
+  }
+  const IndexEntryType& indexEntry = this->IndexEntries[itemNumber];
+  if (indexEntry.CompactMatrixIndex >= 0)
+  {
+    // Data node of a compact item is only created when it is needed
+    return indexEntry.DataNode != nullptr;
+  }
+  if (indexEntry.StorageFrameIndex < 0)
+  {
+    return true;
+  }
+  if (!this->ItemStorageNode)
+  {
+    // Content cannot be loaded
+    return false;
+  }
+  return this->ItemStorageNode->IsSequenceItemLoaded(indexEntry.DataNode);
+}
+
+//-----------------------------------------------------------------------------
+bool vtkMRMLSequenceNode::LoadNthDataNode(int itemNumber)
+{
+  if (itemNumber < 0 || itemNumber >= static_cast<int>(this->IndexEntries.size()))
+  {
+    vtkErrorMacro("vtkMRMLSequenceNode::LoadNthDataNode failed: itemNumber " << itemNumber << " is out of range");
+    return false;
+  }
+  if (this->IsNthDataNodeLoaded(itemNumber))
+  {
+    return true;
+  }
+  if (this->IndexEntries[itemNumber].CompactMatrixIndex >= 0)
+  {
+    return this->CreateCompactDataNode(itemNumber) != nullptr;
+  }
+  if (!this->ItemStorageNode)
+  {
+    vtkErrorMacro("vtkMRMLSequenceNode::LoadNthDataNode failed: storage node is not available to load itemNumber " << itemNumber);
+    return false;
+  }
+  // Loading content that is already stored in the file does not make the sequence modified since read
+  IndexEntryType& indexEntry = this->IndexEntries[itemNumber];
+  if (!this->ItemStorageNode->ReadSequenceItem(indexEntry.DataNode, indexEntry.StorageFrameIndex))
+  {
+    return false;
+  }
+  indexEntry.LoadedTime = GetCurrentModifiedTime();
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkMRMLSequenceNode::UnloadNthDataNode(int itemNumber)
+{
+  if (itemNumber < 0 || itemNumber >= static_cast<int>(this->IndexEntries.size()))
+  {
+    vtkErrorMacro("vtkMRMLSequenceNode::UnloadNthDataNode failed: itemNumber " << itemNumber << " is out of range");
+    return false;
+  }
+  IndexEntryType& indexEntry = this->IndexEntries[itemNumber];
+  if (indexEntry.CompactMatrixIndex >= 0)
+  {
+    if (!indexEntry.DataNode)
+    {
+      return false;
+    }
+    // Store the current content of the data node in the compact item and release the data node
+    vtkMRMLTransformNode* transformNode = vtkMRMLTransformNode::SafeDownCast(indexEntry.DataNode);
+    vtkNew<vtkMatrix4x4> matrixToParent;
+    if (!transformNode || !transformNode->IsLinear() || !transformNode->GetMatrixTransformToParent(matrixToParent))
+    {
+      // Content cannot be stored in compact form anymore, keep the data node
+      indexEntry.CompactMatrixIndex = -1;
+      return false;
+    }
+    std::copy(&matrixToParent->Element[0][0], &matrixToParent->Element[0][0] + 16, this->CompactTransformMatrices.begin() + indexEntry.CompactMatrixIndex * 16);
+    if (this->SequenceScene)
+    {
+      // Storage nodes may have been added for writing the data node, they are not needed anymore
+      for (int storageNodeIndex = transformNode->GetNumberOfStorageNodes() - 1; storageNodeIndex >= 0; --storageNodeIndex)
+      {
+        vtkMRMLStorageNode* storageNode = transformNode->GetNthStorageNode(storageNodeIndex);
+        if (storageNode)
+        {
+          this->SequenceScene->RemoveNode(storageNode);
+        }
+      }
+      this->SequenceScene->RemoveNode(indexEntry.DataNode);
+    }
+    indexEntry.DataNode = nullptr;
+    return true;
+  }
+  if (indexEntry.StorageFrameIndex < 0 || !this->ItemStorageNode)
+  {
+    // Data node content is not available from the storage node
+    return false;
+  }
+  if (!this->ItemStorageNode->IsSequenceItemLoaded(indexEntry.DataNode))
+  {
+    return false;
+  }
+  if (this->ItemStorageNode->IsSequenceItemModifiedSince(indexEntry.DataNode, indexEntry.LoadedTime))
+  {
+    // Content was edited in place, it is different from the file now. Keep it in memory
+    // and indicate that the sequence has to be saved.
+    indexEntry.StorageFrameIndex = -1;
+    this->StorableModifiedTime.Modified();
+    return false;
+  }
+  if (!this->ItemStorageNode->UnloadSequenceItem(indexEntry.DataNode))
+  {
+    return false;
+  }
+  indexEntry.LoadedTime = GetCurrentModifiedTime();
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkMRMLSequenceNode::LoadAllDataNodes()
+{
+  bool success = true;
+  for (int itemNumber = 0; itemNumber < static_cast<int>(this->IndexEntries.size()); ++itemNumber)
+  {
+    if (!this->LoadNthDataNode(itemNumber))
+    {
+      success = false;
+    }
+  }
+  return success;
+}
+
+//-----------------------------------------------------------------------------
+void vtkMRMLSequenceNode::PrefetchDataNodes(const std::vector<int>& itemNumbers)
+{
+  if (!this->ItemStorageNode)
+  {
+    // Data nodes are not loaded on demand
+    return;
+  }
+  std::vector<int> frameIndices;
+  for (int itemNumber : itemNumbers)
+  {
+    if (itemNumber < 0 || itemNumber >= static_cast<int>(this->IndexEntries.size()))
+    {
+      continue;
+    }
+    if (this->IndexEntries[itemNumber].StorageFrameIndex >= 0 && !this->IsNthDataNodeLoaded(itemNumber))
+    {
+      frameIndices.push_back(this->IndexEntries[itemNumber].StorageFrameIndex);
+    }
+  }
+  this->ItemStorageNode->PrefetchSequenceItems(frameIndices);
+}
+
 //-----------------------------------------------------------------------------
 vtkMRMLScene* vtkMRMLSequenceNode::GetSequenceScene(bool autoCreate /*=true*/)
 {
@@ -703,7 +1150,8 @@ vtkMRMLStorageNode* vtkMRMLSequenceNode::CreateDefaultStorageNode()
 std::string vtkMRMLSequenceNode::GetDefaultStorageNodeClassName(const char* filename /* =nullptr */)
 {
   // No need to create storage node if there are no nodes to store
-  if (this->GetSequenceScene() == nullptr || this->GetSequenceScene()->GetNumberOfNodes() == 0)
+  bool hasCompactItems = !this->CompactTransformMatrices.empty() && !this->IndexEntries.empty();
+  if (!hasCompactItems && (this->GetSequenceScene() == nullptr || this->GetSequenceScene()->GetNumberOfNodes() == 0))
   {
     return "";
   }
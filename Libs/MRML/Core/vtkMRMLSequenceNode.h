@@ -21,10 +21,17 @@
 // MRML includes
 #include <vtkMRML.h>
 #include <vtkMRMLStorableNode.h>
+class vtkMRMLStorageNode;
+
+// VTK includes
+#include <vtkSmartPointer.h>
+class vtkMatrix4x4;
 
 // std includes
 #include <deque>
 #include <set>
+#include <unordered_map>
+#include <vector>
 
 /// \brief MRML node for representing a sequence of MRML nodes
 ///
@@ -96,6 +103,17 @@ public:
   /// Set tolerance value for comparing numeric index values.
   void SetNumericIndexValueTolerance(double tolerance);
 
+  /// Store linear transforms in compact form.
+  /// If enabled, recorded or loaded linear transforms are stored as matrices in a contiguous array
+  /// instead of as transform nodes in the sequence scene, which reduces memory usage and saving time
+  /// of long recordings (such as tracked tools) by orders of magnitude.
+  /// A transform node is only created when the data node of a compact item is accessed,
+  /// and it can be released by UnloadNthDataNode.
+  /// Disabled by default.
+  vtkGetMacro(CompactLinearTransformStorage, bool);
+  vtkSetMacro(CompactLinearTransformStorage, bool);
+  vtkBooleanMacro(CompactLinearTransformStorage, bool);
+
   /// Helper functions for converting between string and code representation of the index type
   static std::string GetIndexTypeAsString(int indexType);
   static int GetIndexTypeFromString(const std::string& indexTypeString);
@@ -110,6 +128,19 @@ public:
   /// Return true if a data node was found by that index.
   bool UpdateDataNodeAtValue(vtkMRMLNode* node, const std::string& indexValue, bool shallowCopy = false);
 
+  /// Add a linear transform to the sequence as a compact item (the matrix is stored without creating a data node).
+  /// If a sequence item is not found by that index, a new item is added.
+  /// Returns true on success.
+  bool SetMatrixTransformToParentAtValue(vtkMatrix4x4* matrixToParent, const std::string& indexValue);
+
+  /// Get the matrix of the n-th item if it is a linear transform, without creating a data node for compact items.
+  /// Returns false if the item is not a linear transform.
+  bool GetNthMatrixTransformToParent(int itemNumber, vtkMatrix4x4* matrixToParent);
+
+  /// Return true if the n-th item is a linear transform that is stored in compact form.
+  /// See CompactLinearTransformStorage.
+  bool IsNthDataNodeCompact(int itemNumber);
+
   /// Remove data node corresponding to the specified index
   void RemoveDataNodeAtValue(const std::string& indexValue);
 
@@ -136,6 +167,48 @@ public:
   /// Return the number of nodes stored in this sequence.
   int GetNumberOfDataNodes();
 
+  /// Index of the frame in the storage node's file that the n-th data node can be loaded from.
+  /// Set by storage nodes that load data nodes on demand (see vtkMRMLVolumeSequenceStorageNode::LoadFramesOnDemand).
+  /// -1 means that the data node content is always kept in memory.
+  /// The current content of the data node is considered to be the same as in the file.
+  void SetNthDataNodeStorageFrameIndex(int itemNumber, int frameIndex);
+  int GetNthDataNodeStorageFrameIndex(int itemNumber);
+
+  /// Storage node that reads the content of data nodes that are loaded on demand.
+  /// Set by the storage node that added the data nodes. Copies of this sequence node
+  /// use a copy of the storage node, which reads from the same file.
+  /// \sa vtkMRMLStorageNode::ReadSequenceItem()
+  void SetItemStorageNode(vtkMRMLStorageNode* storageNode);
+  vtkMRMLStorageNode* GetItemStorageNode();
+
+  /// Return true if the n-th data node content is in memory.
+  /// Data nodes that are loaded on demand are added to the sequence as placeholders
+  /// (for example, volume nodes without image data) and must be loaded before they are used.
+  /// For compact items it returns true if the data node is created.
+  bool IsNthDataNodeLoaded(int itemNumber);
+
+  /// Read the content of the n-th data node from the storage node, if it is not loaded yet.
+  /// For compact items the data node is created.
+  /// Returns true if the data node content is available.
+  bool LoadNthDataNode(int itemNumber);
+
+  /// Release the content of the n-th data node from memory.
+  /// Only data nodes that can be loaded again from the storage node are unloaded.
+  /// Data nodes that have been modified since they were loaded are kept in memory
+  /// and they are not loaded on demand anymore (their storage frame index is set to -1).
+  /// For compact items the data node is removed from the sequence scene (its matrix is kept).
+  /// Returns true if the data node was unloaded.
+  bool UnloadNthDataNode(int itemNumber);
+
+  /// Load content of all data nodes. Returns true if all data nodes are loaded.
+  bool LoadAllDataNodes();
+
+  /// Start loading content of the specified data nodes in the background, so that
+  /// LoadNthDataNode can complete without waiting for the file to be read.
+  /// Data nodes that were requested to be prefetched earlier but not in this list are released.
+  /// Only data nodes that are loaded on demand are prefetched.
+  void PrefetchDataNodes(const std::vector<int>& itemNumbers);
+
   /// Return the class name of the data nodes (e.g., vtkMRMLTransformNode). If there are no data nodes yet then it returns empty string.
   std::string GetDataNodeClassName();
 
@@ -182,11 +255,34 @@ protected:
 
   vtkMRMLNode* DeepCopyNodeToScene(vtkMRMLNode* source, vtkMRMLScene* scene);
 
+  /// Insert a new item with the specified index value and return its item number.
+  /// Does not check if an item already exists with the same index value.
+  int InsertIndexEntry(const std::string& indexValue);
+
+  /// Create a transform node in the sequence scene from the matrix of a compact item
+  vtkMRMLNode* CreateCompactDataNode(int itemNumber);
+
+  /// Make item number lookup by index value available (rebuild it if items were inserted or removed)
+  void UpdateItemNumberByIndexValue();
+
+  /// Indicate that item numbers have changed and the lookup table has to be rebuilt
+  void InvalidateItemNumberByIndexValue();
+
   struct IndexEntryType
   {
+    IndexEntryType() = default;
+    IndexEntryType(const std::string& indexValue)
+      : IndexValue(indexValue)
+      , NumericIndexValue(atof(indexValue.c_str()))
+    {
+    }
     std::string IndexValue;
+    double NumericIndexValue{ 0.0 }; // cached numeric value of IndexValue, used for searching in numeric index
     vtkWeakPointer<vtkMRMLNode> DataNode;
     std::string DataNodeID; // only used temporarily, during scene load
+    int StorageFrameIndex{ -1 }; // frame index in the storage node's file, if data node is loaded on demand
+    vtkMTimeType LoadedTime{ 0 }; // time when content of a data node that is loaded on demand was the same as in the file
+    int CompactMatrixIndex{ -1 }; // matrix index in CompactTransformMatrices, if item is stored in compact form
   };
 
 protected:
@@ -202,6 +298,21 @@ protected:
 
   /// List of data items (the scene may contain some more nodes, such as storage nodes)
   std::deque<IndexEntryType> IndexEntries;
+
+  /// Item number for each index value, for finding items without a linear search.
+  /// Appending items keeps it up-to-date, other changes invalidate it and it is rebuilt on next lookup.
+  std::unordered_map<std::string, int> ItemNumberByIndexValue;
+  bool ItemNumberByIndexValueValid{ true };
+
+  bool CompactLinearTransformStorage{ false };
+
+  /// Reads content of data nodes that are loaded on demand
+  vtkSmartPointer<vtkMRMLStorageNode> ItemStorageNode;
+
+  /// Matrices of items stored in compact form, 16 values (row-major 4x4 matrix) per item.
+  /// If a data node is created for a compact item then the data node content is used
+  /// until the data node is released.
+  std::vector<double> CompactTransformMatrices;
 };
 
 #endif
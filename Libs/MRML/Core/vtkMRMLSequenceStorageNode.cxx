@@ -156,6 +156,28 @@ int vtkMRMLSequenceStorageNode::WriteDataInternal(vtkMRMLNode* refNode)
   bool success = false;
   if (extension == ".mrb")
   {
+    // Data nodes of items that are stored in compact form or loaded on demand may not be in the
+    // sequence scene. Load them temporarily so that they are written to the bundle.
+    std::vector<int> temporarilyLoadedItemNumbers;
+    for (int itemNumber = 0; itemNumber < sequenceNode->GetNumberOfDataNodes(); ++itemNumber)
+    {
+      if (sequenceNode->IsNthDataNodeLoaded(itemNumber))
+      {
+        continue;
+      }
+      if (!sequenceNode->LoadNthDataNode(itemNumber))
+      {
+        vtkErrorToMessageCollectionMacro(
+          this->GetUserMessages(), "vtkMRMLSequenceStorageNode::WriteDataInternal", "Writing sequence node failed: cannot load data node of item " << itemNumber);
+        for (int loadedItemNumber : temporarilyLoadedItemNumbers)
+        {
+          sequenceNode->UnloadNthDataNode(loadedItemNumber);
+        }
+        return 0;
+      }
+      temporarilyLoadedItemNumbers.push_back(itemNumber);
+    }
+
     this->ForceUniqueDataNodeFileNames(sequenceNode); // Prevents storable nodes' files from being overwritten due to the same node name
     vtkMRMLScene* sequenceScene = sequenceNode->GetSequenceScene();
 
@@ -174,6 +196,11 @@ int vtkMRMLSequenceStorageNode::WriteDataInternal(vtkMRMLNode* refNode)
     // would call Copy(). Copy may not work correctly or may log warnings/errors,
     // because embeddedSequenceNode is incomplete (does not contain any data nodes, only index values and node IDs).
     sequenceScene->RemoveNode(embeddedSequenceNode.GetPointer());
+
+    for (int itemNumber : temporarilyLoadedItemNumbers)
+    {
+      sequenceNode->UnloadNthDataNode(itemNumber);
+    }
   }
   else
   {
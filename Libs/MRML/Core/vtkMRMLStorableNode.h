@@ -154,6 +154,11 @@ public:
   /// \sa GetStoredTime() StorableModifiedTime Modified() GetModifiedSinceRead()
   virtual void StorableModified();
 
+  /// Get the last time when a storable property was modified.
+  /// Unlike GetMTime(), it is updated when bulk data (voxels, points, etc.) changes.
+  /// \sa StorableModifiedTime StorableModified()
+  vtkMTimeType GetStorableModifiedMTime() { return this->StorableModifiedTime.GetMTime(); }
+
 protected:
   vtkMRMLStorableNode();
   ~vtkMRMLStorableNode() override;
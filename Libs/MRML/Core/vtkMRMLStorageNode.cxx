@@ -1289,6 +1289,43 @@ int vtkMRMLStorageNode::WriteData(vtkMRMLNode* refNode)
   return success;
 }
 
+//------------------------------------------------------------------------------
+bool vtkMRMLStorageNode::PreloadData(vtkMRMLNode* vtkNotUsed(refNode))
+{
+  return false;
+}
+
+//------------------------------------------------------------------------------
+void vtkMRMLStorageNode::ReleasePreloadedData() {}
+
+//------------------------------------------------------------------------------
+bool vtkMRMLStorageNode::ReadSequenceItem(vtkMRMLNode* vtkNotUsed(dataNode), int vtkNotUsed(frameIndex))
+{
+  return false;
+}
+
+//------------------------------------------------------------------------------
+bool vtkMRMLStorageNode::IsSequenceItemLoaded(vtkMRMLNode* vtkNotUsed(dataNode))
+{
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool vtkMRMLStorageNode::IsSequenceItemModifiedSince(vtkMRMLNode* dataNode, vtkMTimeType time)
+{
+  vtkMRMLStorableNode* storableNode = vtkMRMLStorableNode::SafeDownCast(dataNode);
+  return (storableNode && storableNode->GetStorableModifiedMTime() > time);
+}
+
+//------------------------------------------------------------------------------
+bool vtkMRMLStorageNode::UnloadSequenceItem(vtkMRMLNode* vtkNotUsed(dataNode))
+{
+  return false;
+}
+
+//------------------------------------------------------------------------------
+void vtkMRMLStorageNode::PrefetchSequenceItems(const std::vector<int>& vtkNotUsed(frameIndices)) {}
+
 //------------------------------------------------------------------------------
 int vtkMRMLStorageNode::ReadDataInternal(vtkMRMLNode* vtkNotUsed(refNode))
 {
@@ -1343,6 +1380,47 @@ std::string vtkMRMLStorageNode::GetFileNameWithoutExtension(const char* filePath
 //------------------------------------------------------------------------------
 void vtkMRMLStorageNode::UpdateCompressionPresets() {}
 
+//------------------------------------------------------------------------------
+void vtkMRMLStorageNode::AddGzipCompressionPresets(bool multiThreaded)
+{
+  if (multiThreaded)
+  {
+    this->CompressionPresets.emplace_back(vtkMRMLStorageNode::GetCompressionParameterFastestMultiThreaded(), "Fastest (multi-threaded)");
+    this->CompressionPresets.emplace_back(vtkMRMLStorageNode::GetCompressionParameterNormalMultiThreaded(), "Normal (multi-threaded)");
+  }
+  this->CompressionPresets.emplace_back(vtkMRMLStorageNode::GetCompressionParameterFastest(), "Fastest");
+  this->CompressionPresets.emplace_back(vtkMRMLStorageNode::GetCompressionParameterNormal(), "Normal");
+  this->CompressionPresets.emplace_back(vtkMRMLStorageNode::GetCompressionParameterMinimumSize(), "Minimum size");
+
+  this->CompressionParameter = multiThreaded ? vtkMRMLStorageNode::GetCompressionParameterFastestMultiThreaded() : vtkMRMLStorageNode::GetCompressionParameterFastest();
+}
+
+//------------------------------------------------------------------------------
+int vtkMRMLStorageNode::GetGzipCompressionLevelFromCompressionParameter(const std::string& compressionParameter)
+{
+  if (compressionParameter == vtkMRMLStorageNode::GetCompressionParameterNormal() //
+      || compressionParameter == vtkMRMLStorageNode::GetCompressionParameterNormalMultiThreaded())
+  {
+    return 6;
+  }
+  else if (compressionParameter == vtkMRMLStorageNode::GetCompressionParameterMinimumSize())
+  {
+    return 9;
+  }
+  return 1;
+}
+
+//------------------------------------------------------------------------------
+int vtkMRMLStorageNode::GetGzipCompressionNumberOfThreadsFromCompressionParameter(const std::string& compressionParameter)
+{
+  if (compressionParameter == vtkMRMLStorageNode::GetCompressionParameterFastestMultiThreaded() //
+      || compressionParameter == vtkMRMLStorageNode::GetCompressionParameterNormalMultiThreaded())
+  {
+    return 0;
+  }
+  return 1;
+}
+
 //------------------------------------------------------------------------------
 int vtkMRMLStorageNode::GetNumberOfCompressionPresets()
 {
@@ -59,6 +59,54 @@ public:
   /// \sa SetFileName(), ReadDataInternal(), GetStoredTime()
   virtual int ReadData(vtkMRMLNode* refNode, bool temporaryFile = false);
 
+  ///
+  /// Read the data file into memory, without modifying \a refNode or any other MRML node.
+  /// The preloaded data is kept in the storage node and the next ReadData() call
+  /// for the same \a refNode uses it instead of reading the file again.
+  /// This method may be called from a background thread (to read multiple files in parallel),
+  /// as long as the scene and the nodes are not modified meanwhile.
+  /// Returns true if data was preloaded. Default implementation does not support
+  /// preloading and returns false.
+  /// \sa ReleasePreloadedData(), vtkMRMLScene::SetParallelDataLoading()
+  virtual bool PreloadData(vtkMRMLNode* refNode);
+
+  ///
+  /// Release data read by PreloadData() that has not been used by ReadData().
+  virtual void ReleasePreloadedData();
+
+  ///
+  /// Read the content of a sequence data node that is loaded on demand.
+  /// Storage nodes that load sequence items on demand add placeholder data nodes
+  /// to the sequence and record where each item is in the file
+  /// (see vtkMRMLSequenceNode::SetNthDataNodeStorageFrameIndex()).
+  /// Returns true on success. Default implementation does not support loading on demand
+  /// and returns false.
+  /// \sa IsSequenceItemLoaded(), UnloadSequenceItem(), vtkMRMLSequenceNode::LoadNthDataNode()
+  virtual bool ReadSequenceItem(vtkMRMLNode* dataNode, int frameIndex);
+
+  ///
+  /// Return true if the content of a sequence data node that is loaded on demand is in memory.
+  /// Default implementation returns true.
+  virtual bool IsSequenceItemLoaded(vtkMRMLNode* dataNode);
+
+  ///
+  /// Return true if the content of a sequence data node has been modified after \a time.
+  /// Used for keeping items in memory that were edited after they were loaded.
+  /// Default implementation checks the storable modified time of the node.
+  virtual bool IsSequenceItemModifiedSince(vtkMRMLNode* dataNode, vtkMTimeType time);
+
+  ///
+  /// Release the content of a sequence data node from memory, it can be read again by ReadSequenceItem().
+  /// Returns true if the content was released. Default implementation returns false.
+  virtual bool UnloadSequenceItem(vtkMRMLNode* dataNode);
+
+  ///
+  /// Start reading the specified sequence items in the background, so that
+  /// ReadSequenceItem() does not have to wait for the file to be read.
+  /// Items that were requested earlier but not in this list are released.
+  /// Default implementation does nothing.
+  virtual void PrefetchSequenceItems(const std::vector<int>& frameIndices);
+
   ///
   /// Write data from a  referenced node
   /// Return 1 on success, 0 on failure.
@@ -353,6 +401,23 @@ public:
   /// Get a list of all supported compression presets
   virtual const std::vector<CompressionPreset> GetCompressionPresets();
 
+  /// Compression parameters of the presets added by AddGzipCompressionPresets.
+  /// Fastest, Normal, and MinimumSize correspond to minimum, default, and maximum zlib
+  /// compression level. MultiThreaded presets compress blocks of the data in parallel.
+  static std::string GetCompressionParameterFastest() { return "gzip_fastest"; };
+  static std::string GetCompressionParameterNormal() { return "gzip_normal"; };
+  static std::string GetCompressionParameterMinimumSize() { return "gzip_minimum_size"; };
+  static std::string GetCompressionParameterFastestMultiThreaded() { return "gzip_fastest_multithreaded"; };
+  static std::string GetCompressionParameterNormalMultiThreaded() { return "gzip_normal_multithreaded"; };
+
+  /// Get zlib compression level (1-9) of a preset added by AddGzipCompressionPresets.
+  /// Returns the fastest level for unknown presets.
+  static int GetGzipCompressionLevelFromCompressionParameter(const std::string& compressionParameter);
+
+  /// Get number of threads used for compression by a preset added by AddGzipCompressionPresets.
+  /// 0 means that all available threads are used.
+  static int GetGzipCompressionNumberOfThreadsFromCompressionParameter(const std::string& compressionParameter);
+
   /// Coordinate system options
   /// LPS coordinate system is used the most commonly in medical image computing.
   ///   Slicer is moving towards using this coordinate system in all files by default
@@ -465,6 +530,14 @@ protected:
   /// Subclasses can use this method to set presets based on storable node content.
   virtual void UpdateCompressionPresets();
 
+  ///
+  /// Add compression presets for file formats that store gzip-compressed data
+  /// and select the fastest preset.
+  /// If multiThreaded is true then presets that compress blocks of the data in parallel
+  /// are added, too, and the fastest multi-threaded preset is selected.
+  /// All presets produce standard gzip streams, which can be read by any reader of the file format.
+  void AddGzipCompressionPresets(bool multiThreaded);
+
   /// Time when data was last read or written.
   /// This is used by the storable node to know when it needs to save its data
   /// Can be reset with InvalidateFile.
@@ -15,6 +15,7 @@ Version:   $Revision: 1.14 $
 #include "vtkMRMLTransformNode.h"
 
 // MRML includes
+#include "vtkEventBroker.h"
 #include "vtkMRMLBSplineTransformNode.h"
 #include "vtkMRMLGridTransformNode.h"
 #include "vtkMRMLLinearTransformNode.h"
@@ -34,16 +35,568 @@ Version:   $Revision: 1.14 $
 #include <vtkImageData.h>
 #include <vtkLinearTransform.h>
 #include <vtkHomogeneousTransform.h>
+#include <vtkMath.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
 #include <vtkPoints.h>
+#include <vtkSMPThreadLocal.h>
+#include <vtkSMPTools.h>
+#include <vtkSmartPointer.h>
 #include <vtkThinPlateSplineTransform.h>
 #include <vtkTransform.h>
+#include <vtkWarpTransform.h>
 #include <vtksys/SystemTools.hxx>
 
 // STD includes
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <future>
+#include <memory>
 #include <sstream>
 #include <stack>
+#include <utility>
+#include <vector>
+
+//----------------------------------------------------------------------------
+class vtkMRMLTransformNode::vtkTransformToWorldCache
+{
+public:
+  /// Transform nodes from this node to the root of the transform tree
+  /// and the evaluated transforms of each node at the time the cache was updated.
+  /// Transform from parent is only stored for non-linear transforms (inverse of linear
+  /// transforms is computed from the matrix).
+  struct ChainItem
+  {
+    vtkMRMLTransformNode* Node{ nullptr };
+    vtkAbstractTransform* TransformToParent{ nullptr };
+    vtkAbstractTransform* TransformFromParent{ nullptr };
+  };
+  std::vector<ChainItem> Chain;
+  /// Latest modification time of transforms in the chain
+  vtkMTimeType MTime{ 0 };
+  bool Valid{ false };
+  /// All transforms in the chain are linear
+  bool Linear{ true };
+
+  /// Each item contains either a matrix that is computed from consecutive linear
+  /// transforms or a non-linear transform and its inverse.
+  struct Segment
+  {
+    vtkSmartPointer<vtkMatrix4x4> Matrix;
+    vtkSmartPointer<vtkAbstractTransform> Transform;
+    vtkSmartPointer<vtkAbstractTransform> InverseTransform;
+  };
+  /// Segments of the transform to world, ordered from this node to the root
+  std::vector<Segment> Segments;
+};
+
+//----------------------------------------------------------------------------
+/// Grid transform that contains the sampled inverse of a warp transform.
+/// Grid transforms clamp the displacements outside the grid, therefore the exact inverse
+/// (the inverse of the approximated transform) is computed for points outside the grid instead.
+/// The inverse of this transform is the approximated transform.
+class vtkApproximateInverseGridTransform : public vtkOrientedGridTransform
+{
+public:
+  static vtkApproximateInverseGridTransform* New();
+  vtkTypeMacro(vtkApproximateInverseGridTransform, vtkOrientedGridTransform);
+
+  /// Warp transform that is approximated by the inverse of this transform.
+  /// It must not be modified after it is set.
+  void SetApproximatedTransform(vtkAbstractTransform* transform)
+  {
+    if (this->ApproximatedTransform == transform)
+    {
+      return;
+    }
+    this->ApproximatedTransform = transform;
+    this->Modified();
+  }
+  vtkAbstractTransform* GetApproximatedTransform() { return this->ApproximatedTransform; }
+
+  vtkAbstractTransform* MakeTransform() override { return vtkApproximateInverseGridTransform::New(); }
+
+protected:
+  vtkApproximateInverseGridTransform() = default;
+  ~vtkApproximateInverseGridTransform() override = default;
+
+  void InternalDeepCopy(vtkAbstractTransform* transform) override
+  {
+    this->Superclass::InternalDeepCopy(transform);
+    vtkApproximateInverseGridTransform* approximateInverseTransform = vtkApproximateInverseGridTransform::SafeDownCast(transform);
+    if (approximateInverseTransform)
+    {
+      this->SetApproximatedTransform(approximateInverseTransform->ApproximatedTransform);
+    }
+  }
+
+  void InternalUpdate() override
+  {
+    this->Superclass::InternalUpdate();
+    this->ExactInverse = nullptr;
+    vtkImageData* grid = this->GetDisplacementGrid();
+    if (this->ApproximatedTransform == nullptr || grid == nullptr)
+    {
+      return;
+    }
+    this->ApproximatedTransform->Update();
+    this->ExactInverse = this->ApproximatedTransform->GetInverse();
+    this->ExactInverse->Update();
+
+    // Mapping from physical to grid index coordinates, used for checking if a point is inside the grid
+    grid->GetOrigin(this->GridOrigin);
+    double spacing[3] = { 1.0, 1.0, 1.0 };
+    grid->GetSpacing(spacing);
+    int dimensions[3] = { 0, 0, 0 };
+    grid->GetDimensions(dimensions);
+    vtkMatrix4x4* direction = this->GetGridDirectionMatrix();
+    double indexToPhysical[3][3];
+    for (int row = 0; row < 3; ++row)
+    {
+      for (int column = 0; column < 3; ++column)
+      {
+        double directionElement = direction ? direction->GetElement(row, column) : (row == column ? 1.0 : 0.0);
+        indexToPhysical[row][column] = directionElement * spacing[column];
+      }
+      this->GridMaximumIndex[row] = dimensions[row] - 1;
+    }
+    vtkMath::Invert3x3(indexToPhysical, this->PhysicalToIndex);
+  }
+
+  bool IsInsideGrid(const double point[3])
+  {
+    const double tolerance = 1e-6;
+    double offset[3] = { 0.0, 0.0, 0.0 };
+    vtkMath::Subtract(point, this->GridOrigin, offset);
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      double index = vtkMath::Dot(this->PhysicalToIndex[axis], offset);
+      if (index < -tolerance || index > this->GridMaximumIndex[axis] + tolerance)
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void ForwardTransformPoint(const double in[3], double out[3]) override
+  {
+    if (this->ExactInverse == nullptr || this->IsInsideGrid(in))
+    {
+      this->Superclass::ForwardTransformPoint(in, out);
+      return;
+    }
+    this->ExactInverse->InternalTransformPoint(in, out);
+  }
+
+  void ForwardTransformPoint(const float in[3], float out[3]) override
+  {
+    double point[3] = { in[0], in[1], in[2] };
+    this->ForwardTransformPoint(point, point);
+    out[0] = static_cast<float>(point[0]);
+    out[1] = static_cast<float>(point[1]);
+    out[2] = static_cast<float>(point[2]);
+  }
+
+  void ForwardTransformDerivative(const double in[3], double out[3], double derivative[3][3]) override
+  {
+    if (this->ExactInverse == nullptr || this->IsInsideGrid(in))
+    {
+      this->Superclass::ForwardTransformDerivative(in, out, derivative);
+      return;
+    }
+    this->ExactInverse->InternalTransformDerivative(in, out, derivative);
+  }
+
+  void ForwardTransformDerivative(const float in[3], float out[3], float derivative[3][3]) override
+  {
+    double point[3] = { in[0], in[1], in[2] };
+    double doubleDerivative[3][3];
+    this->ForwardTransformDerivative(point, point, doubleDerivative);
+    for (int row = 0; row < 3; ++row)
+    {
+      out[row] = static_cast<float>(point[row]);
+      for (int column = 0; column < 3; ++column)
+      {
+        derivative[row][column] = static_cast<float>(doubleDerivative[row][column]);
+      }
+    }
+  }
+
+  void InverseTransformPoint(const double in[3], double out[3]) override
+  {
+    if (this->ExactInverse == nullptr)
+    {
+      this->Superclass::InverseTransformPoint(in, out);
+      return;
+    }
+    this->ApproximatedTransform->InternalTransformPoint(in, out);
+  }
+
+  void InverseTransformPoint(const float in[3], float out[3]) override
+  {
+    double point[3] = { in[0], in[1], in[2] };
+    this->InverseTransformPoint(point, point);
+    out[0] = static_cast<float>(point[0]);
+    out[1] = static_cast<float>(point[1]);
+    out[2] = static_cast<float>(point[2]);
+  }
+
+  void InverseTransformDerivative(const double in[3], double out[3], double derivative[3][3]) override
+  {
+    if (this->ExactInverse == nullptr)
+    {
+      this->Superclass::InverseTransformDerivative(in, out, derivative);
+      return;
+    }
+    this->ApproximatedTransform->InternalTransformDerivative(in, out, derivative);
+  }
+
+  void InverseTransformDerivative(const float in[3], float out[3], float derivative[3][3]) override
+  {
+    double point[3] = { in[0], in[1], in[2] };
+    double doubleDerivative[3][3];
+    this->InverseTransformDerivative(point, point, doubleDerivative);
+    for (int row = 0; row < 3; ++row)
+    {
+      out[row] = static_cast<float>(point[row]);
+      for (int column = 0; column < 3; ++column)
+      {
+        derivative[row][column] = static_cast<float>(doubleDerivative[row][column]);
+      }
+    }
+  }
+
+  vtkSmartPointer<vtkAbstractTransform> ApproximatedTransform;
+  /// Inverse of the approximated transform, set in InternalUpdate
+  vtkAbstractTransform* ExactInverse{ nullptr };
+  double GridOrigin[3]{ 0.0, 0.0, 0.0 };
+  double PhysicalToIndex[3][3]{ { 1.0, 0.0, 0.0 }, { 0.0, 1.0, 0.0 }, { 0.0, 0.0, 1.0 } };
+  int GridMaximumIndex[3]{ 0, 0, 0 };
+
+private:
+  vtkApproximateInverseGridTransform(const vtkApproximateInverseGridTransform&) = delete;
+  void operator=(const vtkApproximateInverseGridTransform&) = delete;
+};
+
+vtkStandardNewMacro(vtkApproximateInverseGridTransform);
+
+//----------------------------------------------------------------------------
+class vtkMRMLTransformNode::vtkApproximateInverse
+{
+public:
+  /// Identifies the approximated inverse. The approximation is up-to-date if its key is the same as the current key.
+  struct Key
+  {
+    /// Stored warp transform that is inverted
+    vtkAbstractTransform* StoredTransform{ nullptr };
+    vtkMTimeType StoredTransformMTime{ 0 };
+    /// The stored transform is the transform to parent (and transform from parent is approximated)
+    bool StoredTransformToParent{ false };
+    double GridOrigin[3]{ 0.0, 0.0, 0.0 };
+    double GridSpacing[3]{ 0.0, 0.0, 0.0 };
+    int GridDimensions[3]{ 0, 0, 0 };
+
+    bool operator==(const Key& other) const
+    {
+      return this->StoredTransform == other.StoredTransform && this->StoredTransformMTime == other.StoredTransformMTime
+             && this->StoredTransformToParent == other.StoredTransformToParent //
+             && std::equal(this->GridOrigin, this->GridOrigin + 3, other.GridOrigin) //
+             && std::equal(this->GridSpacing, this->GridSpacing + 3, other.GridSpacing) //
+             && std::equal(this->GridDimensions, this->GridDimensions + 3, other.GridDimensions);
+    }
+    bool operator!=(const Key& other) const { return !(*this == other); }
+  };
+
+  /// Geometry of the grid that the inverse is sampled on
+  struct GridGeometry
+  {
+    double Origin[3]{ 0.0, 0.0, 0.0 };
+    double Spacing[3]{ 1.0, 1.0, 1.0 };
+    int Dimensions[3]{ 0, 0, 0 };
+    vtkSmartPointer<vtkMatrix4x4> Direction;
+  };
+
+  struct Result
+  {
+    vtkSmartPointer<vtkApproximateInverseGridTransform> Transform;
+    double MaximumError{ -1.0 };
+  };
+
+  /// Latest retrieved computation result. Transform is nullptr if the inverse could not be computed.
+  Key ComputedKey;
+  Result Computed;
+  /// Computed transform that TransformModifiedEvent has been invoked for
+  vtkApproximateInverseGridTransform* NotifiedTransform{ nullptr };
+
+  /// Computation running in a background thread. Pending is ready when the result is available,
+  /// PendingTask is ready when the background thread does not use the completion notifier anymore.
+  Key PendingKey;
+  std::future<Result> Pending;
+  std::future<void> PendingTask;
+  std::shared_ptr<std::atomic<bool>> PendingCanceled;
+
+  /// Object that is modified on the main thread (using vtkEventBroker::RequestModified)
+  /// when a background computation is completed.
+  vtkObject* CompletionNotifier{ nullptr };
+
+  /// Get the key of the inverse that should be approximated in the node.
+  /// Returns false if the node does not store a warp transform that has to be inverted iteratively.
+  static bool GetKey(vtkMRMLTransformNode* node, Key& key)
+  {
+    vtkAbstractTransform* storedTransform = nullptr;
+    if (node->TransformToParent != nullptr && node->TransformFromParent == nullptr)
+    {
+      storedTransform = node->TransformToParent;
+      key.StoredTransformToParent = true;
+    }
+    else if (node->TransformFromParent != nullptr && node->TransformToParent == nullptr)
+    {
+      storedTransform = node->TransformFromParent;
+      key.StoredTransformToParent = false;
+    }
+    // Only the inverse of warp transforms is computed iteratively
+    vtkWarpTransform* storedWarpTransform = vtkWarpTransform::SafeDownCast(storedTransform);
+    if (storedWarpTransform == nullptr || storedWarpTransform->GetInverseFlag())
+    {
+      return false;
+    }
+    key.StoredTransform = storedTransform;
+    key.StoredTransformMTime = storedTransform->GetMTime();
+    std::copy(node->ApproximateInverseGridOrigin, node->ApproximateInverseGridOrigin + 3, key.GridOrigin);
+    std::copy(node->ApproximateInverseGridSpacing, node->ApproximateInverseGridSpacing + 3, key.GridSpacing);
+    std::copy(node->ApproximateInverseGridDimensions, node->ApproximateInverseGridDimensions + 3, key.GridDimensions);
+    return true;
+  }
+
+  /// Get the grid geometry specified in the key. If grid dimensions are not specified
+  /// then the geometry is determined from the stored transform.
+  static bool GetGridGeometry(const Key& key, GridGeometry& geometry)
+  {
+    geometry.Direction = vtkSmartPointer<vtkMatrix4x4>::New();
+    if (key.GridDimensions[0] > 0 && key.GridDimensions[1] > 0 && key.GridDimensions[2] > 0)
+    {
+      std::copy(key.GridOrigin, key.GridOrigin + 3, geometry.Origin);
+      std::copy(key.GridSpacing, key.GridSpacing + 3, geometry.Spacing);
+      std::copy(key.GridDimensions, key.GridDimensions + 3, geometry.Dimensions);
+      return true;
+    }
+
+    vtkImageData* grid = nullptr;
+    vtkMatrix4x4* gridDirection = nullptr;
+    int refinement = 1;
+    if (vtkGridTransform* gridTransform = vtkGridTransform::SafeDownCast(key.StoredTransform))
+    {
+      grid = gridTransform->GetDisplacementGrid();
+      vtkOrientedGridTransform* orientedGridTransform = vtkOrientedGridTransform::SafeDownCast(gridTransform);
+      gridDirection = orientedGridTransform ? orientedGridTransform->GetGridDirectionMatrix() : nullptr;
+    }
+    else if (vtkBSplineTransform* bsplineTransform = vtkBSplineTransform::SafeDownCast(key.StoredTransform))
+    {
+      // Displacements vary smoothly between B-spline control points, therefore
+      // a few samples between control points are sufficient for accurate interpolation.
+      grid = bsplineTransform->GetCoefficientData();
+      vtkOrientedBSplineTransform* orientedBSplineTransform = vtkOrientedBSplineTransform::SafeDownCast(bsplineTransform);
+      gridDirection = orientedBSplineTransform ? orientedBSplineTransform->GetGridDirectionMatrix() : nullptr;
+      refinement = 4;
+    }
+    if (grid == nullptr)
+    {
+      return false;
+    }
+    int gridDimensions[3] = { 0, 0, 0 };
+    grid->GetDimensions(gridDimensions);
+    if (gridDimensions[0] <= 0 || gridDimensions[1] <= 0 || gridDimensions[2] <= 0)
+    {
+      return false;
+    }
+    grid->GetOrigin(geometry.Origin);
+    grid->GetSpacing(geometry.Spacing);
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      geometry.Spacing[axis] /= refinement;
+      geometry.Dimensions[axis] = (gridDimensions[axis] - 1) * refinement + 1;
+    }
+    if (gridDirection)
+    {
+      geometry.Direction->DeepCopy(gridDirection);
+    }
+    return true;
+  }
+
+  /// Sample the inverse of the transform on the grid and estimate the error of the interpolated inverse.
+  /// This method is executed in a background thread, therefore the transform must not be used by other threads.
+  /// Returns an empty result if the computation is canceled.
+  static Result Compute(vtkSmartPointer<vtkAbstractTransform> storedTransform, const GridGeometry& geometry, std::shared_ptr<std::atomic<bool>> canceled)
+  {
+    Result result;
+    vtkAbstractTransform* exactInverse = storedTransform->GetInverse();
+    storedTransform->Update();
+    exactInverse->Update();
+
+    const int* dimensions = geometry.Dimensions;
+    double direction[3][3];
+    for (int row = 0; row < 3; ++row)
+    {
+      for (int column = 0; column < 3; ++column)
+      {
+        direction[row][column] = geometry.Direction->GetElement(row, column) * geometry.Spacing[column];
+      }
+    }
+    auto gridPointPosition = [&](double i, double j, double k, double position[3])
+    {
+      for (int row = 0; row < 3; ++row)
+      {
+        position[row] = geometry.Origin[row] + direction[row][0] * i + direction[row][1] * j + direction[row][2] * k;
+      }
+    };
+
+    // Sample the exact inverse at the grid points
+    vtkNew<vtkImageData> displacementGrid;
+    displacementGrid->SetOrigin(geometry.Origin);
+    displacementGrid->SetSpacing(geometry.Spacing);
+    displacementGrid->SetDimensions(geometry.Dimensions);
+    displacementGrid->AllocateScalars(VTK_DOUBLE, 3);
+    double* displacements = static_cast<double*>(displacementGrid->GetScalarPointer());
+    vtkSMPTools::For(0, dimensions[2],
+      [&](vtkIdType beginSlice, vtkIdType endSlice)
+      {
+        for (vtkIdType k = beginSlice; k < endSlice && !canceled->load(); ++k)
+        {
+          for (int j = 0; j < dimensions[1]; ++j)
+          {
+            double* displacement = displacements + 3 * ((k * dimensions[1] + j) * dimensions[0]);
+            for (int i = 0; i < dimensions[0]; ++i, displacement += 3)
+            {
+              double point[3] = { 0.0, 0.0, 0.0 };
+              double inversePoint[3] = { 0.0, 0.0, 0.0 };
+              gridPointPosition(i, j, static_cast<double>(k), point);
+              exactInverse->InternalTransformPoint(point, inversePoint);
+              vtkMath::Subtract(inversePoint, point, displacement);
+            }
+          }
+        }
+      });
+    if (canceled->load())
+    {
+      return Result();
+    }
+
+    vtkSmartPointer<vtkApproximateInverseGridTransform> approximateInverse = vtkSmartPointer<vtkApproximateInverseGridTransform>::New();
+    approximateInverse->SetInterpolationModeToLinear();
+    approximateInverse->SetDisplacementGridData(displacementGrid);
+    approximateInverse->SetGridDirectionMatrix(geometry.Direction);
+    approximateInverse->SetApproximatedTransform(storedTransform);
+    approximateInverse->Update();
+
+    // Estimate the error at cell centers, where the interpolation error is expected to be the largest
+    int numberOfCells[3] = { 1, 1, 1 };
+    double cellCenterOffset[3] = { 0.0, 0.0, 0.0 };
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      if (dimensions[axis] > 1)
+      {
+        numberOfCells[axis] = dimensions[axis] - 1;
+        cellCenterOffset[axis] = 0.5;
+      }
+    }
+    vtkSMPThreadLocal<double> maximumErrors(0.0);
+    vtkSMPTools::For(0, numberOfCells[2],
+      [&](vtkIdType beginSlice, vtkIdType endSlice)
+      {
+        double& maximumError = maximumErrors.Local();
+        for (vtkIdType k = beginSlice; k < endSlice && !canceled->load(); ++k)
+        {
+          for (int j = 0; j < numberOfCells[1]; ++j)
+          {
+            for (int i = 0; i < numberOfCells[0]; ++i)
+            {
+              double point[3] = { 0.0, 0.0, 0.0 };
+              double inversePoint[3] = { 0.0, 0.0, 0.0 };
+              double roundTripPoint[3] = { 0.0, 0.0, 0.0 };
+              gridPointPosition(i + cellCenterOffset[0], j + cellCenterOffset[1], k + cellCenterOffset[2], point);
+              approximateInverse->InternalTransformPoint(point, inversePoint);
+              storedTransform->InternalTransformPoint(inversePoint, roundTripPoint);
+              maximumError = std::max(maximumError, std::sqrt(vtkMath::Distance2BetweenPoints(point, roundTripPoint)));
+            }
+          }
+        }
+      });
+    if (canceled->load())
+    {
+      return Result();
+    }
+
+    result.Transform = approximateInverse;
+    result.MaximumError = 0.0;
+    for (vtkSMPThreadLocal<double>::iterator it = maximumErrors.begin(); it != maximumErrors.end(); ++it)
+    {
+      result.MaximumError = std::max(result.MaximumError, *it);
+    }
+    return result;
+  }
+
+  /// Compute the approximate inverse in a background thread and notify the node on the main thread.
+  /// The result is published before the notification is requested, so that it can be retrieved
+  /// without waiting when the notification is processed.
+  static void ComputeAndNotify(vtkSmartPointer<vtkAbstractTransform> storedTransform,
+                               GridGeometry geometry,
+                               std::shared_ptr<std::atomic<bool>> canceled,
+                               std::shared_ptr<std::promise<Result>> result,
+                               vtkObject* completionNotifier)
+  {
+    result->set_value(Compute(storedTransform, geometry, canceled));
+    if (!canceled->load())
+    {
+      // The notifier is kept alive by the node until this task is completed
+      vtkEventBroker::GetInstance()->RequestModified(completionNotifier);
+    }
+  }
+
+  /// Stop the background computation and wait for it to finish
+  void CancelPending()
+  {
+    if (this->PendingCanceled)
+    {
+      this->PendingCanceled->store(true);
+    }
+    if (this->PendingTask.valid())
+    {
+      this->PendingTask.wait();
+    }
+    this->Pending = std::future<Result>();
+    this->PendingTask = std::future<void>();
+    this->PendingCanceled = nullptr;
+  }
+
+  /// Retrieve the background computation result if the computation is completed.
+  /// If waitForCompletion is true then the method waits until the computation is completed.
+  void RetrievePending(bool waitForCompletion)
+  {
+    if (!this->Pending.valid())
+    {
+      return;
+    }
+    if (!waitForCompletion && this->Pending.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    {
+      return;
+    }
+    this->Computed = this->Pending.get();
+    this->ComputedKey = this->PendingKey;
+    this->PendingCanceled = nullptr;
+  }
+
+  /// Discard the computation result and cancel the background computation
+  void Reset()
+  {
+    this->CancelPending();
+    this->ComputedKey = Key();
+    this->Computed = Result();
+    this->NotifiedTransform = nullptr;
+  }
+};
 
 //----------------------------------------------------------------------------
 vtkMRMLNodeNewMacro(vtkMRMLTransformNode);
@@ -60,6 +613,9 @@ vtkMRMLTransformNode::vtkMRMLTransformNode()
   this->CachedMatrixTransformToParent = vtkMatrix4x4::New();
   this->CachedMatrixTransformFromParent = vtkMatrix4x4::New();
 
+  this->TransformToWorldCache = new vtkTransformToWorldCache;
+  this->ApproximateInverse = new vtkApproximateInverse;
+
   this->ContentModifiedEvents->InsertNextValue(vtkMRMLTransformableNode::TransformModifiedEvent);
 
   this->DefaultSequenceStorageNodeClassName = "vtkMRMLTransformSequenceStorageNode";
@@ -75,6 +631,15 @@ vtkMRMLTransformNode::~vtkMRMLTransformNode()
   this->CachedMatrixTransformToParent = nullptr;
   this->CachedMatrixTransformFromParent->Delete();
   this->CachedMatrixTransformFromParent = nullptr;
+
+  delete this->TransformToWorldCache;
+  this->TransformToWorldCache = nullptr;
+
+  // The background computation uses the notifier, therefore it must be completed before the notifier is released
+  this->ApproximateInverse->CancelPending();
+  vtkSetAndObserveMRMLObjectMacro(this->ApproximateInverse->CompletionNotifier, nullptr);
+  delete this->ApproximateInverse;
+  this->ApproximateInverse = nullptr;
 }
 
 //----------------------------------------------------------------------------
@@ -341,6 +906,13 @@ void vtkMRMLTransformNode::CopyContent(vtkMRMLNode* anode, bool deepCopy /*=true
   // copy the center of transformation
   this->SetCenterOfTransformation(node->GetCenterOfTransformation());
 
+  // copy approximate inverse options (the approximation is computed when it is needed)
+  this->SetUseApproximateInverse(node->GetUseApproximateInverse());
+  this->SetApproximateInverseGridOrigin(node->GetApproximateInverseGridOrigin());
+  this->SetApproximateInverseGridSpacing(node->GetApproximateInverseGridSpacing());
+  this->SetApproximateInverseGridDimensions(node->GetApproximateInverseGridDimensions());
+  this->SetApproximateInverseTolerance(node->GetApproximateInverseTolerance());
+
   this->Modified();
   this->TransformModified();
 }
@@ -382,6 +954,16 @@ void vtkMRMLTransformNode::PrintSelf(ostream& os, vtkIndent indent)
   }
 
   os << indent << "Center of transformation: " << this->CenterOfTransformation[0] << ", " << this->CenterOfTransformation[1] << ", " << this->CenterOfTransformation[2] << "\n";
+
+  os << indent << "UseApproximateInverse: " << (this->UseApproximateInverse ? "true" : "false") << "\n";
+  os << indent << "ApproximateInverseGridOrigin: " << this->ApproximateInverseGridOrigin[0] << ", " << this->ApproximateInverseGridOrigin[1] << ", "
+     << this->ApproximateInverseGridOrigin[2] << "\n";
+  os << indent << "ApproximateInverseGridSpacing: " << this->ApproximateInverseGridSpacing[0] << ", " << this->ApproximateInverseGridSpacing[1] << ", "
+     << this->ApproximateInverseGridSpacing[2] << "\n";
+  os << indent << "ApproximateInverseGridDimensions: " << this->ApproximateInverseGridDimensions[0] << ", " << this->ApproximateInverseGridDimensions[1] << ", "
+     << this->ApproximateInverseGridDimensions[2] << "\n";
+  os << indent << "ApproximateInverseTolerance: " << this->ApproximateInverseTolerance << "\n";
+  os << indent << "ApproximateInverseError: " << this->ApproximateInverse->Computed.MaximumError << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -421,6 +1003,10 @@ vtkAbstractTransform* vtkMRMLTransformNode::GetTransformFromParent()
 //----------------------------------------------------------------------------
 int vtkMRMLTransformNode::IsTransformToWorldLinear()
 {
+  if (this->UpdateTransformToWorldCache())
+  {
+    return this->TransformToWorldCache->Linear ? 1 : 0;
+  }
   for (vtkMRMLTransformNode* current = this; current != nullptr; current = current->GetParentTransformNode())
   {
     if (!current->IsLinear())
@@ -529,6 +1115,18 @@ void vtkMRMLTransformNode::GetTransformBetweenNodes(vtkMRMLTransformNode* source
     return;
   }
 
+  // Transforms to and from world are available in the transform to world cache
+  if (targetNode == nullptr && sourceNode->UpdateTransformToWorldCache())
+  {
+    sourceNode->ConcatenateCachedTransformToWorld(transformSourceToTarget);
+    return;
+  }
+  if (sourceNode == nullptr && targetNode->UpdateTransformToWorldCache())
+  {
+    targetNode->ConcatenateCachedTransformFromWorld(transformSourceToTarget);
+    return;
+  }
+
   // If the number of transforms between the nodes exceeds the max depth threshold, then begin to search
   // for duplicate transform nodes to ensure that the transform nodes don't contain a loop.
   // See issue https://github.com/Slicer/Slicer/issues/6355.
@@ -962,6 +1560,17 @@ int vtkMRMLTransformNode::GetMatrixTransformBetweenNodes(vtkMRMLTransformNode* s
     return 1;
   }
 
+  // Matrices to and from world are available in the transform to world cache if all transforms are linear
+  if (targetNode == nullptr && sourceNode->UpdateTransformToWorldCache() && sourceNode->GetCachedMatrixTransformToWorld(transformSourceToTarget))
+  {
+    return 1;
+  }
+  if (sourceNode == nullptr && targetNode->UpdateTransformToWorldCache() && targetNode->GetCachedMatrixTransformToWorld(transformSourceToTarget))
+  {
+    transformSourceToTarget->Invert();
+    return 1;
+  }
+
   if (sourceNode && sourceNode->IsTransformNodeMyParent(targetNode))
   {
     transformSourceToTarget->Identity();
@@ -1230,6 +1839,11 @@ void vtkMRMLTransformNode::ProcessMRMLEvents(vtkObject* caller, unsigned long ev
       this->TransformModified();
       this->StorableModifiedTime.Modified();
     }
+    else if (caller == this->ApproximateInverse->CompletionNotifier)
+    {
+      // Background computation of the approximate inverse is completed
+      this->UpdateApproximateInverse();
+    }
   }
 }
 
@@ -1289,6 +1903,174 @@ vtkMTimeType vtkMRMLTransformNode::GetTransformToWorldMTime()
   return latestMTime;
 }
 
+//----------------------------------------------------------------------------
+bool vtkMRMLTransformNode::UpdateTransformToWorldCache()
+{
+  vtkTransformToWorldCache* cache = this->TransformToWorldCache;
+
+  // The cache is up-to-date if the chain of transform nodes and their transforms are
+  // the same and none of the transforms has been modified since the cache was updated
+  // (same as comparing with GetTransformToWorldMTime, but it also detects changes in the tree).
+  if (cache->Valid)
+  {
+    bool upToDate = true;
+    size_t chainIndex = 0;
+    for (vtkMRMLTransformNode* current = this; current != nullptr; current = current->GetParentTransformNode(), ++chainIndex)
+    {
+      if (chainIndex >= cache->Chain.size() || cache->Chain[chainIndex].Node != current)
+      {
+        upToDate = false;
+        break;
+      }
+      const vtkTransformToWorldCache::ChainItem& item = cache->Chain[chainIndex];
+      vtkAbstractTransform* transformToParent = current->GetEvaluatedTransformToParent();
+      vtkAbstractTransform* transformFromParent = item.TransformFromParent ? current->GetEvaluatedTransformFromParent() : nullptr;
+      if (item.TransformToParent != transformToParent || item.TransformFromParent != transformFromParent //
+          || (transformToParent && transformToParent->GetMTime() > cache->MTime)                       //
+          || (transformFromParent && transformFromParent->GetMTime() > cache->MTime))
+      {
+        upToDate = false;
+        break;
+      }
+    }
+    if (upToDate && chainIndex == cache->Chain.size())
+    {
+      return true;
+    }
+  }
+
+  cache->Valid = false;
+  cache->Chain.clear();
+  cache->Segments.clear();
+  cache->MTime = 0;
+  cache->Linear = true;
+
+  // If the number of transforms exceeds the max depth threshold, then begin to search
+  // for duplicate transform nodes to ensure that the transform nodes don't contain a loop.
+  // See issue https://github.com/Slicer/Slicer/issues/6355.
+  const size_t maxDepth = 100;
+  std::set<vtkMRMLTransformNode*> visitedTransformNodes;
+
+  // Product of consecutive linear transforms
+  vtkSmartPointer<vtkMatrix4x4> linearTransformToWorld;
+  for (vtkMRMLTransformNode* current = this; current != nullptr; current = current->GetParentTransformNode())
+  {
+    if (cache->Chain.size() > maxDepth && !visitedTransformNodes.insert(current).second)
+    {
+      // Loop detected, transform to world is undefined
+      cache->Chain.clear();
+      cache->Segments.clear();
+      return false;
+    }
+
+    vtkTransformToWorldCache::ChainItem item;
+    item.Node = current;
+    item.TransformToParent = current->GetEvaluatedTransformToParent();
+    vtkAbstractTransform* transformToParent = item.TransformToParent;
+    if (!current->IsLinear())
+    {
+      cache->Linear = false;
+    }
+    if (transformToParent == nullptr)
+    {
+      cache->Chain.push_back(item);
+      continue;
+    }
+    cache->MTime = std::max(cache->MTime, transformToParent->GetMTime());
+
+    vtkLinearTransform* linearTransformToParent = vtkLinearTransform::SafeDownCast(transformToParent);
+    if (linearTransformToParent)
+    {
+      if (!linearTransformToWorld)
+      {
+        linearTransformToWorld = vtkSmartPointer<vtkMatrix4x4>::New();
+      }
+      vtkNew<vtkMatrix4x4> toParentMatrix;
+      linearTransformToParent->GetMatrix(toParentMatrix);
+      vtkMatrix4x4::Multiply4x4(toParentMatrix, linearTransformToWorld, linearTransformToWorld);
+    }
+    else
+    {
+      if (linearTransformToWorld)
+      {
+        vtkTransformToWorldCache::Segment linearSegment;
+        linearSegment.Matrix = linearTransformToWorld;
+        cache->Segments.push_back(linearSegment);
+        linearTransformToWorld = nullptr;
+      }
+      item.TransformFromParent = current->GetEvaluatedTransformFromParent();
+      cache->MTime = std::max(cache->MTime, item.TransformFromParent->GetMTime());
+      vtkTransformToWorldCache::Segment nonLinearSegment;
+      nonLinearSegment.Transform = transformToParent;
+      nonLinearSegment.InverseTransform = item.TransformFromParent;
+      cache->Segments.push_back(nonLinearSegment);
+    }
+    cache->Chain.push_back(item);
+  }
+  if (linearTransformToWorld)
+  {
+    vtkTransformToWorldCache::Segment linearSegment;
+    linearSegment.Matrix = linearTransformToWorld;
+    cache->Segments.push_back(linearSegment);
+  }
+
+  cache->Valid = true;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLTransformNode::ConcatenateCachedTransformToWorld(vtkGeneralTransform* transform)
+{
+  for (const vtkTransformToWorldCache::Segment& segment : this->TransformToWorldCache->Segments)
+  {
+    if (segment.Matrix)
+    {
+      // The matrix is copied, so that the transform is not changed when the cache is updated
+      transform->Concatenate(segment.Matrix);
+    }
+    else
+    {
+      transform->Concatenate(segment.Transform);
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLTransformNode::ConcatenateCachedTransformFromWorld(vtkGeneralTransform* transform)
+{
+  const std::vector<vtkTransformToWorldCache::Segment>& segments = this->TransformToWorldCache->Segments;
+  for (auto segmentIt = segments.rbegin(); segmentIt != segments.rend(); ++segmentIt)
+  {
+    if (segmentIt->Matrix)
+    {
+      vtkNew<vtkMatrix4x4> inverseMatrix;
+      vtkMatrix4x4::Invert(segmentIt->Matrix, inverseMatrix);
+      transform->Concatenate(inverseMatrix);
+    }
+    else
+    {
+      transform->Concatenate(segmentIt->InverseTransform);
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLTransformNode::GetCachedMatrixTransformToWorld(vtkMatrix4x4* matrix)
+{
+  const std::vector<vtkTransformToWorldCache::Segment>& segments = this->TransformToWorldCache->Segments;
+  if (segments.empty())
+  {
+    matrix->Identity();
+    return true;
+  }
+  if (segments.size() == 1 && segments[0].Matrix)
+  {
+    matrix->DeepCopy(segments[0].Matrix);
+    return true;
+  }
+  return false;
+}
+
 //----------------------------------------------------------------------------
 const char* vtkMRMLTransformNode::GetTransformToParentInfo()
 {
@@ -1762,3 +2544,237 @@ void vtkMRMLTransformNode::SetCenterOfTransformation(const double center[3])
 {
   this->SetCenterOfTransformation(center[0], center[1], center[2]);
 }
+
+//----------------------------------------------------------------------------
+void vtkMRMLTransformNode::SetUseApproximateInverse(bool use)
+{
+  if (this->UseApproximateInverse == use)
+  {
+    return;
+  }
+  this->UseApproximateInverse = use;
+  if (!use)
+  {
+    this->ApproximateInverse->Reset();
+  }
+  this->Modified();
+  // Transform to world changes when the approximation is enabled and it is computed when the transform is requested
+  this->TransformModified();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLTransformNode::SetApproximateInverseGridOrigin(double x, double y, double z)
+{
+  if (this->ApproximateInverseGridOrigin[0] == x && this->ApproximateInverseGridOrigin[1] == y && this->ApproximateInverseGridOrigin[2] == z)
+  {
+    return;
+  }
+  this->ApproximateInverseGridOrigin[0] = x;
+  this->ApproximateInverseGridOrigin[1] = y;
+  this->ApproximateInverseGridOrigin[2] = z;
+  this->Modified();
+  if (this->UseApproximateInverse)
+  {
+    this->TransformModified();
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLTransformNode::SetApproximateInverseGridOrigin(const double origin[3])
+{
+  this->SetApproximateInverseGridOrigin(origin[0], origin[1], origin[2]);
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLTransformNode::SetApproximateInverseGridSpacing(double x, double y, double z)
+{
+  if (this->ApproximateInverseGridSpacing[0] == x && this->ApproximateInverseGridSpacing[1] == y && this->ApproximateInverseGridSpacing[2] == z)
+  {
+    return;
+  }
+  this->ApproximateInverseGridSpacing[0] = x;
+  this->ApproximateInverseGridSpacing[1] = y;
+  this->ApproximateInverseGridSpacing[2] = z;
+  this->Modified();
+  if (this->UseApproximateInverse)
+  {
+    this->TransformModified();
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLTransformNode::SetApproximateInverseGridSpacing(const double spacing[3])
+{
+  this->SetApproximateInverseGridSpacing(spacing[0], spacing[1], spacing[2]);
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLTransformNode::SetApproximateInverseGridDimensions(int x, int y, int z)
+{
+  if (this->ApproximateInverseGridDimensions[0] == x && this->ApproximateInverseGridDimensions[1] == y && this->ApproximateInverseGridDimensions[2] == z)
+  {
+    return;
+  }
+  this->ApproximateInverseGridDimensions[0] = x;
+  this->ApproximateInverseGridDimensions[1] = y;
+  this->ApproximateInverseGridDimensions[2] = z;
+  this->Modified();
+  if (this->UseApproximateInverse)
+  {
+    this->TransformModified();
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLTransformNode::SetApproximateInverseGridDimensions(const int dimensions[3])
+{
+  this->SetApproximateInverseGridDimensions(dimensions[0], dimensions[1], dimensions[2]);
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLTransformNode::SetApproximateInverseTolerance(double tolerance)
+{
+  if (this->ApproximateInverseTolerance == tolerance)
+  {
+    return;
+  }
+  this->ApproximateInverseTolerance = tolerance;
+  this->Modified();
+  if (this->UseApproximateInverse)
+  {
+    this->TransformModified();
+  }
+}
+
+//----------------------------------------------------------------------------
+vtkAbstractTransform* vtkMRMLTransformNode::GetApproximateInverse()
+{
+  if (!this->UseApproximateInverse)
+  {
+    return nullptr;
+  }
+  vtkApproximateInverse* approximateInverse = this->ApproximateInverse;
+  vtkApproximateInverse::Key key;
+  if (!vtkApproximateInverse::GetKey(this, key))
+  {
+    return nullptr;
+  }
+
+  if (approximateInverse->Pending.valid())
+  {
+    if (approximateInverse->PendingKey == key)
+    {
+      approximateInverse->RetrievePending(false);
+    }
+    else
+    {
+      // The transform or grid has been changed since the computation was started
+      approximateInverse->CancelPending();
+    }
+  }
+
+  if (approximateInverse->ComputedKey != key && !approximateInverse->Pending.valid())
+  {
+    // Start computation of the approximate inverse in a background thread
+    vtkApproximateInverse::GridGeometry geometry;
+    if (!vtkApproximateInverse::GetGridGeometry(key, geometry))
+    {
+      // Grid geometry is not specified and cannot be determined from the stored transform.
+      // Store an empty result to not retry until the transform or options are changed.
+      approximateInverse->ComputedKey = key;
+      approximateInverse->Computed = vtkApproximateInverse::Result();
+      return nullptr;
+    }
+    // The stored transform is copied so that it can be modified while the inverse is computed
+    vtkSmartPointer<vtkAbstractTransform> storedTransformCopy = vtkSmartPointer<vtkAbstractTransform>::Take(key.StoredTransform->MakeTransform());
+    vtkMRMLTransformNode::DeepCopyTransform(storedTransformCopy, key.StoredTransform);
+    if (approximateInverse->CompletionNotifier == nullptr)
+    {
+      vtkNew<vtkObject> completionNotifier;
+      vtkSetAndObserveMRMLObjectMacro(approximateInverse->CompletionNotifier, completionNotifier);
+    }
+    // Wait for the previous task to release the notifier (its result has already been retrieved)
+    approximateInverse->CancelPending();
+    std::shared_ptr<std::promise<vtkApproximateInverse::Result>> result = std::make_shared<std::promise<vtkApproximateInverse::Result>>();
+    approximateInverse->PendingKey = key;
+    approximateInverse->PendingCanceled = std::make_shared<std::atomic<bool>>(false);
+    approximateInverse->Pending = result->get_future();
+    approximateInverse->PendingTask = std::async(std::launch::async,
+                                                 vtkApproximateInverse::ComputeAndNotify,
+                                                 storedTransformCopy,
+                                                 geometry,
+                                                 approximateInverse->PendingCanceled,
+                                                 result,
+                                                 approximateInverse->CompletionNotifier);
+  }
+
+  if (approximateInverse->ComputedKey != key || approximateInverse->Computed.Transform == nullptr
+      || approximateInverse->Computed.MaximumError > this->ApproximateInverseTolerance)
+  {
+    return nullptr;
+  }
+  return approximateInverse->Computed.Transform;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLTransformNode::IsApproximateInverseUsed()
+{
+  return this->GetApproximateInverse() != nullptr;
+}
+
+//----------------------------------------------------------------------------
+double vtkMRMLTransformNode::GetApproximateInverseError()
+{
+  vtkApproximateInverse::Key key;
+  if (!this->UseApproximateInverse || !vtkApproximateInverse::GetKey(this, key) //
+      || this->ApproximateInverse->ComputedKey != key || this->ApproximateInverse->Computed.Transform == nullptr)
+  {
+    return -1.0;
+  }
+  return this->ApproximateInverse->Computed.MaximumError;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLTransformNode::UpdateApproximateInverse(bool waitForCompletion /*=false*/)
+{
+  vtkApproximateInverse* approximateInverse = this->ApproximateInverse;
+  this->GetApproximateInverse();
+  if (waitForCompletion)
+  {
+    approximateInverse->RetrievePending(true);
+  }
+  if (approximateInverse->Computed.Transform != approximateInverse->NotifiedTransform)
+  {
+    // Transform to world has changed
+    approximateInverse->NotifiedTransform = approximateInverse->Computed.Transform;
+    this->TransformModified();
+  }
+}
+
+//----------------------------------------------------------------------------
+vtkAbstractTransform* vtkMRMLTransformNode::GetEvaluatedTransformToParent()
+{
+  if (this->TransformToParent == nullptr)
+  {
+    vtkAbstractTransform* approximateInverse = this->GetApproximateInverse();
+    if (approximateInverse)
+    {
+      return approximateInverse;
+    }
+  }
+  return this->GetTransformToParent();
+}
+
+//----------------------------------------------------------------------------
+vtkAbstractTransform* vtkMRMLTransformNode::GetEvaluatedTransformFromParent()
+{
+  if (this->TransformFromParent == nullptr)
+  {
+    vtkAbstractTransform* approximateInverse = this->GetApproximateInverse();
+    if (approximateInverse)
+    {
+      return approximateInverse;
+    }
+  }
+  return this->GetTransformFromParent();
+}
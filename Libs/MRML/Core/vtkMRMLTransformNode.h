@@ -118,6 +118,9 @@ public:
   ///
   /// Get concatenated transforms to world.
   /// The method may change the PreMultiply/PostMultiply flag of the transform.
+  /// The result is computed from a cache that is only updated when the transforms change.
+  /// Consecutive linear transforms are included as a copy of their combined matrix, therefore
+  /// the transform must be retrieved again when TransformModifiedEvent is invoked.
   /// \sa GetTransformBetweenNodes
   void GetTransformToWorld(vtkGeneralTransform* transformToWorld);
 
@@ -361,6 +364,60 @@ public:
   virtual void SetCenterOfTransformation(const double xyz[3]);
   vtkGetVector3Macro(CenterOfTransformation, double);
 
+  /// Use a precomputed displacement field for evaluating the inverse of non-linear (grid, B-spline, thin-plate spline)
+  /// transforms when computing transform to/from world. Disabled by default.
+  /// Evaluating the inverse of a warp transform requires iterative solving for each point, which is slow when
+  /// many points are transformed (e.g., models and slice views). If this option is enabled then the inverse
+  /// is sampled on a grid in a background thread and linear interpolation of the sampled displacements
+  /// is used instead, if its estimated error is below ApproximateInverseTolerance.
+  /// The exact inverse is still computed for points outside the sampled grid.
+  /// Until the approximation is available (or if it is not accurate enough) the exact inverse is used.
+  /// GetTransformToParent() and GetTransformFromParent() always return the exact transforms.
+  /// TransformModifiedEvent is invoked when the approximate inverse becomes available.
+  virtual void SetUseApproximateInverse(bool use);
+  vtkGetMacro(UseApproximateInverse, bool);
+  vtkBooleanMacro(UseApproximateInverse, bool);
+
+  /// Geometry of the grid that the approximate inverse is computed on. The grid is defined in the input coordinate
+  /// system of the approximated transform (this node's coordinate system for transform to parent, the parent
+  /// coordinate system for transform from parent).
+  /// If any of the dimensions is 0 (default) then the geometry is determined from the stored transform:
+  /// grid transforms use their displacement grid, B-spline transforms use their coefficient grid refined 4x.
+  /// Other transforms (such as thin-plate splines) can only be approximated on an explicitly specified grid.
+  /// \sa SetUseApproximateInverse
+  virtual void SetApproximateInverseGridOrigin(double x, double y, double z);
+  virtual void SetApproximateInverseGridOrigin(const double origin[3]);
+  vtkGetVector3Macro(ApproximateInverseGridOrigin, double);
+  virtual void SetApproximateInverseGridSpacing(double x, double y, double z);
+  virtual void SetApproximateInverseGridSpacing(const double spacing[3]);
+  vtkGetVector3Macro(ApproximateInverseGridSpacing, double);
+  virtual void SetApproximateInverseGridDimensions(int x, int y, int z);
+  virtual void SetApproximateInverseGridDimensions(const int dimensions[3]);
+  vtkGetVector3Macro(ApproximateInverseGridDimensions, int);
+
+  /// Maximum allowed error (in mm) of the approximate inverse. Default is 0.1mm.
+  /// If the estimated error of the computed approximation is larger then the exact inverse is used.
+  virtual void SetApproximateInverseTolerance(double tolerance);
+  vtkGetMacro(ApproximateInverseTolerance, double);
+
+  /// Returns true if an up-to-date approximate inverse is available and its error is within tolerance,
+  /// therefore it is used for computing transform to/from world.
+  /// Starts computation of the approximate inverse if needed.
+  bool IsApproximateInverseUsed();
+
+  /// Returns the estimated maximum error (in mm) of the latest up-to-date approximate inverse.
+  /// The error is the distance between a point and the point transformed by the approximate inverse and then by
+  /// the stored transform, evaluated at the center of each grid cell.
+  /// Returns -1 if no up-to-date approximate inverse is available.
+  double GetApproximateInverseError();
+
+  /// Start computation of the approximate inverse if needed and use the result if the computation is completed.
+  /// If waitForCompletion is true then the method returns when the approximate inverse is computed.
+  /// Computation is started automatically when the transform to/from world is requested, and this method
+  /// is called automatically when the background computation is completed (if the application processes
+  /// vtkEventBroker modified requests), therefore it is only necessary to call this method to wait for completion.
+  void UpdateApproximateInverse(bool waitForCompletion = false);
+
 protected:
   vtkMRMLTransformNode();
   ~vtkMRMLTransformNode() override;
@@ -398,6 +455,56 @@ protected:
   vtkMatrix4x4* CachedMatrixTransformFromParent;
 
   double CenterOfTransformation[3]{ 0.0, 0.0, 0.0 };
+
+  ///
+  /// Update the cached transform to world if the chain of parent transform nodes or any
+  /// transform in it has changed (transform MTime is newer than the cache) since the last update.
+  /// Returns false if the cache cannot be updated because a loop is found in the transform tree.
+  bool UpdateTransformToWorldCache();
+
+  ///
+  /// Concatenate the cached transform to world to the specified transform.
+  /// UpdateTransformToWorldCache() must be called before this method.
+  void ConcatenateCachedTransformToWorld(vtkGeneralTransform* transform);
+
+  ///
+  /// Get the cached transform to world as a matrix.
+  /// UpdateTransformToWorldCache() must be called before this method.
+  /// Returns false if the cached transform is not a single matrix.
+  bool GetCachedMatrixTransformToWorld(vtkMatrix4x4* matrix);
+
+  ///
+  /// Concatenate the inverse of the cached transform to world to the specified transform.
+  /// UpdateTransformToWorldCache() must be called before this method.
+  void ConcatenateCachedTransformFromWorld(vtkGeneralTransform* transform);
+
+  ///
+  /// Transform to/from parent that is used for computing transform to/from world.
+  /// Same as GetTransformToParent/GetTransformFromParent, except that the approximate inverse is returned
+  /// instead of the exact inverse if it is enabled, up-to-date, and accurate enough.
+  /// \sa SetUseApproximateInverse
+  vtkAbstractTransform* GetEvaluatedTransformToParent();
+  vtkAbstractTransform* GetEvaluatedTransformFromParent();
+
+  /// Returns the approximate inverse if it can be used or nullptr otherwise.
+  /// A completed background computation result is retrieved and a new computation is started
+  /// if the approximate inverse is not up-to-date.
+  vtkAbstractTransform* GetApproximateInverse();
+
+  /// Transform from this node to world. Consecutive linear transforms in the chain
+  /// are collapsed into a single matrix, non-linear transforms are kept as they are.
+  class vtkTransformToWorldCache;
+  vtkTransformToWorldCache* TransformToWorldCache;
+
+  bool UseApproximateInverse{ false };
+  double ApproximateInverseGridOrigin[3]{ 0.0, 0.0, 0.0 };
+  double ApproximateInverseGridSpacing[3]{ 1.0, 1.0, 1.0 };
+  int ApproximateInverseGridDimensions[3]{ 0, 0, 0 };
+  double ApproximateInverseTolerance{ 0.1 };
+
+  /// Approximate inverse of the stored warp transform and its background computation
+  class vtkApproximateInverse;
+  vtkApproximateInverse* ApproximateInverse;
 };
 
 #endif
@@ -51,6 +51,44 @@ Version:   $Revision: 1.6 $
 #include <algorithm>
 #include <iterator>
 
+//----------------------------------------------------------------------------
+// Returns true if the file is written by an ITK image IO that compresses data using zlib.
+// Other image IOs interpret the compression level differently (for example, as JPEG quality),
+// therefore gzip compression presets must not be applied to them.
+static bool IsGzipCompressedFileName(const std::string& fileName)
+{
+  std::string lowerCaseFileName = vtksys::SystemTools::LowerCase(fileName);
+  const char* gzipCompressedExtensions[] = { ".mha", ".mhd", ".nrrd", ".nhdr", ".nii.gz", ".img.gz" };
+  for (const char* extension : gzipCompressedExtensions)
+  {
+    if (vtksys::SystemTools::StringEndsWith(lowerCaseFileName, extension))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+//----------------------------------------------------------------------------
+// Returns true if writing fileName may replace existingFileName. This is the case if
+// they are the same file or if existingFileName is the detached data file of fileName
+// (for example, volume.raw of volume.nhdr).
+static bool IsFileOverwrittenByWriting(const std::string& existingFileName, const std::string& fileName)
+{
+  if (fileName.empty())
+  {
+    return false;
+  }
+  if (vtksys::SystemTools::SameFile(existingFileName, fileName))
+  {
+    return true;
+  }
+  std::string existingDir = vtksys::SystemTools::GetFilenamePath(existingFileName);
+  std::string dir = vtksys::SystemTools::GetFilenamePath(fileName);
+  return vtksys::SystemTools::SameFile(existingDir, dir)
+         && vtksys::SystemTools::GetFilenameWithoutLastExtension(existingFileName) == vtksys::SystemTools::GetFilenameWithoutLastExtension(fileName);
+}
+
 //----------------------------------------------------------------------------
 vtkMRMLNodeNewMacro(vtkMRMLVolumeArchetypeStorageNode);
 
@@ -63,7 +101,11 @@ vtkMRMLVolumeArchetypeStorageNode::vtkMRMLVolumeArchetypeStorageNode()
   this->SingleFile = 0;
   this->UseOrientationFromFile = 1;
   this->ForceRightHandedIJKCoordinateSystem = true;
+  this->UseMemoryMapping = false;
   this->DefaultWriteFileExtension = "nrrd";
+
+  // ITK image IOs compress the data in a single thread
+  this->AddGzipCompressionPresets(false);
 }
 
 //----------------------------------------------------------------------------
@@ -79,6 +121,7 @@ void vtkMRMLVolumeArchetypeStorageNode::WriteXML(ostream& of, int nIndent)
     of << " centerImage=\"" << ss.str() << "\"";
   }
   of << " forceRightHandedIJKCoordinateSystem=\"" << (this->ForceRightHandedIJKCoordinateSystem ? "true" : "false") << "\"";
+  of << " useMemoryMapping=\"" << (this->UseMemoryMapping ? "true" : "false") << "\"";
   {
     std::stringstream ss;
     ss << this->UseOrientationFromFile;
@@ -122,6 +165,10 @@ void vtkMRMLVolumeArchetypeStorageNode::ReadXMLAttributes(const char** atts)
     {
       this->SetForceRightHandedIJKCoordinateSystem(strcmp(attValue, "true") == 0);
     }
+    if (!strcmp(attName, "useMemoryMapping"))
+    {
+      this->SetUseMemoryMapping(strcmp(attValue, "true") == 0);
+    }
   }
 
   // SingleFile attribute used to be read from the scene, but often
@@ -147,6 +194,7 @@ void vtkMRMLVolumeArchetypeStorageNode::Copy(vtkMRMLNode* anode)
   this->SetSingleFile(node->SingleFile);
   this->SetUseOrientationFromFile(node->UseOrientationFromFile);
   this->SetForceRightHandedIJKCoordinateSystem(node->ForceRightHandedIJKCoordinateSystem);
+  this->SetUseMemoryMapping(node->UseMemoryMapping);
 
   this->EndModify(disabledModify);
 }
@@ -159,6 +207,7 @@ void vtkMRMLVolumeArchetypeStorageNode::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "SingleFile:   " << this->SingleFile << "\n";
   os << indent << "UseOrientationFromFile:   " << this->UseOrientationFromFile << "\n";
   os << indent << "ForceRightHandedIJKCoordinateSystem:   " << (this->ForceRightHandedIJKCoordinateSystem ? "true" : "false") << "\n";
+  os << indent << "UseMemoryMapping:   " << (this->UseMemoryMapping ? "true" : "false") << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -295,6 +344,103 @@ void ApplyImageSeriesReaderWorkaround(vtkMRMLVolumeArchetypeStorageNode* storage
 
 } // end of anonymous namespace
 
+//----------------------------------------------------------------------------
+vtkITKArchetypeImageSeriesReader* vtkMRMLVolumeArchetypeStorageNode::InstantiateReader(vtkMRMLNode* refNode, const std::string& fullName)
+{
+  vtkSmartPointer<vtkITKArchetypeImageSeriesReader> reader;
+
+  if (refNode->IsA("vtkMRMLVectorVolumeNode"))
+  {
+    reader.TakeReference(this->InstantiateVectorVolumeReader(fullName));
+  }
+  else if (refNode->IsA("vtkMRMLDiffusionTensorVolumeNode"))
+  {
+    reader = vtkSmartPointer<vtkITKArchetypeDiffusionTensorImageReaderFile>::New();
+    reader->SetSingleFile(this->GetSingleFile());
+    reader->SetUseOrientationFromFile(this->GetUseOrientationFromFile());
+  }
+  else
+  {
+    reader = vtkSmartPointer<vtkITKArchetypeImageSeriesScalarReader>::New();
+    reader->SetSingleFile(this->GetSingleFile());
+    reader->SetUseOrientationFromFile(this->GetUseOrientationFromFile());
+  }
+
+  if (reader.GetPointer() == nullptr)
+  {
+    return nullptr;
+  }
+
+  // Set the list of file names on the reader
+  reader->ResetFileNames();
+  reader->SetArchetype(fullName.c_str());
+
+  // Workaround
+  ApplyImageSeriesReaderWorkaround(this, reader, fullName);
+
+  // Center image
+  reader->SetOutputScalarTypeToNative();
+  reader->SetDesiredCoordinateOrientationToNative();
+  reader->SetUseMemoryMapping(this->UseMemoryMapping);
+  if (this->CenterImage)
+  {
+    reader->SetUseNativeOriginOff();
+  }
+  else
+  {
+    reader->SetUseNativeOriginOn();
+  }
+
+  reader->Register(nullptr);
+  return reader;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLVolumeArchetypeStorageNode::PreloadData(vtkMRMLNode* refNode)
+{
+  this->ReleasePreloadedData();
+  if (!refNode || !refNode->IsA("vtkMRMLScalarVolumeNode") || this->GetWriteState() == SkippedNoData)
+  {
+    return false;
+  }
+  std::string fullName = this->GetFullNameFromFileName();
+  if (fullName.empty())
+  {
+    return false;
+  }
+  vtkSmartPointer<vtkITKArchetypeImageSeriesReader> reader;
+  reader.TakeReference(this->InstantiateReader(refNode, fullName));
+  if (reader.GetPointer() == nullptr)
+  {
+    return false;
+  }
+  try
+  {
+    reader->Update();
+  }
+  catch (...)
+  {
+    // ReadData() will read the file again and report the error
+    return false;
+  }
+  if (reader->GetErrorCode() != vtkErrorCode::NoError)
+  {
+    return false;
+  }
+  this->PreloadedReader = reader;
+  this->PreloadedNode = refNode;
+  this->PreloadedFileName = fullName;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeArchetypeStorageNode::ReleasePreloadedData()
+{
+  this->PreloadedReader = nullptr;
+  this->PreloadedNode = nullptr;
+  this->PreloadedFileName.clear();
+}
+
 //----------------------------------------------------------------------------
 int vtkMRMLVolumeArchetypeStorageNode::ReadDataInternal(vtkMRMLNode* refNode)
 {
@@ -337,23 +483,17 @@ int vtkMRMLVolumeArchetypeStorageNode::ReadDataInternal(vtkMRMLNode* refNode)
     return 0;
   }
 
+  // Use the preloaded reader if the file has been read already
   vtkSmartPointer<vtkITKArchetypeImageSeriesReader> reader;
-
-  if (refNode->IsA("vtkMRMLVectorVolumeNode"))
+  if (this->PreloadedReader && this->PreloadedNode.GetPointer() == refNode && this->PreloadedFileName == fullName)
   {
-    reader.TakeReference(this->InstantiateVectorVolumeReader(fullName));
+    reader = this->PreloadedReader;
   }
-  else if (refNode->IsA("vtkMRMLDiffusionTensorVolumeNode"))
+  bool preloaded = (reader.GetPointer() != nullptr);
+  this->ReleasePreloadedData();
+  if (!preloaded)
   {
-    reader = vtkSmartPointer<vtkITKArchetypeDiffusionTensorImageReaderFile>::New();
-    reader->SetSingleFile(this->GetSingleFile());
-    reader->SetUseOrientationFromFile(this->GetUseOrientationFromFile());
-  }
-  else
-  {
-    reader = vtkSmartPointer<vtkITKArchetypeImageSeriesScalarReader>::New();
-    reader->SetSingleFile(this->GetSingleFile());
-    reader->SetUseOrientationFromFile(this->GetUseOrientationFromFile());
+    reader.TakeReference(this->InstantiateReader(refNode, fullName));
   }
 
   if (reader.GetPointer() == nullptr)
@@ -369,31 +509,15 @@ int vtkMRMLVolumeArchetypeStorageNode::ReadDataInternal(vtkMRMLNode* refNode)
     volNode->SetAndObserveImageData(nullptr);
   }
 
-  // Set the list of file names on the reader
-  reader->ResetFileNames();
-  reader->SetArchetype(fullName.c_str());
-
-  // Workaround
-  ApplyImageSeriesReaderWorkaround(this, reader, fullName);
-
-  // Center image
-  reader->SetOutputScalarTypeToNative();
-  reader->SetDesiredCoordinateOrientationToNative();
-  if (this->CenterImage)
-  {
-    reader->SetUseNativeOriginOff();
-  }
-  else
-  {
-    reader->SetUseNativeOriginOn();
-  }
-
   bool readingWorked = true;
   std::string errorMessage = "";
   try
   {
     vtkDebugMacro("ReadDataInternal: right before reader update, reader num files = " << reader->GetNumberOfFileNames());
-    reader->Update();
+    if (!preloaded)
+    {
+      reader->Update();
+    }
     if (reader->GetErrorCode() != vtkErrorCode::NoError)
     {
       readingWorked = false;
@@ -559,6 +683,20 @@ int vtkMRMLVolumeArchetypeStorageNode::WriteDataInternal(vtkMRMLNode* refNode)
     return 1;
   }
 
+  // If the voxels are memory mapped from the file that is about to be overwritten then
+  // writing would truncate the file under the mapping (crash on Linux, sharing violation
+  // on Windows). Copy the voxels into regular memory first.
+  vtkImageData* imageData = volNode->GetImageData();
+  vtkDataArray* scalars = imageData->GetPointData() ? imageData->GetPointData()->GetScalars() : nullptr;
+  std::string mappedFileName = vtkITKArchetypeImageSeriesReader::GetMappedFileName(scalars);
+  if (!mappedFileName.empty() && IsFileOverwrittenByWriting(mappedFileName, this->GetFullNameFromFileName()))
+  {
+    vtkDebugMacro("WriteData: voxels are memory mapped from " << mappedFileName << ", copying them to memory before writing");
+    vtkSmartPointer<vtkDataArray> ownedScalars = vtkSmartPointer<vtkDataArray>::Take(scalars->NewInstance());
+    ownedScalars->DeepCopy(scalars);
+    imageData->GetPointData()->SetScalars(ownedScalars);
+  }
+
   // update the file list
   std::string moveFromDir = this->UpdateFileList(refNode, 1);
 
@@ -675,6 +813,10 @@ int vtkMRMLVolumeArchetypeStorageNode::WriteDataInternal(vtkMRMLNode* refNode)
 
     writer->SetInputConnection(volNode->GetImageDataConnection());
     writer->SetUseCompression(this->GetUseCompression());
+    if (IsGzipCompressedFileName(fullName))
+    {
+      writer->SetCompressionLevel(this->GetGzipCompressionLevelFromCompressionParameter(this->CompressionParameter));
+    }
     if (this->WriteFileFormat)
     {
       writer->SetImageIOClassName(this->GetScene()->GetDataIOManager()->GetFileFormatHelper()->GetClassNameFromFormatString(this->WriteFileFormat));
@@ -868,6 +1010,10 @@ std::string vtkMRMLVolumeArchetypeStorageNode::UpdateFileList(vtkMRMLNode* refNo
   writer->SetFileName(tempName.c_str());
   writer->SetInputData(volNode->GetImageData());
   writer->SetUseCompression(this->GetUseCompression());
+  if (IsGzipCompressedFileName(tempName))
+  {
+    writer->SetCompressionLevel(this->GetGzipCompressionLevelFromCompressionParameter(this->CompressionParameter));
+  }
   if (this->WriteFileFormat)
   {
     if (this->GetScene() &&                     //
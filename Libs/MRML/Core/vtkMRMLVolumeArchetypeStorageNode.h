@@ -17,6 +17,10 @@
 
 #include "vtkMRMLStorageNode.h"
 
+// VTK includes
+#include <vtkSmartPointer.h>
+#include <vtkWeakPointer.h>
+
 class vtkImageData;
 class vtkITKArchetypeImageSeriesReader;
 class vtkMRMLVolumeNode;
@@ -86,6 +90,18 @@ public:
   vtkBooleanMacro(ForceRightHandedIJKCoordinateSystem, bool);
   //@}
 
+  //@{
+  /// Map uncompressed single-file volumes (raw NRRD, NHDR, MHA, MHD) into memory when reading.
+  /// Voxels are loaded from disk on first access, therefore even very large volumes are opened
+  /// almost instantly. The mapping is copy-on-write, modified voxels are never written to the file.
+  /// The file must not be modified or removed while the volume is loaded.
+  /// Disabled by default.
+  /// \sa vtkITKArchetypeImageSeriesReader::SetUseMemoryMapping
+  vtkSetMacro(UseMemoryMapping, bool);
+  vtkGetMacro(UseMemoryMapping, bool);
+  vtkBooleanMacro(UseMemoryMapping, bool);
+  //@}
+
   /// Convert voxel vector type enum from vtkITK type to MRML type
   static int ConvertVoxelVectorTypeVTKITKToMRML(int vtkitkType);
   /// Convert voxel vector type enum from MRML type to vtkITK type
@@ -108,6 +124,12 @@ public:
   /// using only wrapped types.
   static void SetMetaDataDictionaryFromReader(vtkMRMLVolumeNode*, vtkITKArchetypeImageSeriesReader*);
 
+  ///
+  /// Read the image file into memory without modifying the volume node.
+  /// \sa vtkMRMLStorageNode::PreloadData()
+  bool PreloadData(vtkMRMLNode* refNode) override;
+  void ReleasePreloadedData() override;
+
 protected:
   vtkMRMLVolumeArchetypeStorageNode();
   ~vtkMRMLVolumeArchetypeStorageNode() override;
@@ -119,6 +141,10 @@ protected:
 
   vtkITKArchetypeImageSeriesReader* InstantiateVectorVolumeReader(const std::string& fullName);
 
+  /// Instantiate a reader that is appropriate for the volume node type and set its inputs.
+  /// Returns nullptr if no suitable reader is found. The returned reader is not updated yet.
+  vtkITKArchetypeImageSeriesReader* InstantiateReader(vtkMRMLNode* refNode, const std::string& fullName);
+
   /// Read data and set it in the referenced node
   int ReadDataInternal(vtkMRMLNode* refNode) override;
 
@@ -129,6 +155,13 @@ protected:
   int SingleFile;
   int UseOrientationFromFile;
   bool ForceRightHandedIJKCoordinateSystem;
+  bool UseMemoryMapping;
+
+  /// Reader that already read the file of PreloadedNode.
+  /// \sa PreloadData()
+  vtkSmartPointer<vtkITKArchetypeImageSeriesReader> PreloadedReader;
+  vtkWeakPointer<vtkMRMLNode> PreloadedNode;
+  std::string PreloadedFileName;
 };
 
 #endif
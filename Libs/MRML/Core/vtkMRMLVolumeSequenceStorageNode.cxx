@@ -49,6 +49,47 @@
 
 // STD includes
 #include <algorithm>
+#include <chrono>
+#include <future>
+#include <map>
+
+//----------------------------------------------------------------------------
+class vtkMRMLVolumeSequenceStorageNode::vtkInternal
+{
+public:
+  /// Frames that are being read or have been read in background threads, indexed by frame index
+  std::map<int, std::future<vtkSmartPointer<vtkImageData>>> PrefetchedFrames;
+
+  /// Read a frame using the specified reader. The reader is passed by value to keep it alive
+  /// while the frame is read in a background thread, even if the storage node switches to another file.
+  static vtkSmartPointer<vtkImageData> ReadFrameImage(vtkSmartPointer<vtkITKImageSequenceReader> reader, int frameIndex)
+  {
+    vtkSmartPointer<vtkImageData> frameImage = vtkSmartPointer<vtkImageData>::New();
+    if (!reader->ReadFrame(static_cast<unsigned int>(frameIndex), frameImage))
+    {
+      return nullptr;
+    }
+    return frameImage;
+  }
+
+  /// Release prefetched frames. Frames that are still being read are only released
+  /// if waitForPendingFrames is enabled, otherwise they are kept until they are completed
+  /// (to not block the main thread).
+  void ReleasePrefetchedFrames(bool waitForPendingFrames)
+  {
+    for (auto it = this->PrefetchedFrames.begin(); it != this->PrefetchedFrames.end();)
+    {
+      if (waitForPendingFrames || it->second.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+      {
+        it = this->PrefetchedFrames.erase(it);
+      }
+      else
+      {
+        ++it;
+      }
+    }
+  }
+};
 
 //----------------------------------------------------------------------------
 vtkMRMLNodeNewMacro(vtkMRMLVolumeSequenceStorageNode);
@@ -56,11 +97,60 @@ vtkMRMLNodeNewMacro(vtkMRMLVolumeSequenceStorageNode);
 //----------------------------------------------------------------------------
 vtkMRMLVolumeSequenceStorageNode::vtkMRMLVolumeSequenceStorageNode()
 {
+  this->Internal = new vtkInternal;
   this->TypeDisplayName = vtkMRMLTr("vtkMRMLVolumeSequenceStorageNode", "Volume Sequence Storage");
 }
 
 //----------------------------------------------------------------------------
-vtkMRMLVolumeSequenceStorageNode::~vtkMRMLVolumeSequenceStorageNode() = default;
+vtkMRMLVolumeSequenceStorageNode::~vtkMRMLVolumeSequenceStorageNode()
+{
+  delete this->Internal;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeSequenceStorageNode::PrintSelf(ostream& os, vtkIndent indent)
+{
+  Superclass::PrintSelf(os, indent);
+  vtkMRMLPrintBeginMacro(os, indent);
+  vtkMRMLPrintBooleanMacro(LoadFramesOnDemand);
+  vtkMRMLPrintEndMacro();
+  os << indent << "FramesLoadedOnDemand: " << (this->FrameReader ? "true" : "false") << "\n";
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeSequenceStorageNode::ReadXMLAttributes(const char** atts)
+{
+  MRMLNodeModifyBlocker blocker(this);
+  Superclass::ReadXMLAttributes(atts);
+  vtkMRMLReadXMLBeginMacro(atts);
+  vtkMRMLReadXMLBooleanMacro(loadFramesOnDemand, LoadFramesOnDemand);
+  vtkMRMLReadXMLEndMacro();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeSequenceStorageNode::WriteXML(ostream& of, int nIndent)
+{
+  Superclass::WriteXML(of, nIndent);
+  vtkMRMLWriteXMLBeginMacro(of);
+  vtkMRMLWriteXMLBooleanMacro(loadFramesOnDemand, LoadFramesOnDemand);
+  vtkMRMLWriteXMLEndMacro();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeSequenceStorageNode::Copy(vtkMRMLNode* anode)
+{
+  MRMLNodeModifyBlocker blocker(this);
+  Superclass::Copy(anode);
+  vtkMRMLCopyBeginMacro(anode);
+  vtkMRMLCopyBooleanMacro(LoadFramesOnDemand);
+  vtkMRMLCopyEndMacro();
+  // The reader only stores the layout of an existing file, therefore it can be shared
+  vtkMRMLVolumeSequenceStorageNode* node = vtkMRMLVolumeSequenceStorageNode::SafeDownCast(anode);
+  if (node)
+  {
+    this->FrameReader = node->FrameReader;
+  }
+}
 
 //----------------------------------------------------------------------------
 bool vtkMRMLVolumeSequenceStorageNode::CanReadInReferenceNode(vtkMRMLNode* refNode)
@@ -90,15 +180,27 @@ int vtkMRMLVolumeSequenceStorageNode::ReadDataInternal(vtkMRMLNode* refNode)
     return 0;
   }
 
+  // Frames of a previously read file are no longer available
+  this->FrameReader = nullptr;
+  this->Internal->ReleasePrefetchedFrames(true);
+
   // Read first frame and check success
-  vtkNew<vtkITKImageSequenceReader> reader;
+  vtkSmartPointer<vtkITKImageSequenceReader> reader = vtkSmartPointer<vtkITKImageSequenceReader>::New();
   reader->SetFileName(fullName.c_str());
-  reader->Update(); // This will read all the frames into the cache
+  reader->SetReadFramesOnDemand(this->LoadFramesOnDemand);
+  reader->Update(); // This will read all the frames into the cache (unless frames are read on demand)
   if (reader->GetErrorCode() != vtkErrorCode::NoError)
   {
     vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLVolumeSequenceStorageNode::ReadDataInternal", "Error reading file.");
     return 0;
   }
+  bool framesReadOnDemand = reader->GetFramesReadOnDemand();
+  if (this->LoadFramesOnDemand && !framesReadOnDemand)
+  {
+    vtkWarningToMessageCollectionMacro(this->GetUserMessages(),
+                                       "vtkMRMLVolumeSequenceStorageNode::ReadDataInternal",
+                                       "Frames can only be loaded on demand from uncompressed files. All frames are loaded into memory.");
+  }
 
   // Read custom attributes
   std::vector<std::string> indexValues;
@@ -130,20 +232,27 @@ int vtkMRMLVolumeSequenceStorageNode::ReadDataInternal(vtkMRMLNode* refNode)
     }
   }
 
-  for (int frameIndex = 0; frameIndex < reader->GetNumberOfCachedImages(); ++frameIndex)
+  int numberOfFrames = framesReadOnDemand ? static_cast<int>(reader->GetNumberOfFrames()) : static_cast<int>(reader->GetNumberOfCachedImages());
+  for (int frameIndex = 0; frameIndex < numberOfFrames; ++frameIndex)
   {
-    vtkImageData* frameImage = reader->GetCachedImage(frameIndex);
-    if (frameImage == nullptr || frameImage->GetPointData() == nullptr || frameImage->GetPointData()->GetScalars() == nullptr)
+    // Frames that are loaded on demand are added without image data
+    vtkImageData* frameImage = nullptr;
+    if (!framesReadOnDemand)
     {
-      vtkErrorMacro("vtkMRMLVolumeSequenceStorageNode::ReadDataInternal: invalid image data");
-      return 0;
+      frameImage = reader->GetCachedImage(frameIndex);
+      if (frameImage == nullptr || frameImage->GetPointData() == nullptr || frameImage->GetPointData()->GetScalars() == nullptr)
+      {
+        vtkErrorMacro("vtkMRMLVolumeSequenceStorageNode::ReadDataInternal: invalid image data");
+        return 0;
+      }
     }
 
     // Create appropriate volume node based on hint in the file or number of components
     vtkSmartPointer<vtkMRMLVolumeNode> frameVolume;
     if (dataNodeClassName.empty())
     {
-      if (frameImage->GetNumberOfScalarComponents() > 1)
+      int numberOfComponents = frameImage ? frameImage->GetNumberOfScalarComponents() : reader->GetOutput()->GetNumberOfScalarComponents();
+      if (numberOfComponents > 1)
       {
         dataNodeClassName = "vtkMRMLVectorVolumeNode";
       }
@@ -170,17 +279,20 @@ int vtkMRMLVolumeSequenceStorageNode::ReadDataInternal(vtkMRMLNode* refNode)
       frameVolume = vtkSmartPointer<vtkMRMLScalarVolumeNode>::New();
     }
 
-    // Copy origin and spacing from image data to volume node
-    double origin[3] = { 0.0, 0.0, 0.0 };
-    double spacing[3] = { 1.0, 1.0, 1.0 };
-    frameImage->GetOrigin(origin);
-    frameImage->GetSpacing(spacing);
-
-    // Clear origin, spacing, and directions from image data since they are now in the volume node
-    frameImage->SetOrigin(0.0, 0.0, 0.0);
-    frameImage->SetSpacing(1.0, 1.0, 1.0);
-    vtkNew<vtkMatrix3x3> identityDirections;
-    frameImage->SetDirectionMatrix(identityDirections);
+    if (frameImage)
+    {
+      // Copy origin and spacing from image data to volume node
+      double origin[3] = { 0.0, 0.0, 0.0 };
+      double spacing[3] = { 1.0, 1.0, 1.0 };
+      frameImage->GetOrigin(origin);
+      frameImage->GetSpacing(spacing);
+
+      // Clear origin, spacing, and directions from image data since they are now in the volume node
+      frameImage->SetOrigin(0.0, 0.0, 0.0);
+      frameImage->SetSpacing(1.0, 1.0, 1.0);
+      vtkNew<vtkMatrix3x3> identityDirections;
+      frameImage->SetDirectionMatrix(identityDirections);
+    }
 
     // Set up the volume node
     frameVolume->SetAndObserveImageData(frameImage);
@@ -202,6 +314,15 @@ int vtkMRMLVolumeSequenceStorageNode::ReadDataInternal(vtkMRMLNode* refNode)
     nameStr << refNode->GetName() << "_" << std::setw(4) << std::setfill('0') << frameIndex;
     frameVolume->SetName(nameStr.str().c_str());
     volSequenceNode->SetDataNodeAtValue(frameVolume, indexStr.str().c_str());
+    if (framesReadOnDemand)
+    {
+      volSequenceNode->SetNthDataNodeStorageFrameIndex(volSequenceNode->GetItemNumberFromIndexValue(indexStr.str()), frameIndex);
+    }
+  }
+  if (framesReadOnDemand)
+  {
+    this->FrameReader = reader;
+    volSequenceNode->SetItemStorageNode(this);
   }
 
   // Read axis label and unit
@@ -229,6 +350,8 @@ bool vtkMRMLVolumeSequenceStorageNode::CanWriteFromReferenceNode(vtkMRMLNode* re
     this->GetUserMessages()->AddMessage(vtkCommand::ErrorEvent, std::string("Only volume nodes can be written."));
     return false;
   }
+  // Image properties are compared to the first frame, therefore it must be loaded
+  volSequenceNode->LoadNthDataNode(0);
 
   int firstFrameVolumeExtent[6] = { 0, -1, 0, -1, 0, -1 };
   int firstFrameVolumeScalarType = VTK_VOID;
@@ -264,6 +387,11 @@ bool vtkMRMLVolumeSequenceStorageNode::CanWriteFromReferenceNode(vtkMRMLNode* re
       this->GetUserMessages()->AddMessage(vtkCommand::ErrorEvent, std::string("Geometry of all volumes in the sequence must be the same."));
       return false;
     }
+    if (!volSequenceNode->IsNthDataNodeLoaded(frameIndex))
+    {
+      // Frames that are not loaded yet are read from a volume sequence file, which already ensures consistent image properties
+      continue;
+    }
     int currentFrameVolumeExtent[6] = { 0, -1, 0, -1, 0, -1 };
     int currentFrameVolumeScalarType = VTK_VOID;
     int currentFrameVolumeNumberOfComponents = 0;
@@ -318,6 +446,22 @@ int vtkMRMLVolumeSequenceStorageNode::WriteDataInternal(vtkMRMLNode* refNode)
     return 0;
   }
 
+  // All frames are needed for writing. Frames that are loaded only for writing are unloaded after writing.
+  std::vector<int> temporarilyLoadedItemNumbers;
+  for (int itemNumber = 0; itemNumber < volSequenceNode->GetNumberOfDataNodes(); ++itemNumber)
+  {
+    if (volSequenceNode->IsNthDataNodeLoaded(itemNumber))
+    {
+      continue;
+    }
+    if (!volSequenceNode->LoadNthDataNode(itemNumber))
+    {
+      this->GetUserMessages()->AddMessage(vtkCommand::ErrorEvent, std::string("Failed to load sequence item for writing."));
+      return 0;
+    }
+    temporarilyLoadedItemNumbers.push_back(itemNumber);
+  }
+
   vtkNew<vtkMatrix4x4> firstVolumeRasToIjk;
   int frameVolumeDimensions[3] = { 0 };
   int frameVolumeScalarType = VTK_VOID;
@@ -456,12 +600,180 @@ int vtkMRMLVolumeSequenceStorageNode::WriteDataInternal(vtkMRMLNode* refNode)
     writeFlag = 0;
   }
 
+  if (writeFlag && this->LoadFramesOnDemand && this->InitializeFrameReader(fullName))
+  {
+    // Frames are now available from the written file, release them from memory
+    volSequenceNode->SetItemStorageNode(this);
+    for (int itemNumber = 0; itemNumber < numberOfFrameVolumes; ++itemNumber)
+    {
+      volSequenceNode->SetNthDataNodeStorageFrameIndex(itemNumber, itemNumber);
+    }
+    for (int itemNumber : temporarilyLoadedItemNumbers)
+    {
+      volSequenceNode->UnloadNthDataNode(itemNumber);
+    }
+  }
+  else if (writeFlag)
+  {
+    // Frames of the previous file may not be available anymore, keep all of them in memory
+    this->FrameReader = nullptr;
+    volSequenceNode->SetItemStorageNode(nullptr);
+    for (int itemNumber = 0; itemNumber < numberOfFrameVolumes; ++itemNumber)
+    {
+      volSequenceNode->SetNthDataNodeStorageFrameIndex(itemNumber, -1);
+    }
+  }
+  else
+  {
+    for (int itemNumber : temporarilyLoadedItemNumbers)
+    {
+      volSequenceNode->UnloadNthDataNode(itemNumber);
+    }
+  }
+
   this->StageWriteData(refNode);
 
   vtkDebugMacro("vtkMRMLVolumeSequenceStorageNode::WriteDataInternal: sequence successfully written.");
   return writeFlag;
 }
 
+//----------------------------------------------------------------------------
+bool vtkMRMLVolumeSequenceStorageNode::InitializeFrameReader(const std::string& fileName)
+{
+  vtkSmartPointer<vtkITKImageSequenceReader> reader = vtkSmartPointer<vtkITKImageSequenceReader>::New();
+  reader->SetFileName(fileName.c_str());
+  reader->ReadFramesOnDemandOn();
+  reader->Update();
+  this->Internal->ReleasePrefetchedFrames(true);
+  if (reader->GetErrorCode() != vtkErrorCode::NoError || !reader->GetFramesReadOnDemand())
+  {
+    this->FrameReader = nullptr;
+    return false;
+  }
+  this->FrameReader = reader;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLVolumeSequenceStorageNode::ReadFrame(vtkMRMLVolumeNode* frameVolume, int frameIndex)
+{
+  if (!frameVolume)
+  {
+    vtkErrorMacro("vtkMRMLVolumeSequenceStorageNode::ReadFrame failed: invalid volume node");
+    return false;
+  }
+  if (!this->FrameReader)
+  {
+    vtkErrorMacro("vtkMRMLVolumeSequenceStorageNode::ReadFrame failed: frames are not loaded on demand");
+    return false;
+  }
+  if (frameIndex < 0 || frameIndex >= static_cast<int>(this->FrameReader->GetNumberOfFrames()))
+  {
+    vtkErrorMacro("vtkMRMLVolumeSequenceStorageNode::ReadFrame failed: frame index " << frameIndex << " is out of range");
+    return false;
+  }
+  vtkSmartPointer<vtkImageData> frameImage;
+  auto prefetchedFrameIt = this->Internal->PrefetchedFrames.find(frameIndex);
+  if (prefetchedFrameIt != this->Internal->PrefetchedFrames.end())
+  {
+    // Use the prefetched frame (waits for completion if it is still being read)
+    frameImage = prefetchedFrameIt->second.get();
+    this->Internal->PrefetchedFrames.erase(prefetchedFrameIt);
+  }
+  else
+  {
+    frameImage = vtkInternal::ReadFrameImage(this->FrameReader, frameIndex);
+  }
+  if (!frameImage)
+  {
+    vtkErrorMacro("vtkMRMLVolumeSequenceStorageNode::ReadFrame failed: error reading frame " << frameIndex << " from " << this->FrameReader->GetFileName());
+    return false;
+  }
+  frameVolume->SetAndObserveImageData(frameImage);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeSequenceStorageNode::PrefetchFrames(const std::vector<int>& frameIndices)
+{
+  // Release frames that are not requested anymore
+  for (auto it = this->Internal->PrefetchedFrames.begin(); it != this->Internal->PrefetchedFrames.end();)
+  {
+    if (std::find(frameIndices.begin(), frameIndices.end(), it->first) == frameIndices.end() //
+        && it->second.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+    {
+      it = this->Internal->PrefetchedFrames.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+
+  if (!this->FrameReader)
+  {
+    return;
+  }
+  int numberOfFrames = static_cast<int>(this->FrameReader->GetNumberOfFrames());
+  for (int frameIndex : frameIndices)
+  {
+    if (frameIndex < 0 || frameIndex >= numberOfFrames || this->Internal->PrefetchedFrames.count(frameIndex) > 0)
+    {
+      continue;
+    }
+    this->Internal->PrefetchedFrames[frameIndex] = std::async(std::launch::async, vtkInternal::ReadFrameImage, this->FrameReader, frameIndex);
+  }
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLVolumeSequenceStorageNode::GetNumberOfPrefetchedFrames()
+{
+  return static_cast<int>(this->Internal->PrefetchedFrames.size());
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLVolumeSequenceStorageNode::ReadSequenceItem(vtkMRMLNode* dataNode, int frameIndex)
+{
+  return this->ReadFrame(vtkMRMLVolumeNode::SafeDownCast(dataNode), frameIndex);
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLVolumeSequenceStorageNode::IsSequenceItemLoaded(vtkMRMLNode* dataNode)
+{
+  vtkMRMLVolumeNode* volumeNode = vtkMRMLVolumeNode::SafeDownCast(dataNode);
+  return (volumeNode == nullptr || volumeNode->GetImageData() != nullptr);
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLVolumeSequenceStorageNode::IsSequenceItemModifiedSince(vtkMRMLNode* dataNode, vtkMTimeType time)
+{
+  if (this->Superclass::IsSequenceItemModifiedSince(dataNode, time))
+  {
+    return true;
+  }
+  // Voxels may be modified in place, without changing the volume node
+  vtkMRMLVolumeNode* volumeNode = vtkMRMLVolumeNode::SafeDownCast(dataNode);
+  return (volumeNode && volumeNode->GetImageData() && volumeNode->GetImageData()->GetMTime() > time);
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLVolumeSequenceStorageNode::UnloadSequenceItem(vtkMRMLNode* dataNode)
+{
+  vtkMRMLVolumeNode* volumeNode = vtkMRMLVolumeNode::SafeDownCast(dataNode);
+  if (!volumeNode || !volumeNode->GetImageData())
+  {
+    return false;
+  }
+  volumeNode->SetAndObserveImageData(nullptr);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeSequenceStorageNode::PrefetchSequenceItems(const std::vector<int>& frameIndices)
+{
+  this->PrefetchFrames(frameIndices);
+}
+
 //----------------------------------------------------------------------------
 void vtkMRMLVolumeSequenceStorageNode::InitializeSupportedReadFileTypes()
 {
@@ -27,7 +27,16 @@
 #include "vtkMRML.h"
 
 #include "vtkMRMLStorageNode.h"
+
+// VTK includes
+#include <vtkSmartPointer.h>
+
+// STD includes
 #include <string>
+#include <vector>
+
+class vtkITKImageSequenceReader;
+class vtkMRMLVolumeNode;
 
 /// \brief Store a sequence of volumes in a NRRD file.
 ///
@@ -44,6 +53,10 @@
 /// - axis 3 index type: numeric or text
 /// - axis 3 index values: space-separated list of index values (URL-encoded, to deal with special characters)
 ///
+/// If LoadFramesOnDemand is enabled then only the file header is read when the sequence is loaded
+/// and the sequence is populated with volume nodes that have no image data. Voxels of a frame are read
+/// from the file when the item is loaded (see vtkMRMLSequenceNode::LoadNthDataNode).
+///
 
 class VTK_MRML_EXPORT vtkMRMLVolumeSequenceStorageNode : public vtkMRMLStorageNode
 {
@@ -53,6 +66,17 @@ public:
 
   vtkMRMLNode* CreateNodeInstance() override;
 
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Read node attributes from XML file
+  void ReadXMLAttributes(const char** atts) override;
+
+  /// Write this node's information to a MRML file in XML format.
+  void WriteXML(ostream& of, int indent) override;
+
+  /// Copy the node's attributes to this object
+  void Copy(vtkMRMLNode* node) override;
+
   ///
   /// Get node XML tag name (like Storage, Model)
   const char* GetNodeTagName() override { return "VolumeSequenceStorage"; };
@@ -76,6 +100,36 @@ public:
   /// Return a default file extension for writing
   const char* GetDefaultWriteFileExtension() override;
 
+  /// Load voxels of frames only when they are needed.
+  /// This allows browsing sequences that are larger than the available memory.
+  /// Only uncompressed files can be read this way, all frames of compressed files are loaded into memory.
+  /// Default is false.
+  vtkGetMacro(LoadFramesOnDemand, bool);
+  vtkSetMacro(LoadFramesOnDemand, bool);
+  vtkBooleanMacro(LoadFramesOnDemand, bool);
+
+  /// Read voxels of the specified frame of the file into the volume node.
+  /// Only available if the sequence was read with frames loaded on demand.
+  /// Returns true on success.
+  bool ReadFrame(vtkMRMLVolumeNode* frameVolume, int frameIndex);
+
+  /// Start reading the specified frames in background threads so that ReadFrame
+  /// can use them without waiting for the file to be read.
+  /// Previously prefetched frames that are not in the list anymore are released.
+  /// Only available if the sequence was read with frames loaded on demand.
+  void PrefetchFrames(const std::vector<int>& frameIndices);
+
+  /// Get number of frames that are prefetched or are being read in the background
+  int GetNumberOfPrefetchedFrames();
+
+  /// Sequence item loading interface, implemented using ReadFrame() and PrefetchFrames().
+  /// Unloading an item releases the image data of the volume node.
+  bool ReadSequenceItem(vtkMRMLNode* dataNode, int frameIndex) override;
+  bool IsSequenceItemLoaded(vtkMRMLNode* dataNode) override;
+  bool IsSequenceItemModifiedSince(vtkMRMLNode* dataNode, vtkMTimeType time) override;
+  bool UnloadSequenceItem(vtkMRMLNode* dataNode) override;
+  void PrefetchSequenceItems(const std::vector<int>& frameIndices) override;
+
 protected:
   vtkMRMLVolumeSequenceStorageNode();
   ~vtkMRMLVolumeSequenceStorageNode() override;
@@ -96,6 +150,18 @@ protected:
 
   /// Initialize all the supported write file types
   void InitializeSupportedWriteFileTypes() override;
+
+  /// Set up reading frames from the file on demand. Returns false if the file does not support it.
+  bool InitializeFrameReader(const std::string& fileName);
+
+  bool LoadFramesOnDemand{ false };
+
+  /// Reader that keeps the file layout of frames that are loaded on demand
+  vtkSmartPointer<vtkITKImageSequenceReader> FrameReader;
+
+private:
+  class vtkInternal;
+  vtkInternal* Internal;
 };
 
 #endif
@@ -0,0 +1,535 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkMRMLVolumeNode.h"
+#include "vtkMRMLVolumeSharedMemoryTransfer.h"
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+
+// STD includes
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+
+// POSIX includes
+#ifndef _WIN32
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+namespace
+{
+
+const char SharedMemoryFileNamePrefix[] = "shm:";
+const char SharedMemoryImageMagic[8] = { 'S', 'L', 'I', 'C', 'E', 'R', 'I', 'M' };
+const uint32_t SharedMemoryImageVersion = 1;
+// Number of names tried by CreateUnique() before giving up
+const int MaximumNumberOfUniqueNameAttempts = 100;
+
+//----------------------------------------------------------------------------
+// Layout of the beginning of the shared memory segment.
+// Both processes run on the same computer, therefore native byte order is used.
+struct SharedMemoryImageHeader
+{
+  char Magic[8];
+  uint32_t Version;
+  int32_t Dimensions[3];
+  int32_t ScalarType;
+  int32_t NumberOfComponents;
+  double Spacing[3];
+  double Origin[3];
+  double Directions[9];
+  uint64_t ScalarSizeInBytes;
+};
+
+// Voxel data starts at a cache line boundary after the header
+const size_t SharedMemoryImageDataOffset = ((sizeof(SharedMemoryImageHeader) + 63) / 64) * 64;
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkMRMLVolumeSharedMemoryTransfer);
+
+//----------------------------------------------------------------------------
+vtkMRMLVolumeSharedMemoryTransfer::vtkMRMLVolumeSharedMemoryTransfer() = default;
+
+//----------------------------------------------------------------------------
+vtkMRMLVolumeSharedMemoryTransfer::~vtkMRMLVolumeSharedMemoryTransfer()
+{
+  this->Close();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeSharedMemoryTransfer::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "FileName: " << this->FileName << "\n";
+  os << indent << "MappedSize: " << this->MappedSize << "\n";
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLVolumeSharedMemoryTransfer::IsSupported()
+{
+#ifdef _WIN32
+  return false;
+#else
+  return true;
+#endif
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLVolumeSharedMemoryTransfer::IsSharedMemoryFileName(const std::string& fileName)
+{
+  return fileName.compare(0, strlen(SharedMemoryFileNamePrefix), SharedMemoryFileNamePrefix) == 0;
+}
+
+//----------------------------------------------------------------------------
+std::string vtkMRMLVolumeSharedMemoryTransfer::GetSegmentName(const std::string& fileName)
+{
+  if (!vtkMRMLVolumeSharedMemoryTransfer::IsSharedMemoryFileName(fileName))
+  {
+    return std::string();
+  }
+  std::string segmentName = fileName.substr(strlen(SharedMemoryFileNamePrefix));
+  // POSIX shared memory object names must start with a single slash
+  if (segmentName.empty() || segmentName[0] != '/')
+  {
+    segmentName = "/" + segmentName;
+  }
+  return segmentName;
+}
+
+//----------------------------------------------------------------------------
+std::string vtkMRMLVolumeSharedMemoryTransfer::CreateUniqueFileName()
+{
+  static std::atomic<unsigned int> segmentCounter(0);
+  std::ostringstream fileName;
+  // Some platforms (such as macOS) limit the name length to 31 characters
+  fileName << SharedMemoryFileNamePrefix << "/Slicer";
+#ifndef _WIN32
+  fileName << getpid();
+#endif
+  fileName << "_" << ++segmentCounter;
+  return fileName.str();
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLVolumeSharedMemoryTransfer::RemoveSharedMemory(const std::string& fileName)
+{
+  std::string segmentName = vtkMRMLVolumeSharedMemoryTransfer::GetSegmentName(fileName);
+  if (segmentName.empty())
+  {
+    return false;
+  }
+#ifdef _WIN32
+  return false;
+#else
+  return shm_unlink(segmentName.c_str()) == 0;
+#endif
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLVolumeSharedMemoryTransfer::Create(const std::string& fileName,
+                                               const int dimensions[3],
+                                               int scalarType,
+                                               int numberOfComponents,
+                                               const double spacing[3],
+                                               const double origin[3],
+                                               const double directions[9])
+{
+  return this->CreateSegment(fileName, dimensions, scalarType, numberOfComponents, spacing, origin, directions, false, nullptr);
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLVolumeSharedMemoryTransfer::CreateUnique(std::string& fileName,
+                                                     const int dimensions[3],
+                                                     int scalarType,
+                                                     int numberOfComponents,
+                                                     const double spacing[3],
+                                                     const double origin[3],
+                                                     const double directions[9])
+{
+  std::string uniqueFileName = fileName;
+  for (int attempt = 0; attempt < MaximumNumberOfUniqueNameAttempts; ++attempt)
+  {
+    bool segmentExists = false;
+    if (this->CreateSegment(uniqueFileName, dimensions, scalarType, numberOfComponents, spacing, origin, directions, true, &segmentExists))
+    {
+      fileName = uniqueFileName;
+      return true;
+    }
+    if (!segmentExists)
+    {
+      return false;
+    }
+    vtkDebugMacro("CreateUnique: shared memory image '" << uniqueFileName << "' already exists, trying a new name");
+    uniqueFileName = vtkMRMLVolumeSharedMemoryTransfer::CreateUniqueFileName();
+  }
+  vtkErrorMacro("CreateUnique: failed to find an unused shared memory segment name, last tried '" << uniqueFileName << "'");
+  return false;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLVolumeSharedMemoryTransfer::CreateSegment(const std::string& fileName,
+                                                      const int dimensions[3],
+                                                      int scalarType,
+                                                      int numberOfComponents,
+                                                      const double spacing[3],
+                                                      const double origin[3],
+                                                      const double directions[9],
+                                                      bool exclusive,
+                                                      bool* segmentExists)
+{
+  if (segmentExists)
+  {
+    *segmentExists = false;
+  }
+  this->Close();
+  std::string segmentName = vtkMRMLVolumeSharedMemoryTransfer::GetSegmentName(fileName);
+  if (segmentName.empty())
+  {
+    vtkErrorMacro("Create: invalid shared memory file name '" << fileName << "'");
+    return false;
+  }
+  int scalarTypeSize = vtkDataArray::GetDataTypeSize(scalarType);
+  if (scalarTypeSize <= 0 || numberOfComponents <= 0 || dimensions[0] < 0 || dimensions[1] < 0 || dimensions[2] < 0)
+  {
+    vtkErrorMacro("Create: invalid image properties for shared memory image '" << fileName << "'");
+    return false;
+  }
+  uint64_t scalarSizeInBytes = static_cast<uint64_t>(dimensions[0]) * dimensions[1] * dimensions[2] * numberOfComponents * scalarTypeSize;
+  size_t mappedSize = SharedMemoryImageDataOffset + static_cast<size_t>(scalarSizeInBytes);
+
+#ifdef _WIN32
+  vtkErrorMacro("Create: shared memory images are not supported on this platform");
+  return false;
+#else
+  // In exclusive mode an existing segment is never opened: it might be mapped by another process
+  int openFlags = O_CREAT | O_RDWR | (exclusive ? O_EXCL : O_TRUNC);
+  int fileDescriptor = shm_open(segmentName.c_str(), openFlags, S_IRUSR | S_IWUSR);
+  if (fileDescriptor < 0)
+  {
+    if (exclusive && errno == EEXIST)
+    {
+      if (segmentExists)
+      {
+        *segmentExists = true;
+      }
+      return false;
+    }
+    vtkErrorMacro("Create: failed to create shared memory segment '" << segmentName << "'");
+    return false;
+  }
+  if (ftruncate(fileDescriptor, static_cast<off_t>(mappedSize)) != 0)
+  {
+    vtkErrorMacro("Create: failed to allocate " << mappedSize << " bytes in shared memory segment '" << segmentName << "'");
+    close(fileDescriptor);
+    shm_unlink(segmentName.c_str());
+    return false;
+  }
+  void* mappedMemory = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0);
+  // The mapping remains valid after the file descriptor is closed
+  close(fileDescriptor);
+  if (mappedMemory == MAP_FAILED)
+  {
+    vtkErrorMacro("Create: failed to map shared memory segment '" << segmentName << "'");
+    shm_unlink(segmentName.c_str());
+    return false;
+  }
+  this->MappedMemory = mappedMemory;
+  this->MappedSize = mappedSize;
+  this->FileName = fileName;
+#endif
+
+  SharedMemoryImageHeader* header = static_cast<SharedMemoryImageHeader*>(this->MappedMemory);
+  memset(header, 0, sizeof(SharedMemoryImageHeader));
+  memcpy(header->Magic, SharedMemoryImageMagic, sizeof(header->Magic));
+  header->Version = SharedMemoryImageVersion;
+  for (int i = 0; i < 3; ++i)
+  {
+    header->Dimensions[i] = dimensions[i];
+    header->Spacing[i] = spacing[i];
+    header->Origin[i] = origin[i];
+  }
+  for (int i = 0; i < 9; ++i)
+  {
+    header->Directions[i] = directions[i];
+  }
+  header->ScalarType = scalarType;
+  header->NumberOfComponents = numberOfComponents;
+  header->ScalarSizeInBytes = scalarSizeInBytes;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLVolumeSharedMemoryTransfer::Open(const std::string& fileName)
+{
+  this->Close();
+  std::string segmentName = vtkMRMLVolumeSharedMemoryTransfer::GetSegmentName(fileName);
+  if (segmentName.empty())
+  {
+    vtkErrorMacro("Open: invalid shared memory file name '" << fileName << "'");
+    return false;
+  }
+
+#ifdef _WIN32
+  vtkErrorMacro("Open: shared memory images are not supported on this platform");
+  return false;
+#else
+  int fileDescriptor = shm_open(segmentName.c_str(), O_RDONLY, 0);
+  if (fileDescriptor < 0)
+  {
+    // Not an error, the caller may just check if the segment exists
+    vtkDebugMacro("Open: shared memory segment '" << segmentName << "' does not exist");
+    return false;
+  }
+  struct stat segmentStat;
+  if (fstat(fileDescriptor, &segmentStat) != 0 || static_cast<size_t>(segmentStat.st_size) < SharedMemoryImageDataOffset)
+  {
+    vtkErrorMacro("Open: shared memory segment '" << segmentName << "' does not contain an image");
+    close(fileDescriptor);
+    return false;
+  }
+  size_t mappedSize = static_cast<size_t>(segmentStat.st_size);
+  void* mappedMemory = mmap(nullptr, mappedSize, PROT_READ, MAP_SHARED, fileDescriptor, 0);
+  close(fileDescriptor);
+  if (mappedMemory == MAP_FAILED)
+  {
+    vtkErrorMacro("Open: failed to map shared memory segment '" << segmentName << "'");
+    return false;
+  }
+  const SharedMemoryImageHeader* header = static_cast<const SharedMemoryImageHeader*>(mappedMemory);
+  if (memcmp(header->Magic, SharedMemoryImageMagic, sizeof(header->Magic)) != 0 //
+      || header->Version != SharedMemoryImageVersion                           //
+      || SharedMemoryImageDataOffset + header->ScalarSizeInBytes > mappedSize)
+  {
+    vtkErrorMacro("Open: shared memory segment '" << segmentName << "' does not contain a valid image");
+    munmap(mappedMemory, mappedSize);
+    return false;
+  }
+  this->MappedMemory = mappedMemory;
+  this->MappedSize = mappedSize;
+  this->FileName = fileName;
+  return true;
+#endif
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeSharedMemoryTransfer::Close()
+{
+  if (!this->MappedMemory)
+  {
+    return;
+  }
+#ifndef _WIN32
+  munmap(this->MappedMemory, this->MappedSize);
+#endif
+  this->MappedMemory = nullptr;
+  this->MappedSize = 0;
+  this->FileName.clear();
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLVolumeSharedMemoryTransfer::IsOpen() const
+{
+  return this->MappedMemory != nullptr;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeSharedMemoryTransfer::GetDimensions(int dimensions[3]) const
+{
+  const SharedMemoryImageHeader* header = static_cast<const SharedMemoryImageHeader*>(this->MappedMemory);
+  for (int i = 0; i < 3; ++i)
+  {
+    dimensions[i] = header ? header->Dimensions[i] : 0;
+  }
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLVolumeSharedMemoryTransfer::GetScalarType() const
+{
+  const SharedMemoryImageHeader* header = static_cast<const SharedMemoryImageHeader*>(this->MappedMemory);
+  return header ? header->ScalarType : VTK_VOID;
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLVolumeSharedMemoryTransfer::GetNumberOfComponents() const
+{
+  const SharedMemoryImageHeader* header = static_cast<const SharedMemoryImageHeader*>(this->MappedMemory);
+  return header ? header->NumberOfComponents : 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeSharedMemoryTransfer::GetSpacing(double spacing[3]) const
+{
+  const SharedMemoryImageHeader* header = static_cast<const SharedMemoryImageHeader*>(this->MappedMemory);
+  for (int i = 0; i < 3; ++i)
+  {
+    spacing[i] = header ? header->Spacing[i] : 1.0;
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeSharedMemoryTransfer::GetOrigin(double origin[3]) const
+{
+  const SharedMemoryImageHeader* header = static_cast<const SharedMemoryImageHeader*>(this->MappedMemory);
+  for (int i = 0; i < 3; ++i)
+  {
+    origin[i] = header ? header->Origin[i] : 0.0;
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeSharedMemoryTransfer::GetDirections(double directions[9]) const
+{
+  const SharedMemoryImageHeader* header = static_cast<const SharedMemoryImageHeader*>(this->MappedMemory);
+  for (int i = 0; i < 9; ++i)
+  {
+    if (header)
+    {
+      directions[i] = header->Directions[i];
+    }
+    else
+    {
+      directions[i] = (i % 4 == 0) ? 1.0 : 0.0;
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+void* vtkMRMLVolumeSharedMemoryTransfer::GetScalarPointer() const
+{
+  if (!this->MappedMemory)
+  {
+    return nullptr;
+  }
+  return static_cast<char*>(this->MappedMemory) + SharedMemoryImageDataOffset;
+}
+
+//----------------------------------------------------------------------------
+size_t vtkMRMLVolumeSharedMemoryTransfer::GetScalarSizeInBytes() const
+{
+  const SharedMemoryImageHeader* header = static_cast<const SharedMemoryImageHeader*>(this->MappedMemory);
+  return header ? static_cast<size_t>(header->ScalarSizeInBytes) : 0;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLVolumeSharedMemoryTransfer::WriteVolumeNode(vtkMRMLVolumeNode* volumeNode, std::string& fileName)
+{
+  if (!volumeNode || !volumeNode->GetImageData() || !volumeNode->GetImageData()->GetPointData()->GetScalars())
+  {
+    vtkGenericWarningMacro("vtkMRMLVolumeSharedMemoryTransfer::WriteVolumeNode failed: invalid volume node or empty image data");
+    return false;
+  }
+  vtkImageData* imageData = volumeNode->GetImageData();
+
+  // Split IJK to RAS matrix into spacing, origin, and unit directions in LPS coordinate system
+  vtkNew<vtkMatrix4x4> ijkToRas;
+  volumeNode->GetIJKToRASMatrix(ijkToRas);
+  double spacing[3] = { 1.0, 1.0, 1.0 };
+  double origin[3] = { 0.0, 0.0, 0.0 };
+  double directions[9] = { 0.0 };
+  for (int column = 0; column < 3; ++column)
+  {
+    double columnLength = 0.0;
+    for (int row = 0; row < 3; ++row)
+    {
+      columnLength += ijkToRas->GetElement(row, column) * ijkToRas->GetElement(row, column);
+    }
+    columnLength = sqrt(columnLength);
+    spacing[column] = (columnLength > 0.0 ? columnLength : 1.0);
+    for (int row = 0; row < 3; ++row)
+    {
+      double rasToLpsSign = (row < 2 ? -1.0 : 1.0);
+      directions[row * 3 + column] = rasToLpsSign * ijkToRas->GetElement(row, column) / spacing[column];
+    }
+  }
+  for (int row = 0; row < 3; ++row)
+  {
+    double rasToLpsSign = (row < 2 ? -1.0 : 1.0);
+    origin[row] = rasToLpsSign * ijkToRas->GetElement(row, 3);
+  }
+
+  vtkNew<vtkMRMLVolumeSharedMemoryTransfer> transfer;
+  if (!transfer->CreateUnique(
+        fileName, imageData->GetDimensions(), imageData->GetScalarType(), imageData->GetNumberOfScalarComponents(), spacing, origin, directions))
+  {
+    return false;
+  }
+  memcpy(transfer->GetScalarPointer(), imageData->GetScalarPointer(), transfer->GetScalarSizeInBytes());
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLVolumeSharedMemoryTransfer::ReadVolumeNode(vtkMRMLVolumeNode* volumeNode, const std::string& fileName)
+{
+  if (!volumeNode)
+  {
+    vtkGenericWarningMacro("vtkMRMLVolumeSharedMemoryTransfer::ReadVolumeNode failed: invalid volume node");
+    return false;
+  }
+  vtkNew<vtkMRMLVolumeSharedMemoryTransfer> transfer;
+  if (!transfer->Open(fileName))
+  {
+    vtkGenericWarningMacro("vtkMRMLVolumeSharedMemoryTransfer::ReadVolumeNode failed: cannot open shared memory image '" << fileName << "'");
+    return false;
+  }
+
+  int dimensions[3] = { 0, 0, 0 };
+  transfer->GetDimensions(dimensions);
+  vtkNew<vtkImageData> imageData;
+  imageData->SetDimensions(dimensions);
+  imageData->AllocateScalars(transfer->GetScalarType(), transfer->GetNumberOfComponents());
+  size_t imageSizeInBytes = static_cast<size_t>(imageData->GetNumberOfPoints()) * imageData->GetNumberOfScalarComponents() * imageData->GetScalarSize();
+  if (imageSizeInBytes != transfer->GetScalarSizeInBytes())
+  {
+    vtkGenericWarningMacro("vtkMRMLVolumeSharedMemoryTransfer::ReadVolumeNode failed: inconsistent image size in '" << fileName << "'");
+    return false;
+  }
+  memcpy(imageData->GetScalarPointer(), transfer->GetScalarPointer(), imageSizeInBytes);
+
+  // Compose IJK to RAS matrix from spacing, origin, and unit directions in LPS coordinate system
+  double spacing[3] = { 1.0, 1.0, 1.0 };
+  double origin[3] = { 0.0, 0.0, 0.0 };
+  double directions[9] = { 0.0 };
+  transfer->GetSpacing(spacing);
+  transfer->GetOrigin(origin);
+  transfer->GetDirections(directions);
+  vtkNew<vtkMatrix4x4> ijkToRas;
+  for (int row = 0; row < 3; ++row)
+  {
+    double lpsToRasSign = (row < 2 ? -1.0 : 1.0);
+    for (int column = 0; column < 3; ++column)
+    {
+      ijkToRas->SetElement(row, column, lpsToRasSign * directions[row * 3 + column] * spacing[column]);
+    }
+    ijkToRas->SetElement(row, 3, lpsToRasSign * origin[row]);
+  }
+
+  int wasModified = volumeNode->StartModify();
+  volumeNode->SetIJKToRASMatrix(ijkToRas);
+  volumeNode->SetAndObserveImageData(imageData);
+  volumeNode->EndModify(wasModified);
+  return true;
+}
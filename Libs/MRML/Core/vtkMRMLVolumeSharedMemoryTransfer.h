@@ -0,0 +1,143 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+#ifndef __vtkMRMLVolumeSharedMemoryTransfer_h
+#define __vtkMRMLVolumeSharedMemoryTransfer_h
+
+// MRML includes
+#include "vtkMRML.h"
+
+// VTK includes
+#include <vtkObject.h>
+
+// STD includes
+#include <string>
+
+class vtkMRMLVolumeNode;
+
+/// \brief Transfer volumes between processes through named shared memory segments.
+///
+/// A shared memory image is referred to by a file name of the form <code>shm:\<segment name\></code>,
+/// which can be passed to an out-of-process module on its command line instead of a temporary file name.
+/// The segment contains a fixed-size header (dimensions, scalar type, number of components, and
+/// spacing, origin, and axis directions in LPS coordinate system) followed by the raw voxel data.
+/// Therefore a volume can be transferred without any encoding, compression, or disk access.
+///
+/// The module logic uses this class to write input volumes and read back output volumes, while
+/// itk::MRMLSharedMemoryImageIO uses it to read and write the same segments in the module process.
+///
+/// Shared memory segments are only available on POSIX systems, see IsSupported().
+/// Segments persist until RemoveSharedMemory() is called, even after all processes unmapped them.
+class VTK_MRML_EXPORT vtkMRMLVolumeSharedMemoryTransfer : public vtkObject
+{
+public:
+  static vtkMRMLVolumeSharedMemoryTransfer* New();
+  vtkTypeMacro(vtkMRMLVolumeSharedMemoryTransfer, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Returns true if shared memory segments can be used on this platform.
+  static bool IsSupported();
+
+  /// Returns true if the file name refers to a shared memory image (starts with "shm:").
+  static bool IsSharedMemoryFileName(const std::string& fileName);
+
+  /// Returns a new shared memory image file name that is unique on this computer.
+  /// The name is kept short to be valid on all platforms.
+  static std::string CreateUniqueFileName();
+
+  /// Remove a shared memory segment. The memory is released when the last mapping is closed.
+  /// Returns false if the segment could not be removed (for example, it did not exist).
+  static bool RemoveSharedMemory(const std::string& fileName);
+
+  /// Create a new shared memory segment for an image and map it for writing.
+  /// An existing segment with the same name is overwritten.
+  /// Geometry is specified in LPS coordinate system. directions is a row-major 3x3 matrix,
+  /// its columns are the unit direction vectors of the image axes.
+  bool Create(const std::string& fileName,
+              const int dimensions[3],
+              int scalarType,
+              int numberOfComponents,
+              const double spacing[3],
+              const double origin[3],
+              const double directions[9]);
+
+  /// Create a shared memory segment for an image and map it for writing, without ever
+  /// reusing an existing segment. If a segment with the name already exists (for example,
+  /// left behind by a crashed process or created by another process) then a new name is
+  /// generated by CreateUniqueFileName() and creation is retried.
+  /// fileName is updated to the name of the created segment.
+  bool CreateUnique(std::string& fileName,
+                    const int dimensions[3],
+                    int scalarType,
+                    int numberOfComponents,
+                    const double spacing[3],
+                    const double origin[3],
+                    const double directions[9]);
+
+  /// Map an existing shared memory segment for reading.
+  /// Returns false if the segment does not exist or it does not contain a valid image.
+  bool Open(const std::string& fileName);
+
+  /// Unmap the current segment. The segment itself is not removed.
+  void Close();
+
+  /// Returns true if a segment is currently mapped.
+  bool IsOpen() const;
+
+  /// Image properties of the currently mapped segment.
+  void GetDimensions(int dimensions[3]) const;
+  int GetScalarType() const;
+  int GetNumberOfComponents() const;
+  void GetSpacing(double spacing[3]) const;
+  void GetOrigin(double origin[3]) const;
+  void GetDirections(double directions[9]) const;
+
+  /// Pointer to the voxel data of the currently mapped segment.
+  /// The memory must not be modified if the segment was mapped by Open().
+  void* GetScalarPointer() const;
+  size_t GetScalarSizeInBytes() const;
+
+  /// Write image data and geometry of a volume node into a new shared memory segment.
+  /// Existing segments are not overwritten: if the name is already taken then the image
+  /// is written into a segment with a new unique name and fileName is updated accordingly.
+  static bool WriteVolumeNode(vtkMRMLVolumeNode* volumeNode, std::string& fileName);
+
+  /// Replace image data and geometry of a volume node by the content of a shared memory segment.
+  static bool ReadVolumeNode(vtkMRMLVolumeNode* volumeNode, const std::string& fileName);
+
+protected:
+  vtkMRMLVolumeSharedMemoryTransfer();
+  ~vtkMRMLVolumeSharedMemoryTransfer() override;
+  vtkMRMLVolumeSharedMemoryTransfer(const vtkMRMLVolumeSharedMemoryTransfer&);
+  void operator=(const vtkMRMLVolumeSharedMemoryTransfer&);
+
+  /// Get segment name from shared memory image file name
+  static std::string GetSegmentName(const std::string& fileName);
+
+  /// Create and map a segment. If exclusive is true then creation fails if the segment
+  /// already exists, which is reported in segmentExists (without logging an error).
+  bool CreateSegment(const std::string& fileName,
+                     const int dimensions[3],
+                     int scalarType,
+                     int numberOfComponents,
+                     const double spacing[3],
+                     const double origin[3],
+                     const double directions[9],
+                     bool exclusive,
+                     bool* segmentExists);
+
+  void* MappedMemory{ nullptr };
+  size_t MappedSize{ 0 };
+  std::string FileName;
+};
+
+#endif
@@ -16,6 +16,7 @@
  *
  *=========================================================================*/
 #include "itkMRMLIDImageIOFactory.h"
+#include "itkMRMLSharedMemoryImageIO.h"
 #include "itkVersion.h"
 
 namespace itk
@@ -23,6 +24,11 @@ namespace itk
 MRMLIDImageIOFactory::MRMLIDImageIOFactory()
 {
   this->RegisterOverride("itkImageIOBase", "itkMRMLIDImageIO", "ImageIO to communicate directly with a MRML scene.", true, CreateObjectFunction<MRMLIDImageIO>::New());
+  this->RegisterOverride("itkImageIOBase",
+                         "itkMRMLSharedMemoryImageIO",
+                         "ImageIO to exchange images with Slicer through shared memory.",
+                         true,
+                         CreateObjectFunction<MRMLSharedMemoryImageIO>::New());
 }
 
 MRMLIDImageIOFactory::~MRMLIDImageIOFactory() = default;
@@ -34,7 +40,7 @@ const char* MRMLIDImageIOFactory::GetITKSourceVersion() const
 
 const char* MRMLIDImageIOFactory::GetDescription() const
 {
-  return "ImageIOFactory that imports/exports data to a MRML node.";
+  return "ImageIOFactory that imports/exports data to a MRML node or a shared memory image.";
 }
 
 } // end namespace itk
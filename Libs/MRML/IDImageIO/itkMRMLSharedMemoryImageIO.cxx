@@ -0,0 +1,194 @@
+/*=auto=========================================================================
+
+Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+See COPYRIGHT.txt
+or http://www.slicer.org/copyright/copyright.txt for details.
+
+Program:   3D Slicer
+
+=========================================================================auto=*/
+
+#include "itkMRMLSharedMemoryImageIO.h"
+
+// MRML includes
+#include "vtkMRMLVolumeSharedMemoryTransfer.h"
+
+// VTK includes
+#include <vtkNew.h>
+#include <vtkType.h>
+
+// STD includes
+#include <cstring>
+
+namespace itk
+{
+//----------------------------------------------------------------------------
+MRMLSharedMemoryImageIO::MRMLSharedMemoryImageIO() = default;
+
+//----------------------------------------------------------------------------
+MRMLSharedMemoryImageIO::~MRMLSharedMemoryImageIO() = default;
+
+//----------------------------------------------------------------------------
+bool MRMLSharedMemoryImageIO::CanReadFile(const char* filename)
+{
+  if (!filename || !vtkMRMLVolumeSharedMemoryTransfer::IsSharedMemoryFileName(filename))
+  {
+    return false;
+  }
+  vtkNew<vtkMRMLVolumeSharedMemoryTransfer> transfer;
+  return transfer->Open(filename);
+}
+
+//----------------------------------------------------------------------------
+void MRMLSharedMemoryImageIO::ReadImageInformation()
+{
+  vtkNew<vtkMRMLVolumeSharedMemoryTransfer> transfer;
+  if (!transfer->Open(m_FileName))
+  {
+    itkExceptionMacro("ReadImageInformation: cannot open shared memory image " << m_FileName);
+  }
+
+  // VTK is only 3D
+  this->SetNumberOfDimensions(3);
+
+  int dimensions[3] = { 0, 0, 0 };
+  double spacing[3] = { 1.0, 1.0, 1.0 };
+  double origin[3] = { 0.0, 0.0, 0.0 };
+  double directions[9] = { 0.0 };
+  transfer->GetDimensions(dimensions);
+  transfer->GetSpacing(spacing);
+  transfer->GetOrigin(origin);
+  transfer->GetDirections(directions);
+  for (unsigned int i = 0; i < 3; i++)
+  {
+    this->SetDimensions(i, dimensions[i]);
+    this->SetSpacing(i, spacing[i]);
+    this->SetOrigin(i, origin[i]);
+    std::vector<double> axisDirection(3);
+    for (unsigned int j = 0; j < 3; j++)
+    {
+      axisDirection[j] = directions[j * 3 + i];
+    }
+    this->SetDirection(i, axisDirection);
+  }
+
+  // Number of components, PixelType
+  this->SetNumberOfComponents(transfer->GetNumberOfComponents());
+  if (this->GetNumberOfComponents() == 1)
+  {
+    this->SetPixelType(CommonEnums::IOPixel::SCALAR);
+  }
+  else
+  {
+    this->SetPixelType(CommonEnums::IOPixel::VECTOR);
+  }
+
+  // ComponentType
+  CommonEnums::IOComponent componentType = CommonEnums::IOComponent::UCHAR;
+  switch (transfer->GetScalarType())
+  {
+    case VTK_FLOAT: componentType = CommonEnums::IOComponent::FLOAT; break;
+    case VTK_DOUBLE: componentType = CommonEnums::IOComponent::DOUBLE; break;
+    case VTK_INT: componentType = CommonEnums::IOComponent::INT; break;
+    case VTK_UNSIGNED_INT: componentType = CommonEnums::IOComponent::UINT; break;
+    case VTK_SHORT: componentType = CommonEnums::IOComponent::SHORT; break;
+    case VTK_UNSIGNED_SHORT: componentType = CommonEnums::IOComponent::USHORT; break;
+    case VTK_LONG: componentType = CommonEnums::IOComponent::LONG; break;
+    case VTK_UNSIGNED_LONG: componentType = CommonEnums::IOComponent::ULONG; break;
+    case VTK_LONG_LONG: componentType = CommonEnums::IOComponent::LONGLONG; break;
+    case VTK_UNSIGNED_LONG_LONG: componentType = CommonEnums::IOComponent::ULONGLONG; break;
+    case VTK_CHAR:
+    case VTK_SIGNED_CHAR: componentType = CommonEnums::IOComponent::CHAR; break;
+    case VTK_UNSIGNED_CHAR: componentType = CommonEnums::IOComponent::UCHAR; break;
+    default:
+      itkWarningMacro("Unknown scalar type.");
+      componentType = CommonEnums::IOComponent::UNKNOWNCOMPONENTTYPE;
+      break;
+  }
+  this->SetComponentType(componentType);
+}
+
+//----------------------------------------------------------------------------
+void MRMLSharedMemoryImageIO::Read(void* buffer)
+{
+  vtkNew<vtkMRMLVolumeSharedMemoryTransfer> transfer;
+  if (!transfer->Open(m_FileName))
+  {
+    itkExceptionMacro("Read: cannot open shared memory image " << m_FileName);
+  }
+  if (static_cast<size_t>(this->GetImageSizeInBytes()) != transfer->GetScalarSizeInBytes())
+  {
+    itkExceptionMacro("Read: shared memory image " << m_FileName << " size does not match the image information");
+  }
+  // buffer is preallocated, memcpy the data
+  memcpy(buffer, transfer->GetScalarPointer(), transfer->GetScalarSizeInBytes());
+}
+
+//----------------------------------------------------------------------------
+bool MRMLSharedMemoryImageIO::CanWriteFile(const char* filename)
+{
+  return filename && vtkMRMLVolumeSharedMemoryTransfer::IsSupported() //
+         && vtkMRMLVolumeSharedMemoryTransfer::IsSharedMemoryFileName(filename);
+}
+
+//----------------------------------------------------------------------------
+void MRMLSharedMemoryImageIO::WriteImageInformation() {}
+
+//----------------------------------------------------------------------------
+void MRMLSharedMemoryImageIO::Write(const void* buffer)
+{
+  if (this->GetNumberOfDimensions() > 3)
+  {
+    itkExceptionMacro("Dimension of image is too high for VTK (Dimension = " << this->GetNumberOfDimensions() << ")");
+  }
+
+  // VTK is only 3D, fill in remaining dimensions with reasonable defaults
+  int dimensions[3] = { 1, 1, 1 };
+  double spacing[3] = { 1.0, 1.0, 1.0 };
+  double origin[3] = { 0.0, 0.0, 0.0 };
+  double directions[9] = { 1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0 };
+  for (unsigned int i = 0; i < this->GetNumberOfDimensions(); i++)
+  {
+    dimensions[i] = static_cast<int>(this->GetDimensions(i));
+    spacing[i] = this->GetSpacing(i);
+    origin[i] = this->GetOrigin(i);
+    for (unsigned int j = 0; j < this->GetNumberOfDimensions(); j++)
+    {
+      directions[j * 3 + i] = this->GetDirection(i)[j];
+    }
+  }
+
+  // ComponentType
+  int scalarType = VTK_SHORT;
+  switch (this->GetComponentType())
+  {
+    case CommonEnums::IOComponent::FLOAT: scalarType = VTK_FLOAT; break;
+    case CommonEnums::IOComponent::DOUBLE: scalarType = VTK_DOUBLE; break;
+    case CommonEnums::IOComponent::INT: scalarType = VTK_INT; break;
+    case CommonEnums::IOComponent::UINT: scalarType = VTK_UNSIGNED_INT; break;
+    case CommonEnums::IOComponent::SHORT: scalarType = VTK_SHORT; break;
+    case CommonEnums::IOComponent::USHORT: scalarType = VTK_UNSIGNED_SHORT; break;
+    case CommonEnums::IOComponent::LONG: scalarType = VTK_LONG; break;
+    case CommonEnums::IOComponent::ULONG: scalarType = VTK_UNSIGNED_LONG; break;
+    case CommonEnums::IOComponent::LONGLONG: scalarType = VTK_LONG_LONG; break;
+    case CommonEnums::IOComponent::ULONGLONG: scalarType = VTK_UNSIGNED_LONG_LONG; break;
+    case CommonEnums::IOComponent::CHAR: scalarType = VTK_CHAR; break;
+    case CommonEnums::IOComponent::UCHAR: scalarType = VTK_UNSIGNED_CHAR; break;
+    default: itkExceptionMacro("Write: unsupported component type for shared memory image " << m_FileName);
+  }
+
+  vtkNew<vtkMRMLVolumeSharedMemoryTransfer> transfer;
+  if (!transfer->Create(m_FileName, dimensions, scalarType, this->GetNumberOfComponents(), spacing, origin, directions))
+  {
+    itkExceptionMacro("Write: cannot create shared memory image " << m_FileName);
+  }
+  if (static_cast<size_t>(this->GetImageSizeInBytes()) != transfer->GetScalarSizeInBytes())
+  {
+    vtkMRMLVolumeSharedMemoryTransfer::RemoveSharedMemory(m_FileName);
+    itkExceptionMacro("Write: shared memory image " << m_FileName << " size does not match the image information");
+  }
+  memcpy(transfer->GetScalarPointer(), buffer, transfer->GetScalarSizeInBytes());
+}
+
+} // end namespace itk
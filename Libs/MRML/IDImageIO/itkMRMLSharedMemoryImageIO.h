@@ -0,0 +1,85 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+#ifndef itkMRMLSharedMemoryImageIO_h
+#define itkMRMLSharedMemoryImageIO_h
+
+#ifdef _MSC_VER
+# pragma warning(disable : 4786)
+#endif
+
+#include "itkMRMLIDIOExport.h"
+
+#include "itkImageIOBase.h"
+
+namespace itk
+{
+/** \class MRMLSharedMemoryImageIO
+ * \brief ImageIO object for reading and writing images in shared memory segments
+ *
+ * MRMLSharedMemoryImageIO allows a command line module that runs in a
+ * separate process to exchange images with Slicer without writing
+ * temporary files. Slicer stores input images in named shared memory
+ * segments and passes their names to the module instead of file
+ * names. Output images are written by the module into new segments,
+ * which are then read by Slicer.
+ *
+ * The "filename" specified will look like:
+ *     <code>shm:\<segment name\></code>
+ *
+ * The segment layout is defined by vtkMRMLVolumeSharedMemoryTransfer.
+ * Only scalar and vector images are supported.
+ */
+class MRMLIDImageIO_EXPORT MRMLSharedMemoryImageIO : public ImageIOBase
+{
+public:
+  /** Standard class typedefs. */
+  typedef MRMLSharedMemoryImageIO Self;
+  typedef ImageIOBase Superclass;
+  typedef SmartPointer<Self> Pointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(MRMLSharedMemoryImageIO, ImageIOBase);
+
+  /** Determine the file type. Returns true if this ImageIO can read the
+   * file specified. */
+  bool CanReadFile(const char*) override;
+
+  /** Set the spacing and dimension information for the set filename. */
+  void ReadImageInformation() override;
+
+  /** Reads the data from shared memory into the memory buffer provided. */
+  void Read(void* buffer) override;
+
+  /*-------- This part of the interfaces deals with writing data. ----- */
+
+  /** Determine the file type. Returns true if this ImageIO can write the
+   * file specified. */
+  bool CanWriteFile(const char*) override;
+
+  /** Image information is written together with the data. */
+  void WriteImageInformation() override;
+
+  /** Writes the data to shared memory from the memory buffer provided. */
+  void Write(const void* buffer) override;
+
+protected:
+  MRMLSharedMemoryImageIO();
+  ~MRMLSharedMemoryImageIO() override;
+
+private:
+  MRMLSharedMemoryImageIO(const Self&) = delete;
+  void operator=(const Self&) = delete;
+};
+
+} // namespace itk
+#endif
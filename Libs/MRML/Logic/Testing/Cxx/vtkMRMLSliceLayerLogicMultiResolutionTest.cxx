@@ -0,0 +1,223 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRMLLogic includes
+#include "vtkMRMLSliceLayerLogic.h"
+
+// MRML includes
+#include "vtkEventBroker.h"
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLScalarVolumeDisplayNode.h"
+#include "vtkMRMLScalarVolumeNode.h"
+#include "vtkMRMLScene.h"
+#include "vtkMRMLSliceNode.h"
+
+// VTK includes
+#include <vtkCallbackCommand.h>
+#include <vtkImageData.h>
+#include <vtkImageReslice.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+
+// STD includes
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Minimal implementation of the application's request modified mechanism:
+// requests may come from any thread, they are processed on the main thread.
+std::mutex RequestedObjectsMutex;
+std::vector<vtkObject*> RequestedObjects;
+
+//----------------------------------------------------------------------------
+void RequestModifiedCallback(vtkObject* vtkNotUsed(caller), unsigned long vtkNotUsed(eid), void* vtkNotUsed(clientData), void* callData)
+{
+  vtkObject* object = reinterpret_cast<vtkObject*>(callData);
+  object->Register(nullptr);
+  std::lock_guard<std::mutex> lock(RequestedObjectsMutex);
+  RequestedObjects.push_back(object);
+}
+
+//----------------------------------------------------------------------------
+void ProcessModifiedRequests()
+{
+  std::vector<vtkObject*> requestedObjects;
+  {
+    std::lock_guard<std::mutex> lock(RequestedObjectsMutex);
+    requestedObjects.swap(RequestedObjects);
+  }
+  for (vtkObject* object : requestedObjects)
+  {
+    object->Modified();
+    object->UnRegister(nullptr);
+  }
+}
+
+//----------------------------------------------------------------------------
+void CountModifiedCallback(vtkObject* vtkNotUsed(caller), unsigned long vtkNotUsed(eid), void* clientData, void* vtkNotUsed(callData))
+{
+  int* modifiedCount = reinterpret_cast<int*>(clientData);
+  (*modifiedCount)++;
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLScalarVolumeNode* AddVolumeNode(vtkMRMLScene* scene)
+{
+  vtkNew<vtkImageData> imageData;
+  imageData->SetDimensions(128, 128, 128);
+  imageData->AllocateScalars(VTK_SHORT, 1);
+  imageData->GetPointData()->GetScalars()->Fill(100);
+
+  vtkNew<vtkMRMLScalarVolumeDisplayNode> displayNode;
+  scene->AddNode(displayNode);
+  vtkNew<vtkMRMLScalarVolumeNode> volumeNode;
+  volumeNode->SetAndObserveImageData(imageData);
+  scene->AddNode(volumeNode);
+  volumeNode->SetAndObserveDisplayNodeID(displayNode->GetID());
+  return volumeNode;
+}
+
+//----------------------------------------------------------------------------
+/// Process modified requests until the layer uses a downsampled image or the timeout expires.
+/// Returns the number of times the layer logic was modified meanwhile.
+int WaitForDownsampledImage(vtkMRMLSliceLayerLogic* layerLogic)
+{
+  int modifiedCount = 0;
+  vtkNew<vtkCallbackCommand> countModified;
+  countModified->SetCallback(CountModifiedCallback);
+  countModified->SetClientData(&modifiedCount);
+  layerLogic->AddObserver(vtkCommand::ModifiedEvent, countModified);
+  for (int i = 0; i < 1000 && layerLogic->GetMultiResolutionLevel() == 0; ++i)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    ProcessModifiedRequests();
+  }
+  layerLogic->RemoveObserver(countModified);
+  return modifiedCount;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkMRMLSliceLayerLogicMultiResolutionTest(int, char*[])
+{
+  vtkNew<vtkCallbackCommand> requestModifiedCallback;
+  requestModifiedCallback->SetCallback(RequestModifiedCallback);
+  vtkEventBroker::GetInstance()->SetRequestModifiedCallback(requestModifiedCallback);
+
+  vtkNew<vtkMRMLScene> scene;
+  vtkMRMLScalarVolumeNode* volumeNode = AddVolumeNode(scene);
+  vtkMRMLScalarVolumeNode* volumeNode2 = AddVolumeNode(scene);
+
+  // Slice view pixel size is 2mm, which corresponds to pyramid level 1
+  vtkNew<vtkMRMLSliceNode> sliceNode;
+  sliceNode->SetLayoutName("Red");
+  scene->AddNode(sliceNode);
+  sliceNode->SetDimensions(128, 128, 1);
+  sliceNode->SetFieldOfView(256.0, 256.0, 1.0);
+  sliceNode->UpdateMatrices();
+
+  vtkNew<vtkMRMLSliceLayerLogic> layerLogic;
+  layerLogic->SetMRMLScene(scene);
+  layerLogic->SetSliceNode(sliceNode);
+  layerLogic->SetVolumeNode(volumeNode);
+  layerLogic->MultiResolutionOn();
+  CHECK_INT(layerLogic->GetMultiResolutionLevel(), 0);
+  CHECK_POINTER(layerLogic->GetReslice()->GetInput(), volumeNode->GetImageData());
+
+  // Pyramid computation is started when the view is interacted with.
+  // Full resolution image is used until the pyramid is ready, then the layer is modified to trigger rendering.
+  sliceNode->InteractingOn();
+  layerLogic->UpdateTransforms();
+  CHECK_INT(layerLogic->GetMultiResolutionLevel(), 0);
+  CHECK_BOOL(WaitForDownsampledImage(layerLogic) > 0, true);
+  CHECK_INT(layerLogic->GetMultiResolutionLevel(), 1);
+  vtkImageData* downsampledImage = vtkImageData::SafeDownCast(layerLogic->GetReslice()->GetInput());
+  CHECK_NOT_NULL(downsampledImage);
+  CHECK_INT(downsampledImage->GetDimensions()[0], 64);
+  CHECK_DOUBLE_TOLERANCE(downsampledImage->GetSpacing()[0], 2.0, 1e-6);
+
+  // Full resolution image is used when interaction is completed
+  sliceNode->InteractingOff();
+  layerLogic->UpdateTransforms();
+  CHECK_INT(layerLogic->GetMultiResolutionLevel(), 0);
+  CHECK_POINTER(layerLogic->GetReslice()->GetInput(), volumeNode->GetImageData());
+
+  // Cached pyramid is used immediately
+  sliceNode->InteractingOn();
+  layerLogic->UpdateTransforms();
+  CHECK_INT(layerLogic->GetMultiResolutionLevel(), 1);
+
+  // Pyramid is recomputed if the image is modified
+  volumeNode->GetImageData()->GetPointData()->GetScalars()->Fill(200);
+  volumeNode->GetImageData()->Modified();
+  layerLogic->UpdateTransforms();
+  CHECK_INT(layerLogic->GetMultiResolutionLevel(), 0);
+  CHECK_BOOL(WaitForDownsampledImage(layerLogic) > 0, true);
+  CHECK_INT(layerLogic->GetMultiResolutionLevel(), 1);
+  downsampledImage = vtkImageData::SafeDownCast(layerLogic->GetReslice()->GetInput());
+  CHECK_DOUBLE_TOLERANCE(downsampledImage->GetScalarComponentAsDouble(10, 10, 10, 0), 200.0, 1e-6);
+
+  // Pyramids of multiple images are cached
+  CHECK_BOOL(vtkMRMLSliceLayerLogic::GetMultiResolutionCacheSize() > 0, true);
+  vtkTypeInt64 defaultCacheSize = vtkMRMLSliceLayerLogic::GetMultiResolutionCacheSize();
+  layerLogic->SetVolumeNode(volumeNode2);
+  layerLogic->UpdateTransforms();
+  CHECK_BOOL(WaitForDownsampledImage(layerLogic) > 0, true);
+  layerLogic->SetVolumeNode(volumeNode);
+  layerLogic->UpdateTransforms();
+  CHECK_INT(layerLogic->GetMultiResolutionLevel(), 1);
+
+  // Pyramids that do not fit in the cache are removed, only the last computed pyramid is kept
+  vtkMRMLSliceLayerLogic::SetMultiResolutionCacheSize(1);
+  layerLogic->SetVolumeNode(volumeNode2);
+  layerLogic->UpdateTransforms();
+  CHECK_INT(layerLogic->GetMultiResolutionLevel(), 0);
+  CHECK_BOOL(WaitForDownsampledImage(layerLogic) > 0, true);
+  layerLogic->SetVolumeNode(volumeNode);
+  layerLogic->UpdateTransforms();
+  CHECK_INT(layerLogic->GetMultiResolutionLevel(), 0);
+  CHECK_BOOL(WaitForDownsampledImage(layerLogic) > 0, true);
+  CHECK_INT(layerLogic->GetMultiResolutionLevel(), 1);
+  layerLogic->SetVolumeNode(volumeNode2);
+  layerLogic->UpdateTransforms();
+  CHECK_INT(layerLogic->GetMultiResolutionLevel(), 0);
+  vtkMRMLSliceLayerLogic::SetMultiResolutionCacheSize(defaultCacheSize);
+
+  // Layer logic is deleted while the pyramid is being computed, another logic computes it then
+  vtkMRMLScalarVolumeNode* volumeNode3 = AddVolumeNode(scene);
+  {
+    vtkNew<vtkMRMLSliceLayerLogic> pendingLayerLogic;
+    pendingLayerLogic->SetMRMLScene(scene);
+    pendingLayerLogic->SetSliceNode(sliceNode);
+    pendingLayerLogic->SetVolumeNode(volumeNode3);
+    pendingLayerLogic->MultiResolutionOn();
+    pendingLayerLogic->UpdateTransforms();
+    CHECK_INT(pendingLayerLogic->GetMultiResolutionLevel(), 0);
+  }
+  layerLogic->SetVolumeNode(volumeNode3);
+  layerLogic->UpdateTransforms();
+  CHECK_INT(layerLogic->GetMultiResolutionLevel(), 0);
+  CHECK_BOOL(WaitForDownsampledImage(layerLogic) > 0, true);
+  CHECK_INT(layerLogic->GetMultiResolutionLevel(), 1);
+
+  sliceNode->InteractingOff();
+  vtkEventBroker::GetInstance()->SetRequestModifiedCallback(nullptr);
+  ProcessModifiedRequests();
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
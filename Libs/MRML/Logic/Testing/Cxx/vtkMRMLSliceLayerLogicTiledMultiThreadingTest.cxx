@@ -0,0 +1,197 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRMLLogic includes
+#include "vtkImageLabelOutline.h"
+#include "vtkMRMLSliceLayerLogic.h"
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+
+// VTK includes
+#include <vtkCallbackCommand.h>
+#include <vtkImageData.h>
+#include <vtkImageReslice.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkTransform.h>
+
+// STD includes
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Labelmap with random boxes of different labels
+void CreateLabelmap(vtkImageData* labelmap)
+{
+  const int dimensions[3] = { 301, 257, 3 };
+  labelmap->SetDimensions(dimensions[0], dimensions[1], dimensions[2]);
+  labelmap->AllocateScalars(VTK_SHORT, 1);
+  labelmap->GetPointData()->GetScalars()->Fill(0);
+  vtkMath::RandomSeed(42);
+  for (int boxIndex = 0; boxIndex < 40; ++boxIndex)
+  {
+    short label = static_cast<short>(boxIndex % 5 + 1);
+    int extent[6] = { 0, 0, 0, 0, 0, dimensions[2] - 1 };
+    for (int axis = 0; axis < 2; ++axis)
+    {
+      extent[axis * 2] = static_cast<int>(vtkMath::Random(-10.0, dimensions[axis] - 1));
+      extent[axis * 2 + 1] = extent[axis * 2] + static_cast<int>(vtkMath::Random(1.0, 60.0));
+    }
+    for (int k = extent[4]; k <= extent[5]; ++k)
+    {
+      for (int j = std::max(extent[2], 0); j <= std::min(extent[3], dimensions[1] - 1); ++j)
+      {
+        for (int i = std::max(extent[0], 0); i <= std::min(extent[1], dimensions[0] - 1); ++i)
+        {
+          *static_cast<short*>(labelmap->GetScalarPointer(i, j, k)) = label;
+        }
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+bool IsImageDataEqual(vtkImageData* image1, vtkImageData* image2)
+{
+  int extent1[6] = { 0, -1, 0, -1, 0, -1 };
+  int extent2[6] = { 0, -1, 0, -1, 0, -1 };
+  image1->GetExtent(extent1);
+  image2->GetExtent(extent2);
+  if (!std::equal(extent1, extent1 + 6, extent2))
+  {
+    std::cerr << "Image extents are different" << std::endl;
+    return false;
+  }
+  if (image1->GetScalarType() != image2->GetScalarType() //
+      || image1->GetNumberOfScalarComponents() != image2->GetNumberOfScalarComponents())
+  {
+    std::cerr << "Image scalar types are different" << std::endl;
+    return false;
+  }
+  size_t imageSize = static_cast<size_t>(image1->GetNumberOfPoints()) * image1->GetNumberOfScalarComponents() * image1->GetScalarSize();
+  if (memcmp(image1->GetScalarPointer(), image2->GetScalarPointer(), imageSize) != 0)
+  {
+    std::cerr << "Image voxels are different" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void ProgressCallback(vtkObject* caller, unsigned long, void* clientData, void*)
+{
+  vtkAlgorithm* algorithm = vtkAlgorithm::SafeDownCast(caller);
+  double* maximumProgress = static_cast<double*>(clientData);
+  *maximumProgress = std::max(*maximumProgress, algorithm->GetProgress());
+}
+
+//----------------------------------------------------------------------------
+int TestLabelOutline(vtkImageData* labelmap)
+{
+  vtkNew<vtkImageLabelOutline> serialOutline;
+  serialOutline->SetInputData(labelmap);
+  serialOutline->SetOutline(2);
+  vtkMRMLSliceLayerLogic::ConfigureTiledMultiThreading(serialOutline, false);
+  serialOutline->SetNumberOfThreads(1);
+  serialOutline->Update();
+
+  vtkNew<vtkImageLabelOutline> tiledOutline;
+  tiledOutline->SetInputData(labelmap);
+  tiledOutline->SetOutline(2);
+  vtkMRMLSliceLayerLogic::ConfigureTiledMultiThreading(tiledOutline, true);
+  CHECK_BOOL(tiledOutline->GetEnableSMP(), true);
+  double maximumProgress = 0.0;
+  vtkNew<vtkCallbackCommand> progressCallback;
+  progressCallback->SetCallback(ProgressCallback);
+  progressCallback->SetClientData(&maximumProgress);
+  tiledOutline->AddObserver(vtkCommand::ProgressEvent, progressCallback);
+  tiledOutline->Update();
+
+  CHECK_BOOL(IsImageDataEqual(serialOutline->GetOutput(), tiledOutline->GetOutput()), true);
+
+  // Progress is reported from all tiles, not just from the first one
+  CHECK_DOUBLE_TOLERANCE(maximumProgress, 1.0, 1e-6);
+
+  // Multi-threading with slabs gives the same result
+  vtkMRMLSliceLayerLogic::ConfigureTiledMultiThreading(tiledOutline, false);
+  tiledOutline->SetNumberOfThreads(4);
+  tiledOutline->Update();
+  CHECK_BOOL(IsImageDataEqual(serialOutline->GetOutput(), tiledOutline->GetOutput()), true);
+
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestReslice(vtkImageData* labelmap, int interpolationMode)
+{
+  // Oblique slice that is partially outside of the volume
+  vtkNew<vtkTransform> resliceTransform;
+  resliceTransform->Translate(100.0, 80.0, 1.0);
+  resliceTransform->RotateZ(30.0);
+  resliceTransform->RotateX(20.0);
+
+  vtkNew<vtkImageReslice> serialReslice;
+  vtkNew<vtkImageReslice> tiledReslice;
+  for (vtkImageReslice* reslice : { serialReslice.GetPointer(), tiledReslice.GetPointer() })
+  {
+    reslice->SetInputData(labelmap);
+    reslice->SetResliceTransform(resliceTransform);
+    reslice->SetInterpolationMode(interpolationMode);
+    reslice->SetOutputDimensionality(2);
+    reslice->SetOutputExtent(0, 399, 0, 299, 0, 0);
+    reslice->SetOutputSpacing(0.7, 0.7, 1.0);
+    reslice->SetBackgroundLevel(0.0);
+  }
+  vtkMRMLSliceLayerLogic::ConfigureTiledMultiThreading(serialReslice, false);
+  serialReslice->SetNumberOfThreads(1);
+  serialReslice->Update();
+  vtkMRMLSliceLayerLogic::ConfigureTiledMultiThreading(tiledReslice, true);
+  tiledReslice->Update();
+
+  CHECK_BOOL(IsImageDataEqual(serialReslice->GetOutput(), tiledReslice->GetOutput()), true);
+
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestSliceLayerLogic()
+{
+  vtkNew<vtkMRMLSliceLayerLogic> logic;
+  CHECK_BOOL(logic->GetTiledMultiThreading(), true);
+  CHECK_BOOL(logic->GetReslice()->GetEnableSMP(), true);
+  CHECK_BOOL(logic->GetResliceUVW()->GetEnableSMP(), true);
+  logic->TiledMultiThreadingOff();
+  CHECK_BOOL(logic->GetReslice()->GetEnableSMP(), false);
+  CHECK_BOOL(logic->GetResliceUVW()->GetEnableSMP(), false);
+  return EXIT_SUCCESS;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkMRMLSliceLayerLogicTiledMultiThreadingTest(int, char*[])
+{
+  vtkNew<vtkImageData> labelmap;
+  CreateLabelmap(labelmap);
+
+  CHECK_EXIT_SUCCESS(TestLabelOutline(labelmap));
+  CHECK_EXIT_SUCCESS(TestReslice(labelmap, VTK_RESLICE_NEAREST));
+  CHECK_EXIT_SUCCESS(TestReslice(labelmap, VTK_RESLICE_LINEAR));
+  CHECK_EXIT_SUCCESS(TestSliceLayerLogic());
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
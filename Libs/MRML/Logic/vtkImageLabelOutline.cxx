@@ -17,9 +17,13 @@
 #include <vtkInformation.h>
 #include "vtkObjectFactory.h"
 #include "vtkImageData.h"
+#include <vtkInformationVector.h>
 #include <vtkStreamingDemandDrivenPipeline.h>
 #include <vtkVersion.h>
 
+// STD includes
+#include <algorithm>
+
 //------------------------------------------------------------------------------
 vtkStandardNewMacro(vtkImageLabelOutline);
 
@@ -32,6 +36,9 @@ vtkImageLabelOutline::vtkImageLabelOutline()
   this->Background = 0;
   this->HandleBoundaries = 1;
   this->SetNeighborTo8();
+  this->NumberOfRowsToProcess = 1;
+  this->NumberOfProcessedRows = 0;
+  this->ProgressStep = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -41,7 +48,7 @@ vtkImageLabelOutline::~vtkImageLabelOutline() = default;
 // Description:
 // This templated function executes the filter for any type of data.
 template <class T>
-static void vtkImageLabelOutlineExecute(vtkImageLabelOutline* self, vtkImageData* inData, T* vtkNotUsed(inPtr), vtkImageData* outData, int outExt[6], int id)
+static void vtkImageLabelOutlineExecute(vtkImageLabelOutline* self, vtkImageData* inData, T* vtkNotUsed(inPtr), vtkImageData* outData, int outExt[6])
 {
   int *kernelMiddle, *kernelSize;
   // For looping though output (and input) pixels.
@@ -62,8 +69,6 @@ static void vtkImageLabelOutlineExecute(vtkImageLabelOutline* self, vtkImageData
   T backgroundLabelValue = (T)(self->GetBackground());
   T inLabelValue;
   T* outPtr = (T*)outData->GetScalarPointerForExtent(outExt);
-  unsigned long count = 0;
-  unsigned long target;
 
   // Get information to march through data
 
@@ -103,9 +108,6 @@ static void vtkImageLabelOutlineExecute(vtkImageLabelOutline* self, vtkImageData
   hoodMax2 = 0;
 
   // in and out should be marching through corresponding pixels.
-  target = (unsigned long)((outMax2 - outMin2 + 1) * (outMax1 - outMin1 + 1) / 50.0);
-  target++;
-
   // loop through pixels of output
   outPtr2 = outPtr;
   inPtr2 = (T*)(inData->GetScalarPointer(outMin0, outMin1, outMin2));
@@ -115,14 +117,6 @@ static void vtkImageLabelOutlineExecute(vtkImageLabelOutline* self, vtkImageData
     inPtr1 = inPtr2;
     for (outIdx1 = outMin1; !self->AbortExecute && outIdx1 <= outMax1; outIdx1++)
     {
-      if (!id)
-      {
-        if (!(count % target))
-        {
-          self->UpdateProgress(count / (50.0 * target));
-        }
-        count++;
-      }
       outPtr0 = outPtr1;
       inPtr0 = inPtr1;
       for (outIdx0 = outMin0; outIdx0 <= outMax0; outIdx0++)
@@ -185,19 +179,51 @@ static void vtkImageLabelOutlineExecute(vtkImageLabelOutline* self, vtkImageData
       } // for0
       inPtr1 += inInc1;
       outPtr1 += outInc1;
+      // Pieces are processed in parallel, therefore progress is counted in all threads
+      self->UpdateProgressForProcessedRows(1);
     } // for1
     inPtr2 += inInc2;
     outPtr2 += outInc2;
   } // for2
 }
 
+//----------------------------------------------------------------------------
+int vtkImageLabelOutline::RequestData(vtkInformation* request, vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+{
+  int outExt[6] = { 0, -1, 0, -1, 0, -1 };
+  outputVector->GetInformationObject(0)->Get(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), outExt);
+  this->NumberOfRowsToProcess = std::max<vtkIdType>(1, static_cast<vtkIdType>(outExt[3] - outExt[2] + 1) * (outExt[5] - outExt[4] + 1));
+  this->NumberOfProcessedRows = 0;
+  this->ProgressStep = 0;
+  return this->Superclass::RequestData(request, inputVector, outputVector);
+}
+
+//----------------------------------------------------------------------------
+void vtkImageLabelOutline::UpdateProgressForProcessedRows(vtkIdType numberOfRows)
+{
+  vtkIdType processedRows = (this->NumberOfProcessedRows += numberOfRows);
+  // Progress is reported in 2% steps, by the thread that completes the step
+  int progressStep = static_cast<int>(std::min<vtkIdType>(processedRows * 50 / this->NumberOfRowsToProcess, 50));
+  int lastProgressStep = this->ProgressStep;
+  while (progressStep > lastProgressStep)
+  {
+    if (this->ProgressStep.compare_exchange_weak(lastProgressStep, progressStep))
+    {
+      // Observers are not invoked concurrently and they never see decreasing progress
+      std::lock_guard<std::mutex> lock(this->ProgressMutex);
+      this->UpdateProgress(this->ProgressStep / 50.0);
+      break;
+    }
+  }
+}
+
 //----------------------------------------------------------------------------
 // Description:
 // This method is passed a input and output data, and executes the filter
 // algorithm to fill the output from the input.
 // It just executes a switch statement to call the correct function for
 // the data data types.
-void vtkImageLabelOutline::ThreadedExecute(vtkImageData* inData, vtkImageData* outData, int outExt[6], int id)
+void vtkImageLabelOutline::ThreadedExecute(vtkImageData* inData, vtkImageData* outData, int outExt[6], int vtkNotUsed(id))
 {
   int x1;
 
@@ -214,17 +240,17 @@ void vtkImageLabelOutline::ThreadedExecute(vtkImageData* inData, vtkImageData* o
 
   switch (inData->GetScalarType())
   {
-    case VTK_DOUBLE: vtkImageLabelOutlineExecute(this, inData, (double*)(inPtr), outData, outExt, id); break;
-    case VTK_FLOAT: vtkImageLabelOutlineExecute(this, inData, (float*)(inPtr), outData, outExt, id); break;
-    case VTK_LONG: vtkImageLabelOutlineExecute(this, inData, (long*)(inPtr), outData, outExt, id); break;
-    case VTK_UNSIGNED_LONG: vtkImageLabelOutlineExecute(this, inData, (unsigned long*)(inPtr), outData, outExt, id); break;
-    case VTK_INT: vtkImageLabelOutlineExecute(this, inData, (int*)(inPtr), outData, outExt, id); break;
-    case VTK_UNSIGNED_INT: vtkImageLabelOutlineExecute(this, inData, (unsigned int*)(inPtr), outData, outExt, id); break;
-    case VTK_SHORT: vtkImageLabelOutlineExecute(this, inData, (short*)(inPtr), outData, outExt, id); break;
-    case VTK_UNSIGNED_SHORT: vtkImageLabelOutlineExecute(this, inData, (unsigned short*)(inPtr), outData, outExt, id); break;
-    case VTK_CHAR: vtkImageLabelOutlineExecute(this, inData, (char*)(inPtr), outData, outExt, id); break;
-    case VTK_SIGNED_CHAR: vtkImageLabelOutlineExecute(this, inData, (signed char*)(inPtr), outData, outExt, id); break;
-    case VTK_UNSIGNED_CHAR: vtkImageLabelOutlineExecute(this, inData, (unsigned char*)(inPtr), outData, outExt, id); break;
+    case VTK_DOUBLE: vtkImageLabelOutlineExecute(this, inData, (double*)(inPtr), outData, outExt); break;
+    case VTK_FLOAT: vtkImageLabelOutlineExecute(this, inData, (float*)(inPtr), outData, outExt); break;
+    case VTK_LONG: vtkImageLabelOutlineExecute(this, inData, (long*)(inPtr), outData, outExt); break;
+    case VTK_UNSIGNED_LONG: vtkImageLabelOutlineExecute(this, inData, (unsigned long*)(inPtr), outData, outExt); break;
+    case VTK_INT: vtkImageLabelOutlineExecute(this, inData, (int*)(inPtr), outData, outExt); break;
+    case VTK_UNSIGNED_INT: vtkImageLabelOutlineExecute(this, inData, (unsigned int*)(inPtr), outData, outExt); break;
+    case VTK_SHORT: vtkImageLabelOutlineExecute(this, inData, (short*)(inPtr), outData, outExt); break;
+    case VTK_UNSIGNED_SHORT: vtkImageLabelOutlineExecute(this, inData, (unsigned short*)(inPtr), outData, outExt); break;
+    case VTK_CHAR: vtkImageLabelOutlineExecute(this, inData, (char*)(inPtr), outData, outExt); break;
+    case VTK_SIGNED_CHAR: vtkImageLabelOutlineExecute(this, inData, (signed char*)(inPtr), outData, outExt); break;
+    case VTK_UNSIGNED_CHAR: vtkImageLabelOutlineExecute(this, inData, (unsigned char*)(inPtr), outData, outExt); break;
     default: vtkErrorMacro(<< "Execute: Unknown input ScalarType"); return;
   }
 }
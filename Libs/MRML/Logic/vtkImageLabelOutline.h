@@ -19,6 +19,10 @@
 
 #include "vtkMRMLLogicExport.h"
 
+// STD includes
+#include <atomic>
+#include <mutex>
+
 class vtkImageData;
 
 /// \brief Display labelmap outlines.
@@ -42,6 +46,11 @@ public:
   void SetOutline(int outline);
   vtkGetMacro(Outline, int);
 
+  ///
+  /// Report that rows of the output image have been processed.
+  /// It is called by the execute method from all threads.
+  void UpdateProgressForProcessedRows(vtkIdType numberOfRows);
+
 protected:
   vtkImageLabelOutline();
   ~vtkImageLabelOutline() override;
@@ -49,6 +58,12 @@ protected:
   float Background;
   int Outline;
 
+  vtkIdType NumberOfRowsToProcess;
+  std::atomic<vtkIdType> NumberOfProcessedRows;
+  std::atomic<int> ProgressStep;
+  std::mutex ProgressMutex;
+
+  int RequestData(vtkInformation* request, vtkInformationVector** inputVector, vtkInformationVector* outputVector) override;
   void ThreadedExecute(vtkImageData* inData, vtkImageData* outData, int extent[6], int id) override;
 
 private:
@@ -22,6 +22,7 @@
 #include "vtkMRMLDiffusionWeightedVolumeDisplayNode.h"
 #include "vtkMRMLDiffusionTensorVolumeDisplayNode.h"
 #include "vtkMRMLDiffusionTensorVolumeSliceDisplayNode.h"
+#include "vtkEventBroker.h"
 #include "vtkMRMLScene.h"
 #include "vtkMRMLTransformNode.h"
 
@@ -29,20 +30,25 @@
 #include <vtkAlgorithm.h>
 #include <vtkAlgorithmOutput.h>
 #include <vtkAssignAttribute.h>
+#include <vtkCallbackCommand.h>
+#include <vtkDataArray.h>
 #include <vtkDiffusionTensorMathematics.h>
 #include <vtkFloatArray.h>
 #include <vtkGeneralTransform.h>
 #include <vtkImageData.h>
 #include <vtkImageReslice.h>
+#include <vtkImageShrink3D.h>
 #include <vtkInformation.h>
 #include <vtkInformationVector.h>
 #include <vtkMatrix4x4.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
 #include <vtkPointData.h>
+#include <vtkThreadedImageAlgorithm.h>
 #include <vtkTrivialProducer.h>
 #include <vtkTransform.h>
 #include <vtkVersion.h>
+#include <vtkWeakPointer.h>
 #include <vtkAddonMathUtilities.h>
 
 //
@@ -50,6 +56,13 @@
 
 // STD includes
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <future>
+#include <map>
+#include <memory>
+#include <vector>
 
 //----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkMRMLSliceLayerLogic);
@@ -100,6 +113,329 @@ void SnapToPermuteMatrix(vtkTransform* transform)
   }
 }
 
+namespace
+{
+// Pyramid levels are generated until the longest axis of the image becomes shorter than this
+const int MULTI_RESOLUTION_MINIMUM_SIZE = 64;
+
+typedef std::vector<vtkSmartPointer<vtkImageData>> ImagePyramidLevels;
+
+//----------------------------------------------------------------------------
+// Downsampled copies of an image. Levels[i] contains pyramid level i+1.
+struct ImagePyramid
+{
+  vtkWeakPointer<vtkImageData> Image;
+  vtkMTimeType ImageMTime{ 0 };
+  ImagePyramidLevels Levels;
+  /// Memory size of all levels in bytes
+  vtkTypeInt64 LevelsMemorySize{ 0 };
+  /// Used for removing the least recently used pyramids when the cache is full
+  unsigned long LastUsed{ 0 };
+
+  /// Levels are being computed by the background task of a layer logic
+  bool Pending{ false };
+
+  /// Object that is modified (on the main thread) when computed levels are stored in the pyramid.
+  /// Layer logics that use the image observe it.
+  vtkSmartPointer<vtkObject> CompletionNotifier;
+};
+
+// Pyramids are indexed by image and averaging mode.
+// They are only accessed from the main thread. Background computations are owned by
+// layer logics (vtkMRMLSliceLayerLogic::vtkMultiResolutionTask), so that they are completed
+// before the logic is deleted, and not when this cache is destroyed at application exit.
+typedef std::map<std::pair<vtkImageData*, bool>, ImagePyramid> ImagePyramidMap;
+
+//----------------------------------------------------------------------------
+ImagePyramidMap& GetImagePyramids()
+{
+  static ImagePyramidMap pyramids;
+  return pyramids;
+}
+
+//----------------------------------------------------------------------------
+vtkTypeInt64& GetImagePyramidCacheSize()
+{
+  static vtkTypeInt64 maximumCacheSize = 512 * 1024 * 1024;
+  return maximumCacheSize;
+}
+
+//----------------------------------------------------------------------------
+// Compute all pyramid levels of an image by repeatedly halving its resolution.
+// Averaging is used for scalar images, subsampling for labelmaps (to not create new label values).
+// Origin and spacing of each level are set so that physical coordinates of the levels
+// match the full resolution image, therefore the same reslice transform can be used for all levels.
+// Computation stops (and the levels computed so far are returned) if canceled is set.
+ImagePyramidLevels ComputeImagePyramidLevels(vtkSmartPointer<vtkImageData> image, bool averaging, std::shared_ptr<std::atomic<bool>> canceled)
+{
+  ImagePyramidLevels levels;
+  int dimensions[3] = { 0, 0, 0 };
+  image->GetDimensions(dimensions);
+  double origin[3] = { 0.0, 0.0, 0.0 };
+  image->GetOrigin(origin);
+  double spacing[3] = { 1.0, 1.0, 1.0 };
+  image->GetSpacing(spacing);
+
+  vtkSmartPointer<vtkImageData> input = image;
+  while (!canceled->load())
+  {
+    int shrinkFactors[3] = { 1, 1, 1 };
+    int maximumDimension = 0;
+    for (int i = 0; i < 3; ++i)
+    {
+      if (dimensions[i] >= 2)
+      {
+        shrinkFactors[i] = 2;
+      }
+      dimensions[i] /= shrinkFactors[i];
+      maximumDimension = std::max(maximumDimension, dimensions[i]);
+    }
+    if (maximumDimension < MULTI_RESOLUTION_MINIMUM_SIZE)
+    {
+      break;
+    }
+
+    vtkNew<vtkImageShrink3D> shrink;
+    shrink->SetInputData(input);
+    shrink->SetShrinkFactors(shrinkFactors);
+    shrink->SetShift(0, 0, 0);
+    shrink->SetAveraging(averaging);
+    shrink->Update();
+
+    vtkSmartPointer<vtkImageData> level = vtkSmartPointer<vtkImageData>::New();
+    level->ShallowCopy(shrink->GetOutput());
+    for (int i = 0; i < 3; ++i)
+    {
+      if (averaging)
+      {
+        // output voxel is the average of input voxels, therefore it is located at their center
+        origin[i] += spacing[i] * (shrinkFactors[i] - 1) * 0.5;
+      }
+      spacing[i] *= shrinkFactors[i];
+    }
+    level->SetOrigin(origin);
+    level->SetSpacing(spacing);
+    levels.push_back(level);
+    input = level;
+  }
+  return levels;
+}
+
+//----------------------------------------------------------------------------
+// Remove pyramids of deleted images and least recently used pyramids that do not fit in the cache.
+// Pyramids are not removed while their computation is in progress.
+void TrimImagePyramids(ImagePyramidMap::key_type keptPyramidKey)
+{
+  ImagePyramidMap& pyramids = GetImagePyramids();
+  vtkTypeInt64 cacheSize = 0;
+  for (ImagePyramidMap::iterator it = pyramids.begin(); it != pyramids.end();)
+  {
+    if (!it->second.Image && !it->second.Pending)
+    {
+      it = pyramids.erase(it);
+    }
+    else
+    {
+      cacheSize += it->second.LevelsMemorySize;
+      ++it;
+    }
+  }
+
+  const vtkTypeInt64 maximumCacheSize = GetImagePyramidCacheSize();
+  while (cacheSize > maximumCacheSize)
+  {
+    ImagePyramidMap::iterator leastRecentlyUsedIt = pyramids.end();
+    for (ImagePyramidMap::iterator it = pyramids.begin(); it != pyramids.end(); ++it)
+    {
+      if (it->first == keptPyramidKey || it->second.Pending || it->second.LevelsMemorySize == 0)
+      {
+        continue;
+      }
+      if (leastRecentlyUsedIt == pyramids.end() || it->second.LastUsed < leastRecentlyUsedIt->second.LastUsed)
+      {
+        leastRecentlyUsedIt = it;
+      }
+    }
+    if (leastRecentlyUsedIt == pyramids.end())
+    {
+      break;
+    }
+    cacheSize -= leastRecentlyUsedIt->second.LevelsMemorySize;
+    pyramids.erase(leastRecentlyUsedIt);
+  }
+}
+
+//----------------------------------------------------------------------------
+// Get the highest available pyramid level of the image that is not higher than requestedLevel.
+// If the pyramid is not available yet then the full resolution image (level 0) is returned
+// and completionNotifier is set to the object that is modified when the pyramid levels become available.
+// Computation of the levels has to be started by the caller (see vtkMultiResolutionTask::Start).
+int GetImagePyramidLevel(vtkImageData* image, bool averaging, int requestedLevel, vtkSmartPointer<vtkImageData>& levelImage, vtkObject*& completionNotifier)
+{
+  static unsigned long useCounter = 0;
+  levelImage = image;
+  completionNotifier = nullptr;
+  ImagePyramidMap::key_type pyramidKey = std::make_pair(image, averaging);
+  TrimImagePyramids(pyramidKey);
+
+  if (!image || requestedLevel <= 0)
+  {
+    return 0;
+  }
+
+  ImagePyramid& pyramid = GetImagePyramids()[pyramidKey];
+  pyramid.LastUsed = ++useCounter;
+  if (pyramid.Image.GetPointer() != image || pyramid.ImageMTime != image->GetMTime())
+  {
+    // Image content has changed since the pyramid was computed or it has not been computed yet
+    pyramid.Levels.clear();
+    pyramid.LevelsMemorySize = 0;
+    if (!pyramid.CompletionNotifier)
+    {
+      pyramid.CompletionNotifier = vtkSmartPointer<vtkObject>::New();
+    }
+    completionNotifier = pyramid.CompletionNotifier;
+    return 0;
+  }
+
+  int level = std::min(requestedLevel, static_cast<int>(pyramid.Levels.size()));
+  if (level > 0)
+  {
+    levelImage = pyramid.Levels[level - 1];
+  }
+  return level;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+/// Background computation of the pyramid levels of an image.
+/// Each layer logic runs at most one computation at a time.
+class vtkMRMLSliceLayerLogic::vtkMultiResolutionTask
+{
+public:
+  /// Pyramid that the levels are computed for
+  ImagePyramidMap::key_type PyramidKey{ nullptr, false };
+  /// Image modification time when the computation was started.
+  /// The result is discarded if the image has been modified since then.
+  vtkMTimeType ImageMTime{ 0 };
+  /// Result of the computation. It is available before CompletionNotifier modification is requested.
+  std::future<ImagePyramidLevels> Levels;
+  /// Computation task. It is completed after CompletionNotifier modification is requested.
+  std::future<void> Task;
+  std::shared_ptr<std::atomic<bool>> Canceled;
+  /// Object that is modified on the main thread (using vtkEventBroker::RequestModified)
+  /// when the computation is completed. It is observed by the layer logic.
+  vtkSmartPointer<vtkObject> CompletionNotifier{ vtkSmartPointer<vtkObject>::New() };
+
+  bool IsRunning() { return this->Task.valid(); }
+
+  /// Start computation of the pyramid levels of the image in a background thread.
+  /// The voxels are copied, so that the image can be modified while the levels are computed.
+  /// Returns false if a computation is already running or the image has no scalars.
+  bool Start(vtkImageData* image, bool averaging)
+  {
+    vtkDataArray* scalars = image->GetPointData() ? image->GetPointData()->GetScalars() : nullptr;
+    if (this->IsRunning() || !scalars)
+    {
+      return false;
+    }
+    ImagePyramid& pyramid = GetImagePyramids()[std::make_pair(image, averaging)];
+    pyramid.Image = image;
+    pyramid.Pending = true;
+
+    this->PyramidKey = std::make_pair(image, averaging);
+    this->ImageMTime = image->GetMTime();
+    vtkSmartPointer<vtkImageData> imageSnapshot = vtkSmartPointer<vtkImageData>::New();
+    imageSnapshot->CopyStructure(image);
+    vtkSmartPointer<vtkDataArray> scalarsSnapshot = vtkSmartPointer<vtkDataArray>::Take(scalars->NewInstance());
+    scalarsSnapshot->DeepCopy(scalars);
+    imageSnapshot->GetPointData()->SetScalars(scalarsSnapshot);
+
+    std::shared_ptr<std::promise<ImagePyramidLevels>> levelsPromise = std::make_shared<std::promise<ImagePyramidLevels>>();
+    this->Levels = levelsPromise->get_future();
+    this->Canceled = std::make_shared<std::atomic<bool>>(false);
+    std::shared_ptr<std::atomic<bool>> canceled = this->Canceled;
+    // The notifier is not released until the task is completed
+    vtkObject* notifier = this->CompletionNotifier;
+    this->Task = std::async(std::launch::async,
+                            [imageSnapshot, averaging, canceled, levelsPromise, notifier]()
+                            {
+                              levelsPromise->set_value(ComputeImagePyramidLevels(imageSnapshot, averaging, canceled));
+                              if (!canceled->load())
+                              {
+                                // The result is available now, notify the layer logic on the main thread
+                                vtkEventBroker::GetInstance()->RequestModified(notifier);
+                              }
+                            });
+    return true;
+  }
+
+  /// Store the computed levels in the pyramid cache and notify all layer logics that use the image.
+  /// Returns false if no computation result is available.
+  bool Retrieve()
+  {
+    if (!this->IsRunning() || this->Levels.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    {
+      return false;
+    }
+    ImagePyramidLevels levels = this->Levels.get();
+    this->Task.wait();
+    this->Task = std::future<void>();
+    this->Canceled = nullptr;
+
+    ImagePyramidMap& pyramids = GetImagePyramids();
+    ImagePyramidMap::iterator pyramidIt = pyramids.find(this->PyramidKey);
+    if (pyramidIt == pyramids.end())
+    {
+      return true;
+    }
+    ImagePyramid& pyramid = pyramidIt->second;
+    pyramid.Pending = false;
+    // Discard the result if the image has been modified since the computation was started
+    if (pyramid.Image.GetPointer() == this->PyramidKey.first && pyramid.Image->GetMTime() == this->ImageMTime)
+    {
+      pyramid.Levels = levels;
+      pyramid.ImageMTime = this->ImageMTime;
+      pyramid.LevelsMemorySize = 0;
+      for (vtkImageData* level : pyramid.Levels)
+      {
+        // GetActualMemorySize returns size in kibibytes
+        pyramid.LevelsMemorySize += static_cast<vtkTypeInt64>(level->GetActualMemorySize()) * 1024;
+      }
+      TrimImagePyramids(this->PyramidKey);
+    }
+    if (pyramid.CompletionNotifier)
+    {
+      // Pyramid entry may have been removed by TrimImagePyramids, so the notifier is kept alive here
+      vtkSmartPointer<vtkObject> completionNotifier = pyramid.CompletionNotifier;
+      completionNotifier->Modified();
+    }
+    return true;
+  }
+
+  /// Stop the computation and wait for the background thread to finish
+  void Cancel()
+  {
+    if (!this->IsRunning())
+    {
+      return;
+    }
+    this->Canceled->store(true);
+    this->Task.wait();
+    this->Levels = std::future<ImagePyramidLevels>();
+    this->Task = std::future<void>();
+    this->Canceled = nullptr;
+    ImagePyramidMap& pyramids = GetImagePyramids();
+    ImagePyramidMap::iterator pyramidIt = pyramids.find(this->PyramidKey);
+    if (pyramidIt != pyramids.end())
+    {
+      // Another layer logic can start the computation now
+      pyramidIt->second.Pending = false;
+    }
+  }
+};
+
 //----------------------------------------------------------------------------
 vtkMRMLSliceLayerLogic::vtkMRMLSliceLayerLogic()
 {
@@ -149,11 +485,208 @@ vtkMRMLSliceLayerLogic::vtkMRMLSliceLayerLogic()
   this->UpdatingTransforms = 0;
 
   this->InterpolationMode = VTK_RESLICE_LINEAR;
+
+  this->TiledMultiThreading = false;
+  this->SetTiledMultiThreading(true);
+
+  this->MultiResolution = false;
+  this->MultiResolutionLevel = 0;
+  this->MultiResolutionCompletionNotifier = nullptr;
+  this->MultiResolutionCompletedCommand = vtkCallbackCommand::New();
+  this->MultiResolutionCompletedCommand->SetClientData(this);
+  this->MultiResolutionCompletedCommand->SetCallback(vtkMRMLSliceLayerLogic::MultiResolutionCompletedCallback);
+  this->MultiResolutionTask = new vtkMultiResolutionTask;
+  this->MultiResolutionTask->CompletionNotifier->AddObserver(vtkCommand::ModifiedEvent, this->MultiResolutionCompletedCommand);
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLSliceLayerLogic::SetTiledMultiThreading(bool enable)
+{
+  if (this->TiledMultiThreading == enable)
+  {
+    return;
+  }
+  this->TiledMultiThreading = enable;
+  vtkMRMLSliceLayerLogic::ConfigureTiledMultiThreading(this->Reslice, enable);
+  vtkMRMLSliceLayerLogic::ConfigureTiledMultiThreading(this->ResliceUVW, enable);
+  vtkMRMLSliceLayerLogic::ConfigureTiledMultiThreading(this->LabelOutline, enable);
+  vtkMRMLSliceLayerLogic::ConfigureTiledMultiThreading(this->LabelOutlineUVW, enable);
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLSliceLayerLogic::ConfigureTiledMultiThreading(vtkThreadedImageAlgorithm* filter, bool enable)
+{
+  if (!filter)
+  {
+    return;
+  }
+  if (enable)
+  {
+    // Slice images are 2D, therefore splitting to blocks results in tiles.
+    // 64kB pieces (e.g., 128x128 RGBA tiles) keep the working set of each tile in cache.
+    filter->SetSplitModeToBlock();
+    filter->SetDesiredBytesPerPiece(65536);
+  }
+  else
+  {
+    filter->SetSplitModeToSlab();
+  }
+  filter->SetEnableSMP(enable);
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLSliceLayerLogic::SetMultiResolution(bool enable)
+{
+  if (this->MultiResolution == enable)
+  {
+    return;
+  }
+  this->MultiResolution = enable;
+  this->UpdateResliceInputData();
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLSliceLayerLogic::SetMultiResolutionCacheSize(vtkTypeInt64 maximumSizeBytes)
+{
+  GetImagePyramidCacheSize() = maximumSizeBytes;
+  TrimImagePyramids(ImagePyramidMap::key_type(nullptr, false));
+}
+
+//----------------------------------------------------------------------------
+vtkTypeInt64 vtkMRMLSliceLayerLogic::GetMultiResolutionCacheSize()
+{
+  return GetImagePyramidCacheSize();
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLSliceLayerLogic::GetDesiredMultiResolutionLevel()
+{
+  if (!this->MultiResolution || !this->SliceNode || !this->VolumeNode || !this->VolumeNode->GetImageData())
+  {
+    return 0;
+  }
+  if (this->SliceNode->GetInteractionFlags() == 0 && !this->SliceNode->GetInteracting())
+  {
+    // use full resolution when the view is not being interacted with
+    return 0;
+  }
+
+  // Compute the size of a slice view pixel in voxels.
+  // Parent transforms are ignored, as only an approximate value is needed.
+  vtkNew<vtkMatrix4x4> xyToIJK;
+  this->VolumeNode->GetRASToIJKMatrix(xyToIJK.GetPointer());
+  vtkMatrix4x4::Multiply4x4(xyToIJK.GetPointer(), this->SliceNode->GetXYToRAS(), xyToIJK.GetPointer());
+  double pixelSizeInVoxels = VTK_DOUBLE_MAX;
+  for (int column = 0; column < 2; ++column)
+  {
+    double columnNorm = sqrt(xyToIJK->GetElement(0, column) * xyToIJK->GetElement(0, column) //
+                             + xyToIJK->GetElement(1, column) * xyToIJK->GetElement(1, column) //
+                             + xyToIJK->GetElement(2, column) * xyToIJK->GetElement(2, column));
+    pixelSizeInVoxels = std::min(pixelSizeInVoxels, columnNorm);
+  }
+  if (pixelSizeInVoxels < 2.0)
+  {
+    return 0;
+  }
+  return static_cast<int>(std::floor(std::log2(pixelSizeInVoxels)));
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLSliceLayerLogic::UpdateResliceInputData()
+{
+  this->MultiResolutionLevel = 0;
+  if (!this->VolumeNode || this->VolumeNode->IsA("vtkMRMLDiffusionTensorVolumeNode"))
+  {
+    // tensor volumes are resliced through a different pipeline
+    this->SetMultiResolutionCompletionNotifier(nullptr);
+    return;
+  }
+  vtkImageData* imageData = this->VolumeNode->GetImageData();
+  if (!imageData)
+  {
+    this->SetMultiResolutionCompletionNotifier(nullptr);
+    this->Reslice->SetInputData(nullptr);
+    return;
+  }
+  // Labelmaps are subsampled to preserve label values
+  bool averaging = !this->IsLabelLayer && !vtkMRMLLabelMapVolumeDisplayNode::SafeDownCast(this->VolumeDisplayNode);
+  vtkSmartPointer<vtkImageData> resliceInput;
+  vtkObject* completionNotifier = nullptr;
+  this->MultiResolutionLevel = GetImagePyramidLevel(imageData, averaging, this->GetDesiredMultiResolutionLevel(), resliceInput, completionNotifier);
+  if (completionNotifier && !GetImagePyramids()[std::make_pair(imageData, averaging)].Pending)
+  {
+    // Pyramid is needed but not available and nobody is computing it.
+    // If this logic is still computing another pyramid then computation is started when that is completed.
+    this->MultiResolutionTask->Start(imageData, averaging);
+  }
+  // Get notified when the pyramid computation is completed to update the slice with the downsampled image
+  this->SetMultiResolutionCompletionNotifier(completionNotifier);
+  if (this->Reslice->GetInput() != resliceInput.GetPointer())
+  {
+    this->Reslice->SetInputData(resliceInput);
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLSliceLayerLogic::SetMultiResolutionCompletionNotifier(vtkObject* completionNotifier)
+{
+  if (this->MultiResolutionCompletionNotifier == completionNotifier)
+  {
+    return;
+  }
+  if (this->MultiResolutionCompletionNotifier)
+  {
+    this->MultiResolutionCompletionNotifier->RemoveObservers(vtkCommand::ModifiedEvent, this->MultiResolutionCompletedCommand);
+    this->MultiResolutionCompletionNotifier->UnRegister(this);
+  }
+  this->MultiResolutionCompletionNotifier = completionNotifier;
+  if (this->MultiResolutionCompletionNotifier)
+  {
+    this->MultiResolutionCompletionNotifier->Register(this);
+    this->MultiResolutionCompletionNotifier->AddObserver(vtkCommand::ModifiedEvent, this->MultiResolutionCompletedCommand);
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLSliceLayerLogic::MultiResolutionCompletedCallback(vtkObject* caller, unsigned long vtkNotUsed(eid), void* clientData, void* vtkNotUsed(callData))
+{
+  vtkMRMLSliceLayerLogic* self = reinterpret_cast<vtkMRMLSliceLayerLogic*>(clientData);
+  if (!self)
+  {
+    return;
+  }
+  if (caller == self->MultiResolutionTask->CompletionNotifier.GetPointer())
+  {
+    // Background computation of this logic is completed. Storing the result
+    // notifies all layer logics that use the same image.
+    self->MultiResolutionTask->Retrieve();
+  }
+  if (!self->MultiResolution)
+  {
+    return;
+  }
+  // Pyramid levels are available now. If the view is still being interacted with then
+  // switch to the downsampled image and request re-rendering of the slice.
+  int oldMultiResolutionLevel = self->MultiResolutionLevel;
+  self->UpdateResliceInputData();
+  if (self->MultiResolutionLevel != oldMultiResolutionLevel)
+  {
+    self->Modified();
+  }
 }
 
 //----------------------------------------------------------------------------
 vtkMRMLSliceLayerLogic::~vtkMRMLSliceLayerLogic()
 {
+  this->SetMultiResolutionCompletionNotifier(nullptr);
+  // The background thread uses the task notifier, therefore it must be completed before the task is deleted
+  this->MultiResolutionTask->Cancel();
+  this->MultiResolutionTask->CompletionNotifier->RemoveObservers(vtkCommand::ModifiedEvent, this->MultiResolutionCompletedCommand);
+  delete this->MultiResolutionTask;
+  this->MultiResolutionTask = nullptr;
+  this->MultiResolutionCompletedCommand->Delete();
   if (this->SliceNode)
   {
     vtkSetAndObserveMRMLNodeMacro(this->SliceNode, 0);
@@ -573,6 +1106,12 @@ void vtkMRMLSliceLayerLogic::UpdateTransforms()
 
   this->ResliceUVW->SetOutputExtent(0, dimensionsUVW[0] - 1, 0, dimensionsUVW[1] - 1, 0, dimensionsUVW[2] - 1);
 
+  // Switch between pyramid levels as the zoom factor or the interaction state changes
+  if (this->MultiResolution || this->MultiResolutionLevel > 0)
+  {
+    this->UpdateResliceInputData();
+  }
+
   this->UpdatingTransforms = 0;
 
   // if (transformModified || transformModifiedUVW)
@@ -741,7 +1280,7 @@ void vtkMRMLSliceLayerLogic::UpdateImageDisplay()
     //      {
     //      volumeNode->GetImageData()->Print(std::cout);
     //      }
-    this->Reslice->SetInputData(volumeNode->GetImageData());
+    this->UpdateResliceInputData();
     this->ResliceUVW->SetInputData(volumeNode->GetImageData());
     // use the label outline if we have a label map volume, this is the label
     // layer (turned on in slice logic when the label layer is instantiated)
@@ -956,6 +1495,9 @@ void vtkMRMLSliceLayerLogic::PrintSelf(ostream& os, vtkIndent indent)
     os << indent << "VolumeDisplayNodeUVW: (none)\n";
   }
 
+  os << indent << "TiledMultiThreading: " << (this->TiledMultiThreading ? "true" : "false") << "\n";
+  os << indent << "MultiResolution: " << (this->MultiResolution ? "true" : "false") << "\n";
+  os << indent << "MultiResolutionLevel: " << this->MultiResolutionLevel << "\n";
   os << indent << "Reslice:\n";
   if (this->Reslice)
   {
@@ -54,7 +54,9 @@ class vtkGeneralTransform;
 // STL includes
 // #include <cstdlib>
 
+class vtkCallbackCommand;
 class vtkImageLabelOutline;
+class vtkThreadedImageAlgorithm;
 class vtkTransform;
 
 class VTK_MRML_LOGIC_EXPORT vtkMRMLSliceLayerLogic : public vtkMRMLAbstractLogic
@@ -132,6 +134,44 @@ public:
   vtkGetMacro(InterpolationMode, int);
   vtkSetMacro(InterpolationMode, int);
 
+  ///
+  /// Enable tiled multi-threaded processing in the reslice and label outline filters.
+  /// If enabled, the output slice is split into small rectangular tiles that are processed
+  /// in parallel using vtkSMPTools (instead of a few horizontal slabs processed by the
+  /// vtkMultiThreader), which balances the load better when large part of the slice
+  /// is outside of the volume. Enabled by default.
+  void SetTiledMultiThreading(bool enable);
+  vtkGetMacro(TiledMultiThreading, bool);
+  vtkBooleanMacro(TiledMultiThreading, bool);
+
+  ///
+  /// Configure an image filter for tiled multi-threaded processing.
+  /// \sa SetTiledMultiThreading
+  static void ConfigureTiledMultiThreading(vtkThreadedImageAlgorithm* filter, bool enable);
+
+  ///
+  /// Enable multi-resolution reslicing.
+  /// If enabled, while the slice view is being interacted with (panned, zoomed, etc.) the slice
+  /// is resliced from a downsampled copy of the volume that has a voxel size closest to the
+  /// displayed pixel size. Downsampled copies (image pyramid) are generated lazily in background
+  /// threads and are shared by all slice views. Full resolution image is used when interaction stops.
+  /// Disabled by default.
+  void SetMultiResolution(bool enable);
+  vtkGetMacro(MultiResolution, bool);
+  vtkBooleanMacro(MultiResolution, bool);
+
+  ///
+  /// Get the pyramid level that is currently used as reslice input.
+  /// Level 0 is the full resolution image, level N is downsampled by a factor of 2^N.
+  vtkGetMacro(MultiResolutionLevel, int);
+
+  ///
+  /// Maximum memory size (in bytes) of downsampled images that are kept for multi-resolution reslicing.
+  /// The cache is shared by all slice layer logics. If the limit is exceeded then downsampled images
+  /// of the least recently used volumes are removed. Default is 512MB.
+  static void SetMultiResolutionCacheSize(vtkTypeInt64 maximumSizeBytes);
+  static vtkTypeInt64 GetMultiResolutionCacheSize();
+
 protected:
   vtkMRMLSliceLayerLogic();
   ~vtkMRMLSliceLayerLogic() override;
@@ -154,6 +194,18 @@ protected:
   // Copy VolumeDisplayNodeObserved into VolumeDisplayNode
   void UpdateVolumeDisplayNode();
 
+  /// Get the pyramid level that best matches the current slice view pixel size.
+  /// Returns 0 if multi-resolution reslicing is not active.
+  int GetDesiredMultiResolutionLevel();
+
+  /// Set the full resolution or downsampled image as input of the reslice filter.
+  void UpdateResliceInputData();
+
+  /// Observe the object that is modified when downsampled images of the volume become available.
+  /// The callback also stores the result of the background computation of this logic when it is completed.
+  void SetMultiResolutionCompletionNotifier(vtkObject* completionNotifier);
+  static void MultiResolutionCompletedCallback(vtkObject* caller, unsigned long eid, void* clientData, void* callData);
+
   ///
   /// the MRML Nodes that define this Logic's parameters
   vtkMRMLVolumeNode* VolumeNode;
@@ -182,6 +234,17 @@ protected:
   int UpdatingTransforms;
 
   int InterpolationMode;
+
+  bool TiledMultiThreading;
+
+  bool MultiResolution;
+  int MultiResolutionLevel;
+  vtkObject* MultiResolutionCompletionNotifier;
+  vtkCallbackCommand* MultiResolutionCompletedCommand;
+
+  /// Background computation of downsampled images, owned by this logic
+  class vtkMultiResolutionTask;
+  vtkMultiResolutionTask* MultiResolutionTask;
 };
 
 #endif
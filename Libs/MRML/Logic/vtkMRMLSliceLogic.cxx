@@ -140,6 +140,31 @@ struct BlendPipeline
 
     this->AddSubAppendRGBA->AddInputConnection(this->AddSubExtractRGB->GetOutputPort());
     this->AddSubAppendRGBA->AddInputConnection(this->BlendAlpha->GetOutputPort());
+
+    this->SetTiledMultiThreading(true);
+  }
+
+  //----------------------------------------------------------------------------
+  void SetTiledMultiThreading(bool enable)
+  {
+    this->TiledMultiThreading = enable;
+    for (vtkThreadedImageAlgorithm* filter : std::vector<vtkThreadedImageAlgorithm*>{ this->AddSubBackgroundCast,
+                                                                                       this->AddSubMath,
+                                                                                       this->AddSubExtractRGB,
+                                                                                       this->AddSubExtractBackgroundAlpha,
+                                                                                       this->BlendAlpha,
+                                                                                       this->AddSubAppendRGBA,
+                                                                                       this->AddSubOutputCast,
+                                                                                       this->Blend })
+    {
+      vtkMRMLSliceLayerLogic::ConfigureTiledMultiThreading(filter, enable);
+    }
+    for (int stageIndex = 0; stageIndex < static_cast<int>(this->AddSubCasts.size()); ++stageIndex)
+    {
+      vtkMRMLSliceLayerLogic::ConfigureTiledMultiThreading(this->AddSubCasts[stageIndex], enable);
+      vtkMRMLSliceLayerLogic::ConfigureTiledMultiThreading(this->FractionMaths[stageIndex], enable);
+      vtkMRMLSliceLayerLogic::ConfigureTiledMultiThreading(this->AddSubExtractAlphas[stageIndex], enable);
+    }
   }
 
   //----------------------------------------------------------------------------
@@ -172,6 +197,10 @@ struct BlendPipeline
         vtkNew<vtkImageExtractComponents> addSubExtractAlpha;
         addSubExtractAlpha->SetComponents(3);
         this->AddSubExtractAlphas.push_back(addSubExtractAlpha);
+
+        vtkMRMLSliceLayerLogic::ConfigureTiledMultiThreading(addSubCast, this->TiledMultiThreading);
+        vtkMRMLSliceLayerLogic::ConfigureTiledMultiThreading(fractionMath, this->TiledMultiThreading);
+        vtkMRMLSliceLayerLogic::ConfigureTiledMultiThreading(addSubExtractAlpha, this->TiledMultiThreading);
       }
       stagesChanged = true;
     }
@@ -296,6 +325,8 @@ struct BlendPipeline
   vtkNew<vtkImageAppendComponents> AddSubAppendRGBA;
   vtkNew<vtkImageCast> AddSubOutputCast;
   vtkNew<vtkImageBlend> Blend;
+
+  bool TiledMultiThreading{ false };
 };
 
 //----------------------------------------------------------------------------
@@ -320,6 +351,8 @@ vtkMRMLSliceLogic::vtkMRMLSliceLogic()
   this->ImageDataConnection = nullptr;
   this->SliceSpacing[0] = this->SliceSpacing[1] = this->SliceSpacing[2] = 1;
   this->AddingSliceModelNodes = false;
+  this->TiledMultiThreading = true;
+  this->MultiResolution = false;
 }
 
 //----------------------------------------------------------------------------
@@ -840,11 +873,53 @@ void vtkMRMLSliceLogic::SetNthLayer(int layerIndex, vtkMRMLSliceLayerLogic* laye
     layer->SetMRMLScene(this->GetMRMLScene());
 
     layer->SetSliceNode(this->SliceNode);
+    layer->SetTiledMultiThreading(this->TiledMultiThreading);
+    layer->SetMultiResolution(this->MultiResolution);
     vtkEventBroker::GetInstance()->AddObservation(layer, vtkCommand::ModifiedEvent, this, this->GetMRMLLogicsCallbackCommand());
   }
   this->Modified();
 }
 
+//----------------------------------------------------------------------------
+void vtkMRMLSliceLogic::SetTiledMultiThreading(bool enable)
+{
+  if (this->TiledMultiThreading == enable)
+  {
+    return;
+  }
+  this->TiledMultiThreading = enable;
+  this->Pipeline->SetTiledMultiThreading(enable);
+  this->PipelineUVW->SetTiledMultiThreading(enable);
+  for (LayerListIterator iterator = this->Layers.begin(); iterator != this->Layers.end(); ++iterator)
+  {
+    vtkMRMLSliceLayerLogic* layer = *iterator;
+    if (layer)
+    {
+      layer->SetTiledMultiThreading(enable);
+    }
+  }
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLSliceLogic::SetMultiResolution(bool enable)
+{
+  if (this->MultiResolution == enable)
+  {
+    return;
+  }
+  this->MultiResolution = enable;
+  for (LayerListIterator iterator = this->Layers.begin(); iterator != this->Layers.end(); ++iterator)
+  {
+    vtkMRMLSliceLayerLogic* layer = *iterator;
+    if (layer)
+    {
+      layer->SetMultiResolution(enable);
+    }
+  }
+  this->Modified();
+}
+
 //----------------------------------------------------------------------------
 vtkAlgorithmOutput* vtkMRMLSliceLogic::GetNthLayerImageDataConnection(int layerIndex)
 {
@@ -2388,6 +2463,16 @@ void vtkMRMLSliceLogic::EndSliceNodeInteraction()
   }
 
   this->SliceNode->SetInteractionFlags(0);
+
+  // Interaction stopped, refine downsampled layers to full resolution
+  for (LayerListIterator iterator = this->Layers.begin(); iterator != this->Layers.end(); ++iterator)
+  {
+    vtkMRMLSliceLayerLogic* layer = *iterator;
+    if (layer && layer->GetMultiResolutionLevel() > 0)
+    {
+      layer->UpdateTransforms();
+    }
+  }
 }
 
 //----------------------------------------------------------------------------
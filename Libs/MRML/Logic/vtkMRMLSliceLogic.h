@@ -157,6 +157,19 @@ public:
   vtkImageBlend* GetBlend();
   vtkImageBlend* GetBlendUVW();
 
+  /// Enable tiled multi-threaded processing in all layers and in the compositing filters.
+  /// \sa vtkMRMLSliceLayerLogic::SetTiledMultiThreading
+  void SetTiledMultiThreading(bool enable);
+  vtkGetMacro(TiledMultiThreading, bool);
+  vtkBooleanMacro(TiledMultiThreading, bool);
+
+  /// Enable multi-resolution reslicing in all layers.
+  /// Layers are refined to full resolution in EndSliceNodeInteraction().
+  /// \sa vtkMRMLSliceLayerLogic::SetMultiResolution
+  void SetMultiResolution(bool enable);
+  vtkGetMacro(MultiResolution, bool);
+  vtkBooleanMacro(MultiResolution, bool);
+
   /// An image reslice instance to pull a single slice from the volume that
   /// represents the filmsheet display output
   vtkGetObjectMacro(ExtractModelTexture, vtkImageReslice);
@@ -470,6 +483,9 @@ protected:
   vtkMRMLLinearTransformNode* SliceModelTransformNode;
   double SliceSpacing[3];
 
+  bool TiledMultiThreading;
+  bool MultiResolution;
+
 private:
   vtkMRMLSliceLogic(const vtkMRMLSliceLogic&) = delete;
   void operator=(const vtkMRMLSliceLogic&) = delete;
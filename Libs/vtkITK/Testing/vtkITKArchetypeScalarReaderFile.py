@@ -47,10 +47,81 @@ class vtkITKReaderAgainstNRRDReader(unittest.TestCase):
         self.itkArray = ns.vtk_to_numpy(self.ritk.GetOutput().GetPointData().GetScalars())
         self.assertTrue(numpy.allclose(self.nrrdArray, self.itkArray))
 
+    def test_memory_mapping(self):
+        import os
+        import tempfile
+
+        mappedFileName = os.path.join(tempfile.gettempdir(), "vtkITKArchetypeScalarReaderFileMapped.mha")
+        writer = vtkITK.vtkITKImageWriter()
+        writer.SetFileName(mappedFileName)
+        writer.SetInputConnection(self.ritk.GetOutputPort())
+        writer.SetRasToIJKMatrix(self.ritk.GetRasToIjkMatrix())
+        writer.SetUseCompression(False)
+        writer.Write()
+
+        mappedReader = vtkITK.vtkITKArchetypeImageSeriesScalarReader()
+        mappedReader.SetUseMemoryMapping(True)
+        mappedReader.SetOutputScalarTypeToNative()
+        mappedReader.SetDesiredCoordinateOrientationToNative()
+        mappedReader.SetArchetype(mappedFileName)
+        mappedReader.Update()
+        mappedArray = ns.vtk_to_numpy(mappedReader.GetOutput().GetPointData().GetScalars())
+        itkArray = ns.vtk_to_numpy(self.ritk.GetOutput().GetPointData().GetScalars())
+        self.assertTrue(numpy.array_equal(mappedArray, itkArray))
+
+        # Writers can find out which file the voxels are mapped from
+        mappedScalars = mappedReader.GetOutput().GetPointData().GetScalars()
+        self.assertTrue(os.path.samefile(vtkITK.vtkITKArchetypeImageSeriesReader.GetMappedFileName(mappedScalars), mappedFileName))
+        self.assertEqual(vtkITK.vtkITKArchetypeImageSeriesReader.GetMappedFileName(self.ritk.GetOutput().GetPointData().GetScalars()), "")
+
+        # Modified voxels are not written to the file
+        mappedArray[0] = mappedArray[0] + 1
+        fileReader = vtkITK.vtkITKArchetypeImageSeriesScalarReader()
+        fileReader.SetOutputScalarTypeToNative()
+        fileReader.SetDesiredCoordinateOrientationToNative()
+        fileReader.SetArchetype(mappedFileName)
+        fileReader.Update()
+        fileArray = ns.vtk_to_numpy(fileReader.GetOutput().GetPointData().GetScalars())
+        self.assertEqual(fileArray[0], itkArray[0])
+
+        del mappedArray
+        mappedScalars = None
+        mappedReader = None
+        os.remove(mappedFileName)
+
+    def test_memory_mapping_inconsistent_file(self):
+        import os
+        import tempfile
+
+        # Extra bytes after the voxels: the file does not match its header, therefore
+        # it must be read by ITK instead of mapping the end of the file.
+        inconsistentFileName = os.path.join(tempfile.gettempdir(), "vtkITKArchetypeScalarReaderFileInconsistent.nrrd")
+        voxels = numpy.arange(4 * 3 * 2, dtype=numpy.int16)
+        with open(inconsistentFileName, "wb") as inconsistentFile:
+            inconsistentFile.write(b"NRRD0004\ntype: short\ndimension: 3\nsizes: 4 3 2\n")
+            inconsistentFile.write(b"endian: " + (b"little" if numpy.little_endian else b"big") + b"\nencoding: raw\n\n")
+            inconsistentFile.write(voxels.tobytes())
+            inconsistentFile.write(b"\0" * 6)
+
+        mappedReader = vtkITK.vtkITKArchetypeImageSeriesScalarReader()
+        mappedReader.SetUseMemoryMapping(True)
+        mappedReader.SetOutputScalarTypeToNative()
+        mappedReader.SetDesiredCoordinateOrientationToNative()
+        mappedReader.SetArchetype(inconsistentFileName)
+        mappedReader.Update()
+        mappedArray = ns.vtk_to_numpy(mappedReader.GetOutput().GetPointData().GetScalars())
+        self.assertTrue(numpy.array_equal(mappedArray, voxels))
+
+        del mappedArray
+        mappedReader = None
+        os.remove(inconsistentFileName)
+
     def runTest(self):
         self.setUp()
         self.test_pointdata()
         self.test_ras_to_ijk()
+        self.test_memory_mapping()
+        self.test_memory_mapping_inconsistent_file()
 
 
 def compare_vtk_matrix(m1, m2, n=4):
@@ -29,7 +29,14 @@
 #include <vtkPointData.h>
 #include <vtkStreamingDemandDrivenPipeline.h>
 
+// VTKsys includes
+#include <vtksys/SystemTools.hxx>
+#ifdef _WIN32
+# include <vtksys/Encoding.hxx>
+#endif
+
 // ITK includes
+#include <itkByteSwapper.h>
 #include <itkNiftiImageIO.h>
 #include <itkNrrdImageIO.h>
 #include <itkMetaDataDictionary.h>
@@ -40,8 +47,26 @@
 
 // STD includes
 #include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
 #include <vector>
 
+// Memory mapping includes
+#ifdef _WIN32
+# ifndef NOMINMAX
+#  define NOMINMAX
+# endif
+# include <windows.h>
+#else
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
 #include "itkArchetypeSeriesFileNames.h"
 #include "itkOrientImageFilter.h"
 #include "itkImageSeriesReader.h"
@@ -53,6 +78,486 @@
 
 vtkStandardNewMacro(vtkITKArchetypeImageSeriesReader);
 
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Location of the voxels of an uncompressed image file
+struct RawDataFileInfo
+{
+  std::string DataFileName;
+  bool BigEndian{ false };
+  int ElementSize{ 0 };
+  /// Number of values (voxels times components) stored in the file, as specified in the header
+  vtkTypeInt64 NumberOfValues{ 0 };
+  /// Position of the first voxel in the data file, -1 if the data is at the end of the file
+  vtkTypeInt64 DataOffset{ 0 };
+};
+
+//----------------------------------------------------------------------------
+// Get size of a NRRD "type" field value in bytes (0 if unknown)
+int GetNRRDTypeSize(const std::string& type)
+{
+  if (type.find("char") != std::string::npos || type.find("int8") != std::string::npos)
+  {
+    return 1;
+  }
+  else if (type.find("short") != std::string::npos || type.find("int16") != std::string::npos)
+  {
+    return 2;
+  }
+  else if (type.find("long") != std::string::npos || type.find("int64") != std::string::npos || type == "double")
+  {
+    return 8;
+  }
+  else if (type.find("int") != std::string::npos || type == "float")
+  {
+    return 4;
+  }
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+// Get size of a MetaImage "ElementType" field value in bytes (0 if unknown)
+int GetMetaImageTypeSize(const std::string& type)
+{
+  if (type.find("CHAR") != std::string::npos)
+  {
+    return 1;
+  }
+  else if (type.find("SHORT") != std::string::npos)
+  {
+    return 2;
+  }
+  else if (type.find("LONG_LONG") != std::string::npos || type.find("DOUBLE") != std::string::npos)
+  {
+    return 8;
+  }
+  else if (type.find("INT") != std::string::npos || type.find("LONG") != std::string::npos || type.find("FLOAT") != std::string::npos)
+  {
+    return 4;
+  }
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+std::string TrimWhitespace(const std::string& str)
+{
+  const char* whitespace = " \t\r\n";
+  size_t first = str.find_first_not_of(whitespace);
+  if (first == std::string::npos)
+  {
+    return std::string();
+  }
+  size_t last = str.find_last_not_of(whitespace);
+  return str.substr(first, last - first + 1);
+}
+
+//----------------------------------------------------------------------------
+// Get absolute path of a detached data file, which is specified relative to the header file
+bool GetDetachedDataFileName(const std::string& headerFileName, const std::string& dataFileSpecification, std::string& dataFileName)
+{
+  // Lists of files and file name patterns (which are followed by a slice range) cannot be mapped
+  if (dataFileSpecification.empty() || dataFileSpecification.find(' ') != std::string::npos || dataFileSpecification.compare(0, 4, "LIST") == 0)
+  {
+    return false;
+  }
+  std::string headerDirectory = vtksys::SystemTools::GetFilenamePath(headerFileName);
+  dataFileName = vtksys::SystemTools::CollapseFullPath(dataFileSpecification, headerDirectory);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+// Returns true if ITK reads the values along a NRRD axis of this kind as pixel components
+// exactly as they are stored in the file. For example, masked tensors are not, as ITK drops the mask.
+bool IsNRRDComponentAxisKindMappable(const std::string& kind)
+{
+  const char* mappableKinds[] = { "scalar", "list", "vector", "covariant-vector", "normal", "point", "2-vector", "3-vector",
+                                  "4-vector", "3-color", "4-color", "RGB-color", "RGBA-color", "HSV-color", "XYZ-color" };
+  for (const char* mappableKind : mappableKinds)
+  {
+    if (kind == mappableKind)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+//----------------------------------------------------------------------------
+// Parse NRRD header. Only those files can be mapped where ITK reads the voxels
+// as they are stored in the file, i.e., the pixel components are stored
+// along the first axis and all other axes are spatial.
+bool GetRawDataFileInfoFromNRRD(const std::string& fileName, RawDataFileInfo& info)
+{
+  std::ifstream file(fileName.c_str(), std::ios::in | std::ios::binary);
+  std::string line;
+  if (!std::getline(file, line) || line.compare(0, 7, "NRRD000") != 0)
+  {
+    return false;
+  }
+  std::string encoding;
+  int dimension = 0;
+  std::vector<std::string> kinds;
+  std::vector<vtkTypeInt64> sizes;
+  vtkTypeInt64 byteSkip = 0;
+  bool detachedData = false;
+  bool endOfHeader = false;
+  info.DataFileName = fileName;
+  while (std::getline(file, line))
+  {
+    line = TrimWhitespace(line);
+    if (line.empty())
+    {
+      endOfHeader = true;
+      break;
+    }
+    size_t separatorPosition = line.find(": ");
+    if (line[0] == '#' || separatorPosition == std::string::npos || line.find(":=") < separatorPosition)
+    {
+      // comment or key/value pair
+      continue;
+    }
+    std::string field = line.substr(0, separatorPosition);
+    std::string value = TrimWhitespace(line.substr(separatorPosition + 2));
+    if (field == "type")
+    {
+      info.ElementSize = GetNRRDTypeSize(value);
+    }
+    else if (field == "encoding")
+    {
+      encoding = value;
+    }
+    else if (field == "endian")
+    {
+      info.BigEndian = (value == "big");
+    }
+    else if (field == "dimension")
+    {
+      dimension = atoi(value.c_str());
+    }
+    else if (field == "kinds")
+    {
+      std::istringstream kindsStream(value);
+      std::string kind;
+      while (kindsStream >> kind)
+      {
+        kinds.push_back(kind);
+      }
+    }
+    else if (field == "sizes")
+    {
+      std::istringstream sizesStream(value);
+      vtkTypeInt64 size = 0;
+      while (sizesStream >> size)
+      {
+        sizes.push_back(size);
+      }
+    }
+    else if (field == "byte skip" || field == "byteskip")
+    {
+      byteSkip = atoll(value.c_str());
+    }
+    else if (field == "line skip" || field == "lineskip")
+    {
+      if (atoll(value.c_str()) != 0)
+      {
+        return false;
+      }
+    }
+    else if (field == "data file" || field == "datafile")
+    {
+      if (!GetDetachedDataFileName(fileName, value, info.DataFileName))
+      {
+        return false;
+      }
+      detachedData = true;
+    }
+  }
+  if (encoding != "raw" || dimension <= 0 || static_cast<int>(sizes.size()) != dimension)
+  {
+    return false;
+  }
+  if (!kinds.empty() && static_cast<int>(kinds.size()) != dimension)
+  {
+    return false;
+  }
+  for (size_t axisIndex = 1; axisIndex < kinds.size(); ++axisIndex)
+  {
+    if (kinds[axisIndex] != "domain" && kinds[axisIndex] != "space")
+    {
+      // ITK would permute the axes to make pixel components contiguous
+      return false;
+    }
+  }
+  bool componentAxis = (dimension > 3 || (!kinds.empty() && kinds[0] != "domain" && kinds[0] != "space"));
+  if (componentAxis && (kinds.empty() || !IsNRRDComponentAxisKindMappable(kinds[0])))
+  {
+    return false;
+  }
+
+  info.NumberOfValues = 1;
+  for (vtkTypeInt64 size : sizes)
+  {
+    if (size <= 0)
+    {
+      return false;
+    }
+    info.NumberOfValues *= size;
+  }
+  if (byteSkip < -1)
+  {
+    return false;
+  }
+  if (byteSkip == -1)
+  {
+    info.DataOffset = -1;
+  }
+  else if (detachedData)
+  {
+    info.DataOffset = byteSkip;
+  }
+  else
+  {
+    // Attached data starts right after the empty line that terminates the header
+    std::streamoff headerSize = file.tellg();
+    if (!endOfHeader || headerSize < 0)
+    {
+      return false;
+    }
+    info.DataOffset = static_cast<vtkTypeInt64>(headerSize) + byteSkip;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+// Parse MetaImage header
+bool GetRawDataFileInfoFromMetaImage(const std::string& fileName, RawDataFileInfo& info)
+{
+  std::ifstream file(fileName.c_str(), std::ios::in | std::ios::binary);
+  std::string line;
+  std::vector<vtkTypeInt64> dimSizes;
+  vtkTypeInt64 numberOfChannels = 1;
+  vtkTypeInt64 headerSize = 0;
+  while (std::getline(file, line))
+  {
+    size_t separatorPosition = line.find('=');
+    if (separatorPosition == std::string::npos)
+    {
+      return false;
+    }
+    std::string field = TrimWhitespace(line.substr(0, separatorPosition));
+    std::string value = TrimWhitespace(line.substr(separatorPosition + 1));
+    if (field == "CompressedData")
+    {
+      if (value == "True" || value == "true")
+      {
+        return false;
+      }
+    }
+    else if (field == "ElementType")
+    {
+      info.ElementSize = GetMetaImageTypeSize(value);
+    }
+    else if (field == "NDims")
+    {
+      if (atoi(value.c_str()) > 3)
+      {
+        return false;
+      }
+    }
+    else if (field == "DimSize")
+    {
+      std::istringstream dimSizesStream(value);
+      vtkTypeInt64 dimSize = 0;
+      while (dimSizesStream >> dimSize)
+      {
+        dimSizes.push_back(dimSize);
+      }
+    }
+    else if (field == "ElementNumberOfChannels")
+    {
+      numberOfChannels = atoll(value.c_str());
+    }
+    else if (field == "HeaderSize")
+    {
+      headerSize = atoll(value.c_str());
+    }
+    else if (field == "BinaryDataByteOrderMSB" || field == "ElementByteOrderMSB")
+    {
+      info.BigEndian = (value == "True" || value == "true");
+    }
+    else if (field == "ElementDataFile")
+    {
+      // data file is the last field of the header
+      if (dimSizes.empty() || numberOfChannels <= 0 || headerSize < -1)
+      {
+        return false;
+      }
+      info.NumberOfValues = numberOfChannels;
+      for (vtkTypeInt64 dimSize : dimSizes)
+      {
+        if (dimSize <= 0)
+        {
+          return false;
+        }
+        info.NumberOfValues *= dimSize;
+      }
+      if (value == "LOCAL" || value == "Local" || value == "local")
+      {
+        // Local data starts right after the header, unless it is explicitly placed at the end of the file
+        std::streamoff localHeaderSize = file.tellg();
+        if (localHeaderSize < 0 || headerSize > 0)
+        {
+          return false;
+        }
+        info.DataFileName = fileName;
+        info.DataOffset = (headerSize == -1 ? -1 : static_cast<vtkTypeInt64>(localHeaderSize));
+        return true;
+      }
+      info.DataOffset = headerSize;
+      return value.find('%') == std::string::npos && GetDetachedDataFileName(fileName, value, info.DataFileName);
+    }
+  }
+  return false;
+}
+
+//----------------------------------------------------------------------------
+// Mapped memory regions, indexed by the pointer of the first voxel
+struct MappedRegion
+{
+  void* Address;
+  size_t Length;
+  std::string FileName;
+};
+std::mutex MappedRegionsLock;
+std::map<void*, MappedRegion> MappedRegions;
+
+//----------------------------------------------------------------------------
+// Free function of memory mapped data arrays
+void UnmapScalars(void* voxels)
+{
+  std::lock_guard<std::mutex> lock(MappedRegionsLock);
+  std::map<void*, MappedRegion>::iterator regionIt = MappedRegions.find(voxels);
+  if (regionIt == MappedRegions.end())
+  {
+    return;
+  }
+#ifdef _WIN32
+  UnmapViewOfFile(regionIt->second.Address);
+#else
+  munmap(regionIt->second.Address, regionIt->second.Length);
+#endif
+  MappedRegions.erase(regionIt);
+}
+
+//----------------------------------------------------------------------------
+// Get position of the first voxel in the data file. The file must end right after the voxels,
+// otherwise the header does not describe the file content correctly and it is not mapped.
+// Returns -1 if the file size does not match.
+vtkTypeInt64 GetDataOffsetInFile(vtkTypeInt64 fileSize, vtkTypeInt64 dataOffset, vtkTypeInt64 dataSize)
+{
+  if (fileSize < dataSize)
+  {
+    return -1;
+  }
+  if (dataOffset < 0)
+  {
+    // data is at the end of the file
+    return fileSize - dataSize;
+  }
+  return (dataOffset + dataSize == fileSize) ? dataOffset : -1;
+}
+
+//----------------------------------------------------------------------------
+// Map dataSize bytes of a file copy-on-write, starting at dataOffset
+// (-1 means that the data is at the end of the file).
+// Returns pointer to the first voxel, nullptr on failure.
+void* MapScalarsFromDataFile(const std::string& fileName, vtkTypeInt64 dataOffset, vtkTypeInt64 dataSize, int dataTypeSize)
+{
+  if (dataSize <= 0)
+  {
+    return nullptr;
+  }
+  void* address = nullptr;
+  vtkTypeInt64 mapOffset = 0;
+#ifdef _WIN32
+  HANDLE file = CreateFileW(vtksys::Encoding::ToWindowsExtendedPath(fileName).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+  {
+    return nullptr;
+  }
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(file, &fileSize))
+  {
+    CloseHandle(file);
+    return nullptr;
+  }
+  dataOffset = GetDataOffsetInFile(fileSize.QuadPart, dataOffset, dataSize);
+  if (dataOffset < 0)
+  {
+    CloseHandle(file);
+    return nullptr;
+  }
+  SYSTEM_INFO systemInfo;
+  GetSystemInfo(&systemInfo);
+  mapOffset = dataOffset - dataOffset % systemInfo.dwAllocationGranularity;
+  size_t mapLength = static_cast<size_t>(fileSize.QuadPart - mapOffset);
+  if (dataOffset % dataTypeSize == 0)
+  {
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    if (mapping)
+    {
+      address = MapViewOfFile(mapping, FILE_MAP_COPY, static_cast<DWORD>(mapOffset >> 32), static_cast<DWORD>(mapOffset & 0xFFFFFFFF), mapLength);
+      // the view keeps the file mapping open
+      CloseHandle(mapping);
+    }
+  }
+  CloseHandle(file);
+#else
+  int file = open(fileName.c_str(), O_RDONLY);
+  if (file < 0)
+  {
+    return nullptr;
+  }
+  struct stat fileStatus;
+  if (fstat(file, &fileStatus) != 0)
+  {
+    close(file);
+    return nullptr;
+  }
+  dataOffset = GetDataOffsetInFile(static_cast<vtkTypeInt64>(fileStatus.st_size), dataOffset, dataSize);
+  if (dataOffset < 0)
+  {
+    close(file);
+    return nullptr;
+  }
+  mapOffset = dataOffset - dataOffset % sysconf(_SC_PAGESIZE);
+  size_t mapLength = static_cast<size_t>(fileStatus.st_size - mapOffset);
+  if (dataOffset % dataTypeSize == 0)
+  {
+    // Private mapping: pages are copied on first write, changes are not written to the file
+    address = mmap(nullptr, mapLength, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, static_cast<off_t>(mapOffset));
+    if (address == MAP_FAILED)
+    {
+      address = nullptr;
+    }
+  }
+  // the mapping keeps the file open
+  close(file);
+#endif
+  if (!address)
+  {
+    return nullptr;
+  }
+  void* voxels = static_cast<char*>(address) + (dataOffset - mapOffset);
+  std::lock_guard<std::mutex> lock(MappedRegionsLock);
+  MappedRegions[voxels] = MappedRegion{ address, mapLength, fileName };
+  return voxels;
+}
+
+} // end of anonymous namespace
+
 //----------------------------------------------------------------------------
 vtkITKArchetypeImageSeriesReader::vtkITKArchetypeImageSeriesReader()
 {
@@ -60,6 +565,7 @@ vtkITKArchetypeImageSeriesReader::vtkITKArchetypeImageSeriesReader()
   this->IndexArchetype = 0;
   this->SingleFile = 1;
   this->UseOrientationFromFile = 1;
+  this->UseMemoryMapping = false;
   this->RasToIjkMatrix = nullptr;
   this->MeasurementFrameMatrix = vtkMatrix4x4::New();
   this->SetDesiredCoordinateOrientationToAxial();
@@ -156,6 +662,7 @@ void vtkITKArchetypeImageSeriesReader::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "FileNameSliceOffset: " << this->FileNameSliceOffset << "\n";
   os << indent << "FileNameSliceSpacing: " << this->FileNameSliceSpacing << "\n";
   os << indent << "FileNameSliceCount: " << this->FileNameSliceCount << "\n";
+  os << indent << "UseMemoryMapping: " << (this->UseMemoryMapping ? "true" : "false") << "\n";
 
   os << indent << "OutputScalarType: " << vtkImageScalarTypeNameMacro(this->OutputScalarType) << std::endl;
   os << indent << "DefaultDataSpacing: (" << this->DefaultDataSpacing[0];
@@ -1100,6 +1607,74 @@ void vtkITKArchetypeImageSeriesReader::SetMetaDataScalarRangeToPointDataInfo(vtk
   }
 }
 
+//----------------------------------------------------------------------------
+bool vtkITKArchetypeImageSeriesReader::MapScalarsFromFile(vtkImageData* data)
+{
+  // Voxels are only used as they are stored in the file if they are not reoriented or converted
+  if (!this->UseMemoryMapping || this->FileNames.size() != 1 || this->ArchetypeIsDICOM //
+      || !this->UseNativeCoordinateOrientation || !this->UseNativeScalarType)
+  {
+    return false;
+  }
+  vtkDataArray* scalars = data ? data->GetPointData()->GetScalars() : nullptr;
+  if (!scalars || !scalars->HasStandardMemoryLayout() || scalars->GetDataType() != this->OutputScalarType)
+  {
+    return false;
+  }
+
+  const std::string& fileName = this->FileNames[0];
+  std::string extension = vtksys::SystemTools::LowerCase(vtksys::SystemTools::GetFilenameLastExtension(fileName));
+  RawDataFileInfo info;
+  bool rawDataFile = false;
+  if (extension == ".nrrd" || extension == ".nhdr")
+  {
+    rawDataFile = GetRawDataFileInfoFromNRRD(fileName, info);
+  }
+  else if (extension == ".mha" || extension == ".mhd")
+  {
+    rawDataFile = GetRawDataFileInfoFromMetaImage(fileName, info);
+  }
+  if (!rawDataFile)
+  {
+    return false;
+  }
+  int dataTypeSize = scalars->GetDataTypeSize();
+  if (info.ElementSize != dataTypeSize || (dataTypeSize > 1 && info.BigEndian != itk::ByteSwapper<int>::SystemIsBigEndian()))
+  {
+    return false;
+  }
+
+  vtkIdType numberOfValues = data->GetNumberOfPoints() * scalars->GetNumberOfComponents();
+  if (info.NumberOfValues != static_cast<vtkTypeInt64>(numberOfValues))
+  {
+    // ITK does not read the voxels as they are stored in the file (for example, it drops components)
+    vtkDebugMacro("MapScalarsFromFile: " << info.NumberOfValues << " values are stored in " << fileName << " but the image has " << numberOfValues
+                                         << ", reading the file instead");
+    return false;
+  }
+  void* voxels = MapScalarsFromDataFile(info.DataFileName, info.DataOffset, static_cast<vtkTypeInt64>(numberOfValues) * dataTypeSize, dataTypeSize);
+  if (!voxels)
+  {
+    vtkDebugMacro("MapScalarsFromFile: failed to map " << info.DataFileName << ", reading the file instead");
+    return false;
+  }
+  scalars->SetVoidArray(voxels, numberOfValues, 0, vtkAbstractArray::VTK_DATA_ARRAY_USER_DEFINED);
+  scalars->SetArrayFreeFunction(UnmapScalars);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+std::string vtkITKArchetypeImageSeriesReader::GetMappedFileName(vtkDataArray* scalars)
+{
+  if (!scalars || scalars->GetNumberOfValues() == 0)
+  {
+    return std::string();
+  }
+  std::lock_guard<std::mutex> lock(MappedRegionsLock);
+  std::map<void*, MappedRegion>::iterator regionIt = MappedRegions.find(scalars->GetVoidPointer(0));
+  return (regionIt != MappedRegions.end()) ? regionIt->second.FileName : std::string();
+}
+
 //----------------------------------------------------------------------------
 void vtkITKArchetypeImageSeriesReader::AssembleNthVolume(int n)
 {
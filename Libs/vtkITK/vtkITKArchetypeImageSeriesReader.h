@@ -20,6 +20,7 @@ Version:   $Revision$
 
 // VTK includes
 #include "vtkImageAlgorithm.h"
+class vtkDataArray;
 class vtkMatrix4x4;
 
 // ITK includes
@@ -250,6 +251,26 @@ public:
   vtkSetMacro(UseOrientationFromFile, int);
   vtkGetMacro(UseOrientationFromFile, int);
 
+  ///
+  /// Map the voxels of uncompressed single-file images (raw NRRD, NHDR, MHA, MHD) into memory
+  /// instead of reading them into a newly allocated buffer. (Default is off)
+  /// The file is mapped copy-on-write: voxels are loaded from disk when they are first accessed
+  /// and modified voxels are kept in memory, the file is never changed.
+  /// The file must not be modified or removed while the image data is in use.
+  /// Images that cannot be mapped (compressed, different byte order, reoriented, converted
+  /// to a different scalar type, pixel components that ITK does not read as stored, or file
+  /// size that does not match the header) are read as usual.
+  vtkSetMacro(UseMemoryMapping, bool);
+  vtkGetMacro(UseMemoryMapping, bool);
+  vtkBooleanMacro(UseMemoryMapping, bool);
+
+  ///
+  /// Returns the name of the file that the scalars are memory mapped from,
+  /// empty string if the scalars are stored in regular memory.
+  /// Writers must not overwrite this file while the scalars are in use.
+  /// \sa SetUseMemoryMapping
+  static std::string GetMappedFileName(vtkDataArray* scalars);
+
   ///
   /// Returns an IJK to RAS transformation matrix
   vtkMatrix4x4* GetRasToIjkMatrix();
@@ -762,9 +783,16 @@ protected:
   /// Get the image IO for the specified filename
   itk::ImageIOBase::Pointer GetImageIO(const char* filename);
 
+  /// Set scalars of the output image data to a memory mapping of the image file.
+  /// Returns false if memory mapping is disabled or not possible for this file,
+  /// in this case the image has to be read by ITK.
+  /// \sa SetUseMemoryMapping
+  bool MapScalarsFromFile(vtkImageData* data);
+
   char* Archetype;
   int SingleFile;
   int UseOrientationFromFile;
+  bool UseMemoryMapping;
   int DataExtent[6];
 
   int OutputScalarType;
@@ -85,6 +85,12 @@ int vtkITKArchetypeImageSeriesScalarReader::RequestData(vtkInformation* vtkNotUs
   data->SetExtent(outInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT()));
   this->SetMetaDataScalarRangeToPointDataInfo(data);
 
+  // Uncompressed files can be mapped into memory instead of reading them
+  if (this->MapScalarsFromFile(data))
+  {
+    return 1;
+  }
+
 #ifdef VTKITK_BUILD_DICOM_SUPPORT
 # define vtkITKExecuteDataDeclareDICOMImageIO                                                                                \
    typedef itk::ImageIOBase ImageIOType;                                                                                     \
@@ -21,8 +21,10 @@
 #include "vtkITKArchetypeImageSeriesReader.h"
 
 // VTK includes
+#include <vtkByteSwap.h>
 #include <vtkErrorCode.h>
 #include "vtkImageExtractComponents.h"
+#include <vtkImageData.h>
 #include <vtkInformation.h>
 #include <vtkInformationVector.h>
 #include <vtkNew.h>
@@ -36,8 +38,100 @@
 #include "itkNrrdImageIO.h"
 #include "itkVectorIndexSelectionCastImageFilter.h"
 
+// VTKsys includes
+#include <vtksys/FStream.hxx>
+#include <vtksys/SystemTools.hxx>
+
+// STD includes
+#include <sstream>
+
 #define KEY_PREFIX "NRRD_"
 
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Get position of voxel data in an NRRD file that stores uncompressed data after the header.
+/// Returns false if voxel data is compressed, stored in a separate file, or its position cannot be determined.
+bool GetAttachedRawDataOffset(const char* fileName, unsigned long long& dataOffset, bool& bigEndian)
+{
+  vtksys::ifstream file(fileName, std::ios::in | std::ios::binary);
+  if (!file.is_open())
+  {
+    return false;
+  }
+  std::string line;
+  if (!std::getline(file, line) || line.compare(0, 4, "NRRD") != 0)
+  {
+    return false;
+  }
+  bool rawEncoding = false;
+  bigEndian = false;
+  while (std::getline(file, line))
+  {
+    if (!line.empty() && line.back() == '\r')
+    {
+      line.pop_back();
+    }
+    if (line.empty())
+    {
+      // end of header, voxel data starts here
+      if (!rawEncoding)
+      {
+        return false;
+      }
+      dataOffset = static_cast<unsigned long long>(file.tellg());
+      return true;
+    }
+    if (line[0] == '#' || line.find(":=") != std::string::npos)
+    {
+      // comment or key/value pair
+      continue;
+    }
+    std::string::size_type separatorPosition = line.find(':');
+    if (separatorPosition == std::string::npos)
+    {
+      continue;
+    }
+    std::string fieldName = line.substr(0, separatorPosition);
+    std::string fieldValue = vtksys::SystemTools::TrimWhitespace(line.substr(separatorPosition + 1));
+    if (fieldName == "encoding")
+    {
+      rawEncoding = (fieldValue == "raw");
+    }
+    else if (fieldName == "endian")
+    {
+      bigEndian = (fieldValue == "big");
+    }
+    else if (fieldName == "data file" || fieldName == "datafile" //
+             || fieldName == "line skip" || fieldName == "lineskip" || fieldName == "byte skip" || fieldName == "byteskip")
+    {
+      // detached data or skipped bytes are not supported
+      return false;
+    }
+  }
+  return false;
+}
+
+//----------------------------------------------------------------------------
+int GetVTKScalarTypeFromITKComponentType(itk::ImageIOBase::IOComponentEnum componentType)
+{
+  switch (componentType)
+  {
+    case itk::ImageIOBase::IOComponentEnum::UCHAR: return VTK_UNSIGNED_CHAR;
+    case itk::ImageIOBase::IOComponentEnum::CHAR: return VTK_CHAR;
+    case itk::ImageIOBase::IOComponentEnum::USHORT: return VTK_UNSIGNED_SHORT;
+    case itk::ImageIOBase::IOComponentEnum::SHORT: return VTK_SHORT;
+    case itk::ImageIOBase::IOComponentEnum::UINT: return VTK_UNSIGNED_INT;
+    case itk::ImageIOBase::IOComponentEnum::INT: return VTK_INT;
+    case itk::ImageIOBase::IOComponentEnum::FLOAT: return VTK_FLOAT;
+    case itk::ImageIOBase::IOComponentEnum::DOUBLE: return VTK_DOUBLE;
+    default: return VTK_VOID;
+  }
+}
+
+} // namespace
+
 vtkStandardNewMacro(vtkITKImageSequenceReader);
 
 //----------------------------------------------------------------------------
@@ -73,6 +167,8 @@ void vtkITKImageSequenceReader::PrintSelf(ostream& os, vtkIndent indent)
   {
     os << indent.GetNextIndent() << "Axis " << it->first << ": " << it->second << "\n";
   }
+  os << indent << "ReadFramesOnDemand: " << (this->ReadFramesOnDemand ? "true" : "false") << "\n";
+  os << indent << "FramesReadOnDemand: " << (this->FramesReadOnDemand ? "true" : "false") << "\n";
   os << indent << "RasToIjkMatrix:\n";
   if (this->RasToIjkMatrix)
   {
@@ -137,7 +233,7 @@ const char* vtkITKImageSequenceReader::GetAxisUnit(unsigned int axis)
 
 //----------------------------------------------------------------------------
 template <class TPixelType, int Dimension>
-void vtkITKExecuteDataFromFile(vtkITKImageSequenceReader* self, std::vector<vtkSmartPointer<vtkImageData>>& images, int listDimIdx, int voxelVectorType)
+void vtkITKExecuteDataFromFile(vtkITKImageSequenceReader* self, std::vector<vtkSmartPointer<vtkImageData>>& images, int listDimIdx, int voxelVectorType, bool cacheFrames)
 {
   using PixelType = TPixelType;
   constexpr unsigned int ImageDimension = Dimension;
@@ -152,7 +248,15 @@ void vtkITKExecuteDataFromFile(vtkITKImageSequenceReader* self, std::vector<vtkS
   reader->SetImageIO(imageIO);
 
   reader->SetFileName(self->GetFileName());
-  reader->Update();
+  if (cacheFrames)
+  {
+    reader->Update();
+  }
+  else
+  {
+    // Only read image information, frames will be read on demand
+    reader->UpdateOutputInformation();
+  }
   typename ImageType::ConstPointer image = reader->GetOutput();
 
   // Get IJK to LPS matrix
@@ -191,6 +295,12 @@ void vtkITKExecuteDataFromFile(vtkITKImageSequenceReader* self, std::vector<vtkS
   typename ImageType::SizeType extractionSize = fullRegion.GetSize();
   self->SetNumberOfFrames(extractionSize[listDimIdx]);
 
+  images.clear();
+  if (!cacheFrames)
+  {
+    return;
+  }
+
   extractionSize[listDimIdx] = 0; // Collapse sequence dimension when extracting frame
 
   typename ImageType::RegionType extractionRegion;
@@ -201,7 +311,6 @@ void vtkITKExecuteDataFromFile(vtkITKImageSequenceReader* self, std::vector<vtkS
   using VTKExporterFilterType = itk::ImageToVTKImageFilter<FrameImageType>;
   typename VTKExporterFilterType::Pointer vtkExportFilter = VTKExporterFilterType::New();
 
-  images.clear();
   for (unsigned int frameIndex = 0; frameIndex < self->GetNumberOfFrames(); frameIndex++)
   {
     extractionIndex[listDimIdx] = frameIndex;
@@ -239,6 +348,7 @@ void vtkITKImageSequenceReader::ExecuteDataWithInformation(vtkDataObject* output
   this->AxisUnits.clear();
   this->SequenceAxisLabel.clear();
   this->SequenceAxisUnit.clear();
+  this->FramesReadOnDemand = false;
 
   if (this->FileName == nullptr)
   {
@@ -368,6 +478,32 @@ void vtkITKImageSequenceReader::ExecuteDataWithInformation(vtkDataObject* output
 
     bool isPixelAxisListKind = vtkITKArchetypeImageSeriesReader::IsListPixelComponentTypeInMetaDataDictionary(thisDic);
 
+    // Frames can be read on demand if they are stored uncompressed, one after the other (along the last axis)
+    this->FramesReadOnDemand = false;
+    if (this->ReadFramesOnDemand && imageIO->GetNumberOfDimensions() == 4 && listDim >= 0
+        && listDim == static_cast<int>(imageIO->GetNumberOfDimensions() + baseDim) - 1)
+    {
+      unsigned long long dataOffset = 0;
+      bool bigEndian = false;
+      int scalarType = GetVTKScalarTypeFromITKComponentType(imageIO->GetComponentType());
+      if (scalarType != VTK_VOID && GetAttachedRawDataOffset(this->GetFileName(), dataOffset, bigEndian))
+      {
+        this->FramesReadOnDemand = true;
+        this->FrameLayout.DataOffset = dataOffset;
+        for (int i = 0; i < 3; i++)
+        {
+          this->FrameLayout.Dimensions[i] = static_cast<int>(imageIO->GetDimensions(i));
+        }
+        this->FrameLayout.ScalarType = scalarType;
+        this->FrameLayout.NumberOfComponents = static_cast<int>(imageIO->GetNumberOfComponents());
+#ifdef VTK_WORDS_BIGENDIAN
+        this->FrameLayout.ByteSwapRequired = !bigEndian;
+#else
+        this->FrameLayout.ByteSwapRequired = bigEndian;
+#endif
+      }
+    }
+
     // Load image from file
     switch (imageIO->GetNumberOfDimensions())
     {
@@ -382,7 +518,7 @@ void vtkITKImageSequenceReader::ExecuteDataWithInformation(vtkDataObject* output
               this->SetErrorCode(vtkErrorCode::UnrecognizedFileTypeError);
               return;
             }
-            vtkITKExecuteDataFromFile<itk::RGBPixel<unsigned char>, 3>(this, this->CachedImages, listDim, this->VoxelVectorType);
+            vtkITKExecuteDataFromFile<itk::RGBPixel<unsigned char>, 3>(this, this->CachedImages, listDim, this->VoxelVectorType, !this->FramesReadOnDemand);
             break;
           case itk::CommonEnums::IOPixel::RGBA:
             this->SetVoxelVectorType(vtkITKImageWriter::VoxelVectorTypeColorRGBA);
@@ -392,7 +528,7 @@ void vtkITKImageSequenceReader::ExecuteDataWithInformation(vtkDataObject* output
               this->SetErrorCode(vtkErrorCode::UnrecognizedFileTypeError);
               return;
             }
-            vtkITKExecuteDataFromFile<itk::RGBAPixel<unsigned char>, 3>(this, this->CachedImages, listDim, this->VoxelVectorType);
+            vtkITKExecuteDataFromFile<itk::RGBAPixel<unsigned char>, 3>(this, this->CachedImages, listDim, this->VoxelVectorType, !this->FramesReadOnDemand);
             break;
           case itk::CommonEnums::IOPixel::VECTOR:
             if (measurementFrameMatrixExplicitlySpecified && !isPixelAxisListKind)
@@ -407,19 +543,19 @@ void vtkITKImageSequenceReader::ExecuteDataWithInformation(vtkDataObject* output
             switch (imageIO->GetComponentType())
             {
               case itk::ImageIOBase::IOComponentEnum::UCHAR: //
-                vtkITKExecuteDataFromFile<itk::Vector<unsigned char>, 3>(this, this->CachedImages, listDim, this->VoxelVectorType);
+                vtkITKExecuteDataFromFile<itk::Vector<unsigned char>, 3>(this, this->CachedImages, listDim, this->VoxelVectorType, !this->FramesReadOnDemand);
                 break;
               case itk::ImageIOBase::IOComponentEnum::USHORT: //
-                vtkITKExecuteDataFromFile<itk::Vector<unsigned short>, 3>(this, this->CachedImages, listDim, this->VoxelVectorType);
+                vtkITKExecuteDataFromFile<itk::Vector<unsigned short>, 3>(this, this->CachedImages, listDim, this->VoxelVectorType, !this->FramesReadOnDemand);
                 break;
               case itk::ImageIOBase::IOComponentEnum::INT: //
-                vtkITKExecuteDataFromFile<itk::Vector<int>, 3>(this, this->CachedImages, listDim, this->VoxelVectorType);
+                vtkITKExecuteDataFromFile<itk::Vector<int>, 3>(this, this->CachedImages, listDim, this->VoxelVectorType, !this->FramesReadOnDemand);
                 break;
               case itk::ImageIOBase::IOComponentEnum::FLOAT: //
-                vtkITKExecuteDataFromFile<itk::Vector<float>, 3>(this, this->CachedImages, listDim, this->VoxelVectorType);
+                vtkITKExecuteDataFromFile<itk::Vector<float>, 3>(this, this->CachedImages, listDim, this->VoxelVectorType, !this->FramesReadOnDemand);
                 break;
               case itk::ImageIOBase::IOComponentEnum::DOUBLE: //
-                vtkITKExecuteDataFromFile<itk::Vector<double>, 3>(this, this->CachedImages, listDim, this->VoxelVectorType);
+                vtkITKExecuteDataFromFile<itk::Vector<double>, 3>(this, this->CachedImages, listDim, this->VoxelVectorType, !this->FramesReadOnDemand);
                 break;
               default:
                 vtkErrorMacro("Unexpected component type for 4 or less component vector voxel: " //
@@ -437,28 +573,28 @@ void vtkITKImageSequenceReader::ExecuteDataWithInformation(vtkDataObject* output
             switch (imageIO->GetComponentType())
             {
               case itk::ImageIOBase::IOComponentEnum::UCHAR: //
-                vtkITKExecuteDataFromFile<unsigned char, 4>(this, this->CachedImages, listDim, this->VoxelVectorType);
+                vtkITKExecuteDataFromFile<unsigned char, 4>(this, this->CachedImages, listDim, this->VoxelVectorType, !this->FramesReadOnDemand);
                 break;
               case itk::ImageIOBase::IOComponentEnum::CHAR: //
-                vtkITKExecuteDataFromFile<char, 4>(this, this->CachedImages, listDim, this->VoxelVectorType);
+                vtkITKExecuteDataFromFile<char, 4>(this, this->CachedImages, listDim, this->VoxelVectorType, !this->FramesReadOnDemand);
                 break;
               case itk::ImageIOBase::IOComponentEnum::USHORT: //
-                vtkITKExecuteDataFromFile<unsigned short, 4>(this, this->CachedImages, listDim, this->VoxelVectorType);
+                vtkITKExecuteDataFromFile<unsigned short, 4>(this, this->CachedImages, listDim, this->VoxelVectorType, !this->FramesReadOnDemand);
                 break;
               case itk::ImageIOBase::IOComponentEnum::SHORT: //
-                vtkITKExecuteDataFromFile<short, 4>(this, this->CachedImages, listDim, this->VoxelVectorType);
+                vtkITKExecuteDataFromFile<short, 4>(this, this->CachedImages, listDim, this->VoxelVectorType, !this->FramesReadOnDemand);
                 break;
               case itk::ImageIOBase::IOComponentEnum::INT: //
-                vtkITKExecuteDataFromFile<int, 4>(this, this->CachedImages, listDim, this->VoxelVectorType);
+                vtkITKExecuteDataFromFile<int, 4>(this, this->CachedImages, listDim, this->VoxelVectorType, !this->FramesReadOnDemand);
                 break;
               case itk::ImageIOBase::IOComponentEnum::UINT: //
-                vtkITKExecuteDataFromFile<unsigned int, 4>(this, this->CachedImages, listDim, this->VoxelVectorType);
+                vtkITKExecuteDataFromFile<unsigned int, 4>(this, this->CachedImages, listDim, this->VoxelVectorType, !this->FramesReadOnDemand);
                 break;
               case itk::ImageIOBase::IOComponentEnum::FLOAT: //
-                vtkITKExecuteDataFromFile<float, 4>(this, this->CachedImages, listDim, this->VoxelVectorType);
+                vtkITKExecuteDataFromFile<float, 4>(this, this->CachedImages, listDim, this->VoxelVectorType, !this->FramesReadOnDemand);
                 break;
               case itk::ImageIOBase::IOComponentEnum::DOUBLE: //
-                vtkITKExecuteDataFromFile<double, 4>(this, this->CachedImages, listDim, this->VoxelVectorType);
+                vtkITKExecuteDataFromFile<double, 4>(this, this->CachedImages, listDim, this->VoxelVectorType, !this->FramesReadOnDemand);
                 break;
               default:
                 vtkErrorMacro("Unexpected component type for scalar voxel: " //
@@ -475,7 +611,7 @@ void vtkITKImageSequenceReader::ExecuteDataWithInformation(vtkDataObject* output
               this->SetErrorCode(vtkErrorCode::UnrecognizedFileTypeError);
               return;
             }
-            vtkITKExecuteDataFromFile<itk::RGBPixel<unsigned char>, 4>(this, this->CachedImages, listDim, this->VoxelVectorType);
+            vtkITKExecuteDataFromFile<itk::RGBPixel<unsigned char>, 4>(this, this->CachedImages, listDim, this->VoxelVectorType, !this->FramesReadOnDemand);
             break;
           case itk::CommonEnums::IOPixel::RGBA:
             this->SetVoxelVectorType(vtkITKImageWriter::VoxelVectorTypeColorRGBA);
@@ -485,7 +621,7 @@ void vtkITKImageSequenceReader::ExecuteDataWithInformation(vtkDataObject* output
               this->SetErrorCode(vtkErrorCode::UnrecognizedFileTypeError);
               return;
             }
-            vtkITKExecuteDataFromFile<itk::RGBAPixel<unsigned char>, 4>(this, this->CachedImages, listDim, this->VoxelVectorType);
+            vtkITKExecuteDataFromFile<itk::RGBAPixel<unsigned char>, 4>(this, this->CachedImages, listDim, this->VoxelVectorType, !this->FramesReadOnDemand);
             break;
           case itk::CommonEnums::IOPixel::VECTOR:
             if (measurementFrameMatrixExplicitlySpecified)
@@ -503,19 +639,19 @@ void vtkITKImageSequenceReader::ExecuteDataWithInformation(vtkDataObject* output
                 switch (imageIO->GetComponentType())
                 {
                   case itk::ImageIOBase::IOComponentEnum::UCHAR: //
-                    vtkITKExecuteDataFromFile<itk::Vector<unsigned char>, 4>(this, this->CachedImages, listDim, this->VoxelVectorType);
+                    vtkITKExecuteDataFromFile<itk::Vector<unsigned char>, 4>(this, this->CachedImages, listDim, this->VoxelVectorType, !this->FramesReadOnDemand);
                     break;
                   case itk::ImageIOBase::IOComponentEnum::USHORT: //
-                    vtkITKExecuteDataFromFile<itk::Vector<unsigned short>, 4>(this, this->CachedImages, listDim, this->VoxelVectorType);
+                    vtkITKExecuteDataFromFile<itk::Vector<unsigned short>, 4>(this, this->CachedImages, listDim, this->VoxelVectorType, !this->FramesReadOnDemand);
                     break;
                   case itk::ImageIOBase::IOComponentEnum::INT: //
-                    vtkITKExecuteDataFromFile<itk::Vector<int>, 4>(this, this->CachedImages, listDim, this->VoxelVectorType);
+                    vtkITKExecuteDataFromFile<itk::Vector<int>, 4>(this, this->CachedImages, listDim, this->VoxelVectorType, !this->FramesReadOnDemand);
                     break;
                   case itk::ImageIOBase::IOComponentEnum::FLOAT: //
-                    vtkITKExecuteDataFromFile<itk::Vector<float>, 4>(this, this->CachedImages, listDim, this->VoxelVectorType);
+                    vtkITKExecuteDataFromFile<itk::Vector<float>, 4>(this, this->CachedImages, listDim, this->VoxelVectorType, !this->FramesReadOnDemand);
                     break;
                   case itk::ImageIOBase::IOComponentEnum::DOUBLE: //
-                    vtkITKExecuteDataFromFile<itk::Vector<double>, 4>(this, this->CachedImages, listDim, this->VoxelVectorType);
+                    vtkITKExecuteDataFromFile<itk::Vector<double>, 4>(this, this->CachedImages, listDim, this->VoxelVectorType, !this->FramesReadOnDemand);
                     break;
                   default:
                     vtkErrorMacro("Unexpected component type for vector voxel: " << imageIO->GetComponentTypeAsString(imageIO->GetComponentType()));
@@ -528,19 +664,19 @@ void vtkITKImageSequenceReader::ExecuteDataWithInformation(vtkDataObject* output
                 switch (imageIO->GetComponentType())
                 {
                   case itk::ImageIOBase::IOComponentEnum::UCHAR: //
-                    vtkITKExecuteDataFromFile<itk::Vector<unsigned char, 4>, 4>(this, this->CachedImages, listDim, this->VoxelVectorType);
+                    vtkITKExecuteDataFromFile<itk::Vector<unsigned char, 4>, 4>(this, this->CachedImages, listDim, this->VoxelVectorType, !this->FramesReadOnDemand);
                     break;
                   case itk::ImageIOBase::IOComponentEnum::USHORT: //
-                    vtkITKExecuteDataFromFile<itk::Vector<unsigned short, 4>, 4>(this, this->CachedImages, listDim, this->VoxelVectorType);
+                    vtkITKExecuteDataFromFile<itk::Vector<unsigned short, 4>, 4>(this, this->CachedImages, listDim, this->VoxelVectorType, !this->FramesReadOnDemand);
                     break;
                   case itk::ImageIOBase::IOComponentEnum::INT: //
-                    vtkITKExecuteDataFromFile<itk::Vector<int, 4>, 4>(this, this->CachedImages, listDim, this->VoxelVectorType);
+                    vtkITKExecuteDataFromFile<itk::Vector<int, 4>, 4>(this, this->CachedImages, listDim, this->VoxelVectorType, !this->FramesReadOnDemand);
                     break;
                   case itk::ImageIOBase::IOComponentEnum::FLOAT: //
-                    vtkITKExecuteDataFromFile<itk::Vector<float, 4>, 4>(this, this->CachedImages, listDim, this->VoxelVectorType);
+                    vtkITKExecuteDataFromFile<itk::Vector<float, 4>, 4>(this, this->CachedImages, listDim, this->VoxelVectorType, !this->FramesReadOnDemand);
                     break;
                   case itk::ImageIOBase::IOComponentEnum::DOUBLE: //
-                    vtkITKExecuteDataFromFile<itk::Vector<double, 4>, 4>(this, this->CachedImages, listDim, this->VoxelVectorType);
+                    vtkITKExecuteDataFromFile<itk::Vector<double, 4>, 4>(this, this->CachedImages, listDim, this->VoxelVectorType, !this->FramesReadOnDemand);
                     break;
                   default:
                     vtkErrorMacro("Unexpected component type for vector voxel: " << imageIO->GetComponentTypeAsString(imageIO->GetComponentType()));
@@ -555,19 +691,19 @@ void vtkITKImageSequenceReader::ExecuteDataWithInformation(vtkDataObject* output
             switch (imageIO->GetComponentType())
             {
               case itk::ImageIOBase::IOComponentEnum::UCHAR: //
-                vtkITKExecuteDataFromFile<itk::CovariantVector<unsigned char>, 4>(this, this->CachedImages, listDim, this->VoxelVectorType);
+                vtkITKExecuteDataFromFile<itk::CovariantVector<unsigned char>, 4>(this, this->CachedImages, listDim, this->VoxelVectorType, !this->FramesReadOnDemand);
                 break;
               case itk::ImageIOBase::IOComponentEnum::USHORT: //
-                vtkITKExecuteDataFromFile<itk::CovariantVector<unsigned short>, 4>(this, this->CachedImages, listDim, this->VoxelVectorType);
+                vtkITKExecuteDataFromFile<itk::CovariantVector<unsigned short>, 4>(this, this->CachedImages, listDim, this->VoxelVectorType, !this->FramesReadOnDemand);
                 break;
               case itk::ImageIOBase::IOComponentEnum::INT: //
-                vtkITKExecuteDataFromFile<itk::CovariantVector<int>, 4>(this, this->CachedImages, listDim, this->VoxelVectorType);
+                vtkITKExecuteDataFromFile<itk::CovariantVector<int>, 4>(this, this->CachedImages, listDim, this->VoxelVectorType, !this->FramesReadOnDemand);
                 break;
               case itk::ImageIOBase::IOComponentEnum::FLOAT: //
-                vtkITKExecuteDataFromFile<itk::CovariantVector<float>, 4>(this, this->CachedImages, listDim, this->VoxelVectorType);
+                vtkITKExecuteDataFromFile<itk::CovariantVector<float>, 4>(this, this->CachedImages, listDim, this->VoxelVectorType, !this->FramesReadOnDemand);
                 break;
               case itk::ImageIOBase::IOComponentEnum::DOUBLE: //
-                vtkITKExecuteDataFromFile<itk::CovariantVector<double>, 4>(this, this->CachedImages, listDim, this->VoxelVectorType);
+                vtkITKExecuteDataFromFile<itk::CovariantVector<double>, 4>(this, this->CachedImages, listDim, this->VoxelVectorType, !this->FramesReadOnDemand);
                 break;
               default:
                 vtkErrorMacro("Unexpected component type for covariant vector voxel: " << imageIO->GetComponentTypeAsString(imageIO->GetComponentType()));
@@ -596,6 +732,11 @@ void vtkITKImageSequenceReader::ExecuteDataWithInformation(vtkDataObject* output
     return;
   }
 
+  if (this->FramesReadOnDemand)
+  {
+    this->ReadFrame(this->GetCurrentFrameIndex(), data);
+    return;
+  }
   vtkImageData* loadedImage = this->GetCachedImage(this->GetCurrentFrameIndex());
   if (loadedImage && data)
   {
@@ -603,6 +744,57 @@ void vtkITKImageSequenceReader::ExecuteDataWithInformation(vtkDataObject* output
   }
 }
 
+//----------------------------------------------------------------------------
+bool vtkITKImageSequenceReader::ReadFrame(unsigned int frameIndex, vtkImageData* frameImage)
+{
+  if (!frameImage)
+  {
+    vtkErrorMacro("ReadFrame failed: invalid output image");
+    return false;
+  }
+  if (!this->FramesReadOnDemand || !this->FileName)
+  {
+    vtkErrorMacro("ReadFrame failed: frames are not read on demand");
+    return false;
+  }
+  if (frameIndex >= this->NumberOfFrames)
+  {
+    vtkErrorMacro("ReadFrame failed: frame index " << frameIndex << " is out of range (number of frames: " << this->NumberOfFrames << ")");
+    return false;
+  }
+
+  const int* dimensions = this->FrameLayout.Dimensions;
+  frameImage->SetOrigin(0.0, 0.0, 0.0);
+  frameImage->SetSpacing(1.0, 1.0, 1.0);
+  frameImage->SetExtent(0, dimensions[0] - 1, 0, dimensions[1] - 1, 0, dimensions[2] - 1);
+  frameImage->AllocateScalars(this->FrameLayout.ScalarType, this->FrameLayout.NumberOfComponents);
+  unsigned long long frameSizeInBytes = static_cast<unsigned long long>(frameImage->GetNumberOfPoints()) * frameImage->GetScalarSize() * this->FrameLayout.NumberOfComponents;
+
+  vtksys::ifstream file(this->FileName, std::ios::in | std::ios::binary);
+  if (!file.is_open())
+  {
+    vtkErrorMacro("ReadFrame failed: cannot open file " << this->FileName);
+    return false;
+  }
+  file.seekg(static_cast<std::streamoff>(this->FrameLayout.DataOffset + frameIndex * frameSizeInBytes));
+  file.read(static_cast<char*>(frameImage->GetScalarPointer()), static_cast<std::streamsize>(frameSizeInBytes));
+  if (!file)
+  {
+    vtkErrorMacro("ReadFrame failed: cannot read frame " << frameIndex << " from file " << this->FileName);
+    return false;
+  }
+
+  if (this->FrameLayout.ByteSwapRequired && frameImage->GetScalarSize() > 1)
+  {
+    vtkByteSwap::SwapVoidRange(frameImage->GetScalarPointer(), frameImage->GetNumberOfPoints() * this->FrameLayout.NumberOfComponents, frameImage->GetScalarSize());
+  }
+  if (this->VoxelVectorType == vtkITKImageWriter::VoxelVectorTypeSpatial || this->VoxelVectorType == vtkITKImageWriter::VoxelVectorTypeSpatialCovariant)
+  {
+    vtkITKImageWriter::ConvertSpatialVectorVoxelsBetweenRasLps(frameImage);
+  }
+  return true;
+}
+
 //----------------------------------------------------------------------------
 unsigned int vtkITKImageSequenceReader::GetNumberOfCachedImages()
 {
@@ -71,6 +71,25 @@ public:
   vtkImageData* GetCachedImage(unsigned int index);
   void ClearCachedImages();
 
+  /// Request reading of frames on demand. If enabled then Update() only reads the header
+  /// and frames can be read one by one using ReadFrame(), which allows accessing sequences
+  /// that do not fit into memory.
+  /// Frames can only be read individually from uncompressed (raw encoding) files that store
+  /// the frames along the last axis. All frames are cached as usual for other files.
+  /// By default = false.
+  vtkSetMacro(ReadFramesOnDemand, bool);
+  vtkGetMacro(ReadFramesOnDemand, bool);
+  vtkBooleanMacro(ReadFramesOnDemand, bool);
+
+  /// Returns true if the last Update() prepared reading frames on demand (no frames are cached).
+  vtkGetMacro(FramesReadOnDemand, bool);
+
+  /// Read a single frame directly from the file.
+  /// Only available if frames are read on demand (see GetFramesReadOnDemand()).
+  /// The frame has the same scalar type, components, and extent as cached images would have.
+  /// The reader is not modified, therefore frames can be read from multiple threads concurrently.
+  bool ReadFrame(unsigned int frameIndex, vtkImageData* frameImage);
+
 protected:
   vtkITKImageSequenceReader();
   ~vtkITKImageSequenceReader() override;
@@ -104,6 +123,20 @@ protected:
 
   std::vector<vtkSmartPointer<vtkImageData>> CachedImages;
 
+  bool ReadFramesOnDemand{ false };
+  bool FramesReadOnDemand{ false };
+
+  /// Layout of frame data in the file, used for reading frames on demand
+  struct FrameLayoutType
+  {
+    unsigned long long DataOffset{ 0 };
+    int Dimensions[3]{ 0, 0, 0 };
+    int ScalarType{ VTK_VOID };
+    int NumberOfComponents{ 0 };
+    bool ByteSwapRequired{ false };
+  };
+  FrameLayoutType FrameLayout;
+
 private:
   vtkITKImageSequenceReader(const vtkITKImageSequenceReader&) = delete;
   void operator=(const vtkITKImageSequenceReader&) = delete;
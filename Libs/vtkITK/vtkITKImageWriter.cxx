@@ -134,6 +134,10 @@ void ITKWriteVTKImage(vtkITKImageWriter* self,
   if (self->GetUseCompression())
   {
     itkImageWriter->UseCompressionOn();
+    if (self->GetCompressionLevel() >= 0)
+    {
+      itkImageWriter->SetCompressionLevel(self->GetCompressionLevel());
+    }
   }
   else
   {
@@ -228,6 +232,7 @@ vtkITKImageWriter::vtkITKImageWriter()
   this->RasToIJKMatrix = nullptr;
   this->MeasurementFrameMatrix = nullptr;
   this->UseCompression = 0;
+  this->CompressionLevel = -1;
   this->ImageIOClassName = nullptr;
   this->VoxelVectorType = vtkITKImageWriter::VoxelVectorTypeUndefined;
 }
@@ -256,6 +261,8 @@ void vtkITKImageWriter::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "FileName: " << (this->FileName ? this->FileName : "(none)") << "\n";
   os << indent << "ImageIOClassName: " << (this->ImageIOClassName ? this->ImageIOClassName : "(none)") << "\n";
+  os << indent << "UseCompression: " << this->UseCompression << "\n";
+  os << indent << "CompressionLevel: " << this->CompressionLevel << "\n";
 }
 
 //----------------------------------------------------------------------------
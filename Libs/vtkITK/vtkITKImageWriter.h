@@ -66,6 +66,12 @@ public:
   vtkSetMacro(UseCompression, int);
   vtkBooleanMacro(UseCompression, int);
 
+  ///
+  /// Set/Get the compression level. Valid range depends on the ImageIO (1-9 for zlib-based formats).
+  /// Negative value means that the default compression level of the ImageIO is used.
+  vtkGetMacro(CompressionLevel, int);
+  vtkSetMacro(CompressionLevel, int);
+
   ///
   /// Set/Get the ImageIO class name.
   vtkGetStringMacro(ImageIOClassName);
@@ -99,6 +105,7 @@ protected:
   vtkMatrix4x4* RasToIJKMatrix;
   vtkMatrix4x4* MeasurementFrameMatrix;
   int UseCompression;
+  int CompressionLevel;
   char* ImageIOClassName;
   int VoxelVectorType;
 
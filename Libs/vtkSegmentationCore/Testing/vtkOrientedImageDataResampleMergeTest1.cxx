@@ -0,0 +1,281 @@
+/*==============================================================================
+
+  Copyright (c) Laboratory for Percutaneous Surgery (PerkLab)
+  Queen's University, Kingston, ON, Canada. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// VTK includes
+#include <vtkMinimalStandardRandomSequence.h>
+#include <vtkNew.h>
+#include <vtkTimerLog.h>
+
+// SegmentationCore includes
+#include "vtkOrientedImageData.h"
+#include "vtkOrientedImageDataResample.h"
+
+// STD includes
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+// Get CHECK_INT from vtkAddonTestingMacros.h to avoid dependency on vtkAddon
+namespace
+{
+
+//----------------------------------------------------------------------------
+bool CheckInt(int line, const std::string& description, int current, int expected)
+{
+  if (current == expected)
+  {
+    return EXIT_SUCCESS;
+  }
+  std::cerr << "\nLine " << line << " - " << description.c_str() << " : test failed"
+            << "\n\tcurrent :" << current << "\n\texpected:" << expected << std::endl;
+  return EXIT_FAILURE;
+}
+
+// Use a macro to be able to print the evaluated expression and the line number
+#define CHECK_INT(actual, expected)                                                         \
+  {                                                                                         \
+    if (CheckInt(__LINE__, #actual " != " #expected, (actual), (expected)) != EXIT_SUCCESS) \
+    {                                                                                       \
+      return EXIT_FAILURE;                                                                  \
+    }                                                                                       \
+  }
+
+//----------------------------------------------------------------------------
+/// Create a labelmap where about fillRatio of the voxels in the fill extent are set to random labels (1..numberOfLabels)
+void CreateRandomLabelmap(vtkOrientedImageData* image,
+                          const int extent[6],
+                          const int fillExtent[6],
+                          double fillRatio,
+                          int numberOfLabels,
+                          vtkMinimalStandardRandomSequence* random)
+{
+  image->SetExtent(const_cast<int*>(extent));
+  image->AllocateScalars(VTK_SHORT, 1);
+  memset(image->GetScalarPointer(), 0, image->GetNumberOfPoints() * image->GetScalarSize());
+  for (int k = fillExtent[4]; k <= fillExtent[5]; ++k)
+  {
+    for (int j = fillExtent[2]; j <= fillExtent[3]; ++j)
+    {
+      short* voxelPtr = static_cast<short*>(image->GetScalarPointer(fillExtent[0], j, k));
+      for (int i = fillExtent[0]; i <= fillExtent[1]; ++i, ++voxelPtr)
+      {
+        random->Next();
+        if (random->GetValue() < fillRatio)
+        {
+          random->Next();
+          *voxelPtr = static_cast<short>(1 + random->GetValue() * numberOfLabels) % (numberOfLabels + 1);
+        }
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+/// Straightforward per-voxel implementation of vtkOrientedImageDataResample::ModifyImage, used as reference.
+/// Both images must have the same extent.
+void ModifyImageReference(vtkOrientedImageData* baseImage, vtkOrientedImageData* modifierImage, int operation, short maskThreshold, short fillValue)
+{
+  short* basePtr = static_cast<short*>(baseImage->GetScalarPointer());
+  short* modifierPtr = static_cast<short*>(modifierImage->GetScalarPointer());
+  vtkIdType numberOfVoxels = baseImage->GetNumberOfPoints();
+  for (vtkIdType voxelIndex = 0; voxelIndex < numberOfVoxels; ++voxelIndex)
+  {
+    if (operation == vtkOrientedImageDataResample::OPERATION_MAXIMUM)
+    {
+      basePtr[voxelIndex] = std::max(basePtr[voxelIndex], modifierPtr[voxelIndex]);
+    }
+    else if (operation == vtkOrientedImageDataResample::OPERATION_MINIMUM)
+    {
+      basePtr[voxelIndex] = std::min(basePtr[voxelIndex], modifierPtr[voxelIndex]);
+    }
+    else if (operation == vtkOrientedImageDataResample::OPERATION_MASKING)
+    {
+      if (modifierPtr[voxelIndex] > maskThreshold)
+      {
+        basePtr[voxelIndex] = fillValue;
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+/// Straightforward per-voxel implementation of vtkOrientedImageDataResample::CalculateEffectiveExtent, used as reference.
+void CalculateEffectiveExtentReference(vtkOrientedImageData* image, int effectiveExtent[6])
+{
+  int* extent = image->GetExtent();
+  effectiveExtent[0] = extent[1] + 1;
+  effectiveExtent[1] = extent[0] - 1;
+  effectiveExtent[2] = extent[3] + 1;
+  effectiveExtent[3] = extent[2] - 1;
+  effectiveExtent[4] = extent[5] + 1;
+  effectiveExtent[5] = extent[4] - 1;
+  for (int k = extent[4]; k <= extent[5]; ++k)
+  {
+    for (int j = extent[2]; j <= extent[3]; ++j)
+    {
+      short* voxelPtr = static_cast<short*>(image->GetScalarPointer(extent[0], j, k));
+      for (int i = extent[0]; i <= extent[1]; ++i, ++voxelPtr)
+      {
+        if (*voxelPtr > 0)
+        {
+          effectiveExtent[0] = std::min(effectiveExtent[0], i);
+          effectiveExtent[1] = std::max(effectiveExtent[1], i);
+          effectiveExtent[2] = std::min(effectiveExtent[2], j);
+          effectiveExtent[3] = std::max(effectiveExtent[3], j);
+          effectiveExtent[4] = std::min(effectiveExtent[4], k);
+          effectiveExtent[5] = std::max(effectiveExtent[5], k);
+        }
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+int TestModifyImage(vtkOrientedImageData* baseImage, vtkOrientedImageData* modifierImage, int operation, const char* operationName)
+{
+  vtkNew<vtkOrientedImageData> referenceImage;
+  referenceImage->DeepCopy(baseImage);
+  vtkNew<vtkOrientedImageData> modifiedImage;
+  modifiedImage->DeepCopy(baseImage);
+
+  const short maskThreshold = 1;
+  const short fillValue = 7;
+
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  ModifyImageReference(referenceImage, modifierImage, operation, maskThreshold, fillValue);
+  timer->StopTimer();
+  double referenceTime = timer->GetElapsedTime();
+
+  timer->StartTimer();
+  CHECK_INT(vtkOrientedImageDataResample::ModifyImage(modifiedImage, modifierImage, operation, nullptr, maskThreshold, fillValue), true);
+  timer->StopTimer();
+  double optimizedTime = timer->GetElapsedTime();
+
+  CHECK_INT(memcmp(modifiedImage->GetScalarPointer(), referenceImage->GetScalarPointer(), baseImage->GetNumberOfPoints() * baseImage->GetScalarSize()), 0);
+
+  std::cout << operationName << ": reference " << referenceTime << " s, optimized " << optimizedTime << " s" << std::endl;
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestEffectiveExtent(vtkOrientedImageData* image, const char* imageName)
+{
+  int referenceExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  int effectiveExtent[6] = { 0, -1, 0, -1, 0, -1 };
+
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  CalculateEffectiveExtentReference(image, referenceExtent);
+  timer->StopTimer();
+  double referenceTime = timer->GetElapsedTime();
+
+  timer->StartTimer();
+  vtkOrientedImageDataResample::CalculateEffectiveExtent(image, effectiveExtent);
+  timer->StopTimer();
+  double optimizedTime = timer->GetElapsedTime();
+
+  for (int i = 0; i < 6; ++i)
+  {
+    CHECK_INT(effectiveExtent[i], referenceExtent[i]);
+  }
+
+  std::cout << "Effective extent of " << imageName << ": reference " << referenceTime << " s, optimized " << optimizedTime << " s" << std::endl;
+  return EXIT_SUCCESS;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+/// Verifies the labelmap merge and effective extent computation against straightforward implementations
+/// and reports computation times. Image size can be specified as first argument (default: 128) to use
+/// the test as a benchmark with realistic image sizes (for example 512).
+int vtkOrientedImageDataResampleMergeTest1(int argc, char* argv[])
+{
+  int size = 128;
+  if (argc > 1)
+  {
+    size = std::max(atoi(argv[1]), 16);
+  }
+  std::cout << "Image size: " << size << "x" << size << "x" << size << std::endl;
+
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(1);
+
+  // Odd extents to test rows that are not multiple of vector sizes
+  const int extent[6] = { -3, size - 3, 1, size, 0, size - 1 };
+
+  vtkNew<vtkOrientedImageData> baseImage;
+  CreateRandomLabelmap(baseImage, extent, extent, 0.3, 5, random);
+  vtkNew<vtkOrientedImageData> modifierImage;
+  CreateRandomLabelmap(modifierImage, extent, extent, 0.1, 5, random);
+
+  if (TestModifyImage(baseImage, modifierImage, vtkOrientedImageDataResample::OPERATION_MAXIMUM, "Maximum") != EXIT_SUCCESS //
+      || TestModifyImage(baseImage, modifierImage, vtkOrientedImageDataResample::OPERATION_MINIMUM, "Minimum") != EXIT_SUCCESS
+      || TestModifyImage(baseImage, modifierImage, vtkOrientedImageDataResample::OPERATION_MASKING, "Masking") != EXIT_SUCCESS)
+  {
+    return EXIT_FAILURE;
+  }
+
+  // Modifier with smaller extent
+  vtkNew<vtkOrientedImageData> smallModifierImage;
+  const int smallExtent[6] = { 5, size / 2 + 1, 3, size / 2, 2, size / 3 };
+  CreateRandomLabelmap(smallModifierImage, smallExtent, smallExtent, 0.5, 5, random);
+  vtkNew<vtkOrientedImageData> referenceImage;
+  referenceImage->DeepCopy(baseImage);
+  for (int k = smallExtent[4]; k <= smallExtent[5]; ++k)
+  {
+    for (int j = smallExtent[2]; j <= smallExtent[3]; ++j)
+    {
+      for (int i = smallExtent[0]; i <= smallExtent[1]; ++i)
+      {
+        short* referenceVoxel = static_cast<short*>(referenceImage->GetScalarPointer(i, j, k));
+        *referenceVoxel = std::max(*referenceVoxel, *static_cast<short*>(smallModifierImage->GetScalarPointer(i, j, k)));
+      }
+    }
+  }
+  CHECK_INT(vtkOrientedImageDataResample::ModifyImage(baseImage, smallModifierImage, vtkOrientedImageDataResample::OPERATION_MAXIMUM), true);
+  CHECK_INT(memcmp(baseImage->GetScalarPointer(), referenceImage->GetScalarPointer(), baseImage->GetNumberOfPoints() * baseImage->GetScalarSize()), 0);
+
+  // Effective extent of dense, sparse, single voxel, and empty images
+  if (TestEffectiveExtent(baseImage, "dense image") != EXIT_SUCCESS)
+  {
+    return EXIT_FAILURE;
+  }
+  vtkNew<vtkOrientedImageData> sparseImage;
+  const int sparseFillExtent[6] = { size / 4, size - 7, size / 3, size / 2, 5, size - 10 };
+  CreateRandomLabelmap(sparseImage, extent, sparseFillExtent, 0.001, 1, random);
+  if (TestEffectiveExtent(sparseImage, "sparse image") != EXIT_SUCCESS)
+  {
+    return EXIT_FAILURE;
+  }
+  vtkNew<vtkOrientedImageData> singleVoxelImage;
+  CreateRandomLabelmap(singleVoxelImage, extent, extent, 0.0, 1, random);
+  *static_cast<short*>(singleVoxelImage->GetScalarPointer(size - 3, size / 2, size / 2)) = 1;
+  if (TestEffectiveExtent(singleVoxelImage, "single voxel image") != EXIT_SUCCESS)
+  {
+    return EXIT_FAILURE;
+  }
+  vtkNew<vtkOrientedImageData> emptyImage;
+  CreateRandomLabelmap(emptyImage, extent, extent, 0.0, 1, random);
+  if (TestEffectiveExtent(emptyImage, "empty image") != EXIT_SUCCESS)
+  {
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Oriented image data merge test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -83,6 +83,206 @@ int GetVoxelCount(vtkImageData* labelmap, int labelValue)
   return accumulate->GetVoxelCount();
 }
 
+//----------------------------------------------------------------------------
+int TestDeltaCompression()
+{
+  int segment1LabelValue = 1;
+  int segment2LabelValue = 2;
+
+  vtkNew<vtkSegment> segment1;
+  segment1->SetName("Segment_1");
+  segment1->SetLabelValue(segment1LabelValue);
+  vtkNew<vtkSegment> segment2;
+  segment2->SetName("Segment_2");
+  segment2->SetLabelValue(segment2LabelValue);
+
+  vtkNew<vtkOrientedImageData> labelmap;
+  segment1->AddRepresentation(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName(), labelmap);
+  segment2->AddRepresentation(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName(), labelmap);
+
+  vtkNew<vtkSegmentation> segmentation;
+  segmentation->AddSegment(segment1);
+  segmentation->AddSegment(segment2);
+
+  vtkNew<vtkSegmentationHistory> history;
+  history->SetSegmentation(segmentation);
+  history->DeltaCompressionOn();
+  history->SetMaximumNumberOfStates(10);
+
+  int segmentExtent[6] = { 0, 63, 0, 63, 0, 63 };
+  CreateCubeLabelmap(labelmap, segmentExtent);
+  history->SaveState();
+  CHECK_INT(history->GetNumberOfStates(), 1);
+  vtkTypeInt64 fullStateMemorySize = history->GetMemorySize();
+
+  int originalSegment1VoxelCount = GetVoxelCount(labelmap, segment1LabelValue);
+  int originalSegment2VoxelCount = GetVoxelCount(labelmap, segment2LabelValue);
+
+  // First modification
+  int modifierExtent1[6] = { 5, 10, 5, 15, 15, 20 };
+  vtkNew<vtkOrientedImageData> modifierLabelmap1;
+  CreateCubeLabelmap(modifierLabelmap1, modifierExtent1);
+  vtkOrientedImageDataResample::ModifyImage(labelmap, modifierLabelmap1, vtkOrientedImageDataResample::OPERATION_MASKING, nullptr, 0.0, 2.0);
+  int modified1Segment1VoxelCount = GetVoxelCount(labelmap, segment1LabelValue);
+  int modified1Segment2VoxelCount = GetVoxelCount(labelmap, segment2LabelValue);
+  history->SaveState();
+  CHECK_INT(history->GetNumberOfStates(), 2);
+
+  // Only the most recent state is stored in full, the previous state only stores the changed region
+  if (history->GetMemorySize() > fullStateMemorySize * 3 / 2)
+  {
+    std::cerr << "Delta-compressed history memory size (" << history->GetMemorySize() << ") is too large compared to a single state memory size ("
+              << fullStateMemorySize << ")" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Second modification
+  int modifierExtent2[6] = { 30, 40, 20, 25, 40, 50 };
+  vtkNew<vtkOrientedImageData> modifierLabelmap2;
+  CreateCubeLabelmap(modifierLabelmap2, modifierExtent2);
+  vtkOrientedImageDataResample::ModifyImage(labelmap, modifierLabelmap2, vtkOrientedImageDataResample::OPERATION_MASKING, nullptr, 0.0, 2.0);
+  int modified2Segment1VoxelCount = GetVoxelCount(labelmap, segment1LabelValue);
+  int modified2Segment2VoxelCount = GetVoxelCount(labelmap, segment2LabelValue);
+
+  // Undo twice
+  history->RestorePreviousState();
+  CHECK_INT(history->GetNumberOfStates(), 3);
+  vtkOrientedImageData* restoredLabelmap = vtkOrientedImageData::SafeDownCast(segment1->GetRepresentation(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName()));
+  CHECK_INT(GetVoxelCount(restoredLabelmap, segment1LabelValue), modified1Segment1VoxelCount);
+  CHECK_INT(GetVoxelCount(restoredLabelmap, segment2LabelValue), modified1Segment2VoxelCount);
+
+  history->RestorePreviousState();
+  restoredLabelmap = vtkOrientedImageData::SafeDownCast(segment1->GetRepresentation(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName()));
+  CHECK_INT(GetVoxelCount(restoredLabelmap, segment1LabelValue), originalSegment1VoxelCount);
+  CHECK_INT(GetVoxelCount(restoredLabelmap, segment2LabelValue), originalSegment2VoxelCount);
+
+  // Redo twice
+  history->RestoreNextState();
+  history->RestoreNextState();
+  CHECK_INT(history->GetNumberOfStates(), 3);
+  restoredLabelmap = vtkOrientedImageData::SafeDownCast(segment1->GetRepresentation(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName()));
+  CHECK_INT(GetVoxelCount(restoredLabelmap, segment1LabelValue), modified2Segment1VoxelCount);
+  CHECK_INT(GetVoxelCount(restoredLabelmap, segment2LabelValue), modified2Segment2VoxelCount);
+
+  // Undo, then modify the segmentation: future states are removed and the last restored state becomes the most recent
+  history->RestorePreviousState();
+  restoredLabelmap = vtkOrientedImageData::SafeDownCast(segment1->GetRepresentation(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName()));
+  vtkOrientedImageDataResample::ModifyImage(restoredLabelmap, modifierLabelmap2, vtkOrientedImageDataResample::OPERATION_MASKING, nullptr, 0.0, 2.0);
+  CHECK_INT(history->GetNumberOfStates(), 2);
+  history->RestorePreviousState();
+  CHECK_INT(history->GetNumberOfStates(), 3);
+  restoredLabelmap = vtkOrientedImageData::SafeDownCast(segment1->GetRepresentation(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName()));
+  CHECK_INT(GetVoxelCount(restoredLabelmap, segment1LabelValue), modified1Segment1VoxelCount);
+  CHECK_INT(GetVoxelCount(restoredLabelmap, segment2LabelValue), modified1Segment2VoxelCount);
+
+  // Memory limit removes the oldest states (but the last restored state is kept)
+  history->SetMaximumMemorySize(1);
+  CHECK_INT(history->GetNumberOfStates(), 2);
+
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+// Labelmaps that are not modified between states are shared between the states
+// and compressed only in the most recent state that contains them.
+int TestDeltaCompressionSharedLabelmaps()
+{
+  const std::string labelmapName = vtkSegmentationConverter::GetBinaryLabelmapRepresentationName();
+
+  // Each segment is in a separate layer
+  vtkNew<vtkSegment> segment1;
+  segment1->SetName("Segment_1");
+  segment1->SetLabelValue(1);
+  vtkNew<vtkSegment> segment2;
+  segment2->SetName("Segment_2");
+  segment2->SetLabelValue(1);
+  vtkNew<vtkOrientedImageData> labelmap1;
+  vtkNew<vtkOrientedImageData> labelmap2;
+  int segmentExtent[6] = { 0, 63, 0, 63, 0, 63 };
+  CreateCubeLabelmap(labelmap1, segmentExtent);
+  CreateCubeLabelmap(labelmap2, segmentExtent);
+  segment1->AddRepresentation(labelmapName, labelmap1);
+  segment2->AddRepresentation(labelmapName, labelmap2);
+
+  vtkNew<vtkSegmentation> segmentation;
+  segmentation->AddSegment(segment1, "Segment_1");
+  segmentation->AddSegment(segment2, "Segment_2");
+
+  vtkNew<vtkSegmentationHistory> history;
+  history->SetSegmentation(segmentation);
+  history->DeltaCompressionOn();
+  history->SetMaximumNumberOfStates(10);
+
+  auto getVoxelCount = [&](const char* segmentId)
+  { return GetVoxelCount(vtkOrientedImageData::SafeDownCast(segmentation->GetSegment(segmentId)->GetRepresentation(labelmapName)), 1); };
+
+  // State 0: original
+  history->SaveState();
+  int state0Segment1VoxelCount = getVoxelCount("Segment_1");
+  int state0Segment2VoxelCount = getVoxelCount("Segment_2");
+
+  // State 1: only layer 1 is modified (layer 2 is shared between state 0 and 1)
+  int modifierExtent1[6] = { 5, 10, 5, 15, 15, 20 };
+  vtkNew<vtkOrientedImageData> modifierLabelmap1;
+  CreateCubeLabelmap(modifierLabelmap1, modifierExtent1);
+  vtkOrientedImageDataResample::ModifyImage(labelmap1, modifierLabelmap1, vtkOrientedImageDataResample::OPERATION_MASKING, nullptr, 0.0, 0.0);
+  history->SaveState();
+  int state1Segment1VoxelCount = getVoxelCount("Segment_1");
+  int state1Segment2VoxelCount = getVoxelCount("Segment_2");
+  CHECK_INT(state1Segment2VoxelCount, state0Segment2VoxelCount);
+
+  // State 2: only layer 2 is modified (the layer 2 that state 0 and 1 share is compressed in state 1)
+  int modifierExtent2[6] = { 30, 40, 20, 25, 40, 50 };
+  vtkNew<vtkOrientedImageData> modifierLabelmap2;
+  CreateCubeLabelmap(modifierLabelmap2, modifierExtent2);
+  vtkOrientedImageDataResample::ModifyImage(labelmap2, modifierLabelmap2, vtkOrientedImageDataResample::OPERATION_MASKING, nullptr, 0.0, 0.0);
+  history->SaveState();
+  CHECK_INT(history->GetNumberOfStates(), 3);
+  int state2Segment1VoxelCount = getVoxelCount("Segment_1");
+  int state2Segment2VoxelCount = getVoxelCount("Segment_2");
+  if (state1Segment1VoxelCount == state0Segment1VoxelCount || state2Segment2VoxelCount == state1Segment2VoxelCount)
+  {
+    std::cerr << "Line " << __LINE__ << ": labelmap modification failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Undo to state 0, layer 2 is reconstructed using the delta stored in state 1
+  history->RestorePreviousState();
+  CHECK_INT(getVoxelCount("Segment_1"), state1Segment1VoxelCount);
+  CHECK_INT(getVoxelCount("Segment_2"), state1Segment2VoxelCount);
+  history->RestorePreviousState();
+  CHECK_INT(getVoxelCount("Segment_1"), state0Segment1VoxelCount);
+  CHECK_INT(getVoxelCount("Segment_2"), state0Segment2VoxelCount);
+
+  // Redo
+  history->RestoreNextState();
+  CHECK_INT(getVoxelCount("Segment_1"), state1Segment1VoxelCount);
+  CHECK_INT(getVoxelCount("Segment_2"), state1Segment2VoxelCount);
+  history->RestoreNextState();
+  CHECK_INT(getVoxelCount("Segment_1"), state2Segment1VoxelCount);
+  CHECK_INT(getVoxelCount("Segment_2"), state2Segment2VoxelCount);
+
+  // Undo to state 0 and modify the segmentation: state 0 becomes the most recent state,
+  // therefore its shared layer must be reconstructed before the more recent states are removed.
+  history->RestorePreviousState();
+  history->RestorePreviousState();
+  vtkOrientedImageDataResample::ModifyImage(vtkOrientedImageData::SafeDownCast(segmentation->GetSegment("Segment_1")->GetRepresentation(labelmapName)),
+                                            modifierLabelmap2,
+                                            vtkOrientedImageDataResample::OPERATION_MASKING,
+                                            nullptr,
+                                            0.0,
+                                            0.0);
+  segmentation->InvokeEvent(vtkSegmentation::SourceRepresentationModified);
+  CHECK_INT(history->GetNumberOfStates(), 1);
+  history->SaveState();
+  CHECK_INT(history->GetNumberOfStates(), 2);
+  history->RestorePreviousState();
+  CHECK_INT(getVoxelCount("Segment_1"), state0Segment1VoxelCount);
+  CHECK_INT(getVoxelCount("Segment_2"), state0Segment2VoxelCount);
+
+  return EXIT_SUCCESS;
+}
+
 //----------------------------------------------------------------------------
 int vtkSegmentationHistoryTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
 {
@@ -237,6 +437,17 @@ int vtkSegmentationHistoryTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
   // restoring previous state saves the current modified state
   CHECK_INT(history->GetNumberOfStates(), 3);
 
+  if (TestDeltaCompression() != EXIT_SUCCESS)
+  {
+    std::cerr << "Segmentation history delta compression test failed." << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (TestDeltaCompressionSharedLabelmaps() != EXIT_SUCCESS)
+  {
+    std::cerr << "Segmentation history delta compression of shared labelmaps test failed." << std::endl;
+    return EXIT_FAILURE;
+  }
+
   std::cout << "Segmentation history test 1 passed." << std::endl;
   return EXIT_SUCCESS;
 }
@@ -19,7 +19,9 @@
 ==============================================================================*/
 
 // VTK includes
+#include <vtkFeatureEdges.h>
 #include <vtkNew.h>
+#include <vtkVariant.h>
 #include <vtkVersion.h>
 #include <vtkPointData.h>
 #include <vtkPolyData.h>
@@ -34,6 +36,7 @@
 #include "vtkOrientedImageData.h"
 #include "vtkOrientedImageDataResample.h"
 #include "vtkSegmentationConverterFactory.h"
+#include "vtkSegmentationModifier.h"
 #include "vtkBinaryLabelmapToClosedSurfaceConversionRule.h"
 #include "vtkClosedSurfaceToBinaryLabelmapConversionRule.h"
 
@@ -397,6 +400,156 @@ bool TestLabelmapValidation()
   return true;
 }
 
+//----------------------------------------------------------------------------
+/// Returns the number of boundary and non-manifold edges of the surface (0 for watertight surfaces)
+vtkIdType GetNumberOfOpenEdges(vtkPolyData* surface)
+{
+  vtkNew<vtkFeatureEdges> featureEdges;
+  featureEdges->SetInputData(surface);
+  featureEdges->BoundaryEdgesOn();
+  featureEdges->NonManifoldEdgesOn();
+  featureEdges->FeatureEdgesOff();
+  featureEdges->ManifoldEdgesOff();
+  featureEdges->Update();
+  return featureEdges->GetOutput()->GetNumberOfCells();
+}
+
+//----------------------------------------------------------------------------
+bool CompareIncrementalClosedSurface(vtkSegment* segment, const std::string& smoothingFactor, const std::string& decimationFactor)
+{
+  vtkPolyData* incrementalSurface = vtkPolyData::SafeDownCast(segment->GetRepresentation(vtkSegmentationConverter::GetClosedSurfaceRepresentationName()));
+  if (!incrementalSurface || incrementalSurface->GetNumberOfPolys() == 0)
+  {
+    std::cerr << __LINE__ << ": Incrementally updated surface is empty" << std::endl;
+    return false;
+  }
+
+  // Bricks must be merged into a watertight surface
+  vtkIdType numberOfOpenEdges = GetNumberOfOpenEdges(incrementalSurface);
+  if (numberOfOpenEdges != 0)
+  {
+    std::cerr << __LINE__ << ": Incrementally updated surface has " << numberOfOpenEdges << " boundary or non-manifold edges, should be 0" << std::endl;
+    return false;
+  }
+
+  // Compare with the surface that is generated from the entire labelmap
+  vtkNew<vtkBinaryLabelmapToClosedSurfaceConversionRule> rule;
+  rule->SetConversionParameter(vtkBinaryLabelmapToClosedSurfaceConversionRule::GetSmoothingFactorParameterName(), smoothingFactor);
+  rule->SetConversionParameter(vtkBinaryLabelmapToClosedSurfaceConversionRule::GetDecimationFactorParameterName(), decimationFactor);
+  vtkNew<vtkPolyData> fullSurface;
+  vtkOrientedImageData* modifiedLabelmap = vtkOrientedImageData::SafeDownCast(segment->GetRepresentation(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName()));
+  rule->CreateClosedSurface(modifiedLabelmap, fullSurface, { segment->GetLabelValue() });
+
+  bool decimated = (vtkVariant(decimationFactor).ToDouble() > 0.0);
+  if (!decimated)
+  {
+    // Without decimation the merged bricks have the same mesh as the full surface
+    if (incrementalSurface->GetNumberOfPolys() != fullSurface->GetNumberOfPolys() //
+        || incrementalSurface->GetNumberOfPoints() != fullSurface->GetNumberOfPoints())
+    {
+      std::cerr << __LINE__ << ": Incrementally updated surface has " << incrementalSurface->GetNumberOfPolys() << " polygons and " << incrementalSurface->GetNumberOfPoints()
+                << " points, should be " << fullSurface->GetNumberOfPolys() << " polygons and " << fullSurface->GetNumberOfPoints() << " points" << std::endl;
+      return false;
+    }
+  }
+  else
+  {
+    // Brick boundaries are not decimated, therefore somewhat more polygons remain
+    if (incrementalSurface->GetNumberOfPolys() < fullSurface->GetNumberOfPolys() / 2 //
+        || incrementalSurface->GetNumberOfPolys() > fullSurface->GetNumberOfPolys() * 2)
+    {
+      std::cerr << __LINE__ << ": Incrementally updated surface has " << incrementalSurface->GetNumberOfPolys() << " polygons, expected about " << fullSurface->GetNumberOfPolys()
+                << std::endl;
+      return false;
+    }
+  }
+
+  // Smoothing of the merged surface gives the same result (up to floating-point rounding) as smoothing the full surface
+  const double boundsTolerance = decimated ? 0.5 : 1e-3;
+  double incrementalBounds[6] = { 0.0, -1.0, 0.0, -1.0, 0.0, -1.0 };
+  double fullBounds[6] = { 0.0, -1.0, 0.0, -1.0, 0.0, -1.0 };
+  incrementalSurface->GetBounds(incrementalBounds);
+  fullSurface->GetBounds(fullBounds);
+  for (int i = 0; i < 6; ++i)
+  {
+    if (fabs(incrementalBounds[i] - fullBounds[i]) > boundsTolerance)
+    {
+      std::cerr << __LINE__ << ": Incrementally updated surface bounds mismatch at index " << i << ": " << incrementalBounds[i] << " should be " << fullBounds[i] << std::endl;
+      return false;
+    }
+  }
+
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool TestIncrementalClosedSurfaceUpdate(const std::string& smoothingFactor, const std::string& decimationFactor)
+{
+  std::cout << "Test incremental closed surface update with smoothing factor " << smoothingFactor << ", decimation factor " << decimationFactor << std::endl;
+
+  // Labelmap that spans multiple bricks
+  vtkNew<vtkOrientedImageData> labelmap;
+  int labelmapExtent[6] = { 0, 99, 0, 79, 0, 9 };
+  CreateCubeLabelmap(labelmap, labelmapExtent);
+
+  vtkNew<vtkSegment> segment;
+  segment->SetName("cube");
+  segment->AddRepresentation(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName(), labelmap);
+
+  vtkNew<vtkSegmentation> segmentation;
+  segmentation->SetSourceRepresentationName(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName());
+  segmentation->AddSegment(segment, "cube");
+  segmentation->SetConversionParameter(vtkBinaryLabelmapToClosedSurfaceConversionRule::GetSmoothingFactorParameterName(), smoothingFactor);
+  segmentation->SetConversionParameter(vtkBinaryLabelmapToClosedSurfaceConversionRule::GetDecimationFactorParameterName(), decimationFactor);
+  segmentation->SetConversionParameter(vtkBinaryLabelmapToClosedSurfaceConversionRule::GetIncrementalUpdateParameterName(), "1");
+  if (!segmentation->CreateRepresentation(vtkSegmentationConverter::GetClosedSurfaceRepresentationName()))
+  {
+    std::cerr << __LINE__ << ": Failed to create closed surface representation" << std::endl;
+    return false;
+  }
+
+  // Remove a box from the segment, crossing brick boundaries
+  vtkNew<vtkOrientedImageData> eraseLabelmap;
+  int eraseExtent[6] = { 50, 79, 20, 69, 3, 6 };
+  CreateCubeLabelmap(eraseLabelmap, eraseExtent);
+  memset(eraseLabelmap->GetScalarPointer(), 0, eraseLabelmap->GetNumberOfPoints() * eraseLabelmap->GetScalarSize());
+  if (!vtkSegmentationModifier::ModifyBinaryLabelmap(eraseLabelmap, segmentation, "cube", vtkSegmentationModifier::MODE_MERGE_MIN))
+  {
+    std::cerr << __LINE__ << ": Failed to modify binary labelmap" << std::endl;
+    return false;
+  }
+  if (!segmentation->CreateRepresentation(vtkSegmentationConverter::GetClosedSurfaceRepresentationName(), true))
+  {
+    std::cerr << __LINE__ << ": Failed to update closed surface representation" << std::endl;
+    return false;
+  }
+  if (!CompareIncrementalClosedSurface(segment, smoothingFactor, decimationFactor))
+  {
+    return false;
+  }
+
+  // Remove a small box within a single brick. Only the smoothed surface of nearby bricks is updated,
+  // the other bricks are reused from the previous update.
+  int smallEraseExtent[6] = { 5, 8, 5, 8, 3, 6 };
+  CreateCubeLabelmap(eraseLabelmap, smallEraseExtent);
+  memset(eraseLabelmap->GetScalarPointer(), 0, eraseLabelmap->GetNumberOfPoints() * eraseLabelmap->GetScalarSize());
+  if (!vtkSegmentationModifier::ModifyBinaryLabelmap(eraseLabelmap, segmentation, "cube", vtkSegmentationModifier::MODE_MERGE_MIN))
+  {
+    std::cerr << __LINE__ << ": Failed to modify binary labelmap" << std::endl;
+    return false;
+  }
+  if (!segmentation->CreateRepresentation(vtkSegmentationConverter::GetClosedSurfaceRepresentationName(), true))
+  {
+    std::cerr << __LINE__ << ": Failed to update closed surface representation" << std::endl;
+    return false;
+  }
+  if (!CompareIncrementalClosedSurface(segment, smoothingFactor, decimationFactor))
+  {
+    return false;
+  }
+  return true;
+}
+
 //----------------------------------------------------------------------------
 int vtkSegmentationTest2(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
 {
@@ -434,6 +587,26 @@ int vtkSegmentationTest2(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
     return EXIT_FAILURE;
   }
 
+  if (!TestIncrementalClosedSurfaceUpdate("0.0", "0.0"))
+  {
+    return EXIT_FAILURE;
+  }
+
+  if (!TestIncrementalClosedSurfaceUpdate("0.5", "0.0"))
+  {
+    return EXIT_FAILURE;
+  }
+
+  if (!TestIncrementalClosedSurfaceUpdate("0.0", "0.5"))
+  {
+    return EXIT_FAILURE;
+  }
+
+  if (!TestIncrementalClosedSurfaceUpdate("0.5", "0.5"))
+  {
+    return EXIT_FAILURE;
+  }
+
   std::cout << "Segmentation test 2 passed." << std::endl;
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,261 @@
+/*==============================================================================
+
+  Copyright (c) Laboratory for Percutaneous Surgery (PerkLab)
+  Queen's University, Kingston, ON, Canada. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// VTK includes
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkPolyData.h>
+
+// SegmentationCore includes
+#include "vtkBinaryLabelmapToClosedSurfaceConversionRule.h"
+#include "vtkOrientedImageData.h"
+#include "vtkOrientedImageDataResample.h"
+#include "vtkSegment.h"
+#include "vtkSegmentation.h"
+#include "vtkSegmentationConverterFactory.h"
+#include "vtkSparseOrientedImageData.h"
+
+// STD includes
+#include <cstring>
+#include <string>
+
+// Get CHECK_INT from vtkAddonTestingMacros.h to avoid dependency on vtkAddon
+namespace
+{
+
+//----------------------------------------------------------------------------
+bool CheckInt(int line, const std::string& description, int current, int expected)
+{
+  if (current == expected)
+  {
+    return EXIT_SUCCESS;
+  }
+  std::cerr << "\nLine " << line << " - " << description.c_str() << " : test failed"
+            << "\n\tcurrent :" << current << "\n\texpected:" << expected << std::endl;
+  return EXIT_FAILURE;
+}
+
+// Use a macro to be able to print the evaluated expression and the line number
+#define CHECK_INT(actual, expected)                                                         \
+  {                                                                                         \
+    if (CheckInt(__LINE__, #actual " != " #expected, (actual), (expected)) != EXIT_SUCCESS) \
+    {                                                                                       \
+      return EXIT_FAILURE;                                                                  \
+    }                                                                                       \
+  }
+
+//----------------------------------------------------------------------------
+void CreateLabelmap(vtkOrientedImageData* image, const int extent[6], vtkMatrix4x4* imageToWorldMatrix)
+{
+  image->SetImageToWorldMatrix(imageToWorldMatrix);
+  image->SetExtent(const_cast<int*>(extent));
+  image->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+  memset(image->GetScalarPointer(), 0, image->GetNumberOfPoints() * image->GetScalarSize());
+}
+
+//----------------------------------------------------------------------------
+int CountVoxels(vtkOrientedImageData* image, int value)
+{
+  int count = 0;
+  int* extent = image->GetExtent();
+  for (int k = extent[4]; k <= extent[5]; ++k)
+  {
+    for (int j = extent[2]; j <= extent[3]; ++j)
+    {
+      for (int i = extent[0]; i <= extent[1]; ++i)
+      {
+        if (image->GetScalarComponentAsDouble(i, j, k, 0) == value)
+        {
+          ++count;
+        }
+      }
+    }
+  }
+  return count;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkSparseOrientedImageDataTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  vtkNew<vtkMatrix4x4> imageToWorldMatrix;
+  imageToWorldMatrix->SetElement(0, 0, 0.5);
+  imageToWorldMatrix->SetElement(1, 1, 0.5);
+  imageToWorldMatrix->SetElement(2, 2, 2.0);
+  imageToWorldMatrix->SetElement(0, 3, 10.0);
+
+  // Large, mostly empty labelmap with two small labels in opposite corners
+  vtkNew<vtkOrientedImageData> denseLabelmap;
+  int denseExtent[6] = { -20, 235, 0, 255, 0, 63 };
+  CreateLabelmap(denseLabelmap, denseExtent, imageToWorldMatrix);
+  for (int k = 2; k < 6; ++k)
+  {
+    for (int j = 2; j < 6; ++j)
+    {
+      for (int i = -18; i < -14; ++i)
+      {
+        denseLabelmap->SetScalarComponentFromDouble(i, j, k, 0, 1);
+      }
+    }
+  }
+  for (int k = 60; k < 62; ++k)
+  {
+    for (int j = 250; j < 252; ++j)
+    {
+      for (int i = 230; i < 232; ++i)
+      {
+        denseLabelmap->SetScalarComponentFromDouble(i, j, k, 0, 2);
+      }
+    }
+  }
+
+  vtkNew<vtkSparseOrientedImageData> sparseLabelmap;
+  CHECK_INT(sparseLabelmap->SetImage(denseLabelmap), true);
+  CHECK_INT(sparseLabelmap->GetScalarType(), VTK_UNSIGNED_CHAR);
+  CHECK_INT(sparseLabelmap->GetNumberOfBricks(), 2);
+  CHECK_INT(sparseLabelmap->GetActualMemorySize() < denseLabelmap->GetActualMemorySize() / 10, true);
+  CHECK_INT(sparseLabelmap->GetBrick(100, 100, 30) == nullptr, true);
+  CHECK_INT(sparseLabelmap->GetBrick(-16, 3, 3) != nullptr, true);
+
+  // Effective extent
+  int effectiveExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  CHECK_INT(sparseLabelmap->CalculateEffectiveExtent(effectiveExtent), true);
+  int expectedEffectiveExtent[6] = { -18, 231, 2, 251, 2, 61 };
+  for (int i = 0; i < 6; ++i)
+  {
+    CHECK_INT(effectiveExtent[i], expectedEffectiveExtent[i]);
+  }
+
+  // Round trip to dense image
+  vtkNew<vtkOrientedImageData> restoredLabelmap;
+  CHECK_INT(sparseLabelmap->GetImage(restoredLabelmap, denseExtent), true);
+  CHECK_INT(vtkOrientedImageDataResample::DoGeometriesMatch(restoredLabelmap, denseLabelmap), true);
+  CHECK_INT(memcmp(restoredLabelmap->GetScalarPointer(), denseLabelmap->GetScalarPointer(), denseLabelmap->GetNumberOfPoints()), 0);
+
+  // Threshold a single label
+  vtkNew<vtkOrientedImageData> label2Labelmap;
+  CHECK_INT(sparseLabelmap->ExtractLabel(2, label2Labelmap), true);
+  CHECK_INT(CountVoxels(label2Labelmap, 1), 8);
+  CHECK_INT(label2Labelmap->GetNumberOfPoints(), 32 * 32 * 32);
+
+  // Add a region that spans multiple bricks
+  vtkNew<vtkOrientedImageData> modifierLabelmap;
+  int modifierExtent[6] = { 20, 79, 20, 29, 20, 29 };
+  CreateLabelmap(modifierLabelmap, modifierExtent, imageToWorldMatrix);
+  vtkOrientedImageDataResample::FillImage(modifierLabelmap, 3);
+  CHECK_INT(sparseLabelmap->ModifyImage(modifierLabelmap, vtkOrientedImageDataResample::OPERATION_MAXIMUM), true);
+  CHECK_INT(sparseLabelmap->GetNumberOfBricks(), 5);
+  vtkNew<vtkOrientedImageData> label3Labelmap;
+  CHECK_INT(sparseLabelmap->ExtractLabel(3, label3Labelmap), true);
+  CHECK_INT(CountVoxels(label3Labelmap, 1), 60 * 10 * 10);
+
+  // Empty modifier does not allocate bricks
+  vtkNew<vtkOrientedImageData> emptyModifierLabelmap;
+  int emptyModifierExtent[6] = { 100, 199, 100, 199, 0, 9 };
+  CreateLabelmap(emptyModifierLabelmap, emptyModifierExtent, imageToWorldMatrix);
+  CHECK_INT(sparseLabelmap->ModifyImage(emptyModifierLabelmap, vtkOrientedImageDataResample::OPERATION_MAXIMUM), true);
+  CHECK_INT(sparseLabelmap->GetNumberOfBricks(), 5);
+
+  // Erasing a region releases the bricks that become empty
+  vtkOrientedImageDataResample::FillImage(modifierLabelmap, 0);
+  CHECK_INT(sparseLabelmap->ModifyImage(modifierLabelmap, vtkOrientedImageDataResample::OPERATION_MINIMUM), true);
+  CHECK_INT(sparseLabelmap->GetNumberOfBricks(), 2);
+
+  // Copy
+  vtkNew<vtkSparseOrientedImageData> sparseLabelmapCopy;
+  sparseLabelmapCopy->DeepCopy(sparseLabelmap);
+  CHECK_INT(sparseLabelmapCopy->GetNumberOfBricks(), 2);
+  CHECK_INT(sparseLabelmapCopy->GetBrick(-16, 3, 3) != sparseLabelmap->GetBrick(-16, 3, 3), true);
+
+  // Shallow copy shares bricks until one of the copies is modified
+  vtkNew<vtkSparseOrientedImageData> sparseLabelmapShallowCopy;
+  sparseLabelmapShallowCopy->ShallowCopy(sparseLabelmap);
+  CHECK_INT(sparseLabelmapShallowCopy->GetBrick(-16, 3, 3) == sparseLabelmap->GetBrick(-16, 3, 3), true);
+  vtkNew<vtkOrientedImageData> eraseLabelmap;
+  int eraseExtent[6] = { -18, -15, 2, 5, 2, 5 };
+  CreateLabelmap(eraseLabelmap, eraseExtent, imageToWorldMatrix);
+  CHECK_INT(sparseLabelmapShallowCopy->ModifyImage(eraseLabelmap, vtkOrientedImageDataResample::OPERATION_MINIMUM), true);
+  CHECK_INT(sparseLabelmapShallowCopy->GetNumberOfBricks(), 1);
+  CHECK_INT(sparseLabelmap->GetNumberOfBricks(), 2);
+  CHECK_INT(static_cast<int>(sparseLabelmap->GetBrick(-16, 3, 3)->GetScalarComponentAsDouble(-16, 3, 3, 0)), 1);
+
+  // Merge segments of a segmentation into sparse storage and set them back
+  vtkSegmentationConverterFactory::GetInstance()->RegisterConverterRule(vtkSmartPointer<vtkBinaryLabelmapToClosedSurfaceConversionRule>::New());
+  vtkNew<vtkSegmentation> segmentation;
+  segmentation->SetSourceRepresentationName(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName());
+  const int numberOfSegments = 3;
+  for (int segmentIndex = 0; segmentIndex < numberOfSegments; ++segmentIndex)
+  {
+    // Small segments far from each other in a large geometry
+    vtkNew<vtkOrientedImageData> segmentLabelmap;
+    int segmentExtent[6] = { 0, 255, 0, 255, 0, 63 };
+    CreateLabelmap(segmentLabelmap, segmentExtent, imageToWorldMatrix);
+    int offset = segmentIndex * 80;
+    for (int k = 10; k < 14; ++k)
+    {
+      for (int j = offset + 10; j < offset + 14; ++j)
+      {
+        for (int i = offset + 10; i < offset + 14; ++i)
+        {
+          segmentLabelmap->SetScalarComponentFromDouble(i, j, k, 0, 1);
+        }
+      }
+    }
+    vtkNew<vtkSegment> segment;
+    segment->AddRepresentation(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName(), segmentLabelmap);
+    segmentation->AddSegment(segment, "segment" + std::to_string(segmentIndex));
+  }
+
+  vtkNew<vtkSparseOrientedImageData> mergedLabelmap;
+  CHECK_INT(segmentation->GenerateMergedLabelmap(mergedLabelmap), true);
+  CHECK_INT(mergedLabelmap->GetScalarType(), VTK_SHORT);
+  CHECK_INT(mergedLabelmap->GetNumberOfBricks(), numberOfSegments);
+  for (int segmentIndex = 0; segmentIndex < numberOfSegments; ++segmentIndex)
+  {
+    vtkNew<vtkOrientedImageData> labelLabelmap;
+    CHECK_INT(mergedLabelmap->ExtractLabel(segmentIndex + 1, labelLabelmap), true);
+    CHECK_INT(CountVoxels(labelLabelmap, 1), 4 * 4 * 4);
+  }
+
+  // Erase the first segment in the merged labelmap, then set segment labelmaps from it
+  vtkNew<vtkOrientedImageData> eraseSegmentLabelmap;
+  int eraseSegmentExtent[6] = { 0, 31, 0, 31, 0, 31 };
+  CreateLabelmap(eraseSegmentLabelmap, eraseSegmentExtent, imageToWorldMatrix);
+  CHECK_INT(mergedLabelmap->ModifyImage(eraseSegmentLabelmap, vtkOrientedImageDataResample::OPERATION_MINIMUM), true);
+  CHECK_INT(mergedLabelmap->GetNumberOfBricks(), numberOfSegments - 1);
+  CHECK_INT(segmentation->SetSegmentLabelmapsFromMergedLabelmap(mergedLabelmap), true);
+  vtkOrientedImageData* firstSegmentLabelmap =
+    vtkOrientedImageData::SafeDownCast(segmentation->GetSegment("segment0")->GetRepresentation(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName()));
+  CHECK_INT(firstSegmentLabelmap->IsEmpty(), true);
+  for (int segmentIndex = 1; segmentIndex < numberOfSegments; ++segmentIndex)
+  {
+    vtkSegment* segment = segmentation->GetSegment("segment" + std::to_string(segmentIndex));
+    vtkOrientedImageData* segmentLabelmap = vtkOrientedImageData::SafeDownCast(segment->GetRepresentation(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName()));
+    CHECK_INT(segment->GetLabelValue(), 1);
+    CHECK_INT(CountVoxels(segmentLabelmap, 1), 4 * 4 * 4);
+    // Segment labelmap only covers the brick that contains the segment
+    CHECK_INT(segmentLabelmap->GetNumberOfPoints(), 32 * 32 * 32);
+  }
+
+  // Surfaces are generated from the segment labelmaps
+  CHECK_INT(segmentation->CreateRepresentation(vtkSegmentationConverter::GetClosedSurfaceRepresentationName()), true);
+  vtkPolyData* surface = vtkPolyData::SafeDownCast(segmentation->GetSegment("segment2")->GetRepresentation(vtkSegmentationConverter::GetClosedSurfaceRepresentationName()));
+  CHECK_INT(surface != nullptr && surface->GetNumberOfPolys() > 0, true);
+
+  std::cout << "Sparse oriented image data test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -26,6 +26,10 @@
 #include "vtkOrientedImageDataResample.h"
 
 // VTK includes
+#include <vtkAppendPolyData.h>
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkCleanPolyData.h>
 #include <vtkCompositeDataIterator.h>
 #include <vtkDecimatePro.h>
 #include <vtkDiscreteFlyingEdges3D.h>
@@ -33,6 +37,7 @@
 #include <vtkImageAccumulate.h>
 #include <vtkImageChangeInformation.h>
 #include <vtkImageConstantPad.h>
+#include <vtkImageData.h>
 #include <vtkImageThreshold.h>
 #include <vtkMultiBlockDataSet.h>
 #include <vtkMultiThreshold.h>
@@ -58,8 +63,17 @@
 #include <vtkSelectionNode.h>
 #include <vtkFloatArray.h>
 #include <vtkInformation.h>
+#include <vtkIntArray.h>
+#include <vtkMatrix4x4.h>
 #include <vtkExtractSelection.h>
 #include <vtkSelectionSource.h>
+#include <vtkSMPTools.h>
+
+// STD includes
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <sstream>
 
 //----------------------------------------------------------------------------
 const std::string vtkBinaryLabelmapToClosedSurfaceConversionRule::CONVERSION_METHOD_FLYING_EDGES = std::string("0");
@@ -68,6 +82,482 @@ const std::string vtkBinaryLabelmapToClosedSurfaceConversionRule::CONVERSION_MET
 //----------------------------------------------------------------------------
 vtkSegmentationConverterRuleNewMacro(vtkBinaryLabelmapToClosedSurfaceConversionRule);
 
+namespace
+{
+
+/// Size of the bricks (in voxels along each axis) that the surface is split to for incremental update
+const int BRICK_SIZE = 64;
+
+/// Number of voxels around the regenerated bricks where the smoothed surface is updated as well.
+/// Smoothing moves points depending on their neighbors within a few ten edges, therefore
+/// modifying a brick changes the smoothed surface near the boundaries of its neighbor bricks.
+const int SEAM_MARGIN = BRICK_SIZE / 2;
+
+/// Name of the cell data array that stores which brick each cell of a merged surface comes from
+const char* const BRICK_INDEX_ARRAY_NAME = "BrickIndex";
+
+/// Maximum number of modifications that are remembered for each labelmap
+const size_t MAXIMUM_NUMBER_OF_RECORDED_MODIFICATIONS = 256;
+
+//----------------------------------------------------------------------------
+struct SurfaceGenerationParameters
+{
+  double DecimationFactor{ 0.0 };
+  double SmoothingFactor{ 0.0 };
+  std::string ConversionMethod;
+  int SurfaceNetsSmoothing{ 0 };
+};
+
+//----------------------------------------------------------------------------
+bool ExtractSurface(vtkImageData* binaryLabelmapWithIdentityGeometry,
+                    const std::vector<int>& labelValues,
+                    const SurfaceGenerationParameters& parameters,
+                    vtkSmartPointer<vtkPolyData>& surface)
+{
+  if (parameters.ConversionMethod == vtkBinaryLabelmapToClosedSurfaceConversionRule::CONVERSION_METHOD_FLYING_EDGES)
+  {
+    vtkNew<vtkDiscreteFlyingEdges3D> flyingEdges;
+    flyingEdges->SetInputData(binaryLabelmapWithIdentityGeometry);
+    flyingEdges->ComputeGradientsOff();
+    flyingEdges->ComputeNormalsOff(); // While computing normals is faster using the flying edges filter,
+    // it results in incorrect normals in meshes from shared labelmaps marchingCubes->ComputeScalarsOn();
+
+    int valueIndex = 0;
+    for (vtkIdType labelValue : labelValues)
+    {
+      flyingEdges->SetValue(valueIndex, labelValue);
+      ++valueIndex;
+    }
+    try
+    {
+      flyingEdges->Update();
+    }
+    catch (...)
+    {
+      return false;
+    }
+    surface = flyingEdges->GetOutput();
+  }
+  else if (parameters.ConversionMethod == vtkBinaryLabelmapToClosedSurfaceConversionRule::CONVERSION_METHOD_SURFACE_NETS)
+  {
+    vtkNew<vtkSurfaceNets3D> surfaceNets;
+    surfaceNets->SetInputData(binaryLabelmapWithIdentityGeometry);
+
+    // Disable internal smoothing, and use vtkWindowedSincPolyDataFilter for smoothing as needed
+    surfaceNets->SmoothingOff();
+
+    if (parameters.SurfaceNetsSmoothing == 1)
+    {
+      surfaceNets->SmoothingOn();
+
+      // This formula maps (input) -> (iteration count)
+      // 0.0  ->  0   (almost no smoothing)
+      // 0.2  ->  2   (little smoothing)
+      // 0.5  ->  8   (average smoothing)
+      // 0.7  ->  14  (strong smoothing)
+      // 1.0  ->  24  (very strong smoothing)
+      double fCount = 15.0 * parameters.SmoothingFactor * parameters.SmoothingFactor + 9.0 * parameters.SmoothingFactor;
+      int iterationCount = floor(fCount);
+      surfaceNets->SetNumberOfIterations(iterationCount);
+    }
+
+    int valueIndex = 0;
+    for (vtkIdType labelValue : labelValues)
+    {
+      surfaceNets->SetValue(valueIndex, labelValue);
+      ++valueIndex;
+    }
+
+    try
+    {
+      surfaceNets->Update();
+    }
+    catch (...)
+    {
+      return false;
+    }
+    surface = surfaceNets->GetOutput();
+  }
+  else
+  {
+    surface = vtkSmartPointer<vtkPolyData>::New();
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void DecimateSurface(vtkSmartPointer<vtkPolyData>& surface, double decimationFactor, bool preserveBoundary)
+{
+  if (decimationFactor <= 0.0)
+  {
+    return;
+  }
+  vtkSmartPointer<vtkDecimatePro> decimator = vtkSmartPointer<vtkDecimatePro>::New();
+  decimator->SetInputData(surface);
+  decimator->SetFeatureAngle(60);
+  decimator->SplittingOff();
+  decimator->PreserveTopologyOn();
+  decimator->SetMaximumError(1);
+  decimator->SetTargetReduction(decimationFactor);
+  if (preserveBoundary)
+  {
+    decimator->BoundaryVertexDeletionOff();
+  }
+  decimator->Update();
+  surface = decimator->GetOutput();
+}
+
+//----------------------------------------------------------------------------
+void SmoothSurface(vtkSmartPointer<vtkPolyData>& surface, const SurfaceGenerationParameters& parameters)
+{
+  if (parameters.SmoothingFactor <= 0 || parameters.SurfaceNetsSmoothing != 0)
+  {
+    return;
+  }
+  vtkSmartPointer<vtkWindowedSincPolyDataFilter> smoother = vtkSmartPointer<vtkWindowedSincPolyDataFilter>::New();
+  smoother->SetInputData(surface);
+
+  // Smoothing factor is a user-friendly linear scale that we need to maps to low-pass filter parameters.
+  // Default smoothing aims for removing blocky appearance (staircase artifacts) while avoiding shrinking.
+  // Typically a few ten iterations are sufficient, but stronger smoothing requires more iterations.
+  //
+  //   Smoothing factor                             Passband   Iterations
+  //
+  //     0.0  (almost no smoothing, blocky)      ->   1.0          20
+  //     0.25 (less smoothing, somewhat blocky)  ->   0.1          30
+  //     0.5  (default smoothing)                ->   0.01         40
+  //     0.75 (more smoothing, somewhat shrinks) ->   0.001        50
+  //     1.0  (very strong smoothing, shrinks)   ->   0.0001       60
+  //
+  double passBand = pow(10.0, -4.0 * parameters.SmoothingFactor);
+  int numberOfIterations = 20 + parameters.SmoothingFactor * 40;
+
+  smoother->SetNumberOfIterations(numberOfIterations);
+  smoother->SetPassBand(passBand);
+  smoother->BoundarySmoothingOff();
+  smoother->FeatureEdgeSmoothingOff();
+  smoother->NonManifoldSmoothingOn();
+  smoother->NormalizeCoordinatesOn();
+  smoother->Update();
+  surface = smoother->GetOutput();
+}
+
+//----------------------------------------------------------------------------
+void TransformSurfaceToWorld(vtkOrientedImageData* orientedBinaryLabelmap, vtkPolyData* surface, bool computeSurfaceNormals, vtkPolyData* closedSurfacePolyData)
+{
+  // Transform the result surface from labelmap IJK to world coordinate system
+  vtkSmartPointer<vtkTransform> labelmapGeometryTransform = vtkSmartPointer<vtkTransform>::New();
+  vtkSmartPointer<vtkMatrix4x4> labelmapImageToWorldMatrix = vtkSmartPointer<vtkMatrix4x4>::New();
+  orientedBinaryLabelmap->GetImageToWorldMatrix(labelmapImageToWorldMatrix);
+  labelmapGeometryTransform->SetMatrix(labelmapImageToWorldMatrix);
+
+  vtkSmartPointer<vtkTransformPolyDataFilter> transformPolyDataFilter = vtkSmartPointer<vtkTransformPolyDataFilter>::New();
+  transformPolyDataFilter->SetInputData(surface);
+  transformPolyDataFilter->SetTransform(labelmapGeometryTransform);
+
+  vtkSmartPointer<vtkPolyData> convertedSegment = vtkSmartPointer<vtkPolyData>::New();
+  if (computeSurfaceNormals)
+  {
+    vtkSmartPointer<vtkPolyDataNormals> polyDataNormals = vtkSmartPointer<vtkPolyDataNormals>::New();
+    polyDataNormals->SetInputConnection(transformPolyDataFilter->GetOutputPort());
+    polyDataNormals->ConsistencyOn(); // discrete marching cubes may generate inconsistent surface
+
+    // We almost always perform smoothing, so splitting would not be able to preserve any sharp features
+    // (and sharp edges would look like artifacts in the smooth surface).
+    polyDataNormals->SplittingOff();
+    polyDataNormals->Update();
+    convertedSegment->ShallowCopy(polyDataNormals->GetOutput());
+  }
+  else
+  {
+    transformPolyDataFilter->Update();
+    convertedSegment->ShallowCopy(transformPolyDataFilter->GetOutput());
+  }
+
+  closedSurfacePolyData->ShallowCopy(convertedSegment);
+}
+
+//----------------------------------------------------------------------------
+int FloorDivide(int value, int divisor)
+{
+  return (value >= 0) ? (value / divisor) : -((-value + divisor - 1) / divisor);
+}
+
+//----------------------------------------------------------------------------
+bool IsExtentValid(const int extent[6])
+{
+  return extent[0] <= extent[1] && extent[2] <= extent[3] && extent[4] <= extent[5];
+}
+
+//----------------------------------------------------------------------------
+void AddExtentToExtent(const int extentToAdd[6], int extent[6])
+{
+  if (!IsExtentValid(extentToAdd))
+  {
+    return;
+  }
+  if (!IsExtentValid(extent))
+  {
+    std::copy(extentToAdd, extentToAdd + 6, extent);
+    return;
+  }
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    extent[axis * 2] = std::min(extent[axis * 2], extentToAdd[axis * 2]);
+    extent[axis * 2 + 1] = std::max(extent[axis * 2 + 1], extentToAdd[axis * 2 + 1]);
+  }
+}
+
+//----------------------------------------------------------------------------
+template <class ImageScalarType>
+void IsLabelInRegionGeneric(const void* scalars, const int imageExtent[6], const int regionExtent[6], int labelValue, bool& labelFound)
+{
+  labelFound = false;
+  const ImageScalarType* imagePtr = static_cast<const ImageScalarType*>(scalars);
+  const ImageScalarType label = static_cast<ImageScalarType>(labelValue);
+  const vtkIdType rowSize = imageExtent[1] - imageExtent[0] + 1;
+  const vtkIdType sliceSize = rowSize * (imageExtent[3] - imageExtent[2] + 1);
+  for (int k = regionExtent[4]; k <= regionExtent[5]; ++k)
+  {
+    for (int j = regionExtent[2]; j <= regionExtent[3]; ++j)
+    {
+      const ImageScalarType* rowPtr = imagePtr + (k - imageExtent[4]) * sliceSize + (j - imageExtent[2]) * rowSize + (regionExtent[0] - imageExtent[0]);
+      const ImageScalarType* rowEndPtr = rowPtr + (regionExtent[1] - regionExtent[0] + 1);
+      if (std::find(rowPtr, rowEndPtr, label) != rowEndPtr)
+      {
+        labelFound = true;
+        return;
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+bool IsBrickInExtent(const std::array<int, 3>& brickIndex, const int brickExtent[6])
+{
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    if (brickIndex[axis] < brickExtent[axis * 2] || brickIndex[axis] > brickExtent[axis * 2 + 1])
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+/// Copy the specified cells of a merged surface into a separate surface.
+/// Points that are used by cells of other bricks are returned as seam points, along with
+/// their unsmoothed position, which is the same in all the bricks that share the point.
+void ExtractBrickCells(vtkPolyData* mergedSurface,
+                       vtkPoints* unsmoothedPoints,
+                       const std::vector<vtkIdType>& polyIds,
+                       const std::vector<bool>& sharedPoints,
+                       std::vector<vtkIdType>& pointIdMap,
+                       vtkSmartPointer<vtkPolyData>& brickSurface,
+                       std::vector<vtkIdType>& seamPointIds,
+                       std::vector<std::array<double, 3>>& seamPointPositions)
+{
+  vtkPoints* mergedPoints = mergedSurface->GetPoints();
+  vtkDataArray* mergedNormals = mergedSurface->GetPointData()->GetNormals();
+
+  vtkNew<vtkPoints> points;
+  points->SetDataType(mergedPoints->GetDataType());
+  vtkSmartPointer<vtkDataArray> normals;
+  if (mergedNormals)
+  {
+    normals = vtkSmartPointer<vtkDataArray>::Take(mergedNormals->NewInstance());
+    normals->SetName(mergedNormals->GetName());
+    normals->SetNumberOfComponents(3);
+  }
+  vtkNew<vtkCellArray> polys;
+  seamPointIds.clear();
+  seamPointPositions.clear();
+
+  std::vector<vtkIdType> usedPointIds;
+  std::vector<vtkIdType> cellPointIds;
+  for (vtkIdType polyId : polyIds)
+  {
+    vtkIdType numberOfCellPoints = 0;
+    const vtkIdType* mergedCellPointIds = nullptr;
+    mergedSurface->GetPolys()->GetCellAtId(polyId, numberOfCellPoints, mergedCellPointIds);
+    cellPointIds.resize(numberOfCellPoints);
+    for (vtkIdType pointIndex = 0; pointIndex < numberOfCellPoints; ++pointIndex)
+    {
+      vtkIdType mergedPointId = mergedCellPointIds[pointIndex];
+      if (pointIdMap[mergedPointId] < 0)
+      {
+        pointIdMap[mergedPointId] = points->InsertNextPoint(mergedPoints->GetPoint(mergedPointId));
+        if (normals)
+        {
+          normals->InsertNextTuple(mergedNormals->GetTuple(mergedPointId));
+        }
+        if (sharedPoints[mergedPointId])
+        {
+          std::array<double, 3> position;
+          unsmoothedPoints->GetPoint(mergedPointId, position.data());
+          seamPointIds.push_back(pointIdMap[mergedPointId]);
+          seamPointPositions.push_back(position);
+        }
+        usedPointIds.push_back(mergedPointId);
+      }
+      cellPointIds[pointIndex] = pointIdMap[mergedPointId];
+    }
+    polys->InsertNextCell(numberOfCellPoints, cellPointIds.data());
+  }
+
+  // Reset the map for the next brick
+  for (vtkIdType mergedPointId : usedPointIds)
+  {
+    pointIdMap[mergedPointId] = -1;
+  }
+
+  brickSurface = vtkSmartPointer<vtkPolyData>::New();
+  brickSurface->SetPoints(points);
+  brickSurface->SetPolys(polys);
+  if (normals)
+  {
+    brickSurface->GetPointData()->SetNormals(normals);
+  }
+}
+
+//----------------------------------------------------------------------------
+/// Generates the surface of a single brick.
+/// The labelmap voxels of the brick and a margin around it are copied into a separate image,
+/// so that bricks can be processed in parallel without sharing any VTK pipeline objects.
+/// Only those cells are kept in the output that lie inside the brick.
+/// The brick surface is decimated but not smoothed: smoothing is performed after merging
+/// the brick with its neighbors, the same way as in the full conversion.
+struct BrickSurfaceGenerator
+{
+  const char* Scalars{ nullptr };
+  int Extent[6]{ 0, -1, 0, -1, 0, -1 };
+  int ScalarType{ VTK_UNSIGNED_CHAR };
+  int ScalarSize{ 1 };
+  int LabelValue{ 1 };
+  /// Number of voxels around the brick that are included in surface generation
+  /// to make the surface consistent with neighbor bricks
+  int Margin{ 2 };
+  SurfaceGenerationParameters Parameters;
+
+  bool CreateBrickSurface(const std::array<int, 3>& brickIndex, vtkSmartPointer<vtkPolyData>& brickSurface) const
+  {
+    brickSurface = nullptr;
+
+    // Copy the brick voxels and the margin around it, with an additional zero padding
+    int copyExtent[6] = { 0, -1, 0, -1, 0, -1 };
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      copyExtent[axis * 2] = std::max(brickIndex[axis] * BRICK_SIZE - this->Margin, this->Extent[axis * 2]);
+      copyExtent[axis * 2 + 1] = std::min((brickIndex[axis] + 1) * BRICK_SIZE - 1 + this->Margin, this->Extent[axis * 2 + 1]);
+    }
+    if (!IsExtentValid(copyExtent))
+    {
+      return true;
+    }
+
+    // Skip bricks that do not contain the label
+    bool labelFound = true;
+    switch (this->ScalarType)
+    {
+      vtkTemplateMacro(IsLabelInRegionGeneric<VTK_TT>(this->Scalars, this->Extent, copyExtent, this->LabelValue, labelFound));
+    }
+    if (!labelFound)
+    {
+      return true;
+    }
+
+    vtkNew<vtkImageData> brickImage;
+    brickImage->SetExtent(copyExtent[0] - 1, copyExtent[1] + 1, copyExtent[2] - 1, copyExtent[3] + 1, copyExtent[4] - 1, copyExtent[5] + 1);
+    brickImage->AllocateScalars(this->ScalarType, 1);
+    memset(brickImage->GetScalarPointer(), 0, brickImage->GetNumberOfPoints() * this->ScalarSize);
+    const vtkIdType sourceRowSize = this->Extent[1] - this->Extent[0] + 1;
+    const vtkIdType sourceSliceSize = sourceRowSize * (this->Extent[3] - this->Extent[2] + 1);
+    const size_t copyRowBytes = static_cast<size_t>(copyExtent[1] - copyExtent[0] + 1) * this->ScalarSize;
+    for (int k = copyExtent[4]; k <= copyExtent[5]; ++k)
+    {
+      for (int j = copyExtent[2]; j <= copyExtent[3]; ++j)
+      {
+        vtkIdType sourceOffset = (k - this->Extent[4]) * sourceSliceSize + (j - this->Extent[2]) * sourceRowSize + (copyExtent[0] - this->Extent[0]);
+        memcpy(brickImage->GetScalarPointer(copyExtent[0], j, k), this->Scalars + sourceOffset * this->ScalarSize, copyRowBytes);
+      }
+    }
+
+    vtkSmartPointer<vtkPolyData> surface;
+    std::vector<int> labelValues = { this->LabelValue };
+    if (!ExtractSurface(brickImage, labelValues, this->Parameters, surface))
+    {
+      return false;
+    }
+    if (!surface || surface->GetNumberOfPolys() == 0)
+    {
+      return true;
+    }
+
+    // Determine which cells belong to this brick, based on the position of the cell centroid.
+    // Neighbor bricks generate the same cells from the same voxels, so each cell is kept in exactly one brick.
+    std::vector<bool> cellInBrick(surface->GetNumberOfPolys(), false);
+    vtkPoints* points = surface->GetPoints();
+    vtkCellArray* polys = surface->GetPolys();
+    vtkIdType numberOfCellPoints = 0;
+    const vtkIdType* cellPointIds = nullptr;
+    vtkIdType cellIndex = 0;
+    polys->InitTraversal();
+    while (polys->GetNextCell(numberOfCellPoints, cellPointIds))
+    {
+      double centroid[3] = { 0.0, 0.0, 0.0 };
+      for (vtkIdType pointIndex = 0; pointIndex < numberOfCellPoints; ++pointIndex)
+      {
+        double* point = points->GetPoint(cellPointIds[pointIndex]);
+        centroid[0] += point[0];
+        centroid[1] += point[1];
+        centroid[2] += point[2];
+      }
+      bool inBrick = (numberOfCellPoints > 0);
+      for (int axis = 0; axis < 3 && inBrick; ++axis)
+      {
+        int voxelIndex = static_cast<int>(floor(centroid[axis] / numberOfCellPoints));
+        inBrick = (FloorDivide(voxelIndex, BRICK_SIZE) == brickIndex[axis]);
+      }
+      cellInBrick[cellIndex++] = inBrick;
+    }
+
+    vtkNew<vtkCellArray> brickPolys;
+    polys = surface->GetPolys();
+    cellIndex = 0;
+    polys->InitTraversal();
+    while (polys->GetNextCell(numberOfCellPoints, cellPointIds))
+    {
+      if (cellInBrick[cellIndex++])
+      {
+        brickPolys->InsertNextCell(numberOfCellPoints, cellPointIds);
+      }
+    }
+    if (brickPolys->GetNumberOfCells() == 0)
+    {
+      return true;
+    }
+    vtkNew<vtkPolyData> clippedSurface;
+    clippedSurface->SetPoints(surface->GetPoints());
+    clippedSurface->GetPointData()->ShallowCopy(surface->GetPointData());
+    clippedSurface->SetPolys(brickPolys);
+
+    // Remove points that are only used by cells of neighbor bricks
+    vtkNew<vtkCleanPolyData> cleaner;
+    cleaner->SetInputData(clippedSurface);
+    cleaner->PointMergingOff();
+    cleaner->Update();
+    brickSurface = cleaner->GetOutput();
+
+    // Decimate the brick without moving its boundary, so that boundary points remain identical
+    // to the boundary points of the neighbor bricks and can be merged with them
+    DecimateSurface(brickSurface, this->Parameters.DecimationFactor, true);
+    return true;
+  }
+};
+
+} // end of anonymous namespace
+
 //----------------------------------------------------------------------------
 vtkBinaryLabelmapToClosedSurfaceConversionRule::vtkBinaryLabelmapToClosedSurfaceConversionRule()
 {
@@ -99,6 +589,12 @@ vtkBinaryLabelmapToClosedSurfaceConversionRule::vtkBinaryLabelmapToClosedSurface
     GetJointSmoothingParameterName(),
     "0",
     "Perform joint smoothing.");
+  this->ConversionParameters->SetParameter( //
+    GetIncrementalUpdateParameterName(),
+    "0",
+    "Incremental update. 0 (default) = the entire surface is regenerated when the labelmap is modified. "
+    "1 = only the modified region of the surface is extracted and decimated again, "
+    "the surface is then merged and smoothed (faster editing of large segments).");
 }
 
 //----------------------------------------------------------------------------
@@ -234,12 +730,30 @@ bool vtkBinaryLabelmapToClosedSurfaceConversionRule::Convert(vtkSegment* segment
     vtkPolyData* thresholdedSurface = geometry->GetOutput();
     closedSurfacePolyData->ShallowCopy(thresholdedSurface);
   }
+  // Internal smoothing of surface nets filter is performed during surface extraction,
+  // therefore it cannot be applied to the merged bricks and incremental update is not used.
+  else if (this->ConversionParameters->GetValueAsInt(GetIncrementalUpdateParameterName()) > 0
+           && (this->ConversionParameters->GetValueAsInt(GetSurfaceNetInternalSmoothingParameterName()) == 0
+               || this->ConversionParameters->GetValue(GetConversionMethodParameterName()) != CONVERSION_METHOD_SURFACE_NETS))
+  {
+    if (!this->UpdateClosedSurfaceIncrementally(orientedBinaryLabelmap, segment->GetLabelValue(), closedSurfacePolyData))
+    {
+      return false;
+    }
+  }
   else
   {
     std::vector<int> labelValue = { segment->GetLabelValue() };
     this->CreateClosedSurface(orientedBinaryLabelmap, closedSurfacePolyData, labelValue);
   }
 
+  if (this->ConversionParameters->GetValueAsInt(GetIncrementalUpdateParameterName()) == 0)
+  {
+    // Release memory if incremental update has been switched off
+    this->BrickSurfaceCaches.clear();
+    this->LabelmapModifications.clear();
+  }
+
   // Remove "ImageScalars" array because having a scalar in a model would get that
   // scalar array displayed automatically (instead of model node color) when the mesh is loaded.
   vtkPointData* pointData = closedSurfacePolyData->GetPointData();
@@ -311,179 +825,522 @@ bool vtkBinaryLabelmapToClosedSurfaceConversionRule::CreateClosedSurface(vtkOrie
   binaryLabelmapWithIdentityGeometry->SetSpacing(1.0, 1.0, 1.0);
 
   // Get conversion parameters
-  double decimationFactor = this->ConversionParameters->GetValueAsDouble(GetDecimationFactorParameterName());
-  double smoothingFactor = this->ConversionParameters->GetValueAsDouble(GetSmoothingFactorParameterName());
+  SurfaceGenerationParameters parameters;
+  parameters.DecimationFactor = this->ConversionParameters->GetValueAsDouble(GetDecimationFactorParameterName());
+  parameters.SmoothingFactor = this->ConversionParameters->GetValueAsDouble(GetSmoothingFactorParameterName());
   int computeSurfaceNormals = this->ConversionParameters->GetValueAsInt(GetComputeSurfaceNormalsParameterName());
 
   // Conversion method
-  std::string conversionMethod = this->ConversionParameters->GetValue(GetConversionMethodParameterName());
+  parameters.ConversionMethod = this->ConversionParameters->GetValue(GetConversionMethodParameterName());
 
   // SurfaceNetInternalSmoothing
   // 0 = use vtkWindowedSincPolyDataFilter
   // 1 = use surface nets internal smoothing filter (vtkConstrainedSmoothingFilter)
-  int surfaceNetsSmoothing = this->ConversionParameters->GetValueAsInt(GetSurfaceNetInternalSmoothingParameterName());
+  parameters.SurfaceNetsSmoothing = this->ConversionParameters->GetValueAsInt(GetSurfaceNetInternalSmoothingParameterName());
 
   vtkSmartPointer<vtkPolyData> processingResult = vtkSmartPointer<vtkPolyData>::New();
+  if (parameters.ConversionMethod != vtkBinaryLabelmapToClosedSurfaceConversionRule::CONVERSION_METHOD_FLYING_EDGES
+      && parameters.ConversionMethod != vtkBinaryLabelmapToClosedSurfaceConversionRule::CONVERSION_METHOD_SURFACE_NETS)
+  {
+    vtkErrorMacro("Conversion Rule: Unknown surface generation method");
+  }
+  else if (!ExtractSurface(binaryLabelmapWithIdentityGeometry, labelValues, parameters, processingResult))
+  {
+    if (parameters.ConversionMethod == vtkBinaryLabelmapToClosedSurfaceConversionRule::CONVERSION_METHOD_FLYING_EDGES)
+    {
+      vtkErrorMacro("Convert: Error while running flying edges!");
+    }
+    else
+    {
+      vtkErrorMacro("Convert: Error while running surface nets!");
+    }
+    return false;
+  }
 
-  if (conversionMethod == vtkBinaryLabelmapToClosedSurfaceConversionRule::CONVERSION_METHOD_FLYING_EDGES)
+  if (processingResult->GetNumberOfPolys() == 0)
   {
-    vtkNew<vtkDiscreteFlyingEdges3D> flyingEdges;
-    flyingEdges->SetInputData(binaryLabelmapWithIdentityGeometry);
-    flyingEdges->ComputeGradientsOff();
-    flyingEdges->ComputeNormalsOff(); // While computing normals is faster using the flying edges filter,
-    // it results in incorrect normals in meshes from shared labelmaps marchingCubes->ComputeScalarsOn();
+    vtkDebugMacro("Convert: No polygons can be created, probably all voxels are empty");
+    closedSurfacePolyData->Initialize();
+    return true;
+  }
 
-    int valueIndex = 0;
-    for (vtkIdType labelValue : labelValues)
+  // Decimate
+  DecimateSurface(processingResult, parameters.DecimationFactor, false);
+
+  // Smooth
+  SmoothSurface(processingResult, parameters);
+
+  // Transform the result surface from labelmap IJK to world coordinate system
+  TransformSurfaceToWorld(orientedBinaryLabelmap,
+                          processingResult,
+                          computeSurfaceNormals > 0 && parameters.ConversionMethod == vtkBinaryLabelmapToClosedSurfaceConversionRule::CONVERSION_METHOD_FLYING_EDGES,
+                          closedSurfacePolyData);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+std::string vtkBinaryLabelmapToClosedSurfaceConversionRule::GetSurfaceGenerationParametersKey()
+{
+  std::stringstream parametersKey;
+  parametersKey << this->ConversionParameters->GetValue(GetDecimationFactorParameterName()) << ";"
+                << this->ConversionParameters->GetValue(GetSmoothingFactorParameterName()) << ";"
+                << this->ConversionParameters->GetValue(GetComputeSurfaceNormalsParameterName()) << ";"
+                << this->ConversionParameters->GetValue(GetConversionMethodParameterName()) << ";"
+                << this->ConversionParameters->GetValue(GetSurfaceNetInternalSmoothingParameterName());
+  return parametersKey.str();
+}
+
+//----------------------------------------------------------------------------
+void vtkBinaryLabelmapToClosedSurfaceConversionRule::SourceRepresentationRegionModified(vtkDataObject* sourceRepresentation,
+                                                                                        const int modifiedExtent[6],
+                                                                                        vtkMTimeType previousMTime)
+{
+  vtkOrientedImageData* orientedBinaryLabelmap = vtkOrientedImageData::SafeDownCast(sourceRepresentation);
+  if (!orientedBinaryLabelmap || !modifiedExtent || this->ConversionParameters->GetValueAsInt(GetIncrementalUpdateParameterName()) == 0)
+  {
+    return;
+  }
+
+  // Forget about labelmaps that have been deleted
+  for (auto historyIt = this->LabelmapModifications.begin(); historyIt != this->LabelmapModifications.end();)
+  {
+    if (!historyIt->second.Labelmap)
     {
-      flyingEdges->SetValue(valueIndex, labelValue);
-      ++valueIndex;
+      historyIt = this->LabelmapModifications.erase(historyIt);
     }
-    try
+    else
     {
-      flyingEdges->Update();
+      ++historyIt;
     }
-    catch (...)
+  }
+
+  LabelmapModificationHistory& history = this->LabelmapModifications[orientedBinaryLabelmap];
+  if (history.Labelmap.GetPointer() != orientedBinaryLabelmap)
+  {
+    // A new labelmap is allocated at the address of a deleted one
+    history.Labelmap = orientedBinaryLabelmap;
+    history.Modifications.clear();
+  }
+
+  LabelmapModification modification;
+  modification.PreviousMTime = previousMTime;
+  modification.MTime = orientedBinaryLabelmap->GetMTime();
+  std::copy(modifiedExtent, modifiedExtent + 6, modification.Extent);
+  history.Modifications.push_back(modification);
+  while (history.Modifications.size() > MAXIMUM_NUMBER_OF_RECORDED_MODIFICATIONS)
+  {
+    history.Modifications.pop_front();
+  }
+}
+
+//----------------------------------------------------------------------------
+bool vtkBinaryLabelmapToClosedSurfaceConversionRule::GetModifiedExtentSince(vtkOrientedImageData* orientedBinaryLabelmap,
+                                                                            vtkMTimeType sinceMTime,
+                                                                            int modifiedExtent[6])
+{
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    modifiedExtent[axis * 2] = 0;
+    modifiedExtent[axis * 2 + 1] = -1;
+  }
+  auto historyIt = this->LabelmapModifications.find(orientedBinaryLabelmap);
+  if (historyIt == this->LabelmapModifications.end() || historyIt->second.Labelmap.GetPointer() != orientedBinaryLabelmap)
+  {
+    return false;
+  }
+
+  // Collect the modifications since the specified time. The modifications must form an unbroken chain,
+  // otherwise the labelmap was modified in some other way as well and the modified region is unknown.
+  bool firstModificationFound = false;
+  vtkMTimeType lastMTime = sinceMTime;
+  for (const LabelmapModification& modification : historyIt->second.Modifications)
+  {
+    if (!firstModificationFound)
+    {
+      if (modification.PreviousMTime != sinceMTime)
+      {
+        continue;
+      }
+      firstModificationFound = true;
+    }
+    else if (modification.PreviousMTime != lastMTime)
     {
-      vtkErrorMacro("Convert: Error while running flying edges!");
       return false;
     }
-    processingResult = flyingEdges->GetOutput();
+    AddExtentToExtent(modification.Extent, modifiedExtent);
+    lastMTime = modification.MTime;
   }
-  else if (conversionMethod == vtkBinaryLabelmapToClosedSurfaceConversionRule::CONVERSION_METHOD_SURFACE_NETS)
-  {
-    vtkNew<vtkSurfaceNets3D> surfaceNets;
-    surfaceNets->SetInputData(binaryLabelmapWithIdentityGeometry);
 
-    // Disable internal smoothing, and use vtkWindowedSincPolyDataFilter for smoothing as needed
-    surfaceNets->SmoothingOff();
+  return firstModificationFound && lastMTime == orientedBinaryLabelmap->GetMTime();
+}
+
+//----------------------------------------------------------------------------
+bool vtkBinaryLabelmapToClosedSurfaceConversionRule::UpdateClosedSurfaceIncrementally(vtkOrientedImageData* orientedBinaryLabelmap,
+                                                                                      int labelValue,
+                                                                                      vtkPolyData* closedSurfacePolyData)
+{
+  SurfaceGenerationParameters parameters;
+  parameters.DecimationFactor = this->ConversionParameters->GetValueAsDouble(GetDecimationFactorParameterName());
+  parameters.SmoothingFactor = this->ConversionParameters->GetValueAsDouble(GetSmoothingFactorParameterName());
+  parameters.ConversionMethod = this->ConversionParameters->GetValue(GetConversionMethodParameterName());
+  parameters.SurfaceNetsSmoothing = this->ConversionParameters->GetValueAsInt(GetSurfaceNetInternalSmoothingParameterName());
+  int computeSurfaceNormals = this->ConversionParameters->GetValueAsInt(GetComputeSurfaceNormalsParameterName());
+  if (parameters.ConversionMethod != vtkBinaryLabelmapToClosedSurfaceConversionRule::CONVERSION_METHOD_FLYING_EDGES
+      && parameters.ConversionMethod != vtkBinaryLabelmapToClosedSurfaceConversionRule::CONVERSION_METHOD_SURFACE_NETS)
+  {
+    vtkErrorMacro("Conversion Rule: Unknown surface generation method");
+    closedSurfacePolyData->Initialize();
+    return true;
+  }
 
-    if (surfaceNetsSmoothing == 1)
+  // Forget about labelmaps that have been deleted
+  for (auto cacheIt = this->BrickSurfaceCaches.begin(); cacheIt != this->BrickSurfaceCaches.end();)
+  {
+    if (!cacheIt->second.Labelmap)
     {
-      surfaceNets->SmoothingOn();
+      cacheIt = this->BrickSurfaceCaches.erase(cacheIt);
+    }
+    else
+    {
+      ++cacheIt;
+    }
+  }
 
-      // This formula maps (input) -> (iteration count)
-      // 0.0  ->  0   (almost no smoothing)
-      // 0.2  ->  2   (little smoothing)
-      // 0.5  ->  8   (average smoothing)
-      // 0.7  ->  14  (strong smoothing)
-      // 1.0  ->  24  (very strong smoothing)
-      double fCount = 15.0 * smoothingFactor * smoothingFactor + 9.0 * smoothingFactor;
-      int iterationCount = floor(fCount);
-      surfaceNets->SetNumberOfIterations(iterationCount);
+  BrickSurfaceCache& cache = this->BrickSurfaceCaches[std::make_pair(orientedBinaryLabelmap, labelValue)];
+  std::string parametersKey = this->GetSurfaceGenerationParametersKey();
+  vtkNew<vtkMatrix4x4> imageToWorldMatrix;
+  orientedBinaryLabelmap->GetImageToWorldMatrix(imageToWorldMatrix);
+  bool fullUpdate = (cache.Labelmap.GetPointer() != orientedBinaryLabelmap  //
+                     || cache.ConversionParametersKey != parametersKey     //
+                     || !std::equal(cache.ImageToWorldMatrix, cache.ImageToWorldMatrix + 16, imageToWorldMatrix->GetData()));
+
+  if (!fullUpdate && cache.Surface && cache.LabelmapMTime == orientedBinaryLabelmap->GetMTime())
+  {
+    // Labelmap has not changed since the last update
+    closedSurfacePolyData->ShallowCopy(cache.Surface);
+    return true;
+  }
+
+  int modifiedExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  if (!fullUpdate && !this->GetModifiedExtentSince(orientedBinaryLabelmap, cache.LabelmapMTime, modifiedExtent))
+  {
+    // Modified region is not known
+    fullUpdate = true;
+  }
+
+  int* labelmapExtent = orientedBinaryLabelmap->GetExtent();
+  if (fullUpdate)
+  {
+    cache.Bricks.clear();
+    cache.ProcessedBricks.clear();
+    cache.Labelmap = orientedBinaryLabelmap;
+    cache.ConversionParametersKey = parametersKey;
+    std::copy(imageToWorldMatrix->GetData(), imageToWorldMatrix->GetData() + 16, cache.ImageToWorldMatrix);
+    std::copy(labelmapExtent, labelmapExtent + 6, modifiedExtent);
+  }
+  cache.LabelmapMTime = orientedBinaryLabelmap->GetMTime();
+
+  BrickSurfaceGenerator generator;
+  generator.Parameters = parameters;
+  generator.LabelValue = labelValue;
+
+  // Bricks whose smoothed surface has to be updated
+  int processedBricks[6] = { 0, -1, 0, -1, 0, -1 };
+  if (!IsExtentValid(labelmapExtent) || !orientedBinaryLabelmap->GetPointData()->GetScalars())
+  {
+    cache.Bricks.clear();
+    cache.ProcessedBricks.clear();
+  }
+  else
+  {
+    generator.Scalars = static_cast<const char*>(orientedBinaryLabelmap->GetScalarPointer());
+    std::copy(labelmapExtent, labelmapExtent + 6, generator.Extent);
+    generator.ScalarType = orientedBinaryLabelmap->GetScalarType();
+    generator.ScalarSize = orientedBinaryLabelmap->GetScalarSize();
+
+    // Surface cells span between neighbor voxels, therefore the surface may extend one voxel beyond the labelmap extent
+    int domainBricks[6] = { 0, -1, 0, -1, 0, -1 };
+    int updatedBricks[6] = { 0, -1, 0, -1, 0, -1 };
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      domainBricks[axis * 2] = FloorDivide(labelmapExtent[axis * 2] - 1, BRICK_SIZE);
+      domainBricks[axis * 2 + 1] = FloorDivide(labelmapExtent[axis * 2 + 1], BRICK_SIZE);
+      if (IsExtentValid(modifiedExtent))
+      {
+        updatedBricks[axis * 2] = std::max(FloorDivide(modifiedExtent[axis * 2] - generator.Margin - 1, BRICK_SIZE), domainBricks[axis * 2]);
+        updatedBricks[axis * 2 + 1] = std::min(FloorDivide(modifiedExtent[axis * 2 + 1] + generator.Margin, BRICK_SIZE), domainBricks[axis * 2 + 1]);
+        processedBricks[axis * 2] =
+          std::max(FloorDivide(modifiedExtent[axis * 2] - generator.Margin - SEAM_MARGIN - 1, BRICK_SIZE), domainBricks[axis * 2]);
+        processedBricks[axis * 2 + 1] =
+          std::min(FloorDivide(modifiedExtent[axis * 2 + 1] + generator.Margin + SEAM_MARGIN, BRICK_SIZE), domainBricks[axis * 2 + 1]);
+      }
     }
 
-    int valueIndex = 0;
-    for (vtkIdType labelValue : labelValues)
+    // Remove bricks that are outside of the labelmap
+    for (auto brickIt = cache.Bricks.begin(); brickIt != cache.Bricks.end();)
     {
-      surfaceNets->SetValue(valueIndex, labelValue);
-      ++valueIndex;
+      brickIt = IsBrickInExtent(brickIt->first, domainBricks) ? std::next(brickIt) : cache.Bricks.erase(brickIt);
+    }
+    for (auto brickIt = cache.ProcessedBricks.begin(); brickIt != cache.ProcessedBricks.end();)
+    {
+      brickIt = IsBrickInExtent(brickIt->first, domainBricks) ? std::next(brickIt) : cache.ProcessedBricks.erase(brickIt);
     }
 
-    try
+    // Regenerate the modified bricks in parallel
+    std::vector<std::array<int, 3>> brickIndices;
+    if (IsExtentValid(updatedBricks))
     {
-      surfaceNets->Update();
+      for (int k = updatedBricks[4]; k <= updatedBricks[5]; ++k)
+      {
+        for (int j = updatedBricks[2]; j <= updatedBricks[3]; ++j)
+        {
+          for (int i = updatedBricks[0]; i <= updatedBricks[1]; ++i)
+          {
+            brickIndices.push_back({ i, j, k });
+          }
+        }
+      }
     }
-    catch (...)
+    std::vector<vtkSmartPointer<vtkPolyData>> brickSurfaces(brickIndices.size());
+    std::vector<char> brickSuccess(brickIndices.size(), 1);
+    vtkSMPTools::For(0,
+                     static_cast<vtkIdType>(brickIndices.size()),
+                     1,
+                     [&](vtkIdType begin, vtkIdType end)
+                     {
+                       for (vtkIdType brickIndex = begin; brickIndex < end; ++brickIndex)
+                       {
+                         brickSuccess[brickIndex] = generator.CreateBrickSurface(brickIndices[brickIndex], brickSurfaces[brickIndex]);
+                       }
+                     });
+
+    bool success = true;
+    for (size_t brickIndex = 0; brickIndex < brickIndices.size(); ++brickIndex)
     {
-      vtkErrorMacro("Convert: Error while running surface nets!");
+      success = success && brickSuccess[brickIndex];
+      if (brickSurfaces[brickIndex] && brickSurfaces[brickIndex]->GetNumberOfPolys() > 0)
+      {
+        cache.Bricks[brickIndices[brickIndex]] = brickSurfaces[brickIndex];
+      }
+      else
+      {
+        cache.Bricks.erase(brickIndices[brickIndex]);
+      }
+    }
+    if (!success)
+    {
+      vtkErrorMacro("UpdateClosedSurfaceIncrementally: Error while generating surface");
+      this->BrickSurfaceCaches.erase(std::make_pair(orientedBinaryLabelmap, labelValue));
       return false;
     }
-    processingResult = surfaceNets->GetOutput();
   }
-  else
+
+  if (IsExtentValid(processedBricks))
   {
-    vtkErrorMacro("Conversion Rule: Unknown surface generation method");
+    this->UpdateProcessedBrickSurfaces(orientedBinaryLabelmap,
+                                       cache,
+                                       processedBricks,
+                                       parameters.SurfaceNetsSmoothing == 0 ? parameters.SmoothingFactor : 0.0,
+                                       computeSurfaceNormals > 0 && parameters.ConversionMethod == vtkBinaryLabelmapToClosedSurfaceConversionRule::CONVERSION_METHOD_FLYING_EDGES);
   }
 
-  vtkSmartPointer<vtkPolyData> convertedSegment = vtkSmartPointer<vtkPolyData>::New();
+  vtkSmartPointer<vtkPolyData> surface = vtkSmartPointer<vtkPolyData>::New();
+  AssembleProcessedBrickSurfaces(cache, surface);
+  cache.Surface = surface;
+  closedSurfacePolyData->ShallowCopy(surface);
+  return true;
+}
 
-  if (processingResult->GetNumberOfPolys() == 0)
+//----------------------------------------------------------------------------
+void vtkBinaryLabelmapToClosedSurfaceConversionRule::UpdateProcessedBrickSurfaces(vtkOrientedImageData* orientedBinaryLabelmap,
+                                                                                  BrickSurfaceCache& cache,
+                                                                                  const int processedBricks[6],
+                                                                                  double smoothingFactor,
+                                                                                  bool computeSurfaceNormals)
+{
+  // Bricks of the processed extent and one brick around it. Smoothing of the outer bricks is distorted
+  // by the open boundary of the merged surface, therefore only the cells of the processed bricks are kept.
+  int mergedBricks[6] = { 0, -1, 0, -1, 0, -1 };
+  for (int axis = 0; axis < 3; ++axis)
   {
-    vtkDebugMacro("Convert: No polygons can be created, probably all voxels are empty");
-    convertedSegment = nullptr;
-    closedSurfacePolyData->Initialize();
+    mergedBricks[axis * 2] = processedBricks[axis * 2] - 1;
+    mergedBricks[axis * 2 + 1] = processedBricks[axis * 2 + 1] + 1;
   }
-
-  if (!convertedSegment)
+  std::vector<std::array<int, 3>> brickIndices;
+  vtkNew<vtkAppendPolyData> appender;
+  for (const auto& brick : cache.Bricks)
   {
-    return true;
+    if (!IsBrickInExtent(brick.first, mergedBricks))
+    {
+      continue;
+    }
+    vtkNew<vtkIntArray> brickIndexArray;
+    brickIndexArray->SetName(BRICK_INDEX_ARRAY_NAME);
+    brickIndexArray->SetNumberOfValues(brick.second->GetNumberOfCells());
+    brickIndexArray->FillValue(static_cast<int>(brickIndices.size()));
+    vtkNew<vtkPolyData> brickSurface;
+    brickSurface->ShallowCopy(brick.second);
+    brickSurface->GetCellData()->AddArray(brickIndexArray);
+    appender->AddInputData(brickSurface);
+    brickIndices.push_back(brick.first);
   }
 
-  // Decimate
-  if (decimationFactor > 0.0)
-  {
-    vtkSmartPointer<vtkDecimatePro> decimator = vtkSmartPointer<vtkDecimatePro>::New();
-    decimator->SetInputData(processingResult);
-    decimator->SetFeatureAngle(60);
-    decimator->SplittingOff();
-    decimator->PreserveTopologyOn();
-    decimator->SetMaximumError(1);
-    decimator->SetTargetReduction(decimationFactor);
-    decimator->Update();
-    processingResult = decimator->GetOutput();
-  }
-
-  if (smoothingFactor > 0 && surfaceNetsSmoothing == 0)
-  {
-    vtkSmartPointer<vtkWindowedSincPolyDataFilter> smoother = vtkSmartPointer<vtkWindowedSincPolyDataFilter>::New();
-    smoother->SetInputData(processingResult);
-
-    // Smoothing factor is a user-friendly linear scale that we need to maps to low-pass filter parameters.
-    // Default smoothing aims for removing blocky appearance (staircase artifacts) while avoiding shrinking.
-    // Typically a few ten iterations are sufficient, but stronger smoothing requires more iterations.
-    //
-    //   Smoothing factor                             Passband   Iterations
-    //
-    //     0.0  (almost no smoothing, blocky)      ->   1.0          20
-    //     0.25 (less smoothing, somewhat blocky)  ->   0.1          30
-    //     0.5  (default smoothing)                ->   0.01         40
-    //     0.75 (more smoothing, somewhat shrinks) ->   0.001        50
-    //     1.0  (very strong smoothing, shrinks)   ->   0.0001       60
-    //
-    double passBand = pow(10.0, -4.0 * smoothingFactor);
-    int numberOfIterations = 20 + smoothingFactor * 40;
-
-    smoother->SetNumberOfIterations(numberOfIterations);
-    smoother->SetPassBand(passBand);
-    smoother->BoundarySmoothingOff();
-    smoother->FeatureEdgeSmoothingOff();
-    smoother->NonManifoldSmoothingOn();
-    smoother->NormalizeCoordinatesOn();
-    smoother->Update();
-    processingResult = smoother->GetOutput();
+  // Smoothed surfaces of the processed bricks are replaced
+  for (auto brickIt = cache.ProcessedBricks.begin(); brickIt != cache.ProcessedBricks.end();)
+  {
+    brickIt = IsBrickInExtent(brickIt->first, processedBricks) ? cache.ProcessedBricks.erase(brickIt) : std::next(brickIt);
+  }
+  if (brickIndices.empty())
+  {
+    return;
   }
 
-  // Transform the result surface from labelmap IJK to world coordinate system
-  vtkSmartPointer<vtkTransform> labelmapGeometryTransform = vtkSmartPointer<vtkTransform>::New();
-  vtkSmartPointer<vtkMatrix4x4> labelmapImageToWorldMatrix = vtkSmartPointer<vtkMatrix4x4>::New();
-  orientedBinaryLabelmap->GetImageToWorldMatrix(labelmapImageToWorldMatrix);
-  labelmapGeometryTransform->SetMatrix(labelmapImageToWorldMatrix);
+  // Points on brick boundaries are generated from the same voxels in neighbor bricks, therefore
+  // they are exactly coincident. Merge them to get a watertight surface.
+  vtkNew<vtkCleanPolyData> seamMerger;
+  seamMerger->SetInputConnection(appender->GetOutputPort());
+  seamMerger->PointMergingOn();
+  seamMerger->SetTolerance(0.0);
+  seamMerger->Update();
+  vtkSmartPointer<vtkPolyData> unsmoothedSurface = seamMerger->GetOutput();
+
+  // Smoothing, transform and normal computation keep the point and cell order
+  SurfaceGenerationParameters parameters;
+  parameters.SmoothingFactor = smoothingFactor;
+  vtkSmartPointer<vtkPolyData> smoothedSurface = unsmoothedSurface;
+  SmoothSurface(smoothedSurface, parameters);
+  vtkNew<vtkPolyData> mergedSurface;
+  TransformSurfaceToWorld(orientedBinaryLabelmap, smoothedSurface, computeSurfaceNormals, mergedSurface);
+
+  // Sort the polygons by brick and find the points that are shared between bricks
+  vtkIntArray* cellBrickIndices = vtkIntArray::SafeDownCast(mergedSurface->GetCellData()->GetArray(BRICK_INDEX_ARRAY_NAME));
+  if (!cellBrickIndices)
+  {
+    vtkErrorMacro("UpdateProcessedBrickSurfaces: Brick index is missing from the merged surface");
+    return;
+  }
+  const vtkIdType firstPolyCellId = mergedSurface->GetNumberOfVerts() + mergedSurface->GetNumberOfLines();
+  std::vector<std::vector<vtkIdType>> brickPolyIds(brickIndices.size());
+  std::vector<int> pointBrickIndices(mergedSurface->GetNumberOfPoints(), -1);
+  std::vector<bool> sharedPoints(mergedSurface->GetNumberOfPoints(), false);
+  vtkCellArray* polys = mergedSurface->GetPolys();
+  vtkIdType numberOfCellPoints = 0;
+  const vtkIdType* cellPointIds = nullptr;
+  for (vtkIdType polyId = 0; polyId < polys->GetNumberOfCells(); ++polyId)
+  {
+    int brickIndex = cellBrickIndices->GetValue(firstPolyCellId + polyId);
+    brickPolyIds[brickIndex].push_back(polyId);
+    polys->GetCellAtId(polyId, numberOfCellPoints, cellPointIds);
+    for (vtkIdType pointIndex = 0; pointIndex < numberOfCellPoints; ++pointIndex)
+    {
+      int& pointBrickIndex = pointBrickIndices[cellPointIds[pointIndex]];
+      if (pointBrickIndex >= 0 && pointBrickIndex != brickIndex)
+      {
+        sharedPoints[cellPointIds[pointIndex]] = true;
+      }
+      pointBrickIndex = brickIndex;
+    }
+  }
 
-  vtkSmartPointer<vtkTransformPolyDataFilter> transformPolyDataFilter = vtkSmartPointer<vtkTransformPolyDataFilter>::New();
-  transformPolyDataFilter->SetInputData(processingResult);
-  transformPolyDataFilter->SetTransform(labelmapGeometryTransform);
+  std::vector<vtkIdType> pointIdMap(mergedSurface->GetNumberOfPoints(), -1);
+  for (size_t brickIndex = 0; brickIndex < brickIndices.size(); ++brickIndex)
+  {
+    if (!IsBrickInExtent(brickIndices[brickIndex], processedBricks) || brickPolyIds[brickIndex].empty())
+    {
+      continue;
+    }
+    ProcessedBrickSurface& processedBrick = cache.ProcessedBricks[brickIndices[brickIndex]];
+    ExtractBrickCells(mergedSurface,
+                      unsmoothedSurface->GetPoints(),
+                      brickPolyIds[brickIndex],
+                      sharedPoints,
+                      pointIdMap,
+                      processedBrick.Surface,
+                      processedBrick.SeamPointIds,
+                      processedBrick.SeamPointPositions);
+  }
+}
 
-  if (computeSurfaceNormals > 0 && conversionMethod == vtkBinaryLabelmapToClosedSurfaceConversionRule::CONVERSION_METHOD_FLYING_EDGES)
+//----------------------------------------------------------------------------
+void vtkBinaryLabelmapToClosedSurfaceConversionRule::AssembleProcessedBrickSurfaces(const BrickSurfaceCache& cache, vtkPolyData* surface)
+{
+  surface->Initialize();
+  if (cache.ProcessedBricks.empty())
   {
-    vtkSmartPointer<vtkPolyDataNormals> polyDataNormals = vtkSmartPointer<vtkPolyDataNormals>::New();
-    polyDataNormals->SetInputConnection(transformPolyDataFilter->GetOutputPort());
-    polyDataNormals->ConsistencyOn(); // discrete marching cubes may generate inconsistent surface
+    return;
+  }
 
-    // We almost always perform smoothing, so splitting would not be able to preserve any sharp features
-    // (and sharp edges would look like artifacts in the smooth surface).
-    polyDataNormals->SplittingOff();
-    polyDataNormals->Update();
-    convertedSegment->ShallowCopy(polyDataNormals->GetOutput());
+  vtkPolyData* firstBrickSurface = cache.ProcessedBricks.begin()->second.Surface;
+  vtkDataArray* firstBrickNormals = firstBrickSurface->GetPointData()->GetNormals();
+  vtkNew<vtkPoints> points;
+  points->SetDataType(firstBrickSurface->GetPoints()->GetDataType());
+  vtkSmartPointer<vtkDataArray> normals;
+  if (firstBrickNormals)
+  {
+    normals = vtkSmartPointer<vtkDataArray>::Take(firstBrickNormals->NewInstance());
+    normals->SetName(firstBrickNormals->GetName());
+    normals->SetNumberOfComponents(3);
   }
-  else
+  vtkNew<vtkCellArray> polys;
+
+  // Seam points that have been added already, indexed by their unsmoothed position.
+  // Neighbor bricks may have been smoothed separately, therefore position of the first brick is used.
+  std::map<std::array<double, 3>, vtkIdType> seamPoints;
+  std::vector<vtkIdType> pointIds;
+  std::vector<vtkIdType> cellPointIds;
+  for (const auto& brick : cache.ProcessedBricks)
   {
-    transformPolyDataFilter->Update();
-    convertedSegment->ShallowCopy(transformPolyDataFilter->GetOutput());
+    const ProcessedBrickSurface& processedBrick = brick.second;
+    vtkPoints* brickPoints = processedBrick.Surface->GetPoints();
+    vtkDataArray* brickNormals = processedBrick.Surface->GetPointData()->GetNormals();
+
+    pointIds.assign(processedBrick.Surface->GetNumberOfPoints(), -1);
+    for (size_t seamPointIndex = 0; seamPointIndex < processedBrick.SeamPointIds.size(); ++seamPointIndex)
+    {
+      auto seamPointIt = seamPoints.find(processedBrick.SeamPointPositions[seamPointIndex]);
+      if (seamPointIt != seamPoints.end())
+      {
+        pointIds[processedBrick.SeamPointIds[seamPointIndex]] = seamPointIt->second;
+      }
+    }
+    for (vtkIdType pointId = 0; pointId < static_cast<vtkIdType>(pointIds.size()); ++pointId)
+    {
+      if (pointIds[pointId] >= 0)
+      {
+        continue;
+      }
+      pointIds[pointId] = points->InsertNextPoint(brickPoints->GetPoint(pointId));
+      if (normals && brickNormals)
+      {
+        normals->InsertNextTuple(brickNormals->GetTuple(pointId));
+      }
+    }
+    for (size_t seamPointIndex = 0; seamPointIndex < processedBrick.SeamPointIds.size(); ++seamPointIndex)
+    {
+      seamPoints.emplace(processedBrick.SeamPointPositions[seamPointIndex], pointIds[processedBrick.SeamPointIds[seamPointIndex]]);
+    }
+
+    vtkCellArray* brickPolys = processedBrick.Surface->GetPolys();
+    vtkIdType numberOfCellPoints = 0;
+    const vtkIdType* brickCellPointIds = nullptr;
+    brickPolys->InitTraversal();
+    while (brickPolys->GetNextCell(numberOfCellPoints, brickCellPointIds))
+    {
+      cellPointIds.resize(numberOfCellPoints);
+      for (vtkIdType pointIndex = 0; pointIndex < numberOfCellPoints; ++pointIndex)
+      {
+        cellPointIds[pointIndex] = pointIds[brickCellPointIds[pointIndex]];
+      }
+      polys->InsertNextCell(numberOfCellPoints, cellPointIds.data());
+    }
   }
 
-  closedSurfacePolyData->ShallowCopy(convertedSegment);
-  return true;
+  surface->SetPoints(points);
+  surface->SetPolys(polys);
+  if (normals)
+  {
+    surface->GetPointData()->SetNormals(normals);
+  }
 }
 
 //----------------------------------------------------------------------------
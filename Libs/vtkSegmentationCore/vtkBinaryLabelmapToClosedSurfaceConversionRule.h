@@ -29,11 +29,25 @@
 
 // VTK includes
 #include <vtkPolyData.h>
+#include <vtkWeakPointer.h>
+
+// STD includes
+#include <array>
+#include <deque>
+#include <map>
+#include <vector>
 
 /// \brief Convert binary labelmap representation (vtkOrientedImageData type) to
 ///   closed surface representation (vtkPolyData type). The conversion algorithm
 ///   performs a marching cubes operation on the image data followed by an optional
 ///   decimation step.
+///
+/// If incremental update is enabled, the surface of each segment is cached as a set of
+/// bricks (fixed size blocks of the labelmap) and only those bricks are regenerated that
+/// intersect the region modified by vtkSegmentationModifier. Bricks are extracted and decimated
+/// separately (decimation keeps brick boundaries unchanged). The smoothed surface of each brick is
+/// cached as well: only the regenerated bricks and the bricks within a seam margin around them are
+/// merged with their neighbors and smoothed again, then all bricks are joined into a watertight surface.
 class vtkSegmentationCore_EXPORT vtkBinaryLabelmapToClosedSurfaceConversionRule : public vtkSegmentationConverterRule
 {
 public:
@@ -53,6 +67,10 @@ public:
   /// If joint smoothing is enabled, surfaces will be created and smoothed as one vtkPolyData.
   /// Joint smoothing converts all segments in shared labelmap together, reducing smoothing artifacts.
   static const std::string GetJointSmoothingParameterName() { return "Joint smoothing"; };
+  /// Conversion parameter: incremental update
+  /// If incremental update is enabled, only the modified region of the surface is regenerated
+  /// after the binary labelmap is edited. Not used if joint smoothing or SurfaceNets smoothing is enabled.
+  static const std::string GetIncrementalUpdateParameterName() { return "Incremental update"; };
 
   // Conversion methods
   static const std::string CONVERSION_METHOD_FLYING_EDGES;
@@ -83,6 +101,9 @@ public:
   /// Clears the joint smoothing cache
   bool PostConvert(vtkSegmentation* segmentation) override;
 
+  /// Record the modified region of a binary labelmap for incremental surface update
+  void SourceRepresentationRegionModified(vtkDataObject* sourceRepresentation, const int modifiedExtent[6], vtkMTimeType previousMTime) override;
+
   /// Get the cost of the conversion.
   unsigned int GetConversionCost(vtkDataObject* sourceRepresentation = nullptr, vtkDataObject* targetRepresentation = nullptr) override;
 
@@ -100,6 +121,32 @@ protected:
   /// This function checks whether this is the case.
   bool IsLabelmapPaddingNecessary(vtkImageData* binaryLabelMap);
 
+  /// Update the closed surface of a label value by only regenerating the bricks that have
+  /// been modified since the last update. Falls back to regenerating all bricks if the
+  /// modified region is not known.
+  bool UpdateClosedSurfaceIncrementally(vtkOrientedImageData* orientedBinaryLabelmap, int labelValue, vtkPolyData* closedSurfacePolyData);
+
+  /// Get the union of all regions of the labelmap that were modified since the specified modified time.
+  /// \return False if the modifications since the specified time are not all known.
+  bool GetModifiedExtentSince(vtkOrientedImageData* orientedBinaryLabelmap, vtkMTimeType sinceMTime, int modifiedExtent[6]);
+
+  /// Get a string that identifies the current values of the parameters that affect the surface
+  std::string GetSurfaceGenerationParametersKey();
+
+  struct BrickSurfaceCache;
+
+  /// Smooth the bricks of the cache that are within the specified brick extent and store the result
+  /// in the processed bricks of the cache. The bricks are merged with the neighbor bricks around the extent
+  /// before smoothing, so that points near brick boundaries are smoothed the same way as in the full surface.
+  void UpdateProcessedBrickSurfaces(vtkOrientedImageData* orientedBinaryLabelmap,
+                                    BrickSurfaceCache& cache,
+                                    const int processedBricks[6],
+                                    double smoothingFactor,
+                                    bool computeSurfaceNormals);
+
+  /// Join the processed bricks of the cache into a single surface, merging the points on brick boundaries
+  static void AssembleProcessedBrickSurfaces(const BrickSurfaceCache& cache, vtkPolyData* surface);
+
 protected:
   vtkBinaryLabelmapToClosedSurfaceConversionRule();
   ~vtkBinaryLabelmapToClosedSurfaceConversionRule() override;
@@ -109,6 +156,54 @@ protected:
   /// The key used is the binary labelmap representation, which maps to the combined vtkPolyData containing surfaces for all segments in the segmentation
   std::map<vtkOrientedImageData*, vtkSmartPointer<vtkPolyData>> JointSmoothCache;
 
+  /// Region of a labelmap that was modified between two modified times
+  struct LabelmapModification
+  {
+    vtkMTimeType PreviousMTime{ 0 };
+    vtkMTimeType MTime{ 0 };
+    int Extent[6]{ 0, -1, 0, -1, 0, -1 };
+  };
+
+  /// Recent modifications of a labelmap, in chronological order
+  struct LabelmapModificationHistory
+  {
+    vtkWeakPointer<vtkOrientedImageData> Labelmap;
+    std::deque<LabelmapModification> Modifications;
+  };
+
+  /// Smoothed surface of a brick, in world coordinate system
+  struct ProcessedBrickSurface
+  {
+    vtkSmartPointer<vtkPolyData> Surface;
+    /// Points of the surface that are shared with neighbor bricks
+    std::vector<vtkIdType> SeamPointIds;
+    /// Unsmoothed IJK position of each seam point, which is identical in the neighbor bricks
+    std::vector<std::array<double, 3>> SeamPointPositions;
+  };
+
+  /// Surface of a label value in a labelmap, stored as separate bricks
+  struct BrickSurfaceCache
+  {
+    vtkWeakPointer<vtkOrientedImageData> Labelmap;
+    /// Modified time of the labelmap when the surface was last updated
+    vtkMTimeType LabelmapMTime{ 0 };
+    /// Conversion parameters that the surface was generated with
+    std::string ConversionParametersKey;
+    double ImageToWorldMatrix[16]{ 0.0 };
+    /// Decimated, unsmoothed surface of each non-empty brick in IJK coordinate system, indexed by brick position
+    std::map<std::array<int, 3>, vtkSmartPointer<vtkPolyData>> Bricks;
+    /// Smoothed surface of each non-empty brick in world coordinate system, indexed by brick position
+    std::map<std::array<int, 3>, ProcessedBrickSurface> ProcessedBricks;
+    /// Surface assembled from all the bricks, in world coordinate system
+    vtkSmartPointer<vtkPolyData> Surface;
+  };
+
+  /// Modification history of labelmaps, used for incremental surface update
+  std::map<vtkOrientedImageData*, LabelmapModificationHistory> LabelmapModifications;
+
+  /// Cache of brick surfaces for each labelmap and label value, used for incremental surface update
+  std::map<std::pair<vtkOrientedImageData*, int>, BrickSurfaceCache> BrickSurfaceCaches;
+
 private:
   vtkBinaryLabelmapToClosedSurfaceConversionRule(const vtkBinaryLabelmapToClosedSurfaceConversionRule&) = delete;
   void operator=(const vtkBinaryLabelmapToClosedSurfaceConversionRule&) = delete;
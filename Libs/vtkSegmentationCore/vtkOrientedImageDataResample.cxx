@@ -48,6 +48,76 @@
 
 vtkStandardNewMacro(vtkOrientedImageDataResample);
 
+//----------------------------------------------------------------------------
+// Row kernels of the merge operations.
+// The loops have no early exits and no data-dependent branches so that compilers can vectorize them.
+// Each kernel first checks if any voxel of the row has to be changed and only writes the row if needed
+// (this avoids writing memory and allows reporting if the image has been modified).
+template <class BaseImageScalarType, class ModifierImageScalarType>
+bool MaximumRow(BaseImageScalarType* baseRowPtr, const ModifierImageScalarType* modifierRowPtr, vtkIdType rowLength)
+{
+  int rowModified = 0;
+  for (vtkIdType idxX = 0; idxX < rowLength; idxX++)
+  {
+    rowModified |= (static_cast<BaseImageScalarType>(modifierRowPtr[idxX]) > baseRowPtr[idxX]);
+  }
+  if (!rowModified)
+  {
+    return false;
+  }
+  for (vtkIdType idxX = 0; idxX < rowLength; idxX++)
+  {
+    BaseImageScalarType modifierValue = static_cast<BaseImageScalarType>(modifierRowPtr[idxX]);
+    baseRowPtr[idxX] = (modifierValue > baseRowPtr[idxX]) ? modifierValue : baseRowPtr[idxX];
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+template <class BaseImageScalarType, class ModifierImageScalarType>
+bool MinimumRow(BaseImageScalarType* baseRowPtr, const ModifierImageScalarType* modifierRowPtr, vtkIdType rowLength)
+{
+  int rowModified = 0;
+  for (vtkIdType idxX = 0; idxX < rowLength; idxX++)
+  {
+    rowModified |= (static_cast<BaseImageScalarType>(modifierRowPtr[idxX]) < baseRowPtr[idxX]);
+  }
+  if (!rowModified)
+  {
+    return false;
+  }
+  for (vtkIdType idxX = 0; idxX < rowLength; idxX++)
+  {
+    BaseImageScalarType modifierValue = static_cast<BaseImageScalarType>(modifierRowPtr[idxX]);
+    baseRowPtr[idxX] = (modifierValue < baseRowPtr[idxX]) ? modifierValue : baseRowPtr[idxX];
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+template <class BaseImageScalarType, class ModifierImageScalarType>
+bool MaskRow(BaseImageScalarType* baseRowPtr,
+             const ModifierImageScalarType* modifierRowPtr,
+             vtkIdType rowLength,
+             ModifierImageScalarType maskThreshold,
+             BaseImageScalarType fillValue)
+{
+  int rowModified = 0;
+  for (vtkIdType idxX = 0; idxX < rowLength; idxX++)
+  {
+    rowModified |= (modifierRowPtr[idxX] > maskThreshold);
+  }
+  if (!rowModified)
+  {
+    return false;
+  }
+  for (vtkIdType idxX = 0; idxX < rowLength; idxX++)
+  {
+    baseRowPtr[idxX] = (modifierRowPtr[idxX] > maskThreshold) ? fillValue : baseRowPtr[idxX];
+  }
+  return true;
+}
+
 //----------------------------------------------------------------------------
 // This templated function executes the filter for any type of data.
 template <class BaseImageScalarType, class ModifierImageScalarType>
@@ -109,31 +179,22 @@ void MergeImageGeneric2(vtkImageData* baseImage, vtkImageData* modifierImage, in
   }
 
   bool baseImageModified = false;
+  const vtkIdType rowLength = maxX + 1;
 
-  // Loop through output pixels
-  // There is difference in only one line between min/max computation but the comparison
-  // is performed for each pixel, so it is faster to make the conditional expression in the outer loop.
-  // Looping is performed in two step: first we just check if any of the pixels have to be changed,
-  // if we find any, then we set baseImageModified flag and to the second loop without need to set
-  // baseImageModified flag again (setting a flag in a hot loop may impact speed).
+  // Loop through output rows. The operation is selected in the outer loop so that
+  // each row is processed by a simple kernel that the compiler can vectorize.
   if (operation == vtkOrientedImageDataResample::OPERATION_MAXIMUM)
   {
     for (vtkIdType idxZ = 0; idxZ <= maxZ; idxZ++)
     {
       for (vtkIdType idxY = 0; idxY <= maxY; idxY++)
       {
-        for (vtkIdType idxX = 0; idxX <= maxX; idxX++)
+        if (MaximumRow(baseImagePtr, modifierImagePtr, rowLength))
         {
-          if (static_cast<BaseImageScalarType>(*modifierImagePtr) > *baseImagePtr)
-          {
-            *baseImagePtr = *modifierImagePtr;
-            baseImageModified = true;
-          }
-          baseImagePtr++;
-          modifierImagePtr++;
+          baseImageModified = true;
         }
-        baseImagePtr += baseIncY;
-        modifierImagePtr += modifierIncY;
+        baseImagePtr += rowLength + baseIncY;
+        modifierImagePtr += rowLength + modifierIncY;
       }
       baseImagePtr += baseIncZ;
       modifierImagePtr += modifierIncZ;
@@ -145,18 +206,12 @@ void MergeImageGeneric2(vtkImageData* baseImage, vtkImageData* modifierImage, in
     {
       for (vtkIdType idxY = 0; idxY <= maxY; idxY++)
       {
-        for (vtkIdType idxX = 0; idxX <= maxX; idxX++)
+        if (MinimumRow(baseImagePtr, modifierImagePtr, rowLength))
         {
-          if (static_cast<BaseImageScalarType>(*modifierImagePtr) < *baseImagePtr)
-          {
-            *baseImagePtr = *modifierImagePtr;
-            baseImageModified = true;
-          }
-          baseImagePtr++;
-          modifierImagePtr++;
+          baseImageModified = true;
         }
-        baseImagePtr += baseIncY;
-        modifierImagePtr += modifierIncY;
+        baseImagePtr += rowLength + baseIncY;
+        modifierImagePtr += rowLength + modifierIncY;
       }
       baseImagePtr += baseIncZ;
       modifierImagePtr += modifierIncZ;
@@ -199,18 +254,12 @@ void MergeImageGeneric2(vtkImageData* baseImage, vtkImageData* modifierImage, in
     {
       for (vtkIdType idxY = 0; idxY <= maxY; idxY++)
       {
-        for (vtkIdType idxX = 0; idxX <= maxX; idxX++)
+        if (MaskRow(baseImagePtr, modifierImagePtr, rowLength, maskThresholdModifierType, fillValueBaseImageType))
         {
-          if ((*modifierImagePtr) > maskThresholdModifierType)
-          {
-            *baseImagePtr = fillValueBaseImageType;
-            baseImageModified = true;
-          }
-          baseImagePtr++;
-          modifierImagePtr++;
+          baseImageModified = true;
         }
-        baseImagePtr += baseIncY;
-        modifierImagePtr += modifierIncY;
+        baseImagePtr += rowLength + baseIncY;
+        modifierImagePtr += rowLength + modifierIncY;
       }
       baseImagePtr += baseIncZ;
       modifierImagePtr += modifierIncZ;
@@ -574,6 +623,77 @@ bool vtkOrientedImageDataResample::IsEqual(vtkMatrix4x4* lhs, vtkMatrix4x4* rhs)
          AreEqualWithTolerance(lhs->GetElement(3, 3), rhs->GetElement(3, 3));
 }
 
+//----------------------------------------------------------------------------
+// Number of voxels that are checked at once when searching for non-empty voxels.
+// Checking a block is a branch-free loop that the compiler can vectorize, and the exact
+// position is only searched for in the block that contains a non-empty voxel.
+static const vtkIdType EFFECTIVE_EXTENT_SEARCH_BLOCK_SIZE = 64;
+
+//----------------------------------------------------------------------------
+// Returns the index of the first voxel in the row that is above the threshold, or rowLength if there is none.
+template <typename T>
+vtkIdType FindFirstVoxelAboveThreshold(const T* rowPtr, vtkIdType rowLength, T threshold)
+{
+  for (vtkIdType blockStart = 0; blockStart < rowLength; blockStart += EFFECTIVE_EXTENT_SEARCH_BLOCK_SIZE)
+  {
+    vtkIdType blockEnd = std::min(blockStart + EFFECTIVE_EXTENT_SEARCH_BLOCK_SIZE, rowLength);
+    int found = 0;
+    for (vtkIdType i = blockStart; i < blockEnd; i++)
+    {
+      found |= (rowPtr[i] > threshold);
+    }
+    if (found)
+    {
+      for (vtkIdType i = blockStart; i < blockEnd; i++)
+      {
+        if (rowPtr[i] > threshold)
+        {
+          return i;
+        }
+      }
+    }
+  }
+  return rowLength;
+}
+
+//----------------------------------------------------------------------------
+// Returns the index of the last voxel in the row that is above the threshold, or -1 if there is none.
+template <typename T>
+vtkIdType FindLastVoxelAboveThreshold(const T* rowPtr, vtkIdType rowLength, T threshold)
+{
+  for (vtkIdType blockEnd = rowLength; blockEnd > 0; blockEnd -= EFFECTIVE_EXTENT_SEARCH_BLOCK_SIZE)
+  {
+    vtkIdType blockStart = std::max(blockEnd - EFFECTIVE_EXTENT_SEARCH_BLOCK_SIZE, vtkIdType(0));
+    int found = 0;
+    for (vtkIdType i = blockStart; i < blockEnd; i++)
+    {
+      found |= (rowPtr[i] > threshold);
+    }
+    if (found)
+    {
+      for (vtkIdType i = blockEnd - 1; i >= blockStart; i--)
+      {
+        if (rowPtr[i] > threshold)
+        {
+          return i;
+        }
+      }
+    }
+  }
+  return -1;
+}
+
+//----------------------------------------------------------------------------
+void ExpandExtentToContainVoxel(int extent[6], int i, int j, int k)
+{
+  extent[0] = std::min(extent[0], i);
+  extent[1] = std::max(extent[1], i);
+  extent[2] = std::min(extent[2], j);
+  extent[3] = std::max(extent[3], j);
+  extent[4] = std::min(extent[4], k);
+  extent[5] = std::max(extent[5], k);
+}
+
 //----------------------------------------------------------------------------
 template <typename T>
 void CalculateEffectiveExtentGeneric(vtkOrientedImageData* image, int effectiveExtent[6], T threshold)
@@ -594,85 +714,39 @@ void CalculateEffectiveExtentGeneric(vtkOrientedImageData* image, int effectiveE
     return;
   }
 
-  // Loop through output pixels
+  const vtkIdType rowLength = wholeExt[1] - wholeExt[0] + 1;
+
+  // Loop through image rows
   for (int k = wholeExt[4]; k <= wholeExt[5]; k++)
   {
     for (int j = wholeExt[2]; j <= wholeExt[3]; j++)
     {
       bool currentLineInEffectiveExtent = (k >= effectiveExtent[4] && k <= effectiveExtent[5] && j >= effectiveExtent[2] && j <= effectiveExtent[3]);
-      int i = wholeExt[0];
-      T* imagePtr = static_cast<T*>(image->GetScalarPointer(i, j, k));
-      int firstSegmentEnd = currentLineInEffectiveExtent ? effectiveExtent[0] : wholeExt[1];
-      for (; i <= firstSegmentEnd; i++)
+      const T* rowPtr = static_cast<T*>(image->GetScalarPointer(wholeExt[0], j, k));
+
+      // If this line is already in the effective extent then only the voxels before the effective extent need to be checked
+      vtkIdType firstSegmentLength = currentLineInEffectiveExtent ? std::min<vtkIdType>(effectiveExtent[0] - wholeExt[0], rowLength) : rowLength;
+      vtkIdType firstIndex = FindFirstVoxelAboveThreshold(rowPtr, firstSegmentLength, threshold);
+      if (firstIndex < firstSegmentLength)
       {
-        if (*(imagePtr++) > threshold)
-        {
-          if (i < effectiveExtent[0])
-          {
-            effectiveExtent[0] = i;
-          }
-          if (i > effectiveExtent[1])
-          {
-            effectiveExtent[1] = i;
-          }
-          if (j < effectiveExtent[2])
-          {
-            effectiveExtent[2] = j;
-          }
-          if (j > effectiveExtent[3])
-          {
-            effectiveExtent[3] = j;
-          }
-          if (k < effectiveExtent[4])
-          {
-            effectiveExtent[4] = k;
-          }
-          if (k > effectiveExtent[5])
-          {
-            effectiveExtent[5] = k;
-          }
-          currentLineInEffectiveExtent = true;
-          break;
-        }
+        ExpandExtentToContainVoxel(effectiveExtent, wholeExt[0] + static_cast<int>(firstIndex), j, k);
+        currentLineInEffectiveExtent = true;
       }
       if (!currentLineInEffectiveExtent)
       {
         // We haven't found any non-empty voxel in this line
         continue;
       }
+
       // Now we need to find the other end of the extent: the last non-empty voxel in the line.
-      // The fastest way to find it is to start backward search from the end of the line.
-      i = wholeExt[1];
-      imagePtr = static_cast<T*>(image->GetScalarPointer(i, j, k));
-      for (; i > effectiveExtent[1]; i--)
+      // Only the voxels after the current effective extent need to be checked.
+      vtkIdType lastSegmentStart = effectiveExtent[1] + 1 - wholeExt[0];
+      if (lastSegmentStart < rowLength)
       {
-        if (*(imagePtr--) > threshold)
+        vtkIdType lastIndex = FindLastVoxelAboveThreshold(rowPtr + lastSegmentStart, rowLength - lastSegmentStart, threshold);
+        if (lastIndex >= 0)
         {
-          if (i < effectiveExtent[0])
-          {
-            effectiveExtent[0] = i;
-          }
-          if (i > effectiveExtent[1])
-          {
-            effectiveExtent[1] = i;
-          }
-          if (j < effectiveExtent[2])
-          {
-            effectiveExtent[2] = j;
-          }
-          if (j > effectiveExtent[3])
-          {
-            effectiveExtent[3] = j;
-          }
-          if (k < effectiveExtent[4])
-          {
-            effectiveExtent[4] = k;
-          }
-          if (k > effectiveExtent[5])
-          {
-            effectiveExtent[5] = k;
-          }
-          break;
+          ExpandExtentToContainVoxel(effectiveExtent, wholeExt[0] + static_cast<int>(lastSegmentStart + lastIndex), j, k);
         }
       }
     }
@@ -27,6 +27,7 @@
 #include "vtkOrientedImageData.h"
 #include "vtkOrientedImageDataResample.h"
 #include "vtkCalculateOversamplingFactor.h"
+#include "vtkSparseOrientedImageData.h"
 
 // VTK includes
 #include <vtkAbstractTransform.h>
@@ -1690,6 +1691,202 @@ bool vtkSegmentation::GenerateMergedLabelmap(vtkOrientedImageData* sharedImageDa
   return success;
 }
 
+//---------------------------------------------------------------------------
+bool vtkSegmentation::GenerateMergedLabelmap(vtkSparseOrientedImageData* mergedImageData,
+                                             vtkOrientedImageData* mergedLabelmapGeometry /*=nullptr*/,
+                                             const std::vector<std::string>& segmentIDs /*=std::vector<std::string>()*/,
+                                             vtkIntArray* labelValues /*=nullptr*/)
+{
+  if (!mergedImageData)
+  {
+    vtkErrorMacro("GenerateMergedLabelmap: Invalid image data");
+    return false;
+  }
+
+  if (!this->ContainsRepresentation(vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName()))
+  {
+    vtkErrorMacro("GenerateMergedLabelmap: Segmentation does not contain binary labelmap representation");
+    return false;
+  }
+
+  // If segment IDs list is empty then include all segments
+  std::vector<std::string> mergedSegmentIDs;
+  if (segmentIDs.empty())
+  {
+    this->GetSegmentIDs(mergedSegmentIDs);
+  }
+  else
+  {
+    mergedSegmentIDs = segmentIDs;
+  }
+
+  if (labelValues && labelValues->GetNumberOfValues() != static_cast<vtkIdType>(mergedSegmentIDs.size()))
+  {
+    vtkErrorMacro("GenerateMergedLabelmap: Number of label values does not equal the number of segment IDs");
+    return false;
+  }
+
+  // Only the lattice of the geometry is used, bricks are allocated wherever the segments are
+  vtkNew<vtkMatrix4x4> mergedImageToWorldMatrix;
+  if (mergedLabelmapGeometry)
+  {
+    mergedLabelmapGeometry->GetImageToWorldMatrix(mergedImageToWorldMatrix);
+  }
+  else
+  {
+    std::string commonGeometryString = this->DetermineCommonLabelmapGeometry(EXTENT_UNION_OF_SEGMENTS, mergedSegmentIDs);
+    if (commonGeometryString.empty())
+    {
+      // This can occur if there are only empty segments in the segmentation
+      mergedImageData->Initialize();
+      return true;
+    }
+    vtkNew<vtkOrientedImageData> commonGeometryImage;
+    vtkSegmentationConverter::DeserializeImageGeometry(commonGeometryString, commonGeometryImage, false);
+    commonGeometryImage->GetImageToWorldMatrix(mergedImageToWorldMatrix);
+  }
+  mergedImageData->Initialize();
+  mergedImageData->SetScalarType(VTK_SHORT);
+  mergedImageData->SetImageToWorldMatrix(mergedImageToWorldMatrix);
+
+  bool success = true;
+  short segmentIndex = 0;
+  for (std::vector<std::string>::iterator segmentIdIt = mergedSegmentIDs.begin(); segmentIdIt != mergedSegmentIDs.end(); ++segmentIdIt, ++segmentIndex)
+  {
+    std::string currentSegmentId = *segmentIdIt;
+    vtkSegment* currentSegment = this->GetSegment(currentSegmentId);
+    if (!currentSegment)
+    {
+      vtkErrorMacro("GenerateMergedLabelmap: Segment not found by ID: " << currentSegmentId);
+      success = false;
+      continue;
+    }
+
+    vtkOrientedImageData* representationBinaryLabelmap =
+      vtkOrientedImageData::SafeDownCast(currentSegment->GetRepresentation(vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName()));
+    if (!representationBinaryLabelmap || representationBinaryLabelmap->IsEmpty())
+    {
+      continue;
+    }
+
+    // If labelmap geometries (origin, spacing, and directions) do not match the merged labelmap then resample temporarily
+    vtkOrientedImageData* binaryLabelmap = representationBinaryLabelmap;
+    vtkSmartPointer<vtkOrientedImageData> resampledBinaryLabelmap;
+    vtkNew<vtkMatrix4x4> segmentImageToWorldMatrix;
+    representationBinaryLabelmap->GetImageToWorldMatrix(segmentImageToWorldMatrix);
+    if (!vtkOrientedImageDataResample::IsEqual(segmentImageToWorldMatrix, mergedImageToWorldMatrix))
+    {
+      resampledBinaryLabelmap = vtkSmartPointer<vtkOrientedImageData>::New();
+      if (!vtkOrientedImageDataResample::ResampleOrientedImageToReferenceGeometry(representationBinaryLabelmap, mergedImageToWorldMatrix, resampledBinaryLabelmap))
+      {
+        vtkErrorMacro("GenerateMergedLabelmap: ResampleOrientedImageToReferenceGeometry failed for segment " << currentSegmentId);
+        success = false;
+        continue;
+      }
+      binaryLabelmap = resampledBinaryLabelmap;
+    }
+
+    vtkNew<vtkOrientedImageData> thresholdedLabelmap;
+    vtkNew<vtkImageThreshold> threshold;
+    threshold->SetInputData(binaryLabelmap);
+    threshold->ThresholdBetween(currentSegment->GetLabelValue(), currentSegment->GetLabelValue());
+    threshold->SetInValue(1);
+    threshold->SetOutValue(0);
+    threshold->Update();
+    thresholdedLabelmap->ShallowCopy(threshold->GetOutput());
+    thresholdedLabelmap->CopyDirections(binaryLabelmap);
+
+    int labelValue = 1 + segmentIndex;
+    if (labelValues)
+    {
+      labelValue = labelValues->GetValue(segmentIndex);
+    }
+
+    // Bricks that the segment does not cover are not allocated
+    if (!mergedImageData->ModifyImage(thresholdedLabelmap, vtkOrientedImageDataResample::OPERATION_MASKING, nullptr, 0, labelValue))
+    {
+      vtkErrorMacro("GenerateMergedLabelmap: Failed to add segment " << currentSegmentId << " to the merged labelmap");
+      success = false;
+    }
+  }
+
+  return success;
+}
+
+//---------------------------------------------------------------------------
+bool vtkSegmentation::SetSegmentLabelmapsFromMergedLabelmap(vtkSparseOrientedImageData* mergedImageData,
+                                                            const std::vector<std::string>& segmentIDs /*=std::vector<std::string>()*/,
+                                                            vtkIntArray* labelValues /*=nullptr*/)
+{
+  if (!mergedImageData)
+  {
+    vtkErrorMacro("SetSegmentLabelmapsFromMergedLabelmap: Invalid image data");
+    return false;
+  }
+
+  if (this->SourceRepresentationName != vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName())
+  {
+    vtkErrorMacro("SetSegmentLabelmapsFromMergedLabelmap: Source representation is not binary labelmap");
+    return false;
+  }
+
+  std::vector<std::string> mergedSegmentIDs;
+  if (segmentIDs.empty())
+  {
+    this->GetSegmentIDs(mergedSegmentIDs);
+  }
+  else
+  {
+    mergedSegmentIDs = segmentIDs;
+  }
+
+  if (labelValues && labelValues->GetNumberOfValues() != static_cast<vtkIdType>(mergedSegmentIDs.size()))
+  {
+    vtkErrorMacro("SetSegmentLabelmapsFromMergedLabelmap: Number of label values does not equal the number of segment IDs");
+    return false;
+  }
+
+  bool success = true;
+  int segmentIndex = 0;
+  for (std::vector<std::string>::iterator segmentIdIt = mergedSegmentIDs.begin(); segmentIdIt != mergedSegmentIDs.end(); ++segmentIdIt, ++segmentIndex)
+  {
+    std::string currentSegmentId = *segmentIdIt;
+    vtkSegment* currentSegment = this->GetSegment(currentSegmentId);
+    if (!currentSegment)
+    {
+      vtkErrorMacro("SetSegmentLabelmapsFromMergedLabelmap: Segment not found by ID: " << currentSegmentId);
+      success = false;
+      continue;
+    }
+
+    int labelValue = 1 + segmentIndex;
+    if (labelValues)
+    {
+      labelValue = labelValues->GetValue(segmentIndex);
+    }
+
+    // Only the bricks that contain the label are thresholded, and the extent of the
+    // segment labelmap is limited to those bricks
+    vtkSmartPointer<vtkOrientedImageData> segmentLabelmap = vtkSmartPointer<vtkOrientedImageData>::New();
+    if (!mergedImageData->ExtractLabel(labelValue, segmentLabelmap))
+    {
+      vtkErrorMacro("SetSegmentLabelmapsFromMergedLabelmap: Failed to extract label " << labelValue << " for segment " << currentSegmentId);
+      success = false;
+      continue;
+    }
+
+    // Derived representations are no longer valid
+    currentSegment->RemoveAllRepresentations(this->SourceRepresentationName);
+    currentSegment->AddRepresentation(vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName(), segmentLabelmap);
+    currentSegment->SetLabelValue(DEFAULT_LABEL_VALUE); // extracted label voxels are set to 1
+    this->InvokeEvent(vtkSegmentation::SourceRepresentationModified, segmentLabelmap);
+    this->InvokeEvent(vtkSegmentation::RepresentationModified, (void*)currentSegmentId.c_str());
+  }
+
+  this->Modified();
+  return success;
+}
+
 //---------------------------------------------------------------------------
 void vtkSegmentation::SeparateSegmentLabelmap(std::string segmentId)
 {
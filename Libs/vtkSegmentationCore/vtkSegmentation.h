@@ -45,6 +45,7 @@ class vtkCollection;
 class vtkIntArray;
 class vtkMinimalStandardRandomSequence;
 class vtkSegmentationConversionPath;
+class vtkSparseOrientedImageData;
 class vtkStringArray;
 
 /// \brief This class encapsulates a segmentation that can contain multiple segments and multiple representations for each segment
@@ -345,6 +346,14 @@ public:
     this->InvalidateNonSourceRepresentations();
   };
 
+  /// Notify conversion rules that a region of a source representation object has been modified,
+  /// so that they can update the other representations incrementally.
+  /// \sa vtkSegmentationConverterRule::SourceRepresentationRegionModified, vtkSegmentationModifier::ModifyBinaryLabelmap
+  void SourceRepresentationRegionModified(vtkDataObject* sourceRepresentation, const int modifiedExtent[6], vtkMTimeType previousMTime)
+  {
+    this->Converter->SourceRepresentationRegionModified(sourceRepresentation, modifiedExtent, previousMTime);
+  };
+
   /// Merged labelmap functions
 
 #ifndef __VTK_WRAP__
@@ -365,6 +374,29 @@ public:
                               vtkOrientedImageData* mergedLabelmapGeometry = nullptr,
                               const std::vector<std::string>& segmentIDs = std::vector<std::string>(),
                               vtkIntArray* labelValues = nullptr);
+
+  /// Create a merged labelmap from the segment IDs in brick-based sparse storage.
+  /// Only bricks that contain any of the segments are allocated, therefore this requires much less
+  /// memory than GenerateMergedLabelmap when segments only occupy a small part of the geometry.
+  /// \param mergedImageData Output sparse labelmap. Voxels are of signed short type, label values are set
+  ///   the same way as in GenerateMergedLabelmap.
+  /// \param mergedLabelmapGeometry Determines geometry of merged labelmap if not nullptr, the common geometry of the segments is used otherwise.
+  /// \param segmentIDs List of IDs of segments to include in the merged labelmap. If empty, then all segments are included
+  /// \param labelValues Input list of label values that will be used in the merged labelmap.
+  bool GenerateMergedLabelmap(vtkSparseOrientedImageData* mergedImageData,
+                              vtkOrientedImageData* mergedLabelmapGeometry = nullptr,
+                              const std::vector<std::string>& segmentIDs = std::vector<std::string>(),
+                              vtkIntArray* labelValues = nullptr);
+
+  /// Set binary labelmap representation of segments from a merged labelmap in brick-based sparse storage.
+  /// Each segment gets a separate labelmap that only contains the bricks where its label value is found.
+  /// \param mergedImageData Input sparse labelmap
+  /// \param segmentIDs List of IDs of segments to set. If empty, then all segments are set.
+  /// \param labelValues Label value of each segment in the merged labelmap.
+  ///   If not specified, then label value of n-th segment is (n + 1), as in GenerateMergedLabelmap.
+  bool SetSegmentLabelmapsFromMergedLabelmap(vtkSparseOrientedImageData* mergedImageData,
+                                             const std::vector<std::string>& segmentIDs = std::vector<std::string>(),
+                                             vtkIntArray* labelValues = nullptr);
 #endif // __VTK_WRAP__
 
   /// Shared labelmap utility functions
@@ -587,3 +587,12 @@ void vtkSegmentationConverter::ApplyTransformOnReferenceImageGeometry(vtkAbstrac
   }
   this->SetConversionParameter(vtkSegmentationConverter::GetReferenceImageGeometryParameterName(), newGeometryString);
 }
+
+//----------------------------------------------------------------------------
+void vtkSegmentationConverter::SourceRepresentationRegionModified(vtkDataObject* sourceRepresentation, const int modifiedExtent[6], vtkMTimeType previousMTime)
+{
+  for (ConverterRulesListType::iterator ruleIt = this->ConverterRules.begin(); ruleIt != this->ConverterRules.end(); ++ruleIt)
+  {
+    (*ruleIt)->SourceRepresentationRegionModified(sourceRepresentation, modifiedExtent, previousMTime);
+  }
+}
@@ -117,6 +117,10 @@ public:
   /// Non-linear: calculate new extents and change only the extents
   void ApplyTransformOnReferenceImageGeometry(vtkAbstractTransform* transform);
 
+  /// Notify all rules that a region of a source representation object has been modified.
+  /// \sa vtkSegmentationConverterRule::SourceRepresentationRegionModified
+  void SourceRepresentationRegionModified(vtkDataObject* sourceRepresentation, const int modifiedExtent[6], vtkMTimeType previousMTime);
+
   // Utility functions
 public:
   /// Return cheapest path from a list of paths with costs
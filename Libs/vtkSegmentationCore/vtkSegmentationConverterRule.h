@@ -92,6 +92,16 @@ public:
   /// This step should be unnecessary if only converting a single segment
   virtual bool PostConvert(vtkSegmentation* vtkNotUsed(segmentation)) { return true; };
 
+  /// Notify the rule that a region of a source representation object has been modified.
+  /// Rules may use this information to update the target representation incrementally
+  /// in the next Convert() call. Default implementation ignores the notification.
+  /// \param sourceRepresentation Modified source representation object
+  /// \param modifiedExtent Modified region (voxel extent for image data)
+  /// \param previousMTime Modified time of the source representation object before the modification
+  virtual void SourceRepresentationRegionModified(vtkDataObject* vtkNotUsed(sourceRepresentation),
+                                                  const int vtkNotUsed(modifiedExtent)[6],
+                                                  vtkMTimeType vtkNotUsed(previousMTime)){};
+
   /// Get the cost of the conversion.
   /// \return Expected duration of the conversion in milliseconds. If the arguments are omitted, then a rough average can be
   ///   given just to indicate the relative computational cost of the algorithm. If the objects are given, then a more educated
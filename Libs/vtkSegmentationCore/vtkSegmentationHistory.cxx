@@ -22,14 +22,166 @@
 #include "vtkSegmentationHistory.h"
 #include "vtkSegmentationConverterFactory.h"
 #include "vtkSegmentation.h"
+#include "vtkOrientedImageData.h"
+#include "vtkOrientedImageDataResample.h"
 
 // VTK includes
+#include <vtkDataArray.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
 #include <vtkCallbackCommand.h>
+#include <vtkPointData.h>
 
 // std includes
 #include <algorithm>
+#include <cstring>
+#include <set>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Get pointer to the first byte of the voxel at (i, j, k)
+unsigned char* GetVoxelPointer(vtkImageData* image, int i, int j, int k)
+{
+  return static_cast<unsigned char*>(image->GetScalarPointer(i, j, k));
+}
+
+//----------------------------------------------------------------------------
+// Get size of a voxel in bytes
+int GetVoxelSize(vtkImageData* image)
+{
+  return image->GetScalarSize() * image->GetNumberOfScalarComponents();
+}
+
+//----------------------------------------------------------------------------
+// Compute the bounding box of voxels that differ between two images of the same extent and scalar type.
+// Returns false if there is no difference.
+bool GetChangedExtent(vtkImageData* image1, vtkImageData* image2, int changedExtent[6])
+{
+  int extent[6] = { 0, -1, 0, -1, 0, -1 };
+  image1->GetExtent(extent);
+  changedExtent[0] = changedExtent[2] = changedExtent[4] = VTK_INT_MAX;
+  changedExtent[1] = changedExtent[3] = changedExtent[5] = VTK_INT_MIN;
+  const int voxelSize = GetVoxelSize(image1);
+  const size_t rowSize = static_cast<size_t>(extent[1] - extent[0] + 1) * voxelSize;
+  bool changed = false;
+  for (int k = extent[4]; k <= extent[5]; ++k)
+  {
+    for (int j = extent[2]; j <= extent[3]; ++j)
+    {
+      unsigned char* row1 = GetVoxelPointer(image1, extent[0], j, k);
+      unsigned char* row2 = GetVoxelPointer(image2, extent[0], j, k);
+      if (memcmp(row1, row2, rowSize) == 0)
+      {
+        continue;
+      }
+      // Only rows that contain changes need to be checked voxel by voxel
+      int firstChangedI = extent[0];
+      while (memcmp(row1 + (firstChangedI - extent[0]) * voxelSize, row2 + (firstChangedI - extent[0]) * voxelSize, voxelSize) == 0)
+      {
+        ++firstChangedI;
+      }
+      int lastChangedI = extent[1];
+      while (memcmp(row1 + (lastChangedI - extent[0]) * voxelSize, row2 + (lastChangedI - extent[0]) * voxelSize, voxelSize) == 0)
+      {
+        --lastChangedI;
+      }
+      changedExtent[0] = std::min(changedExtent[0], firstChangedI);
+      changedExtent[1] = std::max(changedExtent[1], lastChangedI);
+      changedExtent[2] = std::min(changedExtent[2], j);
+      changedExtent[3] = std::max(changedExtent[3], j);
+      changedExtent[4] = std::min(changedExtent[4], k);
+      changedExtent[5] = std::max(changedExtent[5], k);
+      changed = true;
+    }
+  }
+  if (!changed)
+  {
+    changedExtent[0] = changedExtent[2] = changedExtent[4] = 0;
+    changedExtent[1] = changedExtent[3] = changedExtent[5] = -1;
+  }
+  return changed;
+}
+
+//----------------------------------------------------------------------------
+// Store voxels of the image within the extent as a sequence of (run length, voxel value) pairs.
+void RunLengthEncode(vtkImageData* image, const int extent[6], std::vector<unsigned char>& encoded)
+{
+  encoded.clear();
+  const int voxelSize = GetVoxelSize(image);
+  const unsigned char* runValue = nullptr;
+  vtkTypeUInt32 runLength = 0;
+  auto appendRun = [&]()
+  {
+    size_t position = encoded.size();
+    encoded.resize(position + sizeof(vtkTypeUInt32) + voxelSize);
+    memcpy(encoded.data() + position, &runLength, sizeof(vtkTypeUInt32));
+    memcpy(encoded.data() + position + sizeof(vtkTypeUInt32), runValue, voxelSize);
+  };
+  for (int k = extent[4]; k <= extent[5]; ++k)
+  {
+    for (int j = extent[2]; j <= extent[3]; ++j)
+    {
+      const unsigned char* voxel = GetVoxelPointer(image, extent[0], j, k);
+      for (int i = extent[0]; i <= extent[1]; ++i, voxel += voxelSize)
+      {
+        if (runValue && runLength < VTK_TYPE_UINT32_MAX && memcmp(voxel, runValue, voxelSize) == 0)
+        {
+          ++runLength;
+          continue;
+        }
+        if (runValue)
+        {
+          appendRun();
+        }
+        runValue = voxel;
+        runLength = 1;
+      }
+    }
+  }
+  if (runValue)
+  {
+    appendRun();
+  }
+  encoded.shrink_to_fit();
+}
+
+//----------------------------------------------------------------------------
+// Write run-length encoded voxels (created by RunLengthEncode) into the extent of the image.
+void RunLengthDecode(const std::vector<unsigned char>& encoded, const int extent[6], vtkImageData* image)
+{
+  const int voxelSize = GetVoxelSize(image);
+  const size_t runSize = sizeof(vtkTypeUInt32) + voxelSize;
+  size_t position = 0;
+  vtkTypeUInt32 remainingRunLength = 0;
+  const unsigned char* runValue = nullptr;
+  for (int k = extent[4]; k <= extent[5]; ++k)
+  {
+    for (int j = extent[2]; j <= extent[3]; ++j)
+    {
+      unsigned char* voxel = GetVoxelPointer(image, extent[0], j, k);
+      for (int i = extent[0]; i <= extent[1]; ++i, voxel += voxelSize)
+      {
+        if (remainingRunLength == 0)
+        {
+          if (position + runSize > encoded.size())
+          {
+            vtkGenericWarningMacro("vtkSegmentationHistory: run-length encoded labelmap is incomplete");
+            return;
+          }
+          memcpy(&remainingRunLength, encoded.data() + position, sizeof(vtkTypeUInt32));
+          runValue = encoded.data() + position + sizeof(vtkTypeUInt32);
+          position += runSize;
+        }
+        memcpy(voxel, runValue, voxelSize);
+        --remainingRunLength;
+      }
+    }
+  }
+}
+
+} // namespace
 
 //----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkSegmentationHistory);
@@ -40,6 +192,8 @@ vtkSegmentationHistory::vtkSegmentationHistory()
   this->Segmentation = nullptr;
 
   this->MaximumNumberOfStates = 5;
+  this->DeltaCompression = false;
+  this->MaximumMemorySize = 0;
 
   this->LastRestoredState = 0;
   this->RestoreStateInProgress = false;
@@ -98,6 +252,10 @@ void vtkSegmentationHistory::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Modified Time: " << this->GetMTime() << "\n";
 
   os << indent << "Number of saved states:  " << this->SegmentationStates.size() << "\n";
+  os << indent << "MaximumNumberOfStates:  " << this->MaximumNumberOfStates << "\n";
+  os << indent << "DeltaCompression:  " << (this->DeltaCompression ? "true" : "false") << "\n";
+  os << indent << "MaximumMemorySize:  " << this->MaximumMemorySize << "\n";
+  os << indent << "MemorySize:  " << this->GetMemorySize() << "\n";
 }
 
 //---------------------------------------------------------------------------
@@ -141,7 +299,7 @@ bool vtkSegmentationHistory::SaveState()
     // Previous saved state of the segment
     // (if the new state has exactly the same representation then only a shallow copy will be made)
     vtkSegment* baselineSegment = nullptr;
-    if (this->SegmentationStates.size() > 0)
+    if (this->SegmentationStates.size() > 0 && !this->SegmentationStates.back().Decompressed)
     {
       SegmentsMap::iterator baselineSegmentIt = this->SegmentationStates.back().Segments.find(*segmentIDIt);
       if (baselineSegmentIt != this->SegmentationStates.back().Segments.end())
@@ -156,6 +314,12 @@ bool vtkSegmentationHistory::SaveState()
   }
   this->SegmentationStates.push_back(newSegmentationState);
 
+  if (this->DeltaCompression && this->SegmentationStates.size() > 1)
+  {
+    // Only the most recent state is kept in full, the previous state only needs to store the differences
+    this->CompressState((unsigned int)this->SegmentationStates.size() - 2);
+  }
+
   // Set the current state as last restored state.
   // Setting it to SegmentationStates.size() would mean that the state has been modified since
   // the state was saved.
@@ -226,6 +390,24 @@ bool vtkSegmentationHistory::RestoreState(unsigned int stateIndex)
 
   std::set<std::string> segmentIDsToKeep;
   std::map<vtkDataObject*, vtkDataObject*> restoredRepresentations;
+
+  // Delta-compressed labelmaps are reconstructed and used directly as representations
+  // (vtkSegmentation::CopySegment uses the objects in restoredRepresentations without copying)
+  std::set<vtkDataObject*> compressedLabelmaps;
+  this->GetCompressedLabelmaps(stateIndex, compressedLabelmaps);
+  std::vector<vtkSmartPointer<vtkOrientedImageData>> decompressedLabelmaps;
+  for (vtkDataObject* compressedLabelmap : compressedLabelmaps)
+  {
+    vtkSmartPointer<vtkOrientedImageData> decompressedLabelmap = this->GetDecompressedLabelmap(stateIndex, vtkOrientedImageData::SafeDownCast(compressedLabelmap));
+    if (!decompressedLabelmap)
+    {
+      vtkErrorMacro("vtkSegmentation::RestoreState: failed to decompress labelmap");
+      continue;
+    }
+    decompressedLabelmaps.push_back(decompressedLabelmap);
+    restoredRepresentations[compressedLabelmap] = decompressedLabelmap;
+  }
+
   for (SegmentsMap::iterator restoredSegmentsIt = restoredState.Segments.begin(); restoredSegmentsIt != restoredState.Segments.end(); ++restoredSegmentsIt)
   {
     vtkSegment* segmentToRestore = restoredSegmentsIt->second;
@@ -306,6 +488,11 @@ bool vtkSegmentationHistory::IsRestoreNextStateAvailable()
 //---------------------------------------------------------------------------
 void vtkSegmentationHistory::RemoveAllNextStates()
 {
+  if (this->SegmentationStates.size() > this->LastRestoredState + 1)
+  {
+    // The last restored state becomes the most recent state, which must be stored in full
+    this->DecompressState(this->LastRestoredState);
+  }
   bool modified = false;
   while ((this->SegmentationStates.size() > this->LastRestoredState + 1) && (!this->SegmentationStates.empty()))
   {
@@ -322,8 +509,15 @@ void vtkSegmentationHistory::RemoveAllNextStates()
 void vtkSegmentationHistory::RemoveAllObsoleteStates()
 {
   bool modified = false;
-  while ((this->SegmentationStates.size() > this->MaximumNumberOfStates) && (!this->SegmentationStates.empty()))
+  while (!this->SegmentationStates.empty())
   {
+    bool tooManyStates = (this->SegmentationStates.size() > this->MaximumNumberOfStates);
+    bool tooLargeStates = (this->MaximumMemorySize > 0 && this->SegmentationStates.size() > 1 && this->LastRestoredState > 0 //
+                           && this->GetMemorySize() > this->MaximumMemorySize);
+    if (!tooManyStates && !tooLargeStates)
+    {
+      break;
+    }
     this->SegmentationStates.pop_front();
     this->LastRestoredState--;
     modified = true;
@@ -346,6 +540,245 @@ void vtkSegmentationHistory::SetMaximumNumberOfStates(unsigned int maximumNumber
   this->Modified();
 }
 
+//---------------------------------------------------------------------------
+void vtkSegmentationHistory::SetDeltaCompression(bool deltaCompression)
+{
+  if (deltaCompression == this->DeltaCompression)
+  {
+    return;
+  }
+  // Stored states are not converted, start a new history instead
+  this->RemoveAllStates();
+  this->DeltaCompression = deltaCompression;
+  this->Modified();
+}
+
+//---------------------------------------------------------------------------
+void vtkSegmentationHistory::SetMaximumMemorySize(vtkTypeInt64 maximumMemorySizeBytes)
+{
+  if (maximumMemorySizeBytes == this->MaximumMemorySize)
+  {
+    return;
+  }
+  this->MaximumMemorySize = maximumMemorySizeBytes;
+  this->RemoveAllObsoleteStates();
+  this->Modified();
+}
+
+//---------------------------------------------------------------------------
+vtkTypeInt64 vtkSegmentationHistory::GetMemorySize()
+{
+  vtkTypeInt64 memorySize = 0;
+  std::set<vtkDataObject*> countedDataObjects;
+  for (SegmentationState& state : this->SegmentationStates)
+  {
+    for (auto& labelmapDeltaIt : state.LabelmapDeltas)
+    {
+      memorySize += static_cast<vtkTypeInt64>(labelmapDeltaIt.second.RunLengthEncodedVoxels.capacity());
+    }
+    for (SegmentsMap::iterator segmentIt = state.Segments.begin(); segmentIt != state.Segments.end(); ++segmentIt)
+    {
+      std::vector<std::string> representationNames;
+      segmentIt->second->GetContainedRepresentationNames(representationNames);
+      for (const std::string& representationName : representationNames)
+      {
+        vtkDataObject* representation = segmentIt->second->GetRepresentation(representationName);
+        if (!representation || !countedDataObjects.insert(representation).second)
+        {
+          continue;
+        }
+        // GetActualMemorySize returns size in kibibytes
+        memorySize += static_cast<vtkTypeInt64>(representation->GetActualMemorySize()) * 1024;
+      }
+    }
+  }
+  return memorySize;
+}
+
+//---------------------------------------------------------------------------
+void vtkSegmentationHistory::CompressState(unsigned int stateIndex)
+{
+  if (stateIndex + 1 >= this->SegmentationStates.size())
+  {
+    vtkErrorMacro("vtkSegmentation::CompressState failed: the most recent state cannot be compressed");
+    return;
+  }
+  SegmentationState& state = this->SegmentationStates[stateIndex];
+  SegmentationState& nextState = this->SegmentationStates[stateIndex + 1];
+
+  // Representations that are shared with the next state are unchanged, they must be kept as is
+  std::set<vtkDataObject*> nextStateDataObjects;
+  for (SegmentsMap::iterator segmentIt = nextState.Segments.begin(); segmentIt != nextState.Segments.end(); ++segmentIt)
+  {
+    std::vector<std::string> representationNames;
+    segmentIt->second->GetContainedRepresentationNames(representationNames);
+    for (const std::string& representationName : representationNames)
+    {
+      nextStateDataObjects.insert(segmentIt->second->GetRepresentation(representationName));
+    }
+  }
+
+  for (SegmentsMap::iterator segmentIt = state.Segments.begin(); segmentIt != state.Segments.end(); ++segmentIt)
+  {
+    SegmentsMap::iterator nextSegmentIt = nextState.Segments.find(segmentIt->first);
+    if (nextSegmentIt == nextState.Segments.end())
+    {
+      // segment is removed in the next state, no reference to compute the difference from
+      continue;
+    }
+    std::vector<std::string> representationNames;
+    segmentIt->second->GetContainedRepresentationNames(representationNames);
+    for (const std::string& representationName : representationNames)
+    {
+      vtkOrientedImageData* labelmap = vtkOrientedImageData::SafeDownCast(segmentIt->second->GetRepresentation(representationName));
+      if (!labelmap || !labelmap->GetPointData()->GetScalars() //
+          || nextStateDataObjects.find(labelmap) != nextStateDataObjects.end() //
+          || state.LabelmapDeltas.find(labelmap) != state.LabelmapDeltas.end())
+      {
+        // not a labelmap, shared with the next state, or already compressed (shared labelmap)
+        continue;
+      }
+      vtkOrientedImageData* nextLabelmap = vtkOrientedImageData::SafeDownCast(nextSegmentIt->second->GetRepresentation(representationName));
+      if (!nextLabelmap || !nextLabelmap->GetPointData()->GetScalars()                          //
+          || !vtkOrientedImageDataResample::DoGeometriesMatch(labelmap, nextLabelmap)           //
+          || !vtkOrientedImageDataResample::DoExtentsMatch(labelmap, nextLabelmap)              //
+          || labelmap->GetScalarType() != nextLabelmap->GetScalarType()                        //
+          || labelmap->GetNumberOfScalarComponents() != nextLabelmap->GetNumberOfScalarComponents())
+      {
+        // Labelmap geometry has changed, store the full labelmap
+        continue;
+      }
+
+      LabelmapDelta& labelmapDelta = state.LabelmapDeltas[labelmap];
+      labelmapDelta.NextLabelmap = nextLabelmap;
+      if (GetChangedExtent(labelmap, nextLabelmap, labelmapDelta.Extent))
+      {
+        RunLengthEncode(labelmap, labelmapDelta.Extent, labelmapDelta.RunLengthEncodedVoxels);
+      }
+
+      // Release voxels, they can be reconstructed from the next labelmap and the delta
+      labelmap->GetPointData()->Initialize();
+    }
+  }
+  this->Modified();
+}
+
+//---------------------------------------------------------------------------
+vtkSmartPointer<vtkOrientedImageData> vtkSegmentationHistory::GetDecompressedLabelmap(unsigned int stateIndex, vtkOrientedImageData* labelmap)
+{
+  if (!labelmap)
+  {
+    return nullptr;
+  }
+
+  // Collect all the deltas between this labelmap and the first full labelmap.
+  // A labelmap's delta is stored in the most recent state that contains the labelmap,
+  // and the next labelmap is always in a more recent state.
+  std::vector<const LabelmapDelta*> labelmapDeltas;
+  vtkOrientedImageData* fullLabelmap = labelmap;
+  for (unsigned int index = stateIndex; index < this->SegmentationStates.size(); ++index)
+  {
+    std::map<vtkDataObject*, LabelmapDelta>::const_iterator labelmapDeltaIt = this->SegmentationStates[index].LabelmapDeltas.find(fullLabelmap);
+    if (labelmapDeltaIt != this->SegmentationStates[index].LabelmapDeltas.end())
+    {
+      labelmapDeltas.push_back(&labelmapDeltaIt->second);
+      fullLabelmap = labelmapDeltaIt->second.NextLabelmap;
+    }
+  }
+  if (!fullLabelmap->GetPointData()->GetScalars())
+  {
+    vtkErrorMacro("vtkSegmentation::GetDecompressedLabelmap failed: no full labelmap is found");
+    return nullptr;
+  }
+
+  vtkSmartPointer<vtkOrientedImageData> decompressedLabelmap = vtkSmartPointer<vtkOrientedImageData>::New();
+  decompressedLabelmap->DeepCopy(fullLabelmap);
+  for (std::vector<const LabelmapDelta*>::reverse_iterator labelmapDeltaIt = labelmapDeltas.rbegin(); labelmapDeltaIt != labelmapDeltas.rend(); ++labelmapDeltaIt)
+  {
+    if ((*labelmapDeltaIt)->RunLengthEncodedVoxels.empty())
+    {
+      // no change compared to the next labelmap
+      continue;
+    }
+    RunLengthDecode((*labelmapDeltaIt)->RunLengthEncodedVoxels, (*labelmapDeltaIt)->Extent, decompressedLabelmap);
+  }
+  return decompressedLabelmap;
+}
+
+//---------------------------------------------------------------------------
+void vtkSegmentationHistory::DecompressState(unsigned int stateIndex)
+{
+  if (stateIndex >= this->SegmentationStates.size())
+  {
+    return;
+  }
+  std::set<vtkDataObject*> compressedLabelmaps;
+  this->GetCompressedLabelmaps(stateIndex, compressedLabelmaps);
+  if (compressedLabelmaps.empty())
+  {
+    return;
+  }
+
+  // Reconstruct all labelmaps before any of them is modified, as labelmaps are reconstructed
+  // using the deltas of the more recent states.
+  std::map<vtkDataObject*, vtkSmartPointer<vtkOrientedImageData>> decompressedLabelmaps;
+  for (vtkDataObject* compressedLabelmap : compressedLabelmaps)
+  {
+    vtkSmartPointer<vtkOrientedImageData> decompressedLabelmap = this->GetDecompressedLabelmap(stateIndex, vtkOrientedImageData::SafeDownCast(compressedLabelmap));
+    if (decompressedLabelmap)
+    {
+      decompressedLabelmaps[compressedLabelmap] = decompressedLabelmap;
+    }
+  }
+  for (auto& decompressedLabelmapIt : decompressedLabelmaps)
+  {
+    // Copy into the existing object, as it is referenced by segments and by deltas of previous states
+    decompressedLabelmapIt.first->DeepCopy(decompressedLabelmapIt.second);
+    for (unsigned int index = stateIndex; index < this->SegmentationStates.size(); ++index)
+    {
+      this->SegmentationStates[index].LabelmapDeltas.erase(decompressedLabelmapIt.first);
+    }
+  }
+  this->SegmentationStates[stateIndex].Decompressed = true;
+}
+
+//---------------------------------------------------------------------------
+void vtkSegmentationHistory::GetCompressedLabelmaps(unsigned int stateIndex, std::set<vtkDataObject*>& compressedLabelmaps)
+{
+  compressedLabelmaps.clear();
+  if (stateIndex >= this->SegmentationStates.size())
+  {
+    return;
+  }
+  SegmentationState& state = this->SegmentationStates[stateIndex];
+  for (auto& labelmapDeltaIt : state.LabelmapDeltas)
+  {
+    compressedLabelmaps.insert(labelmapDeltaIt.first);
+  }
+  for (SegmentsMap::iterator segmentIt = state.Segments.begin(); segmentIt != state.Segments.end(); ++segmentIt)
+  {
+    std::vector<std::string> representationNames;
+    segmentIt->second->GetContainedRepresentationNames(representationNames);
+    for (const std::string& representationName : representationNames)
+    {
+      vtkOrientedImageData* labelmap = vtkOrientedImageData::SafeDownCast(segmentIt->second->GetRepresentation(representationName));
+      if (!labelmap || labelmap->GetPointData()->GetScalars() || compressedLabelmaps.find(labelmap) != compressedLabelmaps.end())
+      {
+        // not a labelmap, voxels are stored in full, or already found
+        continue;
+      }
+      for (unsigned int index = stateIndex + 1; index < this->SegmentationStates.size(); ++index)
+      {
+        if (this->SegmentationStates[index].LabelmapDeltas.find(labelmap) != this->SegmentationStates[index].LabelmapDeltas.end())
+        {
+          compressedLabelmaps.insert(labelmap);
+          break;
+        }
+      }
+    }
+  }
+}
+
 //---------------------------------------------------------------------------
 void vtkSegmentationHistory::OnSegmentationModified(vtkObject* vtkNotUsed(caller), unsigned long vtkNotUsed(eid), void* clientData, void* vtkNotUsed(callData))
 {
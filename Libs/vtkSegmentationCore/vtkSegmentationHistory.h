@@ -28,12 +28,14 @@
 // STD includes
 #include <deque>
 #include <map>
+#include <set>
 #include <vector>
 
 #include "vtkSegmentationCoreConfigure.h"
 
 class vtkCallbackCommand;
 class vtkDataObject;
+class vtkOrientedImageData;
 class vtkSegment;
 class vtkSegmentation;
 
@@ -85,6 +87,26 @@ public:
   /// Get the current number of states.
   int GetNumberOfStates();
 
+  /// If enabled then only the most recent state stores complete binary labelmaps.
+  /// Older states only store the changed region of each labelmap (run-length encoded)
+  /// relative to the state that follows it, which greatly reduces memory usage
+  /// for large labelmaps when each editing step only modifies a small region.
+  /// Disabled by default. Changing the value removes all stored states.
+  void SetDeltaCompression(bool deltaCompression);
+  vtkGetMacro(DeltaCompression, bool);
+  vtkBooleanMacro(DeltaCompression, bool);
+
+  /// Limits the total memory size (in bytes) used by the stored states.
+  /// If the limit is exceeded then the oldest states are removed (at least one state is always kept).
+  /// The limit is applied in addition to MaximumNumberOfStates.
+  /// 0 means no limit (default).
+  void SetMaximumMemorySize(vtkTypeInt64 maximumMemorySizeBytes);
+  vtkGetMacro(MaximumMemorySize, vtkTypeInt64);
+
+  /// Get the estimated memory size (in bytes) of all stored states.
+  /// Data objects that are shared between states are only counted once.
+  vtkTypeInt64 GetMemorySize();
+
 protected:
   /// Callback function called when the segmentation has been modified.
   /// It clears all states that are more recent than the last restored state.
@@ -99,22 +121,56 @@ protected:
   /// Restores a state defined by stateIndex.
   bool RestoreState(unsigned int stateIndex);
 
+  /// Replace binary labelmaps of the state defined by stateIndex by differences
+  /// relative to the next state. Only used if DeltaCompression is enabled.
+  void CompressState(unsigned int stateIndex);
+
+  /// Get full content of a labelmap stored in the state defined by stateIndex.
+  /// If the labelmap is delta-compressed then it is reconstructed from the following states.
+  vtkSmartPointer<vtkOrientedImageData> GetDecompressedLabelmap(unsigned int stateIndex, vtkOrientedImageData* labelmap);
+
+  /// Restore full content of all delta-compressed labelmaps of the state defined by stateIndex.
+  void DecompressState(unsigned int stateIndex);
+
+  /// Get labelmaps of the state defined by stateIndex that are delta-compressed.
+  /// A labelmap that is shared between consecutive states is compressed in the most recent state
+  /// that contains it, therefore deltas of the more recent states are searched as well.
+  void GetCompressedLabelmaps(unsigned int stateIndex, std::set<vtkDataObject*>& compressedLabelmaps);
+
 protected:
   vtkSegmentationHistory();
   ~vtkSegmentationHistory() override;
 
   typedef std::map<std::string, vtkSmartPointer<vtkSegment>> SegmentsMap;
 
+  /// Changed region of a labelmap relative to the labelmap that replaced it in the next state.
+  struct LabelmapDelta
+  {
+    // Labelmap in a more recent state that this labelmap can be reconstructed from
+    vtkSmartPointer<vtkOrientedImageData> NextLabelmap;
+    // Extent of the changed region (empty if there is no change)
+    int Extent[6];
+    // Run-length encoded voxels of the changed region
+    std::vector<unsigned char> RunLengthEncodedVoxels;
+  };
+
   struct SegmentationState
   {
     SegmentsMap Segments;
     std::vector<std::string> SegmentIds; // order of segments
+    // Delta-compressed labelmaps (voxels of these images are released)
+    std::map<vtkDataObject*, LabelmapDelta> LabelmapDeltas;
+    // True if the representations were decompressed after the state was saved.
+    // Such representations are newer than the segmentation content, therefore they must not be used as baseline.
+    bool Decompressed{ false };
   };
 
   vtkSegmentation* Segmentation;
   vtkCallbackCommand* SegmentationModifiedCallbackCommand;
   std::deque<SegmentationState> SegmentationStates;
   unsigned int MaximumNumberOfStates;
+  bool DeltaCompression;
+  vtkTypeInt64 MaximumMemorySize;
 
   // Index of the state in SegmentationStates that was restored last.
   // If LastRestoredState == size of states then it means that the segmentation has changed
@@ -30,6 +30,7 @@
 #include <vtkImageThreshold.h>
 #include <vtkObjectFactory.h>
 #include <vtkPointData.h>
+#include <vtkTransform.h>
 
 // STD includes
 #include <algorithm>
@@ -93,6 +94,11 @@ bool vtkSegmentationModifier::ModifyBinaryLabelmap(vtkOrientedImageData* labelma
 
   bool wasSourceRepresentationModifiedEnabled = segmentation->SetSourceRepresentationModifiedEnabled(sourceRepresentationModifiedEnabled);
 
+  // Store the state of the labelmap before the modification to be able to report the modified region
+  vtkMTimeType segmentLabelmapMTimeBefore = segmentLabelmap->GetMTime();
+  int segmentLabelmapExtentBefore[6] = { 0, -1, 0, -1, 0, -1 };
+  segmentLabelmap->GetExtent(segmentLabelmapExtentBefore);
+
   bool segmentLabelmapModified = true;
   if (!vtkSegmentationModifier::AppendLabelmapToSegment(labelmap, segmentation, segmentID, mergeMode, extent, minimumOfAllSegments, modifiedSegmentIDs, segmentLabelmapModified))
   {
@@ -103,6 +109,14 @@ bool vtkSegmentationModifier::ModifyBinaryLabelmap(vtkOrientedImageData* labelma
   // Shrink the image data extent to only contain the effective data (extent of non-zero voxels)
   vtkSegmentationModifier::ShrinkSegmentToEffectiveExtent(segmentLabelmap);
 
+  // Report the modified region to allow incremental update of other representations
+  if (segmentLabelmap->GetMTime() != segmentLabelmapMTimeBefore)
+  {
+    int modifiedExtent[6] = { 0, -1, 0, -1, 0, -1 };
+    vtkSegmentationModifier::GetModifiedExtent(labelmap, segmentLabelmap, mergeMode, extent, segmentLabelmapExtentBefore, modifiedExtent);
+    segmentation->SourceRepresentationRegionModified(segmentLabelmap, modifiedExtent, segmentLabelmapMTimeBefore);
+  }
+
   // Re-enable source representation modified event
   segmentation->SetSourceRepresentationModifiedEnabled(wasSourceRepresentationModifiedEnabled);
   if (segmentLabelmapModified)
@@ -249,6 +263,59 @@ void vtkSegmentationModifier::GetExtentIntersection(const int extentA[6], const
   }
 }
 
+//-----------------------------------------------------------------------------
+void vtkSegmentationModifier::GetModifiedExtent(vtkOrientedImageData* modifierLabelmap,
+                                                vtkOrientedImageData* segmentLabelmap,
+                                                int mergeMode,
+                                                const int extent[6],
+                                                const int segmentLabelmapExtentBefore[6],
+                                                int modifiedExtent[6])
+{
+  for (int axis = 0; axis < 3; axis++)
+  {
+    modifiedExtent[axis * 2] = 0;
+    modifiedExtent[axis * 2 + 1] = -1;
+  }
+
+  // Region of the modifier labelmap that was used, transformed to the segment labelmap
+  int modifierExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  if (vtkSegmentationModifier::IsExtentValid(modifierLabelmap->GetExtent()))
+  {
+    vtkSegmentationModifier::GetExtentIntersection(modifierLabelmap->GetExtent(), extent, modifierExtent);
+  }
+  if (vtkSegmentationModifier::IsExtentValid(modifierExtent))
+  {
+    vtkNew<vtkTransform> modifierToSegmentLabelmapTransform;
+    vtkOrientedImageDataResample::GetTransformBetweenOrientedImages(modifierLabelmap, segmentLabelmap, modifierToSegmentLabelmapTransform);
+    vtkOrientedImageDataResample::TransformExtent(modifierExtent, modifierToSegmentLabelmapTransform, modifiedExtent);
+    // Add a margin to account for rounding when the image lattices are not aligned
+    for (int axis = 0; axis < 3; axis++)
+    {
+      modifiedExtent[axis * 2] -= 1;
+      modifiedExtent[axis * 2 + 1] += 1;
+    }
+  }
+
+  // In replace mode the previous content of the segment may have been removed anywhere
+  int extentBefore[6] = { 0, -1, 0, -1, 0, -1 };
+  std::copy(segmentLabelmapExtentBefore, segmentLabelmapExtentBefore + 6, extentBefore);
+  if (mergeMode == MODE_REPLACE && vtkSegmentationModifier::IsExtentValid(extentBefore))
+  {
+    if (!vtkSegmentationModifier::IsExtentValid(modifiedExtent))
+    {
+      std::copy(extentBefore, extentBefore + 6, modifiedExtent);
+    }
+    else
+    {
+      for (int axis = 0; axis < 3; axis++)
+      {
+        modifiedExtent[axis * 2] = std::min(modifiedExtent[axis * 2], extentBefore[axis * 2]);
+        modifiedExtent[axis * 2 + 1] = std::max(modifiedExtent[axis * 2 + 1], extentBefore[axis * 2 + 1]);
+      }
+    }
+  }
+}
+
 //-----------------------------------------------------------------------------
 bool vtkSegmentationModifier::IsExtentValid(int extent[6])
 {
@@ -90,6 +90,20 @@ protected:
 
   static void ShrinkSegmentToEffectiveExtent(vtkOrientedImageData* segmentLabelmap);
 
+  /// Get the region of the segment labelmap that may have been modified by ModifyBinaryLabelmap.
+  /// \param modifierLabelmap Labelmap that was used for modifying the segment
+  /// \param segmentLabelmap Modified labelmap of the segment
+  /// \param mergeMode Merge mode that was used for modifying the segment
+  /// \param extent Extent of the modifier labelmap that was used (nullptr means the whole modifier labelmap)
+  /// \param segmentLabelmapExtentBefore Extent of the segment labelmap before the modification
+  /// \param modifiedExtent Output extent, in the IJK coordinate system of the segment labelmap
+  static void GetModifiedExtent(vtkOrientedImageData* modifierLabelmap,
+                                vtkOrientedImageData* segmentLabelmap,
+                                int mergeMode,
+                                const int extent[6],
+                                const int segmentLabelmapExtentBefore[6],
+                                int modifiedExtent[6]);
+
   static bool SharedLabelmapShouldOverlap(vtkSegmentation* segmentation, std::string segmentID, std::vector<std::string>& segmentIDsToOverwrite);
 
   static void SeparateModifiedSegmentFromSharedLabelmap(vtkOrientedImageData* labelmap,
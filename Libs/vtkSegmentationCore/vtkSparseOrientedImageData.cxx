@@ -0,0 +1,611 @@
+/*==============================================================================
+
+  Copyright (c) Laboratory for Percutaneous Surgery (PerkLab)
+  Queen's University, Kingston, ON, Canada. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// SegmentationCore includes
+#include "vtkSparseOrientedImageData.h"
+#include "vtkOrientedImageDataResample.h"
+
+// VTK includes
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+
+// STD includes
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+vtkStandardNewMacro(vtkSparseOrientedImageData);
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+int FloorDivide(int value, int divisor)
+{
+  return (value >= 0) ? (value / divisor) : -((-value + divisor - 1) / divisor);
+}
+
+//----------------------------------------------------------------------------
+bool IsExtentValid(const int extent[6])
+{
+  return extent[0] <= extent[1] && extent[2] <= extent[3] && extent[4] <= extent[5];
+}
+
+//----------------------------------------------------------------------------
+bool GetExtentIntersection(const int extentA[6], const int extentB[6], int extentIntersection[6])
+{
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    extentIntersection[axis * 2] = std::max(extentA[axis * 2], extentB[axis * 2]);
+    extentIntersection[axis * 2 + 1] = std::min(extentA[axis * 2 + 1], extentB[axis * 2 + 1]);
+  }
+  return IsExtentValid(extentIntersection);
+}
+
+//----------------------------------------------------------------------------
+void AddExtentToExtent(const int extentToAdd[6], int extent[6])
+{
+  if (!IsExtentValid(extent))
+  {
+    std::copy(extentToAdd, extentToAdd + 6, extent);
+    return;
+  }
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    extent[axis * 2] = std::min(extent[axis * 2], extentToAdd[axis * 2]);
+    extent[axis * 2 + 1] = std::max(extent[axis * 2 + 1], extentToAdd[axis * 2 + 1]);
+  }
+}
+
+//----------------------------------------------------------------------------
+/// Copy voxels in the specified extent between images of the same scalar type
+void CopyRegion(vtkImageData* sourceImage, vtkImageData* targetImage, const int extent[6])
+{
+  size_t rowSize = static_cast<size_t>(extent[1] - extent[0] + 1) * sourceImage->GetScalarSize();
+  for (int k = extent[4]; k <= extent[5]; ++k)
+  {
+    for (int j = extent[2]; j <= extent[3]; ++j)
+    {
+      memcpy(targetImage->GetScalarPointer(extent[0], j, k), sourceImage->GetScalarPointer(extent[0], j, k), rowSize);
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+template <class ImageScalarType>
+void IsRegionAboveThresholdGeneric(vtkImageData* image, const int extent[6], double threshold, bool& aboveThreshold)
+{
+  aboveThreshold = false;
+  int rowLength = extent[1] - extent[0] + 1;
+  for (int k = extent[4]; k <= extent[5]; ++k)
+  {
+    for (int j = extent[2]; j <= extent[3]; ++j)
+    {
+      ImageScalarType* imagePtr = static_cast<ImageScalarType*>(image->GetScalarPointer(extent[0], j, k));
+      for (int i = 0; i < rowLength; ++i)
+      {
+        if (imagePtr[i] > threshold)
+        {
+          aboveThreshold = true;
+          return;
+        }
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+/// Returns true if any voxel in the extent of the image is above the threshold
+bool IsRegionAboveThreshold(vtkImageData* image, const int extent[6], double threshold)
+{
+  bool aboveThreshold = false;
+  switch (image->GetScalarType())
+  {
+    vtkTemplateMacro(IsRegionAboveThresholdGeneric<VTK_TT>(image, extent, threshold, aboveThreshold));
+    default: vtkGenericWarningMacro("vtkSparseOrientedImageData::IsRegionAboveThreshold: Unknown image scalar type"); return true;
+  }
+  return aboveThreshold;
+}
+
+//----------------------------------------------------------------------------
+template <class ImageScalarType>
+void ExtractLabelGeneric(vtkImageData* image, int labelValue, vtkImageData* outputImage, bool& labelFound)
+{
+  labelFound = false;
+  int* extent = image->GetExtent();
+  ImageScalarType* imagePtr = static_cast<ImageScalarType*>(image->GetScalarPointer());
+  int rowLength = extent[1] - extent[0] + 1;
+  for (int k = extent[4]; k <= extent[5]; ++k)
+  {
+    for (int j = extent[2]; j <= extent[3]; ++j)
+    {
+      unsigned char* outputPtr = outputImage ? static_cast<unsigned char*>(outputImage->GetScalarPointer(extent[0], j, k)) : nullptr;
+      for (int i = 0; i < rowLength; ++i, ++imagePtr)
+      {
+        if (*imagePtr != labelValue)
+        {
+          continue;
+        }
+        labelFound = true;
+        if (!outputPtr)
+        {
+          // Only checking if the label is present
+          return;
+        }
+        outputPtr[i] = 1;
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+/// Set voxels of the label in outputImage to 1. If outputImage is nullptr then only checks if the label is present.
+bool ExtractLabel(vtkImageData* image, int labelValue, vtkImageData* outputImage)
+{
+  bool labelFound = false;
+  switch (image->GetScalarType())
+  {
+    vtkTemplateMacro(ExtractLabelGeneric<VTK_TT>(image, labelValue, outputImage, labelFound));
+    default: vtkGenericWarningMacro("vtkSparseOrientedImageData::ExtractLabel: Unknown image scalar type"); return false;
+  }
+  return labelFound;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+vtkSparseOrientedImageData::vtkSparseOrientedImageData()
+  : ScalarType(VTK_UNSIGNED_CHAR)
+{
+}
+
+//----------------------------------------------------------------------------
+vtkSparseOrientedImageData::~vtkSparseOrientedImageData() = default;
+
+//----------------------------------------------------------------------------
+void vtkSparseOrientedImageData::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "BrickSize: " << this->BrickSize << "\n";
+  os << indent << "ScalarType: " << vtkImageScalarTypeNameMacro(this->ScalarType) << "\n";
+  os << indent << "NumberOfBricks: " << this->Bricks.size() << "\n";
+  os << indent << "ImageToWorldMatrix:\n";
+  this->ImageToWorldMatrix->PrintSelf(os, indent.GetNextIndent());
+}
+
+//----------------------------------------------------------------------------
+void vtkSparseOrientedImageData::Initialize()
+{
+  this->Superclass::Initialize();
+  this->Bricks.clear();
+}
+
+//----------------------------------------------------------------------------
+void vtkSparseOrientedImageData::ShallowCopy(vtkDataObject* src)
+{
+  this->Superclass::ShallowCopy(src);
+  vtkSparseOrientedImageData* sourceImage = vtkSparseOrientedImageData::SafeDownCast(src);
+  if (!sourceImage)
+  {
+    return;
+  }
+  this->BrickSize = sourceImage->BrickSize;
+  this->ScalarType = sourceImage->ScalarType;
+  this->ImageToWorldMatrix->DeepCopy(sourceImage->ImageToWorldMatrix);
+  this->Bricks = sourceImage->Bricks;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkSparseOrientedImageData::DeepCopy(vtkDataObject* src)
+{
+  this->Superclass::DeepCopy(src);
+  vtkSparseOrientedImageData* sourceImage = vtkSparseOrientedImageData::SafeDownCast(src);
+  if (!sourceImage)
+  {
+    return;
+  }
+  this->BrickSize = sourceImage->BrickSize;
+  this->ScalarType = sourceImage->ScalarType;
+  this->ImageToWorldMatrix->DeepCopy(sourceImage->ImageToWorldMatrix);
+  this->Bricks.clear();
+  for (const auto& brick : sourceImage->Bricks)
+  {
+    vtkSmartPointer<vtkOrientedImageData> brickCopy = vtkSmartPointer<vtkOrientedImageData>::New();
+    brickCopy->DeepCopy(brick.second);
+    this->Bricks[brick.first] = brickCopy;
+  }
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+unsigned long vtkSparseOrientedImageData::GetActualMemorySize()
+{
+  unsigned long size = this->Superclass::GetActualMemorySize();
+  for (const auto& brick : this->Bricks)
+  {
+    size += brick.second->GetActualMemorySize();
+  }
+  return size;
+}
+
+//----------------------------------------------------------------------------
+void vtkSparseOrientedImageData::SetBrickSize(int brickSize)
+{
+  if (brickSize == this->BrickSize)
+  {
+    return;
+  }
+  if (brickSize < 1)
+  {
+    vtkErrorMacro("SetBrickSize: Invalid brick size " << brickSize);
+    return;
+  }
+  if (!this->Bricks.empty())
+  {
+    vtkErrorMacro("SetBrickSize: Brick size cannot be changed while bricks are allocated");
+    return;
+  }
+  this->BrickSize = brickSize;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkSparseOrientedImageData::SetScalarType(int scalarType)
+{
+  if (scalarType == this->ScalarType)
+  {
+    return;
+  }
+  if (!this->Bricks.empty())
+  {
+    vtkErrorMacro("SetScalarType: Scalar type cannot be changed while bricks are allocated");
+    return;
+  }
+  this->ScalarType = scalarType;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkSparseOrientedImageData::SetImageToWorldMatrix(vtkMatrix4x4* imageToWorldMatrix)
+{
+  if (!imageToWorldMatrix)
+  {
+    return;
+  }
+  if (!this->Bricks.empty())
+  {
+    vtkErrorMacro("SetImageToWorldMatrix: Geometry cannot be changed while bricks are allocated");
+    return;
+  }
+  this->ImageToWorldMatrix->DeepCopy(imageToWorldMatrix);
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkSparseOrientedImageData::GetImageToWorldMatrix(vtkMatrix4x4* imageToWorldMatrix)
+{
+  if (!imageToWorldMatrix)
+  {
+    return;
+  }
+  imageToWorldMatrix->DeepCopy(this->ImageToWorldMatrix);
+}
+
+//----------------------------------------------------------------------------
+vtkSparseOrientedImageData::BrickIndexType vtkSparseOrientedImageData::GetBrickIndex(int i, int j, int k)
+{
+  return { FloorDivide(i, this->BrickSize), FloorDivide(j, this->BrickSize), FloorDivide(k, this->BrickSize) };
+}
+
+//----------------------------------------------------------------------------
+void vtkSparseOrientedImageData::GetBrickExtent(const BrickIndexType& brickIndex, int brickExtent[6])
+{
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    brickExtent[axis * 2] = brickIndex[axis] * this->BrickSize;
+    brickExtent[axis * 2 + 1] = (brickIndex[axis] + 1) * this->BrickSize - 1;
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkSparseOrientedImageData::GetBrickExtent(int i, int j, int k, int brickExtent[6])
+{
+  this->GetBrickExtent(this->GetBrickIndex(i, j, k), brickExtent);
+}
+
+//----------------------------------------------------------------------------
+vtkOrientedImageData* vtkSparseOrientedImageData::GetBrick(int i, int j, int k)
+{
+  auto brickIt = this->Bricks.find(this->GetBrickIndex(i, j, k));
+  if (brickIt == this->Bricks.end())
+  {
+    return nullptr;
+  }
+  return brickIt->second;
+}
+
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkOrientedImageData> vtkSparseOrientedImageData::CreateBrick(const BrickIndexType& brickIndex)
+{
+  int brickExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  this->GetBrickExtent(brickIndex, brickExtent);
+  vtkSmartPointer<vtkOrientedImageData> brick = vtkSmartPointer<vtkOrientedImageData>::New();
+  brick->SetImageToWorldMatrix(this->ImageToWorldMatrix);
+  brick->SetExtent(brickExtent);
+  brick->AllocateScalars(this->ScalarType, 1);
+  memset(brick->GetScalarPointer(), 0, brick->GetNumberOfPoints() * brick->GetScalarSize());
+  return brick;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSparseOrientedImageData::SetImage(vtkOrientedImageData* image)
+{
+  if (!image)
+  {
+    vtkErrorMacro("SetImage: Invalid image");
+    return false;
+  }
+  if (image->GetPointData()->GetScalars() && image->GetNumberOfScalarComponents() != 1)
+  {
+    vtkErrorMacro("SetImage: Only single-component images are supported");
+    return false;
+  }
+
+  this->Bricks.clear();
+  this->ScalarType = image->GetScalarType();
+  image->GetImageToWorldMatrix(this->ImageToWorldMatrix);
+
+  int* imageExtent = image->GetExtent();
+  if (!image->GetPointData()->GetScalars() || !IsExtentValid(imageExtent))
+  {
+    this->Modified();
+    return true;
+  }
+
+  BrickIndexType firstBrickIndex = this->GetBrickIndex(imageExtent[0], imageExtent[2], imageExtent[4]);
+  BrickIndexType lastBrickIndex = this->GetBrickIndex(imageExtent[1], imageExtent[3], imageExtent[5]);
+  for (int k = firstBrickIndex[2]; k <= lastBrickIndex[2]; ++k)
+  {
+    for (int j = firstBrickIndex[1]; j <= lastBrickIndex[1]; ++j)
+    {
+      for (int i = firstBrickIndex[0]; i <= lastBrickIndex[0]; ++i)
+      {
+        BrickIndexType brickIndex = { i, j, k };
+        int brickExtent[6] = { 0, -1, 0, -1, 0, -1 };
+        this->GetBrickExtent(brickIndex, brickExtent);
+        int copyExtent[6] = { 0, -1, 0, -1, 0, -1 };
+        if (!GetExtentIntersection(brickExtent, imageExtent, copyExtent) || !IsRegionAboveThreshold(image, copyExtent, 0.0))
+        {
+          // Empty brick
+          continue;
+        }
+        vtkSmartPointer<vtkOrientedImageData> brick = this->CreateBrick(brickIndex);
+        CopyRegion(image, brick, copyExtent);
+        this->Bricks[brickIndex] = brick;
+      }
+    }
+  }
+
+  this->Modified();
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSparseOrientedImageData::GetImage(vtkOrientedImageData* image, const int extent[6] /*=nullptr*/)
+{
+  if (!image)
+  {
+    vtkErrorMacro("GetImage: Invalid image");
+    return false;
+  }
+
+  int outputExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  if (extent)
+  {
+    std::copy(extent, extent + 6, outputExtent);
+  }
+  else
+  {
+    this->CalculateEffectiveExtent(outputExtent);
+  }
+
+  image->Initialize();
+  image->SetImageToWorldMatrix(this->ImageToWorldMatrix);
+  image->SetExtent(outputExtent);
+  image->AllocateScalars(this->ScalarType, 1);
+  if (!IsExtentValid(outputExtent))
+  {
+    return true;
+  }
+  memset(image->GetScalarPointer(), 0, image->GetNumberOfPoints() * image->GetScalarSize());
+
+  for (const auto& brick : this->Bricks)
+  {
+    int copyExtent[6] = { 0, -1, 0, -1, 0, -1 };
+    if (GetExtentIntersection(brick.second->GetExtent(), outputExtent, copyExtent))
+    {
+      CopyRegion(brick.second, image, copyExtent);
+    }
+  }
+  image->Modified();
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSparseOrientedImageData::ExtractLabel(int labelValue, vtkOrientedImageData* outputImage)
+{
+  if (!outputImage)
+  {
+    vtkErrorMacro("ExtractLabel: Invalid output image");
+    return false;
+  }
+
+  // Find bricks that contain the label
+  std::vector<vtkOrientedImageData*> labelBricks;
+  int outputExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  for (const auto& brick : this->Bricks)
+  {
+    if (::ExtractLabel(brick.second, labelValue, nullptr))
+    {
+      labelBricks.push_back(brick.second);
+      AddExtentToExtent(brick.second->GetExtent(), outputExtent);
+    }
+  }
+
+  outputImage->Initialize();
+  outputImage->SetImageToWorldMatrix(this->ImageToWorldMatrix);
+  outputImage->SetExtent(outputExtent);
+  outputImage->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+  if (labelBricks.empty())
+  {
+    return true;
+  }
+  memset(outputImage->GetScalarPointer(), 0, outputImage->GetNumberOfPoints() * outputImage->GetScalarSize());
+  for (vtkOrientedImageData* brick : labelBricks)
+  {
+    ::ExtractLabel(brick, labelValue, outputImage);
+  }
+  outputImage->Modified();
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSparseOrientedImageData::ModifyImage(vtkOrientedImageData* modifierImage,
+                                             int operation,
+                                             const int extent[6] /*=nullptr*/,
+                                             double maskThreshold /*=0*/,
+                                             double fillValue /*=1*/)
+{
+  if (!modifierImage)
+  {
+    vtkErrorMacro("ModifyImage: Invalid modifier image");
+    return false;
+  }
+  vtkNew<vtkMatrix4x4> modifierImageToWorldMatrix;
+  modifierImage->GetImageToWorldMatrix(modifierImageToWorldMatrix);
+  if (!vtkOrientedImageDataResample::IsEqual(modifierImageToWorldMatrix, this->ImageToWorldMatrix))
+  {
+    vtkErrorMacro("ModifyImage: Geometry mismatch between the sparse image and the modifier image");
+    return false;
+  }
+
+  int modifierExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  modifierImage->GetExtent(modifierExtent);
+  if (extent && !GetExtentIntersection(modifierExtent, extent, modifierExtent))
+  {
+    return true;
+  }
+  if (!IsExtentValid(modifierExtent) || !modifierImage->GetPointData()->GetScalars())
+  {
+    return true;
+  }
+
+  bool modified = false;
+  BrickIndexType firstBrickIndex = this->GetBrickIndex(modifierExtent[0], modifierExtent[2], modifierExtent[4]);
+  BrickIndexType lastBrickIndex = this->GetBrickIndex(modifierExtent[1], modifierExtent[3], modifierExtent[5]);
+  for (int k = firstBrickIndex[2]; k <= lastBrickIndex[2]; ++k)
+  {
+    for (int j = firstBrickIndex[1]; j <= lastBrickIndex[1]; ++j)
+    {
+      for (int i = firstBrickIndex[0]; i <= lastBrickIndex[0]; ++i)
+      {
+        BrickIndexType brickIndex = { i, j, k };
+        int brickExtent[6] = { 0, -1, 0, -1, 0, -1 };
+        this->GetBrickExtent(brickIndex, brickExtent);
+        int updateExtent[6] = { 0, -1, 0, -1, 0, -1 };
+        GetExtentIntersection(brickExtent, modifierExtent, updateExtent);
+
+        auto brickIt = this->Bricks.find(brickIndex);
+        if (brickIt == this->Bricks.end())
+        {
+          // Skip empty bricks that would remain empty
+          bool emptyBrickModified = false;
+          if (operation == vtkOrientedImageDataResample::OPERATION_MAXIMUM)
+          {
+            emptyBrickModified = IsRegionAboveThreshold(modifierImage, updateExtent, 0.0);
+          }
+          else if (operation == vtkOrientedImageDataResample::OPERATION_MASKING)
+          {
+            emptyBrickModified = (fillValue != 0.0 && IsRegionAboveThreshold(modifierImage, updateExtent, maskThreshold));
+          }
+          if (!emptyBrickModified)
+          {
+            continue;
+          }
+          vtkSmartPointer<vtkOrientedImageData> brick = this->CreateBrick(brickIndex);
+          vtkOrientedImageDataResample::ModifyImage(brick, modifierImage, operation, updateExtent, maskThreshold, fillValue);
+          this->Bricks[brickIndex] = brick;
+          modified = true;
+        }
+        else
+        {
+          // Bricks that are shared with a shallow copy are modified in a copy of the brick
+          vtkSmartPointer<vtkOrientedImageData> brick = brickIt->second;
+          bool sharedBrick = (brick->GetReferenceCount() > 2);
+          if (sharedBrick)
+          {
+            brick = vtkSmartPointer<vtkOrientedImageData>::New();
+            brick->DeepCopy(brickIt->second);
+          }
+          vtkMTimeType brickMTimeBefore = brick->GetMTime();
+          vtkOrientedImageDataResample::ModifyImage(brick, modifierImage, operation, updateExtent, maskThreshold, fillValue);
+          if (brick->GetMTime() == brickMTimeBefore)
+          {
+            continue;
+          }
+          modified = true;
+          if (sharedBrick)
+          {
+            brickIt->second = brick;
+          }
+          int effectiveExtent[6] = { 0, -1, 0, -1, 0, -1 };
+          if (operation != vtkOrientedImageDataResample::OPERATION_MAXIMUM //
+              && !vtkOrientedImageDataResample::CalculateEffectiveExtent(brick, effectiveExtent))
+          {
+            // Release bricks that became empty
+            this->Bricks.erase(brickIt);
+          }
+        }
+      }
+    }
+  }
+
+  if (modified)
+  {
+    this->Modified();
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSparseOrientedImageData::CalculateEffectiveExtent(int effectiveExtent[6])
+{
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    effectiveExtent[axis * 2] = 0;
+    effectiveExtent[axis * 2 + 1] = -1;
+  }
+  for (const auto& brick : this->Bricks)
+  {
+    int brickEffectiveExtent[6] = { 0, -1, 0, -1, 0, -1 };
+    if (vtkOrientedImageDataResample::CalculateEffectiveExtent(brick.second, brickEffectiveExtent))
+    {
+      AddExtentToExtent(brickEffectiveExtent, effectiveExtent);
+    }
+  }
+  return IsExtentValid(effectiveExtent);
+}
@@ -0,0 +1,142 @@
+/*==============================================================================
+
+  Copyright (c) Laboratory for Percutaneous Surgery (PerkLab)
+  Queen's University, Kingston, ON, Canada. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkSparseOrientedImageData_h
+#define __vtkSparseOrientedImageData_h
+
+// Segmentation includes
+#include "vtkSegmentationCoreConfigure.h"
+#include "vtkOrientedImageData.h"
+
+// VTK includes
+#include <vtkDataObject.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkSmartPointer.h>
+
+// STD includes
+#include <array>
+#include <map>
+
+/// \brief Labelmap image stored as a set of fixed size bricks
+///
+/// The image lattice is divided into cubic bricks of BrickSize voxels along each axis,
+/// and only those bricks are allocated that contain non-zero voxels. This is much more
+/// memory efficient than a dense vtkOrientedImageData when labels only occupy a small
+/// fraction of a large geometry (for example many small segments in a large reference volume).
+///
+/// Each brick is stored as a vtkOrientedImageData with the geometry of the sparse image and
+/// the extent of the brick, so all vtkOrientedImageDataResample functions can be used on them.
+/// Labelmap values are expected to be non-negative, zero is the background.
+///
+/// Segments of a vtkSegmentation can be merged into a sparse labelmap and set from it.
+/// \sa vtkSegmentation::GenerateMergedLabelmap, vtkSegmentation::SetSegmentLabelmapsFromMergedLabelmap
+class vtkSegmentationCore_EXPORT vtkSparseOrientedImageData : public vtkDataObject
+{
+public:
+  static vtkSparseOrientedImageData* New();
+  vtkTypeMacro(vtkSparseOrientedImageData, vtkDataObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Remove all bricks. Geometry, scalar type, and brick size are kept.
+  void Initialize() override;
+
+  /// Shallow copy. Bricks are shared between the two objects until either of them modifies a brick.
+  void ShallowCopy(vtkDataObject* src) override;
+  /// Deep copy
+  void DeepCopy(vtkDataObject* src) override;
+
+  /// Return the memory used by the allocated bricks, in kibibytes (1024 bytes)
+  unsigned long GetActualMemorySize() override;
+
+  /// Size of a brick along each axis, in voxels.
+  /// Can only be changed when there are no allocated bricks.
+  void SetBrickSize(int brickSize);
+  vtkGetMacro(BrickSize, int);
+
+  /// Scalar type of the voxels.
+  /// Can only be changed when there are no allocated bricks.
+  void SetScalarType(int scalarType);
+  vtkGetMacro(ScalarType, int);
+
+  /// Geometry of the image lattice. Can only be changed when there are no allocated bricks.
+  void SetImageToWorldMatrix(vtkMatrix4x4* imageToWorldMatrix);
+  void GetImageToWorldMatrix(vtkMatrix4x4* imageToWorldMatrix);
+
+  /// Set the content from a dense image. Geometry and scalar type are copied from the image.
+  /// Only bricks that contain non-zero voxels are allocated.
+  bool SetImage(vtkOrientedImageData* image);
+
+  /// Get the content as a dense image.
+  /// \param extent Extent of the output image. If not specified then the effective extent
+  ///   (extent of non-zero voxels) is used.
+  bool GetImage(vtkOrientedImageData* image, const int extent[6] = nullptr);
+
+  /// Get a binary labelmap of the voxels that have the specified label value.
+  /// Only bricks that contain the label value are processed.
+  /// The extent of the output is the union of those bricks.
+  /// \param outputImage Output labelmap of unsigned char type, voxels of the label are set to 1.
+  bool ExtractLabel(int labelValue, vtkOrientedImageData* outputImage);
+
+  /// Modify the image by combining it with modifierImage using the same operations as
+  /// vtkOrientedImageDataResample::ModifyImage. The sparse image is extended as needed.
+  /// Bricks that would remain empty are not allocated and bricks that become empty are released.
+  /// modifierImage must have the same geometry (origin, spacing, directions).
+  /// \param extent If specified then only that region of modifierImage is used.
+  bool ModifyImage(vtkOrientedImageData* modifierImage, int operation, const int extent[6] = nullptr, double maskThreshold = 0, double fillValue = 1);
+
+  /// Compute the extent of non-zero voxels. Returns false if there are no non-zero voxels.
+  bool CalculateEffectiveExtent(int effectiveExtent[6]);
+
+  /// Get number of allocated bricks
+  int GetNumberOfBricks() { return static_cast<int>(this->Bricks.size()); };
+
+  /// Get the brick that contains the specified voxel. Returns nullptr if the brick is not allocated.
+  vtkOrientedImageData* GetBrick(int i, int j, int k);
+
+  /// Get the extent of the brick that contains the specified voxel
+  void GetBrickExtent(int i, int j, int k, int brickExtent[6]);
+
+protected:
+  using BrickIndexType = std::array<int, 3>;
+
+  /// Get index of the brick that contains the voxel
+  BrickIndexType GetBrickIndex(int i, int j, int k);
+
+  /// Get extent of the brick with the specified index
+  void GetBrickExtent(const BrickIndexType& brickIndex, int brickExtent[6]);
+
+  /// Create a new brick filled with zeros
+  vtkSmartPointer<vtkOrientedImageData> CreateBrick(const BrickIndexType& brickIndex);
+
+protected:
+  vtkSparseOrientedImageData();
+  ~vtkSparseOrientedImageData() override;
+
+protected:
+  int BrickSize{ 32 };
+  int ScalarType;
+  vtkNew<vtkMatrix4x4> ImageToWorldMatrix;
+
+  /// Allocated bricks, indexed by brick position
+  std::map<BrickIndexType, vtkSmartPointer<vtkOrientedImageData>> Bricks;
+
+private:
+  vtkSparseOrientedImageData(const vtkSparseOrientedImageData&) = delete;
+  void operator=(const vtkSparseOrientedImageData&) = delete;
+};
+
+#endif
@@ -0,0 +1,169 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// vtkTeem includes
+#include <vtkTeemNRRDReader.h>
+#include <vtkTeemNRRDWriter.h>
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkSmartPointer.h>
+#include <vtkTimerLog.h>
+
+// STD includes
+#include <cstring>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+bool WriteImage(vtkImageData* image, bool useCompression, const std::string& fileName)
+{
+  vtkNew<vtkTeemNRRDWriter> writer;
+  writer->SetFileName(fileName.c_str());
+  writer->SetUseCompression(useCompression ? 1 : 0);
+  writer->SetInputData(image);
+  writer->Write();
+  if (writer->GetWriteError())
+  {
+    std::cerr << "Line " << __LINE__ << ": failed to write " << fileName << std::endl;
+    return false;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool CheckExtent(vtkTeemNRRDReader* reader, vtkImageData* image, int extent[6])
+{
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  reader->UpdateExtent(extent);
+  timer->StopTimer();
+  vtkImageData* readImage = reader->GetOutput();
+  int readExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  readImage->GetExtent(readExtent);
+  for (int i = 0; i < 6; ++i)
+  {
+    if (readExtent[i] != extent[i])
+    {
+      std::cerr << "Line " << __LINE__ << ": extent mismatch, expected " << extent[i] << ", got " << readExtent[i] << std::endl;
+      return false;
+    }
+  }
+  vtkDataArray* readScalars = readImage->GetPointData()->GetScalars();
+  if (!readScalars || readScalars->GetNumberOfComponents() != image->GetNumberOfScalarComponents())
+  {
+    std::cerr << "Line " << __LINE__ << ": invalid scalars" << std::endl;
+    return false;
+  }
+  size_t rowSize = static_cast<size_t>(extent[1] - extent[0] + 1) * image->GetScalarSize() * image->GetNumberOfScalarComponents();
+  for (int k = extent[4]; k <= extent[5]; ++k)
+  {
+    for (int j = extent[2]; j <= extent[3]; ++j)
+    {
+      if (memcmp(readImage->GetScalarPointer(extent[0], j, k), image->GetScalarPointer(extent[0], j, k), rowSize) != 0)
+      {
+        std::cerr << "Line " << __LINE__ << ": voxel mismatch in row j=" << j << ", k=" << k << std::endl;
+        return false;
+      }
+    }
+  }
+  std::cout << "Extent [" << extent[0] << ", " << extent[1] << ", " << extent[2] << ", " << extent[3] << ", " << extent[4] << ", " << extent[5]
+            << "]: " << timer->GetElapsedTime() << " s" << std::endl;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool CheckImage(vtkImageData* image, bool useCompression, const std::string& fileName)
+{
+  if (!WriteImage(image, useCompression, fileName))
+  {
+    return false;
+  }
+  int dimensions[3] = { 0, 0, 0 };
+  image->GetDimensions(dimensions);
+
+  vtkNew<vtkTeemNRRDReader> reader;
+  reader->SetFileName(fileName.c_str());
+  reader->UpdateInformation();
+
+  // Extents are read in decreasing order to test both reading from the beginning
+  // and reading starting from an access point of the index built by previous reads.
+  int sliceExtent[6] = { 0, dimensions[0] - 1, 0, dimensions[1] - 1, dimensions[2] - 2, dimensions[2] - 2 };
+  int blockExtent[6] = { 10, 30, 20, 45, dimensions[2] * 3 / 4, dimensions[2] * 3 / 4 + 5 };
+  int rowExtent[6] = { 5, 6, 7, 7, 1, 1 };
+  if (!CheckExtent(reader, image, sliceExtent) //
+      || !CheckExtent(reader, image, blockExtent) //
+      || !CheckExtent(reader, image, rowExtent))
+  {
+    std::cerr << "Line " << __LINE__ << ": partial read of " << fileName << " failed" << std::endl;
+    return false;
+  }
+
+  // Whole image
+  int wholeExtent[6] = { 0, dimensions[0] - 1, 0, dimensions[1] - 1, 0, dimensions[2] - 1 };
+  if (!CheckExtent(reader, image, wholeExtent))
+  {
+    std::cerr << "Line " << __LINE__ << ": full read of " << fileName << " failed" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkTeemNRRDReaderTest1(int argc, char* argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " /path/to/temp" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::string tempDir = argv[1];
+
+  // Scalar volume that is larger than the distance of access points in compressed files
+  vtkNew<vtkImageData> scalarImage;
+  scalarImage->SetDimensions(200, 180, 160);
+  scalarImage->AllocateScalars(VTK_SHORT, 1);
+  short* scalarVoxels = static_cast<short*>(scalarImage->GetScalarPointer());
+  for (vtkIdType voxelIndex = 0; voxelIndex < scalarImage->GetNumberOfPoints(); ++voxelIndex)
+  {
+    scalarVoxels[voxelIndex] = static_cast<short>((voxelIndex * 7) % 1013 - 500);
+  }
+
+  // Vector volume, components are stored along the first (fastest) axis
+  vtkNew<vtkImageData> vectorImage;
+  vectorImage->SetDimensions(40, 50, 30);
+  vectorImage->AllocateScalars(VTK_FLOAT, 3);
+  float* vectorVoxels = static_cast<float*>(vectorImage->GetScalarPointer());
+  for (vtkIdType valueIndex = 0; valueIndex < vectorImage->GetNumberOfPoints() * 3; ++valueIndex)
+  {
+    vectorVoxels[valueIndex] = static_cast<float>(valueIndex % 997) * 0.5f;
+  }
+
+  if (!CheckImage(scalarImage, false, tempDir + "/vtkTeemNRRDReaderTest1_scalar_raw.nrrd")    //
+      || !CheckImage(scalarImage, true, tempDir + "/vtkTeemNRRDReaderTest1_scalar_gzip.nrrd") //
+      || !CheckImage(vectorImage, false, tempDir + "/vtkTeemNRRDReaderTest1_vector_raw.nrrd") //
+      || !CheckImage(vectorImage, true, tempDir + "/vtkTeemNRRDReaderTest1_vector_gzip.nrrd"))
+  {
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,198 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// vtkTeem includes
+#include <vtkTeemNRRDReader.h>
+#include <vtkTeemNRRDWriter.h>
+
+// VTK includes
+#include <vtkImageAppendComponents.h>
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkSmartPointer.h>
+#include <vtkTimerLog.h>
+#include <vtksys/SystemTools.hxx>
+
+// STD includes
+#include <cstring>
+#include <vector>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+bool WriteImage(const std::vector<vtkSmartPointer<vtkImageData>>& layers, bool mergeLayers, int numberOfThreads, const std::string& fileName)
+{
+  vtkNew<vtkTeemNRRDWriter> writer;
+  writer->SetFileName(fileName.c_str());
+  writer->SetUseCompression(1);
+  writer->SetNumberOfThreads(numberOfThreads);
+  writer->SetVectorAxisKind(nrrdKindList);
+
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  vtkNew<vtkImageAppendComponents> appender;
+  if (mergeLayers)
+  {
+    for (vtkImageData* layer : layers)
+    {
+      appender->AddInputData(layer);
+    }
+    appender->Update();
+    writer->SetInputConnection(appender->GetOutputPort());
+  }
+  else
+  {
+    writer->SetInputData(layers[0]);
+    for (size_t layerIndex = 1; layerIndex < layers.size(); ++layerIndex)
+    {
+      writer->AddInputDataObject(layers[layerIndex]);
+    }
+  }
+  writer->Write();
+  timer->StopTimer();
+  if (writer->GetWriteError())
+  {
+    std::cerr << "Line " << __LINE__ << ": failed to write " << fileName << std::endl;
+    return false;
+  }
+  std::cout << (mergeLayers ? "Merged layers" : "Streamed layers") << ", " << numberOfThreads << " thread(s): " //
+            << timer->GetElapsedTime() << " s, " << vtksys::SystemTools::FileLength(fileName) << " bytes" << std::endl;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool CheckImage(const std::vector<vtkSmartPointer<vtkImageData>>& layers, const std::string& fileName)
+{
+  vtkNew<vtkTeemNRRDReader> reader;
+  reader->SetFileName(fileName.c_str());
+  reader->Update();
+  vtkImageData* image = reader->GetOutput();
+  vtkDataArray* scalars = (image ? image->GetPointData()->GetScalars() : nullptr);
+  if (!scalars || scalars->GetNumberOfComponents() != static_cast<int>(layers.size()) //
+      || scalars->GetNumberOfTuples() != layers[0]->GetNumberOfPoints())
+  {
+    std::cerr << "Line " << __LINE__ << ": invalid image read from " << fileName << std::endl;
+    return false;
+  }
+  const unsigned char* voxels = static_cast<const unsigned char*>(scalars->GetVoidPointer(0));
+  for (size_t layerIndex = 0; layerIndex < layers.size(); ++layerIndex)
+  {
+    const unsigned char* layerVoxels = static_cast<const unsigned char*>(layers[layerIndex]->GetScalarPointer());
+    for (vtkIdType voxelIndex = 0; voxelIndex < layers[layerIndex]->GetNumberOfPoints(); ++voxelIndex)
+    {
+      if (voxels[voxelIndex * layers.size() + layerIndex] != layerVoxels[voxelIndex])
+      {
+        std::cerr << "Line " << __LINE__ << ": voxel " << voxelIndex << " of layer " << layerIndex << " mismatch in " << fileName << std::endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkTeemNRRDWriterTest1(int argc, char* argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " /path/to/temp" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::string tempDir = argv[1];
+
+  // Segmentation-like layers: a few labels in blocks, large background regions
+  const int numberOfLayers = 4;
+  int dimensions[3] = { 160, 150, 140 };
+  std::vector<vtkSmartPointer<vtkImageData>> layers;
+  for (int layerIndex = 0; layerIndex < numberOfLayers; ++layerIndex)
+  {
+    vtkSmartPointer<vtkImageData> layer = vtkSmartPointer<vtkImageData>::New();
+    layer->SetDimensions(dimensions);
+    layer->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+    unsigned char* voxels = static_cast<unsigned char*>(layer->GetScalarPointer());
+    for (int k = 0; k < dimensions[2]; ++k)
+    {
+      for (int j = 0; j < dimensions[1]; ++j)
+      {
+        for (int i = 0; i < dimensions[0]; ++i)
+        {
+          bool inside = ((i / 20 + j / 15 + k / 10 + layerIndex) % 5 == 0);
+          *(voxels++) = (inside ? static_cast<unsigned char>(1 + (i + j + layerIndex) % 3) : 0);
+        }
+      }
+    }
+    layers.push_back(layer);
+  }
+
+  std::string mergedFileName = tempDir + "/vtkTeemNRRDWriterTest1_merged.nrrd";
+  std::string streamedFileName = tempDir + "/vtkTeemNRRDWriterTest1_streamed.nrrd";
+  std::string streamedSingleThreadFileName = tempDir + "/vtkTeemNRRDWriterTest1_streamed_single_thread.nrrd";
+
+  // Reference: merged image, compressed by teem
+  if (!WriteImage(layers, true, 1, mergedFileName) || !CheckImage(layers, mergedFileName))
+  {
+    return EXIT_FAILURE;
+  }
+  // Layers interleaved while writing, blocks compressed in parallel
+  if (!WriteImage(layers, false, 0, streamedFileName) || !CheckImage(layers, streamedFileName))
+  {
+    return EXIT_FAILURE;
+  }
+  // Layers interleaved while writing, blocks compressed one at a time
+  if (!WriteImage(layers, false, 1, streamedSingleThreadFileName) || !CheckImage(layers, streamedSingleThreadFileName))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // Output must not depend on the number of threads
+  if (vtksys::SystemTools::FilesDiffer(streamedFileName, streamedSingleThreadFileName))
+  {
+    std::cerr << "Line " << __LINE__ << ": file content depends on the number of threads" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Detached header: data is written into a separate file, as by teem
+  std::string detachedHeaderFileName = tempDir + "/vtkTeemNRRDWriterTest1_detached.nhdr";
+  std::string detachedDataFileName = tempDir + "/vtkTeemNRRDWriterTest1_detached.raw.gz";
+  vtksys::SystemTools::RemoveFile(detachedDataFileName);
+  if (!WriteImage(layers, false, 0, detachedHeaderFileName) || !CheckImage(layers, detachedHeaderFileName))
+  {
+    return EXIT_FAILURE;
+  }
+  if (!vtksys::SystemTools::FileExists(detachedDataFileName, true) //
+      || vtksys::SystemTools::FileLength(detachedHeaderFileName) > 4096)
+  {
+    std::cerr << "Line " << __LINE__ << ": data is not written into " << detachedDataFileName << std::endl;
+    return EXIT_FAILURE;
+  }
+  // Single-threaded compression is done by teem
+  std::string detachedSingleThreadHeaderFileName = tempDir + "/vtkTeemNRRDWriterTest1_detached_single_thread.nhdr";
+  if (!WriteImage(layers, true, 1, detachedSingleThreadHeaderFileName) || !CheckImage(layers, detachedSingleThreadHeaderFileName))
+  {
+    return EXIT_FAILURE;
+  }
+  if (!vtksys::SystemTools::FileExists(tempDir + "/vtkTeemNRRDWriterTest1_detached_single_thread.raw.gz", true))
+  {
+    std::cerr << "Line " << __LINE__ << ": data file naming differs from teem" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
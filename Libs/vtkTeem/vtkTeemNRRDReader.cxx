@@ -31,6 +31,7 @@
 // VTK includes
 #include "vtkBitArray.h"
 #include "vtkCharArray.h"
+#include "vtkDataArray.h"
 #include "vtkDoubleArray.h"
 #include "vtkFloatArray.h"
 #include "vtkImageData.h"
@@ -47,11 +48,299 @@
 #include "vtkUnsignedShortArray.h"
 #include "vtkUnsignedIntArray.h"
 #include "vtkUnsignedLongArray.h"
+#include <vtkByteSwap.h>
+#include <vtk_zlib.h>
 #include <vtksys/SystemTools.hxx>
 
 // Teem includes
 #include "teem/ten.h"
 
+// STD includes
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace
+{
+
+/// Size of the zlib history window (the dictionary needed to resume decompression)
+const vtkTypeInt64 NRRD_READER_WINDOW_SIZE = 32768;
+/// Minimum distance of access points in the decompressed stream
+const vtkTypeInt64 NRRD_READER_ACCESS_POINT_SPACING = 8 * 1024 * 1024;
+/// Size of compressed data chunks read from the file
+const vtkTypeInt64 NRRD_READER_INPUT_CHUNK_SIZE = 65536;
+
+//----------------------------------------------------------------------------
+// Contiguous region of the voxel data stream that is copied to the output
+struct DataRange
+{
+  vtkTypeInt64 Offset;
+  vtkTypeInt64 Length;
+  char* Destination;
+};
+
+//----------------------------------------------------------------------------
+// Position in a gzip stream where decompression can be started
+struct GzipAccessPoint
+{
+  /// Position in the decompressed stream
+  vtkTypeInt64 UncompressedOffset{ 0 };
+  /// Position of the first complete byte of the next deflate block in the file
+  vtkTypeInt64 CompressedOffset{ 0 };
+  /// Number of bits of the byte before CompressedOffset that belong to the next block
+  int Bits{ 0 };
+  /// Last NRRD_READER_WINDOW_SIZE bytes of the decompressed stream before this point
+  std::vector<unsigned char> Window;
+};
+
+//----------------------------------------------------------------------------
+// Access points of a gzip-encoded data file, sorted by uncompressed offset
+struct GzipSeekIndex
+{
+  std::string FileName;
+  long int FileModifiedTime{ 0 };
+  vtkTypeInt64 StreamStart{ 0 };
+  std::vector<GzipAccessPoint> AccessPoints;
+
+  /// Returns the last access point before the specified position (nullptr if there is none)
+  const GzipAccessPoint* FindAccessPoint(vtkTypeInt64 uncompressedOffset) const
+  {
+    std::vector<GzipAccessPoint>::const_iterator pointIt = std::upper_bound(AccessPoints.begin(),
+                                                                            AccessPoints.end(),
+                                                                            uncompressedOffset,
+                                                                            [](vtkTypeInt64 offset, const GzipAccessPoint& point) { return offset < point.UncompressedOffset; });
+    return pointIt == AccessPoints.begin() ? nullptr : &(*(pointIt - 1));
+  }
+};
+
+//----------------------------------------------------------------------------
+// Decompresses selected ranges of a gzip stream.
+// Decompression is started from the closest access point of the seek index
+// and new access points are added to the index while decompressing.
+class GzipRangeReader
+{
+public:
+  GzipRangeReader(GzipSeekIndex& index)
+    : Index(index)
+    , File(index.FileName.c_str(), std::ios::in | std::ios::binary)
+    , Input(NRRD_READER_INPUT_CHUNK_SIZE)
+    , Window(NRRD_READER_WINDOW_SIZE)
+  {
+  }
+
+  ~GzipRangeReader()
+  {
+    if (this->Initialized)
+    {
+      inflateEnd(&this->Stream);
+    }
+  }
+
+  /// Copy ranges of the decompressed stream to their destination.
+  /// Ranges must be sorted, must not overlap, and must be after ranges of previous calls.
+  bool Read(const std::vector<DataRange>& ranges)
+  {
+    size_t rangeIndex = 0;
+    while (rangeIndex < ranges.size())
+    {
+      const DataRange& range = ranges[rangeIndex];
+      if (!this->Initialized || this->Position <= range.Offset)
+      {
+        // Range is not started yet, jump to the closest access point if it is ahead of the current position
+        const GzipAccessPoint* point = this->Index.FindAccessPoint(range.Offset);
+        vtkTypeInt64 pointOffset = point ? point->UncompressedOffset : 0;
+        if (!this->Initialized || pointOffset > this->Position)
+        {
+          if (!this->Restart(point))
+          {
+            return false;
+          }
+        }
+      }
+      // Decompress until the current range is completed
+      while (rangeIndex < ranges.size() && this->Position < ranges[rangeIndex].Offset + ranges[rangeIndex].Length)
+      {
+        vtkTypeInt64 chunkStart = this->Position;
+        const char* chunk = nullptr;
+        vtkTypeInt64 chunkLength = 0;
+        if (!this->Decompress(chunk, chunkLength))
+        {
+          return false;
+        }
+        // Copy the decompressed data to all ranges that it overlaps with
+        for (size_t overlapIndex = rangeIndex; overlapIndex < ranges.size() && ranges[overlapIndex].Offset < chunkStart + chunkLength; ++overlapIndex)
+        {
+          const DataRange& overlapRange = ranges[overlapIndex];
+          vtkTypeInt64 start = std::max(overlapRange.Offset, chunkStart);
+          vtkTypeInt64 end = std::min(overlapRange.Offset + overlapRange.Length, chunkStart + chunkLength);
+          if (start < end)
+          {
+            memcpy(overlapRange.Destination + (start - overlapRange.Offset), chunk + (start - chunkStart), end - start);
+          }
+        }
+        while (rangeIndex < ranges.size() && ranges[rangeIndex].Offset + ranges[rangeIndex].Length <= this->Position)
+        {
+          ++rangeIndex;
+        }
+      }
+    }
+    return true;
+  }
+
+protected:
+  /// Start decompression at an access point (or at the beginning of the stream if point is nullptr)
+  bool Restart(const GzipAccessPoint* point)
+  {
+    if (this->Initialized)
+    {
+      inflateEnd(&this->Stream);
+      this->Initialized = false;
+    }
+    this->StreamEnded = false;
+    memset(&this->Stream, 0, sizeof(z_stream));
+    this->File.clear();
+    if (!point)
+    {
+      // automatic gzip or zlib header detection
+      if (inflateInit2(&this->Stream, 47) != Z_OK)
+      {
+        return false;
+      }
+      this->Initialized = true;
+      this->File.seekg(this->Index.StreamStart);
+      this->InputFileOffset = this->Index.StreamStart;
+      this->Position = 0;
+    }
+    else
+    {
+      // raw deflate stream, starting with the history of the access point
+      if (inflateInit2(&this->Stream, -15) != Z_OK)
+      {
+        return false;
+      }
+      this->Initialized = true;
+      this->InputFileOffset = point->CompressedOffset - (point->Bits ? 1 : 0);
+      this->File.seekg(this->InputFileOffset);
+      if (point->Bits)
+      {
+        int partialByte = this->File.get();
+        if (partialByte == EOF)
+        {
+          return false;
+        }
+        ++this->InputFileOffset;
+        inflatePrime(&this->Stream, point->Bits, partialByte >> (8 - point->Bits));
+      }
+      inflateSetDictionary(&this->Stream, point->Window.data(), static_cast<uInt>(NRRD_READER_WINDOW_SIZE));
+      this->Position = point->UncompressedOffset;
+    }
+    this->RestartPosition = this->Position;
+    return this->File.good();
+  }
+
+  /// Decompress the next chunk of data into the circular history window
+  bool Decompress(const char*& chunk, vtkTypeInt64& chunkLength)
+  {
+    if (this->StreamEnded)
+    {
+      // More data is expected after the end of the stream
+      // (streams of multiple concatenated gzip members are not supported).
+      return false;
+    }
+    if (this->Stream.avail_in == 0)
+    {
+      this->File.read(reinterpret_cast<char*>(this->Input.data()), NRRD_READER_INPUT_CHUNK_SIZE);
+      std::streamsize readSize = this->File.gcount();
+      if (readSize <= 0)
+      {
+        // unexpected end of file
+        return false;
+      }
+      this->InputFileOffset += readSize;
+      this->Stream.next_in = this->Input.data();
+      this->Stream.avail_in = static_cast<uInt>(readSize);
+    }
+    vtkTypeInt64 windowPosition = this->Position % NRRD_READER_WINDOW_SIZE;
+    this->Stream.next_out = this->Window.data() + windowPosition;
+    this->Stream.avail_out = static_cast<uInt>(NRRD_READER_WINDOW_SIZE - windowPosition);
+    // Z_BLOCK stops at the end of each deflate block, where an access point can be added
+    int status = inflate(&this->Stream, Z_BLOCK);
+    if (status == Z_STREAM_END)
+    {
+      this->StreamEnded = true;
+    }
+    else if (status != Z_OK && status != Z_BUF_ERROR)
+    {
+      return false;
+    }
+    chunk = reinterpret_cast<const char*>(this->Window.data() + windowPosition);
+    chunkLength = NRRD_READER_WINDOW_SIZE - windowPosition - this->Stream.avail_out;
+    this->Position += chunkLength;
+
+    // Add an access point at the end of the block if the previous one is far enough
+    bool endOfBlock = (this->Stream.data_type & 128) && !(this->Stream.data_type & 64);
+    vtkTypeInt64 lastPointOffset = this->Index.AccessPoints.empty() ? 0 : this->Index.AccessPoints.back().UncompressedOffset;
+    if (endOfBlock //
+        && this->Position >= lastPointOffset + NRRD_READER_ACCESS_POINT_SPACING
+        && this->Position >= this->RestartPosition + NRRD_READER_WINDOW_SIZE)
+    {
+      GzipAccessPoint point;
+      point.UncompressedOffset = this->Position;
+      point.CompressedOffset = this->InputFileOffset - this->Stream.avail_in;
+      point.Bits = this->Stream.data_type & 7;
+      // history window is stored in stream order
+      vtkTypeInt64 oldestPosition = this->Position % NRRD_READER_WINDOW_SIZE;
+      point.Window.reserve(NRRD_READER_WINDOW_SIZE);
+      point.Window.insert(point.Window.end(), this->Window.begin() + oldestPosition, this->Window.end());
+      point.Window.insert(point.Window.end(), this->Window.begin(), this->Window.begin() + oldestPosition);
+      this->Index.AccessPoints.push_back(point);
+    }
+    return true;
+  }
+
+  GzipSeekIndex& Index;
+  std::ifstream File;
+  std::vector<unsigned char> Input;
+  std::vector<unsigned char> Window;
+  z_stream Stream;
+  bool Initialized{ false };
+  bool StreamEnded{ false };
+  /// Position of the next decompressed byte in the stream
+  vtkTypeInt64 Position{ 0 };
+  /// Position where decompression was last started
+  vtkTypeInt64 RestartPosition{ 0 };
+  /// Position in the file after the last read input chunk
+  vtkTypeInt64 InputFileOffset{ 0 };
+};
+
+//----------------------------------------------------------------------------
+// Get position of the first byte after the header of a NRRD file with attached data
+bool GetAttachedDataOffset(const std::string& fileName, vtkTypeInt64& offset)
+{
+  std::ifstream file(fileName.c_str(), std::ios::in | std::ios::binary);
+  std::string line;
+  while (std::getline(file, line))
+  {
+    if (line.empty() || line == "\r")
+    {
+      offset = static_cast<vtkTypeInt64>(file.tellg());
+      return offset > 0;
+    }
+  }
+  return false;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+class vtkTeemNRRDReader::vtkInternal
+{
+public:
+  /// Access points of the last read gzip-encoded data file
+  GzipSeekIndex SeekIndex;
+};
+
 vtkStandardNewMacro(vtkTeemNRRDReader);
 
 //----------------------------------------------------------------------------
@@ -67,6 +356,7 @@ vtkTeemNRRDReader::vtkTeemNRRDReader()
   this->DataType = -1;
   this->NumberOfComponents = -1;
   this->DataArrayName = "NRRDImage";
+  this->Internal = new vtkInternal();
 }
 
 //----------------------------------------------------------------------------
@@ -74,6 +364,7 @@ vtkTeemNRRDReader::~vtkTeemNRRDReader()
 {
   nrrdNuke(this->nrrd);
   this->nrrd = nullptr;
+  delete this->Internal;
 }
 
 //----------------------------------------------------------------------------
@@ -352,6 +643,12 @@ void vtkTeemNRRDReader::ExecuteInformation()
   // image origin
   // meta data dictionary information
 
+  // Only the requested extent is read from the file if possible (see ReadUpdateExtent)
+  if (this->GetOutputInformation(0))
+  {
+    this->GetOutputInformation(0)->Set(vtkAlgorithm::CAN_PRODUCE_SUB_EXTENT(), 1);
+  }
+
   // save the Nrrd struct for the current file and
   // don't re-execute the read unless the filename changes
   if (this->CurrentFileName.compare(this->GetFileName()) == 0)
@@ -769,6 +1066,221 @@ void vtkTeemNRRDReader::AllocatePointData(vtkImageData* out, vtkInformation* out
   }
 }
 
+//----------------------------------------------------------------------------
+vtkDataArray* vtkTeemNRRDReader::GetPointDataArray(vtkImageData* imageData)
+{
+  switch (this->PointDataType)
+  {
+    case vtkDataSetAttributes::SCALARS: return imageData->GetPointData()->GetScalars();
+    case vtkDataSetAttributes::VECTORS: return imageData->GetPointData()->GetVectors();
+    case vtkDataSetAttributes::NORMALS: return imageData->GetPointData()->GetNormals();
+    case vtkDataSetAttributes::TENSORS: return imageData->GetPointData()->GetTensors();
+  }
+  return nullptr;
+}
+
+//----------------------------------------------------------------------------
+bool vtkTeemNRRDReader::ReadUpdateExtent(vtkDataObject* output, vtkInformation* outInfo)
+{
+  vtkInformation* outputInformation = this->GetOutputInformation(0);
+  if (!outputInformation || !outputInformation->Has(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT()))
+  {
+    return false;
+  }
+  int wholeExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  int updateExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  outputInformation->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), wholeExtent);
+  outputInformation->Get(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), updateExtent);
+  bool wholeExtentRequested = true;
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    if (updateExtent[axis * 2] > updateExtent[axis * 2 + 1] //
+        || updateExtent[axis * 2] < wholeExtent[axis * 2] || updateExtent[axis * 2 + 1] > wholeExtent[axis * 2 + 1])
+    {
+      // empty or invalid extent, let the full read report errors
+      return false;
+    }
+    if (updateExtent[axis * 2] != wholeExtent[axis * 2] || updateExtent[axis * 2 + 1] != wholeExtent[axis * 2 + 1])
+    {
+      wholeExtentRequested = false;
+    }
+  }
+  if (wholeExtentRequested)
+  {
+    return false;
+  }
+
+  // Read the header again to get the data file layout
+  Nrrd* nrrdTemp = nrrdNew();
+  NrrdIoState* nio = nrrdIoStateNew();
+  nrrdIoStateSet(nio, nrrdIoStateSkipData, 1);
+  if (nrrdLoad(nrrdTemp, this->GetFileName(), nio) != 0)
+  {
+    char* err = biffGetDone(NRRD);
+    free(err);
+    nrrdIoStateNix(nio);
+    nrrdNuke(nrrdTemp);
+    return false;
+  }
+
+  // Only data stored in a single raw or gzip-encoded file can be read partially.
+  // The voxels must be stored in the same order as in the output image, therefore
+  // the range axis (if any) must be the fastest axis and tensors that are expanded
+  // after reading are not supported.
+  unsigned int rangeAxisIdx[NRRD_DIM_MAX] = { 0 };
+  unsigned int rangeAxisNum = nrrdRangeAxesGet(nrrdTemp, rangeAxisIdx);
+  bool gzipEncoded = (nio->encoding == nrrdEncodingGzip);
+  bool supported = (nio->encoding == nrrdEncodingRaw || gzipEncoded) //
+                   && (!nio->dataFNArr || nio->dataFNArr->len <= 1) && !nio->dataFNFormat //
+                   && nrrdTemp->dim == 3 + rangeAxisNum //
+                   && nrrdTemp->type != nrrdTypeBlock //
+                   && (rangeAxisNum == 0 || rangeAxisIdx[0] == 0) //
+                   && nrrdTemp->axis[0].kind != nrrdKind3DMaskedSymMatrix //
+                   && nrrdTemp->axis[0].kind != nrrdKind3DSymMatrix //
+                   && (!gzipEncoded || nio->byteSkip >= 0);
+  std::string dataFileName;
+  if (supported && nio->dataFNArr && nio->dataFNArr->len == 1)
+  {
+    // detached data file, relative to the header file
+    dataFileName = vtksys::SystemTools::CollapseFullPath(nio->dataFN[0], //
+                                                         vtksys::SystemTools::GetFilenamePath(this->GetFileName()));
+  }
+  size_t elementSize = nrrdElementSize(nrrdTemp);
+  vtkTypeInt64 voxelSize = static_cast<vtkTypeInt64>(elementSize * (rangeAxisNum == 1 ? nrrdTemp->axis[0].size : 1));
+  bool swapBytes = false;
+#ifdef VTK_WORDS_BIGENDIAN
+  swapBytes = (nio->endian == airEndianLittle);
+#else
+  swapBytes = (nio->endian == airEndianBig);
+#endif
+  int lineSkip = nio->lineSkip;
+  vtkTypeInt64 byteSkip = static_cast<vtkTypeInt64>(nio->byteSkip);
+  nrrdIoStateNix(nio);
+  nrrdNuke(nrrdTemp);
+  if (!supported)
+  {
+    return false;
+  }
+
+  // Find the beginning of the data in the data file
+  vtkTypeInt64 dataFileOffset = 0;
+  if (dataFileName.empty())
+  {
+    dataFileName = this->GetFileName();
+    if (!GetAttachedDataOffset(dataFileName, dataFileOffset))
+    {
+      return false;
+    }
+  }
+  std::ifstream dataFile(dataFileName.c_str(), std::ios::in | std::ios::binary);
+  if (!dataFile.is_open())
+  {
+    return false;
+  }
+  dataFile.seekg(dataFileOffset);
+  std::string skippedLine;
+  for (int lineIndex = 0; lineIndex < lineSkip; ++lineIndex)
+  {
+    if (!std::getline(dataFile, skippedLine))
+    {
+      return false;
+    }
+  }
+  dataFileOffset = static_cast<vtkTypeInt64>(dataFile.tellg());
+  dataFile.seekg(0, std::ios::end);
+  vtkTypeInt64 dataFileSize = static_cast<vtkTypeInt64>(dataFile.tellg());
+  vtkTypeInt64 dimensions[3] = { wholeExtent[1] - wholeExtent[0] + 1, wholeExtent[3] - wholeExtent[2] + 1, wholeExtent[5] - wholeExtent[4] + 1 };
+  vtkTypeInt64 dataSize = voxelSize * dimensions[0] * dimensions[1] * dimensions[2];
+  vtkTypeInt64 dataOffset = 0; // position of the first voxel in the (decompressed) data stream
+  if (gzipEncoded)
+  {
+    // byte skip is applied to the decompressed data
+    dataOffset = byteSkip;
+  }
+  else
+  {
+    // byte skip of -1 means that the data is at the end of the file
+    dataFileOffset = (byteSkip == -1 ? dataFileSize - dataSize : dataFileOffset + byteSkip);
+    if (byteSkip < -1 || dataFileOffset < 0 || dataFileOffset + dataSize > dataFileSize)
+    {
+      return false;
+    }
+  }
+
+  vtkImageData* imageData = this->AllocateOutputData(output, outInfo);
+  vtkDataArray* dataArray = imageData ? this->GetPointDataArray(imageData) : nullptr;
+  if (!dataArray)
+  {
+    return false;
+  }
+  dataArray->SetName(this->DataArrayName.c_str());
+  char* outputPointer = static_cast<char*>(dataArray->GetVoidPointer(0));
+
+  // Collect the rows of the update extent, rows that are contiguous both in the file
+  // and in the output are merged (e.g., all rows of a slice if the full row is requested)
+  vtkTypeInt64 rowSize = voxelSize * (updateExtent[1] - updateExtent[0] + 1);
+  std::vector<DataRange> ranges;
+  for (vtkTypeInt64 k = updateExtent[4]; k <= updateExtent[5]; ++k)
+  {
+    for (vtkTypeInt64 j = updateExtent[2]; j <= updateExtent[3]; ++j)
+    {
+      DataRange range;
+      range.Offset = dataOffset + voxelSize * (((k - wholeExtent[4]) * dimensions[1] + (j - wholeExtent[2])) * dimensions[0] + (updateExtent[0] - wholeExtent[0]));
+      range.Length = rowSize;
+      range.Destination = outputPointer;
+      outputPointer += rowSize;
+      if (!ranges.empty() && ranges.back().Offset + ranges.back().Length == range.Offset)
+      {
+        ranges.back().Length += range.Length;
+      }
+      else
+      {
+        ranges.push_back(range);
+      }
+    }
+  }
+
+  if (gzipEncoded)
+  {
+    dataFile.close();
+    GzipSeekIndex& seekIndex = this->Internal->SeekIndex;
+    long int modifiedTime = vtksys::SystemTools::ModifiedTime(dataFileName);
+    if (seekIndex.FileName != dataFileName || seekIndex.FileModifiedTime != modifiedTime || seekIndex.StreamStart != dataFileOffset)
+    {
+      // data file changed, previous access points cannot be used
+      seekIndex.FileName = dataFileName;
+      seekIndex.FileModifiedTime = modifiedTime;
+      seekIndex.StreamStart = dataFileOffset;
+      seekIndex.AccessPoints.clear();
+    }
+    GzipRangeReader gzipReader(seekIndex);
+    if (!gzipReader.Read(ranges))
+    {
+      vtkWarningMacro("ReadUpdateExtent: failed to decompress the requested extent of " << dataFileName << ", reading the whole file");
+      return false;
+    }
+  }
+  else
+  {
+    dataFile.clear();
+    for (const DataRange& range : ranges)
+    {
+      dataFile.seekg(dataFileOffset + range.Offset);
+      if (!dataFile.read(range.Destination, range.Length))
+      {
+        vtkWarningMacro("ReadUpdateExtent: failed to read the requested extent of " << dataFileName << ", reading the whole file");
+        return false;
+      }
+    }
+  }
+
+  if (swapBytes && elementSize > 1)
+  {
+    vtkByteSwap::SwapVoidRange(dataArray->GetVoidPointer(0), static_cast<size_t>(dataArray->GetNumberOfValues()), elementSize);
+  }
+  return true;
+}
+
 //----------------------------------------------------------------------------
 int vtkTeemNRRDReader::tenSpaceDirectionReduce(Nrrd* nout, const Nrrd* nin, double SD[9])
 {
@@ -856,6 +1368,13 @@ int vtkTeemNRRDReader::tenSpaceDirectionReduce(Nrrd* nout, const Nrrd* nin, doub
 // are assumed to be the same as the file extent/order.
 void vtkTeemNRRDReader::ExecuteDataWithInformation(vtkDataObject* output, vtkInformation* outInfo)
 {
+  if (this->GetFileName() && this->ReadUpdateExtent(output, outInfo))
+  {
+    // only the requested extent has been read
+    return;
+  }
+
+  // read the whole image
   if (this->GetOutputInformation(0))
   {
     this->GetOutputInformation(0)->Set(                                                     //
@@ -888,26 +1407,12 @@ void vtkTeemNRRDReader::ExecuteDataWithInformation(vtkDataObject* output, vtkInf
   }
 
   void* ptr = nullptr;
-  switch (this->PointDataType)
+  vtkDataArray* dataArray = this->GetPointDataArray(imageData);
+  if (dataArray)
   {
-    case vtkDataSetAttributes::SCALARS:
-      imageData->GetPointData()->GetScalars()->SetName(this->DataArrayName.c_str());
-      // get pointer
-      ptr = imageData->GetPointData()->GetScalars()->GetVoidPointer(0);
-      break;
-    case vtkDataSetAttributes::VECTORS:
-      imageData->GetPointData()->GetVectors()->SetName(this->DataArrayName.c_str());
-      // get pointer
-      ptr = imageData->GetPointData()->GetVectors()->GetVoidPointer(0);
-      break;
-    case vtkDataSetAttributes::NORMALS:
-      imageData->GetPointData()->GetNormals()->SetName(this->DataArrayName.c_str());
-      ptr = imageData->GetPointData()->GetNormals()->GetVoidPointer(0);
-      break;
-    case vtkDataSetAttributes::TENSORS:
-      imageData->GetPointData()->GetTensors()->SetName(this->DataArrayName.c_str());
-      ptr = imageData->GetPointData()->GetTensors()->GetVoidPointer(0);
-      break;
+    dataArray->SetName(this->DataArrayName.c_str());
+    // get pointer
+    ptr = dataArray->GetVoidPointer(0);
   }
   this->ComputeDataIncrements();
 
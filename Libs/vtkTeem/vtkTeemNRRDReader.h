@@ -49,6 +49,12 @@
 /// \brief Reads Nearly Raw Raster Data files.
 ///
 /// Reads Nearly Raw Raster Data files using the nrrdio library as used in ITK
+///
+/// If a sub-extent of the image is requested (for example, by calling UpdateExtent())
+/// and the voxels are stored in a single raw or gzip-encoded data file, then only
+/// the requested region is read from the file. For gzip-encoded files an index of
+/// access points is built while decompressing, which allows subsequent requests
+/// to start decompression near the requested region instead of at the beginning of the file.
 //
 /// \sa vtkImageReader2
 class VTK_Teem_EXPORT vtkTeemNRRDReader : public vtkMedicalImageReader2
@@ -229,6 +235,17 @@ protected:
 
   int tenSpaceDirectionReduce(Nrrd* nout, const Nrrd* nin, double SD[9]);
 
+  /// Get the point data array that voxels are read into
+  vtkDataArray* GetPointDataArray(vtkImageData* imageData);
+
+  /// Read only the update extent of the image from the file.
+  /// Returns false if the whole extent is requested or the data cannot be
+  /// read partially, in this case the whole image has to be read by teem.
+  bool ReadUpdateExtent(vtkDataObject* output, vtkInformation* outInfo);
+
+  class vtkInternal;
+  vtkInternal* Internal;
+
 private:
   vtkTeemNRRDReader(const vtkTeemNRRDReader&) = delete;
   void operator=(const vtkTeemNRRDReader&) = delete;
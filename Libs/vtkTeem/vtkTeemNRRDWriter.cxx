@@ -1,4 +1,8 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
 #include <map>
+#include <vector>
 
 #include "vtkTeemNRRDWriter.h"
 
@@ -6,7 +10,10 @@
 #include "vtkPointData.h"
 #include "vtkObjectFactory.h"
 #include "vtkInformation.h"
+#include <vtkSMPTools.h>
 #include <vtkVersion.h>
+#include <vtk_zlib.h>
+#include <vtksys/SystemTools.hxx>
 
 #include <itkMath.h>
 #include <vnl/vnl_double_3.h>
@@ -20,6 +27,123 @@ class AxisInfoMapType : public std::map<unsigned int, std::string>
 {
 };
 
+namespace
+{
+
+/// Size of the uncompressed blocks that are compressed independently
+const size_t NRRD_WRITER_BLOCK_SIZE = 1024 * 1024;
+
+/// Size of the deflate window. The end of the previous block is used as dictionary,
+/// so compression ratio is the same as if the whole data was compressed at once.
+const size_t NRRD_WRITER_DICTIONARY_SIZE = 32768;
+
+//----------------------------------------------------------------------------
+/// Voxels of one or more images, where a voxel of the written data contains
+/// the components of all the images (memory layout of the NRRD range axis).
+struct InterleavedVoxels
+{
+  std::vector<const unsigned char*> Layers;
+  std::vector<size_t> LayerVoxelSizes;
+  size_t VoxelSize{ 0 };
+  size_t NumberOfVoxels{ 0 };
+
+  /// Returns pointer to voxels [startVoxel, endVoxel) in the written layout.
+  /// The data is copied into the buffer only if there are multiple layers.
+  const unsigned char* GetVoxels(size_t startVoxel, size_t endVoxel, std::vector<unsigned char>& buffer) const
+  {
+    if (this->Layers.size() == 1)
+    {
+      return this->Layers[0] + startVoxel * this->VoxelSize;
+    }
+    buffer.resize((endVoxel - startVoxel) * this->VoxelSize);
+    size_t layerOffset = 0;
+    for (size_t layerIndex = 0; layerIndex < this->Layers.size(); ++layerIndex)
+    {
+      const size_t layerVoxelSize = this->LayerVoxelSizes[layerIndex];
+      const unsigned char* source = this->Layers[layerIndex] + startVoxel * layerVoxelSize;
+      unsigned char* destination = buffer.data() + layerOffset;
+      if (layerVoxelSize == 1)
+      {
+        // Most common case: segmentation layers
+        for (size_t voxelIndex = startVoxel; voxelIndex < endVoxel; ++voxelIndex, ++source, destination += this->VoxelSize)
+        {
+          *destination = *source;
+        }
+      }
+      else
+      {
+        for (size_t voxelIndex = startVoxel; voxelIndex < endVoxel; ++voxelIndex, source += layerVoxelSize, destination += this->VoxelSize)
+        {
+          memcpy(destination, source, layerVoxelSize);
+        }
+      }
+      layerOffset += layerVoxelSize;
+    }
+    return buffer.data();
+  }
+};
+
+//----------------------------------------------------------------------------
+/// Compress a block into a raw deflate stream. Streams of consecutive blocks
+/// can be concatenated, as all but the last block end with a sync flush
+/// (the same technique is used by the pigz parallel gzip tool).
+bool CompressBlock(const unsigned char* dictionary,
+                   size_t dictionarySize,
+                   const unsigned char* data,
+                   size_t dataSize,
+                   bool lastBlock,
+                   int level,
+                   std::vector<unsigned char>& output)
+{
+  z_stream stream;
+  memset(&stream, 0, sizeof(stream));
+  // negative window bits: raw deflate stream without zlib or gzip wrapper
+  if (deflateInit2(&stream, level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+  {
+    return false;
+  }
+  if (dictionarySize > 0 && deflateSetDictionary(&stream, dictionary, static_cast<uInt>(dictionarySize)) != Z_OK)
+  {
+    deflateEnd(&stream);
+    return false;
+  }
+  const int flush = lastBlock ? Z_FINISH : Z_SYNC_FLUSH;
+  output.resize(deflateBound(&stream, static_cast<uLong>(dataSize)) + 64);
+  stream.next_in = const_cast<Bytef*>(data);
+  stream.avail_in = static_cast<uInt>(dataSize);
+  size_t outputSize = 0;
+  int result = Z_OK;
+  while (true)
+  {
+    if (outputSize == output.size())
+    {
+      output.resize(output.size() * 2);
+    }
+    stream.next_out = output.data() + outputSize;
+    stream.avail_out = static_cast<uInt>(output.size() - outputSize);
+    result = deflate(&stream, flush);
+    outputSize = output.size() - stream.avail_out;
+    if (result == Z_STREAM_ERROR || result == Z_STREAM_END || (!lastBlock && stream.avail_out > 0))
+    {
+      break;
+    }
+  }
+  deflateEnd(&stream);
+  output.resize(outputSize);
+  return (lastBlock ? result == Z_STREAM_END : result == Z_OK);
+}
+
+//----------------------------------------------------------------------------
+void AppendLittleEndian32(std::vector<unsigned char>& output, uLong value)
+{
+  for (int byteIndex = 0; byteIndex < 4; ++byteIndex)
+  {
+    output.push_back(static_cast<unsigned char>((value >> (8 * byteIndex)) & 0xff));
+  }
+}
+
+} // end of anonymous namespace
+
 vtkStandardNewMacro(vtkTeemNRRDWriter);
 
 //----------------------------------------------------------------------------
@@ -33,6 +157,7 @@ vtkTeemNRRDWriter::vtkTeemNRRDWriter()
   this->UseCompression = 1;
   // use default CompressionLevel
   this->CompressionLevel = -1;
+  this->NumberOfThreads = 1;
   this->DiffusionWeightedData = 0;
   this->FileType = VTK_BINARY;
   this->WriteErrorOff();
@@ -76,6 +201,7 @@ vtkImageData* vtkTeemNRRDWriter::GetInput(int port)
 int vtkTeemNRRDWriter::FillInputPortInformation(int vtkNotUsed(port), vtkInformation* info)
 {
   info->Set(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkImageData");
+  info->Set(vtkAlgorithm::INPUT_IS_REPEATABLE(), 1);
   return 1;
 }
 
@@ -194,6 +320,30 @@ void* vtkTeemNRRDWriter::MakeNRRD()
   void* buffer = nullptr;
   this->vtkImageDataInfoToNrrdInfo(this->GetInput(), kind[0], size[0], vtkType, &buffer);
 
+  int numberOfInputs = this->GetNumberOfInputConnections(0);
+  if (numberOfInputs > 1)
+  {
+    // Components of all the inputs are written in the range axis
+    for (int inputIndex = 0; inputIndex < numberOfInputs; ++inputIndex)
+    {
+      vtkImageData* input = vtkImageData::SafeDownCast(this->GetInputDataObject(0, inputIndex));
+      vtkDataArray* scalars = (input ? input->GetPointData()->GetScalars() : nullptr);
+      if (!scalars || scalars->GetDataType() != vtkType                      //
+          || input->GetDimensions()[0] != this->GetInput()->GetDimensions()[0] //
+          || input->GetDimensions()[1] != this->GetInput()->GetDimensions()[1] //
+          || input->GetDimensions()[2] != this->GetInput()->GetDimensions()[2])
+      {
+        vtkErrorMacro("Write: all inputs must have scalars of the same type and dimensions for " << this->GetFileName());
+        return nullptr;
+      }
+      if (inputIndex > 0)
+      {
+        size[0] += scalars->GetNumberOfComponents();
+      }
+    }
+    kind[0] = (this->VectorAxisKind != nrrdKindUnknown ? this->VectorAxisKind : nrrdKindList);
+  }
+
   double spaceDir[NRRD_DIM_MAX][NRRD_SPACE_DIM_MAX] = { 0.0 };
   unsigned int baseDim = 0;
   const unsigned int spaceDim = 3; // VTK is always 3D volumes.
@@ -388,7 +538,8 @@ void vtkTeemNRRDWriter::WriteData()
   NrrdIoState* nio = nrrdIoStateNew();
 
   // set encoding for data: compressed (raw), (uncompressed) raw, or ascii
-  if (this->GetUseCompression() && nrrdEncodingGzip->available())
+  bool useCompression = (this->GetUseCompression() && nrrdEncodingGzip->available());
+  if (useCompression)
   {
     // this is necessarily gzip-compressed *raw* data
     nio->encoding = nrrdEncodingGzip;
@@ -409,7 +560,16 @@ void vtkTeemNRRDWriter::WriteData()
   nio->endian = airEndianUnknown;
 
   // Write the nrrd to file.
-  if (nrrdSave(this->GetFileName(), nrrd, nio))
+  // Teem can only write a single buffer in one thread.
+  bool writeInBlocks = (this->GetNumberOfInputConnections(0) > 1 || (useCompression && this->NumberOfThreads != 1));
+  if (writeInBlocks)
+  {
+    if (!this->WriteDataInBlocks(nrrd, nio))
+    {
+      this->WriteErrorOn();
+    }
+  }
+  else if (nrrdSave(this->GetFileName(), nrrd, nio))
   {
     char* err = biffGetDone(NRRD); // would be nice to free(err)
     vtkErrorMacro("Write: Error writing " << this->GetFileName() << ":\n" << err);
@@ -420,6 +580,198 @@ void vtkTeemNRRDWriter::WriteData()
   nio = nrrdIoStateNix(nio);
 }
 
+//----------------------------------------------------------------------------
+bool vtkTeemNRRDWriter::WriteDataInBlocks(Nrrd* nrrd, NrrdIoState* nio)
+{
+  bool useCompression = (nio->encoding == nrrdEncodingGzip);
+  if (!useCompression && nio->encoding != nrrdEncodingRaw)
+  {
+    vtkErrorMacro("Write: only raw and gzip encodings are supported for multiple inputs when writing " << this->GetFileName());
+    return false;
+  }
+
+  // Collect the voxel buffers of all the inputs
+  InterleavedVoxels voxels;
+  for (int inputIndex = 0; inputIndex < this->GetNumberOfInputConnections(0); ++inputIndex)
+  {
+    vtkImageData* input = vtkImageData::SafeDownCast(this->GetInputDataObject(0, inputIndex));
+    vtkDataArray* scalars = (input ? input->GetPointData()->GetScalars() : nullptr);
+    if (!scalars)
+    {
+      vtkErrorMacro("Write: input " << inputIndex << " has no scalars for " << this->GetFileName());
+      return false;
+    }
+    size_t layerVoxelSize = static_cast<size_t>(scalars->GetNumberOfComponents()) * scalars->GetDataTypeSize();
+    voxels.Layers.push_back(static_cast<const unsigned char*>(scalars->GetVoidPointer(0)));
+    voxels.LayerVoxelSizes.push_back(layerVoxelSize);
+    voxels.VoxelSize += layerVoxelSize;
+    voxels.NumberOfVoxels = static_cast<size_t>(scalars->GetNumberOfTuples());
+  }
+
+  // Write the header using teem, so that it is the same as if the whole file was written by teem.
+  // The header is generated as attached header and the data file reference is added for .nhdr files.
+  nio->format = nrrdFormatNRRD;
+  nio->skipData = AIR_TRUE;
+  char* headerBuffer = nullptr;
+  if (nrrdStringWrite(&headerBuffer, nrrd, nio))
+  {
+    char* err = biffGetDone(NRRD); // would be nice to free(err)
+    vtkErrorMacro("Write: Error writing header of " << this->GetFileName() << ":\n" << err);
+    return false;
+  }
+  std::string header = headerBuffer;
+  free(headerBuffer);
+
+  // Same as nrrdSave: a .nhdr file only contains the header and refers to a separate data file
+  // that has the same name, with the encoding suffix (such as .raw.gz) instead of .nhdr.
+  std::string fileName = this->GetFileName();
+  bool detachedHeader = (vtksys::SystemTools::LowerCase(vtksys::SystemTools::GetFilenameLastExtension(fileName)) == ".nhdr");
+  std::string dataFileName = fileName;
+  if (detachedHeader)
+  {
+    std::string dataFileNameInHeader = vtksys::SystemTools::GetFilenameWithoutLastExtension(fileName) + "." + nio->encoding->suffix;
+    std::string directory = vtksys::SystemTools::GetFilenamePath(fileName);
+    dataFileName = directory.empty() ? dataFileNameInHeader : directory + "/" + dataFileNameInHeader;
+    while (!header.empty() && header.back() == '\n')
+    {
+      header.pop_back();
+    }
+    header += "\ndata file: " + dataFileNameInHeader + "\n";
+
+    FILE* headerFile = vtksys::SystemTools::Fopen(fileName, "wb");
+    if (!headerFile)
+    {
+      vtkErrorMacro("Write: Cannot open file " << fileName << " for writing");
+      return false;
+    }
+    bool headerSuccess = (fwrite(header.data(), 1, header.size(), headerFile) == header.size());
+    headerSuccess = (fclose(headerFile) == 0) && headerSuccess;
+    if (!headerSuccess)
+    {
+      vtkErrorMacro("Write: Error writing " << fileName);
+      return false;
+    }
+  }
+  // The attached header is separated from the data by an empty line
+  else if (header.size() < 2 || header.compare(header.size() - 2, 2, "\n\n") != 0)
+  {
+    header += "\n";
+  }
+
+  FILE* file = vtksys::SystemTools::Fopen(dataFileName, "wb");
+  if (!file)
+  {
+    vtkErrorMacro("Write: Cannot open file " << dataFileName << " for writing");
+    return false;
+  }
+  bool success = true;
+  if (!detachedHeader)
+  {
+    success = (fwrite(header.data(), 1, header.size(), file) == header.size());
+  }
+
+  if (useCompression)
+  {
+    // gzip member header: magic, deflate method, no flags, no modification time, unknown OS
+    const unsigned char gzipHeader[10] = { 0x1f, 0x8b, 8, 0, 0, 0, 0, 0, 0, 0xff };
+    success = success && (fwrite(gzipHeader, 1, sizeof(gzipHeader), file) == sizeof(gzipHeader));
+  }
+
+  // Blocks are processed in rounds, so that at most one block per thread is kept in memory
+  const size_t blockNumberOfVoxels = std::max<size_t>(1, NRRD_WRITER_BLOCK_SIZE / voxels.VoxelSize);
+  const size_t dictionaryNumberOfVoxels = (NRRD_WRITER_DICTIONARY_SIZE + voxels.VoxelSize - 1) / voxels.VoxelSize;
+  const size_t numberOfBlocks = std::max<size_t>(1, (voxels.NumberOfVoxels + blockNumberOfVoxels - 1) / blockNumberOfVoxels);
+  int numberOfThreads = (this->NumberOfThreads > 0 ? this->NumberOfThreads : vtkSMPTools::GetEstimatedNumberOfThreads());
+  const size_t numberOfBlocksPerRound = static_cast<size_t>(std::max(1, numberOfThreads));
+  struct Block
+  {
+    std::vector<unsigned char> Buffer;
+    std::vector<unsigned char> Output;
+    const unsigned char* Data{ nullptr };
+    size_t DataSize{ 0 };
+    uLong Crc{ 0 };
+    bool Success{ true };
+  };
+  std::vector<Block> blocks(numberOfBlocksPerRound);
+  const int level = this->CompressionLevel;
+  uLong crc = crc32(0L, Z_NULL, 0);
+  for (size_t roundStartBlock = 0; success && roundStartBlock < numberOfBlocks; roundStartBlock += numberOfBlocksPerRound)
+  {
+    size_t roundEndBlock = std::min(roundStartBlock + numberOfBlocksPerRound, numberOfBlocks);
+    vtkSMPTools::For(static_cast<vtkIdType>(roundStartBlock),
+                     static_cast<vtkIdType>(roundEndBlock),
+                     1,
+                     [&](vtkIdType beginBlock, vtkIdType endBlock)
+                     {
+                       for (vtkIdType blockIndex = beginBlock; blockIndex < endBlock; ++blockIndex)
+                       {
+                         Block& block = blocks[blockIndex - roundStartBlock];
+                         size_t startVoxel = std::min(static_cast<size_t>(blockIndex) * blockNumberOfVoxels, voxels.NumberOfVoxels);
+                         size_t endVoxel = std::min(startVoxel + blockNumberOfVoxels, voxels.NumberOfVoxels);
+                         if (!useCompression)
+                         {
+                           block.Data = voxels.GetVoxels(startVoxel, endVoxel, block.Buffer);
+                           block.DataSize = (endVoxel - startVoxel) * voxels.VoxelSize;
+                           continue;
+                         }
+                         // The end of the previous block is needed for the dictionary
+                         size_t dictionaryStartVoxel = (startVoxel > dictionaryNumberOfVoxels ? startVoxel - dictionaryNumberOfVoxels : 0);
+                         const unsigned char* data = voxels.GetVoxels(dictionaryStartVoxel, endVoxel, block.Buffer);
+                         size_t dictionarySize = std::min((startVoxel - dictionaryStartVoxel) * voxels.VoxelSize, NRRD_WRITER_DICTIONARY_SIZE);
+                         const unsigned char* blockData = data + (startVoxel - dictionaryStartVoxel) * voxels.VoxelSize;
+                         size_t blockDataSize = (endVoxel - startVoxel) * voxels.VoxelSize;
+                         block.Success = CompressBlock(blockData - dictionarySize,
+                                                       dictionarySize,
+                                                       blockData,
+                                                       blockDataSize,
+                                                       static_cast<size_t>(blockIndex) == numberOfBlocks - 1,
+                                                       level,
+                                                       block.Output);
+                         block.Crc = crc32(0L, blockData, static_cast<uInt>(blockDataSize));
+                         block.DataSize = blockDataSize;
+                       }
+                     });
+    // Write the blocks in order
+    for (size_t blockIndex = roundStartBlock; success && blockIndex < roundEndBlock; ++blockIndex)
+    {
+      Block& block = blocks[blockIndex - roundStartBlock];
+      if (!block.Success)
+      {
+        vtkErrorMacro("Write: Failed to compress data of " << this->GetFileName());
+        success = false;
+        break;
+      }
+      if (useCompression)
+      {
+        crc = crc32_combine(crc, block.Crc, static_cast<z_off_t>(block.DataSize));
+        success = (fwrite(block.Output.data(), 1, block.Output.size(), file) == block.Output.size());
+      }
+      else
+      {
+        success = (fwrite(block.Data, 1, block.DataSize, file) == block.DataSize);
+      }
+    }
+  }
+
+  if (success && useCompression)
+  {
+    // gzip member trailer: CRC-32 and size of the uncompressed data (modulo 2^32)
+    std::vector<unsigned char> gzipTrailer;
+    AppendLittleEndian32(gzipTrailer, crc);
+    AppendLittleEndian32(gzipTrailer, static_cast<uLong>((voxels.NumberOfVoxels * voxels.VoxelSize) & 0xffffffffUL));
+    success = (fwrite(gzipTrailer.data(), 1, gzipTrailer.size(), file) == gzipTrailer.size());
+  }
+  if (fclose(file) != 0)
+  {
+    success = false;
+  }
+  if (!success)
+  {
+    vtkErrorMacro("Write: Error writing " << dataFileName);
+  }
+  return success;
+}
+
 void vtkTeemNRRDWriter::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
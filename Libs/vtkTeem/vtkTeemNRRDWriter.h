@@ -25,6 +25,10 @@ class AxisInfoMapType;
 /// scalars, RGB, RGBA, spatial vectors (displacement, speed, etc.), or generic list components.
 /// vtkITKImageSequenceWriter can be used for writing time sequence data (e.g., time sequence of displacement fields, RGB volumes, etc.).
 ///
+/// Multiple images of the same dimensions and scalar type can be connected to the input port.
+/// Their components are written as a single 4D image, with the components of all the inputs in the range axis.
+/// The voxels are interleaved block by block while writing, so the merged image is never stored in memory.
+///
 /// \sa vtkTeemNRRDReader vtkITKImageWriter vtkITKImageSequenceWriter
 class VTK_Teem_EXPORT vtkTeemNRRDWriter : public vtkWriter
 {
@@ -63,6 +67,13 @@ public:
   vtkSetClampMacro(CompressionLevel, int, 0, 9);
   vtkGetMacro(CompressionLevel, int);
 
+  /// Maximum number of threads used for compressing the image data (default: 1).
+  /// If multiple threads are used then the data is split into blocks that are compressed
+  /// at the same time and joined into a single standard gzip stream, which can be read
+  /// by any NRRD reader. 0 means that all the threads available to vtkSMPTools are used.
+  vtkSetClampMacro(NumberOfThreads, int, 0, VTK_INT_MAX);
+  vtkGetMacro(NumberOfThreads, int);
+
   vtkSetClampMacro(FileType, int, VTK_ASCII, VTK_BINARY);
   vtkGetMacro(FileType, int);
   void SetFileTypeToASCII() { this->SetFileType(VTK_ASCII); };
@@ -120,6 +131,11 @@ protected:
   /// Write method. It is called by vtkWriter::Write();
   void WriteData() override;
 
+  /// Write the header using teem and the data block by block.
+  /// Used for interleaving multiple inputs and for multi-threaded compression.
+  /// As with nrrdSave, the data is written into a separate file if the file name has .nhdr extension.
+  bool WriteDataInBlocks(Nrrd* nrrd, NrrdIoState* nio);
+
   ///
   /// Flag to set to on when a write error occurred
   int WriteError;
@@ -134,6 +150,7 @@ protected:
 
   int UseCompression;
   int CompressionLevel;
+  int NumberOfThreads;
   int FileType;
 
   AttributeMapType* Attributes;
@@ -0,0 +1,172 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Segmentations includes
+#include "vtkImageGrowCutSegment.h"
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkSMPTools.h>
+
+// STD includes
+#include <cstring>
+
+namespace
+{
+
+const int DIMENSIONS[3] = { 40, 36, 64 };
+
+//----------------------------------------------------------------------------
+/// Intensity image with three regions of clearly different intensities (background and two spheres).
+/// A small gradient is added so that distances within a region are not all the same.
+void CreateIntensityVolume(vtkImageData* intensityVolume)
+{
+  intensityVolume->SetDimensions(DIMENSIONS[0], DIMENSIONS[1], DIMENSIONS[2]);
+  intensityVolume->AllocateScalars(VTK_FLOAT, 1);
+  float* intensityPtr = static_cast<float*>(intensityVolume->GetScalarPointer());
+  for (int k = 0; k < DIMENSIONS[2]; ++k)
+  {
+    for (int j = 0; j < DIMENSIONS[1]; ++j)
+    {
+      for (int i = 0; i < DIMENSIONS[0]; ++i)
+      {
+        float intensity = 10.0f;
+        if ((i - 20) * (i - 20) + (j - 18) * (j - 18) + (k - 40) * (k - 40) < 12 * 12)
+        {
+          intensity = 200.0f;
+        }
+        else if ((i - 12) * (i - 12) + (j - 10) * (j - 10) + (k - 12) * (k - 12) < 6 * 6)
+        {
+          intensity = 100.0f;
+        }
+        *(intensityPtr++) = intensity + 0.01f * i + 0.02f * j + 0.03f * k;
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+void SetSeed(vtkImageData* seedLabelVolume, int i, int j, int k, short label)
+{
+  for (int kk = k - 1; kk <= k + 1; ++kk)
+  {
+    for (int jj = j - 1; jj <= j + 1; ++jj)
+    {
+      for (int ii = i - 1; ii <= i + 1; ++ii)
+      {
+        *static_cast<short*>(seedLabelVolume->GetScalarPointer(ii, jj, kk)) = label;
+      }
+    }
+  }
+  seedLabelVolume->Modified();
+}
+
+//----------------------------------------------------------------------------
+bool IsLabelmapEqual(vtkImageData* labelmap1, vtkImageData* labelmap2)
+{
+  int* dimensions1 = labelmap1->GetDimensions();
+  int* dimensions2 = labelmap2->GetDimensions();
+  if (dimensions1[0] != dimensions2[0] || dimensions1[1] != dimensions2[1] || dimensions1[2] != dimensions2[2])
+  {
+    std::cerr << "Labelmap dimensions are different" << std::endl;
+    return false;
+  }
+  if (labelmap1->GetScalarType() != VTK_SHORT || labelmap2->GetScalarType() != VTK_SHORT)
+  {
+    std::cerr << "Unexpected labelmap scalar type" << std::endl;
+    return false;
+  }
+  const short* labelPtr1 = static_cast<short*>(labelmap1->GetScalarPointer());
+  const short* labelPtr2 = static_cast<short*>(labelmap2->GetScalarPointer());
+  vtkIdType numberOfDifferentVoxels = 0;
+  for (vtkIdType voxelIndex = 0; voxelIndex < labelmap1->GetNumberOfPoints(); ++voxelIndex)
+  {
+    if (labelPtr1[voxelIndex] != labelPtr2[voxelIndex])
+    {
+      ++numberOfDifferentVoxels;
+    }
+  }
+  if (numberOfDifferentVoxels > 0)
+  {
+    std::cerr << numberOfDifferentVoxels << " voxels have different labels" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkImageGrowCutSegmentTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  vtkNew<vtkImageData> intensityVolume;
+  CreateIntensityVolume(intensityVolume);
+
+  vtkNew<vtkImageData> seedLabelVolume;
+  seedLabelVolume->SetDimensions(DIMENSIONS);
+  seedLabelVolume->AllocateScalars(VTK_SHORT, 1);
+  seedLabelVolume->GetPointData()->GetScalars()->Fill(0);
+  // Seeds are far from each other along the Z axis, therefore the labels must propagate across multiple slabs
+  SetSeed(seedLabelVolume, 3, 3, 2, 1);
+  SetSeed(seedLabelVolume, 20, 18, 40, 2);
+
+  vtkNew<vtkImageGrowCutSegment> serialGrowCut;
+  serialGrowCut->SetIntensityVolume(intensityVolume);
+  serialGrowCut->SetSeedLabelVolume(seedLabelVolume);
+  CHECK_BOOL(serialGrowCut->GetParallelProcessing(), false);
+
+  vtkNew<vtkImageGrowCutSegment> parallelGrowCut;
+  parallelGrowCut->SetIntensityVolume(intensityVolume);
+  parallelGrowCut->SetSeedLabelVolume(seedLabelVolume);
+  parallelGrowCut->ParallelProcessingOn();
+
+  // Use several threads even on machines with few cores, to have multiple slabs
+  vtkSMPTools::Initialize(4);
+
+  // Initial computation
+  serialGrowCut->Update();
+  parallelGrowCut->Update();
+  CHECK_BOOL(IsLabelmapEqual(serialGrowCut->GetOutput(), parallelGrowCut->GetOutput()), true);
+  CHECK_INT(static_cast<int>(serialGrowCut->GetOutput()->GetScalarComponentAsDouble(39, 35, 63, 0)), 1);
+  CHECK_INT(static_cast<int>(serialGrowCut->GetOutput()->GetScalarComponentAsDouble(20, 18, 50, 0)), 2);
+  // The small sphere has no seed yet, it is labeled as background
+  CHECK_INT(static_cast<int>(serialGrowCut->GetOutput()->GetScalarComponentAsDouble(12, 10, 12, 0)), 1);
+
+  // Update with a new seed reuses the results of the previous computation
+  SetSeed(seedLabelVolume, 12, 10, 12, 3);
+  serialGrowCut->Update();
+  parallelGrowCut->Update();
+  CHECK_BOOL(IsLabelmapEqual(serialGrowCut->GetOutput(), parallelGrowCut->GetOutput()), true);
+  CHECK_INT(static_cast<int>(serialGrowCut->GetOutput()->GetScalarComponentAsDouble(12, 10, 15, 0)), 3);
+
+  // Full recomputation with distance penalty
+  serialGrowCut->SetDistancePenalty(2.0);
+  serialGrowCut->Reset();
+  serialGrowCut->Update();
+  parallelGrowCut->SetDistancePenalty(2.0);
+  parallelGrowCut->Reset();
+  parallelGrowCut->Update();
+  CHECK_BOOL(IsLabelmapEqual(serialGrowCut->GetOutput(), parallelGrowCut->GetOutput()), true);
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
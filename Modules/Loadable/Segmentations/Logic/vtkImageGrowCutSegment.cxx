@@ -1,7 +1,11 @@
 #include "vtkImageGrowCutSegment.h"
 
+#include <algorithm>
+#include <functional>
 #include <iostream>
 #include <limits>
+#include <queue>
+#include <utility>
 #include <vector>
 
 #include <vtkInformation.h>
@@ -9,6 +13,7 @@
 #include <vtkMath.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
+#include <vtkSMPTools.h>
 #include <vtkSmartPointer.h>
 #include <vtkStreamingDemandDrivenPipeline.h>
 #include <vtkTimerLog.h>
@@ -27,6 +32,43 @@ const int MaskPixelTypeID = VTK_UNSIGNED_CHAR;
 const NodeKeyValueType DIST_INF = std::numeric_limits<NodeKeyValueType>::max();
 const NodeKeyValueType DIST_EPSILON = 1e-3;
 
+// Minimum number of slices processed by a thread in parallel processing mode.
+// Thinner slabs would require many iterations of boundary exchange between slabs.
+const NodeIndexType MINIMUM_SLAB_THICKNESS = 4;
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Label propagation from a slab to a neighbor voxel that belongs to another slab
+template <typename LabelPixelType>
+struct BoundaryUpdate
+{
+  NodeIndexType Index;
+  NodeKeyValueType Distance;
+  LabelPixelType Label;
+};
+
+typedef std::pair<NodeKeyValueType, NodeIndexType> QueueItem;
+typedef std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> PriorityQueue;
+
+//----------------------------------------------------------------------------
+/// Range of slices that is processed by one thread in parallel processing mode.
+/// Voxels of a slab are stored at a contiguous range of indices: [StartIndex, EndIndex).
+template <typename LabelPixelType>
+struct Slab
+{
+  NodeIndexType StartIndex{ 0 };
+  NodeIndexType EndIndex{ 0 };
+  /// Voxels to propagate the label from. Outdated items (voxels that have been reached through a
+  /// shorter path since the item was added) are not removed from the queue but ignored when extracted.
+  PriorityQueue Queue;
+  std::vector<BoundaryUpdate<LabelPixelType>> UpdatesToPreviousSlab;
+  std::vector<BoundaryUpdate<LabelPixelType>> UpdatesToNextSlab;
+};
+
+} // namespace
+
 //----------------------------------------------------------------------------
 class vtkImageGrowCutSegment::vtkInternal
 {
@@ -36,17 +78,29 @@ public:
 
   void Reset();
 
+  /// Allocate distance and result label volumes and compute neighborhood offsets and sizes
+  void InitializeVolumes(vtkImageData* seedLabelVolume, double distancePenalty);
+
   template <typename IntensityPixelType, typename LabelPixelType>
   bool InitializationAHP(vtkImageData* intensityVolume, vtkImageData* seedLabelVolume, vtkImageData* maskLabelVolume, double distancePenalty);
 
   template <typename IntensityPixelType, typename LabelPixelType>
   void DijkstraBasedClassificationAHP(vtkImageData* intensityVolume, vtkImageData* seedLabelVolume, vtkImageData* maskLabelVolume);
 
+  /// Multi-threaded alternative of InitializationAHP and DijkstraBasedClassificationAHP
+  template <typename IntensityPixelType, typename LabelPixelType>
+  void ParallelClassification(vtkImageData* intensityVolume, vtkImageData* seedLabelVolume, vtkImageData* maskLabelVolume, double distancePenalty);
+
   template <class SourceVolType>
-  bool ExecuteGrowCut(vtkImageData* intensityVolume, vtkImageData* seedLabelVolume, vtkImageData* maskLabelVolume, vtkImageData* resultLabelVolume, double distancePenalty);
+  bool ExecuteGrowCut(vtkImageData* intensityVolume,
+                      vtkImageData* seedLabelVolume,
+                      vtkImageData* maskLabelVolume,
+                      vtkImageData* resultLabelVolume,
+                      double distancePenalty,
+                      bool parallelProcessing);
 
   template <class SourceVolType, class SeedVolType>
-  bool ExecuteGrowCut2(vtkImageData* intensityVolume, vtkImageData* seedLabelVolume, vtkImageData* maskLabelVolume, double distancePenalty);
+  bool ExecuteGrowCut2(vtkImageData* intensityVolume, vtkImageData* seedLabelVolume, vtkImageData* maskLabelVolume, double distancePenalty, bool parallelProcessing);
 
   // Stores the shortest distance from known labels to each point
   // If a point is set to DIST_INF then that point will modified, as a shorter distance path will be found.
@@ -106,6 +160,71 @@ void vtkImageGrowCutSegment::vtkInternal::Reset()
   m_ResultLabelVolume->Initialize();
 }
 
+//-----------------------------------------------------------------------------
+void vtkImageGrowCutSegment::vtkInternal::InitializeVolumes(vtkImageData* seedLabelVolume, double distancePenalty)
+{
+  NodeIndexType dimXYZ = m_DimX * m_DimY * m_DimZ;
+
+  m_ResultLabelVolume->SetOrigin(seedLabelVolume->GetOrigin());
+  m_ResultLabelVolume->SetSpacing(seedLabelVolume->GetSpacing());
+  m_ResultLabelVolume->SetExtent(seedLabelVolume->GetExtent());
+  m_ResultLabelVolume->AllocateScalars(seedLabelVolume->GetScalarType(), 1);
+  m_DistanceVolume->SetOrigin(seedLabelVolume->GetOrigin());
+  m_DistanceVolume->SetSpacing(seedLabelVolume->GetSpacing());
+  m_DistanceVolume->SetExtent(seedLabelVolume->GetExtent());
+  m_DistanceVolume->AllocateScalars(NodeKeyValueTypeID, 1);
+
+  // Compute index offset
+  m_DistancePenalty = distancePenalty;
+  m_NeighborIndexOffsets.clear();
+  m_NeighborDistancePenalties.clear();
+  // Neighbors are traversed in the order of m_NeighborIndexOffsets,
+  // therefore one would expect that the offsets should
+  // be as continuous as possible (e.g., x coordinate
+  // should change most quickly), but that resulted in
+  // about 5-6% longer computation time. Therefore,
+  // we put indices in order x1y1z1, x1y1z2, x1y1z3, etc.
+  double* spacing = seedLabelVolume->GetSpacing();
+  for (long ix = -1; ix <= 1; ix++)
+  {
+    for (long iy = -1; iy <= 1; iy++)
+    {
+      for (long iz = -1; iz <= 1; iz++)
+      {
+        if (ix == 0 && iy == 0 && iz == 0)
+        {
+          continue;
+        }
+        m_NeighborIndexOffsets.push_back(ix + long(m_DimX) * (iy + long(m_DimY) * iz));
+        m_NeighborDistancePenalties.push_back(this->m_DistancePenalty
+                                              * sqrt((spacing[0] * ix) * (spacing[0] * ix) + (spacing[1] * iy) * (spacing[1] * iy) + (spacing[2] * iz) * (spacing[2] * iz)));
+      }
+    }
+  }
+
+  // Determine neighborhood size for computation at each voxel.
+  // The neighborhood size is everywhere the same (size of m_NeighborIndexOffsets)
+  // except at the edges of the volume, where the neighborhood size is 0.
+  m_NumberOfNeighbors.resize(dimXYZ);
+  const unsigned char numberOfNeighbors = static_cast<unsigned char>(m_NeighborIndexOffsets.size());
+  unsigned char* nbSizePtr = &(m_NumberOfNeighbors[0]);
+  for (NodeIndexType z = 0; z < m_DimZ; z++)
+  {
+    bool zEdge = (z == 0 || z == m_DimZ - 1);
+    for (NodeIndexType y = 0; y < m_DimY; y++)
+    {
+      bool yEdge = (y == 0 || y == m_DimY - 1);
+      *(nbSizePtr++) = 0; // x == 0 (there is always padding, so we don't need to check if m_DimX>0)
+      unsigned char nbSize = (zEdge || yEdge) ? 0 : numberOfNeighbors;
+      for (NodeIndexType x = m_DimX - 2; x > 0; x--)
+      {
+        *(nbSizePtr++) = nbSize;
+      }
+      *(nbSizePtr++) = 0; // x == m_DimX-1 (there is always padding, so we don'neighborNewDistance need to check if m_DimX>1)
+    }
+  }
+}
+
 //-----------------------------------------------------------------------------
 template <typename IntensityPixelType, typename LabelPixelType>
 bool vtkImageGrowCutSegment::vtkInternal::InitializationAHP(vtkImageData* vtkNotUsed(intensityVolume),
@@ -147,67 +266,10 @@ bool vtkImageGrowCutSegment::vtkInternal::InitializationAHP(vtkImageData* vtkNot
 
   if (!m_bSegInitialized)
   {
-    m_ResultLabelVolume->SetOrigin(seedLabelVolume->GetOrigin());
-    m_ResultLabelVolume->SetSpacing(seedLabelVolume->GetSpacing());
-    m_ResultLabelVolume->SetExtent(seedLabelVolume->GetExtent());
-    m_ResultLabelVolume->AllocateScalars(seedLabelVolume->GetScalarType(), 1);
-    m_DistanceVolume->SetOrigin(seedLabelVolume->GetOrigin());
-    m_DistanceVolume->SetSpacing(seedLabelVolume->GetSpacing());
-    m_DistanceVolume->SetExtent(seedLabelVolume->GetExtent());
-    m_DistanceVolume->AllocateScalars(NodeKeyValueTypeID, 1);
+    this->InitializeVolumes(seedLabelVolume, distancePenalty);
     LabelPixelType* resultLabelVolumePtr = static_cast<LabelPixelType*>(m_ResultLabelVolume->GetScalarPointer());
     NodeKeyValueType* distanceVolumePtr = static_cast<NodeKeyValueType*>(m_DistanceVolume->GetScalarPointer());
 
-    // Compute index offset
-    m_DistancePenalty = distancePenalty;
-    m_NeighborIndexOffsets.clear();
-    m_NeighborDistancePenalties.clear();
-    // Neighbors are traversed in the order of m_NeighborIndexOffsets,
-    // therefore one would expect that the offsets should
-    // be as continuous as possible (e.g., x coordinate
-    // should change most quickly), but that resulted in
-    // about 5-6% longer computation time. Therefore,
-    // we put indices in order x1y1z1, x1y1z2, x1y1z3, etc.
-    double* spacing = seedLabelVolume->GetSpacing();
-    for (long ix = -1; ix <= 1; ix++)
-    {
-      for (long iy = -1; iy <= 1; iy++)
-      {
-        for (long iz = -1; iz <= 1; iz++)
-        {
-          if (ix == 0 && iy == 0 && iz == 0)
-          {
-            continue;
-          }
-          m_NeighborIndexOffsets.push_back(ix + long(m_DimX) * (iy + long(m_DimY) * iz));
-          m_NeighborDistancePenalties.push_back(this->m_DistancePenalty
-                                                * sqrt((spacing[0] * ix) * (spacing[0] * ix) + (spacing[1] * iy) * (spacing[1] * iy) + (spacing[2] * iz) * (spacing[2] * iz)));
-        }
-      }
-    }
-
-    // Determine neighborhood size for computation at each voxel.
-    // The neighborhood size is everywhere the same (size of m_NeighborIndexOffsets)
-    // except at the edges of the volume, where the neighborhood size is 0.
-    m_NumberOfNeighbors.resize(dimXYZ);
-    const unsigned char numberOfNeighbors = static_cast<unsigned char>(m_NeighborIndexOffsets.size());
-    unsigned char* nbSizePtr = &(m_NumberOfNeighbors[0]);
-    for (NodeIndexType z = 0; z < m_DimZ; z++)
-    {
-      bool zEdge = (z == 0 || z == m_DimZ - 1);
-      for (NodeIndexType y = 0; y < m_DimY; y++)
-      {
-        bool yEdge = (y == 0 || y == m_DimY - 1);
-        *(nbSizePtr++) = 0; // x == 0 (there is always padding, so we don't need to check if m_DimX>0)
-        unsigned char nbSize = (zEdge || yEdge) ? 0 : numberOfNeighbors;
-        for (NodeIndexType x = m_DimX - 2; x > 0; x--)
-        {
-          *(nbSizePtr++) = nbSize;
-        }
-        *(nbSizePtr++) = 0; // x == m_DimX-1 (there is always padding, so we don'neighborNewDistance need to check if m_DimX>1)
-      }
-    }
-
     if (!maskLabelVolumePtr)
     {
       // no mask
@@ -400,9 +462,205 @@ void vtkImageGrowCutSegment::vtkInternal::DijkstraBasedClassificationAHP(vtkImag
   m_HeapNodes = nullptr;
 }
 
+//-----------------------------------------------------------------------------
+template <typename IntensityPixelType, typename LabelPixelType>
+void vtkImageGrowCutSegment::vtkInternal::ParallelClassification(vtkImageData* intensityVolume,
+                                                                 vtkImageData* seedLabelVolume,
+                                                                 vtkImageData* maskLabelVolume,
+                                                                 double distancePenalty)
+{
+  // Heap of single-threaded processing is not used
+  if (m_Heap != nullptr)
+  {
+    delete m_Heap;
+    m_Heap = nullptr;
+  }
+  if (m_HeapNodes != nullptr)
+  {
+    delete[] m_HeapNodes;
+    m_HeapNodes = nullptr;
+  }
+
+  if (!m_bSegInitialized)
+  {
+    this->InitializeVolumes(seedLabelVolume, distancePenalty);
+  }
+
+  LabelPixelType* seedLabelVolumePtr = static_cast<LabelPixelType*>(seedLabelVolume->GetScalarPointer());
+  MaskPixelType* maskLabelVolumePtr = nullptr;
+  if (maskLabelVolume != nullptr)
+  {
+    maskLabelVolumePtr = static_cast<MaskPixelType*>(maskLabelVolume->GetScalarPointer());
+  }
+  LabelPixelType* resultLabelVolumePtr = static_cast<LabelPixelType*>(m_ResultLabelVolume->GetScalarPointer());
+  NodeKeyValueType* distanceVolumePtr = static_cast<NodeKeyValueType*>(m_DistanceVolume->GetScalarPointer());
+  IntensityPixelType* imSrc = static_cast<IntensityPixelType*>(intensityVolume->GetScalarPointer());
+
+  // Split the volume into slabs along the Z axis. Each slab is grown by one thread and
+  // only voxels of the slab are modified by that thread.
+  const NodeIndexType sliceSize = m_DimX * m_DimY;
+  NodeIndexType maxNumberOfSlabs = std::max(m_DimZ / MINIMUM_SLAB_THICKNESS, NodeIndexType(1));
+  NodeIndexType numberOfThreads = static_cast<NodeIndexType>(std::max(vtkSMPTools::GetEstimatedNumberOfThreads(), 1));
+  NodeIndexType numberOfSlabs = std::min(numberOfThreads, maxNumberOfSlabs);
+  NodeIndexType slabThickness = (m_DimZ + numberOfSlabs - 1) / numberOfSlabs;
+  numberOfSlabs = (m_DimZ + slabThickness - 1) / slabThickness; // avoid empty slabs due to rounding
+  std::vector<Slab<LabelPixelType>> slabs(numberOfSlabs);
+  for (NodeIndexType slabIndex = 0; slabIndex < numberOfSlabs; slabIndex++)
+  {
+    slabs[slabIndex].StartIndex = slabIndex * slabThickness * sliceSize;
+    slabs[slabIndex].EndIndex = std::min((slabIndex + 1) * slabThickness, m_DimZ) * sliceSize;
+  }
+
+  // Initialize voxels and queue the seeds (same rules as in InitializationAHP)
+  const bool segInitialized = m_bSegInitialized;
+  vtkSMPTools::For(0,
+                   static_cast<vtkIdType>(numberOfSlabs),
+                   1,
+                   [&](vtkIdType beginSlab, vtkIdType endSlab)
+                   {
+                     for (vtkIdType slabIndex = beginSlab; slabIndex < endSlab; slabIndex++)
+                     {
+                       Slab<LabelPixelType>& slab = slabs[slabIndex];
+                       for (NodeIndexType index = slab.StartIndex; index < slab.EndIndex; index++)
+                       {
+                         LabelPixelType seedValue = seedLabelVolumePtr[index];
+                         if (!segInitialized)
+                         {
+                           if (maskLabelVolumePtr && maskLabelVolumePtr[index] != 0)
+                           {
+                             // masked region: small distance will prevent overwriting of masked voxels
+                             resultLabelVolumePtr[index] = 0;
+                             distanceVolumePtr[index] = DIST_EPSILON;
+                           }
+                           else if (seedValue == 0)
+                           {
+                             resultLabelVolumePtr[index] = 0;
+                             distanceVolumePtr[index] = DIST_INF;
+                           }
+                           else
+                           {
+                             resultLabelVolumePtr[index] = seedValue;
+                             distanceVolumePtr[index] = DIST_EPSILON;
+                             slab.Queue.push(QueueItem(DIST_EPSILON, index));
+                           }
+                         }
+                         else if (seedValue != 0 && (resultLabelVolumePtr[index] != seedValue || distanceVolumePtr[index] > DIST_EPSILON))
+                         {
+                           // Only grow from new/changed seeds
+                           resultLabelVolumePtr[index] = seedValue;
+                           distanceVolumePtr[index] = DIST_EPSILON;
+                           slab.Queue.push(QueueItem(DIST_EPSILON, index));
+                         }
+                       }
+                     }
+                   });
+
+  bool propagationCompleted = false;
+  while (!propagationCompleted)
+  {
+    // Grow each slab independently (Dijkstra within the slab).
+    // Propagation to voxels of neighbor slabs is recorded and applied after all slabs are completed.
+    vtkSMPTools::For(0,
+                     static_cast<vtkIdType>(numberOfSlabs),
+                     1,
+                     [&](vtkIdType beginSlab, vtkIdType endSlab)
+                     {
+                       for (vtkIdType slabIndex = beginSlab; slabIndex < endSlab; slabIndex++)
+                       {
+                         Slab<LabelPixelType>& slab = slabs[slabIndex];
+                         while (!slab.Queue.empty())
+                         {
+                           NodeKeyValueType currentDistance = slab.Queue.top().first;
+                           NodeIndexType index = slab.Queue.top().second;
+                           slab.Queue.pop();
+                           if (currentDistance > distanceVolumePtr[index])
+                           {
+                             // outdated item, this voxel has been reached through a shorter path since then
+                             continue;
+                           }
+                           LabelPixelType currentLabel = resultLabelVolumePtr[index];
+
+                           // Update neighbors
+                           NodeKeyValueType pixCenter = imSrc[index];
+                           unsigned char nbSize = m_NumberOfNeighbors[index];
+                           for (unsigned char i = 0; i < nbSize; i++)
+                           {
+                             NodeIndexType indexNgbh = index + m_NeighborIndexOffsets[i];
+                             NodeKeyValueType neighborNewDistance = fabs(pixCenter - imSrc[indexNgbh]) + currentDistance + m_NeighborDistancePenalties[i];
+                             if (indexNgbh < slab.StartIndex)
+                             {
+                               slab.UpdatesToPreviousSlab.push_back({ indexNgbh, neighborNewDistance, currentLabel });
+                             }
+                             else if (indexNgbh >= slab.EndIndex)
+                             {
+                               slab.UpdatesToNextSlab.push_back({ indexNgbh, neighborNewDistance, currentLabel });
+                             }
+                             else if (distanceVolumePtr[indexNgbh] > neighborNewDistance)
+                             {
+                               distanceVolumePtr[indexNgbh] = neighborNewDistance;
+                               resultLabelVolumePtr[indexNgbh] = currentLabel;
+                               slab.Queue.push(QueueItem(neighborNewDistance, indexNgbh));
+                             }
+                           }
+                         }
+                       }
+                     });
+
+    // Exchange updates between neighbor slabs. Each slab only reads the updates of its neighbors
+    // and only modifies its own voxels, so slabs can be processed in parallel.
+    vtkSMPTools::For(0,
+                     static_cast<vtkIdType>(numberOfSlabs),
+                     1,
+                     [&](vtkIdType beginSlab, vtkIdType endSlab)
+                     {
+                       for (vtkIdType slabIndex = beginSlab; slabIndex < endSlab; slabIndex++)
+                       {
+                         Slab<LabelPixelType>& slab = slabs[slabIndex];
+                         auto applyUpdates = [&](const std::vector<BoundaryUpdate<LabelPixelType>>& updates)
+                         {
+                           for (const BoundaryUpdate<LabelPixelType>& update : updates)
+                           {
+                             if (distanceVolumePtr[update.Index] > update.Distance)
+                             {
+                               distanceVolumePtr[update.Index] = update.Distance;
+                               resultLabelVolumePtr[update.Index] = update.Label;
+                               slab.Queue.push(QueueItem(update.Distance, update.Index));
+                             }
+                           }
+                         };
+                         if (slabIndex > 0)
+                         {
+                           applyUpdates(slabs[slabIndex - 1].UpdatesToNextSlab);
+                         }
+                         if (slabIndex + 1 < static_cast<vtkIdType>(numberOfSlabs))
+                         {
+                           applyUpdates(slabs[slabIndex + 1].UpdatesToPreviousSlab);
+                         }
+                       }
+                     });
+
+    propagationCompleted = true;
+    for (Slab<LabelPixelType>& slab : slabs)
+    {
+      slab.UpdatesToPreviousSlab.clear();
+      slab.UpdatesToNextSlab.clear();
+      if (!slab.Queue.empty())
+      {
+        propagationCompleted = false;
+      }
+    }
+  }
+
+  m_bSegInitialized = true;
+}
+
 //-----------------------------------------------------------------------------
 template <class IntensityPixelType, class LabelPixelType>
-bool vtkImageGrowCutSegment::vtkInternal::ExecuteGrowCut2(vtkImageData* intensityVolume, vtkImageData* seedLabelVolume, vtkImageData* maskLabelVolume, double distancePenalty)
+bool vtkImageGrowCutSegment::vtkInternal::ExecuteGrowCut2(vtkImageData* intensityVolume,
+                                                          vtkImageData* seedLabelVolume,
+                                                          vtkImageData* maskLabelVolume,
+                                                          double distancePenalty,
+                                                          bool parallelProcessing)
 {
   int* imSize = intensityVolume->GetDimensions();
 
@@ -429,6 +687,12 @@ bool vtkImageGrowCutSegment::vtkInternal::ExecuteGrowCut2(vtkImageData* intensit
     return false;
   }
 
+  if (parallelProcessing)
+  {
+    ParallelClassification<IntensityPixelType, LabelPixelType>(intensityVolume, seedLabelVolume, maskLabelVolume, distancePenalty);
+    return true;
+  }
+
   if (!InitializationAHP<IntensityPixelType, LabelPixelType>(intensityVolume, seedLabelVolume, maskLabelVolume, distancePenalty))
   {
     return false;
@@ -444,7 +708,8 @@ bool vtkImageGrowCutSegment::vtkInternal::ExecuteGrowCut(vtkImageData* intensity
                                                          vtkImageData* seedLabelVolume,
                                                          vtkImageData* maskLabelVolume,
                                                          vtkImageData* resultLabelVolume,
-                                                         double distancePenalty)
+                                                         double distancePenalty,
+                                                         bool parallelProcessing)
 {
   int* extent = intensityVolume->GetExtent();
   double* spacing = intensityVolume->GetSpacing();
@@ -520,7 +785,7 @@ bool vtkImageGrowCutSegment::vtkInternal::ExecuteGrowCut(vtkImageData* intensity
   bool success = false;
   switch (seedLabelVolume->GetScalarType())
   {
-    vtkTemplateMacro((success = ExecuteGrowCut2<SourceVolType, VTK_TT>(intensityVolume, seedLabelVolume, maskLabelVolume, distancePenalty)));
+    vtkTemplateMacro((success = ExecuteGrowCut2<SourceVolType, VTK_TT>(intensityVolume, seedLabelVolume, maskLabelVolume, distancePenalty, parallelProcessing)));
     default: vtkGenericWarningMacro("vtkOrientedImageDataResample::MergeImage: Unknown ScalarType");
   }
 
@@ -542,6 +807,7 @@ vtkImageGrowCutSegment::vtkImageGrowCutSegment()
   this->SetNumberOfInputPorts(3);
   this->SetNumberOfOutputPorts(1);
   this->DistancePenalty = 0.0;
+  this->ParallelProcessing = false;
 }
 
 //-----------------------------------------------------------------------------
@@ -574,7 +840,7 @@ void vtkImageGrowCutSegment::ExecuteDataWithInformation(vtkDataObject* resultLab
 
   switch (intensityVolume->GetScalarType())
   {
-    vtkTemplateMacro(this->Internal->ExecuteGrowCut<VTK_TT>(intensityVolume, seedLabelVolume, maskLabelVolume, resultLabelVolume, this->DistancePenalty));
+    vtkTemplateMacro(this->Internal->ExecuteGrowCut<VTK_TT>(intensityVolume, seedLabelVolume, maskLabelVolume, resultLabelVolume, this->DistancePenalty, this->ParallelProcessing));
     break;
   }
   logger->StopTimer();
@@ -602,6 +868,7 @@ void vtkImageGrowCutSegment::Reset()
 //-----------------------------------------------------------------------------
 void vtkImageGrowCutSegment::PrintSelf(ostream& os, vtkIndent indent)
 {
-  // XXX Implement this function
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "DistancePenalty: " << this->DistancePenalty << "\n";
+  os << indent << "ParallelProcessing: " << (this->ParallelProcessing ? "true" : "false") << "\n";
 }
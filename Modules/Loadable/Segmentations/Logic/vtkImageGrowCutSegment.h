@@ -36,6 +36,18 @@ public:
   vtkGetMacro(DistancePenalty, double);
   vtkSetMacro(DistancePenalty, double);
 
+  /// Use multiple threads for region growing.
+  /// The image is split into slabs that are grown in parallel and label propagation between
+  /// neighboring slabs is repeated until no more changes occur. The result is the same as
+  /// with single-threaded processing, except that voxels that are at exactly the same distance from
+  /// multiple seeds may get a different label.
+  /// Results of previous computation are reused for updates (the same way as in single-threaded mode),
+  /// therefore the mode can be changed between updates.
+  /// By default = false.
+  vtkGetMacro(ParallelProcessing, bool);
+  vtkSetMacro(ParallelProcessing, bool);
+  vtkBooleanMacro(ParallelProcessing, bool);
+
 protected:
   vtkImageGrowCutSegment();
   ~vtkImageGrowCutSegment() override;
@@ -52,6 +64,7 @@ private:
   class vtkInternal;
   vtkInternal* Internal;
   double DistancePenalty;
+  bool ParallelProcessing;
 };
 
 #endif
@@ -55,6 +55,7 @@
 
 // STL includes
 #include <algorithm>
+#include <cmath>
 
 //----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkSlicerSequencesLogic);
@@ -258,29 +259,92 @@ void vtkSlicerSequencesLogic::UpdateAllProxyNodes()
     }
     if (!browserNode->GetPlaybackActive())
     {
-      this->LastSequenceBrowserUpdateTimeSec.erase(browserNode);
+      if (this->LastSequenceBrowserUpdateTimeSec.erase(browserNode) > 0)
+      {
+        // playback stopped, release prefetched items
+        this->PrefetchItems(browserNode, 0);
+      }
       continue;
     }
+    // negative playback rate plays the sequence in reverse direction
+    int playbackDirection = (browserNode->GetPlaybackRateFps() < 0.0 ? -1 : 1);
     if (this->LastSequenceBrowserUpdateTimeSec.find(browserNode) == this->LastSequenceBrowserUpdateTimeSec.end())
     {
       // we just started to play now, no need to update output nodes yet
       this->LastSequenceBrowserUpdateTimeSec[browserNode] = updateStartTimeSec;
+      browserNode->ResetPlaybackStatistics();
+      this->PrefetchItems(browserNode, playbackDirection);
       continue;
     }
     // play is already in progress
     double elapsedTimeSec = updateStartTimeSec - this->LastSequenceBrowserUpdateTimeSec[browserNode];
     // compute how many items we need to jump; if not enough time passed to jump at least to the next item
     // then we don't do anything (let the elapsed time cumulate)
-    int selectionIncrement = floor(elapsedTimeSec * browserNode->GetPlaybackRateFps() + 0.5); // floor with +0.5 is rounding
-    if (selectionIncrement > 0)
+    int numberOfSteps = floor(elapsedTimeSec * fabs(browserNode->GetPlaybackRateFps()) + 0.5); // floor with +0.5 is rounding
+    if (numberOfSteps > 0)
     {
       this->LastSequenceBrowserUpdateTimeSec[browserNode] = updateStartTimeSec;
       if (!browserNode->GetPlaybackItemSkippingEnabled())
       {
-        selectionIncrement = 1;
+        numberOfSteps = 1;
+      }
+      int selectionIncrement = playbackDirection * numberOfSteps;
+      double frameStartTimeSec = vtkTimerLog::GetUniversalTime();
+      browserNode->SelectNextItem(selectionIncrement); // proxy nodes are updated when the browser node is modified
+      browserNode->AddPlaybackFrameStatistics(vtkTimerLog::GetUniversalTime() - frameStartTimeSec, numberOfSteps - 1);
+      this->PrefetchItems(browserNode, browserNode->GetPlaybackActive() ? selectionIncrement : 0);
+    }
+  }
+}
+
+//---------------------------------------------------------------------------
+void vtkSlicerSequencesLogic::PrefetchItems(vtkMRMLSequenceBrowserNode* browserNode, int selectionIncrement)
+{
+  vtkMRMLSequenceNode* masterSequenceNode = browserNode->GetMasterSequenceNode();
+  if (!masterSequenceNode)
+  {
+    return;
+  }
+
+  // Index values of the upcoming items, in playback order
+  std::vector<std::string> indexValues;
+  int numberOfItems = browserNode->GetNumberOfItems();
+  int itemNumber = browserNode->GetSelectedItemNumber();
+  if (selectionIncrement != 0 && numberOfItems > 0 && itemNumber >= 0)
+  {
+    for (int i = 0; i < browserNode->GetPlaybackPrefetchItemCount(); ++i)
+    {
+      itemNumber += selectionIncrement;
+      if (itemNumber < 0 || itemNumber >= numberOfItems)
+      {
+        if (!browserNode->GetPlaybackLooped())
+        {
+          break;
+        }
+        itemNumber = ((itemNumber % numberOfItems) + numberOfItems) % numberOfItems;
+      }
+      indexValues.push_back(masterSequenceNode->GetNthIndexValue(itemNumber));
+    }
+  }
+
+  std::vector<vtkMRMLSequenceNode*> synchronizedSequenceNodes;
+  browserNode->GetSynchronizedSequenceNodes(synchronizedSequenceNodes, true);
+  for (vtkMRMLSequenceNode* synchronizedSequenceNode : synchronizedSequenceNodes)
+  {
+    if (!synchronizedSequenceNode || !browserNode->GetPlayback(synchronizedSequenceNode))
+    {
+      continue;
+    }
+    std::vector<int> itemNumbers;
+    for (const std::string& indexValue : indexValues)
+    {
+      int synchronizedItemNumber = synchronizedSequenceNode->GetItemNumberFromIndexValue(indexValue, /* exactMatchRequired= */ false);
+      if (synchronizedItemNumber >= 0)
+      {
+        itemNumbers.push_back(synchronizedItemNumber);
       }
-      browserNode->SelectNextItem(selectionIncrement);
     }
+    synchronizedSequenceNode->PrefetchDataNodes(itemNumbers);
   }
 }
 
@@ -375,6 +439,8 @@ void vtkSlicerSequencesLogic::UpdateProxyNodesFromSequences(vtkMRMLSequenceBrows
             sourceDataNode = synchronizedSequenceNode->GetDataNodeAtValue(indexValue, /* exactMatchRequired= */ false);
             if (sourceDataNode)
             {
+              // Content of the previous item must be in memory to be copied
+              browserNode->LoadItem(synchronizedSequenceNode, synchronizedSequenceNode->GetItemNumberFromIndexValue(indexValue, /* exactMatchRequired= */ false));
               sourceDataNode = synchronizedSequenceNode->SetDataNodeAtValue(sourceDataNode, indexValue);
             }
           }
@@ -459,6 +525,22 @@ void vtkSlicerSequencesLogic::UpdateProxyNodesFromSequences(vtkMRMLSequenceBrows
       }
     }
 
+    // Item number of the source data node in the sequence (-1 if the source data node is not an item of the sequence)
+    int sourceItemNumber = -1;
+    if (sourceDataNode)
+    {
+      // Make sure the content of the item is in memory if it is loaded on demand
+      sourceItemNumber = synchronizedSequenceNode->GetItemNumberFromIndexValue(indexValue, /* exactMatchRequired= */ false);
+      if (sourceItemNumber >= 0 && synchronizedSequenceNode->GetNthDataNode(sourceItemNumber) == sourceDataNode)
+      {
+        browserNode->LoadItem(synchronizedSequenceNode, sourceItemNumber);
+      }
+      else
+      {
+        sourceItemNumber = -1;
+      }
+    }
+
     if (sourceDataNode == nullptr)
     {
       if (missingItemMode == vtkMRMLSequenceBrowserNode::MissingItemDisplayHidden)
@@ -511,7 +593,19 @@ void vtkSlicerSequencesLogic::UpdateProxyNodesFromSequences(vtkMRMLSequenceBrows
     // TODO: if we really want to force non-mutable nodes in the sequence then we have to deep-copy, but that's slow.
     // Make sure that by default/most of the time shallow-copy is used.
     bool shallowCopy = browserNode->GetSaveChanges(synchronizedSequenceNode);
-    targetProxyNode->CopyContent(sourceDataNode, !shallowCopy);
+    // Content of items that are loaded on demand can be read from file again at any time,
+    // therefore it is moved to the proxy node (shallow copy and unload from the sequence) instead of copying.
+    bool moveContent = !shallowCopy && sourceItemNumber >= 0 && synchronizedSequenceNode->GetNthDataNodeStorageFrameIndex(sourceItemNumber) >= 0;
+    targetProxyNode->CopyContent(sourceDataNode, !(shallowCopy || moveContent));
+    if (moveContent)
+    {
+      synchronizedSequenceNode->UnloadNthDataNode(sourceItemNumber);
+    }
+    else if (!shallowCopy && sourceItemNumber >= 0 && synchronizedSequenceNode->IsNthDataNodeCompact(sourceItemNumber))
+    {
+      // Data node of a compact item is only needed for updating the proxy node
+      synchronizedSequenceNode->UnloadNthDataNode(sourceItemNumber);
+    }
 
     // Singleton nodes must not be renamed, as they are often expected to exist by a specific name
     if (browserNode->GetOverwriteProxyName(synchronizedSequenceNode) && !targetProxyNode->GetSingletonTag())
@@ -114,6 +114,12 @@ protected:
 
   bool IsDataConnectorNode(vtkMRMLNode*);
 
+  /// Start loading upcoming items of sequences that are loaded on demand in background threads.
+  /// Items are predicted by stepping selectionIncrement items from the selected item, following playback looping.
+  /// Negative selectionIncrement prefetches items preceding the selected item (reverse playback).
+  /// If selectionIncrement is 0 then all prefetched items are released.
+  void PrefetchItems(vtkMRMLSequenceBrowserNode* browserNode, int selectionIncrement);
+
   // Time of the last update of each browser node (in universal time)
   std::map<vtkMRMLSequenceBrowserNode*, double> LastSequenceBrowserUpdateTimeSec;
 
@@ -27,11 +27,13 @@
 #include <vtkMRMLScene.h>
 #include <vtkMRMLVolumeNode.h>
 #include <vtkMRMLHierarchyNode.h>
+#include <vtkMRMLLinearTransformNode.h>
 
 // VTK includes
 #include <vtkNew.h>
 #include <vtkIntArray.h>
 #include <vtkCommand.h>
+#include <vtkMatrix4x4.h>
 #include <vtkCollection.h>
 #include <vtkCollectionIterator.h>
 #include <vtkObjectFactory.h>
@@ -159,6 +161,8 @@ void vtkMRMLSequenceBrowserNode::WriteXML(ostream& of, int nIndent)
   of << indent << " playbackItemSkippingEnabled=\"" << (this->PlaybackItemSkippingEnabled ? "true" : "false") << "\"";
   of << indent << " playbackLooped=\"" << (this->PlaybackLooped ? "true" : "false") << "\"";
   of << indent << " selectedItemNumber=\"" << this->SelectedItemNumber << "\"";
+  of << indent << " maximumNumberOfLoadedItems=\"" << this->MaximumNumberOfLoadedItems << "\"";
+  of << indent << " playbackPrefetchItemCount=\"" << this->PlaybackPrefetchItemCount << "\"";
   of << indent << " recordingActive=\"" << (this->RecordingActive ? "true" : "false") << "\"";
   of << indent << " recordOnMasterModifiedOnly=\"" << (this->RecordMasterOnly ? "true" : "false") << "\"";
 
@@ -261,6 +265,22 @@ void vtkMRMLSequenceBrowserNode::ReadXMLAttributes(const char** atts)
       ss >> selectedItemNumber;
       this->SetSelectedItemNumber(selectedItemNumber);
     }
+    else if (!strcmp(attName, "maximumNumberOfLoadedItems"))
+    {
+      std::stringstream ss;
+      ss << attValue;
+      int maximumNumberOfLoadedItems = 8;
+      ss >> maximumNumberOfLoadedItems;
+      this->SetMaximumNumberOfLoadedItems(maximumNumberOfLoadedItems);
+    }
+    else if (!strcmp(attName, "playbackPrefetchItemCount"))
+    {
+      std::stringstream ss;
+      ss << attValue;
+      int playbackPrefetchItemCount = 2;
+      ss >> playbackPrefetchItemCount;
+      this->SetPlaybackPrefetchItemCount(playbackPrefetchItemCount);
+    }
     else if (!strcmp(attName, "recordingActive"))
     {
       if (!strcmp(attValue, "true"))
@@ -390,6 +410,8 @@ void vtkMRMLSequenceBrowserNode::CopyContent(vtkMRMLNode* anode, bool deepCopy /
   vtkMRMLCopyStringMacro(IndexDisplayFormat);
   vtkMRMLCopyBooleanMacro(RecordingActive);
   vtkMRMLCopyIntMacro(SelectedItemNumber);
+  vtkMRMLCopyIntMacro(MaximumNumberOfLoadedItems);
+  vtkMRMLCopyIntMacro(PlaybackPrefetchItemCount);
   vtkMRMLCopyEndMacro();
 }
 
@@ -404,6 +426,12 @@ void vtkMRMLSequenceBrowserNode::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << " Playback item skipping enabled: " << (this->PlaybackItemSkippingEnabled ? "true" : "false") << '\n';
   os << indent << " Playback looped: " << (this->PlaybackLooped ? "true" : "false") << '\n';
   os << indent << " Selected item number: " << this->SelectedItemNumber << '\n';
+  os << indent << " Maximum number of loaded items: " << this->MaximumNumberOfLoadedItems << '\n';
+  os << indent << " Playback prefetch item count: " << this->PlaybackPrefetchItemCount << '\n';
+  os << indent << " Playback displayed frames: " << this->PlaybackNumberOfDisplayedFrames << '\n';
+  os << indent << " Playback dropped frames: " << this->PlaybackNumberOfDroppedFrames << '\n';
+  os << indent << " Playback average frame time (sec): " << this->GetPlaybackAverageFrameTimeSec() << '\n';
+  os << indent << " Playback maximum frame time (sec): " << this->PlaybackMaximumFrameTimeSec << '\n';
   os << indent << " Recording active: " << (this->RecordingActive ? "true" : "false") << '\n';
   os << indent << " Recording on master modified only: " << (this->RecordMasterOnly ? "true" : "false") << '\n';
   os << indent << " Recording sampling mode: " << this->GetRecordingSamplingModeAsString() << "\n";
@@ -1074,6 +1102,74 @@ bool vtkMRMLSequenceBrowserNode::SetSelectedItemByIndexValue(const std::string&
   return true;
 }
 
+//---------------------------------------------------------------------------
+double vtkMRMLSequenceBrowserNode::GetPlaybackAverageFrameTimeSec()
+{
+  if (this->PlaybackNumberOfDisplayedFrames == 0)
+  {
+    return 0.0;
+  }
+  return this->PlaybackTotalFrameTimeSec / this->PlaybackNumberOfDisplayedFrames;
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLSequenceBrowserNode::AddPlaybackFrameStatistics(double frameTimeSec, int numberOfDroppedFrames)
+{
+  this->PlaybackNumberOfDisplayedFrames++;
+  this->PlaybackNumberOfDroppedFrames += std::max(numberOfDroppedFrames, 0);
+  this->PlaybackLastFrameTimeSec = frameTimeSec;
+  this->PlaybackMaximumFrameTimeSec = std::max(this->PlaybackMaximumFrameTimeSec, frameTimeSec);
+  this->PlaybackTotalFrameTimeSec += frameTimeSec;
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLSequenceBrowserNode::ResetPlaybackStatistics()
+{
+  this->PlaybackNumberOfDisplayedFrames = 0;
+  this->PlaybackNumberOfDroppedFrames = 0;
+  this->PlaybackLastFrameTimeSec = 0.0;
+  this->PlaybackMaximumFrameTimeSec = 0.0;
+  this->PlaybackTotalFrameTimeSec = 0.0;
+}
+
+//---------------------------------------------------------------------------
+bool vtkMRMLSequenceBrowserNode::LoadItem(vtkMRMLSequenceNode* sequenceNode, int itemNumber)
+{
+  if (!sequenceNode || !sequenceNode->GetID())
+  {
+    vtkErrorMacro("vtkMRMLSequenceBrowserNode::LoadItem failed: invalid sequence node");
+    return false;
+  }
+  if (itemNumber < 0 || itemNumber >= sequenceNode->GetNumberOfDataNodes())
+  {
+    return false;
+  }
+  if (sequenceNode->GetNthDataNodeStorageFrameIndex(itemNumber) < 0 && !sequenceNode->IsNthDataNodeCompact(itemNumber))
+  {
+    // Item content is always kept in memory
+    return true;
+  }
+
+  std::list<std::string>& loadedIndexValues = this->LoadedItemIndexValues[sequenceNode->GetID()];
+  std::string indexValue = sequenceNode->GetNthIndexValue(itemNumber);
+  loadedIndexValues.remove(indexValue);
+  loadedIndexValues.push_front(indexValue);
+  bool success = sequenceNode->LoadNthDataNode(itemNumber);
+
+  // Release least recently used items
+  int maximumNumberOfLoadedItems = std::max(this->MaximumNumberOfLoadedItems, 1);
+  while (static_cast<int>(loadedIndexValues.size()) > maximumNumberOfLoadedItems)
+  {
+    int leastRecentlyUsedItemNumber = sequenceNode->GetItemNumberFromIndexValue(loadedIndexValues.back());
+    if (leastRecentlyUsedItemNumber >= 0)
+    {
+      sequenceNode->UnloadNthDataNode(leastRecentlyUsedItemNumber);
+    }
+    loadedIndexValues.pop_back();
+  }
+  return success;
+}
+
 //---------------------------------------------------------------------------
 void vtkMRMLSequenceBrowserNode::ProcessMRMLEvents(vtkObject* caller, unsigned long event, void* callData)
 {
@@ -1161,7 +1257,18 @@ void vtkMRMLSequenceBrowserNode::SaveProxyNodesState()
     vtkMRMLSequenceNode* currSequenceNode = (*it);
     if (this->GetRecording(currSequenceNode))
     {
-      currSequenceNode->SetDataNodeAtValue(this->GetProxyNode(currSequenceNode), currTime.str().c_str());
+      vtkMRMLLinearTransformNode* proxyTransformNode = vtkMRMLLinearTransformNode::SafeDownCast(this->GetProxyNode(currSequenceNode));
+      if (proxyTransformNode && currSequenceNode->GetCompactLinearTransformStorage())
+      {
+        // Only store the matrix, without creating a transform node for each sample
+        vtkNew<vtkMatrix4x4> matrixToParent;
+        proxyTransformNode->GetMatrixTransformToParent(matrixToParent);
+        currSequenceNode->SetMatrixTransformToParentAtValue(matrixToParent, currTime.str());
+      }
+      else
+      {
+        currSequenceNode->SetDataNodeAtValue(this->GetProxyNode(currSequenceNode), currTime.str().c_str());
+      }
       snapshotAdded = true;
     }
   }
@@ -30,6 +30,7 @@
 #include <vtkNew.h>
 
 // STD includes
+#include <list>
 #include <set>
 #include <map>
 
@@ -145,7 +146,8 @@ public:
   //@}
 
   //@{
-  /// Get/Set playback rate in fps (frames per second)
+  /// Get/Set playback rate in fps (frames per second).
+  /// Negative value plays the sequence in reverse direction.
   vtkGetMacro(PlaybackRateFps, double);
   vtkSetMacro(PlaybackRateFps, double);
   //@}
@@ -157,6 +159,28 @@ public:
   vtkBooleanMacro(PlaybackItemSkippingEnabled, bool);
   //@}
 
+  //@{
+  /// Get/Set number of upcoming items that are loaded in the background during playback.
+  /// Only items of sequences that are loaded on demand are prefetched
+  /// (see vtkMRMLVolumeSequenceStorageNode::LoadFramesOnDemand). Default is 2.
+  vtkGetMacro(PlaybackPrefetchItemCount, int);
+  vtkSetMacro(PlaybackPrefetchItemCount, int);
+  //@}
+
+  //@{
+  /// Playback statistics, collected since playback was started or statistics were reset.
+  /// Frame time is the time that was needed for selecting an item and updating proxy nodes.
+  /// Items that were skipped to keep up with the requested playback rate are counted as dropped frames.
+  /// Updating the statistics does not invoke modified event.
+  vtkGetMacro(PlaybackNumberOfDisplayedFrames, int);
+  vtkGetMacro(PlaybackNumberOfDroppedFrames, int);
+  vtkGetMacro(PlaybackLastFrameTimeSec, double);
+  vtkGetMacro(PlaybackMaximumFrameTimeSec, double);
+  double GetPlaybackAverageFrameTimeSec();
+  void AddPlaybackFrameStatistics(double frameTimeSec, int numberOfDroppedFrames);
+  void ResetPlaybackStatistics();
+  //@}
+
   //@{
   /// Get/Set playback looping (restart from the first sequence node when reached the last one)
   vtkGetMacro(PlaybackLooped, bool);
@@ -170,6 +194,19 @@ public:
   vtkSetMacro(SelectedItemNumber, int);
   //@}
 
+  //@{
+  /// Get/Set maximum number of items that are kept in memory for each sequence that loads its items on demand
+  /// (see vtkMRMLVolumeSequenceStorageNode::LoadFramesOnDemand). Least recently used items are unloaded
+  /// when more items are loaded. Default is 8.
+  vtkGetMacro(MaximumNumberOfLoadedItems, int);
+  vtkSetMacro(MaximumNumberOfLoadedItems, int);
+  //@}
+
+  /// Make sure that content of a sequence item is in memory, reading it from file if it is loaded on demand.
+  /// Least recently used items of the sequence are unloaded if more than MaximumNumberOfLoadedItems are loaded.
+  /// Returns true if the item content is available.
+  bool LoadItem(vtkMRMLSequenceNode* sequenceNode, int itemNumber);
+
   /// Set selected item by index value.
   /// If exact match is not required and index is numeric then the best matching data node is returned.
   /// Returns true if the index value is found.
@@ -391,6 +428,18 @@ protected:
   bool PlaybackItemSkippingEnabled{ true };
   bool PlaybackLooped{ true };
   int SelectedItemNumber{ -1 };
+  int MaximumNumberOfLoadedItems{ 8 };
+  int PlaybackPrefetchItemCount{ 2 };
+
+  int PlaybackNumberOfDisplayedFrames{ 0 };
+  int PlaybackNumberOfDroppedFrames{ 0 };
+  double PlaybackLastFrameTimeSec{ 0.0 };
+  double PlaybackMaximumFrameTimeSec{ 0.0 };
+  double PlaybackTotalFrameTimeSec{ 0.0 };
+
+  /// Index values of items that were loaded on demand, for each sequence node ID.
+  /// Most recently used item is at the front.
+  std::map<std::string, std::list<std::string>> LoadedItemIndexValues;
 
   double RecordingTimeOffsetSec; // difference between universal time and index value
   vtkSetMacro(RecordingTimeOffsetSec, double);
@@ -212,6 +212,28 @@ int TestRemoveItem()
   return EXIT_SUCCESS;
 }
 
+int TestPlaybackStatistics()
+{
+  vtkNew<vtkMRMLSequenceBrowserNode> browserNode;
+  CHECK_INT(browserNode->GetPlaybackNumberOfDisplayedFrames(), 0);
+  CHECK_DOUBLE(browserNode->GetPlaybackAverageFrameTimeSec(), 0.0);
+
+  browserNode->AddPlaybackFrameStatistics(0.010, 0);
+  browserNode->AddPlaybackFrameStatistics(0.030, 2);
+  CHECK_INT(browserNode->GetPlaybackNumberOfDisplayedFrames(), 2);
+  CHECK_INT(browserNode->GetPlaybackNumberOfDroppedFrames(), 2);
+  CHECK_DOUBLE_TOLERANCE(browserNode->GetPlaybackLastFrameTimeSec(), 0.030, 1e-9);
+  CHECK_DOUBLE_TOLERANCE(browserNode->GetPlaybackMaximumFrameTimeSec(), 0.030, 1e-9);
+  CHECK_DOUBLE_TOLERANCE(browserNode->GetPlaybackAverageFrameTimeSec(), 0.020, 1e-9);
+
+  browserNode->ResetPlaybackStatistics();
+  CHECK_INT(browserNode->GetPlaybackNumberOfDisplayedFrames(), 0);
+  CHECK_INT(browserNode->GetPlaybackNumberOfDroppedFrames(), 0);
+  CHECK_DOUBLE(browserNode->GetPlaybackMaximumFrameTimeSec(), 0.0);
+
+  return EXIT_SUCCESS;
+}
+
 } // end anonymous namespace
 
 int vtkMRMLSequenceBrowserNodeTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
@@ -219,5 +241,6 @@ int vtkMRMLSequenceBrowserNodeTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)
   CHECK_EXIT_SUCCESS(TestIndexFormatting());
   CHECK_EXIT_SUCCESS(TestSelectNextItem());
   CHECK_EXIT_SUCCESS(TestRemoveItem());
+  CHECK_EXIT_SUCCESS(TestPlaybackStatistics());
   return EXIT_SUCCESS;
 }
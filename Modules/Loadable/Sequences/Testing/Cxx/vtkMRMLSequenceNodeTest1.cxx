@@ -147,6 +147,31 @@ int vtkMRMLSequenceNodeTest1(int, char*[])
   CHECK_INT(scene->GetNumberOfNodes(), 1);
   CHECK_INT(seqNode->GetNumberOfDataNodes(), 1);
 
+  // Check item number lookup for text index after adding, removing, and renaming items
+  seqNode->RemoveAllDataNodes();
+  seqNode->SetIndexType(vtkMRMLSequenceNode::TextIndex);
+  for (int i = 0; i < numberOfDataNodes; ++i)
+  {
+    std::ostringstream valueStr;
+    valueStr << "item" << i;
+    seqNode->SetDataNodeAtValue(dataNode, valueStr.str());
+  }
+  CHECK_INT(seqNode->GetItemNumberFromIndexValue("item0"), 0);
+  CHECK_INT(seqNode->GetItemNumberFromIndexValue("item7"), 7);
+  CHECK_INT(seqNode->GetItemNumberFromIndexValue("nonexistent"), -1);
+  seqNode->RemoveDataNodeAtValue("item2");
+  CHECK_INT(seqNode->GetItemNumberFromIndexValue("item2"), -1);
+  CHECK_INT(seqNode->GetItemNumberFromIndexValue("item7"), 6);
+  seqNode->RemoveDataNodeAtValue("item49");
+  CHECK_INT(seqNode->GetItemNumberFromIndexValue("item49"), -1);
+  CHECK_INT(seqNode->GetItemNumberFromIndexValue("item48"), 47);
+  seqNode->UpdateIndexValue("item48", "item48b");
+  CHECK_INT(seqNode->GetItemNumberFromIndexValue("item48"), -1);
+  CHECK_INT(seqNode->GetItemNumberFromIndexValue("item48b"), 47);
+  seqNode->SetDataNodeAtValue(dataNode, "item50");
+  CHECK_INT(seqNode->GetItemNumberFromIndexValue("item50"), 48);
+  CHECK_INT(seqNode->GetNumberOfDataNodes(), numberOfDataNodes - 1);
+
   /*
   bool res = true;
   TESTING_OUTPUT_ASSERT_ERRORS_BEGIN();
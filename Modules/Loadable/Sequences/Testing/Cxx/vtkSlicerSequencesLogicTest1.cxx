@@ -27,6 +27,10 @@
 #include <vtkNew.h>
 #include <vtkTestingOutputWindow.h>
 
+// STD includes
+#include <chrono>
+#include <thread>
+
 namespace
 {
 int TestLogicWithoutScene()
@@ -270,6 +274,45 @@ int TestSparseSequence()
 
   return EXIT_SUCCESS;
 }
+int TestReversePlayback()
+{
+  // Negative playback rate plays the sequence backward, wrapping around at the first item
+
+  vtkSmartPointer<vtkMRMLScene> scene = vtkSmartPointer<vtkMRMLScene>::New();
+  vtkNew<vtkSlicerSequencesLogic> sequencesLogic;
+  sequencesLogic->SetMRMLScene(scene);
+
+  vtkMRMLSequenceBrowserNode* browserNode = vtkMRMLSequenceBrowserNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLSequenceBrowserNode"));
+  vtkMRMLTextNode* proxyNode = vtkMRMLTextNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLTextNode"));
+  vtkMRMLSequenceNode* sequenceNode = sequencesLogic->AddSynchronizedNode(nullptr, proxyNode, browserNode);
+  vtkNew<vtkMRMLTextNode> proxyNodeTemp;
+  const char* texts[] = { "Zero", "One", "Two" };
+  for (int itemNumber = 0; itemNumber < 3; ++itemNumber)
+  {
+    proxyNodeTemp->SetText(texts[itemNumber]);
+    sequenceNode->SetDataNodeAtValue(proxyNodeTemp, std::to_string(itemNumber));
+  }
+
+  CHECK_BOOL(browserNode->SetSelectedItemByIndexValue("1"), true);
+  browserNode->SetPlaybackRateFps(-100.0);
+  browserNode->PlaybackItemSkippingEnabledOff();
+  browserNode->PlaybackLoopedOn();
+  browserNode->PlaybackActiveOn();
+  sequencesLogic->UpdateAllProxyNodes(); // start playback
+  CHECK_INT(browserNode->GetSelectedItemNumber(), 1);
+  const int expectedItemNumbers[] = { 0, 2, 1 };
+  for (int expectedItemNumber : expectedItemNumbers)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    sequencesLogic->UpdateAllProxyNodes();
+    CHECK_INT(browserNode->GetSelectedItemNumber(), expectedItemNumber);
+    CHECK_STD_STRING(proxyNode->GetText(), texts[expectedItemNumber]);
+  }
+  browserNode->PlaybackActiveOff();
+  sequencesLogic->UpdateAllProxyNodes();
+
+  return EXIT_SUCCESS;
+}
 } // namespace
 
 int vtkSlicerSequencesLogicTest1(int, char*[])
@@ -277,5 +320,6 @@ int vtkSlicerSequencesLogicTest1(int, char*[])
   CHECK_EXIT_SUCCESS(TestLogicWithoutScene());
   CHECK_EXIT_SUCCESS(TestAddSequence());
   CHECK_EXIT_SUCCESS(TestSparseSequence());
+  CHECK_EXIT_SUCCESS(TestReversePlayback());
   return EXIT_SUCCESS;
 }